@@ -27,6 +27,8 @@
 #   DEAL_II_HAVE_SSE2                    *)
 #   DEAL_II_HAVE_AVX                     *)
 #   DEAL_II_HAVE_AVX512                  *)
+#   DEAL_II_HAVE_NEON                    *)
+#   DEAL_II_HAVE_ALTIVEC                 *)
 #   DEAL_II_COMPILER_VECTORIZATION_LEVEL
 #   DEAL_II_HAVE_OPENMP_SIMD             *)
 #   DEAL_II_OPENMP_SIMD_PRAGMA
@@ -36,6 +38,11 @@
 # values, when platform introspection is disabled with
 # DEAL_II_ALLOW_PLATFORM_INTROSPECTION=OFF,
 #
+# This is in particular the case when cross compiling, e.g. for ARM or
+# POWER targets on an x86 machine: Then, DEAL_II_HAVE_NEON or
+# DEAL_II_HAVE_ALTIVEC need to be set manually to enable the respective
+# vectorization.
+#
 
 
 #
@@ -75,6 +82,8 @@ IF(DEAL_II_ALLOW_PLATFORM_INTROSPECTION)
     UNSET(DEAL_II_HAVE_SSE2 CACHE)
     UNSET(DEAL_II_HAVE_AVX CACHE)
     UNSET(DEAL_II_HAVE_AVX512 CACHE)
+    UNSET(DEAL_II_HAVE_NEON CACHE)
+    UNSET(DEAL_II_HAVE_ALTIVEC CACHE)
   ENDIF()
   SET(DEAL_II_CHECK_CPU_FEATURES_SAVED
     "${CMAKE_REQUIRED_FLAGS}" CACHE INTERNAL "" FORCE
@@ -201,13 +210,74 @@ IF(DEAL_II_ALLOW_PLATFORM_INTROSPECTION)
     }
     "
     DEAL_II_HAVE_AVX512)
+
+  #
+  # 128-bit vectorization on 64-bit ARM (NEON, also called Advanced SIMD).
+  # Only AArch64 supports vectors of double precision numbers.
+  #
+  CHECK_CXX_SOURCE_RUNS(
+    "
+    #include <arm_neon.h>
+    #ifndef __aarch64__
+    #error NEON support for double requires AArch64
+    #endif
+    int main()
+    {
+      double data[2][2];
+      float64x2_t a, b;
+      a = vdupq_n_f64 (0.0);
+      a = vsetq_lane_f64 ((volatile double)(1.0), a, 0);
+      b = vdupq_n_f64 ((volatile double)(2.25));
+      vst1q_f64 (data[0], vaddq_f64 (a, b));
+      vst1q_f64 (data[1], vmulq_f64 (b, vld1q_f64 (data[0])));
+      unsigned int return_value = 0;
+      if (data[1][0] != 7.3125)
+        return_value = 1;
+      if (data[1][1] != 5.0625)
+        return_value = 1;
+      return return_value;
+    }
+    "
+    DEAL_II_HAVE_NEON)
+
+  #
+  # 128-bit vectorization on POWER (VSX extension of AltiVec), needed for
+  # vectors of double precision numbers.
+  #
+  CHECK_CXX_SOURCE_RUNS(
+    "
+    #include <altivec.h>
+    #undef vector
+    #undef pixel
+    #undef bool
+    #ifndef __VSX__
+    #error AltiVec support for double requires VSX
+    #endif
+    int main()
+    {
+      double data[2][2];
+      __vector double a, b;
+      a = vec_splats (0.0);
+      a = vec_insert ((volatile double)(1.0), a, 0);
+      b = vec_splats ((volatile double)(2.25));
+      vec_vsx_st (vec_add (a, b), 0, data[0]);
+      vec_vsx_st (vec_mul (b, vec_vsx_ld (0, data[0])), 0, data[1]);
+      unsigned int return_value = 0;
+      if (data[1][0] != 7.3125)
+        return_value = 1;
+      if (data[1][1] != 5.0625)
+        return_value = 1;
+      return return_value;
+    }
+    "
+    DEAL_II_HAVE_ALTIVEC)
 ENDIF()
 
 IF(DEAL_II_HAVE_AVX512)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 3)
 ELSEIF(DEAL_II_HAVE_AVX)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 2)
-ELSEIF(DEAL_II_HAVE_SSE2)
+ELSEIF(DEAL_II_HAVE_SSE2 OR DEAL_II_HAVE_NEON OR DEAL_II_HAVE_ALTIVEC)
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 1)
 ELSE()
   SET(DEAL_II_COMPILER_VECTORIZATION_LEVEL 0)
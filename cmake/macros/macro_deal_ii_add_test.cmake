@@ -205,6 +205,15 @@ MACRO(DEAL_II_ADD_TEST _category _test_name _comparison_file)
           )
       ENDIF()
 
+      #
+      # When cross compiling, run the executable through the emulator given
+      # by CMAKE_CROSSCOMPILING_EMULATOR in the toolchain file of the deal.II
+      # configuration, e.g. QEMU in user mode:
+      #
+      IF(NOT "${DEAL_II_CROSSCOMPILING_EMULATOR}" STREQUAL "")
+        SET(_run_args ${DEAL_II_CROSSCOMPILING_EMULATOR} ${_run_args})
+      ENDIF()
+
       #
       # Set up a bunch of variables describing this particular test:
       #
@@ -0,0 +1,365 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_checkpoint_h
+#define dealii_checkpoint_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/mpi.h>
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+/**
+ * A class that writes a checkpoint file, i.e., a single binary file that
+ * collects data of all processors of an MPI communicator for a later restart
+ * of a computation. The counterpart for reading such files is the class
+ * CheckpointReader.
+ *
+ * A checkpoint file consists of named blocks. Every processor contributes
+ * its own part, of arbitrary size, to every block. The parts are stored one
+ * after the other in the order of the processors, each part starting at a
+ * multiple of CheckpointWriter::alignment bytes in the file, and each block
+ * starting at a multiple of CheckpointWriter::page_size bytes. At the end of
+ * the file, a directory records the name of each block along with the
+ * position and size of the part of each processor. A file written by @p P
+ * processors is therefore self-describing: a reader knows how many
+ * processors wrote the file and can access the part of any of these
+ * processors without reading the rest of the file, independent of the number
+ * of processors used for reading.
+ *
+ * With MPI, all writes are collective MPI I/O operations that go to a
+ * single shared file. Without MPI, the file is written with the standard
+ * library.
+ *
+ * The data is written in the byte order of the machine. The header of the
+ * file contains a marker that allows CheckpointReader to detect files that
+ * were written on a machine with different byte order.
+ *
+ * This class is used by parallel::distributed::Triangulation::save() and
+ * LinearAlgebra::distributed::Vector::save() to write the mesh, data
+ * attached to cells, and vectors into one file, but it can also be used to
+ * store any other data of an application, see the following example:
+ * @code
+ *   CheckpointWriter writer ("restart.chk", MPI_COMM_WORLD);
+ *   triangulation.save (writer);
+ *   solution.save (writer, "solution");
+ *   writer.write_block ("time", &time, 1);
+ *   writer.close ();
+ * @endcode
+ */
+class CheckpointWriter
+{
+public:
+  /**
+   * The alignment in bytes of the part of each processor within a block.
+   */
+  static const std::size_t alignment = 64;
+
+  /**
+   * The alignment in bytes of each block. This is chosen as the size of
+   * memory pages on common systems such that each block starts on a new
+   * page when the file is mapped into memory.
+   */
+  static const std::size_t page_size = 4096;
+
+  /**
+   * Constructor. Create the file with the given name, or truncate it if it
+   * already exists. This is a collective operation on @p comm.
+   */
+  CheckpointWriter (const std::string &filename,
+                    const MPI_Comm    &comm);
+
+  /**
+   * Destructor. The file must have been closed through close() before the
+   * object is destroyed, since closing the file involves collective
+   * operations that can not be done in a destructor.
+   */
+  ~CheckpointWriter ();
+
+  /**
+   * Write the part of the current processor of the block with the given
+   * name, given by @p n_bytes bytes starting at @p data. This is a
+   * collective operation: all processors of the communicator have to call
+   * this function with the same @p name in the same order, but may pass
+   * different sizes, including zero. The name must not have been used
+   * before for another block of this file.
+   */
+  void write_block (const std::string &name,
+                    const void        *data,
+                    const std::size_t  n_bytes);
+
+  /**
+   * Same as above, for an array of @p n_elements objects of type @p T
+   * starting at @p data. @p T must be a type that can be copied bytewise.
+   */
+  template <typename T>
+  void write_block (const std::string &name,
+                    const T           *data,
+                    const std::size_t  n_elements);
+
+  /**
+   * Write the directory of blocks and the header of the file and close the
+   * file. This is a collective operation.
+   */
+  void close ();
+
+  /**
+   * Exception.
+   */
+  DeclException1 (ExcDuplicateBlockName,
+                  std::string,
+                  << "A block with name <" << arg1 << "> has already been "
+                  << "written to this checkpoint file.");
+
+private:
+  /**
+   * The communicator of all processors writing to the file.
+   */
+  MPI_Comm comm;
+
+  /**
+   * The name of the file.
+   */
+  std::string filename;
+
+#ifdef DEAL_II_WITH_MPI
+  /**
+   * The MPI file handle.
+   */
+  MPI_File file_handle;
+#else
+  /**
+   * The file stream if deal.II was configured without MPI.
+   */
+  std::ofstream file;
+#endif
+
+  /**
+   * Whether the file is still open.
+   */
+  bool is_open;
+
+  /**
+   * The size of the file written so far, i.e., the position where the next
+   * block is going to start before rounding up to a multiple of
+   * #page_size.
+   */
+  unsigned long long int file_size;
+
+  /**
+   * The names of the blocks written so far, in the order they were written.
+   */
+  std::vector<std::string> block_names;
+
+  /**
+   * For each block written so far, the start of the block in the file,
+   * followed by the size in bytes of the part of each processor. This
+   * information is only collected on processor zero, which writes the
+   * directory of the file in close().
+   */
+  std::vector<std::vector<unsigned long long int> > block_layout;
+
+  /**
+   * Write @p n_bytes bytes starting at @p data at position @p offset of the
+   * file. If @p collective is true, all processors must call this function.
+   * Parts larger than what MPI can write in a single call are written in
+   * several chunks.
+   */
+  void write_at (const unsigned long long int offset,
+                 const void                  *data,
+                 const std::size_t            n_bytes,
+                 const bool                   collective);
+};
+
+
+
+/**
+ * A class that gives access to the data of a checkpoint file written by the
+ * CheckpointWriter class.
+ *
+ * The file is mapped into memory with <code>mmap</code> on systems that
+ * support it, such that only the parts of the file that are actually
+ * accessed are read from disk, and the data of a block can be used directly
+ * from the mapped memory without first copying it into a separate buffer. On
+ * other systems, the whole file is read into memory upon construction.
+ *
+ * Since the file contains the parts of all processors that wrote it, every
+ * processor can access the part of any of the writing processors through
+ * get_block(). A restart on the same number of processors typically only
+ * needs the part written by the processor with the same rank, which can be
+ * queried through the function n_writer_processes().
+ */
+class CheckpointReader
+{
+public:
+  /**
+   * Constructor. Open the file with the given name and read its directory.
+   * The communicator is only used to query the rank and the number of
+   * processors of the reading processors.
+   */
+  CheckpointReader (const std::string &filename,
+                    const MPI_Comm    &comm);
+
+  /**
+   * Destructor. Unmap or release the contents of the file.
+   */
+  ~CheckpointReader ();
+
+  /**
+   * Return the number of processors that wrote the file.
+   */
+  unsigned int n_writer_processes () const;
+
+  /**
+   * Return the rank of the current processor within the communicator given
+   * to the constructor.
+   */
+  unsigned int this_process () const;
+
+  /**
+   * Return the number of processors in the communicator given to the
+   * constructor.
+   */
+  unsigned int n_processes () const;
+
+  /**
+   * Return whether the file contains a block with the given name.
+   */
+  bool has_block (const std::string &name) const;
+
+  /**
+   * Return the part written by processor @p writer_process of the block
+   * with the given name. The returned memory stays valid as long as this
+   * object exists and starts at an address that is a multiple of
+   * CheckpointWriter::alignment.
+   */
+  ArrayView<const char> get_block (const std::string  &name,
+                                   const unsigned int  writer_process) const;
+
+  /**
+   * Same as above, but interpret the data as an array of objects of type
+   * @p T.
+   */
+  template <typename T>
+  ArrayView<const T> get_block (const std::string  &name,
+                                const unsigned int  writer_process) const;
+
+  /**
+   * Exception.
+   */
+  DeclException1 (ExcBlockNotFound,
+                  std::string,
+                  << "The checkpoint file does not contain a block with name <"
+                  << arg1 << ">.");
+
+  /**
+   * Exception.
+   */
+  DeclException1 (ExcInvalidCheckpointFile,
+                  std::string,
+                  << "The file <" << arg1 << "> is not a valid checkpoint file "
+                  << "or was written on a machine with different byte order.");
+
+private:
+  /**
+   * The name of the file.
+   */
+  std::string filename;
+
+  /**
+   * The rank of the current processor and the number of processors in the
+   * communicator given to the constructor.
+   */
+  unsigned int my_rank;
+  unsigned int n_ranks;
+
+  /**
+   * A pointer to the contents of the file and their size.
+   */
+  const char *file_data;
+  std::size_t file_size;
+
+  /**
+   * Whether the contents of the file are mapped into memory. Otherwise,
+   * they are stored in @p file_buffer.
+   */
+  bool is_mapped;
+  std::vector<char> file_buffer;
+
+  /**
+   * The number of processors that wrote the file.
+   */
+  unsigned int n_writers;
+
+  /**
+   * For each block, the position in the file and the size in bytes of the
+   * part of each processor that wrote the file.
+   */
+  std::map<std::string, std::vector<std::pair<unsigned long long int, unsigned long long int> > > blocks;
+
+  /**
+   * Check the header of the file and read its directory into #blocks. Throw
+   * an exception of type ExcInvalidCheckpointFile if any of the offsets or
+   * sizes stored in the file point beyond its end.
+   */
+  void read_directory ();
+};
+
+
+/* ----------------------- inline and template functions -------------------- */
+
+#ifndef DOXYGEN
+
+template <typename T>
+inline
+void
+CheckpointWriter::write_block (const std::string &name,
+                               const T           *data,
+                               const std::size_t  n_elements)
+{
+  write_block (name, static_cast<const void *>(data), n_elements * sizeof(T));
+}
+
+
+
+template <typename T>
+inline
+ArrayView<const T>
+CheckpointReader::get_block (const std::string  &name,
+                             const unsigned int  writer_process) const
+{
+  const ArrayView<const char> bytes = get_block (name, writer_process);
+  Assert (bytes.size() % sizeof(T) == 0,
+          ExcMessage ("The size of the block is not a multiple of the size "
+                      "of the requested type."));
+  return ArrayView<const T> (reinterpret_cast<const T *>(bytes.begin()),
+                             bytes.size() / sizeof(T));
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
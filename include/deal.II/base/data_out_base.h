@@ -27,6 +27,7 @@
 #include <limits>
 #include <typeinfo>
 #include <tuple>
+#include <functional>
 
 #include <deal.II/base/mpi.h>
 
@@ -2579,6 +2580,33 @@ protected:
    */
   void validate_dataset_names () const;
 
+  /**
+   * Collective MPI call to write the output of all participating processors
+   * to a single .vtu file without ever holding all patches of a processor in
+   * memory. The patches are produced in @p n_batches batches: for each batch
+   * <code>i</code>, this function calls <code>build_batch(i)</code>, which is
+   * expected to set up the patches returned by get_patches() for this batch,
+   * and then writes the patches of this batch to the file before moving on
+   * to the next one. This allows derived classes such as DataOut to offer an
+   * output path whose memory consumption is bounded by the size of one batch
+   * rather than by the size of the mesh, see
+   * DataOut::write_vtu_in_parallel_streaming().
+   *
+   * Each batch becomes a separate <code>Piece</code> of the unstructured grid
+   * in the file. The data of all pieces is stored in the raw binary appended
+   * data section of the VTU format with 64 bit headers, avoiding the base64
+   * encoding of write_vtu(). If deal.II was configured with zlib and the
+   * compression level in the VtkFlags is not VtkFlags::no_compression, each
+   * data array is split into blocks that are compressed in parallel. With
+   * MPI, the pieces of all processors are written with collective MPI I/O
+   * operations, one per batch. The number of batches may differ between
+   * processors.
+   */
+  void write_vtu_in_parallel_batched (const char                                   *filename,
+                                      MPI_Comm                                      comm,
+                                      const unsigned int                            n_batches,
+                                      const std::function<void (const unsigned int)> &build_batch) const;
+
 
   /**
    * The default number of subdivisions for patches. This is filled by
@@ -18,6 +18,7 @@
 
 #include <deal.II/base/config.h>
 
+#include <functional>
 #include <vector>
 
 #if !defined(DEAL_II_WITH_MPI) && !defined(DEAL_II_WITH_PETSC)
@@ -291,6 +292,96 @@ namespace Utilities
               const MPI_Comm &mpi_communicator,
               std::vector<T> &minima);
 
+    /**
+     * An object that represents the result of a collective operation that has
+     * been started but has not necessarily finished yet, such as the one
+     * returned by isum(). This allows to start a global communication, do
+     * other work while the messages are in flight, and only wait for the
+     * result once it is actually needed.
+     *
+     * The class is similar to <code>std::future</code>: The function wait()
+     * blocks until the operation has finished, and get() returns its result,
+     * waiting for it if necessary. Objects of this type cannot be copied,
+     * since the operation can only be completed once. If an object is
+     * destroyed before wait() or get() have been called, its destructor waits
+     * for the operation to finish, because the memory involved in the
+     * communication has to stay valid until then.
+     */
+    template <typename T>
+    class Future
+    {
+    public:
+      /**
+       * Constructor. @p wait_operation is a function that blocks until the
+       * operation has finished, and @p get_operation is a function that
+       * returns the result once this is the case.
+       */
+      Future (const std::function<void ()> &wait_operation,
+              const std::function<T ()>    &get_operation);
+
+      /**
+       * Move constructor.
+       */
+      Future (Future &&other);
+
+      /**
+       * Copy constructor. Deleted since the operation may only be completed
+       * once.
+       */
+      Future (const Future &) = delete;
+
+      /**
+       * Destructor. Waits for the operation to finish if this has not
+       * happened yet, since the memory involved in the communication must
+       * stay valid until then. Errors that occur while waiting are ignored
+       * here because a destructor must not throw; call wait() or get()
+       * before the object goes out of scope in order to have them reported.
+       */
+      ~Future ();
+
+      /**
+       * Wait for the operation to finish. Calling this function more than
+       * once is allowed and does nothing after the first call.
+       */
+      void wait ();
+
+      /**
+       * Return the result of the operation, waiting for it to finish if
+       * necessary.
+       */
+      T get ();
+
+    private:
+      /**
+       * The functions given to the constructor.
+       */
+      std::function<void ()> wait_operation;
+      std::function<T ()>    get_operation;
+
+      /**
+       * Whether wait_operation has already been called.
+       */
+      bool is_done;
+    };
+
+    /**
+     * Start computing the sum over all processors of the elements of @p
+     * values, i.e., the same operation as the sum() function above, without
+     * waiting for the result. The function returns an object through which
+     * the result can be accessed once it is needed; the calling processor can
+     * do other work in the meantime. This corresponds to the
+     * <code>MPI_Iallreduce</code> function.
+     *
+     * If the MPI library does not support non-blocking collective operations
+     * (which were introduced in version 3.0 of the MPI standard), or if the
+     * communicator only contains a single processor, the sum is computed
+     * immediately and the returned object is already complete.
+     */
+    template <typename T>
+    Future<std::vector<T> >
+    isum (const std::vector<T> &values,
+          const MPI_Comm       &mpi_communicator);
+
 
     /**
      * A data structure to store the result of the min_max_avg() function.
@@ -480,6 +571,71 @@ namespace Utilities
     {
       internal::all_reduce(MPI_MIN, values, mpi_communicator, minima, N);
     }
+
+
+
+    template <typename T>
+    inline
+    Future<T>::Future (const std::function<void ()> &wait_operation,
+                       const std::function<T ()>    &get_operation)
+      :
+      wait_operation (wait_operation),
+      get_operation (get_operation),
+      is_done (false)
+    {}
+
+
+
+    template <typename T>
+    inline
+    Future<T>::Future (Future<T> &&other)
+      :
+      wait_operation (std::move(other.wait_operation)),
+      get_operation (std::move(other.get_operation)),
+      is_done (other.is_done)
+    {
+      // the moved-from object must not wait in its destructor
+      other.is_done = true;
+    }
+
+
+
+    template <typename T>
+    inline
+    Future<T>::~Future ()
+    {
+      try
+        {
+          wait ();
+        }
+      catch (...)
+        {}
+    }
+
+
+
+    template <typename T>
+    inline
+    void
+    Future<T>::wait ()
+    {
+      if (is_done == false)
+        {
+          wait_operation ();
+          is_done = true;
+        }
+    }
+
+
+
+    template <typename T>
+    inline
+    T
+    Future<T>::get ()
+    {
+      wait ();
+      return get_operation ();
+    }
 #endif
   } // end of namespace MPI
 } // end of namespace Utilities
@@ -23,6 +23,7 @@
 #include <deal.II/base/symmetric_tensor.h>
 #include <deal.II/lac/vector.h>
 
+#include <memory>
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
@@ -162,6 +163,46 @@ namespace Utilities
           }
       }
 
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      /**
+       * Start a non-blocking reduction of the given values in place.
+       */
+      template <typename T>
+      void iall_reduce (const MPI_Op      &mpi_op,
+                        T                 *values,
+                        const MPI_Comm    &mpi_communicator,
+                        const std::size_t  size,
+                        MPI_Request       *request)
+      {
+        const int ierr = MPI_Iallreduce (MPI_IN_PLACE,
+                                         static_cast<void *>(values),
+                                         static_cast<int>(size),
+                                         internal::mpi_type_id(values),
+                                         mpi_op,
+                                         mpi_communicator,
+                                         request);
+        AssertThrowMPI(ierr);
+      }
+
+      template <typename T>
+      void iall_reduce (const MPI_Op      &mpi_op,
+                        std::complex<T>   *values,
+                        const MPI_Comm    &mpi_communicator,
+                        const std::size_t  size,
+                        MPI_Request       *request)
+      {
+        T dummy_selector;
+        const int ierr = MPI_Iallreduce (MPI_IN_PLACE,
+                                         static_cast<void *>(values),
+                                         static_cast<int>(size*2),
+                                         internal::mpi_type_id(&dummy_selector),
+                                         mpi_op,
+                                         mpi_communicator,
+                                         request);
+        AssertThrowMPI(ierr);
+      }
+#endif
+
       template <typename T>
       T all_reduce (const MPI_Op &mpi_op,
                     const T &t,
@@ -221,6 +262,47 @@ namespace Utilities
     }
 
 
+
+    template <typename T>
+    Future<std::vector<T> >
+    isum (const std::vector<T> &values,
+          const MPI_Comm       &mpi_communicator)
+    {
+      // the result is stored in an object that is shared with the returned
+      // object, since the memory has to stay valid until the communication
+      // has finished
+      const std::shared_ptr<std::vector<T> > sums
+        = std::make_shared<std::vector<T> > (values);
+
+#if defined(DEAL_II_WITH_MPI) && MPI_VERSION >= 3
+      if (job_supports_mpi() && n_mpi_processes(mpi_communicator) > 1 &&
+          values.size() > 0)
+        {
+          const std::shared_ptr<MPI_Request> request = std::make_shared<MPI_Request>();
+          internal::iall_reduce (MPI_SUM, sums->data(), mpi_communicator,
+                                 sums->size(), request.get());
+          return Future<std::vector<T> > ([request]()
+          {
+            const int ierr = MPI_Wait (request.get(), MPI_STATUS_IGNORE);
+            AssertThrowMPI(ierr);
+          },
+          [sums]()
+          {
+            return *sums;
+          });
+        }
+#endif
+
+      if (values.size() > 0)
+        internal::all_reduce (MPI_SUM, values, mpi_communicator, *sums);
+      return Future<std::vector<T> > ([]() {},
+                                      [sums]()
+      {
+        return *sums;
+      });
+    }
+
+
     template <int rank, int dim, typename Number>
     Tensor<rank,dim,Number>
     sum (const Tensor<rank,dim,Number> &local,
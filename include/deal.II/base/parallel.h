@@ -23,6 +23,7 @@
 #include <deal.II/base/synchronous_iterator.h>
 #include <deal.II/base/thread_management.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <tuple>
 #include <memory>
@@ -31,6 +32,7 @@
 #ifdef DEAL_II_WITH_THREADS
 #  include <tbb/parallel_for.h>
 #  include <tbb/parallel_reduce.h>
+#  include <tbb/parallel_sort.h>
 #  include <tbb/partitioner.h>
 #  include <tbb/blocked_range.h>
 #endif
@@ -684,6 +686,51 @@ namespace parallel
   }
 
 
+
+  /**
+   * Sort the elements of the range <code>[begin,end)</code> with respect to
+   * the comparison object @p comp, in the same way as
+   * <code>std::sort(begin, end, comp)</code> would do. If deal.II is
+   * configured to use multiple threads, the range is sorted in parallel.
+   * Like std::sort(), this function does not preserve the order of
+   * equivalent elements.
+   *
+   * For a discussion of the kind of problems to which this function is
+   * applicable, see also the
+   * @ref threads "Parallel computing with multiple processors"
+   * module.
+   */
+  template <typename RandomAccessIterator, typename Compare>
+  void sort (const RandomAccessIterator &begin,
+             const RandomAccessIterator &end,
+             const Compare              &comp)
+  {
+#ifndef DEAL_II_WITH_THREADS
+    std::sort (begin, end, comp);
+#else
+    tbb::parallel_sort (begin, end, comp);
+#endif
+  }
+
+
+
+  /**
+   * Sort the elements of the range <code>[begin,end)</code> using
+   * <code>operator&lt;</code>, possibly in parallel. See the other sort()
+   * function for details.
+   */
+  template <typename RandomAccessIterator>
+  void sort (const RandomAccessIterator &begin,
+             const RandomAccessIterator &end)
+  {
+#ifndef DEAL_II_WITH_THREADS
+    std::sort (begin, end);
+#else
+    tbb::parallel_sort (begin, end);
+#endif
+  }
+
+
 // --------------------- for loop affinity partitioner -----------------------
 
   /**
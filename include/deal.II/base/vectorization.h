@@ -30,17 +30,19 @@
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 3
 // #elif defined (__AVX__)
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 2
-// #elif defined (__SSE2__)
+// #elif defined (__SSE2__) || defined (__ARM_NEON) || defined (__VSX__)
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 1
 // #else
 // #define DEAL_II_COMPILER_VECTORIZATION_LEVEL 0
 // #endif
-// In addition to checking the flags __AVX__ and __SSE2__, a CMake test,
-// 'check_01_cpu_features.cmake', ensures that these feature are not only
-// present in the compilation unit but also working properly.
-
-#if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && not defined(__SSE2__)
-#error "Mismatch in vectorization capabilities: SSE2 was detected during configuration of deal.II and switched on, but it is apparently not available for the file you are trying to compile at the moment. Check compilation flags controlling the instruction set, such as -march=native."
+// In addition to checking the flags __AVX__ and __SSE2__ (or their
+// counterparts __ARM_NEON on 64-bit ARM and __VSX__ on POWER, which both
+// provide 128-bit vectors), a CMake test, 'check_01_cpu_features.cmake',
+// ensures that these feature are not only present in the compilation unit
+// but also working properly.
+
+#if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && not defined(__SSE2__) && not (defined(__ARM_NEON) && defined(__aarch64__)) && not (defined(__ALTIVEC__) && defined(__VSX__))
+#error "Mismatch in vectorization capabilities: SSE2 (or NEON/VSX) was detected during configuration of deal.II and switched on, but it is apparently not available for the file you are trying to compile at the moment. Check compilation flags controlling the instruction set, such as -march=native."
 #endif
 #if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 2 && not defined(__AVX__)
 #error "Mismatch in vectorization capabilities: AVX was detected during configuration of deal.II and switched on, but it is apparently not available for the file you are trying to compile at the moment. Check compilation flags controlling the instruction set, such as -march=native."
@@ -51,8 +53,19 @@
 
 #if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 2 // AVX, AVX-512
 #include <immintrin.h>
-#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL == 1 // SSE2
-#include <emmintrin.h>
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL == 1
+#  if defined(__SSE2__) // SSE2
+#    include <emmintrin.h>
+#  elif defined(__ARM_NEON) // ARM NEON
+#    include <arm_neon.h>
+#  elif defined(__ALTIVEC__) // POWER VSX
+#    include <altivec.h>
+// altivec.h defines the keywords vector, pixel and bool as macros which
+// clash with e.g. std::vector, so undefine them again
+#    undef vector
+#    undef pixel
+#    undef bool
+#  endif
 #endif
 
 
@@ -2703,6 +2716,1076 @@ vectorized_transpose_and_store(const bool                    add_into,
 
 
 
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && defined(__ARM_NEON) && defined(__aarch64__)
+
+/**
+ * Specialization for double and ARM NEON.
+ */
+template <>
+class VectorizedArray<double>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 2;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const double x)
+  {
+    data = vdupq_n_f64(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  double &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<double *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const double &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<const double *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+    data = vaddq_f64(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+    data = vsubq_f64(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+    data = vmulq_f64(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+    data = vdivq_f64(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a double address to VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const double *ptr)
+  {
+    data = vld1q_f64 (ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a double address to
+   * VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (double *ptr) const
+  {
+    vst1q_f64 (ptr, data);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const double       *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<2; ++i)
+      *(reinterpret_cast<double *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                double             *base_ptr) const
+  {
+    for (unsigned int i=0; i<2; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const double *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  float64x2_t data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vsqrtq_f64(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vabsq_f64(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vmaxq_f64 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vminq_f64 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for double and ARM NEON.
+ */
+template <>
+inline
+void vectorized_load_and_transpose(const unsigned int      n_entries,
+                                   const double            *in,
+                                   const unsigned int      *offsets,
+                                   VectorizedArray<double> *out)
+{
+  const unsigned int n_chunks = n_entries/2;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      float64x2_t u0 = vld1q_f64(in+2*i+offsets[0]);
+      float64x2_t u1 = vld1q_f64(in+2*i+offsets[1]);
+      out[2*i+0].data = vzip1q_f64 (u0, u1);
+      out[2*i+1].data = vzip2q_f64 (u0, u1);
+    }
+  for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+    for (unsigned int v=0; v<2; ++v)
+      out[i][v] = in[offsets[v]+i];
+}
+
+
+
+/**
+ * Specialization for double and ARM NEON.
+ */
+template <>
+inline
+void
+vectorized_transpose_and_store(const bool                     add_into,
+                               const unsigned int             n_entries,
+                               const VectorizedArray<double> *in,
+                               const unsigned int            *offsets,
+                               double                        *out)
+{
+  const unsigned int n_chunks = n_entries/2;
+  if (add_into)
+    {
+      for (unsigned int i=0; i<n_chunks; ++i)
+        {
+          float64x2_t u0 = in[2*i+0].data;
+          float64x2_t u1 = in[2*i+1].data;
+          float64x2_t res0 = vzip1q_f64 (u0, u1);
+          float64x2_t res1 = vzip2q_f64 (u0, u1);
+          vst1q_f64(out+2*i+offsets[0], vaddq_f64(vld1q_f64(out+2*i+offsets[0]), res0));
+          vst1q_f64(out+2*i+offsets[1], vaddq_f64(vld1q_f64(out+2*i+offsets[1]), res1));
+        }
+      for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+        for (unsigned int v=0; v<2; ++v)
+          out[offsets[v]+i] += in[i][v];
+    }
+  else
+    {
+      for (unsigned int i=0; i<n_chunks; ++i)
+        {
+          float64x2_t u0 = in[2*i+0].data;
+          float64x2_t u1 = in[2*i+1].data;
+          float64x2_t res0 = vzip1q_f64 (u0, u1);
+          float64x2_t res1 = vzip2q_f64 (u0, u1);
+          vst1q_f64(out+2*i+offsets[0], res0);
+          vst1q_f64(out+2*i+offsets[1], res1);
+        }
+      for (unsigned int i=2*n_chunks; i<n_entries; ++i)
+        for (unsigned int v=0; v<2; ++v)
+          out[offsets[v]+i] = in[i][v];
+    }
+}
+
+
+
+/**
+ * Specialization for float and ARM NEON.
+ */
+template <>
+class VectorizedArray<float>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 4;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const float x)
+  {
+    data = vdupq_n_f32(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  float &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<float *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const float &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<const float *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+    data = vaddq_f32(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+    data = vsubq_f32(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+    data = vmulq_f32(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+    data = vdivq_f32(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a float address to VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const float *ptr)
+  {
+    data = vld1q_f32 (ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a float address to
+   * VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (float *ptr) const
+  {
+    vst1q_f32 (ptr, data);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const float        *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<4; ++i)
+      *(reinterpret_cast<float *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                float              *base_ptr) const
+  {
+    for (unsigned int i=0; i<4; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const float *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  float32x4_t data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vsqrtq_f32(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vabsq_f32(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vmaxq_f32 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vminq_f32 (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for float and ARM NEON.
+ */
+template <>
+inline
+void vectorized_load_and_transpose(const unsigned int      n_entries,
+                                   const float            *in,
+                                   const unsigned int     *offsets,
+                                   VectorizedArray<float> *out)
+{
+  const unsigned int n_chunks = n_entries/4;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      float32x4_t u0 = vld1q_f32(in+4*i+offsets[0]);
+      float32x4_t u1 = vld1q_f32(in+4*i+offsets[1]);
+      float32x4_t u2 = vld1q_f32(in+4*i+offsets[2]);
+      float32x4_t u3 = vld1q_f32(in+4*i+offsets[3]);
+      float32x4_t v0 = vzip1q_f32 (u0, u2);
+      float32x4_t v1 = vzip2q_f32 (u0, u2);
+      float32x4_t v2 = vzip1q_f32 (u1, u3);
+      float32x4_t v3 = vzip2q_f32 (u1, u3);
+      out[4*i+0].data = vzip1q_f32 (v0, v2);
+      out[4*i+1].data = vzip2q_f32 (v0, v2);
+      out[4*i+2].data = vzip1q_f32 (v1, v3);
+      out[4*i+3].data = vzip2q_f32 (v1, v3);
+    }
+  for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+    for (unsigned int v=0; v<4; ++v)
+      out[i][v] = in[offsets[v]+i];
+}
+
+
+
+/**
+ * Specialization for float and ARM NEON.
+ */
+template <>
+inline
+void
+vectorized_transpose_and_store(const bool                    add_into,
+                               const unsigned int            n_entries,
+                               const VectorizedArray<float> *in,
+                               const unsigned int           *offsets,
+                               float                        *out)
+{
+  const unsigned int n_chunks = n_entries/4;
+  for (unsigned int i=0; i<n_chunks; ++i)
+    {
+      // the 4x4 transpose is its own inverse, so use the same zip pattern
+      // as in vectorized_load_and_transpose
+      float32x4_t t0 = vzip1q_f32 (in[4*i+0].data, in[4*i+2].data);
+      float32x4_t t1 = vzip2q_f32 (in[4*i+0].data, in[4*i+2].data);
+      float32x4_t t2 = vzip1q_f32 (in[4*i+1].data, in[4*i+3].data);
+      float32x4_t t3 = vzip2q_f32 (in[4*i+1].data, in[4*i+3].data);
+      float32x4_t u0 = vzip1q_f32 (t0, t2);
+      float32x4_t u1 = vzip2q_f32 (t0, t2);
+      float32x4_t u2 = vzip1q_f32 (t1, t3);
+      float32x4_t u3 = vzip2q_f32 (t1, t3);
+
+      if (add_into)
+        {
+          u0 = vaddq_f32(vld1q_f32(out+4*i+offsets[0]), u0);
+          vst1q_f32(out+4*i+offsets[0], u0);
+          u1 = vaddq_f32(vld1q_f32(out+4*i+offsets[1]), u1);
+          vst1q_f32(out+4*i+offsets[1], u1);
+          u2 = vaddq_f32(vld1q_f32(out+4*i+offsets[2]), u2);
+          vst1q_f32(out+4*i+offsets[2], u2);
+          u3 = vaddq_f32(vld1q_f32(out+4*i+offsets[3]), u3);
+          vst1q_f32(out+4*i+offsets[3], u3);
+        }
+      else
+        {
+          vst1q_f32(out+4*i+offsets[0], u0);
+          vst1q_f32(out+4*i+offsets[1], u1);
+          vst1q_f32(out+4*i+offsets[2], u2);
+          vst1q_f32(out+4*i+offsets[3], u3);
+        }
+    }
+  if (add_into)
+    for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+      for (unsigned int v=0; v<4; ++v)
+        out[offsets[v]+i] += in[i][v];
+  else
+    for (unsigned int i=4*n_chunks; i<n_entries; ++i)
+      for (unsigned int v=0; v<4; ++v)
+        out[offsets[v]+i] = in[i][v];
+}
+
+
+
+#elif DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && defined(__ALTIVEC__) && defined(__VSX__)
+
+/**
+ * Specialization for double and POWER VSX.
+ */
+template <>
+class VectorizedArray<double>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 2;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const double x)
+  {
+    data = vec_splats(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  double &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<double *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const double &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 2);
+    return *(reinterpret_cast<const double *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+    data = vec_add(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+    data = vec_sub(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+    data = vec_mul(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+    data = vec_div(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a double address to VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const double *ptr)
+  {
+    data = vec_vsx_ld (0, ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a double address to
+   * VectorizedArray<double>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (double *ptr) const
+  {
+    vec_vsx_st (data, 0, ptr);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const double       *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<2; ++i)
+      *(reinterpret_cast<double *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                double             *base_ptr) const
+  {
+    for (unsigned int i=0; i<2; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const double *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  __vector double data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vec_sqrt(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vec_abs(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_max (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_min (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
+/**
+ * Specialization for float and POWER VSX.
+ */
+template <>
+class VectorizedArray<float>
+{
+public:
+  /**
+   * This gives the number of vectors collected in this class.
+   */
+  static const unsigned int n_array_elements = 4;
+
+  /**
+   * This function can be used to set all data fields to a given scalar.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator = (const float x)
+  {
+    data = vec_splats(x);
+    return *this;
+  }
+
+  /**
+   * Access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  float &
+  operator [] (const unsigned int comp)
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<float *>(&data)+comp);
+  }
+
+  /**
+   * Constant access operator.
+   */
+  DEAL_II_ALWAYS_INLINE
+  const float &
+  operator [] (const unsigned int comp) const
+  {
+    AssertIndexRange (comp, 4);
+    return *(reinterpret_cast<const float *>(&data)+comp);
+  }
+
+  /**
+   * Addition.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator += (const VectorizedArray &vec)
+  {
+    data = vec_add(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Subtraction.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator -= (const VectorizedArray &vec)
+  {
+    data = vec_sub(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Multiplication.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator *= (const VectorizedArray &vec)
+  {
+    data = vec_mul(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Division.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray &
+  operator /= (const VectorizedArray &vec)
+  {
+    data = vec_div(data,vec.data);
+    return *this;
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address. The memory need not be aligned by 16 bytes, as opposed
+   * to casting a float address to VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void load (const float *ptr)
+  {
+    data = vec_vsx_ld (0, ptr);
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address. The memory need not be aligned by
+   * 16 bytes, as opposed to casting a float address to
+   * VectorizedArray<float>*.
+   */
+  DEAL_II_ALWAYS_INLINE
+  void store (float *ptr) const
+  {
+    vec_vsx_st (data, 0, ptr);
+  }
+
+  /**
+   * Load @p n_array_elements from memory into the calling class, starting at
+   * the given address and with given offsets, each entry from the offset
+   * providing one element of the vectorized array.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   this->operator[](v) = base_ptr[offsets[v]];
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void gather (const float        *base_ptr,
+               const unsigned int *offsets)
+  {
+    for (unsigned int i=0; i<4; ++i)
+      *(reinterpret_cast<float *>(&data)+i) = base_ptr[offsets[i]];
+  }
+
+  /**
+   * Write the content of the calling class into memory in form of @p
+   * n_array_elements to the given address and the given offsets, filling the
+   * elements of the vectorized array into each offset.
+   *
+   * This operation corresponds to the following code (but uses a more
+   * efficient implementation in case the hardware allows for that):
+   * @code
+   * for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+   *   base_ptr[offsets[v]] = this->operator[](v);
+   * @endcode
+   */
+  DEAL_II_ALWAYS_INLINE
+  void scatter (const unsigned int *offsets,
+                float              *base_ptr) const
+  {
+    for (unsigned int i=0; i<4; ++i)
+      base_ptr[offsets[i]] = *(reinterpret_cast<const float *>(&data)+i);
+  }
+
+  /**
+   * Actual data field. Since this class represents a POD data type, it
+   * remains public.
+   */
+  __vector float data;
+
+private:
+  /**
+   * Return the square root of this field. Not for use in user code. Use
+   * sqrt(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_sqrt () const
+  {
+    VectorizedArray res;
+    res.data = vec_sqrt(data);
+    return res;
+  }
+
+  /**
+   * Return the absolute value of this field. Not for use in user code. Use
+   * abs(x) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_abs () const
+  {
+    VectorizedArray res;
+    res.data = vec_abs(data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise maximum of this field and another one. Not for
+   * use in user code. Use max(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_max (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_max (data, other.data);
+    return res;
+  }
+
+  /**
+   * Return the component-wise minimum of this field and another one. Not for
+   * use in user code. Use min(x,y) instead.
+   */
+  DEAL_II_ALWAYS_INLINE
+  VectorizedArray
+  get_min (const VectorizedArray &other) const
+  {
+    VectorizedArray res;
+    res.data = vec_min (data, other.data);
+    return res;
+  }
+
+  /**
+   * Make a few functions friends.
+   */
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::sqrt (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::abs  (const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::max  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+  template <typename Number2> friend VectorizedArray<Number2>
+  std::min  (const VectorizedArray<Number2> &, const VectorizedArray<Number2> &);
+};
+
+
+
 #endif // if DEAL_II_COMPILER_VECTORIZATION_LEVEL > 0
 
 
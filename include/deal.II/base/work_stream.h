@@ -34,6 +34,8 @@
 #include <utility>
 #include <memory>
 #include <functional>
+#include <algorithm>
+#include <list>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -135,6 +137,19 @@ DEAL_II_NAMESPACE_OPEN
  * CopyData can be resized in accordance with the number of local DoFs on the
  * current cell.
  *
+ * <h3>Executors</h3>
+ *
+ * By default, the items are processed by a TBB pipeline as described above,
+ * where each item consists of a fixed number of elements of the range. If
+ * the cost of the worker varies a lot between elements, for example in
+ * hp-adaptive computations, this fixed chunking can lead to load imbalance
+ * and idle threads. In that case, an alternative executor can be selected
+ * at run time by calling set_executor() with one of the values of the
+ * Executor enum. It uses the work stealing of tbb::parallel_for on the
+ * individual elements of the range, which hands out elements to threads
+ * adaptively as they become idle. The same executor is then also used for
+ * each color in the version of run() that takes a graph coloring.
+ *
  * The functions in this namespace only really work in parallel when
  * multithread mode was selected during deal.II configuration. Otherwise they
  * simply work on each item sequentially.
@@ -144,6 +159,52 @@ DEAL_II_NAMESPACE_OPEN
  */
 namespace WorkStream
 {
+  /**
+   * An enum describing the strategies for distributing the work of the run()
+   * functions onto the available threads.
+   */
+  enum Executor
+  {
+    /**
+     * Process the range in a TBB pipeline of items with a fixed number of
+     * elements each, and call the copier sequentially and in the order of
+     * the range. This is the default.
+     */
+    pipeline,
+
+    /**
+     * Distribute the elements of the range to the threads by work stealing.
+     * The copier is still called sequentially and in the order of the range:
+     * the range is processed in consecutive waves of
+     * <code>queue_length*chunk_size</code> elements, and the copier works on
+     * the results of one wave while the workers compute the next one.
+     */
+    work_stealing,
+
+    /**
+     * Distribute the elements of the range to the threads by work stealing,
+     * and call the copier right after the worker on the same thread. The
+     * copier is never run concurrently with itself, but the order in which
+     * it receives the results is unspecified. Since results do not need to
+     * be buffered, this is the variant with the least synchronization, but
+     * the outcome of floating point sums in the copier may change from one
+     * run to the next.
+     */
+    work_stealing_unordered_copier
+  };
+
+  /**
+   * Select the executor used by all subsequent calls to the run() functions
+   * with more than one thread. This function should not be called while a
+   * run() function is executing on another thread.
+   */
+  void set_executor (const Executor executor);
+
+  /**
+   * Return the executor selected by set_executor(), or Executor::pipeline if
+   * that function has not been called.
+   */
+  Executor get_executor ();
 
 #ifdef DEAL_II_WITH_THREADS
 
@@ -894,6 +955,246 @@ namespace WorkStream
         const ScratchData    &sample_scratch_data;
         const CopyData       &sample_copy_data;
       };
+
+
+      /**
+       * Run the worker and the copier on all elements of @p iterators with
+       * tbb::parallel_for, letting TBB split the range down to single
+       * elements on demand such that idle threads can steal work from busy
+       * ones. The copier is called on the same thread directly after the
+       * worker, so the caller has to make sure that concurrent calls to it
+       * are safe, e.g. because the elements are of the same color.
+       */
+      template <typename Iterator,
+                typename ScratchData,
+                typename CopyData>
+      void
+      run_work_stealing (const std::vector<Iterator>                  &iterators,
+                         const std::function<void (const Iterator &,
+                                                   ScratchData &,
+                                                   CopyData &)>       &worker,
+                         const std::function<void (const CopyData &)> &copier,
+                         const ScratchData                            &sample_scratch_data,
+                         const CopyData                               &sample_copy_data)
+      {
+        typedef typename std::vector<Iterator>::const_iterator RangeType;
+
+        WorkerAndCopier<Iterator,ScratchData,CopyData>
+        worker_and_copier (worker,
+                           copier,
+                           sample_scratch_data,
+                           sample_copy_data);
+
+        tbb::parallel_for (tbb::blocked_range<RangeType>
+                           (iterators.begin(), iterators.end(),
+                            /*grain_size=*/1),
+                           std::bind (&WorkerAndCopier<Iterator,ScratchData,CopyData>::operator(),
+                                      std::ref(worker_and_copier),
+                                      std::placeholders::_1),
+                           tbb::auto_partitioner());
+      }
+    }
+
+
+    /**
+     * A namespace for the work stealing executor with an ordered copier, see
+     * WorkStream::Executor::work_stealing. The range is processed in waves
+     * of a fixed number of elements. Within a wave, the elements are
+     * distributed to the threads by work stealing and the results are
+     * stored in a buffer with one CopyData object per element. Once a wave
+     * is complete, a task calls the copier on its buffer in the order of the
+     * elements while the workers proceed to the next wave, which uses a
+     * second buffer.
+     */
+    namespace Implementation4
+    {
+      /**
+       * A class that calls the worker function on a range of indices into a
+       * vector of iterators, storing the results in a buffer of CopyData
+       * objects.
+       */
+      template <typename Iterator,
+                typename ScratchData,
+                typename CopyData>
+      class BufferedWorker
+      {
+      public:
+        /**
+         * Constructor.
+         */
+        BufferedWorker (const std::vector<Iterator> &iterators,
+                        const std::function<void (const Iterator &,
+                                                  ScratchData &,
+                                                  CopyData &)> &worker,
+                        const ScratchData &sample_scratch_data)
+          :
+          iterators (iterators),
+          worker (worker),
+          sample_scratch_data (sample_scratch_data),
+          copy_datas (nullptr),
+          wave_start (0)
+        {}
+
+        /**
+         * Set the buffer the results of the elements starting at
+         * @p wave_start are written into.
+         */
+        void set_buffer (std::vector<CopyData> &buffer,
+                         const std::size_t      start)
+        {
+          copy_datas = &buffer;
+          wave_start = start;
+        }
+
+        /**
+         * Call the worker on the elements with the given indices.
+         */
+        void operator() (const tbb::blocked_range<std::size_t> &range)
+        {
+          // get an unused scratch object of the current thread or create
+          // one, see Implementation3::WorkerAndCopier::operator() for why we
+          // do not need a lock here
+          ScratchData *scratch_data = nullptr;
+          {
+            ScratchDataList &scratch_data_list = data.get();
+            for (typename ScratchDataList::iterator p = scratch_data_list.begin();
+                 p != scratch_data_list.end(); ++p)
+              if (p->currently_in_use == false)
+                {
+                  scratch_data = p->scratch_data.get();
+                  p->currently_in_use = true;
+                  break;
+                }
+            if (scratch_data == nullptr)
+              {
+                scratch_data = new ScratchData(sample_scratch_data);
+                scratch_data_list.emplace_back (scratch_data, nullptr, true);
+              }
+          }
+
+          for (std::size_t i=range.begin(); i!=range.end(); ++i)
+            {
+              try
+                {
+                  worker (iterators[i], *scratch_data,
+                          (*copy_datas)[i-wave_start]);
+                }
+              catch (const std::exception &exc)
+                {
+                  Threads::internal::handle_std_exception (exc);
+                }
+              catch (...)
+                {
+                  Threads::internal::handle_unknown_exception ();
+                }
+            }
+
+          {
+            ScratchDataList &scratch_data_list = data.get();
+            for (typename ScratchDataList::iterator p = scratch_data_list.begin();
+                 p != scratch_data_list.end(); ++p)
+              if (p->scratch_data.get() == scratch_data)
+                {
+                  Assert(p->currently_in_use == true, ExcInternalError());
+                  p->currently_in_use = false;
+                }
+          }
+        }
+
+      private:
+        /**
+         * Typedef to a list of scratch data objects, reusing the structure
+         * of Implementation3 without copy data.
+         */
+        typedef
+        std::list<Implementation3::ScratchAndCopyDataObjects<Iterator,ScratchData,CopyData> >
+        ScratchDataList;
+
+        Threads::ThreadLocalStorage<ScratchDataList> data;
+
+        const std::vector<Iterator> &iterators;
+
+        const std::function<void (const Iterator &,
+                                  ScratchData &,
+                                  CopyData &)> worker;
+
+        const ScratchData &sample_scratch_data;
+
+        std::vector<CopyData> *copy_datas;
+
+        std::size_t wave_start;
+      };
+
+
+
+      /**
+       * Run the worker on all elements of @p iterators using work stealing
+       * and the copier in the order of the elements, processing waves of
+       * @p wave_size elements.
+       */
+      template <typename Iterator,
+                typename ScratchData,
+                typename CopyData>
+      void
+      run (const std::vector<Iterator>                  &iterators,
+           const std::function<void (const Iterator &,
+                                     ScratchData &,
+                                     CopyData &)>       &worker,
+           const std::function<void (const CopyData &)> &copier,
+           const ScratchData                            &sample_scratch_data,
+           const CopyData                               &sample_copy_data,
+           const std::size_t                             wave_size)
+      {
+        BufferedWorker<Iterator,ScratchData,CopyData>
+        buffered_worker (iterators, worker, sample_scratch_data);
+
+        std::vector<CopyData> buffers[2];
+        Threads::TaskGroup<> copier_tasks;
+        for (std::size_t wave_start=0, wave=0; wave_start<iterators.size();
+             wave_start+=wave_size, ++wave)
+          {
+            const std::size_t wave_end = std::min(wave_start+wave_size,
+                                                  iterators.size());
+            std::vector<CopyData> &buffer = buffers[wave%2];
+            if (buffer.size() < wave_end-wave_start)
+              buffer.resize (wave_end-wave_start, sample_copy_data);
+
+            // the copier of the previous wave works on the other buffer, so
+            // we can start right away
+            buffered_worker.set_buffer (buffer, wave_start);
+            tbb::parallel_for (tbb::blocked_range<std::size_t> (wave_start, wave_end,
+                                                                /*grain_size=*/1),
+                               std::bind (&BufferedWorker<Iterator,ScratchData,CopyData>::operator(),
+                                          std::ref(buffered_worker),
+                                          std::placeholders::_1),
+                               tbb::auto_partitioner());
+
+            // the copier of the previous wave must be done before we start
+            // the copier of this wave, and before the next wave overwrites
+            // the buffer of the previous one
+            copier_tasks.join_all ();
+            const std::size_t n_items = wave_end-wave_start;
+            copier_tasks += Threads::new_task (std::function<void ()> ([&copier, &buffer, n_items] ()
+            {
+              for (std::size_t i=0; i<n_items; ++i)
+                {
+                  try
+                    {
+                      copier (buffer[i]);
+                    }
+                  catch (const std::exception &exc)
+                    {
+                      Threads::internal::handle_std_exception (exc);
+                    }
+                  catch (...)
+                    {
+                      Threads::internal::handle_unknown_exception ();
+                    }
+                }
+            }));
+          }
+        copier_tasks.join_all ();
+      }
     }
 
   }
@@ -1037,6 +1338,37 @@ namespace WorkStream
           }
       }
 #ifdef DEAL_II_WITH_THREADS
+    else if (get_executor() != pipeline &&
+             static_cast<const std::function<void (const CopyData &)>& >(copier))
+      {
+        // use work stealing on the individual elements, which needs random
+        // access to the range. as for the case without copier below, copy
+        // the iterators into an array
+        std::vector<Iterator> iterators;
+        for (Iterator p=begin; p!=end; ++p)
+          iterators.push_back (p);
+
+        if (get_executor() == work_stealing)
+          internal::Implementation4::run<Iterator,ScratchData,CopyData>
+          (iterators, worker, copier,
+           sample_scratch_data, sample_copy_data,
+           static_cast<std::size_t>(queue_length)*chunk_size);
+        else
+          {
+            // call the copier directly after the worker, but never
+            // concurrently with itself
+            Threads::Mutex copier_mutex;
+            const std::function<void (const CopyData &)> copier_function (copier);
+            internal::Implementation3::run_work_stealing<Iterator,ScratchData,CopyData>
+            (iterators, worker,
+             [&copier_mutex, &copier_function] (const CopyData &copy_data)
+            {
+              Threads::Mutex::ScopedLock lock (copier_mutex);
+              copier_function (copy_data);
+            },
+            sample_scratch_data, sample_copy_data);
+          }
+      }
     else // have TBB and use more than one thread
       {
         // Check that the copier exist
@@ -1148,7 +1480,15 @@ namespace WorkStream
       {
         // loop over the various colors of what we're given
         for (unsigned int color=0; color<colored_iterators.size(); ++color)
-          if (colored_iterators[color].size() > 0)
+          if (colored_iterators[color].size() > 0 && get_executor() != pipeline)
+            {
+              // no need to synchronize the copier, the cells of one color do
+              // not conflict
+              internal::Implementation3::run_work_stealing<Iterator,ScratchData,CopyData>
+              (colored_iterators[color], worker, copier,
+               sample_scratch_data, sample_copy_data);
+            }
+          else if (colored_iterators[color].size() > 0)
             {
               typedef
               internal::Implementation3::WorkerAndCopier<Iterator,ScratchData,CopyData>
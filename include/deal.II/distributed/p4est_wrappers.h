@@ -25,6 +25,9 @@
 #  include <p4est_ghost.h>
 #  include <p4est_communication.h>
 #  include <p4est_iterate.h>
+#  if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+#    include <p4est_io.h>
+#  endif
 
 #  include <p8est_bits.h>
 #  include <p8est_extended.h>
@@ -32,6 +35,9 @@
 #  include <p8est_ghost.h>
 #  include <p8est_communication.h>
 #  include <p8est_iterate.h>
+#  if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+#    include <p8est_io.h>
+#  endif
 
 #include <map>
 #include <set>
@@ -285,6 +291,25 @@ namespace internal
       static
       size_t (&connectivity_memory_used) (types<2>::connectivity *p4est);
 
+#if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+      static
+      void (&comm_count_pertree) (types<2>::forest *p4est,
+                                  p4est_gloidx_t *pertree);
+
+      static
+      sc_array_t *(&deflate_quadrants) (types<2>::forest *p4est,
+                                        sc_array_t **data);
+
+      static
+      types<2>::forest *(&inflate) (MPI_Comm mpicomm,
+                                    types<2>::connectivity *connectivity,
+                                    const p4est_gloidx_t *global_first_quadrant,
+                                    const p4est_gloidx_t *pertree,
+                                    sc_array_t *quadrants,
+                                    sc_array_t *data,
+                                    void *user_pointer);
+#endif
+
       template <int spacedim>
       static void iterate(dealii::internal::p4est::types<2>::forest *parallel_forest,
                           dealii::internal::p4est::types<2>::ghost *parallel_ghost,
@@ -472,6 +497,25 @@ namespace internal
       static
       size_t (&connectivity_memory_used) (types<3>::connectivity *p4est);
 
+#if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+      static
+      void (&comm_count_pertree) (types<3>::forest *p4est,
+                                  p4est_gloidx_t *pertree);
+
+      static
+      sc_array_t *(&deflate_quadrants) (types<3>::forest *p4est,
+                                        sc_array_t **data);
+
+      static
+      types<3>::forest *(&inflate) (MPI_Comm mpicomm,
+                                    types<3>::connectivity *connectivity,
+                                    const p4est_gloidx_t *global_first_quadrant,
+                                    const p4est_gloidx_t *pertree,
+                                    sc_array_t *quadrants,
+                                    sc_array_t *data,
+                                    void *user_pointer);
+#endif
+
 
 
       static const unsigned int max_level = P8EST_MAXLEVEL;
@@ -109,7 +109,8 @@ namespace parallel
        * constructor. Settings can be combined using bitwise OR.
        *
        * The constructor requires that exactly one of <code>partition_metis</code>,
-       * <code>partition_zorder</code>, and <code>partition_custom_signal</code> be set.
+       * <code>partition_zorder</code>, <code>partition_custom_signal</code>, and
+       * <code>partition_hilbert</code> be set.
        * If no setting is given to the constructor, it will set <code>partition_metis</code>
        * by default.
        */
@@ -186,6 +187,15 @@ namespace parallel
          * active cell partitioning method.
          */
         construct_multigrid_hierarchy = 0x8,
+
+        /**
+         * Partition active cells along a Hilbert space-filling curve through
+         * the cell centers, see GridTools::partition_triangulation_hilbert().
+         * All cells have the same weight. Like <code>partition_zorder</code>,
+         * this scheme does not need METIS, but the partitions are more
+         * compact.
+         */
+        partition_hilbert = 0x10,
       };
 
 
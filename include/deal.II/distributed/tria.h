@@ -52,6 +52,9 @@ DEAL_II_NAMESPACE_OPEN
 
 #ifdef DEAL_II_WITH_P4EST
 
+class CheckpointWriter;
+class CheckpointReader;
+
 namespace internal
 {
   namespace DoFHandler
@@ -606,6 +609,43 @@ namespace parallel
       void load(const char *filename,
                 const bool autopartition = true);
 
+      /**
+       * Save the refinement information from the coarse mesh, along with the
+       * cell-based data registered through register_data_attach(), into the
+       * checkpoint file represented by @p writer. In contrast to the
+       * save() function above, all processors write their part of the mesh
+       * into the same binary file through MPI I/O, and the file can hold
+       * other data such as vectors (see
+       * LinearAlgebra::distributed::Vector::save()) next to the mesh. This
+       * is a collective operation.
+       *
+       * @note This function requires p4est version 2.0 or newer.
+       */
+      void save (CheckpointWriter &writer) const;
+
+      /**
+       * Load the refinement information saved with save(CheckpointWriter&)
+       * from the checkpoint file represented by @p reader. The mesh must
+       * contain the same coarse mesh that was used when saving, and no
+       * refinement.
+       *
+       * If the number of processors is the same as when saving, the forest
+       * is built directly from the part of the file written by the processor
+       * with the same rank, which is mapped into memory, and the partitioning
+       * of the saved mesh is kept. Otherwise, the saved cells are
+       * distributed evenly among the processors and the mesh is repartitioned
+       * with repartition(). In both cases, cell-based data can be read with
+       * notify_ready_to_unpack() after calling this function. Since the
+       * numbering of degrees of freedom changes with the partitioning,
+       * vectors stored with LinearAlgebra::distributed::Vector::save() can
+       * only be read back on the same number of processors; use cell-based
+       * data, e.g. through parallel::distributed::SolutionTransfer, to
+       * restart on a different number of processors.
+       *
+       * @note This function requires p4est version 2.0 or newer.
+       */
+      void load (const CheckpointReader &reader);
+
       /**
        * Register a function with the current Triangulation object that will
        * be used to attach data to active cells before
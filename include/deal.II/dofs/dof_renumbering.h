@@ -27,6 +27,8 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+template <int dim, typename Number> class MatrixFree;
+
 /**
  * Implementation of a number of renumbering algorithms for the degrees of
  * freedom on a triangulation.
@@ -197,9 +199,11 @@ DEAL_II_NAMESPACE_OPEN
  * rule that each degree of freedom is ordered according to the first cell in
  * the ordered vector it belongs to.
  *
- * Applications of this scheme are downstream() and clock_wise_dg(). The first
- * orders the cells according to a downstream direction and then applies
- * cell_wise().
+ * Applications of this scheme are downstream(), clock_wise_dg() and
+ * hilbert(). The first orders the cells according to a downstream direction
+ * and then applies cell_wise(). The last one orders the cells along a
+ * Hilbert space-filling curve, which places degrees of freedom that are
+ * close in space at close indices and thus improves cache locality.
  *
  * @note For DG elements, the internal numbering in each cell remains
  * unaffected. This cannot be guaranteed for continuous elements anymore,
@@ -214,6 +218,17 @@ DEAL_II_NAMESPACE_OPEN
  * (iterative or direct ones) on the numbering of the degrees of freedom.
  *
  *
+ * <h3>Numbering for matrix-free loops</h3>
+ *
+ * The matrix_free_data_locality() function numbers the degrees of freedom in
+ * the order in which the cell loop of a MatrixFree object first accesses
+ * them. The entries of a vector read and written by consecutive batches of
+ * cells then lie close to each other in memory, which makes better use of
+ * caches and hardware prefetching than the numbering produced by
+ * DoFHandler::distribute_dofs(), in particular for higher order elements
+ * and after adaptive refinement.
+ *
+ *
  * <h3>A comparison of reordering strategies</h3>
  *
  * As a benchmark of comparison, let us consider what the different sparsity
@@ -932,6 +947,48 @@ namespace DoFRenumbering
                         const Point<DoFHandlerType::space_dimension> &center,
                         const bool                                    counter);
 
+  /**
+   * Cell-wise numbering along a Hilbert space-filling curve.
+   *
+   * This function sorts the active cells by the position of their centers
+   * along a Hilbert curve through the domain (see
+   * GridTools::compute_hilbert_order()) and calls cell_wise() with this
+   * order. Since cells that are close along the curve are also close in
+   * space, degrees of freedom with close indices are located close to each
+   * other, which improves the cache locality of operations that loop over
+   * the cells, such as matrix assembly, matrix-vector products, or
+   * matrix-free operator evaluation. In contrast to Cuthill_McKee(), this
+   * function does not need a sparsity pattern and therefore is cheap even
+   * for large problems. It works for both continuous and discontinuous
+   * elements and does not use any external library.
+   *
+   * The same order of the cells is used by
+   * GridTools::partition_triangulation_hilbert(), so the degrees of freedom
+   * of each subdomain form compact groups.
+   */
+  template <typename DoFHandlerType>
+  void
+  hilbert (DoFHandlerType &dof_handler);
+
+  /**
+   * Cell-wise numbering along a Hilbert space-filling curve on one level.
+   * See the other function with the same name.
+   */
+  template <typename DoFHandlerType>
+  void
+  hilbert (DoFHandlerType     &dof_handler,
+           const unsigned int  level);
+
+  /**
+   * Compute the renumbering vector needed by the hilbert() function. Does
+   * not perform the renumbering on the DoFHandler dofs but returns the
+   * renumbering vector.
+   */
+  template <typename DoFHandlerType>
+  void
+  compute_hilbert (std::vector<types::global_dof_index> &new_dof_indices,
+                   const DoFHandlerType                 &dof_handler);
+
   /**
    * @}
    */
@@ -1072,6 +1129,55 @@ namespace DoFRenumbering
    * @}
    */
 
+  /**
+   * @name Numberings based on matrix-free loops
+   * @{
+   */
+
+  /**
+   * Renumber the degrees of freedom in the order in which they are accessed
+   * by MatrixFree::cell_loop() for the given @p matrix_free object, i.e.,
+   * the degrees of freedom of the first batch of cells come first, followed
+   * by the not yet numbered degrees of freedom of the second batch, etc.
+   * Within a batch, the cells are visited in the order of the lanes of the
+   * vectorization, and the degrees of freedom within a cell in the order
+   * given by DoFCellAccessor::get_dof_indices(). Degrees of freedom that are
+   * not accessed by any cell of the loop, which can only happen if not all
+   * cells are part of @p matrix_free, are put at the end in their old
+   * order.
+   *
+   * @p dof_handler must be one of the DoFHandler objects @p matrix_free was
+   * set up with. If @p matrix_free works on a level of a multigrid
+   * hierarchy, the degrees of freedom on this level are renumbered,
+   * otherwise the active degrees of freedom. In parallel, only the locally
+   * owned degrees of freedom are renumbered, and the set of locally owned
+   * degrees of freedom is not changed.
+   *
+   * Since the renumbering changes the degrees of freedom, @p matrix_free
+   * needs to be set up again afterwards, along with all constraints and
+   * vectors based on the old numbering.
+   */
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>               &dof_handler,
+                             const MatrixFree<dim,Number>  &matrix_free);
+
+  /**
+   * Compute the renumbering vector needed by the matrix_free_data_locality()
+   * function. Does not perform the renumbering on the DoFHandler dofs but
+   * returns the renumbering vector, with one entry for each locally owned
+   * degree of freedom.
+   */
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_dof_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free);
+
+  /**
+   * @}
+   */
+
 
 
   /**
@@ -520,6 +520,42 @@ namespace DoFTools
                          const bool                 keep_constrained_dofs = true,
                          const types::subdomain_id  subdomain_id          = numbers::invalid_subdomain_id);
 
+  /**
+   * Compute which entries of a matrix built on the given @p dof_handler may
+   * possibly be nonzero, and store them directly in the compressed
+   * SparsityPattern @p sparsity_pattern. The result is the same as when
+   * calling the previous make_sparsity_pattern() function with a
+   * DynamicSparsityPattern and the same arguments, and copying the result
+   * into a SparsityPattern (see there for a description of all of the
+   * arguments).
+   *
+   * The previous function adds the entries of one cell after the other to a
+   * dynamic sparsity pattern that needs to grow as entries are added, and
+   * which then has to be copied into the final SparsityPattern. For large
+   * problems, this takes about as long as assembling the matrix, and both
+   * objects have to be in memory at the same time. This function instead
+   * works in two passes over the rows of the matrix: the first one computes
+   * the exact number of entries in each row, after which the final
+   * SparsityPattern is allocated once (see the SparsityPattern::copy_from()
+   * function that takes the row lengths and a function filling the rows);
+   * the second pass writes the sorted column indices of each row directly
+   * into it. Both passes, as well as the setup of the information on which
+   * cells touch which rows, run in parallel on all available threads.
+   *
+   * The previous content of @p sparsity_pattern is lost. Its size is set to
+   * <code>dof_handler.n_dofs()</code> in both directions, and it is in
+   * compressed mode afterwards.
+   *
+   * @ingroup constraints
+   */
+  template <typename DoFHandlerType>
+  void
+  make_compressed_sparsity_pattern (const DoFHandlerType      &dof_handler,
+                                    SparsityPattern           &sparsity_pattern,
+                                    const ConstraintMatrix    &constraints           = ConstraintMatrix(),
+                                    const bool                 keep_constrained_dofs = true,
+                                    const types::subdomain_id  subdomain_id          = numbers::invalid_subdomain_id);
+
   /**
    * Compute which entries of a matrix built on the given @p dof_handler may
    * possibly be nonzero, and create a sparsity pattern object that represents
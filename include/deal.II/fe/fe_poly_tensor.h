@@ -24,9 +24,58 @@
 #include <deal.II/base/quadrature.h>
 #include <deal.II/base/thread_management.h>
 
+#include <vector>
+
 
 DEAL_II_NAMESPACE_OPEN
 
+template <int, typename> class FEValuesBatch;
+
+namespace internal
+{
+  namespace FE_PolyTensor
+  {
+    /**
+     * On noncartesian grids, the sign of the DoFs associated with the faces
+     * of the elements has to be changed in some cases. These functions
+     * determine the DoFs of an element with @p dofs_per_face DoFs per face
+     * that need this sign change on the given cell for elements with
+     * #mapping_raviart_thomas and #mapping_nedelec, respectively, and store
+     * the signs in @p face_sign.
+     */
+    void
+    get_face_sign_change_rt (const dealii::Triangulation<1>::cell_iterator &cell,
+                             const unsigned int                             dofs_per_face,
+                             std::vector<double>                           &face_sign);
+
+    void
+    get_face_sign_change_rt (const dealii::Triangulation<2>::cell_iterator &cell,
+                             const unsigned int                             dofs_per_face,
+                             std::vector<double>                           &face_sign);
+
+    void
+    get_face_sign_change_rt (const dealii::Triangulation<3>::cell_iterator &cell,
+                             const unsigned int                             dofs_per_face,
+                             std::vector<double>                           &face_sign);
+
+    void
+    get_face_sign_change_nedelec (const dealii::Triangulation<1>::cell_iterator &cell,
+                                  const unsigned int                             dofs_per_face,
+                                  std::vector<double>                           &face_sign);
+
+    void
+    get_face_sign_change_nedelec (const dealii::Triangulation<2>::cell_iterator &cell,
+                                  const unsigned int                             dofs_per_face,
+                                  std::vector<double>                           &face_sign);
+
+    void
+    get_face_sign_change_nedelec (const dealii::Triangulation<3>::cell_iterator &cell,
+                                  const unsigned int                             dofs_per_face,
+                                  std::vector<double>                           &face_sign);
+  }
+}
+
+
 /**
  * This class gives a unified framework for the implementation of
  * FiniteElement classes based on Tensor valued polynomial spaces like
@@ -204,6 +253,12 @@ protected:
    */
   MappingType mapping_type;
 
+  /**
+   * FEValuesBatch needs to know the mapping type to transform the shape
+   * functions of this element itself.
+   */
+  template <int, typename> friend class FEValuesBatch;
+
 
   /* NOTE: The following function has its definition inlined into the class declaration
      because we otherwise run into a compiler error with MS Visual Studio. */
@@ -0,0 +1,661 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_fe_values_batch_h
+#define dealii_fe_values_batch_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/quadrature.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/fe/fe.h>
+#include <deal.II/fe/fe_update_flags.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_accessor.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+template <int, int> class MappingQGeneric;
+
+
+/*!@addtogroup feaccess */
+/*@{*/
+
+/**
+ * A class that, like FEValues, evaluates shape functions, their gradients,
+ * and the geometry of the mapping at the quadrature points of cells, but
+ * does so for a whole batch of cells at once. The cells of a batch are
+ * mapped to the lanes of a VectorizedArray, i.e., a value such as
+ * JxW() or shape_grad() returned by this class contains the respective
+ * value on VectorizedArray<Number>::n_array_elements cells. The Jacobians,
+ * inverse Jacobians, and the transformations of shape functions to the real
+ * cells are computed with vectorized arithmetic across these cells, which is
+ * considerably faster than calling FEValues::reinit() for one cell after
+ * the other.
+ *
+ * This class is intended for matrix-based assembly of elements that cannot
+ * be used with the MatrixFree framework, such as FE_Nedelec,
+ * FE_RaviartThomas, or FESystem objects composed of these and of scalar
+ * elements. In a typical assembly loop, one collects the cells to be worked
+ * on into groups of up to n_array_elements cells, and then, for each group,
+ * calls reinit() and computes the local matrices of all cells of the group
+ * at once:
+ * @code
+ *   FEValuesBatch<dim> fe_values (mapping, fe, quadrature,
+ *                                 update_values | update_gradients |
+ *                                 update_JxW_values);
+ *   for (unsigned int batch=0; batch<cell_batches.size(); ++batch)
+ *     {
+ *       fe_values.reinit (cell_batches[batch]);
+ *       for (unsigned int q=0; q<fe_values.n_quadrature_points; ++q)
+ *         for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+ *           for (unsigned int j=0; j<fe.dofs_per_cell; ++j)
+ *             cell_matrix(i,j) += (fe_values.shape_grad(i,q) *
+ *                                  fe_values.shape_grad(j,q) *
+ *                                  fe_values.JxW(q));
+ *       for (unsigned int lane=0; lane<fe_values.n_cells(); ++lane)
+ *         {
+ *           // copy entry 'lane' of cell_matrix(i,j) into the global matrix,
+ *           // using the dof indices of cell_batches[batch][lane]
+ *         }
+ *     }
+ * @endcode
+ * Here, <code>cell_matrix</code> is a FullMatrix<VectorizedArray<double>>
+ * or similar. Since objects of this class can be copied, they can also be
+ * used as (part of) the scratch data of WorkStream::run() if the range over
+ * which WorkStream iterates consists of batches of cells rather than
+ * individual cells.
+ *
+ * If the last batch contains fewer cells than there are lanes, then the
+ * unused lanes are filled with the data of the first cell of the batch,
+ * except for JxW() which is zero on these lanes. Sums of the form shown
+ * above are then simply zero on the unused lanes.
+ *
+ * <h3>Supported mappings, elements, and flags</h3>
+ *
+ * The mapping must be of type MappingQGeneric or a class derived from it
+ * (such as MappingQ1 or MappingQ1Eulerian); the locations of its support
+ * points are taken from the mapping for each cell. The finite element may
+ * be any element whose base elements are either primitive elements whose
+ * shape functions on the real cell are the same as on the reference cell
+ * (such as FE_Q, FE_DGQ, FE_DGP, FE_Q_Hierarchical), or elements derived
+ * from FE_PolyTensor (such as FE_Nedelec, FE_RaviartThomas,
+ * FE_RaviartThomasNodal, FE_BDM, FE_ABF, and their discontinuous
+ * variants). The values and gradients computed by this class for these
+ * elements are the same as the ones computed by FEValues, up to round-off.
+ *
+ * The update flags that can be given to the constructor are
+ * #update_values, #update_gradients, #update_quadrature_points,
+ * #update_JxW_values, #update_jacobians, and #update_inverse_jacobians.
+ *
+ * @ingroup feaccess
+ */
+template <int dim, typename Number=double>
+class FEValuesBatch : public Subscriptor
+{
+public:
+  /**
+   * Dimension in which this object operates.
+   */
+  static const unsigned int dimension = dim;
+
+  /**
+   * The number of cells that are worked on at once, i.e., the number of
+   * lanes of a VectorizedArray<Number>.
+   */
+  static const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+
+  /**
+   * Number of quadrature points.
+   */
+  const unsigned int n_quadrature_points;
+
+  /**
+   * Number of shape functions per cell.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * Constructor. Gets cell independent data from mapping and finite element
+   * objects, matching the quadrature rule and update flags.
+   */
+  FEValuesBatch (const Mapping<dim>       &mapping,
+                 const FiniteElement<dim> &fe,
+                 const Quadrature<dim>    &quadrature,
+                 const UpdateFlags         update_flags);
+
+  /**
+   * Constructor. This constructor is equivalent to the other one except that
+   * it makes the object use a $Q_1$ mapping (i.e., an object of type
+   * MappingQGeneric(1)) implicitly.
+   */
+  FEValuesBatch (const FiniteElement<dim> &fe,
+                 const Quadrature<dim>    &quadrature,
+                 const UpdateFlags         update_flags);
+
+  /**
+   * Reinitialize the values, gradients, and geometric quantities for the
+   * given cells. The number of cells must be between one and n_lanes. The
+   * cell iterator type can be any iterator into a Triangulation or
+   * DoFHandler, active or not.
+   */
+  template <typename CellIteratorType>
+  void reinit (const std::vector<CellIteratorType> &cells);
+
+  /**
+   * Return the number of cells the object was last reinitialized with.
+   */
+  unsigned int n_cells () const;
+
+  /**
+   * Return the cell in the given lane of the current batch.
+   */
+  const typename Triangulation<dim>::cell_iterator &
+  get_cell (const unsigned int lane) const;
+
+  /**
+   * Value of the shape function with index @p function_no at quadrature
+   * point @p q_point on the cells of the current batch. The shape function
+   * must be primitive, otherwise use shape_value_component().
+   */
+  VectorizedArray<Number>
+  shape_value (const unsigned int function_no,
+               const unsigned int q_point) const;
+
+  /**
+   * Value of component @p component of the shape function with index @p
+   * function_no at quadrature point @p q_point on the cells of the current
+   * batch.
+   */
+  VectorizedArray<Number>
+  shape_value_component (const unsigned int function_no,
+                         const unsigned int q_point,
+                         const unsigned int component) const;
+
+  /**
+   * Gradient of the shape function with index @p function_no at quadrature
+   * point @p q_point on the cells of the current batch, with respect to
+   * real cell coordinates. The shape function must be primitive, otherwise
+   * use shape_grad_component().
+   */
+  const Tensor<1,dim,VectorizedArray<Number> > &
+  shape_grad (const unsigned int function_no,
+              const unsigned int q_point) const;
+
+  /**
+   * Gradient of component @p component of the shape function with index @p
+   * function_no at quadrature point @p q_point on the cells of the current
+   * batch.
+   */
+  Tensor<1,dim,VectorizedArray<Number> >
+  shape_grad_component (const unsigned int function_no,
+                        const unsigned int q_point,
+                        const unsigned int component) const;
+
+  /**
+   * Location of the quadrature point @p q_point in real space on the cells
+   * of the current batch.
+   */
+  const Point<dim,VectorizedArray<Number> > &
+  quadrature_point (const unsigned int q_point) const;
+
+  /**
+   * Mapped quadrature weight, i.e., the determinant of the Jacobian times
+   * the quadrature weight, at quadrature point @p q_point. This value is
+   * zero on lanes that do not correspond to a cell of the current batch.
+   */
+  const VectorizedArray<Number> &
+  JxW (const unsigned int q_point) const;
+
+  /**
+   * Jacobian of the transformation from the reference to the real cell at
+   * quadrature point @p q_point.
+   */
+  const Tensor<2,dim,VectorizedArray<Number> > &
+  jacobian (const unsigned int q_point) const;
+
+  /**
+   * Inverse of the Jacobian of the transformation from the reference to the
+   * real cell at quadrature point @p q_point.
+   */
+  const Tensor<2,dim,VectorizedArray<Number> > &
+  inverse_jacobian (const unsigned int q_point) const;
+
+  /**
+   * Return a reference to the mapping object used by this object.
+   */
+  const Mapping<dim> &get_mapping () const;
+
+  /**
+   * Return a reference to the finite element object used by this object.
+   */
+  const FiniteElement<dim> &get_fe () const;
+
+  /**
+   * Return a reference to the quadrature formula used by this object.
+   */
+  const Quadrature<dim> &get_quadrature () const;
+
+  /**
+   * Return the update flags set for this object.
+   */
+  UpdateFlags get_update_flags () const;
+
+  /**
+   * Return an estimate for the memory consumption, in bytes, of this object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcUnsupportedMapping,
+                    "FEValuesBatch can only be used with mappings of type "
+                    "MappingQGeneric or derived classes.");
+
+  /**
+   * Exception
+   */
+  DeclException1 (ExcUnsupportedElement,
+                  std::string,
+                  << "FEValuesBatch does not know how to transform the shape "
+                  << "functions of the element " << arg1 << " to the real "
+                  << "cell.");
+
+private:
+  /**
+   * The ways in which the shape functions of the supported base elements
+   * are transformed from the reference cell to the real cell. The first
+   * entries correspond to the MappingType of FE_PolyTensor, with the
+   * additional distinction whether the signs of some shape functions depend
+   * on the cell.
+   */
+  enum Transformation
+  {
+    /**
+     * Values are the same as on the reference cell, gradients are
+     * transformed by the inverse transpose of the Jacobian.
+     */
+    identity,
+    /**
+     * Covariant transformation, as for FE_Nedelec.
+     */
+    covariant,
+    /**
+     * Contravariant transformation.
+     */
+    contravariant,
+    /**
+     * Piola transformation, as for FE_RaviartThomas or FE_BDM.
+     */
+    piola
+  };
+
+  /**
+   * Set up the data on the reference cell. Called from the constructors.
+   */
+  void initialize ();
+
+  /**
+   * Determine how the shape functions of the given base element are
+   * transformed to the real cell, and whether their signs depend on the
+   * cell. Throws an exception if the element is not supported.
+   */
+  static
+  void
+  get_transformation (const FiniteElement<dim> &fe,
+                      Transformation           &transformation,
+                      MappingType              &sign_change_type);
+
+  /**
+   * Compute the geometric data and the transformed shape functions on the
+   * cells stored in #cells.
+   */
+  void compute_values ();
+
+  /**
+   * The mapping, finite element, and quadrature formula.
+   */
+  SmartPointer<const Mapping<dim>,FEValuesBatch<dim,Number> > mapping;
+  SmartPointer<const MappingQGeneric<dim,dim>,FEValuesBatch<dim,Number> > mapping_q;
+  SmartPointer<const FiniteElement<dim>,FEValuesBatch<dim,Number> > fe;
+  const Quadrature<dim> quadrature;
+
+  /**
+   * The flags given to the constructor.
+   */
+  const UpdateFlags update_flags;
+
+  /**
+   * Whether the second derivatives of the mapping are needed, which is the
+   * case if the gradients of non-primitive shape functions are to be
+   * computed.
+   */
+  bool need_mapping_second_derivatives;
+
+  /**
+   * Values, first and second derivatives of the shape functions of the
+   * mapping at the quadrature points, indexed by quadrature point and shape
+   * function of the mapping.
+   */
+  Table<2,double>          mapping_values;
+  Table<2,Tensor<1,dim> >  mapping_derivatives;
+  Table<2,Tensor<2,dim> >  mapping_second_derivatives;
+
+  /**
+   * For each shape function, the first row in #shape_values and
+   * #shape_gradients that belongs to it, and the first of its nonzero
+   * vector components. Primitive shape functions occupy one row,
+   * non-primitive ones one row per nonzero component.
+   */
+  std::vector<unsigned int> shape_function_to_row;
+  std::vector<unsigned int> first_component;
+
+  /**
+   * For each shape function, how it is transformed, and the index into
+   * #sign_changes for shape functions whose signs depend on the cell (or
+   * numbers::invalid_unsigned_int).
+   */
+  std::vector<Transformation> transformations;
+  std::vector<unsigned int>   sign_change_index;
+
+  /**
+   * For each base element whose shape functions may change signs, the kind
+   * of sign change, and the signs of its shape functions on the cells of
+   * the current batch.
+   */
+  std::vector<std::pair<unsigned int,MappingType> >  sign_change_base_elements;
+  std::vector<std::vector<VectorizedArray<Number> > > sign_changes;
+
+  /**
+   * Values and gradients of the shape functions on the reference cell,
+   * indexed by row and quadrature point.
+   */
+  Table<2,double>         reference_values;
+  Table<2,Tensor<1,dim> > reference_gradients;
+
+  /**
+   * Values and gradients of the shape functions on the cells of the current
+   * batch, indexed by row and quadrature point.
+   */
+  Table<2,VectorizedArray<Number> >                shape_values;
+  Table<2,Tensor<1,dim,VectorizedArray<Number> > > shape_gradients;
+
+  /**
+   * Geometric data at the quadrature points.
+   */
+  AlignedVector<Point<dim,VectorizedArray<Number> > >    quadrature_points;
+  AlignedVector<VectorizedArray<Number> >                JxW_values;
+  AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians;
+  AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > inverse_jacobians;
+
+  /**
+   * Inverses of the determinants of the Jacobians, as needed for the Piola
+   * transformation.
+   */
+  AlignedVector<VectorizedArray<Number> > inverse_determinants;
+
+  /**
+   * Gradients of the Jacobians, pushed forward to the real cell, as
+   * described for #update_jacobian_pushed_forward_grads.
+   */
+  AlignedVector<Tensor<3,dim,VectorizedArray<Number> > > jacobian_pushed_forward_grads;
+
+  /**
+   * The cells of the current batch. Unused lanes hold the first cell.
+   */
+  std::vector<typename Triangulation<dim>::cell_iterator> cells;
+  unsigned int n_filled_lanes;
+
+  /**
+   * Mapping support points of the cells of the current batch.
+   */
+  AlignedVector<Point<dim,VectorizedArray<Number> > > mapping_support_points;
+};
+
+/*@}*/
+
+
+/*------------------------ Inline functions: FEValuesBatch ------------------------*/
+
+#ifndef DOXYGEN
+
+template <int dim, typename Number>
+template <typename CellIteratorType>
+inline
+void
+FEValuesBatch<dim,Number>::reinit (const std::vector<CellIteratorType> &new_cells)
+{
+  Assert (new_cells.size() > 0 && new_cells.size() <= n_lanes,
+          ExcIndexRange (new_cells.size(), 1, n_lanes+1));
+  for (unsigned int lane=0; lane<new_cells.size(); ++lane)
+    {
+      Assert (&new_cells[lane]->get_triangulation() == &new_cells[0]->get_triangulation(),
+              ExcMessage ("All cells of a batch must belong to the same triangulation."));
+      cells[lane] = typename Triangulation<dim>::cell_iterator (new_cells[lane]);
+    }
+  for (unsigned int lane=new_cells.size(); lane<n_lanes; ++lane)
+    cells[lane] = typename Triangulation<dim>::cell_iterator (new_cells[0]);
+  n_filled_lanes = new_cells.size();
+
+  compute_values ();
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+FEValuesBatch<dim,Number>::n_cells () const
+{
+  return n_filled_lanes;
+}
+
+
+
+template <int dim, typename Number>
+inline
+const typename Triangulation<dim>::cell_iterator &
+FEValuesBatch<dim,Number>::get_cell (const unsigned int lane) const
+{
+  AssertIndexRange (lane, n_filled_lanes);
+  return cells[lane];
+}
+
+
+
+template <int dim, typename Number>
+inline
+VectorizedArray<Number>
+FEValuesBatch<dim,Number>::shape_value (const unsigned int function_no,
+                                        const unsigned int q_point) const
+{
+  Assert (update_flags & update_values,
+          ExcMessage ("You need to pass update_values to the constructor."));
+  AssertIndexRange (function_no, dofs_per_cell);
+  Assert (fe->is_primitive (function_no),
+          ExcMessage ("The shape function is not primitive, use "
+                      "shape_value_component() instead."));
+  return shape_values (shape_function_to_row[function_no], q_point);
+}
+
+
+
+template <int dim, typename Number>
+inline
+VectorizedArray<Number>
+FEValuesBatch<dim,Number>::shape_value_component (const unsigned int function_no,
+                                                  const unsigned int q_point,
+                                                  const unsigned int component) const
+{
+  Assert (update_flags & update_values,
+          ExcMessage ("You need to pass update_values to the constructor."));
+  AssertIndexRange (function_no, dofs_per_cell);
+  AssertIndexRange (component, fe->n_components());
+  if (fe->get_nonzero_components (function_no)[component] == false)
+    return make_vectorized_array (Number(0));
+
+  return shape_values (shape_function_to_row[function_no] +
+                       (fe->is_primitive (function_no) ?
+                        0 : component - first_component[function_no]),
+                       q_point);
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Tensor<1,dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::shape_grad (const unsigned int function_no,
+                                       const unsigned int q_point) const
+{
+  Assert (update_flags & update_gradients,
+          ExcMessage ("You need to pass update_gradients to the constructor."));
+  AssertIndexRange (function_no, dofs_per_cell);
+  Assert (fe->is_primitive (function_no),
+          ExcMessage ("The shape function is not primitive, use "
+                      "shape_grad_component() instead."));
+  return shape_gradients (shape_function_to_row[function_no], q_point);
+}
+
+
+
+template <int dim, typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEValuesBatch<dim,Number>::shape_grad_component (const unsigned int function_no,
+                                                 const unsigned int q_point,
+                                                 const unsigned int component) const
+{
+  Assert (update_flags & update_gradients,
+          ExcMessage ("You need to pass update_gradients to the constructor."));
+  AssertIndexRange (function_no, dofs_per_cell);
+  AssertIndexRange (component, fe->n_components());
+  if (fe->get_nonzero_components (function_no)[component] == false)
+    return Tensor<1,dim,VectorizedArray<Number> >();
+
+  return shape_gradients (shape_function_to_row[function_no] +
+                          (fe->is_primitive (function_no) ?
+                           0 : component - first_component[function_no]),
+                          q_point);
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Point<dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::quadrature_point (const unsigned int q_point) const
+{
+  Assert (update_flags & update_quadrature_points,
+          ExcMessage ("You need to pass update_quadrature_points to the constructor."));
+  AssertIndexRange (q_point, n_quadrature_points);
+  return quadrature_points[q_point];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const VectorizedArray<Number> &
+FEValuesBatch<dim,Number>::JxW (const unsigned int q_point) const
+{
+  Assert (update_flags & update_JxW_values,
+          ExcMessage ("You need to pass update_JxW_values to the constructor."));
+  AssertIndexRange (q_point, n_quadrature_points);
+  return JxW_values[q_point];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Tensor<2,dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::jacobian (const unsigned int q_point) const
+{
+  Assert (update_flags & update_jacobians,
+          ExcMessage ("You need to pass update_jacobians to the constructor."));
+  AssertIndexRange (q_point, n_quadrature_points);
+  return jacobians[q_point];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Tensor<2,dim,VectorizedArray<Number> > &
+FEValuesBatch<dim,Number>::inverse_jacobian (const unsigned int q_point) const
+{
+  Assert (update_flags & update_inverse_jacobians,
+          ExcMessage ("You need to pass update_inverse_jacobians to the constructor."));
+  AssertIndexRange (q_point, n_quadrature_points);
+  return inverse_jacobians[q_point];
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Mapping<dim> &
+FEValuesBatch<dim,Number>::get_mapping () const
+{
+  return *mapping;
+}
+
+
+
+template <int dim, typename Number>
+inline
+const FiniteElement<dim> &
+FEValuesBatch<dim,Number>::get_fe () const
+{
+  return *fe;
+}
+
+
+
+template <int dim, typename Number>
+inline
+const Quadrature<dim> &
+FEValuesBatch<dim,Number>::get_quadrature () const
+{
+  return quadrature;
+}
+
+
+
+template <int dim, typename Number>
+inline
+UpdateFlags
+FEValuesBatch<dim,Number>::get_update_flags () const
+{
+  return update_flags;
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -734,6 +734,12 @@ protected:
    * functions on its MappingQGeneric(1) sub-object.
    */
   template <int, int> friend class MappingQ;
+
+  /**
+   * Make FEValuesBatch a friend since it needs to call
+   * compute_mapping_support_points().
+   */
+  template <int, typename> friend class FEValuesBatch;
 };
 
 
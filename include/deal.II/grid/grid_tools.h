@@ -30,6 +30,7 @@
 #include <bitset>
 #include <list>
 #include <set>
+#include <tuple>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -46,6 +47,11 @@ namespace hp
   template <int, int> class MappingCollection;
 }
 
+namespace GridTools
+{
+  template <int, int> class Cache;
+}
+
 class SparsityPattern;
 
 namespace internal
@@ -796,6 +802,69 @@ namespace GridTools
                                  const hp::DoFHandler<dim,spacedim>        &mesh,
                                  const Point<spacedim>                     &p);
 
+  /**
+   * A version of the previous functions that uses the search structures of
+   * a GridTools::Cache object, which stores the triangulation and the
+   * mapping to be used. The function first checks whether the point lies
+   * within @p cell_hint, if given. Otherwise, it queries the R-tree of the
+   * cache for the cells whose bounding boxes contain the point and returns
+   * the one that contains the point, using the same criterion as the
+   * functions above to choose among several cells. Consequently, the cost
+   * of this function grows only logarithmically with the number of cells.
+   *
+   * If none of these cells contains the point, e.g. because the mapping
+   * moves parts of a cell outside the bounding box of its vertices, the
+   * function also checks the cells around the vertex closest to the point,
+   * as given by Cache::find_closest_vertex(), and the cells that share a
+   * vertex with them. If this is unsuccessful as well, an exception of type
+   * GridTools::ExcPointNotFound is thrown. Unlike the functions above, the
+   * function does not fall back to a search through the whole mesh.
+   *
+   * @note Like the other functions above, this function may return a ghost
+   * or artificial cell of a parallel::distributed::Triangulation.
+   */
+  template <int dim, int spacedim>
+  std::pair<typename Triangulation<dim, spacedim>::active_cell_iterator, Point<dim> >
+  find_active_cell_around_point (const Cache<dim,spacedim>                                         &cache,
+                                 const Point<spacedim>                                             &p,
+                                 const typename Triangulation<dim, spacedim>::active_cell_iterator &cell_hint
+                                 = typename Triangulation<dim, spacedim>::active_cell_iterator());
+
+  /**
+   * Find the cells around all of the given @p points and return them along
+   * with the reference coordinates of the points within these cells, grouped
+   * by cells. The returned tuple contains
+   * - a vector of the cells that contain at least one of the points, in the
+   *   order in which they are first encountered in @p points,
+   * - for each of these cells, a vector of the reference coordinates of the
+   *   points within this cell,
+   * - for each of these cells, a vector of the indices of these points
+   *   within @p points.
+   *
+   * In other words, <code>points[std::get<2>(result)[c][q]]</code> is
+   * located at the reference coordinates
+   * <code>std::get<1>(result)[c][q]</code> of the cell
+   * <code>std::get<0>(result)[c]</code>.
+   *
+   * Every point is located through find_active_cell_around_point() above,
+   * using the cell of the previous point as hint, such that points that are
+   * sorted in a spatially coherent way, like the quadrature points of the
+   * cells of another mesh, are found quickly. The points are processed in
+   * parallel on several threads. If given, @p cell_hint is used as hint for
+   * the first point.
+   *
+   * If one of the points does not lie in any cell of the mesh, an exception
+   * of type GridTools::ExcPointNotFound is thrown.
+   */
+  template <int dim, int spacedim>
+  std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+             std::vector<std::vector<Point<dim> > >,
+             std::vector<std::vector<unsigned int> > >
+  compute_point_locations (const Cache<dim,spacedim>                                         &cache,
+                           const std::vector<Point<spacedim> >                               &points,
+                           const typename Triangulation<dim, spacedim>::active_cell_iterator &cell_hint
+                           = typename Triangulation<dim, spacedim>::active_cell_iterator());
+
   /**
    * Return a list of all descendants of the given cell that are active. For
    * example, if the current cell is once refined but none of its children are
@@ -1232,6 +1301,59 @@ namespace GridTools
   partition_triangulation_zorder (const unsigned int          n_partitions,
                                   Triangulation<dim,spacedim> &triangulation);
 
+  /**
+   * Generates a partitioning of the active cells making up the entire domain
+   * by sorting the cells along a Hilbert space-filling curve through their
+   * centers (see compute_hilbert_order()) and cutting the curve into @p
+   * n_partitions pieces of (approximately) equal weight. After calling this
+   * function, the subdomain ids of all active cells will have values between
+   * zero and @p n_partitions-1.
+   *
+   * Because the Hilbert curve is local, i.e., points that are close along
+   * the curve are also close in space, the resulting subdomains are compact.
+   * In contrast to partition_triangulation(), this function does not need
+   * METIS, and in contrast to partition_triangulation_zorder(), the order of
+   * the cells along the curve does not depend on the order of the coarse
+   * cells.
+   *
+   * @param n_partitions The number of subdomains to create.
+   * @param triangulation The triangulation whose cells are to be partitioned.
+   * @param cell_weights A vector indexed by the active cell index of each cell
+   * that contains the (nonnegative) weight of the cell, e.g., the expected
+   * cost of the work on it. The weights of all cells of one subdomain add up
+   * to approximately the same value. If the vector is empty, which is the
+   * default, all cells have the same weight.
+   */
+  template <int dim, int spacedim>
+  void
+  partition_triangulation_hilbert (const unsigned int          n_partitions,
+                                   Triangulation<dim,spacedim> &triangulation,
+                                   const std::vector<double>   &cell_weights = std::vector<double>());
+
+  /**
+   * Return the order in which a Hilbert space-filling curve through the
+   * bounding box of the given points visits the points, i.e., the points
+   * sorted along the curve are <code>points[order[0]]</code>,
+   * <code>points[order[1]]</code>, etc., where <code>order</code> is the
+   * returned vector.
+   *
+   * Points that are close to each other along the curve are also close to
+   * each other in space. Sorting objects such as cells by the location of
+   * their centers along the curve therefore groups objects that are close in
+   * space and is a good way to improve the cache locality of loops over
+   * these objects, or to build compact partitions.
+   *
+   * The position of each point along the curve is computed from the
+   * coordinates of the point rounded to a grid of $2^{64/\text{spacedim}}$
+   * intervals per coordinate direction, i.e., points that can not be
+   * distinguished on this grid are returned in the order in which they are
+   * given. The positions are computed in parallel, and the overall cost of
+   * the function is $O(N \log N)$ for $N$ points.
+   */
+  template <int spacedim>
+  std::vector<unsigned int>
+  compute_hilbert_order (const std::vector<Point<spacedim> > &points);
+
   /**
    * Partitions the cells of a multigrid hierarchy by assigning level subdomain ids
    * using the "youngest child" rule, that is, each cell in the hierarchy is owned by
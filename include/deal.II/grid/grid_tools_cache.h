@@ -0,0 +1,286 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_grid_grid_tools_cache_h
+#define dealii_grid_grid_tools_cache_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/point.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/fe/mapping.h>
+#include <deal.II/fe/mapping_q1.h>
+
+#include <boost/signals2.hpp>
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace GridTools
+{
+  /**
+   * A class that stores geometric search structures for a triangulation and
+   * a mapping, in order to find the cells around many points quickly. Many
+   * functions of the GridTools namespace that locate points, e.g.,
+   * GridTools::find_active_cell_around_point(), start from the vertex closest
+   * to a given point and walk through the neighbors of the cells adjacent to
+   * this vertex. For a single point, this is reasonably fast, but if many
+   * points need to be located, e.g., when interpolating between two
+   * non-matching meshes, most of the work is spent on finding the closest
+   * vertex, which requires a loop over all vertices, over and over again.
+   *
+   * An object of this class instead builds, upon first use, the following
+   * data structures:
+   * - A packed R-tree of the bounding boxes of all active cells. The
+   *   bounding box of a cell is the bounding box of its vertices as given by
+   *   Mapping::get_vertices(), and the tree is built by the
+   *   sort-tile-recursive algorithm, i.e., the boxes are sorted into tiles of
+   *   #rtree_node_size nearby boxes, which are then grouped recursively. The
+   *   cells whose bounding boxes contain a point can be found in logarithmic
+   *   time through get_cells_with_bounding_box_around_point().
+   * - A balanced KD-tree of the vertices of the triangulation, which allows
+   *   to find the vertex closest to a point in logarithmic time through
+   *   find_closest_vertex().
+   * - The map from vertices to adjacent cells as returned by
+   *   GridTools::vertex_to_cell_map().
+   *
+   * These data structures are used by the variants of
+   * GridTools::find_active_cell_around_point() and
+   * GridTools::compute_point_locations() that take a Cache argument.
+   *
+   * The object connects to the Triangulation::Signals::any_change signal of
+   * the triangulation and rebuilds its data structures the next time they
+   * are needed after the triangulation has changed. Changes of the mapping,
+   * e.g., of the displacement vector of a MappingQEulerian, are not tracked
+   * automatically, and the user has to call mark_for_update() in that case.
+   *
+   * All member functions may be called concurrently from several threads.
+   *
+   * @ingroup grid
+   */
+  template <int dim, int spacedim=dim>
+  class Cache : public Subscriptor
+  {
+  public:
+    /**
+     * The number of children of each node of the R-tree.
+     */
+    static const unsigned int rtree_node_size = 8;
+
+    /**
+     * Constructor. The data structures are not built here, but only when
+     * they are first needed.
+     */
+    Cache (const Triangulation<dim,spacedim> &triangulation,
+           const Mapping<dim,spacedim>       &mapping = StaticMappingQ1<dim,spacedim>::mapping);
+
+    /**
+     * Copy constructor. The new object refers to the same triangulation and
+     * mapping as @p other, but builds its own data structures when they are
+     * first needed.
+     */
+    Cache (const Cache<dim,spacedim> &other);
+
+    /**
+     * Destructor.
+     */
+    ~Cache ();
+
+    /**
+     * Mark the data structures as outdated, such that they are rebuilt the
+     * next time they are needed. This is done automatically when the
+     * triangulation changes, but needs to be called by the user if the
+     * mapping changes.
+     */
+    void mark_for_update ();
+
+    /**
+     * Return a reference to the triangulation.
+     */
+    const Triangulation<dim,spacedim> &get_triangulation () const;
+
+    /**
+     * Return a reference to the mapping.
+     */
+    const Mapping<dim,spacedim> &get_mapping () const;
+
+    /**
+     * Return all active cells whose bounding box contains the point @p p,
+     * sorted in the same way as in a std::set of cell iterators. The cell
+     * around @p p, if any, is one of the returned cells, unless the mapping
+     * maps parts of the cell outside the bounding box of its vertices.
+     */
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator>
+    get_cells_with_bounding_box_around_point (const Point<spacedim> &p) const;
+
+    /**
+     * Return the index of the used vertex closest to @p p. The location of
+     * the vertices is the one given by Mapping::get_vertices(). For mappings
+     * that preserve vertex locations, this is the same result as the one of
+     * GridTools::find_closest_vertex(), except for the choice among vertices
+     * with the same distance.
+     */
+    unsigned int
+    find_closest_vertex (const Point<spacedim> &p) const;
+
+    /**
+     * Return the map from vertices to adjacent cells, see
+     * GridTools::vertex_to_cell_map().
+     */
+    const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> > &
+    get_vertex_to_cell_map () const;
+
+    /**
+     * Make sure that the data structures are up to date, i.e., build them
+     * if they do not exist yet or if the triangulation has changed since they
+     * were built. All other member functions call this function, so there is
+     * usually no need to call it explicitly.
+     */
+    void update () const;
+
+    /**
+     * Return an estimate for the memory consumption, in bytes, of this
+     * object.
+     */
+    std::size_t memory_consumption () const;
+
+  private:
+    /**
+     * An axis-parallel box given by its lower left and upper right corners.
+     */
+    struct BoundingBox
+    {
+      Point<spacedim> lower;
+      Point<spacedim> upper;
+
+      /**
+       * Return whether the point @p p lies within the box.
+       */
+      bool contains (const Point<spacedim> &p) const;
+    };
+
+    /**
+     * Build all data structures. The caller must hold the lock on #mutex.
+     */
+    void build () const;
+
+    /**
+     * The triangulation and the mapping.
+     */
+    SmartPointer<const Triangulation<dim,spacedim>,Cache<dim,spacedim> > tria;
+    SmartPointer<const Mapping<dim,spacedim>,Cache<dim,spacedim> >       mapping;
+
+    /**
+     * The connection to the signal of the triangulation that is triggered
+     * upon any change.
+     */
+    boost::signals2::connection tria_change_signal;
+
+    /**
+     * Whether the data structures are up to date. This flag is checked
+     * without holding the lock on #mutex, and is therefore atomic.
+     */
+    mutable std::atomic<bool> is_up_to_date;
+
+    /**
+     * A mutex that guards the (re-)building of the data structures.
+     */
+    mutable Threads::Mutex mutex;
+
+    /**
+     * The active cells in the order of the leaves of the R-tree.
+     */
+    mutable std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> rtree_cells;
+
+    /**
+     * The levels of the R-tree, starting with the bounding boxes of the cells
+     * in #rtree_cells. Box @p i on level @p l+1 is the bounding box of boxes
+     * <code>i*rtree_node_size</code> to
+     * <code>(i+1)*rtree_node_size-1</code> on level @p l. The last level
+     * consists of a single box.
+     */
+    mutable std::vector<std::vector<BoundingBox> > rtree;
+
+    /**
+     * The location of the vertices as given by the mapping.
+     */
+    mutable std::vector<Point<spacedim> > vertices;
+
+    /**
+     * The indices of the used vertices, arranged as a balanced KD-tree: the
+     * vertex in the middle of a range splits the other vertices of this range
+     * into those in front of it and those behind it.
+     */
+    mutable std::vector<unsigned int> kdtree_vertices;
+
+    /**
+     * The map from vertices to adjacent cells.
+     */
+    mutable std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> > vertex_to_cells;
+  };
+
+
+
+  /* ----------------------------- inline functions ----------------------- */
+
+#ifndef DOXYGEN
+
+  template <int dim, int spacedim>
+  inline
+  const Triangulation<dim,spacedim> &
+  Cache<dim,spacedim>::get_triangulation () const
+  {
+    return *tria;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  const Mapping<dim,spacedim> &
+  Cache<dim,spacedim>::get_mapping () const
+  {
+    return *mapping;
+  }
+
+
+
+  template <int dim, int spacedim>
+  inline
+  bool
+  Cache<dim,spacedim>::BoundingBox::contains (const Point<spacedim> &p) const
+  {
+    for (unsigned int d=0; d<spacedim; ++d)
+      if (p[d] < lower[d] || p[d] > upper[d])
+        return false;
+    return true;
+  }
+
+#endif // DOXYGEN
+
+}
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -293,6 +293,25 @@ namespace Manifolds
  * approximate the limit process, and derived classes should do so.
  *
  *
+ * <h3>Thread safety</h3>
+ *
+ * Triangulation::execute_coarsening_and_refinement() computes the locations
+ * of the new vertices on several threads if the manifolds attached to the
+ * triangulation allow it, i.e., it may then call get_new_point() and the
+ * other functions of this class on the same object concurrently. A manifold
+ * tells the triangulation that this is safe through the is_thread_safe()
+ * function. The default implementation of this class returns false, so that
+ * new vertices are computed sequentially whenever a manifold of a class
+ * derived directly from this class or from ChartManifold is attached to the
+ * triangulation. The classes of the library that are safe to use
+ * concurrently, like FlatManifold, SphericalManifold, PolarManifold,
+ * CylindricalManifold, TorusManifold, and TransfiniteInterpolationManifold,
+ * return true. If you derive from one of these classes and your
+ * implementation modifies data without synchronizing the access, e.g., a
+ * cache of previously computed points, you need to override
+ * is_thread_safe() to return false.
+ *
+ *
  * @ingroup manifold
  * @author Luca Heltai, Wolfgang Bangerth, 2014, 2016
  */
@@ -327,6 +346,16 @@ public:
    */
   virtual ~Manifold ();
 
+  /**
+   * Return whether the member functions of this object may be called
+   * concurrently from several threads. See the section on thread safety in
+   * the general documentation of this class. The default implementation
+   * returns false.
+   */
+  virtual
+  bool
+  is_thread_safe () const;
+
   /**
    * @name Computing the location of points.
    */
@@ -681,6 +710,14 @@ public:
   FlatManifold (const Tensor<1,spacedim> &periodicity = Tensor<1,spacedim>(),
                 const double tolerance=1e-10);
 
+  /**
+   * Return true, since the functions of this class do not modify the
+   * object.
+   */
+  virtual
+  bool
+  is_thread_safe () const override;
+
   /**
    * Let the new point be the average sum of surrounding vertices.
    *
@@ -69,6 +69,14 @@ public:
    */
   PolarManifold(const Point<spacedim> center = Point<spacedim>());
 
+  /**
+   * Return true, since the functions of this class do not modify the
+   * object. See Manifold::is_thread_safe().
+   */
+  virtual
+  bool
+  is_thread_safe () const override;
+
   /**
    * Pull back the given point from the Euclidean space. Will return the polar
    * coordinates associated with the point @p space_point. Only used when
@@ -205,6 +213,14 @@ public:
    */
   SphericalManifold(const Point<spacedim> center = Point<spacedim>());
 
+  /**
+   * Return true, since the functions of this class do not modify the
+   * object. See Manifold::is_thread_safe().
+   */
+  virtual
+  bool
+  is_thread_safe () const override;
+
   /**
    * Given any two points in space, first project them on the surface
    * of a sphere with unit radius, then connect them with a geodesic
@@ -282,6 +298,14 @@ public:
                        const Point<spacedim> &point_on_axis,
                        const double tolerance = 1e-10);
 
+  /**
+   * Return true, since the functions of this class do not modify the
+   * object. See Manifold::is_thread_safe().
+   */
+  virtual
+  bool
+  is_thread_safe () const override;
+
   /**
    * Compute the Cartesian coordinates for a point given in cylindrical
    * coordinates.
@@ -504,6 +528,14 @@ public:
    */
   TorusManifold (const double R, const double r);
 
+  /**
+   * Return true, since the functions of this class do not modify the
+   * object. See Manifold::is_thread_safe().
+   */
+  virtual
+  bool
+  is_thread_safe () const override;
+
   /**
    * Pull back operation.
    */
@@ -679,6 +711,14 @@ public:
    */
   void initialize (const Triangulation<dim,spacedim> &triangulation);
 
+  /**
+   * Return true, since the functions of this class only read from the
+   * object and the coarse mesh. See Manifold::is_thread_safe().
+   */
+  virtual
+  bool
+  is_thread_safe () const override;
+
   /**
    * Return the point which shall become the new vertex surrounded by the
    * given points @p surrounding_points. @p weights contains appropriate
@@ -3739,7 +3739,7 @@ Triangulation<dim,spacedim>::load (Archive &ar,
   // this here. don't forget to first resize the fields appropriately
   {
     for (unsigned int l=0; l<levels.size(); ++l)
-      levels[l]->active_cell_indices.resize (levels[l]->refine_flags.size());
+      levels[l]->active_cell_indices.resize (levels[l]->cell_records.size());
     reset_active_cell_indices ();
   }
 
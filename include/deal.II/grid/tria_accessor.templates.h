@@ -220,14 +220,14 @@ TriaAccessorBase<structdim,dim,spacedim>::operator ++ ()
       // has no level)
       if (this->present_index
           >=
-          static_cast<int>(objects().cells.size()))
+          static_cast<int>(objects().records.size()))
         this->present_index = -1;
     }
   else
     {
       while (this->present_index
              >=
-             static_cast<int>(this->tria->levels[this->present_level]->cells.cells.size()))
+             static_cast<int>(this->tria->levels[this->present_level]->cells.records.size()))
         {
           // no -> go one level up until we find
           // one with more than zero cells
@@ -272,7 +272,7 @@ TriaAccessorBase<structdim,dim,spacedim>::operator -- ()
               return;
             }
           // else
-          this->present_index = this->tria->levels[this->present_level]->cells.cells.size()-1;
+          this->present_index = this->tria->levels[this->present_level]->cells.records.size()-1;
         }
     }
 }
@@ -600,7 +600,7 @@ namespace internal
       line_index (const TriaAccessor<2, dim, spacedim> &accessor,
                   const unsigned int i)
       {
-        return accessor.objects().cells[accessor.present_index].face(i);
+        return accessor.objects().records[accessor.present_index].object.face(i);
       }
 
 
@@ -682,7 +682,7 @@ namespace internal
         Assert (i<GeometryInfo<3>::quads_per_cell,
                 ExcIndexRange(i,0,GeometryInfo<3>::quads_per_cell));
         return accessor.tria->levels[accessor.present_level]
-               ->cells.cells[accessor.present_index].face(i);
+               ->cells.records[accessor.present_index].object.face(i);
       }
 
 
@@ -755,15 +755,8 @@ namespace internal
       {
         Assert (face<GeometryInfo<3>::faces_per_cell,
                 ExcIndexRange (face, 0, GeometryInfo<3>::faces_per_cell));
-        Assert (accessor.present_index * GeometryInfo<3>::faces_per_cell + face
-                < accessor.tria->levels[accessor.present_level]
-                ->cells.face_flips.size(),
-                ExcInternalError());
-
         return (accessor.tria->levels[accessor.present_level]
-                ->cells.face_flips[accessor.present_index *
-                                   GeometryInfo<3>::faces_per_cell
-                                   + face]);
+                ->cells.face_flip(accessor.present_index, face));
       }
 
 
@@ -797,15 +790,8 @@ namespace internal
       {
         Assert (face<GeometryInfo<3>::faces_per_cell,
                 ExcIndexRange (face, 0, GeometryInfo<3>::faces_per_cell));
-        Assert (accessor.present_index * GeometryInfo<3>::faces_per_cell + face
-                < accessor.tria->levels[accessor.present_level]
-                ->cells.face_rotations.size(),
-                ExcInternalError());
-
         return (accessor.tria->levels[accessor.present_level]
-                ->cells.face_rotations[accessor.present_index *
-                                       GeometryInfo<3>::faces_per_cell
-                                       + face]);
+                ->cells.face_rotation(accessor.present_index, face));
       }
 
       /**
@@ -973,15 +959,8 @@ namespace internal
         Assert (accessor.used(), TriaAccessorExceptions::ExcCellNotUsed());
         Assert (face<GeometryInfo<3>::faces_per_cell,
                 ExcIndexRange (face, 0, GeometryInfo<3>::faces_per_cell));
-        Assert (accessor.present_index * GeometryInfo<3>::faces_per_cell + face
-                < accessor.tria->levels[accessor.present_level]
-                ->cells.face_orientations.size(),
-                ExcInternalError());
         accessor.tria->levels[accessor.present_level]
-        ->cells.face_orientations[accessor.present_index *
-                                  GeometryInfo<3>::faces_per_cell
-                                  +
-                                  face] = value;
+        ->cells.set_face_orientation(accessor.present_index, face, value);
       }
 
 
@@ -1011,15 +990,8 @@ namespace internal
       {
         Assert (face<GeometryInfo<3>::faces_per_cell,
                 ExcIndexRange (face, 0, GeometryInfo<3>::faces_per_cell));
-        Assert (accessor.present_index * GeometryInfo<3>::faces_per_cell + face
-                < accessor.tria->levels[accessor.present_level]
-                ->cells.face_flips.size(),
-                ExcInternalError());
-
         accessor.tria->levels[accessor.present_level]
-        ->cells.face_flips[accessor.present_index *
-                           GeometryInfo<3>::faces_per_cell
-                           + face] = value;
+        ->cells.set_face_flip(accessor.present_index, face, value);
       }
 
 
@@ -1049,15 +1021,8 @@ namespace internal
       {
         Assert (face<GeometryInfo<3>::faces_per_cell,
                 ExcIndexRange (face, 0, GeometryInfo<3>::faces_per_cell));
-        Assert (accessor.present_index * GeometryInfo<3>::faces_per_cell + face
-                < accessor.tria->levels[accessor.present_level]
-                ->cells.face_rotations.size(),
-                ExcInternalError());
-
         accessor.tria->levels[accessor.present_level]
-        ->cells.face_rotations[accessor.present_index *
-                               GeometryInfo<3>::faces_per_cell
-                               + face] = value;
+        ->cells.set_face_rotation(accessor.present_index, face, value);
       }
 
       /**
@@ -1137,7 +1102,7 @@ namespace internal
       vertex_index (const TriaAccessor<1,dim,spacedim> &accessor,
                     const unsigned int corner)
       {
-        return accessor.objects().cells[accessor.present_index].face (corner);
+        return accessor.objects().records[accessor.present_index].object.face (corner);
       }
 
 
@@ -1216,7 +1181,7 @@ TriaAccessor<structdim,dim,spacedim>::used () const
 {
   Assert (this->state() == IteratorState::valid,
           TriaAccessorExceptions::ExcDereferenceInvalidObject());
-  return this->objects().used[this->present_index];
+  return this->objects().records[this->present_index].used;
 }
 
 
@@ -1410,7 +1375,7 @@ void TriaAccessor<structdim, dim, spacedim>::set_used_flag () const
 {
   Assert (this->state() == IteratorState::valid,
           TriaAccessorExceptions::ExcDereferenceInvalidObject());
-  this->objects().used[this->present_index] = true;
+  this->objects().records[this->present_index].used = true;
 }
 
 
@@ -1421,7 +1386,7 @@ TriaAccessor<structdim, dim, spacedim>::clear_used_flag () const
 {
   Assert (this->state() == IteratorState::valid,
           TriaAccessorExceptions::ExcDereferenceInvalidObject());
-  this->objects().used[this->present_index] = false;
+  this->objects().records[this->present_index].used = false;
 }
 
 
@@ -1437,8 +1402,7 @@ child_index (const unsigned int i) const
   // each set of two children are stored
   // consecutively, so we only have to find
   // the location of the set of children
-  const unsigned int n_sets_of_two = GeometryInfo<structdim>::max_children_per_cell/2;
-  return this->objects().children[n_sets_of_two*this->present_index+i/2]+i%2;
+  return this->objects().records[this->present_index].children[i/2]+i%2;
 }
 
 
@@ -1498,7 +1462,7 @@ TriaAccessor<structdim, dim, spacedim>::refinement_case() const
     {
     case 1:
       return (RefinementCase<structdim>
-              (this->objects().children[this->present_index] != -1
+              (this->objects().records[this->present_index].children[0] != -1
                ?
                // cast the branches
                // here first to uchar
@@ -1516,12 +1480,12 @@ TriaAccessor<structdim, dim, spacedim>::refinement_case() const
 
     default:
       Assert (static_cast<unsigned int> (this->present_index) <
-              this->objects().refinement_cases.size(),
+              this->objects().records.size(),
               ExcIndexRange(this->present_index, 0,
-                            this->objects().refinement_cases.size()));
+                            this->objects().records.size()));
 
       return (static_cast<RefinementCase<structdim> >
-              (this->objects().refinement_cases[this->present_index]));
+              (this->objects().records[this->present_index].refinement_case));
     }
 }
 
@@ -1604,11 +1568,9 @@ TriaAccessor<structdim,dim,spacedim>::has_children () const
   Assert (this->state() == IteratorState::valid,
           TriaAccessorExceptions::ExcDereferenceInvalidObject());
 
-  // each set of two children are stored
-  // consecutively, so we only have to find
-  // the location of the set of children
-  const unsigned int n_sets_of_two = GeometryInfo<structdim>::max_children_per_cell/2;
-  return (this->objects().children[n_sets_of_two * this->present_index] != -1);
+  // an object has children if the index of
+  // its first set of children is set
+  return (this->objects().records[this->present_index].children[0] != -1);
 }
 
 
@@ -1633,11 +1595,11 @@ set_refinement_case (const RefinementCase<structdim> &refinement_case) const
   Assert (this->state() == IteratorState::valid,
           TriaAccessorExceptions::ExcDereferenceInvalidObject());
   Assert (static_cast<unsigned int> (this->present_index) <
-          this->objects().refinement_cases.size(),
+          this->objects().records.size(),
           ExcIndexRange(this->present_index, 0,
-                        this->objects().refinement_cases.size()));
+                        this->objects().records.size()));
 
-  this->objects().refinement_cases[this->present_index] = refinement_case;
+  this->objects().records[this->present_index].refinement_case = refinement_case;
 }
 
 
@@ -1649,11 +1611,11 @@ TriaAccessor<structdim, dim, spacedim>::clear_refinement_case () const
   Assert (this->state() == IteratorState::valid,
           TriaAccessorExceptions::ExcDereferenceInvalidObject());
   Assert (static_cast<unsigned int> (this->present_index) <
-          this->objects().refinement_cases.size(),
+          this->objects().records.size(),
           ExcIndexRange(this->present_index, 0,
-                        this->objects().refinement_cases.size()));
+                        this->objects().records.size()));
 
-  this->objects().refinement_cases[this->present_index]
+  this->objects().records[this->present_index].refinement_case
     = RefinementCase<structdim>::no_refinement;
 }
 
@@ -1669,18 +1631,13 @@ TriaAccessor<structdim, dim, spacedim>::set_children (const unsigned int i,
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
   Assert (i%2==0, TriaAccessorExceptions::ExcSetOnlyEvenChildren(i));
 
-  // each set of two children are stored
-  // consecutively, so we only have to find
-  // the location of the set of children
-  const unsigned int n_sets_of_two = GeometryInfo<structdim>::max_children_per_cell/2;
-
   Assert ((index==-1) ||
           (i==0 && !this->has_children() && (index>=0)) ||
           (i>0  &&  this->has_children() && (index>=0) &&
-           this->objects().children[n_sets_of_two*this->present_index+i/2] == -1),
+           this->objects().records[this->present_index].children[i/2] == -1),
           TriaAccessorExceptions::ExcCantSetChildren(index));
 
-  this->objects().children[n_sets_of_two*this->present_index+i/2] = index;
+  this->objects().records[this->present_index].children[i/2] = index;
 }
 
 
@@ -1706,7 +1663,7 @@ bool
 TriaAccessor<structdim,dim,spacedim>::user_flag_set () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  return this->objects().user_flags[this->present_index];
+  return this->objects().records[this->present_index].user_flag;
 }
 
 
@@ -1717,7 +1674,7 @@ void
 TriaAccessor<structdim,dim,spacedim>::set_user_flag () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  this->objects().user_flags[this->present_index] = true;
+  this->objects().records[this->present_index].user_flag = true;
 }
 
 
@@ -1728,7 +1685,7 @@ void
 TriaAccessor<structdim,dim,spacedim>::clear_user_flag () const
 {
   Assert (this->used(), TriaAccessorExceptions::ExcCellNotUsed());
-  this->objects().user_flags[this->present_index] = false;
+  this->objects().records[this->present_index].user_flag = false;
 }
 
 
@@ -3258,7 +3215,7 @@ CellAccessor<dim,spacedim>::neighbor_index (const unsigned int i) const
 {
   AssertIndexRange (i,GeometryInfo<dim>::faces_per_cell);
   return this->tria->levels[this->present_level]->
-         neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].second;
+         cell_records[this->present_index].neighbors[i].second;
 }
 
 
@@ -3270,7 +3227,7 @@ CellAccessor<dim,spacedim>::neighbor_level (const unsigned int i) const
 {
   AssertIndexRange (i, GeometryInfo<dim>::faces_per_cell);
   return this->tria->levels[this->present_level]->
-         neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].first;
+         cell_records[this->present_index].neighbors[i].first;
 }
 
 
@@ -3286,9 +3243,9 @@ CellAccessor<dim,spacedim>::refine_flag_set () const
   // but activity may change when refinement is
   // executed and for some reason the refine
   // flag is not cleared).
-  Assert (this->active() ||  !this->tria->levels[this->present_level]->refine_flags[this->present_index],
+  Assert (this->active() ||  !this->tria->levels[this->present_level]->cell_records[this->present_index].refine_flag,
           ExcRefineCellNotActive());
-  return RefinementCase<dim>(this->tria->levels[this->present_level]->refine_flags[this->present_index]);
+  return RefinementCase<dim>(this->tria->levels[this->present_level]->cell_records[this->present_index].refine_flag);
 }
 
 
@@ -3302,7 +3259,7 @@ CellAccessor<dim,spacedim>::set_refine_flag (const RefinementCase<dim> refinemen
   Assert (!coarsen_flag_set(),
           ExcCellFlaggedForCoarsening());
 
-  this->tria->levels[this->present_level]->refine_flags[this->present_index] = refinement_case;
+  this->tria->levels[this->present_level]->cell_records[this->present_index].refine_flag = refinement_case;
 }
 
 
@@ -3313,7 +3270,7 @@ void
 CellAccessor<dim,spacedim>::clear_refine_flag () const
 {
   Assert (this->used() && this->active(), ExcRefineCellNotActive());
-  this->tria->levels[this->present_level]->refine_flags[this->present_index] =
+  this->tria->levels[this->present_level]->cell_records[this->present_index].refine_flag =
     RefinementCase<dim>::no_refinement;
 }
 
@@ -3512,9 +3469,9 @@ CellAccessor<dim,spacedim>::coarsen_flag_set () const
   // but activity may change when refinement is
   // executed and for some reason the refine
   // flag is not cleared).
-  Assert (this->active() ||  !this->tria->levels[this->present_level]->coarsen_flags[this->present_index],
+  Assert (this->active() ||  !this->tria->levels[this->present_level]->cell_records[this->present_index].coarsen_flag,
           ExcRefineCellNotActive());
-  return this->tria->levels[this->present_level]->coarsen_flags[this->present_index];
+  return this->tria->levels[this->present_level]->cell_records[this->present_index].coarsen_flag;
 }
 
 
@@ -3527,7 +3484,7 @@ CellAccessor<dim,spacedim>::set_coarsen_flag () const
   Assert (this->used() && this->active(), ExcRefineCellNotActive());
   Assert (!refine_flag_set(), ExcCellFlaggedForRefinement());
 
-  this->tria->levels[this->present_level]->coarsen_flags[this->present_index] = true;
+  this->tria->levels[this->present_level]->cell_records[this->present_index].coarsen_flag = true;
 }
 
 
@@ -3538,7 +3495,7 @@ void
 CellAccessor<dim,spacedim>::clear_coarsen_flag () const
 {
   Assert (this->used() && this->active(), ExcRefineCellNotActive());
-  this->tria->levels[this->present_level]->coarsen_flags[this->present_index] = false;
+  this->tria->levels[this->present_level]->cell_records[this->present_index].coarsen_flag = false;
 }
 
 
@@ -24,6 +24,7 @@
 #include <deal.II/grid/tria_objects.h>
 
 #include <boost/serialization/utility.hpp>
+#include <boost/serialization/version.hpp>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -31,6 +32,65 @@ namespace internal
 {
   namespace Triangulation
   {
+    /**
+     * The data of one cell of a level that is read whenever the neighbors of
+     * the cell are visited or its refinement and coarsening flags are set or
+     * made consistent with those of its neighbors. Storing them together in
+     * one record per cell, rather than in three separate vectors, means that
+     * the loops over cells and their neighbors during the preparation of
+     * refinement find all of this data in one contiguous block of memory.
+     */
+    template <int dim>
+    struct CellRecord
+    {
+      /**
+       * Default constructor. Sets the flags to no refinement and no
+       * coarsening, and all neighbors to non-existent.
+       */
+      CellRecord ();
+
+      /**
+       * Levels and indices of the neighbors of the cell. See the
+       * documentation of TriaLevel for the conventions.
+       */
+      std::pair<int,int> neighbors[GeometryInfo<dim>::faces_per_cell];
+
+      /**
+       * The RefinementCase<dim>::Type the cell is flagged to be refined with,
+       * or RefinementCase<dim>::no_refinement.
+       */
+      unsigned char refine_flag;
+
+      /**
+       * Whether the cell is flagged to be coarsened. Like the refinement
+       * flag, the flag is stored as one byte such that it can be read
+       * without bit manipulations and set concurrently for different cells.
+       */
+      unsigned char coarsen_flag;
+
+      /**
+       * Read or write the data of this object to or from a stream for the
+       * purpose of serialization
+       */
+      template <class Archive>
+      void serialize(Archive &ar,
+                     const unsigned int version);
+
+      /**
+       * Read the refinement flags, coarsening flags and neighbors that
+       * archives of TriaLevel written before version 2 stored in three
+       * separate vectors, and convert them into records. The coarsening
+       * flags were stored as <code>std::vector@<bool@></code> in version 0.
+       */
+      template <class Archive>
+      static
+      void load_old_format (Archive                 &ar,
+                            const unsigned int       version,
+                            std::vector<CellRecord> &records);
+    };
+
+
+
     /**
      * Store all information which belongs to one level of the multilevel
      * hierarchy.
@@ -55,40 +115,20 @@ namespace internal
     {
     public:
       /**
-       * @p RefinementCase<dim>::Type flags for the cells to be refined with
-       * or not (RefinementCase<dim>::no_refinement). The meaning what a cell
-       * is, is dimension specific, therefore also the length of this vector
-       * depends on the dimension: in one dimension, the length of this vector
-       * equals the length of the @p lines vector, in two dimensions that of
-       * the @p quads vector, etc.
-       */
-      std::vector<unsigned char> refine_flags;
-
-      /**
-       * Same meaning as the one above, but specifies whether a cell must be
-       * coarsened.
-       */
-      std::vector<bool> coarsen_flags;
-
-
-      /**
-       * An integer that, for every active cell, stores the how many-th active
-       * cell this is. For non-active cells, this value is unused and set to
-       * an invalid value.
-       */
-      std::vector<unsigned int> active_cell_indices;
-
-      /**
-       * Levels and indices of the neighbors of the cells. Convention is, that
-       * the neighbors of the cell with index @p i are stored in the fields
-       * following $i*(2*real\_space\_dimension)$, e.g. in one spatial
-       * dimension, the neighbors of cell 0 are stored in
-       * <tt>neighbors[0]</tt> and <tt>neighbors[1]</tt>, the neighbors of
-       * cell 1 are stored in <tt>neighbors[2]</tt> and <tt>neighbors[3]</tt>,
-       * and so on.
+       * The refinement flags, coarsening flags and neighbors of the cells on
+       * this level, one record per cell. The meaning what a cell is, is
+       * dimension specific, therefore also the length of this vector depends
+       * on the dimension: in one dimension, the length of this vector equals
+       * the length of the @p lines vector, in two dimensions that of the @p
+       * quads vector, etc.
        *
-       * In neighbors, <tt>neighbors[i].first</tt> is the level, while
-       * <tt>neighbors[i].first</tt> is the index of the neighbor.
+       * The field <tt>refine_flag</tt> stores the @p
+       * RefinementCase<dim>::Type the cell is to be refined with, or
+       * RefinementCase<dim>::no_refinement. The field
+       * <tt>coarsen_flag</tt> specifies whether a cell must be coarsened.
+       *
+       * In the array of neighbors, <tt>neighbors[i].first</tt> is the level,
+       * while <tt>neighbors[i].second</tt> is the index of the neighbor.
        *
        * If a neighbor does not exist (cell is at the boundary),
        * <tt>level=index=-1</tt> is set.
@@ -111,7 +151,15 @@ namespace internal
        * level down (in which case its neighbor pointer points to the mother
        * cell of this cell).
        */
-      std::vector<std::pair<int,int> > neighbors;
+      std::vector<CellRecord<dim> > cell_records;
+
+
+      /**
+       * An integer that, for every active cell, stores the how many-th active
+       * cell this is. For non-active cells, this value is unused and set to
+       * an invalid value.
+       */
+      std::vector<unsigned int> active_cell_indices;
 
       /**
        * One integer per cell to store which subdomain it belongs to. This
@@ -216,10 +264,8 @@ namespace internal
     class TriaLevel<3>
     {
     public:
-      std::vector<unsigned char> refine_flags;
-      std::vector<bool> coarsen_flags;
+      std::vector<CellRecord<3> > cell_records;
       std::vector<unsigned int> active_cell_indices;
-      std::vector<std::pair<int,int> > neighbors;
       std::vector<types::subdomain_id> subdomain_ids;
       std::vector<types::subdomain_id> level_subdomain_ids;
       std::vector<int> parents;
@@ -268,18 +314,80 @@ namespace internal
 
 
 
+    template <int dim>
+    inline
+    CellRecord<dim>::CellRecord ()
+      :
+      refine_flag (RefinementCase<dim>::no_refinement),
+      coarsen_flag (false)
+    {
+      for (unsigned int i=0; i<GeometryInfo<dim>::faces_per_cell; ++i)
+        neighbors[i] = std::make_pair(-1,-1);
+    }
+
+
+
+    template <int dim>
+    template <class Archive>
+    void CellRecord<dim>::serialize(Archive &ar,
+                                    const unsigned int)
+    {
+      ar &neighbors;
+      ar &refine_flag &coarsen_flag;
+    }
+
+
+
+    template <int dim>
+    template <class Archive>
+    void CellRecord<dim>::load_old_format (Archive                 &ar,
+                                           const unsigned int       version,
+                                           std::vector<CellRecord> &records)
+    {
+      std::vector<unsigned char> refine_flags, coarsen_flags;
+      ar &refine_flags;
+      if (version == 0)
+        {
+          std::vector<bool> flags;
+          ar &flags;
+          coarsen_flags.assign (flags.begin(), flags.end());
+        }
+      else
+        ar &coarsen_flags;
+
+      std::vector<std::pair<int,int> > neighbors;
+      ar &neighbors;
+
+      records.resize (refine_flags.size());
+      for (unsigned int i=0; i<records.size(); ++i)
+        {
+          records[i].refine_flag = refine_flags[i];
+          records[i].coarsen_flag = coarsen_flags[i];
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            records[i].neighbors[f]
+              = neighbors[i*GeometryInfo<dim>::faces_per_cell+f];
+        }
+    }
+
+
+
     template <int dim>
     template <class Archive>
     void TriaLevel<dim>::serialize(Archive &ar,
-                                   const unsigned int)
+                                   const unsigned int version)
     {
-      ar &refine_flags &coarsen_flags;
+      // archives of versions 0 and 1 stored the flags and neighbors in
+      // separate vectors. since archives are always written with the current
+      // version, this branch is only taken when loading such an old archive
+      if (version < 2)
+        CellRecord<dim>::load_old_format (ar, version, cell_records);
+      else
+        ar &cell_records;
 
       // do not serialize 'active_cell_indices' here. instead of storing them
       // to the stream and re-reading them again later, we just rebuild them
       // in Triangulation::load()
 
-      ar &neighbors;
       ar &subdomain_ids;
       ar &level_subdomain_ids;
       ar &parents;
@@ -291,15 +399,20 @@ namespace internal
 
     template <class Archive>
     void TriaLevel<3>::serialize(Archive &ar,
-                                 const unsigned int)
+                                 const unsigned int version)
     {
-      ar &refine_flags &coarsen_flags;
+      // archives of versions 0 and 1 stored the flags and neighbors in
+      // separate vectors. since archives are always written with the current
+      // version, this branch is only taken when loading such an old archive
+      if (version < 2)
+        CellRecord<3>::load_old_format (ar, version, cell_records);
+      else
+        ar &cell_records;
 
       // do not serialize 'active_cell_indices' here. instead of storing them
       // to the stream and re-reading them again later, we just rebuild them
       // in Triangulation::load()
 
-      ar &neighbors;
       ar &subdomain_ids;
       ar &level_subdomain_ids;
       ar &parents;
@@ -314,4 +427,11 @@ namespace internal
 
 DEAL_II_NAMESPACE_CLOSE
 
+// version 1 stores the coarsen flags as one byte per cell rather than as
+// std::vector<bool>. version 2 stores the refine and coarsen flags and the
+// neighbors in one record per cell
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaLevel<1>, 2)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaLevel<2>, 2)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaLevel<3>, 2)
+
 #endif
@@ -21,6 +21,8 @@
 #include <deal.II/base/geometry_info.h>
 #include <deal.II/grid/tria_object.h>
 
+#include <boost/serialization/version.hpp>
+
 #include <vector>
 
 DEAL_II_NAMESPACE_OPEN
@@ -32,10 +34,10 @@ DEAL_II_NAMESPACE_OPEN
 //next_free_single_object() and next_free_pair_object, but they seem
 //to get around it.
 
-//TODO: The TriaObjects class contains a std::vector<G>. This is only an
-//efficient storage scheme if G is relatively well packed, i.e. it's not a
-//bool and then an integer and then a double, etc. Verify that this is
-//actually the case.
+//TODO: The TriaObjects class contains a std::vector of records holding a G
+//each. This is only an efficient storage scheme if G is relatively well
+//packed, i.e. it's not a bool and then an integer and then a double, etc.
+//Verify that this is actually the case.
 
 template <int dim, int spacedim> class Triangulation;
 template <class Accessor> class TriaRawIterator;
@@ -48,9 +50,11 @@ namespace internal
 
     /**
      * General template for information belonging to the geometrical objects
-     * of a triangulation, i.e. lines, quads, hexahedra...  Apart from the
-     * vector of objects additional information is included, namely vectors
-     * indicating the children, the used-status, user-flags, material-ids..
+     * of a triangulation, i.e. lines, quads, hexahedra...  The objects are
+     * stored in records that also hold the indices of their children, their
+     * refinement case, their used-status and their user-flag. Additional
+     * information that is not needed for traversing and refining the mesh,
+     * such as material-ids or user data, is stored in separate vectors.
      *
      * Objects of these classes are included in the TriaLevel and TriaFaces
      * classes.
@@ -68,51 +72,81 @@ namespace internal
       TriaObjects();
 
       /**
-       * Vector of the objects belonging to this level. The index of the
-       * object equals the index in this container.
+       * The data of one object that is read whenever the objects are
+       * traversed or refined, stored together such that an iterator or an
+       * accessor finds everything it needs for one object in one contiguous
+       * block of memory rather than in five separate arrays.
        */
-      std::vector<G> cells;
+      struct ObjectRecord
+      {
+        /**
+         * Default constructor. Marks the object as unused, without children
+         * and without refinement.
+         */
+        ObjectRecord ();
 
-      /**
-       * Index of the even children of an object. Since when objects are
-       * refined, all children are created at the same time, they are appended
-       * to the list at least in pairs after each other. We therefore only
-       * store the index of the even children, the uneven follow immediately
-       * afterwards.
-       *
-       * If an object has no children, -1 is stored in this list. An object is
-       * called active if it has no children. The function
-       * TriaAccessorBase::has_children() tests for this.
-       */
-      std::vector<int>  children;
+        /**
+         * The indices of the faces of the object (or of the vertices for
+         * lines).
+         */
+        G object;
 
-      /**
-       * Store the refinement case each of the cells is refined with. This
-       * vector might be replaced by vector<vector<bool> > (dim, vector<bool>
-       * (n_cells)) which is more memory efficient.
-       */
-      std::vector<RefinementCase<G::dimension> > refinement_cases;
+        /**
+         * Index of the even children of the object. Since when objects are
+         * refined, all children are created at the same time, they are
+         * appended to the list at least in pairs after each other. We
+         * therefore only store the index of the even children, the uneven
+         * follow immediately afterwards.
+         *
+         * If an object has no children, -1 is stored in the first entry. An
+         * object is called active if it has no children. The function
+         * TriaAccessorBase::has_children() tests for this.
+         */
+        int children[GeometryInfo<G::dimension>::max_children_per_cell/2];
 
-      /**
-       * Vector storing whether an object is used in the @p cells vector.
-       *
-       * Since it is difficult to delete elements in a @p vector, when an
-       * element is not needed any more (e.g. after derefinement), it is not
-       * deleted from the list, but rather the according @p used flag is set
-       * to @p false.
-       */
-      std::vector<bool> used;
+        /**
+         * The refinement case the object is refined with. This field is not
+         * used for lines, which can only be refined in one way.
+         */
+        RefinementCase<G::dimension> refinement_case;
+
+        /**
+         * Whether the object is in use. Since it is difficult to delete
+         * elements in a @p vector, when an element is not needed any more
+         * (e.g. after derefinement), it is not deleted from the list, but
+         * rather the according @p used flag is set to @p false.
+         *
+         * This flag is read upon every increment of an iterator. It is
+         * therefore stored as one byte rather than as a bit, which avoids
+         * bit manipulations and allows different threads to set the flags of
+         * different objects concurrently.
+         */
+        unsigned char used;
+
+        /**
+         * A field for user data, one flag per object. This field is usually
+         * used when an operation runs over all cells and needs information
+         * whether another cell (e.g. a neighbor) has already been processed.
+         *
+         * You can clear all user flags using
+         * dealii::Triangulation::clear_user_flags().
+         */
+        unsigned char user_flag;
+
+        /**
+         * Read or write the data of this object to or from a stream for the
+         * purpose of serialization
+         */
+        template <class Archive>
+        void serialize(Archive &ar,
+                       const unsigned int version);
+      };
 
       /**
-       * Make available a field for user data, one bit per object. This field
-       * is usually used when an operation runs over all cells and needs
-       * information whether another cell (e.g. a neighbor) has already been
-       * processed.
-       *
-       * You can clear all used flags using
-       * dealii::Triangulation::clear_user_flags().
+       * Vector of the records of the objects belonging to this level. The
+       * index of the object equals the index in this container.
        */
-      std::vector<bool> user_flags;
+      std::vector<ObjectRecord> records;
 
 
       /**
@@ -413,8 +447,8 @@ namespace internal
     /**
      * For hexahedra the data of TriaObjects needs to be extended, as we can
      * obtain faces (quads) in non-standard-orientation, therefore we declare
-     * a class TriaObjectsHex, which additionally contains a bool-vector of
-     * the face-orientations.
+     * a class TriaObjectsHex, which additionally contains the orientation,
+     * flip and rotation of each face.
      */
     class TriaObjectsHex : public TriaObjects<TriaObject<3> >
     {
@@ -428,6 +462,52 @@ namespace internal
        */
       bool face_orientation(const unsigned int cell, const unsigned int face) const;
 
+      /**
+       * Whether the face number <code>face</code> of the cell with number
+       * <code>cell</code> is rotated by 180 degrees.
+       */
+      bool face_flip(const unsigned int cell, const unsigned int face) const;
+
+      /**
+       * Whether the face number <code>face</code> of the cell with number
+       * <code>cell</code> is rotated by 90 degrees.
+       */
+      bool face_rotation(const unsigned int cell, const unsigned int face) const;
+
+      /**
+       * Set the orientation of the face number <code>face</code> of the cell
+       * with number <code>cell</code>.
+       */
+      void set_face_orientation(const unsigned int cell, const unsigned int face,
+                                const bool value);
+
+      /**
+       * Set the flip of the face number <code>face</code> of the cell with
+       * number <code>cell</code>.
+       */
+      void set_face_flip(const unsigned int cell, const unsigned int face,
+                         const bool value);
+
+      /**
+       * Set the rotation of the face number <code>face</code> of the cell with
+       * number <code>cell</code>.
+       */
+      void set_face_rotation(const unsigned int cell, const unsigned int face,
+                             const bool value);
+
+      /**
+       * The bits of the entries of @p face_orientations.
+       */
+      enum FaceOrientationBits
+      {
+        /// The normal vector of the face points the usual way.
+        orientation_bit = 1,
+        /// The face is rotated by 180 degrees.
+        flip_bit = 2,
+        /// The face is rotated by 90 degrees.
+        rotation_bit = 4
+      };
+
 
       /**
        * For edges, we enforce a standard convention that opposite
@@ -445,23 +525,17 @@ namespace internal
        * other faces have normals that point outward. It turns out that this
        * is not always possible. In effect, we have to store whether the
        * normal vector of each face of each cell follows this convention or
-       * not. If this is so, then this variable stores a @p true value,
-       * otherwise a @p false value.
+       * not. If this is so, then the @p orientation_bit of the entry for
+       * this face is set, otherwise it is not. The other two bits of the
+       * entry store whether the face is flipped (rotated by 180 degrees) and
+       * whether it is rotated by 90 degrees. Keeping the three flags of a
+       * face in one byte lets them be read with a single load and without
+       * the bit manipulations of <code>std::vector@<bool@></code>.
        *
        * In effect, this field has <code>6*n_cells</code> elements, being the
        * number of cells times the six faces each has.
        */
-      std::vector<bool> face_orientations;
-
-      /**
-       * flip = rotation by 180 degrees
-       */
-      std::vector<bool> face_flips;
-
-      /**
-       * rotation by 90 degrees
-       */
-      std::vector<bool> face_rotations;
+      std::vector<unsigned char> face_orientations;
 
       /**
        * Assert that enough space is allocated to accommodate
@@ -503,7 +577,7 @@ namespace internal
      * For quadrilaterals in 3D the data of TriaObjects needs to be extended,
      * as we can obtain faces (quads) with lines in non-standard-orientation,
      * therefore we declare a class TriaObjectsQuad3D, which additionally
-     * contains a bool-vector of the line-orientations.
+     * contains the line-orientations.
      */
     class TriaObjectsQuad3D: public TriaObjects<TriaObject<2> >
     {
@@ -520,9 +594,11 @@ namespace internal
 
       /**
        * In effect, this field has <code>4*n_quads</code> elements, being the
-       * number of quads times the four lines each has.
+       * number of quads times the four lines each has. Like the face
+       * orientations of hexes, the orientations are stored as one byte per
+       * line rather than in a <code>std::vector@<bool@></code>.
        */
-      std::vector<bool> line_orientations;
+      std::vector<unsigned char> line_orientations;
 
       /**
        * Assert that enough space is allocated to accommodate
@@ -603,6 +679,32 @@ namespace internal
     }
 
 
+    template <typename G>
+    inline
+    TriaObjects<G>::ObjectRecord::ObjectRecord ()
+      :
+      refinement_case (RefinementCase<G::dimension>::no_refinement),
+      used (false),
+      user_flag (false)
+    {
+      for (unsigned int i=0; i<GeometryInfo<G::dimension>::max_children_per_cell/2; ++i)
+        children[i] = -1;
+    }
+
+
+
+    template <typename G>
+    template <class Archive>
+    void
+    TriaObjects<G>::ObjectRecord::serialize(Archive &ar,
+                                            const unsigned int)
+    {
+      ar &object &children;
+      ar &refinement_case;
+      ar &used &user_flag;
+    }
+
+
     template <typename G>
     inline
     bool
@@ -703,7 +805,8 @@ namespace internal
     inline
     void TriaObjects<G>::clear_user_flags ()
     {
-      user_flags.assign(user_flags.size(),false);
+      for (unsigned int i=0; i<records.size(); ++i)
+        records[i].user_flag = false;
     }
 
 
@@ -722,12 +825,52 @@ namespace internal
     template <typename G>
     template <class Archive>
     void TriaObjects<G>::serialize(Archive &ar,
-                                   const unsigned int)
+                                   const unsigned int version)
     {
-      ar &cells &children;
-      ar &refinement_cases;
-      ar &used;
-      ar &user_flags;
+      // archives of versions 0 and 1 stored the objects, the children, the
+      // refinement cases and the flags in separate vectors, and version 0
+      // stored the flags as std::vector<bool>. since archives are always
+      // written with the current version, this branch is only taken when
+      // loading such an old archive
+      if (version < 2)
+        {
+          std::vector<G> cells;
+          std::vector<int> children;
+          std::vector<RefinementCase<G::dimension> > refinement_cases;
+          std::vector<unsigned char> used, user_flags;
+          ar &cells &children;
+          ar &refinement_cases;
+          if (version == 0)
+            {
+              std::vector<bool> flags;
+              ar &flags;
+              used.assign (flags.begin(), flags.end());
+              ar &flags;
+              user_flags.assign (flags.begin(), flags.end());
+            }
+          else
+            {
+              ar &used;
+              ar &user_flags;
+            }
+
+          const unsigned int n_children
+            = GeometryInfo<G::dimension>::max_children_per_cell/2;
+          records.resize (cells.size());
+          for (unsigned int i=0; i<cells.size(); ++i)
+            {
+              records[i].object = cells[i];
+              for (unsigned int c=0; c<n_children; ++c)
+                records[i].children[c] = children[n_children*i+c];
+              // lines have no refinement cases
+              if (i < refinement_cases.size())
+                records[i].refinement_case = refinement_cases[i];
+              records[i].used = used[i];
+              records[i].user_flag = user_flags[i];
+            }
+        }
+      else
+        ar &records;
       ar &boundary_or_material_id;
       ar &manifold_id;
       ar &next_free_single &next_free_pair &reverse_order_next_free_single;
@@ -741,7 +884,20 @@ namespace internal
     {
       this->TriaObjects<TriaObject<3> >::serialize (ar, version);
 
-      ar &face_orientations &face_flips &face_rotations;
+      // archives of versions 0 and 1 stored the orientations, flips and
+      // rotations of the faces in three separate std::vector<bool>
+      if (version < 2)
+        {
+          std::vector<bool> orientations, flips, rotations;
+          ar &orientations &flips &rotations;
+          face_orientations.resize (orientations.size());
+          for (unsigned int i=0; i<orientations.size(); ++i)
+            face_orientations[i] = ((orientations[i] ? orientation_bit : 0) |
+                                    (flips[i] ? flip_bit : 0) |
+                                    (rotations[i] ? rotation_bit : 0));
+        }
+      else
+        ar &face_orientations;
     }
 
 
@@ -751,7 +907,16 @@ namespace internal
     {
       this->TriaObjects<TriaObject<2> >::serialize (ar, version);
 
-      ar &line_orientations;
+      // archives of versions 0 and 1 stored the orientations as
+      // std::vector<bool>
+      if (version < 2)
+        {
+          std::vector<bool> orientations;
+          ar &orientations;
+          line_orientations.assign (orientations.begin(), orientations.end());
+        }
+      else
+        ar &line_orientations;
     }
 
 
@@ -767,8 +932,94 @@ namespace internal
       Assert (face < GeometryInfo<3>::faces_per_cell,
               ExcIndexRange(0, face, GeometryInfo<3>::faces_per_cell));
 
-      return face_orientations[cell * GeometryInfo<3>::faces_per_cell
-                               + face];
+      return (face_orientations[cell * GeometryInfo<3>::faces_per_cell
+                                + face] & orientation_bit) != 0;
+    }
+
+
+
+    inline
+    bool
+    TriaObjectsHex::face_flip(const unsigned int cell,
+                              const unsigned int face) const
+    {
+      Assert (cell < face_orientations.size() / GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, cell, face_orientations.size() / GeometryInfo<3>::faces_per_cell));
+      Assert (face < GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, face, GeometryInfo<3>::faces_per_cell));
+
+      return (face_orientations[cell * GeometryInfo<3>::faces_per_cell
+                                + face] & flip_bit) != 0;
+    }
+
+
+
+    inline
+    bool
+    TriaObjectsHex::face_rotation(const unsigned int cell,
+                                  const unsigned int face) const
+    {
+      Assert (cell < face_orientations.size() / GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, cell, face_orientations.size() / GeometryInfo<3>::faces_per_cell));
+      Assert (face < GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, face, GeometryInfo<3>::faces_per_cell));
+
+      return (face_orientations[cell * GeometryInfo<3>::faces_per_cell
+                                + face] & rotation_bit) != 0;
+    }
+
+
+
+    inline
+    void
+    TriaObjectsHex::set_face_orientation(const unsigned int cell,
+                                         const unsigned int face,
+                                         const bool value)
+    {
+      Assert (cell < face_orientations.size() / GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, cell, face_orientations.size() / GeometryInfo<3>::faces_per_cell));
+      Assert (face < GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, face, GeometryInfo<3>::faces_per_cell));
+
+      unsigned char &bits = face_orientations[cell * GeometryInfo<3>::faces_per_cell
+                                              + face];
+      bits = (value ? (bits | orientation_bit) : (bits & ~orientation_bit));
+    }
+
+
+
+    inline
+    void
+    TriaObjectsHex::set_face_flip(const unsigned int cell,
+                                  const unsigned int face,
+                                  const bool value)
+    {
+      Assert (cell < face_orientations.size() / GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, cell, face_orientations.size() / GeometryInfo<3>::faces_per_cell));
+      Assert (face < GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, face, GeometryInfo<3>::faces_per_cell));
+
+      unsigned char &bits = face_orientations[cell * GeometryInfo<3>::faces_per_cell
+                                              + face];
+      bits = (value ? (bits | flip_bit) : (bits & ~flip_bit));
+    }
+
+
+
+    inline
+    void
+    TriaObjectsHex::set_face_rotation(const unsigned int cell,
+                                      const unsigned int face,
+                                      const bool value)
+    {
+      Assert (cell < face_orientations.size() / GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, cell, face_orientations.size() / GeometryInfo<3>::faces_per_cell));
+      Assert (face < GeometryInfo<3>::faces_per_cell,
+              ExcIndexRange(0, face, GeometryInfo<3>::faces_per_cell));
+
+      unsigned char &bits = face_orientations[cell * GeometryInfo<3>::faces_per_cell
+                                              + face];
+      bits = (value ? (bits | rotation_bit) : (bits & ~rotation_bit));
     }
 
 //----------------------------------------------------------------------//
@@ -778,7 +1029,7 @@ namespace internal
     TriaObjectsQuad3D::face_orientation(const unsigned int cell, const unsigned int face) const
     {
       return line_orientations[cell * GeometryInfo<2>::faces_per_cell
-                               + face];
+                               + face] != 0;
     }
 
 
@@ -792,14 +1043,14 @@ namespace internal
       // TODO: Think of a way to ensure that we are using the correct triangulation, i.e. the one containing *this.
 
       int pos=next_free_single,
-          last=used.size()-1;
+          last=records.size()-1;
       if (!reverse_order_next_free_single)
         {
           // first sweep forward, only use really single slots, do not use
           // pair slots
           for (; pos<last; ++pos)
-            if (!used[pos])
-              if (used[++pos])
+            if (!records[pos].used)
+              if (records[++pos].used)
                 {
                   // this was a single slot
                   pos-=1;
@@ -808,8 +1059,8 @@ namespace internal
           if (pos>=last)
             {
               reverse_order_next_free_single=true;
-              next_free_single=used.size()-1;
-              pos=used.size()-1;
+              next_free_single=records.size()-1;
+              pos=records.size()-1;
             }
           else
             next_free_single=pos+1;
@@ -820,7 +1071,7 @@ namespace internal
           // second sweep, use all slots, even
           // in pairs
           for (; pos>=0; --pos)
-            if (!used[pos])
+            if (!records[pos].used)
               break;
           if (pos>0)
             next_free_single=pos-1;
@@ -842,10 +1093,10 @@ namespace internal
       // TODO: Think of a way to ensure that we are using the correct triangulation, i.e. the one containing *this.
 
       int pos=next_free_pair,
-          last=used.size()-1;
+          last=records.size()-1;
       for (; pos<last; ++pos)
-        if (!used[pos])
-          if (!used[++pos])
+        if (!records[pos].used)
+          if (!records[++pos].used)
             {
               // this was a pair slot
               pos-=1;
@@ -875,4 +1126,14 @@ namespace internal
 
 DEAL_II_NAMESPACE_CLOSE
 
+// version 1 stores the used and user flags as one byte per object rather
+// than as std::vector<bool>. version 2 stores the objects, their children,
+// refinement cases and flags in one record per object, and the face and line
+// orientations as one byte per face or line
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjects<dealii::internal::Triangulation::TriaObject<1> >, 2)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjects<dealii::internal::Triangulation::TriaObject<2> >, 2)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjects<dealii::internal::Triangulation::TriaObject<3> >, 2)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjectsHex, 2)
+BOOST_CLASS_VERSION(dealii::internal::Triangulation::TriaObjectsQuad3D, 2)
+
 #endif
@@ -22,6 +22,7 @@
 #include <deal.II/base/index_set.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/base/template_constraints.h>
+#include <deal.II/base/thread_management.h>
 
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/vector_element_access.h>
@@ -170,6 +171,71 @@ public:
     right_object_wins
   };
 
+  /**
+   * A set of mutexes that serializes concurrent writes into the rows of a
+   * global matrix and vector by the distribute_local_to_global() function
+   * that takes an object of this type. The rows are grouped into blocks of
+   * @p rows_per_block consecutive indices, and the blocks are assigned to
+   * the mutexes in a round-robin fashion (lock striping). Two threads only
+   * wait for each other if they write into rows of the same stripe at the
+   * same time, which allows several threads to add their local
+   * contributions into the same global objects concurrently. A typical use
+   * is to call distribute_local_to_global() directly in the worker function
+   * of WorkStream::run() and to pass an empty copier function, rather than
+   * funneling all writes through the single copier thread:
+   * @code
+   *   ConstraintMatrix::RowLocks row_locks;
+   *   WorkStream::run (dof_handler.begin_active(), dof_handler.end(),
+   *                    [&] (const cell_iterator &cell,
+   *                         ScratchData         &scratch,
+   *                         CopyData            &copy)
+   *                    {
+   *                      assemble_on_one_cell (cell, scratch, copy);
+   *                      constraints.distribute_local_to_global
+   *                        (copy.cell_matrix, copy.cell_rhs,
+   *                         copy.local_dof_indices,
+   *                         system_matrix, system_rhs, row_locks);
+   *                    },
+   *                    std::function<void(const CopyData &)>(),
+   *                    ScratchData(), CopyData());
+   * @endcode
+   */
+  class RowLocks
+  {
+  public:
+    /**
+     * Constructor. Sets up @p n_stripes mutexes, each protecting every
+     * <code>n_stripes</code>-th block of @p rows_per_block rows. The default
+     * value zero for @p n_stripes selects 16 times the number of threads
+     * returned by MultithreadInfo::n_threads(), which makes it unlikely that
+     * two threads need the same mutex at the same time.
+     */
+    explicit RowLocks (const unsigned int n_stripes      = 0,
+                       const unsigned int rows_per_block = 16);
+
+    /**
+     * Return the mutex that protects the given global row.
+     */
+    Threads::Mutex &get_mutex (const size_type row) const;
+
+    /**
+     * Return the number of mutexes.
+     */
+    unsigned int n_stripes () const;
+
+  private:
+    /**
+     * The number of consecutive rows protected by the same mutex.
+     */
+    unsigned int rows_per_block;
+
+    /**
+     * The mutexes. They are marked mutable since locking does not change
+     * the logical state of this object.
+     */
+    mutable std::vector<Threads::Mutex> mutexes;
+  };
+
   /**
    * Constructor. The supplied IndexSet defines which indices might be
    * constrained inside this ConstraintMatrix. In a calculation with a
@@ -985,7 +1051,7 @@ public:
    * for simultaneous access and the access is not to rows with the same
    * global index at the same time. This needs to be made sure from the
    * caller's site. There is no locking mechanism inside this method to
-   * prevent data races.
+   * prevent data races. The next function provides such a mechanism.
    */
   template <typename MatrixType, typename VectorType>
   void
@@ -996,6 +1062,33 @@ public:
                               VectorType                    &global_vector,
                               bool                          use_inhomogeneities_for_rhs = false) const;
 
+  /**
+   * Same as the previous function, but all writes into @p global_matrix and
+   * @p global_vector are protected by the mutexes of @p row_locks. Thus,
+   * several threads may call this function at the same time on the same
+   * global objects, as long as all of them use the same @p row_locks
+   * object, see the documentation of RowLocks for an example.
+   *
+   * Each thread holds at most one mutex at a time. Since the global rows
+   * touched by the local contributions are processed in ascending order, a
+   * thread keeps a mutex across consecutive rows of the same block rather
+   * than acquiring it once per row.
+   *
+   * This function is only available for non-block matrices that allow for
+   * concurrent writes into different rows, such as SparseMatrix or
+   * FullMatrix, and for vectors with the same property such as Vector or
+   * LinearAlgebra::distributed::Vector.
+   */
+  template <typename MatrixType, typename VectorType>
+  void
+  distribute_local_to_global (const FullMatrix<typename MatrixType::value_type> &local_matrix,
+                              const Vector<typename VectorType::value_type>     &local_vector,
+                              const std::vector<size_type>  &local_dof_indices,
+                              MatrixType                    &global_matrix,
+                              VectorType                    &global_vector,
+                              const RowLocks                &row_locks,
+                              bool                          use_inhomogeneities_for_rhs = false) const;
+
   /**
    * Do a similar operation as the distribute_local_to_global() function that
    * distributes writing entries into a matrix for constrained degrees of
@@ -1401,6 +1494,22 @@ private:
                               bool                          use_inhomogeneities_for_rhs,
                               std::integral_constant<bool, false>) const;
 
+  /**
+   * Same as the previous function, but protecting the writes into the
+   * global objects by the mutexes of @p row_locks unless it is a null
+   * pointer.
+   */
+  template <typename MatrixType, typename VectorType>
+  void
+  distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>  &local_matrix,
+                              const Vector<typename VectorType::value_type>      &local_vector,
+                              const std::vector<size_type> &local_dof_indices,
+                              MatrixType                   &global_matrix,
+                              VectorType                   &global_vector,
+                              bool                          use_inhomogeneities_for_rhs,
+                              std::integral_constant<bool, false>,
+                              const RowLocks               *row_locks) const;
+
   /**
    * This function actually implements the local_to_global function for block
    * matrices.
@@ -1477,6 +1586,24 @@ private:
 
 /* ---------------- template and inline functions ----------------- */
 
+inline
+Threads::Mutex &
+ConstraintMatrix::RowLocks::get_mutex (const size_type row) const
+{
+  return mutexes[(row / rows_per_block) % mutexes.size()];
+}
+
+
+
+inline
+unsigned int
+ConstraintMatrix::RowLocks::n_stripes () const
+{
+  return mutexes.size();
+}
+
+
+
 inline
 ConstraintMatrix::ConstraintMatrix (const IndexSet &local_constraints)
   :
@@ -1914,6 +2041,27 @@ distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>
 
 
 
+template <typename MatrixType, typename VectorType>
+inline
+void
+ConstraintMatrix::
+distribute_local_to_global (const FullMatrix<typename MatrixType::value_type>     &local_matrix,
+                            const Vector<typename VectorType::value_type>         &local_vector,
+                            const std::vector<size_type> &local_dof_indices,
+                            MatrixType                   &global_matrix,
+                            VectorType                   &global_vector,
+                            const RowLocks               &row_locks,
+                            bool                          use_inhomogeneities_for_rhs) const
+{
+  static_assert (IsBlockMatrix<MatrixType>::value == false,
+                 "Row locks are not implemented for block matrices.");
+  distribute_local_to_global (local_matrix, local_vector, local_dof_indices,
+                              global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                              std::integral_constant<bool, false>(), &row_locks);
+}
+
+
+
 
 template <typename SparsityPatternType>
 inline
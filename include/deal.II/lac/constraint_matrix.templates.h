@@ -1979,7 +1979,8 @@ add_this_index:
                         const ConstraintMatrix               &constraints,
                         MatrixType                           &global_matrix,
                         VectorType                           &global_vector,
-                        bool                                 use_inhomogeneities_for_rhs)
+                        bool                                 use_inhomogeneities_for_rhs,
+                        const ConstraintMatrix::RowLocks     *row_locks = nullptr)
   {
     if (global_rows.n_constraints() > 0)
       {
@@ -1995,6 +1996,10 @@ add_this_index:
             const typename MatrixType::value_type new_diagonal
               = (std::abs(local_matrix(local_row,local_row)) != 0 ?
                  std::abs(local_matrix(local_row,local_row)) : average_diagonal);
+
+            if (row_locks != nullptr)
+              row_locks->get_mutex(global_row).acquire();
+
             global_matrix.add(global_row, global_row, new_diagonal);
 
             // if the use_inhomogeneities_for_rhs flag is set to true, the
@@ -2003,6 +2008,9 @@ add_this_index:
             // we set those to: inhomogeneity(i)*global_matrix (i,i).
             if (use_inhomogeneities_for_rhs == true)
               global_vector(global_row) += new_diagonal * constraints.get_inhomogeneity(global_row);
+
+            if (row_locks != nullptr)
+              row_locks->get_mutex(global_row).release();
           }
       }
   }
@@ -2234,6 +2242,28 @@ ConstraintMatrix::distribute_local_to_global (
   VectorType                      &global_vector,
   bool                            use_inhomogeneities_for_rhs,
   std::integral_constant<bool, false>) const
+{
+  distribute_local_to_global (local_matrix, local_vector, local_dof_indices,
+                              global_matrix, global_vector,
+                              use_inhomogeneities_for_rhs,
+                              std::integral_constant<bool, false>(),
+                              static_cast<const RowLocks *>(nullptr));
+}
+
+
+
+// same as above, but with optional locking of the rows written into
+template <typename MatrixType, typename VectorType>
+void
+ConstraintMatrix::distribute_local_to_global (
+  const FullMatrix<typename MatrixType::value_type>     &local_matrix,
+  const Vector<typename VectorType::value_type>         &local_vector,
+  const std::vector<size_type>    &local_dof_indices,
+  MatrixType                      &global_matrix,
+  VectorType                      &global_vector,
+  bool                            use_inhomogeneities_for_rhs,
+  std::integral_constant<bool, false>,
+  const RowLocks                  *row_locks) const
 {
   // check whether we work on real vectors or we just used a dummy when
   // calling the other function above.
@@ -2288,12 +2318,24 @@ ConstraintMatrix::distribute_local_to_global (
     Assert (sparse_matrix != nullptr, ExcInternalError());
 
   // now do the actual job. go through all the global rows that we will touch
-  // and call resolve_matrix_row for each of those.
+  // and call resolve_matrix_row for each of those. if we got row locks, we
+  // hold the mutex of the current row while writing into the matrix and
+  // vector. since the rows are sorted, consecutive rows often share the same
+  // mutex, so we only switch mutexes when the next row needs a different one
   size_type local_row_n = 0;
+  Threads::Mutex *current_mutex = nullptr;
   for (size_type i=0; i<n_actual_dofs; ++i)
     {
       const size_type row = global_rows.global_row(i);
 
+      if (row_locks != nullptr && &row_locks->get_mutex(row) != current_mutex)
+        {
+          if (current_mutex != nullptr)
+            current_mutex->release();
+          current_mutex = &row_locks->get_mutex(row);
+          current_mutex->acquire();
+        }
+
       // calculate all the data that will be written into the matrix row.
       if (use_dealii_matrix == false)
         {
@@ -2327,12 +2369,22 @@ ConstraintMatrix::distribute_local_to_global (
 
           if (val != number ())
             {
-              vector_indices[local_row_n] = row;
-              vector_values[local_row_n] = val;
-              ++local_row_n;
+              // with locks, we must write while still holding the mutex of
+              // this row, otherwise we collect the entries for a bulk update
+              if (row_locks != nullptr)
+                global_vector(row) += static_cast<typename VectorType::value_type>(val);
+              else
+                {
+                  vector_indices[local_row_n] = row;
+                  vector_values[local_row_n] = val;
+                  ++local_row_n;
+                }
             }
         }
     }
+  if (current_mutex != nullptr)
+    current_mutex->release();
+
   // Drop the elements of vector_indices and vector_values that we do not use (we may
   // always elide writing zero values to vectors)
   const size_type n_local_rows = local_row_n;
@@ -2360,7 +2412,8 @@ ConstraintMatrix::distribute_local_to_global (
 
   internals::set_matrix_diagonals (global_rows, local_dof_indices,
                                    local_matrix, *this,
-                                   global_matrix, global_vector, use_inhomogeneities_for_rhs);
+                                   global_matrix, global_vector, use_inhomogeneities_for_rhs,
+                                   row_locks);
 }
 
 
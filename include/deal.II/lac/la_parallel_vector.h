@@ -29,6 +29,9 @@
 
 DEAL_II_NAMESPACE_OPEN
 
+class CheckpointWriter;
+class CheckpointReader;
+
 namespace LinearAlgebra
 {
   namespace distributed
@@ -732,6 +735,94 @@ namespace LinearAlgebra
       void equ (const Number a, const Vector<Number> &u,
                 const Number b, const Vector<Number> &v) DEAL_II_DEPRECATED;
 
+      /**
+       * Compute the inner products of this vector with each of the vectors
+       * in @p V, i.e., <code>result[i] = (*this) * (*V[i])</code>. In contrast
+       * to calling operator* several times, the inner products are computed
+       * in a single sweep over the locally owned elements (processing up to
+       * four vectors at a time), in parallel with the task framework, and
+       * with a single global communication for all of them. This reduces
+       * the number of synchronization points in iterative solvers, e.g. in
+       * SolverCG and SolverGMRES.
+       *
+       * The results are exactly the same as the ones obtained from operator*.
+       */
+      std::vector<Number>
+      multi_dot (const std::vector<const Vector<Number> *> &V) const;
+
+      /**
+       * Same as multi_dot(), but do not wait for the global communication to
+       * finish. The local contributions are computed immediately, whereas
+       * the global sum is started as a non-blocking collective operation. The
+       * result can be obtained through the returned object, once it is
+       * needed; this allows to overlap the communication with other work.
+       * All processors of the communicator must call this function in the
+       * same order, like for any other collective operation.
+       *
+       * If the MPI library does not support non-blocking collective
+       * operations, this function is equivalent to multi_dot(). See also
+       * Utilities::MPI::isum().
+       */
+      Utilities::MPI::Future<std::vector<Number> >
+      multi_dot_start (const std::vector<const Vector<Number> *> &V) const;
+
+      /**
+       * Block version of multi_dot_start(): start computing the inner
+       * products of each of the vectors in @p V with each of the vectors in
+       * @p W, stored in the result as <code>result[i*W.size()+j] = (*V[i]) *
+       * (*W[j])</code>. All inner products are summed over the processors
+       * with a single non-blocking global communication. This is the
+       * building block of s-step and pipelined Krylov methods that
+       * orthogonalize several vectors at once, see SolverSStepGMRES and
+       * SolverPipeCG.
+       *
+       * All vectors must have the same parallel layout, and @p V must not be
+       * empty.
+       */
+      static
+      Utilities::MPI::Future<std::vector<Number> >
+      block_dot_start (const std::vector<const Vector<Number> *> &V,
+                       const std::vector<const Vector<Number> *> &W);
+
+      /**
+       * Write the locally owned elements of this vector to the checkpoint
+       * file of @p writer, using blocks whose names start with @p name. The
+       * data of each processor is written as one contiguous array, followed
+       * by the range of global indices it represents. This is a collective
+       * operation.
+       */
+      void save (CheckpointWriter  &writer,
+                 const std::string &name) const;
+
+      /**
+       * Read the locally owned elements of this vector from a checkpoint file
+       * written by save() under the given @p name. The vector must already
+       * have been initialized with the same parallel layout it had when it
+       * was saved, e.g. from a DoFHandler built on a Triangulation that was
+       * itself restored from the checkpoint file on the same number of
+       * processors. Each processor then reads the part written by the
+       * processor with the same rank with a single copy from the mapped
+       * file. This is a collective operation.
+       *
+       * The global numbering of degrees of freedom depends on the
+       * partitioning of the mesh, so a vector can not be reassembled from
+       * the stored index ranges on a different number of processors. This
+       * function therefore throws an exception if the number of processors
+       * or the locally owned range of any processor differs from the one
+       * stored in the file. To restart on a different number of processors,
+       * transfer the solution through data attached to the cells of the
+       * triangulation instead, e.g. with
+       * parallel::distributed::SolutionTransfer::prepare_serialization()
+       * before saving the triangulation and
+       * parallel::distributed::SolutionTransfer::deserialize() after loading
+       * it.
+       *
+       * Ghost elements are set to zero; call update_ghost_values() if they
+       * are needed.
+       */
+      void load (const CheckpointReader &reader,
+                 const std::string      &name);
+
       //@}
 
 
@@ -1068,6 +1159,12 @@ namespace LinearAlgebra
                                 const Vector<Number> &V,
                                 const Vector<Number> &W);
 
+      /**
+       * Local part of multi_dot().
+       */
+      std::vector<Number>
+      multi_dot_local (const std::vector<const Vector<Number> *> &V) const;
+
       /**
        * Shared pointer to store the parallel partitioning information. This
        * information can be shared between several vectors that have the same
@@ -18,6 +18,7 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/checkpoint.h>
 #include <deal.II/lac/exceptions.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/vector_operations_internal.h>
@@ -516,6 +517,61 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    void
+    Vector<Number>::save (CheckpointWriter  &writer,
+                          const std::string &name) const
+    {
+      const unsigned long long int range[2]
+        = { partitioner->local_range().first, partitioner->local_size() };
+      writer.write_block (name + "/values", val, partitioner->local_size());
+      writer.write_block (name + "/range", range, 2);
+    }
+
+
+
+    template <typename Number>
+    void
+    Vector<Number>::load (const CheckpointReader &reader,
+                          const std::string      &name)
+    {
+      const std::pair<size_type,size_type> my_range = partitioner->local_range();
+      const unsigned int my_rank = reader.this_process();
+
+      // the global numbering of the elements depends on the partitioning of
+      // the mesh, so the stored values can only be interpreted if the
+      // processor with the same rank wrote exactly our range. check this on
+      // all processors to make sure that either all or none of them throw
+      bool same_layout
+        = (reader.n_writer_processes() ==
+           Utilities::MPI::n_mpi_processes (partitioner->get_mpi_communicator()));
+      if (same_layout)
+        {
+          const ArrayView<const unsigned long long int> range
+            = reader.get_block<unsigned long long int> (name + "/range", my_rank);
+          AssertThrow (range.size() == 2,
+                       CheckpointReader::ExcBlockNotFound (name + "/range"));
+          same_layout = (range[0] == my_range.first &&
+                         range[1] == my_range.second-my_range.first);
+        }
+      AssertThrow (Utilities::MPI::min (same_layout ? 1U : 0U,
+                                        partitioner->get_mpi_communicator()) == 1U,
+                   ExcMessage ("The parallel layout of the vector <" + name +
+                               "> in the checkpoint file does not match the "
+                               "layout of this vector. Vectors can only be "
+                               "loaded on the same number of processors and "
+                               "with the same partitioning they were saved "
+                               "with."));
+
+      const ArrayView<const Number> values
+        = reader.get_block<Number> (name + "/values", my_rank);
+      AssertDimension (values.size(), partitioner->local_size());
+      std::copy (values.begin(), values.end(), val);
+      zero_out_ghosts ();
+    }
+
+
+
     template <typename Number>
     void
     Vector<Number>::compress_start (const unsigned int counter,
@@ -1515,6 +1571,81 @@ namespace LinearAlgebra
 
 
 
+    template <typename Number>
+    std::vector<Number>
+    Vector<Number>::multi_dot_local (const std::vector<const Vector<Number> *> &V) const
+    {
+      typedef internal::VectorOperations::MultiDot<Number> MultiDot;
+
+      std::vector<Number> results (V.size());
+      for (unsigned int start=0; start<V.size(); start+=MultiDot::max_vectors)
+        {
+          const unsigned int n_vectors
+            = std::min<unsigned int>(MultiDot::max_vectors, V.size()-start);
+          const Number *vector_values[MultiDot::max_vectors];
+          for (unsigned int v=0; v<n_vectors; ++v)
+            {
+              AssertDimension (partitioner->local_size(), V[start+v]->partitioner->local_size());
+              vector_values[v] = V[start+v]->val;
+            }
+
+          typename MultiDot::ResultType sums;
+          MultiDot dot (val, vector_values, n_vectors);
+          internal::VectorOperations::parallel_reduce (dot, 0, partitioner->local_size(),
+                                                       sums, thread_loop_partitioner);
+          for (unsigned int v=0; v<n_vectors; ++v)
+            {
+              AssertIsFinite(sums.values[v]);
+              results[start+v] = sums.values[v];
+            }
+        }
+      return results;
+    }
+
+
+
+    template <typename Number>
+    std::vector<Number>
+    Vector<Number>::multi_dot (const std::vector<const Vector<Number> *> &V) const
+    {
+      std::vector<Number> results = multi_dot_local (V);
+      if (partitioner->n_mpi_processes() > 1)
+        Utilities::MPI::sum (results, partitioner->get_mpi_communicator(), results);
+      return results;
+    }
+
+
+
+    template <typename Number>
+    Utilities::MPI::Future<std::vector<Number> >
+    Vector<Number>::multi_dot_start (const std::vector<const Vector<Number> *> &V) const
+    {
+      return Utilities::MPI::isum (multi_dot_local (V),
+                                   partitioner->get_mpi_communicator());
+    }
+
+
+
+    template <typename Number>
+    Utilities::MPI::Future<std::vector<Number> >
+    Vector<Number>::block_dot_start (const std::vector<const Vector<Number> *> &V,
+                                     const std::vector<const Vector<Number> *> &W)
+    {
+      Assert (V.size() > 0, ExcMessage ("The list of vectors must not be empty."));
+
+      std::vector<Number> results;
+      results.reserve (V.size()*W.size());
+      for (unsigned int i=0; i<V.size(); ++i)
+        {
+          const std::vector<Number> products = V[i]->multi_dot_local (W);
+          results.insert (results.end(), products.begin(), products.end());
+        }
+      return Utilities::MPI::isum (results,
+                                   V[0]->partitioner->get_mpi_communicator());
+    }
+
+
+
     template <typename Number>
     inline
     bool
@@ -19,6 +19,7 @@
 // This file contains simple preconditioners.
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/base/smartpointer.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/parallel.h>
@@ -26,6 +27,7 @@
 #include <deal.II/base/thread_management.h>
 #include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/sweep_schedule.h>
 #include <deal.II/lac/vector_memory.h>
 
 DEAL_II_NAMESPACE_OPEN
@@ -398,12 +400,30 @@ public:
     /**
      * Constructor.
      */
-    AdditionalData (const double relaxation = 1.);
+    AdditionalData (const double                  relaxation = 1.,
+                    const SweepSchedule::Ordering ordering = SweepSchedule::level_scheduling);
 
     /**
      * Relaxation parameter.
      */
     double relaxation;
+
+    /**
+     * The grouping of the rows with which PreconditionSOR and
+     * PreconditionSSOR run their sweeps on several threads if the matrix is
+     * a SparseMatrix. The default, SweepSchedule::level_scheduling, gives
+     * the same results as the sequential sweeps.
+     * SweepSchedule::multicoloring exposes more parallelism, but turns the
+     * method into SOR for a different ordering of the unknowns. See the
+     * SweepSchedule class for details. The other classes derived from
+     * PreconditionRelaxation ignore this parameter.
+     *
+     * If only one thread is available (see MultithreadInfo::n_threads()),
+     * the level schedule is not built and the sequential sweeps are used,
+     * which avoids the setup cost and the synchronization between the
+     * groups.
+     */
+    SweepSchedule::Ordering ordering;
   };
 
   /**
@@ -563,6 +583,14 @@ public:
    */
   typedef typename PreconditionRelaxation<MatrixType>::AdditionalData AdditionalData;
 
+  /**
+   * Initialize matrix and relaxation parameter. The matrix is just stored in
+   * the preconditioner object. If it is a SparseMatrix, the rows are also
+   * grouped for parallel sweeps as specified by AdditionalData::ordering.
+   */
+  void initialize (const MatrixType     &A,
+                   const AdditionalData &parameters = AdditionalData());
+
   /**
    * Apply preconditioner.
    */
@@ -586,6 +614,13 @@ public:
    */
   template <class VectorType>
   void Tstep (VectorType &x, const VectorType &rhs) const;
+
+private:
+  /**
+   * The groups of rows for parallel sweeps. Empty unless the matrix is a
+   * SparseMatrix.
+   */
+  SweepSchedule schedule;
 };
 
 
@@ -640,7 +675,9 @@ public:
   /**
    * Initialize matrix and relaxation parameter. The matrix is just stored in
    * the preconditioner object. The relaxation parameter should be larger than
-   * zero and smaller than 2 for numerical reasons. It defaults to 1.
+   * zero and smaller than 2 for numerical reasons. It defaults to 1. If the
+   * matrix is a SparseMatrix, the rows are also grouped for parallel sweeps
+   * as specified by AdditionalData::ordering.
    */
   void initialize (const MatrixType &A,
                    const typename BaseClass::AdditionalData &parameters = typename BaseClass::AdditionalData());
@@ -677,6 +714,12 @@ private:
    * the diagonal is located.
    */
   std::vector<std::size_t> pos_right_of_diagonal;
+
+  /**
+   * The groups of rows for parallel sweeps. Empty unless the matrix is a
+   * SparseMatrix.
+   */
+  SweepSchedule schedule;
 };
 
 
@@ -1314,6 +1357,179 @@ PreconditionRichardson::n () const
 
 //---------------------------------------------------------------------------
 
+namespace internal
+{
+  namespace PreconditionRelaxation
+  {
+    // level scheduling only pays off if the groups can be worked on by
+    // several threads, since the sequential sweeps give the same result
+    // anyway. multicoloring changes the order of the unknowns, so we need to
+    // build the schedule also for one thread in order to get the same result
+    // independently of the number of threads
+    inline
+    bool
+    use_schedule (const SweepSchedule::Ordering ordering)
+    {
+      return (ordering == SweepSchedule::multicoloring ||
+              MultithreadInfo::n_threads() > 1);
+    }
+
+    // general matrix types only offer the sequential sweeps and get an empty
+    // schedule. for a SparseMatrix, the overloads below are more specialized
+    // and pass the schedule on
+    template <typename MatrixType, typename VectorType>
+    inline
+    void
+    precondition_SOR (const MatrixType    &A,
+                      VectorType          &dst,
+                      const VectorType    &src,
+                      const double         omega,
+                      const SweepSchedule &)
+    {
+      A.precondition_SOR (dst, src, omega);
+    }
+
+    template <typename number, typename somenumber>
+    inline
+    void
+    precondition_SOR (const dealii::SparseMatrix<number> &A,
+                      dealii::Vector<somenumber>         &dst,
+                      const dealii::Vector<somenumber>   &src,
+                      const double                       omega,
+                      const SweepSchedule                &schedule)
+    {
+      A.precondition_SOR (dst, src, omega, schedule);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    inline
+    void
+    precondition_TSOR (const MatrixType    &A,
+                       VectorType          &dst,
+                       const VectorType    &src,
+                       const double         omega,
+                       const SweepSchedule &)
+    {
+      A.precondition_TSOR (dst, src, omega);
+    }
+
+    template <typename number, typename somenumber>
+    inline
+    void
+    precondition_TSOR (const dealii::SparseMatrix<number> &A,
+                       dealii::Vector<somenumber>         &dst,
+                       const dealii::Vector<somenumber>   &src,
+                       const double                       omega,
+                       const SweepSchedule                &schedule)
+    {
+      A.precondition_TSOR (dst, src, omega, schedule);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    inline
+    void
+    precondition_SSOR (const MatrixType               &A,
+                       VectorType                     &dst,
+                       const VectorType               &src,
+                       const double                    omega,
+                       const std::vector<std::size_t> &pos_right_of_diagonal,
+                       const SweepSchedule            &)
+    {
+      A.precondition_SSOR (dst, src, omega, pos_right_of_diagonal);
+    }
+
+    template <typename number, typename somenumber>
+    inline
+    void
+    precondition_SSOR (const dealii::SparseMatrix<number> &A,
+                       dealii::Vector<somenumber>         &dst,
+                       const dealii::Vector<somenumber>   &src,
+                       const double                       omega,
+                       const std::vector<std::size_t>     &pos_right_of_diagonal,
+                       const SweepSchedule                &schedule)
+    {
+      if (schedule.empty())
+        A.precondition_SSOR (dst, src, omega, pos_right_of_diagonal);
+      else
+        A.precondition_SSOR (dst, src, omega, schedule);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    inline
+    void
+    SOR_step (const MatrixType    &A,
+              VectorType          &v,
+              const VectorType    &b,
+              const double         omega,
+              const SweepSchedule &)
+    {
+      A.SOR_step (v, b, omega);
+    }
+
+    template <typename number, typename somenumber>
+    inline
+    void
+    SOR_step (const dealii::SparseMatrix<number> &A,
+              dealii::Vector<somenumber>         &v,
+              const dealii::Vector<somenumber>   &b,
+              const double                       omega,
+              const SweepSchedule                &schedule)
+    {
+      A.SOR_step (v, b, omega, schedule);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    inline
+    void
+    TSOR_step (const MatrixType    &A,
+               VectorType          &v,
+               const VectorType    &b,
+               const double         omega,
+               const SweepSchedule &)
+    {
+      A.TSOR_step (v, b, omega);
+    }
+
+    template <typename number, typename somenumber>
+    inline
+    void
+    TSOR_step (const dealii::SparseMatrix<number> &A,
+               dealii::Vector<somenumber>         &v,
+               const dealii::Vector<somenumber>   &b,
+               const double                       omega,
+               const SweepSchedule                &schedule)
+    {
+      A.TSOR_step (v, b, omega, schedule);
+    }
+
+    template <typename MatrixType, typename VectorType>
+    inline
+    void
+    SSOR_step (const MatrixType    &A,
+               VectorType          &v,
+               const VectorType    &b,
+               const double         omega,
+               const SweepSchedule &)
+    {
+      A.SSOR_step (v, b, omega);
+    }
+
+    template <typename number, typename somenumber>
+    inline
+    void
+    SSOR_step (const dealii::SparseMatrix<number> &A,
+               dealii::Vector<somenumber>         &v,
+               const dealii::Vector<somenumber>   &b,
+               const double                       omega,
+               const SweepSchedule                &schedule)
+    {
+      A.SSOR_step (v, b, omega, schedule);
+    }
+  }
+}
+
+
+
 template <typename MatrixType>
 inline void
 PreconditionRelaxation<MatrixType>::initialize (const MatrixType     &rA,
@@ -1410,6 +1626,24 @@ PreconditionJacobi<MatrixType>::Tstep (VectorType &dst, const VectorType &src) c
 
 //---------------------------------------------------------------------------
 
+template <typename MatrixType>
+inline void
+PreconditionSOR<MatrixType>::initialize (const MatrixType     &rA,
+                                         const AdditionalData &parameters)
+{
+  this->PreconditionRelaxation<MatrixType>::initialize (rA, parameters);
+
+  const SparseMatrix<typename MatrixType::value_type> *mat =
+    dynamic_cast<const SparseMatrix<typename MatrixType::value_type> *>(&*this->A);
+  if (mat != nullptr &&
+      internal::PreconditionRelaxation::use_schedule (parameters.ordering))
+    schedule.initialize (mat->get_sparsity_pattern(), parameters.ordering);
+  else
+    schedule.clear ();
+}
+
+
+
 template <typename MatrixType>
 template <class VectorType>
 inline void
@@ -1420,7 +1654,8 @@ PreconditionSOR<MatrixType>::vmult (VectorType &dst, const VectorType &src) cons
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_SOR (dst, src, this->relaxation);
+  internal::PreconditionRelaxation::precondition_SOR (*this->A, dst, src,
+                                                      this->relaxation, schedule);
 }
 
 
@@ -1435,7 +1670,8 @@ PreconditionSOR<MatrixType>::Tvmult (VectorType &dst, const VectorType &src) con
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_TSOR (dst, src, this->relaxation);
+  internal::PreconditionRelaxation::precondition_TSOR (*this->A, dst, src,
+                                                       this->relaxation, schedule);
 }
 
 
@@ -1450,7 +1686,8 @@ PreconditionSOR<MatrixType>::step (VectorType &dst, const VectorType &src) const
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->SOR_step (dst, src, this->relaxation);
+  internal::PreconditionRelaxation::SOR_step (*this->A, dst, src,
+                                              this->relaxation, schedule);
 }
 
 
@@ -1465,7 +1702,8 @@ PreconditionSOR<MatrixType>::Tstep (VectorType &dst, const VectorType &src) cons
     "PreconditionSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->TSOR_step (dst, src, this->relaxation);
+  internal::PreconditionRelaxation::TSOR_step (*this->A, dst, src,
+                                               this->relaxation, schedule);
 }
 
 
@@ -1503,6 +1741,12 @@ PreconditionSSOR<MatrixType>::initialize (const MatrixType                     &
           pos_right_of_diagonal[row] = it - mat->begin();
         }
     }
+
+  if (mat != nullptr &&
+      internal::PreconditionRelaxation::use_schedule (parameters.ordering))
+    schedule.initialize (mat->get_sparsity_pattern(), parameters.ordering);
+  else
+    schedule.clear ();
 }
 
 
@@ -1516,7 +1760,10 @@ PreconditionSSOR<MatrixType>::vmult (VectorType &dst, const VectorType &src) con
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  internal::PreconditionRelaxation::precondition_SSOR (*this->A, dst, src,
+                                                       this->relaxation,
+                                                       pos_right_of_diagonal,
+                                                       schedule);
 }
 
 
@@ -1531,7 +1778,10 @@ PreconditionSSOR<MatrixType>::Tvmult (VectorType &dst, const VectorType &src) co
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->precondition_SSOR (dst, src, this->relaxation, pos_right_of_diagonal);
+  internal::PreconditionRelaxation::precondition_SSOR (*this->A, dst, src,
+                                                       this->relaxation,
+                                                       pos_right_of_diagonal,
+                                                       schedule);
 }
 
 
@@ -1546,7 +1796,8 @@ PreconditionSSOR<MatrixType>::step (VectorType &dst, const VectorType &src) cons
     "PreconditionSSOR and VectorType must have the same size_type.");
 
   Assert (this->A!=nullptr, ExcNotInitialized());
-  this->A->SSOR_step (dst, src, this->relaxation);
+  internal::PreconditionRelaxation::SSOR_step (*this->A, dst, src,
+                                               this->relaxation, schedule);
 }
 
 
@@ -1662,9 +1913,11 @@ PreconditionUseMatrix<MatrixType,VectorType>::vmult (VectorType       &dst,
 template <typename MatrixType>
 inline
 PreconditionRelaxation<MatrixType>::AdditionalData::
-AdditionalData (const double relaxation)
+AdditionalData (const double                  relaxation,
+                const SweepSchedule::Ordering ordering)
   :
-  relaxation (relaxation)
+  relaxation (relaxation),
+  ordering (ordering)
 {}
 
 
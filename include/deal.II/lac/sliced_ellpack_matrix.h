@@ -0,0 +1,308 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sliced_ellpack_matrix_h
+#define dealii_sliced_ellpack_matrix_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/vectorization.h>
+#include <deal.II/lac/exceptions.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+template <typename number> class SparseMatrix;
+
+/*! @addtogroup Matrix1
+ *@{
+ */
+
+/**
+ * A sparse matrix stored in the sliced ELLPACK format with sorting scope
+ * $\sigma$, also known as SELL-C-$\sigma$, that is set up from an existing
+ * SparseMatrix. The class provides matrix-vector products that make use of
+ * SIMD instructions through the VectorizedArray class and is meant as a
+ * faster replacement of SparseMatrix in iterative solvers where the matrix
+ * does not change and the matrix-vector product dominates the run time.
+ *
+ * <h3>Storage format</h3>
+ *
+ * The rows of the matrix are grouped into chunks of $C$ consecutive rows,
+ * where $C$ is the number of lanes of VectorizedArray<number>, i.e., the
+ * width of the SIMD registers. Within a chunk, the entries are stored column
+ * by column, i.e., the first entry of all $C$ rows, followed by the second
+ * entry of all $C$ rows, and so on. Rows that are shorter than the longest
+ * row in their chunk are padded with zeros. A matrix-vector product then
+ * computes the result of $C$ rows at once, loading the matrix entries with
+ * contiguous vector loads and the source vector entries with
+ * VectorizedArray::gather().
+ *
+ * The padding is wasted work. In order to reduce it for matrices with varying
+ * row lengths, the rows may be sorted by their length within windows of
+ * $\sigma$ rows before forming the chunks (the argument @p sorting_scope of
+ * reinit()). The default $\sigma=1$ keeps the original order of rows, which
+ * is the best choice for matrices from finite element discretizations where
+ * most rows have a similar length and the original numbering leads to good
+ * data locality in the source vector.
+ *
+ * In contrast to SparseMatrix, the entries cannot be changed once the matrix
+ * has been set up; call reinit() again in case the original matrix changes.
+ * The column indices are stored as 32 bit integers, which is what
+ * VectorizedArray::gather() expects.
+ *
+ * The functions vmult() and vmult_add() are parallelized using the task
+ * framework in the same way as the respective functions of SparseMatrix,
+ * whereas Tvmult() and Tvmult_add() run serially.
+ *
+ * @ingroup Matrix1
+ */
+template <typename number>
+class SlicedEllpackMatrix : public virtual Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Type of matrix entries.
+   */
+  typedef number value_type;
+
+  /**
+   * The number of rows that are processed together, given by the SIMD width
+   * of VectorizedArray<number>.
+   */
+  static const unsigned int chunk_size = VectorizedArray<number>::n_array_elements;
+
+  /**
+   * Constructor. Initializes an empty matrix of dimension zero times zero.
+   */
+  SlicedEllpackMatrix ();
+
+  /**
+   * Constructor. Equivalent to the default constructor followed by
+   * reinit().
+   */
+  template <typename number2>
+  explicit SlicedEllpackMatrix (const SparseMatrix<number2> &matrix,
+                                const unsigned int           sorting_scope = 1);
+
+  /**
+   * Set up the sliced ELLPACK storage from the given sparse matrix, copying
+   * the sparsity pattern as well as the entries of @p matrix. All entries
+   * stored in the sparsity pattern of @p matrix are kept, including the ones
+   * that are zero. If @p sorting_scope is larger than one, the rows are
+   * sorted by decreasing length within windows of @p sorting_scope rows. The
+   * sorting does not affect the result of the matrix-vector products.
+   */
+  template <typename number2>
+  void reinit (const SparseMatrix<number2> &matrix,
+               const unsigned int           sorting_scope = 1);
+
+  /**
+   * Release all memory and return to a state just like after having called
+   * the default constructor.
+   */
+  void clear ();
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of nonzero elements of the matrix this object was set
+   * up from, i.e., the number of entries without the padding.
+   */
+  std::size_t n_nonzero_elements () const;
+
+  /**
+   * Return the number of stored elements including the zeros padded to make
+   * all rows of a chunk the same length. The ratio between this number and
+   * n_nonzero_elements() measures the overhead of the format.
+   */
+  std::size_t n_stored_elements () const;
+
+  /**
+   * Matrix-vector multiplication: let $dst = M*src$ with $M$ being this
+   * matrix. @p VectorType must store its elements contiguously with the
+   * same number type as the matrix, such as Vector<number>.
+   */
+  template <class VectorType>
+  void vmult (VectorType       &dst,
+              const VectorType &src) const;
+
+  /**
+   * Matrix-vector multiplication: let $dst = M^T*src$ with $M$ being this
+   * matrix.
+   */
+  template <class VectorType>
+  void Tvmult (VectorType       &dst,
+               const VectorType &src) const;
+
+  /**
+   * Adding Matrix-vector multiplication. Add $M*src$ on $dst$ with $M$ being
+   * this matrix.
+   */
+  template <class VectorType>
+  void vmult_add (VectorType       &dst,
+                  const VectorType &src) const;
+
+  /**
+   * Adding Matrix-vector multiplication. Add $M^T*src$ to $dst$ with $M$
+   * being this matrix.
+   */
+  template <class VectorType>
+  void Tvmult_add (VectorType       &dst,
+                   const VectorType &src) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /**
+   * @addtogroup Exceptions
+   * @{
+   */
+
+  /**
+   * Exception
+   */
+  DeclException0 (ExcSourceEqualsDestination);
+  //@}
+
+private:
+  /**
+   * Perform the matrix-vector product on the chunks in the range
+   * [begin_chunk, end_chunk), either overwriting or adding into @p dst.
+   */
+  void vmult_on_subrange (const unsigned int begin_chunk,
+                          const unsigned int end_chunk,
+                          const number      *src,
+                          number            *dst,
+                          const bool         add) const;
+
+  /**
+   * Perform the transposed matrix-vector product, adding into @p dst.
+   */
+  void Tvmult_add_internal (const number *src,
+                            number       *dst) const;
+
+  /**
+   * Number of rows of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * Number of columns of the matrix.
+   */
+  size_type n_cols;
+
+  /**
+   * Number of nonzero entries of the original matrix.
+   */
+  std::size_t n_nonzero;
+
+  /**
+   * The index into @p values and @p column_indices where the data of each
+   * chunk starts. The length of the rows in chunk @p c is given by
+   * <code>(chunk_starts[c+1]-chunk_starts[c])/chunk_size</code>.
+   */
+  std::vector<std::size_t> chunk_starts;
+
+  /**
+   * The row in the original matrix for each slot of a chunk, i.e.,
+   * <code>row_indices[c*chunk_size+v]</code> is the row computed by lane @p v
+   * of chunk @p c. Slots beyond the last row of the matrix are set to
+   * numbers::invalid_unsigned_int. This field is empty if the rows have not
+   * been reordered, in which case the rows are in their natural order.
+   */
+  std::vector<unsigned int> row_indices;
+
+  /**
+   * The matrix entries in chunk-wise column-major order.
+   */
+  AlignedVector<number> values;
+
+  /**
+   * The column indices of the entries in @p values.
+   */
+  AlignedVector<unsigned int> column_indices;
+};
+
+/*@}*/
+
+#ifndef DOXYGEN
+/*---------------------- Inline functions -----------------------------------*/
+
+
+
+template <typename number>
+inline
+typename SlicedEllpackMatrix<number>::size_type
+SlicedEllpackMatrix<number>::m () const
+{
+  return n_rows;
+}
+
+
+
+template <typename number>
+inline
+typename SlicedEllpackMatrix<number>::size_type
+SlicedEllpackMatrix<number>::n () const
+{
+  return n_cols;
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SlicedEllpackMatrix<number>::n_nonzero_elements () const
+{
+  return n_nonzero;
+}
+
+
+
+template <typename number>
+inline
+std::size_t
+SlicedEllpackMatrix<number>::n_stored_elements () const
+{
+  return values.size();
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,340 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sliced_ellpack_matrix_templates_h
+#define dealii_sliced_ellpack_matrix_templates_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename number>
+SlicedEllpackMatrix<number>::SlicedEllpackMatrix ()
+  :
+  n_rows (0),
+  n_cols (0),
+  n_nonzero (0)
+{}
+
+
+
+template <typename number>
+template <typename number2>
+SlicedEllpackMatrix<number>::SlicedEllpackMatrix (const SparseMatrix<number2> &matrix,
+                                                  const unsigned int           sorting_scope)
+  :
+  n_rows (0),
+  n_cols (0),
+  n_nonzero (0)
+{
+  reinit (matrix, sorting_scope);
+}
+
+
+
+template <typename number>
+template <typename number2>
+void
+SlicedEllpackMatrix<number>::reinit (const SparseMatrix<number2> &matrix,
+                                     const unsigned int           sorting_scope)
+{
+  Assert (sorting_scope > 0, ExcMessage("The sorting scope must be at least one."));
+  AssertThrow (matrix.m() < static_cast<size_type>(std::numeric_limits<unsigned int>::max()) &&
+               matrix.n() < static_cast<size_type>(std::numeric_limits<unsigned int>::max()),
+               ExcMessage("SlicedEllpackMatrix stores row and column indices as "
+                          "unsigned int and is limited to matrices of less than "
+                          "2^32-1 rows and columns."));
+
+  n_rows = matrix.m();
+  n_cols = matrix.n();
+  n_nonzero = 0;
+
+  const unsigned int n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+
+  // determine the row that each slot of a chunk is going to compute. without
+  // sorting, this is the identity and we do not need to store anything
+  std::vector<unsigned int> slot_to_row (n_chunks * chunk_size,
+                                         numbers::invalid_unsigned_int);
+  std::iota (slot_to_row.begin(), slot_to_row.begin()+n_rows, 0U);
+  if (sorting_scope > 1)
+    for (unsigned int start=0; start<n_rows; start+=sorting_scope)
+      {
+        const unsigned int end = std::min<size_type>(start+sorting_scope, n_rows);
+        std::stable_sort (slot_to_row.begin()+start, slot_to_row.begin()+end,
+                          [&matrix](const unsigned int a, const unsigned int b)
+        {
+          return matrix.get_row_length(a) > matrix.get_row_length(b);
+        });
+      }
+
+  // the width of a chunk is the length of its longest row
+  chunk_starts.resize (n_chunks+1);
+  chunk_starts[0] = 0;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    {
+      unsigned int width = 0;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        if (slot_to_row[c*chunk_size+v] != numbers::invalid_unsigned_int)
+          width = std::max<unsigned int>(width,
+                                         matrix.get_row_length(slot_to_row[c*chunk_size+v]));
+      chunk_starts[c+1] = chunk_starts[c] + std::size_t(width) * chunk_size;
+    }
+
+  // fill the entries. padded entries get a zero value and the column index
+  // of the last entry in the same row (or zero for empty rows), such that the
+  // gather operation does not touch additional cache lines
+  values.resize_fast (chunk_starts.back());
+  column_indices.resize_fast (chunk_starts.back());
+  for (unsigned int c=0; c<n_chunks; ++c)
+    {
+      const unsigned int width = (chunk_starts[c+1]-chunk_starts[c]) / chunk_size;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        {
+          const unsigned int row = slot_to_row[c*chunk_size+v];
+          unsigned int j = 0;
+          unsigned int last_column = 0;
+          if (row != numbers::invalid_unsigned_int)
+            for (typename SparseMatrix<number2>::const_iterator entry = matrix.begin(row);
+                 entry != matrix.end(row); ++entry, ++j)
+              {
+                last_column = entry->column();
+                values[chunk_starts[c]+j*chunk_size+v] = entry->value();
+                column_indices[chunk_starts[c]+j*chunk_size+v] = last_column;
+                ++n_nonzero;
+              }
+          for ( ; j<width; ++j)
+            {
+              values[chunk_starts[c]+j*chunk_size+v] = number();
+              column_indices[chunk_starts[c]+j*chunk_size+v] = last_column;
+            }
+        }
+    }
+
+  if (sorting_scope > 1)
+    row_indices.swap (slot_to_row);
+  else
+    row_indices.clear ();
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::clear ()
+{
+  n_rows = 0;
+  n_cols = 0;
+  n_nonzero = 0;
+  chunk_starts.clear();
+  row_indices.clear();
+  values.clear();
+  column_indices.clear();
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::vmult_on_subrange (const unsigned int begin_chunk,
+                                                const unsigned int end_chunk,
+                                                const number      *src,
+                                                number            *dst,
+                                                const bool         add) const
+{
+  for (unsigned int c=begin_chunk; c<end_chunk; ++c)
+    {
+      const number       *val_ptr = values.begin() + chunk_starts[c];
+      const unsigned int *col_ptr = column_indices.begin() + chunk_starts[c];
+      const unsigned int  width = (chunk_starts[c+1]-chunk_starts[c]) / chunk_size;
+
+      VectorizedArray<number> sum, matrix_entries, src_entries;
+      sum = number();
+      for (unsigned int j=0; j<width; ++j, val_ptr+=chunk_size, col_ptr+=chunk_size)
+        {
+          matrix_entries.load (val_ptr);
+          src_entries.gather (src, col_ptr);
+          sum += matrix_entries * src_entries;
+        }
+
+      // in the common case of rows in natural order and a completely filled
+      // chunk, we can write the result with a contiguous vector store
+      if (row_indices.empty() && (c+1)*chunk_size <= n_rows)
+        {
+          if (add)
+            {
+              VectorizedArray<number> dst_entries;
+              dst_entries.load (dst + c*chunk_size);
+              sum += dst_entries;
+            }
+          sum.store (dst + c*chunk_size);
+        }
+      else
+        for (unsigned int v=0; v<chunk_size; ++v)
+          {
+            const unsigned int row = row_indices.empty() ?
+                                     c*chunk_size+v : row_indices[c*chunk_size+v];
+            if (row >= n_rows)
+              continue;
+            if (add)
+              dst[row] += sum[v];
+            else
+              dst[row] = sum[v];
+          }
+    }
+}
+
+
+
+template <typename number>
+void
+SlicedEllpackMatrix<number>::Tvmult_add_internal (const number *src,
+                                                  number       *dst) const
+{
+  const unsigned int n_chunks = chunk_starts.size() > 0 ? chunk_starts.size()-1 : 0;
+  for (unsigned int c=0; c<n_chunks; ++c)
+    {
+      const unsigned int width = (chunk_starts[c+1]-chunk_starts[c]) / chunk_size;
+      for (unsigned int v=0; v<chunk_size; ++v)
+        {
+          const unsigned int row = row_indices.empty() ?
+                                   c*chunk_size+v : row_indices[c*chunk_size+v];
+          if (row >= n_rows)
+            continue;
+          const number src_value = src[row];
+          for (unsigned int j=0; j<width; ++j)
+            {
+              const std::size_t index = chunk_starts[c]+j*chunk_size+v;
+              dst[column_indices[index]] += values[index] * src_value;
+            }
+        }
+    }
+}
+
+
+
+template <typename number>
+template <class VectorType>
+void
+SlicedEllpackMatrix<number>::vmult (VectorType       &dst,
+                                    const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, number>::value,
+                 "SlicedEllpackMatrix needs vectors with the same number type");
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const unsigned int n_chunks = chunk_starts.size() > 0 ? chunk_starts.size()-1 : 0;
+  parallel::apply_to_subranges (0U, n_chunks,
+                                std::bind (&SlicedEllpackMatrix<number>::vmult_on_subrange,
+                                           this,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           src.begin(),
+                                           dst.begin(),
+                                           false),
+                                std::max(1U, internal::SparseMatrix::minimum_parallel_grain_size/chunk_size));
+}
+
+
+
+template <typename number>
+template <class VectorType>
+void
+SlicedEllpackMatrix<number>::vmult_add (VectorType       &dst,
+                                        const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, number>::value,
+                 "SlicedEllpackMatrix needs vectors with the same number type");
+  Assert(m() == dst.size(), ExcDimensionMismatch(m(),dst.size()));
+  Assert(n() == src.size(), ExcDimensionMismatch(n(),src.size()));
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  const unsigned int n_chunks = chunk_starts.size() > 0 ? chunk_starts.size()-1 : 0;
+  parallel::apply_to_subranges (0U, n_chunks,
+                                std::bind (&SlicedEllpackMatrix<number>::vmult_on_subrange,
+                                           this,
+                                           std::placeholders::_1, std::placeholders::_2,
+                                           src.begin(),
+                                           dst.begin(),
+                                           true),
+                                std::max(1U, internal::SparseMatrix::minimum_parallel_grain_size/chunk_size));
+}
+
+
+
+template <typename number>
+template <class VectorType>
+void
+SlicedEllpackMatrix<number>::Tvmult (VectorType       &dst,
+                                     const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, number>::value,
+                 "SlicedEllpackMatrix needs vectors with the same number type");
+  Assert(n() == dst.size(), ExcDimensionMismatch(n(),dst.size()));
+  Assert(m() == src.size(), ExcDimensionMismatch(m(),src.size()));
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  dst = 0;
+  Tvmult_add_internal (src.begin(), dst.begin());
+}
+
+
+
+template <typename number>
+template <class VectorType>
+void
+SlicedEllpackMatrix<number>::Tvmult_add (VectorType       &dst,
+                                         const VectorType &src) const
+{
+  static_assert (std::is_same<typename VectorType::value_type, number>::value,
+                 "SlicedEllpackMatrix needs vectors with the same number type");
+  Assert(n() == dst.size(), ExcDimensionMismatch(n(),dst.size()));
+  Assert(m() == src.size(), ExcDimensionMismatch(m(),src.size()));
+  Assert (&src != &dst, ExcSourceEqualsDestination());
+
+  Tvmult_add_internal (src.begin(), dst.begin());
+}
+
+
+
+template <typename number>
+std::size_t
+SlicedEllpackMatrix<number>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (chunk_starts) +
+          MemoryConsumption::memory_consumption (row_indices) +
+          values.memory_consumption() +
+          column_indices.memory_consumption());
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -17,10 +17,15 @@
 #define dealii_solver_h
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/subscriptor.h>
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/lac/solver_control.h>
 
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 // Ignore deprecation warnings for auto_ptr.
 DEAL_II_DISABLE_EXTRA_DIAGNOSTICS
 #include <boost/signals2.hpp>
@@ -30,6 +35,14 @@ DEAL_II_NAMESPACE_OPEN
 
 template <typename number> class Vector;
 
+namespace LinearAlgebra
+{
+  namespace distributed
+  {
+    template <typename> class Vector;
+  }
+}
+
 /**
  * A base class for iterative linear solvers. This class provides interfaces
  * to a memory pool and the objects that determine whether a solver has
@@ -451,6 +464,146 @@ protected:
 };
 
 
+namespace internal
+{
+  /**
+   * A namespace for helper functions that allow iterative solvers to combine
+   * several inner products into a single global reduction for the vector
+   * types that support this.
+   */
+  namespace SolverReductions
+  {
+    /**
+     * A flag indicating whether the vector type computes multi_dot_start()
+     * in a single sweep and with a single, non-blocking, global reduction.
+     * For other vector types, the function below falls back to computing one
+     * inner product after the other.
+     */
+    template <typename VectorType>
+    struct supports_multi_dot : std::false_type
+    {};
+
+    template <typename Number>
+    struct supports_multi_dot<LinearAlgebra::distributed::Vector<Number> > : std::true_type
+    {};
+
+    /**
+     * Return whether the vector is distributed over more than one processor,
+     * i.e., whether its inner products involve a global communication. This
+     * is the general implementation for vector types that do not support
+     * multi_dot_start(), where the question does not arise.
+     */
+    template <typename VectorType>
+    bool
+    is_distributed (const VectorType &)
+    {
+      return false;
+    }
+
+    /**
+     * Same as above for LinearAlgebra::distributed::Vector.
+     */
+    template <typename Number>
+    bool
+    is_distributed (const LinearAlgebra::distributed::Vector<Number> &v)
+    {
+      return Utilities::MPI::n_mpi_processes (v.get_mpi_communicator()) > 1;
+    }
+
+    /**
+     * Start computing the inner products of @p v with each of the vectors in
+     * @p w and return an object through which the results can be obtained.
+     * This is the general implementation, which computes the inner products
+     * immediately.
+     */
+    template <typename VectorType>
+    Utilities::MPI::Future<std::vector<double> >
+    multi_dot_start (const VectorType                      &v,
+                     const std::vector<const VectorType *> &w)
+    {
+      std::vector<double> results (w.size());
+      for (unsigned int i=0; i<w.size(); ++i)
+        results[i] = v * (*w[i]);
+      return Utilities::MPI::Future<std::vector<double> > ([]() {},
+                                                           [results]()
+      {
+        return results;
+      });
+    }
+
+    /**
+     * Same as above for LinearAlgebra::distributed::Vector, which computes
+     * all inner products in one sweep and starts a non-blocking global
+     * reduction.
+     */
+    template <typename Number>
+    Utilities::MPI::Future<std::vector<double> >
+    multi_dot_start (const LinearAlgebra::distributed::Vector<Number>                      &v,
+                     const std::vector<const LinearAlgebra::distributed::Vector<Number> *> &w)
+    {
+      const std::shared_ptr<Utilities::MPI::Future<std::vector<Number> > > products
+        = std::make_shared<Utilities::MPI::Future<std::vector<Number> > > (v.multi_dot_start (w));
+      return Utilities::MPI::Future<std::vector<double> > ([products]()
+      {
+        products->wait();
+      },
+      [products]()
+      {
+        const std::vector<Number> results = products->get();
+        return std::vector<double> (results.begin(), results.end());
+      });
+    }
+
+
+    /**
+     * Start computing the inner products of each of the vectors in @p v with
+     * each of the vectors in @p w and return an object through which the
+     * results can be obtained, stored as <code>result[i*w.size()+j] =
+     * (*v[i]) * (*w[j])</code>. This is the general implementation, which
+     * computes the inner products immediately.
+     */
+    template <typename VectorType>
+    Utilities::MPI::Future<std::vector<double> >
+    block_dot_start (const std::vector<const VectorType *> &v,
+                     const std::vector<const VectorType *> &w)
+    {
+      std::vector<double> results (v.size()*w.size());
+      for (unsigned int i=0; i<v.size(); ++i)
+        for (unsigned int j=0; j<w.size(); ++j)
+          results[i*w.size()+j] = (*v[i]) * (*w[j]);
+      return Utilities::MPI::Future<std::vector<double> > ([]() {},
+                                                           [results]()
+      {
+        return results;
+      });
+    }
+
+    /**
+     * Same as above for LinearAlgebra::distributed::Vector, which computes
+     * all inner products with a single, non-blocking global reduction.
+     */
+    template <typename Number>
+    Utilities::MPI::Future<std::vector<double> >
+    block_dot_start (const std::vector<const LinearAlgebra::distributed::Vector<Number> *> &v,
+                     const std::vector<const LinearAlgebra::distributed::Vector<Number> *> &w)
+    {
+      const std::shared_ptr<Utilities::MPI::Future<std::vector<Number> > > products
+        = std::make_shared<Utilities::MPI::Future<std::vector<Number> > >
+          (LinearAlgebra::distributed::Vector<Number>::block_dot_start (v, w));
+      return Utilities::MPI::Future<std::vector<double> > ([products]()
+      {
+        products->wait();
+      },
+      [products]()
+      {
+        const std::vector<Number> results = products->get();
+        return std::vector<double> (results.begin(), results.end());
+      });
+    }
+  }
+}
+
+
 /*-------------------------------- Inline functions ------------------------*/
 
 
@@ -84,6 +84,24 @@ class PreconditionIdentity;
  * Solver base class to determine convergence. This mechanism can also be used
  * to observe the progress of the iteration.
  *
+ * <h3>Global reductions</h3>
+ *
+ * Each iteration of the preconditioned method needs three inner products,
+ * each of which involves a global communication in parallel computations.
+ * For LinearAlgebra::distributed::Vector, the solver can instead apply the
+ * preconditioner to the updated residual before checking for convergence and
+ * compute the norm of the residual and its inner product with the
+ * preconditioned residual together through
+ * LinearAlgebra::distributed::Vector::multi_dot_start(). This saves one
+ * global communication per iteration, and the remaining one overlaps with
+ * the update of the solution vector. The computed iterates are the same, but
+ * the preconditioner is applied once more in the last iteration, which is
+ * why this variant must be requested through
+ * AdditionalData::fused_reductions. It only pays off if a global
+ * communication is more expensive than an application of the
+ * preconditioner, and it is not used if the vectors live on a single
+ * processor.
+ *
  *
  * @author W. Bangerth, G. Kanschat, R. Becker and F.-T. Suttmeier
  */
@@ -98,10 +116,24 @@ public:
 
   /**
    * Standardized data struct to pipe additional data to the solver.
-   * Here, it doesn't store anything but just exists for consistency
-   * with the other solver classes.
    */
-  struct AdditionalData {};
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, compute the inner products separately as in
+     * the textbook version of the method.
+     */
+    explicit
+    AdditionalData (const bool fused_reductions = false);
+
+    /**
+     * Flag to apply the preconditioner before the convergence check and to
+     * compute the two inner products of each iteration with a single global
+     * reduction for vector types that support it. See the section on global
+     * reductions in the general documentation of this class.
+     */
+    bool fused_reductions;
+  };
 
   /**
    * Constructor.
@@ -238,6 +270,15 @@ private:
 
 #ifndef DOXYGEN
 
+template <typename VectorType>
+inline
+SolverCG<VectorType>::AdditionalData::AdditionalData (const bool fused_reductions)
+  :
+  fused_reductions (fused_reductions)
+{}
+
+
+
 template <typename VectorType>
 SolverCG<VectorType>::SolverCG (SolverControl        &cn,
                                 VectorMemory<VectorType> &mem,
@@ -382,6 +423,21 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
       h.reinit(x, true);
 
       double gh,beta;
+      double gh_new = 0;
+
+      // if requested and the vector type supports it, update the residual
+      // and apply the preconditioner before checking for convergence, such
+      // that the norm of the residual and the inner product with the
+      // preconditioned residual can be computed with a single global
+      // reduction that overlaps with the update of the solution. without
+      // preconditioner, add_and_dot already needs only one reduction, and on
+      // a single processor there is no communication to save
+      const bool use_preconditioner
+        = (std::is_same<PreconditionerType,PreconditionIdentity>::value == false);
+      const bool use_multi_dot
+        = (additional_data.fused_reductions && use_preconditioner &&
+           internal::SolverReductions::supports_multi_dot<VectorType>::value &&
+           internal::SolverReductions::is_distributed (x));
 
       // compute residual. if vector is
       // zero, then short-circuit the
@@ -402,7 +458,7 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
           return;
         }
 
-      if (std::is_same<PreconditionerType,PreconditionIdentity>::value == false)
+      if (use_preconditioner)
         {
           precondition.vmult(h,g);
 
@@ -425,8 +481,24 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
           Assert(alpha != 0., ExcDivideByZero());
           alpha = gh/alpha;
 
-          x.add(alpha,d);
-          res = std::sqrt(g.add_and_dot(alpha, h, g));
+          if (use_multi_dot)
+            {
+              g.add(alpha,h);
+              precondition.vmult(h,g);
+              const std::vector<const VectorType *> vectors = {&g, &h};
+              Utilities::MPI::Future<std::vector<double> > products
+                = internal::SolverReductions::multi_dot_start (g, vectors);
+              x.add(alpha,d);
+
+              const std::vector<double> results = products.get();
+              res = std::sqrt(results[0]);
+              gh_new = results[1];
+            }
+          else
+            {
+              x.add(alpha,d);
+              res = std::sqrt(g.add_and_dot(alpha, h, g));
+            }
 
           print_vectors(it, x, g, d);
 
@@ -434,14 +506,17 @@ SolverCG<VectorType>::solve (const MatrixType         &A,
           if (conv != SolverControl::iterate)
             break;
 
-          if (std::is_same<PreconditionerType,PreconditionIdentity>::value
-              == false)
+          if (use_preconditioner)
             {
-              precondition.vmult(h,g);
+              if (use_multi_dot == false)
+                {
+                  precondition.vmult(h,g);
+                  gh_new = g*h;
+                }
 
               beta = gh;
               Assert(beta != 0., ExcDivideByZero());
-              gh   = g*h;
+              gh   = gh_new;
               beta = gh/beta;
               d.sadd(beta,-1.,h);
             }
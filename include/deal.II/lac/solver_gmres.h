@@ -156,6 +156,24 @@ namespace internal
  * class, see the documentation of the Solver base class.
  *
  *
+ * <h3>Orthogonalization</h3>
+ *
+ * By default, each new vector is orthogonalized against the Arnoldi basis
+ * with the modified Gram-Schmidt algorithm, which computes one inner product
+ * after the other. In parallel computations, each of them involves a global
+ * communication, i.e., the number of communications per iteration grows with
+ * the size of the basis. If AdditionalData::classical_gram_schmidt is set,
+ * the solver instead uses the classical Gram-Schmidt algorithm applied twice,
+ * which is as stable as the modified algorithm in practice. All inner
+ * products of one pass are computed together, which for
+ * LinearAlgebra::distributed::Vector means a single sweep over the vectors
+ * and a single global communication (see
+ * LinearAlgebra::distributed::Vector::multi_dot()), so that each iteration
+ * only needs two global communications independent of the size of the
+ * basis. The norm of the new vector is obtained from the second pass without
+ * additional communication.
+ *
+ *
  * <h3>Observing the progress of linear solver iterations</h3>
  *
  * The solve() function of this class uses the mechanism described in the
@@ -190,13 +208,15 @@ public:
      * Constructor. By default, set the number of temporary vectors to 30,
      * i.e. do a restart every 28 iterations. Also set preconditioning from
      * left, the residual of the stopping criterion to the default residual,
-     * and re-orthogonalization only if necessary.
+     * and re-orthogonalization only if necessary, using the modified
+     * Gram-Schmidt algorithm.
      */
     explicit
     AdditionalData (const unsigned int max_n_tmp_vectors = 30,
                     const bool right_preconditioning = false,
                     const bool use_default_residual = true,
-                    const bool force_re_orthogonalization = false);
+                    const bool force_re_orthogonalization = false,
+                    const bool classical_gram_schmidt = false);
 
     /**
      * Maximum number of temporary vectors. This parameter controls the size
@@ -226,6 +246,15 @@ public:
      * if necessary.
      */
     bool force_re_orthogonalization;
+
+    /**
+     * Flag to orthogonalize with the classical Gram-Schmidt algorithm
+     * applied twice instead of the modified Gram-Schmidt algorithm, which
+     * reduces the number of global communications per iteration to two. See
+     * the section on orthogonalization in the general documentation of this
+     * class. If set, the flag #force_re_orthogonalization has no effect.
+     */
+    bool classical_gram_schmidt;
   };
 
   /**
@@ -381,6 +410,20 @@ protected:
                          Vector<double>                                      &h,
                          bool                                                &re_orthogonalize);
 
+  /**
+   * Orthogonalize the vector @p vv against the @p dim (orthogonal) vectors
+   * given by the first argument using the classical Gram-Schmidt algorithm
+   * applied twice, and return the norm of the resulting vector. The factors
+   * used for orthogonalization are stored in @p h. All inner products of one
+   * pass are computed together, see
+   * internal::SolverReductions::multi_dot_start().
+   */
+  static double
+  classical_gram_schmidt (const internal::SolverGMRES::TmpVectors<VectorType> &orthogonal_vectors,
+                          const unsigned int                                  dim,
+                          VectorType                                          &vv,
+                          Vector<double>                                      &h);
+
   /**
    * Estimates the eigenvalues from the Hessenberg matrix, H_orig, generated
    * during the inner iterations. Uses these estimate to compute the condition
@@ -501,6 +544,131 @@ private:
   FullMatrix<double> H1;
 };
 
+/**
+ * Implementation of the s-step variant of the restarted GMRES method with
+ * right preconditioning, also known as communication-avoiding GMRES, see
+ * M. Hoemmen: "Communication-avoiding Krylov subspace methods", PhD thesis,
+ * UC Berkeley, 2010.
+ *
+ * In exact arithmetic, this method computes the same iterates as SolverGMRES
+ * with right preconditioning. Rather than orthogonalizing each new vector of
+ * the Krylov space as soon as it has been computed, it computes blocks of
+ * AdditionalData::s_step vectors by repeated application of the preconditioner
+ * and the matrix, starting from the last vector of the orthonormal basis, and
+ * orthogonalizes the whole block at once. The orthogonalization is a block
+ * classical Gram-Schmidt algorithm applied twice, where the vectors within
+ * the block are orthonormalized by a Cholesky factorization of their Gram
+ * matrix. The Hessenberg matrix of the Arnoldi process is then recovered from
+ * the coefficients of the orthogonalization.
+ *
+ * In parallel computations, this changes the communication pattern
+ * considerably. All inner products of one pass of the block orthogonalization
+ * are computed with a single global reduction (see
+ * internal::SolverReductions::block_dot_start()), i.e., the solver needs two
+ * reductions per block of AdditionalData::s_step iterations rather than at
+ * least two per iteration. Furthermore, the inner products of each vector of
+ * the block with the basis are sent off as soon as the vector is available,
+ * and the reduction runs while the preconditioner and the matrix are applied
+ * to compute the next vector. For LinearAlgebra::distributed::Vector, these
+ * reductions are non-blocking, so that only the latency of the last one of
+ * them and of the second pass is exposed.
+ *
+ * The vectors within a block form a scaled monomial basis, whose condition
+ * number grows quickly with the block size. The block is truncated when
+ * the Cholesky factorization detects that its vectors have become linearly
+ * dependent to working precision, which costs a few matrix-vector products
+ * but keeps the method stable. Block sizes up to about five work well for
+ * most problems.
+ *
+ * The solver needs <tt>AdditionalData::max_basis_size+2</tt> auxiliary
+ * vectors.
+ */
+template <class VectorType = Vector<double> >
+class SolverSStepGMRES : public Solver<VectorType>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. By default, set the maximum basis size to 30 and compute
+     * blocks of four vectors.
+     */
+    explicit
+    AdditionalData(const unsigned int max_basis_size = 30,
+                   const unsigned int s_step = 4)
+      :
+      max_basis_size(max_basis_size),
+      s_step(s_step)
+    {}
+
+    /**
+     * Maximum size of the Krylov space before a restart.
+     */
+    unsigned int    max_basis_size;
+
+    /**
+     * Number of vectors computed and orthogonalized as one block.
+     */
+    unsigned int    s_step;
+  };
+
+  /**
+   * Constructor.
+   */
+  SolverSStepGMRES (SolverControl            &cn,
+                    VectorMemory<VectorType> &mem,
+                    const AdditionalData     &data=AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverSStepGMRES (SolverControl        &cn,
+                    const AdditionalData &data=AdditionalData());
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &precondition);
+
+private:
+  /**
+   * Apply the Givens rotations computed so far to the column @p col of the
+   * Hessenberg matrix stored in @p h, compute the one that eliminates its
+   * subdiagonal entry, and apply it to the right hand side @p b of the
+   * least-squares problem.
+   */
+  static void givens_rotation (Vector<double> &h,
+                               Vector<double> &b,
+                               Vector<double> &ci,
+                               Vector<double> &si,
+                               const unsigned int col);
+
+  /**
+   * Additional flags.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * Hessenberg matrix of the Arnoldi process, without rotations.
+   */
+  FullMatrix<double> H;
+
+  /**
+   * Upper triangular matrix of the least-squares problem, i.e., the
+   * Hessenberg matrix after the Givens rotations.
+   */
+  FullMatrix<double> H1;
+};
+
 /*@}*/
 /* --------------------- Inline and template functions ------------------- */
 
@@ -587,12 +755,14 @@ SolverGMRES<VectorType>::AdditionalData::
 AdditionalData (const unsigned int max_n_tmp_vectors,
                 const bool         right_preconditioning,
                 const bool         use_default_residual,
-                const bool         force_re_orthogonalization)
+                const bool         force_re_orthogonalization,
+                const bool         classical_gram_schmidt)
   :
   max_n_tmp_vectors(max_n_tmp_vectors),
   right_preconditioning(right_preconditioning),
   use_default_residual(use_default_residual),
-  force_re_orthogonalization(force_re_orthogonalization)
+  force_re_orthogonalization(force_re_orthogonalization),
+  classical_gram_schmidt(classical_gram_schmidt)
 {}
 
 
@@ -708,6 +878,55 @@ SolverGMRES<VectorType>::modified_gram_schmidt
 
 
 
+template <class VectorType>
+inline
+double
+SolverGMRES<VectorType>::classical_gram_schmidt
+(const internal::SolverGMRES::TmpVectors<VectorType> &orthogonal_vectors,
+ const unsigned int                                  dim,
+ VectorType                                          &vv,
+ Vector<double>                                      &h)
+{
+  Assert(dim > 0, ExcInternalError());
+
+  std::vector<const VectorType *> vectors (dim);
+  for (unsigned int i=0; i<dim; ++i)
+    vectors[i] = &orthogonal_vectors[i];
+
+  // first pass
+  std::vector<double> products
+    = internal::SolverReductions::multi_dot_start (vv, vectors).get();
+  for (unsigned int i=0; i<dim; ++i)
+    {
+      h(i) = products[i];
+      vv.add(-products[i], orthogonal_vectors[i]);
+    }
+
+  // second pass. since the basis is orthonormal, the squared norm of vv
+  // after the correction is its squared norm before minus the sum of the
+  // squares of the correction factors, so we get it along with the inner
+  // products of this pass
+  vectors.push_back(&vv);
+  products = internal::SolverReductions::multi_dot_start (vv, vectors).get();
+  double norm_vv_sqr = products[dim];
+  for (unsigned int i=0; i<dim; ++i)
+    {
+      h(i) += products[i];
+      vv.add(-products[i], orthogonal_vectors[i]);
+      norm_vv_sqr -= products[i] * products[i];
+    }
+
+  // the correction factors of the second pass are usually tiny compared to
+  // the norm of vv. if not, the difference above is subject to cancellation
+  // and we compute the norm explicitly
+  if (norm_vv_sqr < 0.5 * products[dim])
+    return vv.l2_norm();
+  else
+    return std::sqrt(norm_vv_sqr);
+}
+
+
+
 template <class VectorType>
 inline void
 SolverGMRES<VectorType>::compute_eigs_and_cond
@@ -924,9 +1143,11 @@ SolverGMRES<VectorType>::solve (const MatrixType         &A,
 
           dim = inner_iteration+1;
 
-          const double s = modified_gram_schmidt(tmp_vectors, dim,
-                                                 accumulated_iterations,
-                                                 vv, h, re_orthogonalize);
+          const double s = (additional_data.classical_gram_schmidt ?
+                            classical_gram_schmidt(tmp_vectors, dim, vv, h) :
+                            modified_gram_schmidt(tmp_vectors, dim,
+                                                  accumulated_iterations,
+                                                  vv, h, re_orthogonalize));
           h(inner_iteration+1) = s;
 
           //s=0 is a lucky breakdown, the solver will reach convergence,
@@ -1256,6 +1477,319 @@ SolverFGMRES<VectorType>::solve (const MatrixType         &A,
                                                      res));
 }
 
+//----------------------------------------------------------------------//
+
+template <class VectorType>
+SolverSStepGMRES<VectorType>::SolverSStepGMRES (SolverControl            &cn,
+                                                VectorMemory<VectorType> &mem,
+                                                const AdditionalData     &data)
+  :
+  Solver<VectorType> (cn, mem),
+  additional_data(data)
+{}
+
+
+
+template <class VectorType>
+SolverSStepGMRES<VectorType>::SolverSStepGMRES (SolverControl        &cn,
+                                                const AdditionalData &data)
+  :
+  Solver<VectorType> (cn),
+  additional_data(data)
+{}
+
+
+
+template <class VectorType>
+inline
+void
+SolverSStepGMRES<VectorType>::givens_rotation (Vector<double>     &h,
+                                               Vector<double>     &b,
+                                               Vector<double>     &ci,
+                                               Vector<double>     &si,
+                                               const unsigned int  col)
+{
+  for (unsigned int i=0 ; i<col ; i++)
+    {
+      const double s = si(i);
+      const double c = ci(i);
+      const double dummy = h(i);
+      h(i)   =  c*dummy + s*h(i+1);
+      h(i+1) = -s*dummy + c*h(i+1);
+    }
+
+  const double r = 1./std::sqrt(h(col)*h(col) + h(col+1)*h(col+1));
+  si(col) = h(col+1) *r;
+  ci(col) = h(col)   *r;
+  h(col)  =  ci(col)*h(col) + si(col)*h(col+1);
+  b(col+1)= -si(col)*b(col);
+  b(col) *=  ci(col);
+}
+
+
+
+template <class VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverSStepGMRES<VectorType>::solve (const MatrixType         &A,
+                                     VectorType               &x,
+                                     const VectorType         &b,
+                                     const PreconditionerType &precondition)
+{
+  deallog.push("SStepGMRES");
+
+  SolverControl::State iteration_state = SolverControl::iterate;
+
+  const unsigned int basis_size = additional_data.max_basis_size;
+  Assert (basis_size > 0, ExcMessage ("The basis size must be positive."));
+  Assert (additional_data.s_step > 0,
+          ExcMessage ("The number of vectors per block must be positive."));
+
+  // the orthonormal basis of the Krylov space, and the vector that holds the
+  // preconditioned vectors
+  typename internal::SolverGMRES::TmpVectors<VectorType> v (basis_size+1, this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer (this->memory);
+  VectorType &p = *p_pointer;
+  p.reinit (x);
+
+  // number of the present iteration; this number is not reset to zero upon a
+  // restart
+  unsigned int accumulated_iterations = 0;
+
+  H.reinit (basis_size+1, basis_size);
+  H1.reinit (basis_size+1, basis_size);
+  Vector<double> gamma (basis_size+1), ci (basis_size), si (basis_size),
+         h (basis_size+1);
+
+  // the scaling of the monomial basis, an estimate of the norm of the
+  // preconditioned matrix. it is unknown before the first matrix-vector
+  // product
+  double nu = 0;
+
+  double res = -std::numeric_limits<double>::max();
+  do
+    {
+      VectorType &r = v(0, x);
+      A.vmult (r, x);
+      r.sadd (-1., 1., b);
+      const double beta = r.l2_norm();
+      res = beta;
+      iteration_state = this->iteration_status (accumulated_iterations, res, x);
+      if (iteration_state != SolverControl::iterate)
+        break;
+
+      r /= beta;
+      H = 0.;
+      H1 = 0.;
+      gamma = 0.;
+      gamma(0) = beta;
+
+      // number of columns of the Hessenberg matrix computed in this cycle,
+      // which is also the index of the last vector of the orthonormal basis
+      unsigned int dim = 0;
+      bool breakdown = false;
+      while (dim < basis_size && !breakdown &&
+             iteration_state == SolverControl::iterate)
+        {
+          const unsigned int J = dim;
+          const unsigned int k = std::min (additional_data.s_step, basis_size-J);
+
+          std::vector<const VectorType *> basis (J+1);
+          for (unsigned int i=0; i<=J; ++i)
+            basis[i] = &v[i];
+
+          // compute the block of vectors w_i = (A P^{-1})^i v_J / nu^i, i=1..k,
+          // in the slots J+1..J+k of the basis. as soon as one of them is
+          // available, start the reduction for its inner products with the
+          // basis and with the previous vectors of the block, which then runs
+          // while we compute the next one
+          std::vector<const VectorType *> block;
+          std::vector<Utilities::MPI::Future<std::vector<double> > > first_products;
+          first_products.reserve (k);
+          for (unsigned int i=0; i<k; ++i)
+            {
+              precondition.vmult (p, v[J+i]);
+              VectorType &w = v(J+1+i, x);
+              A.vmult (w, p);
+              if (nu == 0.)
+                {
+                  nu = w.l2_norm();
+                  if (nu == 0.)
+                    nu = 1.;
+                }
+              w /= nu;
+
+              block.push_back (&w);
+              std::vector<const VectorType *> targets (basis);
+              targets.insert (targets.end(), block.begin(), block.end());
+              first_products.push_back
+              (internal::SolverReductions::block_dot_start
+               (std::vector<const VectorType *> (1, &w), targets));
+            }
+
+          // first pass of the block Gram-Schmidt algorithm. C holds the
+          // coefficients of the block with respect to the old basis, and G
+          // the Gram matrix of the block before orthogonalization
+          FullMatrix<double> C (J+1, k), G (k, k);
+          for (unsigned int i=0; i<k; ++i)
+            {
+              const std::vector<double> products = first_products[i].get();
+              for (unsigned int row=0; row<=J; ++row)
+                C(row,i) = products[row];
+              for (unsigned int l=0; l<=i; ++l)
+                G(l,i) = G(i,l) = products[J+1+l];
+            }
+          for (unsigned int i=0; i<k; ++i)
+            for (unsigned int row=0; row<=J; ++row)
+              v[J+1+i].add (-C(row,i), v[row]);
+
+          // second pass, which also gives the Gram matrix of the block after
+          // the orthogonalization against the old basis
+          std::vector<const VectorType *> targets (basis);
+          targets.insert (targets.end(), block.begin(), block.end());
+          const std::vector<double> products
+            = internal::SolverReductions::block_dot_start (block, targets).get();
+          FullMatrix<double> gram (k, k);
+          for (unsigned int i=0; i<k; ++i)
+            {
+              for (unsigned int row=0; row<=J; ++row)
+                {
+                  const double c = products[i*targets.size()+row];
+                  v[J+1+i].add (-c, v[row]);
+                  C(row,i) += c;
+                  for (unsigned int l=0; l<k; ++l)
+                    gram(i,l) -= c * products[l*targets.size()+row];
+                }
+              for (unsigned int l=0; l<k; ++l)
+                gram(i,l) += products[i*targets.size()+J+1+l];
+            }
+
+          // Cholesky factorization of the Gram matrix. if the block has
+          // become linearly dependent to working precision, only keep the
+          // vectors before the first dependent one. if this is already the
+          // first one, the Krylov space is invariant and we have found the
+          // solution in the current space
+          FullMatrix<double> R (k, k);
+          unsigned int n_new = k;
+          for (unsigned int i=0; i<k; ++i)
+            {
+              double pivot = gram(i,i);
+              for (unsigned int l=0; l<i; ++l)
+                pivot -= R(l,i) * R(l,i);
+              if (!(pivot > 1e-10 * gram(i,i)) || !(pivot > 1e-28 * G(i,i)))
+                {
+                  n_new = i;
+                  break;
+                }
+              R(i,i) = std::sqrt (pivot);
+              for (unsigned int j=i+1; j<k; ++j)
+                {
+                  double entry = gram(i,j);
+                  for (unsigned int l=0; l<i; ++l)
+                    entry -= R(l,i) * R(l,j);
+                  R(i,j) = entry / R(i,i);
+                }
+            }
+          if (n_new == 0)
+            {
+              breakdown = true;
+              n_new = 1;
+            }
+
+          for (unsigned int i=0; i<n_new && R(i,i) != 0.; ++i)
+            {
+              for (unsigned int l=0; l<i; ++l)
+                v[J+1+i].add (-R(l,i), v[J+1+l]);
+              v[J+1+i] /= R(i,i);
+            }
+
+          // recover the columns J..J+n_new-1 of the Hessenberg matrix. the
+          // block vectors w_0=v_J, ..., w_{n_new-1} are V S in terms of the
+          // new basis V, where S has the entries of C and R of the previous
+          // vector in its columns, and A P^{-1} maps them to nu w_1, ...,
+          // nu w_{n_new}. this gives H S = nu [C; R], which we solve for
+          // the new columns of H one after the other
+          for (unsigned int i=0; i<n_new; ++i)
+            {
+              const unsigned int col = J+i;
+              h = 0.;
+              for (unsigned int row=0; row<=J; ++row)
+                h(row) = nu * C(row,i);
+              for (unsigned int l=0; l<=i; ++l)
+                h(J+1+l) = nu * R(l,i);
+              if (i > 0)
+                {
+                  for (unsigned int c=0; c<J; ++c)
+                    for (unsigned int row=0; row<=c+1; ++row)
+                      h(row) -= H(row,c) * C(c,i-1);
+                  for (unsigned int l=0; l<i; ++l)
+                    {
+                      const double s_li = (l == 0 ? C(J,i-1) : R(l-1,i-1));
+                      for (unsigned int row=0; row<=J+l+1; ++row)
+                        h(row) -= H(row,J+l) * s_li;
+                    }
+                }
+              const double s_ii = (i == 0 ? 1. : R(i-1,i-1));
+              for (unsigned int row=0; row<=col+1; ++row)
+                H(row,col) = h(row) / s_ii;
+            }
+
+          // update the scaling of the monomial basis with the norms of the
+          // new columns
+          for (unsigned int col=J; col<J+n_new; ++col)
+            {
+              double norm_sqr = 0;
+              for (unsigned int row=0; row<=col+1; ++row)
+                norm_sqr += H(row,col) * H(row,col);
+              nu = std::max (nu, std::sqrt (norm_sqr));
+            }
+
+          // apply the Givens rotations to the new columns and check
+          // convergence after each of them
+          for (unsigned int col=J; col<J+n_new; ++col)
+            {
+              for (unsigned int row=0; row<=col+1; ++row)
+                h(row) = H(row,col);
+              givens_rotation (h, gamma, ci, si, col);
+              for (unsigned int row=0; row<=col; ++row)
+                H1(row,col) = h(row);
+              dim = col+1;
+
+              res = std::fabs (gamma(col+1));
+              iteration_state = this->iteration_status (++accumulated_iterations,
+                                                        res, x);
+              if (iteration_state != SolverControl::iterate)
+                break;
+            }
+        }
+
+      // solve the projected system and update the solution. the last vector
+      // of the basis is not needed for this, so we use it to form the
+      // linear combination of the others before applying the preconditioner
+      Vector<double> y (dim);
+      for (int i=dim-1; i>=0; --i)
+        {
+          double entry = gamma(i);
+          for (unsigned int j=i+1; j<dim; ++j)
+            entry -= H1(i,j) * y(j);
+          y(i) = entry / H1(i,i);
+        }
+      VectorType &update = v[dim];
+      update.equ (y(0), v[0]);
+      for (unsigned int i=1; i<dim; ++i)
+        update.add (y(i), v[i]);
+      precondition.vmult (p, update);
+      x += p;
+    }
+  while (iteration_state == SolverControl::iterate);
+
+  deallog.pop();
+
+  // in case of failure: throw exception
+  AssertThrow(iteration_state == SolverControl::success,
+              SolverControl::NoConvergence (accumulated_iterations, res));
+}
+
 #endif // DOXYGEN
 
 DEAL_II_NAMESPACE_CLOSE
@@ -0,0 +1,255 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_solver_pipe_cg_h
+#define dealii_solver_pipe_cg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/logstream.h>
+#include <deal.II/lac/solver.h>
+#include <deal.II/lac/solver_control.h>
+
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*!@addtogroup Solvers */
+/*@{*/
+
+/**
+ * Pipelined preconditioned conjugate gradient method for symmetric positive
+ * definite matrices, following P. Ghysels and W. Vanroose: "Hiding global
+ * synchronization latency in the preconditioned Conjugate Gradient
+ * algorithm", Parallel Computing 40 (2014), pp. 224-238.
+ *
+ * In exact arithmetic, this method computes the same iterates as SolverCG.
+ * It is rearranged such that all inner products of one iteration are
+ * computed in a single global reduction, and that this reduction can run
+ * while the preconditioner and the matrix are applied. To this end, the
+ * method carries the images of the search direction and of the residual
+ * under the preconditioner and the matrix along as additional vectors that
+ * are updated by recurrences. For
+ * LinearAlgebra::distributed::Vector, the inner products are computed by
+ * LinearAlgebra::distributed::Vector::block_dot_start(), i.e., with a
+ * non-blocking <code>MPI_Iallreduce</code> that overlaps with
+ * <code>precondition.vmult()</code> and <code>A.vmult()</code>. This hides
+ * the latency of the global communication on large numbers of processors,
+ * where SolverCG needs at least two blocking reductions per iteration. For
+ * other vector types, the inner products are computed one after the other.
+ *
+ * The price for this is a larger number of vectors, ten instead of four,
+ * and more vector updates per iteration. Furthermore, the recurrences for
+ * the additional vectors accumulate rounding errors, so that the attainable
+ * accuracy of the residual is somewhat lower than with SolverCG. This class
+ * is therefore only preferable when the global reductions, rather than the
+ * matrix-vector products, dominate the run time, e.g., for small numbers of
+ * unknowns per processor on many processors.
+ *
+ * The stopping criterion is the norm of the residual $b-Ax$, computed by
+ * recurrence, like in SolverCG. The solve() function of this class uses the
+ * mechanism described in the Solver base class to determine convergence,
+ * and gets its temporary vectors from the VectorMemory object given to the
+ * constructor.
+ */
+template <typename VectorType = Vector<double> >
+class SolverPipeCG : public Solver<VectorType>
+{
+public:
+  /**
+   * Standardized data struct to pipe additional data to the solver. This
+   * solver does not need additional data.
+   */
+  struct AdditionalData {};
+
+  /**
+   * Constructor.
+   */
+  SolverPipeCG (SolverControl            &cn,
+                VectorMemory<VectorType> &mem,
+                const AdditionalData     &data = AdditionalData());
+
+  /**
+   * Constructor. Use an object of type GrowingVectorMemory as a default to
+   * allocate memory.
+   */
+  SolverPipeCG (SolverControl        &cn,
+                const AdditionalData &data = AdditionalData());
+
+  /**
+   * Solve the linear system $Ax=b$ for x.
+   */
+  template <typename MatrixType, typename PreconditionerType>
+  void
+  solve (const MatrixType         &A,
+         VectorType               &x,
+         const VectorType         &b,
+         const PreconditionerType &precondition);
+
+protected:
+  /**
+   * Additional parameters.
+   */
+  AdditionalData additional_data;
+};
+
+/*@}*/
+
+/*------------------------- Implementation ----------------------------*/
+
+#ifndef DOXYGEN
+
+template <typename VectorType>
+SolverPipeCG<VectorType>::SolverPipeCG (SolverControl            &cn,
+                                        VectorMemory<VectorType> &mem,
+                                        const AdditionalData     &data)
+  :
+  Solver<VectorType>(cn,mem),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+SolverPipeCG<VectorType>::SolverPipeCG (SolverControl        &cn,
+                                        const AdditionalData &data)
+  :
+  Solver<VectorType>(cn),
+  additional_data(data)
+{}
+
+
+
+template <typename VectorType>
+template <typename MatrixType, typename PreconditionerType>
+void
+SolverPipeCG<VectorType>::solve (const MatrixType         &A,
+                                 VectorType               &x,
+                                 const VectorType         &b,
+                                 const PreconditionerType &precondition)
+{
+  deallog.push("PipeCG");
+
+  // the names of the vectors follow algorithm 4 in the paper by Ghysels and
+  // Vanroose: r is the residual, u = M^{-1} r, w = A u, m = M^{-1} w,
+  // n = A m, and p, s = A p, q = M^{-1} s, z = A q are the search direction
+  // and its images
+  typename VectorMemory<VectorType>::Pointer r_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer u_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer w_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer m_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer n_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer p_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer s_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer q_pointer (this->memory);
+  typename VectorMemory<VectorType>::Pointer z_pointer (this->memory);
+  VectorType &r = *r_pointer;
+  VectorType &u = *u_pointer;
+  VectorType &w = *w_pointer;
+  VectorType &m = *m_pointer;
+  VectorType &n = *n_pointer;
+  VectorType &p = *p_pointer;
+  VectorType &s = *s_pointer;
+  VectorType &q = *q_pointer;
+  VectorType &z = *z_pointer;
+
+  r.reinit (x, true);
+  u.reinit (x, true);
+  w.reinit (x, true);
+  m.reinit (x, true);
+  n.reinit (x, true);
+  p.reinit (x);
+  s.reinit (x);
+  q.reinit (x);
+  z.reinit (x);
+
+  SolverControl::State conv = SolverControl::iterate;
+  double res = -std::numeric_limits<double>::max();
+
+  if (!x.all_zero())
+    {
+      A.vmult (r, x);
+      r.sadd (-1., 1., b);
+    }
+  else
+    r = b;
+  precondition.vmult (u, r);
+  A.vmult (w, u);
+
+  const std::vector<const VectorType *> left_vectors = {&u, &r};
+  const std::vector<const VectorType *> right_vectors = {&r, &w};
+
+  double gamma_old = 0, alpha_old = 0;
+  unsigned int it = 0;
+  for ( ; ; ++it)
+    {
+      // start the reduction for <u,r>, <u,w> and <r,r>, and apply the
+      // preconditioner and the matrix while it is in flight
+      Utilities::MPI::Future<std::vector<double> > products
+        = internal::SolverReductions::block_dot_start (left_vectors, right_vectors);
+      precondition.vmult (m, w);
+      A.vmult (n, m);
+      const std::vector<double> results = products.get();
+      const double gamma = results[0];
+      const double delta = results[1];
+      res = std::sqrt (results[2]);
+
+      conv = this->iteration_status (it, res, x);
+      if (conv != SolverControl::iterate)
+        break;
+
+      double alpha, beta;
+      if (it == 0)
+        {
+          beta = 0.;
+          Assert (delta != 0., ExcDivideByZero());
+          alpha = gamma / delta;
+        }
+      else
+        {
+          Assert (gamma_old != 0. && alpha_old != 0., ExcDivideByZero());
+          beta = gamma / gamma_old;
+          const double denominator = delta - beta * gamma / alpha_old;
+          Assert (denominator != 0., ExcDivideByZero());
+          alpha = gamma / denominator;
+        }
+
+      z.sadd (beta, 1., n);
+      q.sadd (beta, 1., m);
+      s.sadd (beta, 1., w);
+      p.sadd (beta, 1., u);
+
+      x.add (alpha, p);
+      r.add (-alpha, s);
+      u.add (-alpha, q);
+      w.add (-alpha, z);
+
+      gamma_old = gamma;
+      alpha_old = alpha;
+    }
+
+  deallog.pop();
+
+  // in case of failure: throw exception
+  AssertThrow(conv == SolverControl::success,
+              SolverControl::NoConvergence (it, res));
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
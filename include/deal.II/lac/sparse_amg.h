@@ -0,0 +1,386 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_amg_h
+#define dealii_sparse_amg_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/smartpointer.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/sparse_direct.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <memory>
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Preconditioners
+ *@{
+ */
+
+/**
+ * An algebraic multigrid preconditioner based on smoothed aggregation for
+ * symmetric positive definite matrices stored as SparseMatrix. In contrast
+ * to TrilinosWrappers::PreconditionAMG and the AMG preconditioners of PETSc,
+ * this class does not need any external library. It is meant for problems
+ * that are too large for SparseILU or SSOR to be efficient, in the sense
+ * that the number of iterations of SolverCG preconditioned by this class
+ * stays approximately constant as the mesh is refined.
+ *
+ * The hierarchy of coarser matrices is built in the initialize() function
+ * as follows:
+ * <ol>
+ * <li> The degrees of freedom of the current level are grouped into
+ * aggregates. Two unknowns $i,j$ are strongly coupled if $|a_{ij}| \geq
+ * \theta \sqrt{|a_{ii} a_{jj}|}$, where $\theta$ is
+ * AdditionalData::strong_threshold, and every aggregate consists of an
+ * unknown together with some of its strongly coupled neighbors, following
+ * the three phases of the algorithm of Vaněk, Mandel, and Brezina.
+ * Unknowns without strong couplings, such as rows that only contain a
+ * diagonal entry because they are subject to Dirichlet boundary conditions,
+ * are not aggregated at all.
+ * <li> The near null space of the matrix (the constant vector, unless
+ * AdditionalData::near_null_space says otherwise) is restricted to every
+ * aggregate and orthonormalized there. This gives a tentative prolongation
+ * $\hat P$ that represents the near null space exactly on the coarse level,
+ * and the coarse representation of the near null space for the next level.
+ * <li> The tentative prolongation is smoothed by one step of damped Jacobi,
+ * $P = (I - \frac{\omega}{\lambda_\text{max}} D^{-1}A) \hat P$, where
+ * $\lambda_\text{max}$ is estimated by a few power iterations of $D^{-1}A$
+ * and $\omega$ is AdditionalData::prolongation_damping.
+ * <li> The coarse matrix is the Galerkin product $A_c = P^T A P$.
+ * </ol>
+ * This is repeated until the matrix has no more than
+ * AdditionalData::max_coarse_size rows, until no further coarsening is
+ * possible, or until AdditionalData::max_levels levels have been created.
+ *
+ * The sparse matrix products, the transposed prolongation that is stored
+ * explicitly as restriction matrix, the strength of connection, and the
+ * orthonormalization on the aggregates are computed in parallel on all
+ * available threads. Only the aggregation itself is sequential. The
+ * application of the preconditioner is one V-cycle, with a
+ * PreconditionChebyshev smoother around a Jacobi preconditioner for pre- and
+ * post-smoothing on every level except the coarsest one. The smoother works
+ * with the estimate of $\lambda_\text{max}$ from the setup, increased by
+ * 20 percent for safety, instead of computing its own one. On the coarsest
+ * level, the system is solved by SparseDirectUMFPACK if deal.II was
+ * configured with UMFPACK, and with the inverse of the matrix stored as
+ * FullMatrix otherwise. If coarsening stopped before the coarsest level
+ * was small enough, either because of AdditionalData::max_levels or because
+ * the aggregation did not reduce the size any further, factorizing that
+ * level would be too expensive and the smoother is applied there instead.
+ * All the operations of the V-cycle are matrix-vector products and vector
+ * updates that run in parallel.
+ *
+ * The preconditioner is used like any other preconditioner in deal.II:
+ * @code
+ * SparseAMG<double> preconditioner;
+ * preconditioner.initialize (system_matrix);
+ *
+ * SolverControl control (1000, 1e-12*system_rhs.l2_norm());
+ * SolverCG<> cg (control);
+ * cg.solve (system_matrix, solution, system_rhs, preconditioner);
+ * @endcode
+ *
+ * For systems of partial differential equations, the near null space
+ * should be passed through AdditionalData::near_null_space, e.g., the
+ * constant vectors of each component, or the rigid body modes in elasticity.
+ * The aggregation then still works on the individual unknowns, though,
+ * which is less robust than aggregating all the components of a node at
+ * once.
+ *
+ * @note Instantiations for this template are provided for <tt>@<float@> and
+ * @<double@></tt>.
+ */
+template <typename number>
+class SparseAMG : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * Standardized data struct to pipe additional parameters to the
+   * preconditioner.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor. The default values give a solver that works well for
+     * Laplace-type problems discretized by continuous finite elements.
+     */
+    AdditionalData (const double       strong_threshold         = 0.02,
+                    const unsigned int max_coarse_size          = 500,
+                    const unsigned int max_levels               = 20,
+                    const unsigned int smoother_degree          = 2,
+                    const double       smoother_smoothing_range = 15.,
+                    const double       prolongation_damping     = 4./3.);
+
+    /**
+     * The threshold $\theta$ that determines whether two unknowns are
+     * strongly coupled and thus candidates for the same aggregate. Larger
+     * values lead to smaller aggregates, which is sometimes necessary for
+     * anisotropic problems.
+     */
+    double strong_threshold;
+
+    /**
+     * Stop coarsening once a level has at most this many rows. The matrix
+     * on that level is then factorized by a direct solver.
+     */
+    unsigned int max_coarse_size;
+
+    /**
+     * The maximal number of levels in the hierarchy, including the level of
+     * the original matrix.
+     */
+    unsigned int max_levels;
+
+    /**
+     * The degree of the Chebyshev polynomial used for smoothing. See
+     * PreconditionChebyshev::AdditionalData::degree.
+     */
+    unsigned int smoother_degree;
+
+    /**
+     * The range of eigenvalues the Chebyshev smoother acts on. See
+     * PreconditionChebyshev::AdditionalData::smoothing_range.
+     */
+    double smoother_smoothing_range;
+
+    /**
+     * The damping parameter $\omega$ of the Jacobi step that smoothes the
+     * tentative prolongation. The default value $4/3$ is optimal for
+     * Laplace-type problems.
+     */
+    double prolongation_damping;
+
+    /**
+     * The vectors spanning the near null space of the matrix, i.e., the
+     * vectors the AMG hierarchy needs to be able to represent on all
+     * levels. If empty, the constant vector is used, which is the right
+     * choice for scalar problems. Each vector needs to have as many entries
+     * as the matrix has rows.
+     */
+    std::vector<Vector<double> > near_null_space;
+  };
+
+  /**
+   * Constructor. Does nothing.
+   *
+   * Call the initialize() function before using this object as
+   * preconditioner.
+   */
+  SparseAMG ();
+
+  /**
+   * Build the multigrid hierarchy for the given matrix. The matrix needs to
+   * be symmetric positive definite, and it needs to persist as long as this
+   * object is used as preconditioner because the V-cycle works on it
+   * directly on the finest level.
+   */
+  void initialize (const SparseMatrix<number> &matrix,
+                   const AdditionalData       &additional_data = AdditionalData());
+
+  /**
+   * Release all memory and return to the state right after the constructor
+   * was called.
+   */
+  void clear ();
+
+  /**
+   * Apply the preconditioner, i.e., perform one V-cycle with zero initial
+   * guess on <tt>src</tt> and store the result in <tt>dst</tt>. The vectors
+   * may use a different number type than the matrices, in which case they
+   * are converted on the finest level.
+   */
+  template <typename somenumber>
+  void vmult (Vector<somenumber>       &dst,
+              const Vector<somenumber> &src) const;
+
+  /**
+   * Apply the transpose of the preconditioner. Since the V-cycle uses the
+   * same smoother before and after the coarse grid correction, the
+   * preconditioner is symmetric for symmetric matrices, and this function
+   * does the same as vmult().
+   */
+  template <typename somenumber>
+  void Tvmult (Vector<somenumber>       &dst,
+               const Vector<somenumber> &src) const;
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of levels of the hierarchy, including the level of
+   * the original matrix.
+   */
+  unsigned int n_levels () const;
+
+  /**
+   * Return the number of rows of the matrix on the given level, where
+   * level zero is the original matrix.
+   */
+  size_type n_rows_on_level (const unsigned int level) const;
+
+  /**
+   * Return the operator complexity of the hierarchy, i.e., the number of
+   * nonzero entries of the matrices on all levels divided by the number of
+   * nonzero entries of the original matrix. This is a measure for the cost
+   * of one V-cycle relative to one matrix-vector product, as well as for
+   * the memory consumption of the hierarchy.
+   */
+  double operator_complexity () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Type of the smoother used on the levels of the hierarchy.
+   */
+  typedef PreconditionChebyshev<SparseMatrix<number>,Vector<number> > SmootherType;
+
+  /**
+   * Return the matrix on the given level.
+   */
+  const SparseMatrix<number> &get_matrix (const unsigned int level) const;
+
+  /**
+   * Perform one V-cycle with zero initial guess on level @p level, using
+   * <tt>rhs[level]</tt> as right hand side and storing the result in
+   * <tt>solution[level]</tt>.
+   */
+  void v_cycle (const unsigned int level) const;
+
+  /**
+   * Compute the product $C=AB$ of two sparse matrices, building both the
+   * sparsity pattern and the values of @p C in parallel. If the product is
+   * square, its diagonal entries are always added to the sparsity pattern.
+   */
+  static void multiply (const SparseMatrix<number> &A,
+                        const SparseMatrix<number> &B,
+                        SparsityPattern            &sparsity_C,
+                        SparseMatrix<number>       &C);
+
+  /**
+   * Store the transpose of @p A in @p B.
+   */
+  static void transpose (const SparseMatrix<number> &A,
+                         SparsityPattern            &sparsity_B,
+                         SparseMatrix<number>       &B);
+
+  /**
+   * The original matrix on the finest level.
+   */
+  SmartPointer<const SparseMatrix<number>,SparseAMG<number> > matrix;
+
+  /**
+   * Sparsity patterns of the matrices on the coarser levels. The entry for
+   * level zero is empty.
+   */
+  std::vector<std::unique_ptr<SparsityPattern> > level_sparsity;
+
+  /**
+   * The matrices on the coarser levels. The entry for level zero is empty,
+   * see get_matrix().
+   */
+  std::vector<std::unique_ptr<SparseMatrix<number> > > level_matrices;
+
+  /**
+   * Sparsity patterns of the prolongation matrices.
+   */
+  std::vector<std::unique_ptr<SparsityPattern> > prolongation_sparsity;
+
+  /**
+   * The prolongation matrices. Entry @p l maps from level <tt>l+1</tt> to
+   * level @p l.
+   */
+  std::vector<std::unique_ptr<SparseMatrix<number> > > prolongation_matrices;
+
+  /**
+   * Sparsity patterns of the restriction matrices.
+   */
+  std::vector<std::unique_ptr<SparsityPattern> > restriction_sparsity;
+
+  /**
+   * The restriction matrices, i.e., the transposes of the prolongation
+   * matrices. Storing them explicitly allows the restriction to run in
+   * parallel like any other matrix-vector product.
+   */
+  std::vector<std::unique_ptr<SparseMatrix<number> > > restriction_matrices;
+
+  /**
+   * The smoothers on all levels but the coarsest one, plus one on the
+   * coarsest level if that level is not solved directly.
+   */
+  std::vector<std::unique_ptr<SmootherType> > smoothers;
+
+#ifdef DEAL_II_WITH_UMFPACK
+  /**
+   * The factorization of the matrix on the coarsest level.
+   */
+  SparseDirectUMFPACK coarse_solver;
+
+  /**
+   * A vector in double precision in which the coarse solver works.
+   */
+  mutable Vector<double> coarse_vector;
+#else
+  /**
+   * The inverse of the matrix on the coarsest level.
+   */
+  FullMatrix<number> coarse_inverse;
+#endif
+
+  /**
+   * Right hand side, solution, and residual vectors on all levels.
+   */
+  mutable std::vector<Vector<number> > rhs;
+  mutable std::vector<Vector<number> > solution;
+  mutable std::vector<Vector<number> > residual;
+
+  /**
+   * A mutex to avoid that multiple vmult() invocations by different threads
+   * overwrite the vectors of the V-cycle.
+   */
+  mutable Threads::Mutex mutex;
+};
+
+/*@}*/
+
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif // dealii_sparse_amg_h
@@ -0,0 +1,447 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sparse_direct_cholesky_h
+#define dealii_sparse_direct_cholesky_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/types.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/vector.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+/*! @addtogroup Solvers
+ *@{
+ */
+
+/**
+ * A sparse direct solver for symmetric matrices stored as SparseMatrix,
+ * which computes either a Cholesky factorization $PAP^T = LL^T$ of a
+ * symmetric positive definite matrix, or an LDL<sup>T</sup> factorization
+ * $PAP^T = LDL^T$ of a symmetric indefinite one. In contrast to
+ * SparseDirectUMFPACK, this class does not need any external library,
+ * exploits the symmetry of the matrix, and computes the factorization on
+ * all available threads. It is meant for the coarse-grid and sub-domain
+ * problems of larger computations, and for the solution of moderately sized
+ * problems in their own right.
+ *
+ * The factorization is computed in two phases:
+ * <ol>
+ * <li> The symbolic factorization only depends on the sparsity pattern. It
+ * computes a fill-reducing ordering $P$ (see AdditionalData::ordering), the
+ * elimination tree, and the structure of the factor $L$. Columns of $L$ with
+ * the same structure below the diagonal are grouped into supernodes, whose
+ * entries are stored as dense blocks.
+ * <li> The numeric factorization works its way from the leaves of the tree
+ * of supernodes to its root. For every supernode, it assembles the entries
+ * of the matrix and the contributions of its children into a dense frontal
+ * matrix, factorizes the columns of the supernode with blocked dense
+ * kernels, and passes the Schur complement on to the parent (the
+ * multifrontal method). Independent subtrees are factorized in parallel
+ * tasks, and the Schur complements of large supernodes are computed in
+ * parallel as well. If deal.II was configured with LAPACK, the Schur
+ * complements are computed by the BLAS function <code>gemm</code>.
+ * </ol>
+ * The symbolic factorization can be reused for any number of matrices with
+ * the same sparsity pattern: call initialize() with the sparsity pattern
+ * once, and then factorize() for each matrix. The initialize() function
+ * that takes a matrix does both at once.
+ *
+ * Only the entries $a_{ij}$ of one of the two triangles of the matrix (after
+ * renumbering) are read, i.e., the matrix is assumed to be symmetric.
+ *
+ * The LDL<sup>T</sup> factorization uses 1x1 and 2x2 pivots chosen by the
+ * Bunch-Kaufman strategy, but only among the columns of the same supernode
+ * in order to keep the symbolic factorization valid. If no acceptable pivot
+ * can be found there, a pivot whose magnitude is smaller than
+ * AdditionalData::pivot_threshold times the largest entry of the matrix is
+ * replaced by that value, with its sign kept. In that case, the
+ * factorization is the one of a slightly perturbed matrix, which is
+ * reported by n_perturbed_pivots(), and the solution should be improved by
+ * a few steps of an iterative method preconditioned with this object. This
+ * works well for the saddle point problems of mixed discretizations.
+ *
+ * The solution of linear systems with the factors is not parallelized.
+ *
+ * The class implements the usual preconditioner interface, so it can be
+ * used as an exact preconditioner:
+ * @code
+ * SparseDirectCholesky cholesky;
+ * cholesky.initialize (system_matrix);
+ * cholesky.vmult (solution, system_rhs);
+ * @endcode
+ */
+class SparseDirectCholesky : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * The kinds of factorization this class can compute.
+   */
+  enum Factorization
+  {
+    /**
+     * A Cholesky factorization $LL^T$ for symmetric positive definite
+     * matrices.
+     */
+    cholesky,
+    /**
+     * An LDL<sup>T</sup> factorization with 1x1 and 2x2 pivots for
+     * symmetric indefinite matrices.
+     */
+    ldlt
+  };
+
+  /**
+   * The orderings of the rows and columns of the matrix the factorization
+   * is computed for.
+   */
+  enum Ordering
+  {
+    /**
+     * Factorize the matrix in the order given. This is useful if the
+     * degrees of freedom were already renumbered for small fill-in.
+     */
+    natural,
+    /**
+     * Use a nested dissection ordering, see
+     * SparsityTools::reorder_nested_dissection().
+     */
+    nested_dissection
+  };
+
+  /**
+   * Standardized data struct to pipe additional parameters to the solver.
+   */
+  struct AdditionalData
+  {
+    /**
+     * Constructor.
+     */
+    AdditionalData (const Factorization factorization   = cholesky,
+                    const Ordering      ordering        = nested_dissection,
+                    const double        pivot_threshold = 1e-8);
+
+    /**
+     * The kind of factorization to compute.
+     */
+    Factorization factorization;
+
+    /**
+     * The ordering of the unknowns.
+     */
+    Ordering ordering;
+
+    /**
+     * For the LDL<sup>T</sup> factorization, pivots with magnitude smaller
+     * than this number times the largest entry of the matrix are perturbed.
+     */
+    double pivot_threshold;
+  };
+
+  /**
+   * Constructor. Leaves the object empty.
+   */
+  SparseDirectCholesky ();
+
+  /**
+   * Compute the symbolic factorization for matrices with the given sparsity
+   * pattern, which must be square and compressed.
+   */
+  void initialize (const SparsityPattern &sparsity_pattern,
+                   const AdditionalData  &additional_data = AdditionalData());
+
+  /**
+   * Compute the numeric factorization of the given matrix. The symbolic
+   * factorization computed by the last call to one of the initialize()
+   * functions is reused, so the matrix needs to have the same sparsity
+   * pattern as the one given there.
+   */
+  template <typename number>
+  void factorize (const SparseMatrix<number> &matrix);
+
+  /**
+   * Compute the symbolic and the numeric factorization of the given matrix.
+   */
+  template <typename number>
+  void initialize (const SparseMatrix<number> &matrix,
+                   const AdditionalData       &additional_data = AdditionalData());
+
+  /**
+   * Release all memory and return to the state right after the constructor
+   * was called.
+   */
+  void clear ();
+
+  /**
+   * Solve the linear system with the factorized matrix in place, i.e.,
+   * overwrite the right hand side given as argument with the solution.
+   */
+  template <typename number>
+  void solve (Vector<number> &rhs_and_solution) const;
+
+  /**
+   * Apply the inverse of the factorized matrix, i.e., solve the linear
+   * system with right hand side @p src and store the solution in @p dst.
+   */
+  template <typename number>
+  void vmult (Vector<number>       &dst,
+              const Vector<number> &src) const;
+
+  /**
+   * Apply the transpose of the inverse of the factorized matrix. Since the
+   * matrix is symmetric, this is the same as vmult().
+   */
+  template <typename number>
+  void Tvmult (Vector<number>       &dst,
+               const Vector<number> &src) const;
+
+  /**
+   * Return the dimension of the codomain (or range) space.
+   */
+  size_type m () const;
+
+  /**
+   * Return the dimension of the domain space.
+   */
+  size_type n () const;
+
+  /**
+   * Return the number of supernodes of the symbolic factorization.
+   */
+  unsigned int n_supernodes () const;
+
+  /**
+   * Return the number of entries of the factor $L$ on and below the
+   * diagonal, counting the entries of the dense blocks of the supernodes.
+   */
+  std::size_t n_nonzero_elements () const;
+
+  /**
+   * Return the number of pivots that were perturbed in the last numeric
+   * factorization. This is always zero for the Cholesky factorization.
+   */
+  size_type n_perturbed_pivots () const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+  /** @addtogroup Exceptions
+   * @{ */
+
+  /**
+   * Exception
+   */
+  DeclException2 (ExcNotPositiveDefinite,
+                  size_type, double,
+                  << "The Cholesky factorization found the pivot " << arg2
+                  << " for row " << arg1 << " of the matrix, which is not"
+                  << " positive. The matrix is not positive definite.");
+
+  /**
+   * Exception
+   */
+  DeclExceptionMsg (ExcSparsityPatternMismatch,
+                    "The matrix does not have the sparsity pattern the "
+                    "symbolic factorization was computed for.");
+  //@}
+
+private:
+  /**
+   * Compute the ordering, the elimination tree, and the supernodes.
+   */
+  void compute_symbolic_factorization (const SparsityPattern &sparsity_pattern);
+
+  /**
+   * Assemble the frontal matrix of @p supernode from the entries of the
+   * matrix given in @p matrix_values and the Schur complements of its
+   * children, factorize its columns, and store the Schur complement for the
+   * parent.
+   */
+  void factorize_supernode (const unsigned int         supernode,
+                            const std::vector<double> &matrix_values);
+
+  /**
+   * The parameters the object was initialized with.
+   */
+  AdditionalData additional_data;
+
+  /**
+   * The number of rows and columns of the matrix.
+   */
+  size_type n_rows;
+
+  /**
+   * The number of entries of the sparsity pattern the symbolic
+   * factorization was computed for, to check the matrices given to
+   * factorize().
+   */
+  std::size_t n_matrix_entries;
+
+  /**
+   * The new number of each row of the matrix in the fill-reducing ordering,
+   * including the postordering of the elimination tree.
+   */
+  std::vector<size_type> new_index;
+
+  /**
+   * The first column of every supernode, plus one element that denotes the
+   * end of the last one. All indices of the symbolic factorization refer to
+   * the new numbering.
+   */
+  std::vector<size_type> supernode_start;
+
+  /**
+   * The parent of every supernode, or numbers::invalid_unsigned_int for the
+   * roots of the tree.
+   */
+  std::vector<unsigned int> supernode_parent;
+
+  /**
+   * The children of every supernode, stored in compressed form with the
+   * offsets in #children_start.
+   */
+  std::vector<unsigned int> children;
+
+  /**
+   * Offsets of the children of every supernode in #children.
+   */
+  std::vector<unsigned int> children_start;
+
+  /**
+   * The first supernode of the subtree of every supernode. Since the
+   * supernodes are numbered in postorder, the subtree consists of the
+   * supernodes from this one up to the supernode itself.
+   */
+  std::vector<unsigned int> first_descendant;
+
+  /**
+   * The indices of the rows of every supernode, i.e., its own columns
+   * followed by the rows below the supernode in ascending order, stored in
+   * compressed form with the offsets in #row_start.
+   */
+  std::vector<size_type> row_indices;
+
+  /**
+   * Offsets of the rows of every supernode in #row_indices.
+   */
+  std::vector<std::size_t> row_start;
+
+  /**
+   * For every row of a supernode below its own columns, the position of
+   * that row in the list of rows of the parent supernode. The entries are
+   * aligned with #row_indices, and the ones for the columns of the
+   * supernode are unused.
+   */
+  std::vector<unsigned int> parent_position;
+
+  /**
+   * For every supernode, the entries of the matrix that are assembled into
+   * its frontal matrix, given by their position in the sparsity pattern
+   * and their position in the frontal matrix, stored in compressed form
+   * with the offsets in #assembly_start.
+   */
+  std::vector<std::pair<std::size_t,std::size_t> > assembly;
+
+  /**
+   * Offsets of the matrix entries of every supernode in #assembly.
+   */
+  std::vector<std::size_t> assembly_start;
+
+  /**
+   * Estimate of the number of floating point operations needed to
+   * factorize the subtree of every supernode, used to decide which
+   * subtrees are worth a task of their own.
+   */
+  std::vector<double> subtree_work;
+
+  /**
+   * Offsets of the dense blocks of the supernodes in #factor_values.
+   */
+  std::vector<std::size_t> value_start;
+
+  /**
+   * The entries of the factor $L$. The block of every supernode is stored
+   * column by column, with the rows in the order of #row_indices, except
+   * for the rows of the supernode's own columns, which are in the order of
+   * #pivot_order. For the LDL<sup>T</sup> factorization, the diagonal of
+   * $L$ is one and not referenced.
+   */
+  std::vector<double> factor_values;
+
+  /**
+   * For every pivot, the index of the row eliminated by it. Pivoting only
+   * permutes the rows within a supernode. For the Cholesky factorization,
+   * this is the identity.
+   */
+  std::vector<size_type> pivot_order;
+
+  /**
+   * The diagonal of $D$ for the LDL<sup>T</sup> factorization.
+   */
+  std::vector<double> diagonal;
+
+  /**
+   * The entries below the diagonal of $D$ for the LDL<sup>T</sup>
+   * factorization, which are nonzero for the first column of 2x2 pivots
+   * only.
+   */
+  std::vector<double> off_diagonal;
+
+  /**
+   * The Schur complements passed from every supernode to its parent during
+   * the numeric factorization.
+   */
+  std::vector<std::vector<double> > schur_complements;
+
+  /**
+   * For every supernode, the number of perturbed pivots in the last
+   * numeric factorization.
+   */
+  std::vector<size_type> perturbed_pivots;
+
+  /**
+   * For every supernode, the row (in the new numbering) and the value of
+   * the first pivot that was not positive in a Cholesky factorization. The
+   * row is numbers::invalid_size_type if all pivots were positive.
+   */
+  std::vector<std::pair<size_type,double> > failed_pivot;
+
+  /**
+   * The magnitude below which pivots of the LDL<sup>T</sup> factorization
+   * are perturbed in the current numeric factorization.
+   */
+  double perturbation;
+};
+
+/*@}*/
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
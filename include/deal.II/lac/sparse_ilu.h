@@ -22,6 +22,7 @@
 #include <deal.II/lac/sparse_matrix.h>
 #include <deal.II/lac/sparse_decomposition.h>
 #include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sweep_schedule.h>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -40,6 +41,11 @@ DEAL_II_NAMESPACE_OPEN
  * given in the book Y. Saad: "Iterative methods for sparse linear systems",
  * second edition, in section 10.3.2.
  *
+ * The forward and backward substitutions in vmult() run on several threads,
+ * using a SweepSchedule with level scheduling for the sparsity pattern of the
+ * decomposition. The result is the same as with the sequential
+ * substitutions. Tvmult() is not parallelized.
+ *
  *
  * <h3>Usage and state management</h3>
  *
@@ -102,6 +108,12 @@ public:
   void initialize (const SparseMatrix<somenumber> &matrix,
                    const AdditionalData &parameters = AdditionalData());
 
+  /**
+   * Delete all member variables and return to the state after the default
+   * constructor.
+   */
+  virtual void clear();
+
   /**
    * Apply the incomplete decomposition, i.e. do one forward-backward step
    * $dst=(LU)^{-1}src$.
@@ -154,6 +166,13 @@ public:
                   "that the matrix for which you try to compute a "
                   "decomposition is singular.");
   //@}
+
+private:
+  /**
+   * The groups of rows in which the substitutions of vmult() run in
+   * parallel.
+   */
+  SweepSchedule schedule;
 };
 
 /*@}*/
@@ -133,6 +133,17 @@ label_200:
       for (size_type j=j1; j<=j2; ++j)
         iw[ja[j]] = numbers::invalid_size_type;
     }
+
+  schedule.initialize (sparsity);
+}
+
+
+
+template <typename number>
+void SparseILU<number>::clear ()
+{
+  schedule.clear ();
+  SparseLUDecomposition<number>::clear ();
 }
 
 
@@ -164,22 +175,22 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // perform it at the outset of the
   // loop
   dst = src;
-  for (size_type row=0; row<N; ++row)
-    {
-      // get start of this row. skip the
-      // diagonal element
-      const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (rowstart - column_numbers);
-      for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-      dst(row) = dst_row;
-    }
+  const auto forward_row = [&] (const size_type row)
+  {
+    // get start of this row. skip the
+    // diagonal element
+    const size_type *const rowstart = &column_numbers[rowstart_indices[row]+1];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = this->SparseMatrix<number>::val.get() +
+                          (rowstart - column_numbers);
+    for (const size_type *col=rowstart; col!=first_after_diagonal; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+    dst(row) = dst_row;
+  };
 
   // now the backward solve. same
   // procedure, but we need not set
@@ -189,24 +200,40 @@ void SparseILU<number>::vmult (Vector<somenumber>       &dst,
   // note that we need to scale now,
   // since the diagonal is not equal to
   // one now
-  for (int row=N-1; row>=0; --row)
+  const auto backward_row = [&] (const size_type row)
+  {
+    // get end of this row
+    const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
+    // find the position where the part
+    // right of the diagonal starts
+    const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
+
+    somenumber dst_row = dst(row);
+    const number *luval = this->SparseMatrix<number>::val.get() +
+                          (first_after_diagonal - column_numbers);
+    for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
+      dst_row -= *luval * dst(*col);
+
+    // scale by the diagonal element.
+    // note that the diagonal element
+    // was stored inverted
+    dst(row) = dst_row * this->diag_element(row);
+  };
+
+  // the rows that are coupled to a row with smaller index are in later
+  // groups of the schedule, so the substitutions may process the groups in
+  // order, and the rows within each group in parallel
+  if (schedule.empty())
     {
-      // get end of this row
-      const size_type *const rowend = &column_numbers[rowstart_indices[row+1]];
-      // find the position where the part
-      // right of the diagonal starts
-      const size_type *const first_after_diagonal = this->prebuilt_lower_bound[row];
-
-      somenumber dst_row = dst(row);
-      const number *luval = this->SparseMatrix<number>::val.get() +
-                            (first_after_diagonal - column_numbers);
-      for (const size_type *col=first_after_diagonal; col!=rowend; ++col, ++luval)
-        dst_row -= *luval * dst(*col);
-
-      // scale by the diagonal element.
-      // note that the diagonal element
-      // was stored inverted
-      dst(row) = dst_row * this->diag_element(row);
+      for (size_type row=0; row<N; ++row)
+        forward_row (row);
+      for (size_type row=N; row>0; --row)
+        backward_row (row-1);
+    }
+  else
+    {
+      schedule.forward (forward_row);
+      schedule.backward (backward_row);
     }
 }
 
@@ -290,7 +317,8 @@ template <typename number>
 std::size_t
 SparseILU<number>::memory_consumption () const
 {
-  return SparseLUDecomposition<number>::memory_consumption ();
+  return (SparseLUDecomposition<number>::memory_consumption () +
+          schedule.memory_consumption ());
 }
 
 
@@ -34,6 +34,8 @@ template <typename number> class Vector;
 template <typename number> class FullMatrix;
 template <typename Matrix> class BlockMatrixBase;
 template <typename number> class SparseILU;
+template <typename number> class SparseAMG;
+class SweepSchedule;
 
 #ifdef DEAL_II_WITH_TRILINOS
 namespace TrilinosWrappers
@@ -1281,6 +1283,43 @@ public:
                           const Vector<somenumber> &src,
                           const number              om = 1.) const;
 
+  /**
+   * Same as the function above, but run the forward and backward sweeps on
+   * several threads by processing the rows in the groups given by
+   * <tt>schedule</tt>, which must have been initialized with the sparsity
+   * pattern of this matrix. With SweepSchedule::level_scheduling, the
+   * result is the same as with the function above when the positions right
+   * of the diagonal are given. If <tt>schedule</tt> is empty, the rows are
+   * processed sequentially in their natural order.
+   */
+  template <typename somenumber>
+  void precondition_SSOR (Vector<somenumber>       &dst,
+                          const Vector<somenumber> &src,
+                          const number              omega,
+                          const SweepSchedule      &schedule) const;
+
+  /**
+   * Apply SOR preconditioning matrix to <tt>src</tt>, with the rows
+   * processed in parallel in the groups given by <tt>schedule</tt>. See the
+   * corresponding variant of precondition_SSOR().
+   */
+  template <typename somenumber>
+  void precondition_SOR (Vector<somenumber>       &dst,
+                         const Vector<somenumber> &src,
+                         const number              om,
+                         const SweepSchedule      &schedule) const;
+
+  /**
+   * Apply transpose SOR preconditioning matrix to <tt>src</tt>, with the
+   * rows processed in parallel in the groups given by <tt>schedule</tt>.
+   * See the corresponding variant of precondition_SSOR().
+   */
+  template <typename somenumber>
+  void precondition_TSOR (Vector<somenumber>       &dst,
+                          const Vector<somenumber> &src,
+                          const number              om,
+                          const SweepSchedule      &schedule) const;
+
   /**
    * Perform SSOR preconditioning in-place.  Apply the preconditioner matrix
    * without copying to a second vector.  <tt>omega</tt> is the relaxation
@@ -1374,6 +1413,39 @@ public:
   void SSOR_step (Vector<somenumber> &v,
                   const Vector<somenumber> &b,
                   const number        om = 1.) const;
+
+  /**
+   * Do one SOR step on <tt>v</tt>, with the rows processed in parallel in
+   * the groups given by <tt>schedule</tt>. Since no two rows in a group are
+   * coupled, this is the same as the function above with
+   * SweepSchedule::level_scheduling. If <tt>schedule</tt> is empty, this
+   * function falls back to the sequential algorithm.
+   */
+  template <typename somenumber>
+  void SOR_step (Vector<somenumber>       &v,
+                 const Vector<somenumber> &b,
+                 const number              om,
+                 const SweepSchedule      &schedule) const;
+
+  /**
+   * Do one adjoint SOR step on <tt>v</tt>, with the rows processed in
+   * parallel in the groups given by <tt>schedule</tt>.
+   */
+  template <typename somenumber>
+  void TSOR_step (Vector<somenumber>       &v,
+                  const Vector<somenumber> &b,
+                  const number              om,
+                  const SweepSchedule      &schedule) const;
+
+  /**
+   * Do one SSOR step on <tt>v</tt>, with the rows processed in parallel in
+   * the groups given by <tt>schedule</tt>.
+   */
+  template <typename somenumber>
+  void SSOR_step (Vector<somenumber>       &v,
+                  const Vector<somenumber> &b,
+                  const number              om,
+                  const SweepSchedule      &schedule) const;
 //@}
   /**
    * @name Iterators
@@ -1616,6 +1688,7 @@ private:
   template <typename somenumber> friend class SparseMatrix;
   template <typename somenumber> friend class SparseLUDecomposition;
   template <typename> friend class SparseILU;
+  template <typename> friend class SparseAMG;
 
   /**
    * To allow it calling private prepare_add() and prepare_set().
@@ -24,6 +24,7 @@
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sweep_schedule.h>
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/full_matrix.h>
@@ -1593,6 +1594,163 @@ SparseMatrix<number>::precondition_TSOR (Vector<somenumber> &dst,
 }
 
 
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SSOR (Vector<somenumber>       &dst,
+                                         const Vector<somenumber> &src,
+                                         const number              om,
+                                         const SweepSchedule      &schedule) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (src.size(), n());
+  Assert (schedule.empty() || schedule.n_rows() == n(),
+          ExcDimensionMismatch (schedule.n_rows(), n()));
+
+  AssertNoZerosOnDiagonal(*this);
+
+  const std::size_t *const rowstart = cols->rowstart.get();
+  const size_type   *const colnums  = cols->colnums.get();
+
+  // the rows that are processed before the current one in the forward
+  // sweep are the ones in earlier groups of the schedule, or the ones with
+  // smaller index without a schedule. we do the same operations in the same
+  // order as the sequential function with the positions right of the
+  // diagonal given, so level scheduling gives identical results
+  const auto precedes = [&] (const size_type row_1,
+                             const size_type row_2) -> bool
+  {
+    return (schedule.empty() ? row_1 < row_2 : schedule.precedes (row_1, row_2));
+  };
+
+  const auto forward_row = [&] (const size_type row)
+  {
+    number s = 0;
+    for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+      if (precedes (colnums[j], row))
+        s += val[j] * number(dst(colnums[j]));
+
+    dst(row) = src(row);
+    dst(row) -= s * om;
+    dst(row) /= val[rowstart[row]];
+  };
+
+  const auto backward_row = [&] (const size_type row)
+  {
+    number s = 0;
+    for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+      if (precedes (row, colnums[j]))
+        s += val[j] * number(dst(colnums[j]));
+
+    dst(row) -= s * om;
+    dst(row) /= val[rowstart[row]];
+  };
+
+  if (schedule.empty())
+    for (size_type row=0; row<n(); ++row)
+      forward_row (row);
+  else
+    schedule.forward (forward_row);
+
+  parallel::apply_to_subranges
+  (size_type(0), n(),
+   [&] (const size_type begin,
+        const size_type end)
+  {
+    for (size_type row=begin; row<end; ++row)
+      dst(row) *= somenumber(om*(number(2.)-om)) * somenumber(val[rowstart[row]]);
+  },
+  internal::SparseMatrix::minimum_parallel_grain_size);
+
+  if (schedule.empty())
+    for (size_type row=n(); row>0; --row)
+      backward_row (row-1);
+  else
+    schedule.backward (backward_row);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_SOR (Vector<somenumber>       &dst,
+                                        const Vector<somenumber> &src,
+                                        const number              om,
+                                        const SweepSchedule      &schedule) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+
+  dst = src;
+  if (schedule.empty())
+    {
+      SOR (dst, om);
+      return;
+    }
+
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (schedule.n_rows(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  const std::size_t *const rowstart = cols->rowstart.get();
+  const size_type   *const colnums  = cols->colnums.get();
+  schedule.forward ([&] (const size_type row)
+  {
+    somenumber s = dst(row);
+    for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+      if (schedule.precedes (colnums[j], row))
+        s -= somenumber(val[j]) * dst(colnums[j]);
+
+    dst(row) = s * somenumber(om) / somenumber(val[rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::precondition_TSOR (Vector<somenumber>       &dst,
+                                         const Vector<somenumber> &src,
+                                         const number              om,
+                                         const SweepSchedule      &schedule) const
+{
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+
+  dst = src;
+  if (schedule.empty())
+    {
+      TSOR (dst, om);
+      return;
+    }
+
+  AssertDimension (m(), n());
+  AssertDimension (dst.size(), n());
+  AssertDimension (schedule.n_rows(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  const std::size_t *const rowstart = cols->rowstart.get();
+  const size_type   *const colnums  = cols->colnums.get();
+  schedule.backward ([&] (const size_type row)
+  {
+    somenumber s = dst(row);
+    for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+      if (schedule.precedes (row, colnums[j]))
+        s -= somenumber(val[j]) * dst(colnums[j]);
+
+    dst(row) = s * somenumber(om) / somenumber(val[rowstart[row]]);
+  });
+}
+
+
 template <typename number>
 template <typename somenumber>
 void
@@ -1829,6 +1987,95 @@ SparseMatrix<number>::SSOR_step (Vector<somenumber> &v,
 
 
 
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::SOR_step (Vector<somenumber>       &v,
+                                const Vector<somenumber> &b,
+                                const number              om,
+                                const SweepSchedule      &schedule) const
+{
+  if (schedule.empty())
+    {
+      SOR_step (v, b, om);
+      return;
+    }
+
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  Assert (m() == v.size(), ExcDimensionMismatch(m(),v.size()));
+  Assert (m() == b.size(), ExcDimensionMismatch(m(),b.size()));
+  AssertDimension (schedule.n_rows(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  // since no two rows in one group of the schedule are coupled, the rows of
+  // earlier groups have their new values and the ones of later groups
+  // their old values when we get to the current row
+  const std::size_t *const rowstart = cols->rowstart.get();
+  const size_type   *const colnums  = cols->colnums.get();
+  schedule.forward ([&] (const size_type row)
+  {
+    somenumber s = b(row);
+    for (std::size_t j=rowstart[row]; j<rowstart[row+1]; ++j)
+      s -= somenumber(val[j]) * v(colnums[j]);
+    v(row) += s * somenumber(om) / somenumber(val[rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::TSOR_step (Vector<somenumber>       &v,
+                                 const Vector<somenumber> &b,
+                                 const number              om,
+                                 const SweepSchedule      &schedule) const
+{
+  if (schedule.empty())
+    {
+      TSOR_step (v, b, om);
+      return;
+    }
+
+  Assert (cols != nullptr, ExcNotInitialized());
+  Assert (val != nullptr, ExcNotInitialized());
+  AssertDimension (m(), n());
+  Assert (m() == v.size(), ExcDimensionMismatch(m(),v.size()));
+  Assert (m() == b.size(), ExcDimensionMismatch(m(),b.size()));
+  AssertDimension (schedule.n_rows(), n());
+
+  AssertNoZerosOnDiagonal(*this);
+
+  const std::size_t *const rowstart = cols->rowstart.get();
+  const size_type   *const colnums  = cols->colnums.get();
+  schedule.backward ([&] (const size_type row)
+  {
+    somenumber s = b(row);
+    for (std::size_t j=rowstart[row]; j<rowstart[row+1]; ++j)
+      s -= somenumber(val[j]) * v(colnums[j]);
+    v(row) += s * somenumber(om) / somenumber(val[rowstart[row]]);
+  });
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseMatrix<number>::SSOR_step (Vector<somenumber>       &v,
+                                 const Vector<somenumber> &b,
+                                 const number              om,
+                                 const SweepSchedule      &schedule) const
+{
+  SOR_step (v, b, om, schedule);
+  TSOR_step (v, b, om, schedule);
+}
+
+
+
 template <typename number>
 template <typename somenumber>
 void
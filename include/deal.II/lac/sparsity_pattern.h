@@ -31,6 +31,7 @@
 #endif
 #include <boost/serialization/split_member.hpp>
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -45,6 +46,8 @@ template <typename number> class FullMatrix;
 template <typename number> class SparseMatrix;
 template <typename number> class SparseLUDecomposition;
 template <typename number> class SparseILU;
+template <typename number> class SparseAMG;
+class SweepSchedule;
 template <typename VectorType> class VectorSlice;
 
 namespace ChunkSparsityPatternIterators
@@ -653,6 +656,33 @@ public:
   template <typename number>
   void copy_from (const FullMatrix<number> &matrix);
 
+  /**
+   * Make this object a compressed sparsity pattern of size
+   * <tt>n_rows</tt> times <tt>n_cols</tt> in which row $i$ has exactly
+   * <tt>row_lengths[i]</tt> entries, and let the function @p fill_row write
+   * the column indices of each row. The function is called as
+   * <tt>fill_row(i, column_indices)</tt> and must write exactly
+   * <tt>row_lengths[i]</tt> unique column indices, sorted in ascending order,
+   * to the array pointed to by <tt>column_indices</tt>. If the pattern is
+   * square, the diagonal entry must be among them.
+   *
+   * In contrast to the other ways of building a sparsity pattern, this
+   * function allocates the final memory only once and does not need to
+   * compress the pattern afterwards. This is useful if the exact row lengths
+   * can be computed cheaply in a first pass over the data, as done in
+   * DoFTools::make_compressed_sparsity_pattern().
+   *
+   * @note The rows are filled in parallel, i.e., @p fill_row may be called
+   * concurrently from several threads, for different rows.
+   *
+   * Previous content of this object is lost, and the sparsity pattern is in
+   * compressed mode afterwards.
+   */
+  void copy_from (const size_type                                          n_rows,
+                  const size_type                                          n_cols,
+                  const std::vector<unsigned int>                         &row_lengths,
+                  const std::function<void (const size_type, size_type *)> &fill_row);
+
   /**
    * Make the sparsity pattern symmetric by adding the sparsity pattern of the
    * transpose object.
@@ -1107,6 +1137,8 @@ private:
   template <typename number> friend class SparseMatrix;
   template <typename number> friend class SparseLUDecomposition;
   template <typename number> friend class SparseILU;
+  template <typename number> friend class SparseAMG;
+  friend class SweepSchedule;
   template <typename number> friend class ChunkSparseMatrix;
 
   friend class ChunkSparsityPattern;
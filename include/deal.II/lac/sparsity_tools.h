@@ -160,6 +160,35 @@ namespace SparsityTools
   reorder_hierarchical (const DynamicSparsityPattern                   &sparsity,
                         std::vector<DynamicSparsityPattern::size_type> &new_indices);
 
+  /**
+   * For a given square sparsity pattern, compute a re-enumeration of
+   * row/column indices that reduces the fill-in of a Cholesky or LDL<sup>T</sup>
+   * factorization of a symmetric matrix with this sparsity pattern, by
+   * nested dissection. The pattern does not need to be symmetric; the
+   * ordering is computed for the graph of the pattern plus its transpose.
+   * On return, <tt>new_indices[i]</tt> is the new number of index @p i.
+   *
+   * The graph is recursively split into two parts by a vertex separator,
+   * i.e., a set of vertices whose removal disconnects the two parts, and the
+   * vertices of the separator are numbered after those of the two parts.
+   * With this ordering, eliminating the unknowns of one part never creates
+   * fill-in in the other part. If deal.II was configured with METIS, this
+   * function calls <code>METIS_NodeND</code>, which computes the separators
+   * by multilevel graph partitioning. Otherwise, the separators are computed
+   * from a level structure of a breadth-first search that starts at a
+   * pseudo-peripheral vertex: the vertices of the middle level that are
+   * coupled to the next level form the separator. This gives good
+   * separators for the graphs of finite element discretizations of simply
+   * shaped domains, but is not as robust as METIS for general graphs. The
+   * recursion stops at parts with 64 or fewer vertices, which keep their
+   * relative order.
+   *
+   * Disconnected components of the graph are numbered one after the other.
+   */
+  void
+  reorder_nested_dissection (const SparsityPattern                   &sparsity,
+                             std::vector<SparsityPattern::size_type> &new_indices);
+
 #ifdef DEAL_II_WITH_MPI
   /**
    * Communicate rows in a dynamic sparsity pattern over MPI.
@@ -0,0 +1,344 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#ifndef dealii_sweep_schedule_h
+#define dealii_sweep_schedule_h
+
+
+#include <deal.II/base/config.h>
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/subscriptor.h>
+#include <deal.II/base/types.h>
+
+#include <vector>
+
+DEAL_II_NAMESPACE_OPEN
+
+class SparsityPattern;
+
+/*! @addtogroup Sparsity
+ *@{
+ */
+
+/**
+ * A schedule that allows to run Gauss-Seidel type sweeps over the rows of a
+ * sparse matrix, i.e., the forward and backward substitutions of SOR, SSOR
+ * and incomplete factorizations, on several threads.
+ *
+ * Such a sweep computes the new value in one row from the values that were
+ * computed before in the rows it is coupled to, and is therefore sequential
+ * in its natural form. This class splits the rows into groups so that no two
+ * rows in the same group are coupled by an entry of the sparsity pattern, in
+ * either direction. All rows of one group can then be processed in parallel,
+ * and the groups are processed one after the other, in ascending order for a
+ * forward sweep and in descending order for a backward sweep. Two ways to
+ * form the groups are available, see the Ordering enum:
+ * <ul>
+ * <li> With level scheduling, a row is put into the group one past the
+ * largest group of any row with a smaller index that it is coupled to. The
+ * sweep then computes exactly the same result as the sequential loop over
+ * the rows in their natural order, down to the last bit, because each row
+ * uses the same entries in the same order. How much parallelism this
+ * exposes depends on the numbering of the unknowns: a numbering along a
+ * wave front, like the one of DoFRenumbering::Cuthill_McKee(), gives about
+ * as many rows per group as there are unknowns on the front.
+ * <li> With multicoloring, the groups are the colors of a greedy coloring
+ * of the matrix graph. There are typically only a handful of colors, each
+ * with a large fraction of the rows, so this exposes much more parallelism.
+ * However, it changes the order in which the rows are visited and with it
+ * the method itself: SOR with a multicolor ordering is the SOR method for
+ * the matrix with rows and columns permuted such that all rows of one color
+ * come before the rows of the next color. This is well-known to be a
+ * smoother of about the same quality as the lexicographic one, but usually
+ * a somewhat weaker preconditioner. Incomplete factorizations compute
+ * their factors in the natural order and can only use level scheduling.
+ * </ul>
+ *
+ * Which entries of a row are "left of the diagonal" in the sense of the
+ * sweep is decided by comparing the groups of the two rows, see
+ * precedes(). For level scheduling, this is equivalent to comparing the row
+ * indices.
+ *
+ * Groups with fewer rows than a few times the grain size, and all groups if
+ * only one thread is available, are processed by a plain loop without the
+ * overhead of the task scheduler.
+ *
+ * This class is used by PreconditionSOR, PreconditionSSOR and SparseILU
+ * when working on a SparseMatrix. See the corresponding functions of the
+ * SparseMatrix class that take an object of this type.
+ */
+class SweepSchedule : public Subscriptor
+{
+public:
+  /**
+   * Declare type for container size.
+   */
+  typedef types::global_dof_index size_type;
+
+  /**
+   * The ways in which the rows can be grouped. See the class documentation
+   * for details.
+   */
+  enum Ordering
+  {
+    /**
+     * Group the rows by their dependency level. Sweeps give the same results
+     * as in the natural order of the rows.
+     */
+    level_scheduling,
+    /**
+     * Group the rows by the colors of a greedy coloring of the matrix graph.
+     * This changes the method.
+     */
+    multicoloring
+  };
+
+  /**
+   * Constructor. Leaves the object empty, and sweeps with it fall back to the
+   * sequential algorithm.
+   */
+  SweepSchedule ();
+
+  /**
+   * Compute the groups of rows for the given sparsity pattern, which must
+   * be square and compressed.
+   */
+  void initialize (const SparsityPattern &sparsity,
+                   const Ordering         ordering = level_scheduling);
+
+  /**
+   * Release all memory and return to the state after the default
+   * constructor.
+   */
+  void clear ();
+
+  /**
+   * Return whether the object has not been initialized.
+   */
+  bool empty () const;
+
+  /**
+   * Return the ordering with which the object was initialized.
+   */
+  Ordering get_ordering () const;
+
+  /**
+   * Return the number of rows of the sparsity pattern the object was
+   * initialized with.
+   */
+  size_type n_rows () const;
+
+  /**
+   * Return the number of groups, i.e., the number of levels or colors.
+   */
+  unsigned int n_groups () const;
+
+  /**
+   * Return the number of rows in the given group.
+   */
+  size_type n_rows_in_group (const unsigned int group) const;
+
+  /**
+   * Return the group the given row belongs to.
+   */
+  unsigned int group_of_row (const size_type row) const;
+
+  /**
+   * Return whether a forward sweep processes the row @p row_1 before the row
+   * @p row_2. This is only meaningful for two rows that are coupled in the
+   * sparsity pattern, as these are never in the same group.
+   */
+  bool precedes (const size_type row_1,
+                 const size_type row_2) const;
+
+  /**
+   * Call <tt>worker(row)</tt> for all rows, running through the groups in
+   * ascending order. All calls for one group may run in parallel and must
+   * only write to data associated with their row.
+   */
+  template <typename Worker>
+  void forward (const Worker &worker) const;
+
+  /**
+   * Same as forward(), but run through the groups in descending order.
+   */
+  template <typename Worker>
+  void backward (const Worker &worker) const;
+
+  /**
+   * Determine an estimate for the memory consumption (in bytes) of this
+   * object.
+   */
+  std::size_t memory_consumption () const;
+
+private:
+  /**
+   * Process the rows of one group.
+   */
+  template <typename Worker>
+  void process_group (const unsigned int group,
+                      const Worker      &worker) const;
+
+  /**
+   * The minimal number of rows given to one task.
+   */
+  static const unsigned int grain_size = 128;
+
+  /**
+   * The ordering used to form the groups.
+   */
+  Ordering ordering;
+
+  /**
+   * The group of each row.
+   */
+  std::vector<unsigned int> row_group;
+
+  /**
+   * The rows, sorted by group and in ascending order within each group.
+   */
+  std::vector<size_type> rows;
+
+  /**
+   * The position in #rows where each group starts, plus one element that
+   * denotes the end of the last group.
+   */
+  std::vector<size_type> group_start;
+};
+
+/*@}*/
+
+#ifndef DOXYGEN
+/*---------------------------- Inline functions -----------------------------*/
+
+inline
+bool
+SweepSchedule::empty () const
+{
+  return row_group.empty();
+}
+
+
+
+inline
+SweepSchedule::Ordering
+SweepSchedule::get_ordering () const
+{
+  return ordering;
+}
+
+
+
+inline
+SweepSchedule::size_type
+SweepSchedule::n_rows () const
+{
+  return row_group.size();
+}
+
+
+
+inline
+unsigned int
+SweepSchedule::n_groups () const
+{
+  return group_start.empty() ? 0 : group_start.size()-1;
+}
+
+
+
+inline
+SweepSchedule::size_type
+SweepSchedule::n_rows_in_group (const unsigned int group) const
+{
+  AssertIndexRange (group, n_groups());
+  return group_start[group+1] - group_start[group];
+}
+
+
+
+inline
+unsigned int
+SweepSchedule::group_of_row (const size_type row) const
+{
+  AssertIndexRange (row, n_rows());
+  return row_group[row];
+}
+
+
+
+inline
+bool
+SweepSchedule::precedes (const size_type row_1,
+                         const size_type row_2) const
+{
+  return group_of_row (row_1) < group_of_row (row_2);
+}
+
+
+
+template <typename Worker>
+inline
+void
+SweepSchedule::process_group (const unsigned int group,
+                              const Worker      &worker) const
+{
+  const size_type begin = group_start[group];
+  const size_type end   = group_start[group+1];
+  if (end - begin < 4*grain_size || MultithreadInfo::n_threads() == 1)
+    for (size_type i=begin; i<end; ++i)
+      worker (rows[i]);
+  else
+    parallel::apply_to_subranges (begin, end,
+                                  [&] (const size_type range_begin,
+                                       const size_type range_end)
+    {
+      for (size_type i=range_begin; i<range_end; ++i)
+        worker (rows[i]);
+    },
+    grain_size);
+}
+
+
+
+template <typename Worker>
+inline
+void
+SweepSchedule::forward (const Worker &worker) const
+{
+  Assert (!empty(), ExcNotInitialized());
+  for (unsigned int group=0; group<n_groups(); ++group)
+    process_group (group, worker);
+}
+
+
+
+template <typename Worker>
+inline
+void
+SweepSchedule::backward (const Worker &worker) const
+{
+  Assert (!empty(), ExcNotInitialized());
+  for (unsigned int group=n_groups(); group>0; --group)
+    process_group (group-1, worker);
+}
+
+#endif // DOXYGEN
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -18,15 +18,126 @@
 
 
 #include <deal.II/base/config.h>
+#include <deal.II/base/table.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/vectorization.h>
 #include <deal.II/lac/lapack_full_matrix.h>
 #include <deal.II/matrix_free/tensor_product_kernels.h>
 
+#include <array>
+#include <cmath>
+#include <limits>
+
 DEAL_II_NAMESPACE_OPEN
 
 template <typename> class Vector;
 template <typename> class FullMatrix;
 
+/**
+ * This is a base class for the tensor product matrices described in
+ * TensorProductMatrixSymmetricSum, which holds the 1D matrices and their
+ * generalized eigendecomposition and implements the matrix-vector product
+ * and the inverse on plain arrays. The 1D matrices can be different for
+ * each direction, which allows to represent the Laplacian on axis-aligned
+ * cells with different extents in the coordinate directions,
+ * @f{align*}{
+ * L &= A_1 \otimes M_0 + M_1 \otimes A_0
+ * @f}
+ * in 2D and
+ * @f{align*}{
+ * L &= A_2 \otimes M_1 \otimes M_0 + M_2 \otimes A_1 \otimes M_0 +
+ * M_2 \otimes M_1 \otimes A_0
+ * @f}
+ * in 3D, where the index denotes the coordinate direction and direction
+ * zero runs fastest in the vectors.
+ *
+ * This class is not meant to be used directly; the derived classes
+ * TensorProductMatrixSymmetricSum fill the matrices in their reinit()
+ * functions.
+ */
+template <int dim, typename Number, int size = -1>
+class TensorProductMatrixSymmetricSumBase
+{
+public:
+  /**
+   * Returns the number of rows of this matrix, given by the product of the
+   * sizes of the 1D matrices passed to reinit().
+   */
+  unsigned int m() const;
+
+  /**
+   * Returns the number of columns of this matrix, given by the product of
+   * the sizes of the 1D matrices passed to reinit().
+   */
+  unsigned int n() const;
+
+  /**
+   * Implements a matrix-vector product with the underlying matrix as
+   * described in the main documentation of this class, operating on plain
+   * pointers (no check of array bounds possible).
+   */
+  void vmult (Number *dst,
+              const Number *src) const;
+
+  /**
+   * Implements the product of the inverse of the underlying matrix with a
+   * vector as described in the main documentation of this class, operating
+   * on plain pointers (no check of array bounds possible). The two pointers
+   * may point to the same array.
+   */
+  void apply_inverse (Number *dst,
+                      const Number *src) const;
+
+protected:
+  /**
+   * Default constructor, only available to derived classes.
+   */
+  TensorProductMatrixSymmetricSumBase() = default;
+
+  /**
+   * Check the sizes of the 1D matrices.
+   */
+  void check_sizes () const;
+
+  /**
+   * The mass matrices of the directions, as passed to the reinit() method
+   * of the derived class.
+   */
+  std::array<Table<2,Number>, dim> mass_matrix;
+
+  /**
+   * The derivative matrices of the directions, as passed to the reinit()
+   * method of the derived class.
+   */
+  std::array<Table<2,Number>, dim> derivative_matrix;
+
+  /**
+   * The generalized eigenvalues of $A_d s = \lambda M_d s$ of every
+   * direction.
+   */
+  std::array<AlignedVector<Number>, dim> eigenvalues;
+
+  /**
+   * The matrices containing the generalized eigenvectors of every
+   * direction, one eigenvector per column.
+   */
+  std::array<Table<2,Number>, dim> eigenvectors;
+
+  /**
+   * An array for temporary data, only used if the size is not a
+   * compile-time constant.
+   */
+  mutable AlignedVector<Number> tmp_array;
+
+  /**
+   * A mutex that guards access to the array @p tmp_array.
+   */
+  mutable Threads::Mutex mutex;
+};
+
+
+
 /**
  * This is a special matrix class defined as the tensor product (or Kronecker
  * product) of 1D matrices of the type
@@ -41,7 +152,9 @@ template <typename> class FullMatrix;
  * $L$ on a Cartesian (axis-aligned) geometry, where it can be exactly
  * represented by the Kronecker or tensor product of a 1D mass matrix $M$ and
  * a 1D Laplace matrix $A$ in each dimension. The dimension of the resulting
- * class is the product of the one-dimensional matrices.
+ * class is the product of the one-dimensional matrices. The reinit()
+ * function that takes arrays of matrices allows to use different matrices
+ * $M_d$ and $A_d$ in each direction, see TensorProductMatrixSymmetricSumBase.
  *
  * This class implements two basic operations, namely the usual multiplication
  * by a vector and the inverse. For both operations, fast tensorial techniques
@@ -69,7 +182,9 @@ template <typename> class FullMatrix;
  * $S^{\mathrm T} B S = I$. This method of matrix inversion is called fast
  * diagonalization method.
  *
- * This class requires LAPACK support.
+ * This class requires LAPACK support. The specialization for
+ * VectorizedArray, which handles the matrices of several cells at once,
+ * does not.
  *
  * Note that this class allows for two modes of usage. The first is a use case
  * with run time constants for the matrix dimensions that is achieved by
@@ -78,17 +193,20 @@ template <typename> class FullMatrix;
  * time constant, giving significantly faster code in particular for small
  * sizes of the matrix.
  *
- * @note This class uses a temporary array for storing intermediate results
- * that is a class member. A mutex is used to protect access to this array and
- * ensure correct results. If several threads run parallel instances of this
- * class, it is recommended that each threads holds its own matrix version.
+ * @note For run time sizes, this class uses a temporary array for storing
+ * intermediate results that is a class member. A mutex is used to protect
+ * access to this array and ensure correct results. If several threads run
+ * parallel instances of this class, it is recommended that each threads
+ * holds its own matrix version. With compile time sizes, the temporary
+ * array is placed on the stack and no mutex is needed.
  *
  * @tparam dim Dimension of the problem. Currently, 1D, 2D, and 3D codes are
  * implemented.
  *
  * @tparam Number Type of the underlying array elements. Note that the
  * underlying LAPACK implementation supports only float and double numbers, so
- * only these two types are currently supported.
+ * only these two types are currently supported by the generic class, and
+ * VectorizedArray<float> and VectorizedArray<double> by the specialization.
  *
  * @tparam size Compile-time array lengths. By default at -1, which means that
  * the run-time info stored in the matrices passed to the reinit()
@@ -97,7 +215,7 @@ template <typename> class FullMatrix;
  * @author Martin Kronbichler, 2017
  */
 template <int dim, typename Number, int size = -1>
-class TensorProductMatrixSymmetricSum
+class TensorProductMatrixSymmetricSum : public TensorProductMatrixSymmetricSumBase<dim,Number,size>
 {
 public:
   /**
@@ -112,6 +230,13 @@ public:
   TensorProductMatrixSymmetricSum(const FullMatrix<Number> &mass_matrix,
                                   const FullMatrix<Number> &derivative_matrix);
 
+  /**
+   * Constructor that is equivalent to the previous constructor and
+   * immediately calling reinit().
+   */
+  TensorProductMatrixSymmetricSum(const std::array<Table<2,Number>, dim> &mass_matrix,
+                                  const std::array<Table<2,Number>, dim> &derivative_matrix);
+
   /**
    * Initializes the matrix to the given mass matrix $M$ and derivative matrix
    * $A$. Note that the current implementation requires $M$ to be symmetric
@@ -122,16 +247,12 @@ public:
                const FullMatrix<Number> &derivative_matrix);
 
   /**
-   * Returns the number of rows of this matrix, given by the dim-th power of
-   * the size of the 1D matrices passed to the constructor.
-   */
-  unsigned int m() const;
-
-  /**
-   * Returns the number of columns of this matrix, given by the dim-th power
-   * of the size of the 1D matrices passed to the constructor.
+   * Initializes the matrix to the given mass matrices $M_d$ and derivative
+   * matrices $A_d$ of the coordinate directions, with the same requirements
+   * as in the other reinit() function. All matrices must have the same size.
    */
-  unsigned int n() const;
+  void reinit (const std::array<Table<2,Number>, dim> &mass_matrix,
+               const std::array<Table<2,Number>, dim> &derivative_matrix);
 
   /**
    * Implements a matrix-vector product with the underlying matrix as
@@ -140,15 +261,6 @@ public:
   void vmult (Vector<Number> &dst,
               const Vector<Number> &src) const;
 
-  /**
-   * Implements a matrix-vector product with the underlying matrix as
-   * described in the main documentation of this class. Same as the other
-   * vmult() function, but operating on plain pointers rather than a vector
-   * (no check of array bounds possible).
-   */
-  void vmult (Number *dst,
-              const Number *src) const;
-
   /**
    * Implements a matrix-vector product with the underlying matrix as
    * described in the main documentation of this class.
@@ -156,45 +268,70 @@ public:
   void apply_inverse (Vector<Number> &dst,
                       const Vector<Number> &src) const;
 
-  /**
-   * Implements a matrix-vector product with the underlying matrix as
-   * described in the main documentation of this class. Same as the other
-   * apply_inverse() function, but operating on plain pointers rather than a
-   * vector (no check of array bounds possible).
-   */
-  void apply_inverse (Number *dst,
-                      const Number *src) const;
+  using TensorProductMatrixSymmetricSumBase<dim,Number,size>::vmult;
+  using TensorProductMatrixSymmetricSumBase<dim,Number,size>::apply_inverse;
+};
 
-private:
-  /**
-   * A copy of the @p mass_matrix object passed to the reinit() method.
-   */
-  FullMatrix<Number> mass_matrix;
 
+
+/**
+ * This is the specialization of TensorProductMatrixSymmetricSum for
+ * VectorizedArray, which represents the tensor product matrices of
+ * VectorizedArray::n_array_elements cells at once, e.g., the cells of a
+ * batch in MatrixFree. The 1D matrices passed to reinit() contain the
+ * matrices of the individual cells in the lanes of the VectorizedArray
+ * entries, and vmult() and apply_inverse() work on arrays of
+ * VectorizedArray in the same way as the FEEvaluation class.
+ *
+ * The generalized eigenvalue problems of the cells are solved together,
+ * without LAPACK: after a Cholesky factorization $M = LL^T$, the eigenvalues
+ * of the symmetric matrix $L^{-1}AL^{-T}$ are computed by the cyclic Jacobi
+ * method. Apart from the computation of the rotation angles, all operations
+ * work on the VectorizedArray entries, i.e., on all cells simultaneously.
+ * Since all lanes are factorized, the lanes of incompletely filled cell
+ * batches need to be filled with valid matrices, e.g., copies of the first
+ * lane.
+ */
+template <int dim, typename Number, int size>
+class TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
+  : public TensorProductMatrixSymmetricSumBase<dim,VectorizedArray<Number>,size>
+{
+public:
   /**
-   * A copy of the @p derivative_matrix object passed to the reinit() method.
+   * Constructor.
    */
-  FullMatrix<Number> derivative_matrix;
+  TensorProductMatrixSymmetricSum();
 
   /**
-   * A vector containing the generalized eigenvalues of A s = lambda B s.
+   * Constructor that is equivalent to the previous constructor and
+   * immediately calling reinit().
    */
-  AlignedVector<Number> eigenvalues;
+  TensorProductMatrixSymmetricSum(const Table<2,VectorizedArray<Number> > &mass_matrix,
+                                  const Table<2,VectorizedArray<Number> > &derivative_matrix);
 
   /**
-   * The matrix containing the generalized eigenvectors.
+   * Constructor that is equivalent to the previous constructor and
+   * immediately calling reinit().
    */
-  Table<2,Number> eigenvectors;
+  TensorProductMatrixSymmetricSum(const std::array<Table<2,VectorizedArray<Number> >, dim> &mass_matrix,
+                                  const std::array<Table<2,VectorizedArray<Number> >, dim> &derivative_matrix);
 
   /**
-   * An array for temporary data.
+   * Initializes the matrix to the given mass matrix $M$ and derivative matrix
+   * $A$, used for all directions. The current implementation requires $M$
+   * to be symmetric and positive definite and $A$ to be symmetric and
+   * invertible but not necessarily positive defininte in all lanes.
    */
-  mutable AlignedVector<Number> tmp_array;
+  void reinit (const Table<2,VectorizedArray<Number> > &mass_matrix,
+               const Table<2,VectorizedArray<Number> > &derivative_matrix);
 
   /**
-   * A mutex that guards access to the array @p tmp_array.
+   * Initializes the matrix to the given mass matrices $M_d$ and derivative
+   * matrices $A_d$ of the coordinate directions, with the same requirements
+   * as in the other reinit() function. All matrices must have the same size.
    */
-  mutable Threads::Mutex mutex;
+  void reinit (const std::array<Table<2,VectorizedArray<Number> >, dim> &mass_matrix,
+               const std::array<Table<2,VectorizedArray<Number> >, dim> &derivative_matrix);
 };
 
 
@@ -202,6 +339,381 @@ private:
 
 #ifndef DOXYGEN
 
+namespace internal
+{
+  namespace TensorProductMatrix
+  {
+    /**
+     * Compute the generalized eigenvalues and eigenvectors of the matrices
+     * @p derivative_matrix and @p mass_matrix with LAPACK. The eigenvectors
+     * are stored in the columns of @p eigenvectors.
+     */
+    template <typename Number>
+    void
+    spectral_assembly (const dealii::Table<2,Number>  &mass_matrix,
+                       const dealii::Table<2,Number>  &derivative_matrix,
+                       AlignedVector<Number>  &eigenvalues,
+                       dealii::Table<2,Number>        &eigenvectors)
+    {
+      const unsigned int n = mass_matrix.n_rows();
+      std::vector<dealii::Vector<Number> > eigenvecs(n);
+      LAPACKFullMatrix<Number> mass_copy(n, n);
+      LAPACKFullMatrix<Number> deriv_copy(n, n);
+      for (unsigned int i=0; i<n; ++i)
+        for (unsigned int j=0; j<n; ++j)
+          {
+            mass_copy(i,j) = mass_matrix(i,j);
+            deriv_copy(i,j) = derivative_matrix(i,j);
+          }
+
+      deriv_copy.compute_generalized_eigenvalues_symmetric(mass_copy, eigenvecs);
+      AssertDimension(eigenvecs.size(), n);
+      eigenvectors.reinit(n, n);
+      for (unsigned int i=0; i<n; ++i)
+        for (unsigned int j=0; j<n; ++j)
+          eigenvectors(i,j) = eigenvecs[j][i];
+
+      eigenvalues.resize(n);
+      for (unsigned int i=0; i<n; ++i)
+        eigenvalues[i] = deriv_copy.eigenvalue(i).real();
+    }
+
+
+
+    /**
+     * Same as above for the matrices of several cells stored in the lanes of
+     * VectorizedArray. Instead of LAPACK, the generalized eigenvalue problem
+     * is reduced to a standard one by the Cholesky factorization of the mass
+     * matrix, which is then solved by the cyclic Jacobi method on all lanes
+     * simultaneously.
+     */
+    template <typename Number>
+    void
+    spectral_assembly (const dealii::Table<2,VectorizedArray<Number> > &mass_matrix,
+                       const dealii::Table<2,VectorizedArray<Number> > &derivative_matrix,
+                       AlignedVector<VectorizedArray<Number> > &eigenvalues,
+                       dealii::Table<2,VectorizedArray<Number> >       &eigenvectors)
+    {
+      typedef VectorizedArray<Number> VectorizedNumber;
+      const unsigned int n = mass_matrix.n_rows();
+      const unsigned int n_lanes = VectorizedNumber::n_array_elements;
+
+      // Cholesky factorization M = L L^T, with L stored in the lower part
+      dealii::Table<2,VectorizedNumber> l(n, n);
+      for (unsigned int j=0; j<n; ++j)
+        {
+          VectorizedNumber diagonal = mass_matrix(j,j);
+          for (unsigned int k=0; k<j; ++k)
+            diagonal -= l(j,k) * l(j,k);
+          l(j,j) = std::sqrt(diagonal);
+          const VectorizedNumber inverse = make_vectorized_array<Number>(1.) / l(j,j);
+          for (unsigned int i=j+1; i<n; ++i)
+            {
+              VectorizedNumber value = mass_matrix(i,j);
+              for (unsigned int k=0; k<j; ++k)
+                value -= l(i,k) * l(j,k);
+              l(i,j) = value * inverse;
+            }
+        }
+
+      // C = L^{-1} A L^{-T}, computed as X = L^{-1} A followed by
+      // C = L^{-1} X^T, which equals the former as A is symmetric
+      dealii::Table<2,VectorizedNumber> x(n, n), c(n, n);
+      for (unsigned int j=0; j<n; ++j)
+        for (unsigned int i=0; i<n; ++i)
+          {
+            VectorizedNumber value = derivative_matrix(i,j);
+            for (unsigned int k=0; k<i; ++k)
+              value -= l(i,k) * x(k,j);
+            x(i,j) = value / l(i,i);
+          }
+      for (unsigned int j=0; j<n; ++j)
+        for (unsigned int i=0; i<n; ++i)
+          {
+            VectorizedNumber value = x(j,i);
+            for (unsigned int k=0; k<i; ++k)
+              value -= l(i,k) * c(k,j);
+            c(i,j) = value / l(i,i);
+          }
+      for (unsigned int i=0; i<n; ++i)
+        for (unsigned int j=0; j<i; ++j)
+          {
+            const VectorizedNumber average = make_vectorized_array<Number>(0.5) *
+                                             (c(i,j) + c(j,i));
+            c(i,j) = average;
+            c(j,i) = average;
+          }
+
+      // cyclic Jacobi method on C, accumulating the rotations in V. the
+      // rotation angles are computed lane by lane, whereas the rotations are
+      // applied to all lanes at once
+      dealii::Table<2,VectorizedNumber> v(n, n);
+      for (unsigned int i=0; i<n; ++i)
+        v(i,i) = make_vectorized_array<Number>(1.);
+      const Number tolerance = std::numeric_limits<Number>::epsilon() *
+                               std::numeric_limits<Number>::epsilon();
+      for (unsigned int sweep=0; sweep<50; ++sweep)
+        {
+          VectorizedNumber off_diagonal = VectorizedNumber(), total = VectorizedNumber();
+          for (unsigned int i=0; i<n; ++i)
+            {
+              total += c(i,i) * c(i,i);
+              for (unsigned int j=0; j<i; ++j)
+                off_diagonal += c(i,j) * c(i,j);
+            }
+          total += make_vectorized_array<Number>(2.) * off_diagonal;
+          bool converged = true;
+          for (unsigned int lane=0; lane<n_lanes; ++lane)
+            if (off_diagonal[lane] > tolerance * total[lane])
+              converged = false;
+          if (converged)
+            break;
+
+          for (unsigned int p=0; p<n; ++p)
+            for (unsigned int q=p+1; q<n; ++q)
+              {
+                VectorizedNumber cosine, sine;
+                for (unsigned int lane=0; lane<n_lanes; ++lane)
+                  {
+                    const Number c_pq = c(p,q)[lane];
+                    if (c_pq == Number())
+                      {
+                        cosine[lane] = 1.;
+                        sine[lane] = 0.;
+                        continue;
+                      }
+                    const Number theta = (c(q,q)[lane] - c(p,p)[lane]) / (2.*c_pq);
+                    const Number abs_theta = std::abs(theta);
+                    const Number root = abs_theta > 1. ?
+                                        abs_theta * std::sqrt(1. + 1./(theta*theta)) :
+                                        std::sqrt(1. + theta*theta);
+                    const Number t = (theta < 0. ? -1. : 1.) / (abs_theta + root);
+                    cosine[lane] = 1./std::sqrt(1. + t*t);
+                    sine[lane] = t * cosine[lane];
+                  }
+
+                for (unsigned int k=0; k<n; ++k)
+                  {
+                    const VectorizedNumber c_kp = c(k,p), c_kq = c(k,q);
+                    c(k,p) = cosine * c_kp - sine * c_kq;
+                    c(k,q) = sine * c_kp + cosine * c_kq;
+                  }
+                for (unsigned int k=0; k<n; ++k)
+                  {
+                    const VectorizedNumber c_pk = c(p,k), c_qk = c(q,k);
+                    c(p,k) = cosine * c_pk - sine * c_qk;
+                    c(q,k) = sine * c_pk + cosine * c_qk;
+                  }
+                c(p,q) = VectorizedNumber();
+                c(q,p) = VectorizedNumber();
+                for (unsigned int k=0; k<n; ++k)
+                  {
+                    const VectorizedNumber v_kp = v(k,p), v_kq = v(k,q);
+                    v(k,p) = cosine * v_kp - sine * v_kq;
+                    v(k,q) = sine * v_kp + cosine * v_kq;
+                  }
+              }
+        }
+
+      // the eigenvectors of the generalized problem are S = L^{-T} V
+      eigenvalues.resize(n);
+      for (unsigned int i=0; i<n; ++i)
+        eigenvalues[i] = c(i,i);
+      eigenvectors.reinit(n, n);
+      for (unsigned int j=0; j<n; ++j)
+        for (unsigned int i=n; i>0; )
+          {
+            --i;
+            VectorizedNumber value = v(i,j);
+            for (unsigned int k=i+1; k<n; ++k)
+              value -= l(k,i) * eigenvectors(k,j);
+            eigenvectors(i,j) = value / l(i,i);
+          }
+    }
+  }
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+unsigned int
+TensorProductMatrixSymmetricSumBase<dim,Number,size>::m() const
+{
+  unsigned int m = mass_matrix[0].n_rows();
+  for (unsigned int d=1; d<dim; ++d)
+    m *= mass_matrix[d].n_rows();
+  return m;
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+unsigned int
+TensorProductMatrixSymmetricSumBase<dim,Number,size>::n() const
+{
+  unsigned int n = mass_matrix[0].n_cols();
+  for (unsigned int d=1; d<dim; ++d)
+    n *= mass_matrix[d].n_cols();
+  return n;
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumBase<dim,Number,size>::check_sizes() const
+{
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      Assert(size == -1 ||
+             (size > 0 && static_cast<unsigned int>(size) == mass_matrix[d].n_rows()),
+             ExcDimensionMismatch(size, mass_matrix[d].n_rows()));
+      AssertDimension(mass_matrix[d].n_rows(), mass_matrix[0].n_rows());
+      AssertDimension(mass_matrix[d].n_rows(), mass_matrix[d].n_cols());
+      AssertDimension(mass_matrix[d].n_rows(), derivative_matrix[d].n_rows());
+      AssertDimension(mass_matrix[d].n_rows(), derivative_matrix[d].n_cols());
+    }
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumBase<dim,Number,size>
+::vmult(Number *dst,
+        const Number *src) const
+{
+  const unsigned int n = Utilities::fixed_power<dim>(size > 0 ? size : eigenvalues[0].size());
+  const int kernel_size = size > 0 ? size-1 : -1;
+  internal::EvaluatorTensorProduct<internal::evaluate_general,dim,kernel_size,kernel_size+1,Number>
+  eval(AlignedVector<Number>(), AlignedVector<Number>(),
+       AlignedVector<Number>(), mass_matrix[0].n_rows()-1, mass_matrix[0].n_rows());
+
+  const auto apply = [&](Number *t)
+  {
+    const Number *A0 = &derivative_matrix[0](0,0);
+    const Number *M0 = &mass_matrix[0](0,0);
+    if (dim == 1)
+      eval.template apply<0, true, false>(A0, src, dst);
+    else if (dim == 2)
+      {
+        const Number *A1 = &derivative_matrix[1](0,0);
+        const Number *M1 = &mass_matrix[1](0,0);
+        eval.template apply<0, true, false>(M0, src, t);
+        eval.template apply<1, true, false>(A1, t, dst);
+        eval.template apply<0, true, false>(A0, src, t);
+        eval.template apply<1, true, true> (M1, t, dst);
+      }
+    else if (dim == 3)
+      {
+        const Number *A1 = &derivative_matrix[1](0,0);
+        const Number *M1 = &mass_matrix[1](0,0);
+        const Number *A2 = &derivative_matrix[dim-1](0,0);
+        const Number *M2 = &mass_matrix[dim-1](0,0);
+        eval.template apply<0, true, false>(M0, src, t+n);
+        eval.template apply<1, true, false>(M1, t+n, t);
+        eval.template apply<2, true, false>(A2, t, dst);
+        eval.template apply<1, true, false>(A1, t+n, t);
+        eval.template apply<0, true, false>(A0, src, t+n);
+        eval.template apply<1, true, true> (M1, t+n, t);
+        eval.template apply<2, true, true> (M2, t, dst);
+      }
+    else
+      AssertThrow(false, ExcNotImplemented());
+  };
+
+  if (size > 0)
+    {
+      Number t[2*Utilities::fixed_int_power<(size > 0 ? size : 1),dim>::value];
+      apply(t);
+    }
+  else
+    {
+      Threads::Mutex::ScopedLock lock(this->mutex);
+      tmp_array.resize_fast(n*2);
+      apply(tmp_array.begin());
+    }
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+void
+TensorProductMatrixSymmetricSumBase<dim,Number,size>
+::apply_inverse(Number *dst,
+                const Number *src) const
+{
+  const unsigned int n = size > 0 ? size : eigenvalues[0].size();
+  const int kernel_size = size > 0 ? size-1 : -1;
+  internal::EvaluatorTensorProduct<internal::evaluate_general,dim,kernel_size,kernel_size+1,Number>
+  eval(AlignedVector<Number>(), AlignedVector<Number>(),
+       AlignedVector<Number>(), mass_matrix[0].n_rows()-1, mass_matrix[0].n_rows());
+
+  const auto apply = [&](Number *t)
+  {
+    const Number *S0 = &eigenvectors[0](0,0);
+    const Number *S1 = &eigenvectors[dim > 1 ? 1 : 0](0,0);
+    const Number *S2 = &eigenvectors[dim-1](0,0);
+    const Number *lambda0 = eigenvalues[0].begin();
+    const Number *lambda1 = eigenvalues[dim > 1 ? 1 : 0].begin();
+    const Number *lambda2 = eigenvalues[dim-1].begin();
+
+    switch (dim)
+      {
+      case 1:
+        eval.template apply<0, true, false> (S0, src, t);
+        for (unsigned int i=0; i<n; ++i)
+          t[i] /= lambda0[i];
+        eval.template apply<0, false, false> (S0, t, dst);
+        break;
+
+      case 2:
+        eval.template apply<0, true, false> (S0, src, t);
+        eval.template apply<1, true, false> (S1, t, dst);
+        for (unsigned int i=0, c=0; i<n; ++i)
+          for (unsigned int j=0; j<n; ++j, ++c)
+            dst[c] /= (lambda1[i] + lambda0[j]);
+        eval.template apply<1, false, false> (S1, dst, t);
+        eval.template apply<0, false, false> (S0, t, dst);
+        break;
+
+      case 3:
+        eval.template apply<0, true, false> (S0, src, t);
+        eval.template apply<1, true, false> (S1, t, dst);
+        eval.template apply<2, true, false> (S2, dst, t);
+        for (unsigned int i=0, c=0; i<n; ++i)
+          for (unsigned int j=0; j<n; ++j)
+            for (unsigned int k=0; k<n; ++k, ++c)
+              t[c] /= (lambda2[i] + lambda1[j] + lambda0[k]);
+        eval.template apply<2, false, false> (S2, t, dst);
+        eval.template apply<1, false, false> (S1, dst, t);
+        eval.template apply<0, false, false> (S0, t, dst);
+        break;
+
+      default:
+        Assert(false, ExcNotImplemented());
+      }
+  };
+
+  if (size > 0)
+    {
+      Number t[Utilities::fixed_int_power<(size > 0 ? size : 1),dim>::value];
+      apply(t);
+    }
+  else
+    {
+      Threads::Mutex::ScopedLock lock(this->mutex);
+      tmp_array.resize_fast(Utilities::fixed_power<dim>(n));
+      apply(tmp_array.begin());
+    }
+}
+
+
 
 template <int dim, typename Number, int size>
 inline
@@ -224,57 +736,60 @@ TensorProductMatrixSymmetricSum<dim,Number,size>
 
 template <int dim, typename Number, int size>
 inline
-void
 TensorProductMatrixSymmetricSum<dim,Number,size>
-::reinit(const FullMatrix<Number> &mass_matrix,
-         const FullMatrix<Number> &derivative_matrix)
+::TensorProductMatrixSymmetricSum(const std::array<Table<2,Number>, dim> &mass_matrix,
+                                  const std::array<Table<2,Number>, dim> &derivative_matrix)
 {
-  Assert(size == -1 ||
-         (size > 0 && static_cast<unsigned int>(size) == mass_matrix.m()),
-         ExcDimensionMismatch(size, mass_matrix.m()));
-  AssertDimension(mass_matrix.m(), mass_matrix.n());
-  AssertDimension(mass_matrix.m(), derivative_matrix.m());
-  AssertDimension(mass_matrix.m(), derivative_matrix.n());
-
-  this->mass_matrix = mass_matrix;
-  this->derivative_matrix = derivative_matrix;
-
-  std::vector<Vector<Number> > eigenvecs(mass_matrix.m());
-  LAPACKFullMatrix<Number> mass_copy(mass_matrix.m(), mass_matrix.n());
-  LAPACKFullMatrix<Number> deriv_copy(derivative_matrix.m(), derivative_matrix.n());
-  mass_copy = mass_matrix;
-  deriv_copy = derivative_matrix;
-
-  deriv_copy.compute_generalized_eigenvalues_symmetric(mass_copy, eigenvecs);
-  AssertDimension(eigenvecs.size(), mass_matrix.m());
-  eigenvectors.reinit(mass_matrix.m(), mass_matrix.m());
-  for (unsigned int i=0; i<mass_matrix.m(); ++i)
-    for (unsigned int j=0; j<mass_matrix.n(); ++j)
-      eigenvectors(i,j) = eigenvecs[j][i];
-
-  eigenvalues.resize(mass_matrix.m());
-  for (unsigned int i=0; i<mass_matrix.m(); ++i)
-    eigenvalues[i] = deriv_copy.eigenvalue(i).real();
+  reinit(mass_matrix, derivative_matrix);
 }
 
 
 
 template <int dim, typename Number, int size>
 inline
-unsigned int
-TensorProductMatrixSymmetricSum<dim,Number,size>::m() const
+void
+TensorProductMatrixSymmetricSum<dim,Number,size>
+::reinit(const FullMatrix<Number> &mass_matrix,
+         const FullMatrix<Number> &derivative_matrix)
 {
-  return Utilities::fixed_power<dim>(mass_matrix.m());
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      this->mass_matrix[d] = mass_matrix;
+      this->derivative_matrix[d] = derivative_matrix;
+    }
+  this->check_sizes();
+
+  // the matrices are the same in all directions, so only compute the
+  // eigenvalues once
+  internal::TensorProductMatrix::spectral_assembly(this->mass_matrix[0],
+                                                   this->derivative_matrix[0],
+                                                   this->eigenvalues[0],
+                                                   this->eigenvectors[0]);
+  for (unsigned int d=1; d<dim; ++d)
+    {
+      this->eigenvalues[d] = this->eigenvalues[0];
+      this->eigenvectors[d] = this->eigenvectors[0];
+    }
 }
 
 
 
 template <int dim, typename Number, int size>
 inline
-unsigned int
-TensorProductMatrixSymmetricSum<dim,Number,size>::n() const
+void
+TensorProductMatrixSymmetricSum<dim,Number,size>
+::reinit(const std::array<Table<2,Number>, dim> &mass_matrix,
+         const std::array<Table<2,Number>, dim> &derivative_matrix)
 {
-  return Utilities::fixed_power<dim>(mass_matrix.n());
+  this->mass_matrix = mass_matrix;
+  this->derivative_matrix = derivative_matrix;
+  this->check_sizes();
+
+  for (unsigned int d=0; d<dim; ++d)
+    internal::TensorProductMatrix::spectral_assembly(this->mass_matrix[d],
+                                                     this->derivative_matrix[d],
+                                                     this->eigenvalues[d],
+                                                     this->eigenvectors[d]);
 }
 
 
@@ -286,9 +801,9 @@ TensorProductMatrixSymmetricSum<dim,Number,size>
 ::vmult(Vector<Number> &dst,
         const Vector<Number> &src) const
 {
-  AssertDimension(dst.size(), Utilities::fixed_power<dim>(eigenvalues.size()));
-  AssertDimension(src.size(), Utilities::fixed_power<dim>(eigenvalues.size()));
-  vmult(dst.begin(), src.begin());
+  AssertDimension(dst.size(), this->m());
+  AssertDimension(src.size(), this->n());
+  this->vmult(dst.begin(), src.begin());
 }
 
 
@@ -300,9 +815,39 @@ TensorProductMatrixSymmetricSum<dim,Number,size>
 ::apply_inverse(Vector<Number> &dst,
                 const Vector<Number> &src) const
 {
-  AssertDimension(dst.size(), Utilities::fixed_power<dim>(eigenvalues.size()));
-  AssertDimension(src.size(), Utilities::fixed_power<dim>(eigenvalues.size()));
-  apply_inverse(dst.begin(), src.begin());
+  AssertDimension(dst.size(), this->n());
+  AssertDimension(src.size(), this->m());
+  this->apply_inverse(dst.begin(), src.begin());
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
+::TensorProductMatrixSymmetricSum()
+{}
+
+
+
+template <int dim, typename Number, int size>
+inline
+TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
+::TensorProductMatrixSymmetricSum(const Table<2,VectorizedArray<Number> > &mass_matrix,
+                                  const Table<2,VectorizedArray<Number> > &derivative_matrix)
+{
+  reinit(mass_matrix, derivative_matrix);
+}
+
+
+
+template <int dim, typename Number, int size>
+inline
+TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
+::TensorProductMatrixSymmetricSum(const std::array<Table<2,VectorizedArray<Number> >, dim> &mass_matrix,
+                                  const std::array<Table<2,VectorizedArray<Number> >, dim> &derivative_matrix)
+{
+  reinit(mass_matrix, derivative_matrix);
 }
 
 
@@ -310,41 +855,26 @@ TensorProductMatrixSymmetricSum<dim,Number,size>
 template <int dim, typename Number, int size>
 inline
 void
-TensorProductMatrixSymmetricSum<dim,Number,size>
-::vmult(Number *dst,
-        const Number *src) const
+TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
+::reinit(const Table<2,VectorizedArray<Number> > &mass_matrix,
+         const Table<2,VectorizedArray<Number> > &derivative_matrix)
 {
-  Threads::Mutex::ScopedLock lock(this->mutex);
-  const unsigned int n = Utilities::fixed_power<dim>(size > 0 ? size : eigenvalues.size());
-  tmp_array.resize_fast(n*2);
-  const int kernel_size = size > 0 ? size-1 : -1;
-  internal::EvaluatorTensorProduct<internal::evaluate_general,dim,kernel_size,kernel_size+1,Number>
-  eval(AlignedVector<Number>(), AlignedVector<Number>(),
-       AlignedVector<Number>(), mass_matrix.m()-1, mass_matrix.m());
-  const Number *A = &derivative_matrix(0,0);
-  const Number *M = &mass_matrix(0,0);
-  Number *t = tmp_array.begin();
-  if (dim == 1)
-    eval.template apply<0, true, false>(A, src, dst);
-  else if (dim == 2)
+  for (unsigned int d=0; d<dim; ++d)
     {
-      eval.template apply<0, true, false>(M, src, t);
-      eval.template apply<1, true, false>(A, t, dst);
-      eval.template apply<0, true, false>(A, src, t);
-      eval.template apply<1, true, true> (M, t, dst);
+      this->mass_matrix[d] = mass_matrix;
+      this->derivative_matrix[d] = derivative_matrix;
     }
-  else if (dim == 3)
+  this->check_sizes();
+
+  internal::TensorProductMatrix::spectral_assembly(this->mass_matrix[0],
+                                                   this->derivative_matrix[0],
+                                                   this->eigenvalues[0],
+                                                   this->eigenvectors[0]);
+  for (unsigned int d=1; d<dim; ++d)
     {
-      eval.template apply<0, true, false>(M, src, t+n);
-      eval.template apply<1, true, false>(M, t+n, t);
-      eval.template apply<2, true, false>(A, t, dst);
-      eval.template apply<1, true, false>(A, t+n, t);
-      eval.template apply<0, true, false>(A, src, t+n);
-      eval.template apply<1, true, true> (M, t+n, t);
-      eval.template apply<2, true, true> (M, t, dst);
+      this->eigenvalues[d] = this->eigenvalues[0];
+      this->eigenvectors[d] = this->eigenvectors[0];
     }
-  else
-    AssertThrow(false, ExcNotImplemented());
 }
 
 
@@ -352,55 +882,19 @@ TensorProductMatrixSymmetricSum<dim,Number,size>
 template <int dim, typename Number, int size>
 inline
 void
-TensorProductMatrixSymmetricSum<dim,Number,size>
-::apply_inverse(Number *dst,
-                const Number *src) const
+TensorProductMatrixSymmetricSum<dim,VectorizedArray<Number>,size>
+::reinit(const std::array<Table<2,VectorizedArray<Number> >, dim> &mass_matrix,
+         const std::array<Table<2,VectorizedArray<Number> >, dim> &derivative_matrix)
 {
-  Threads::Mutex::ScopedLock lock(this->mutex);
-  const unsigned int n = size > 0 ? size : eigenvalues.size();
-  tmp_array.resize_fast(Utilities::fixed_power<dim>(n));
-  const int kernel_size = size > 0 ? size-1 : -1;
-  internal::EvaluatorTensorProduct<internal::evaluate_general,dim,kernel_size,kernel_size+1,Number>
-  eval(AlignedVector<Number>(), AlignedVector<Number>(),
-       AlignedVector<Number>(), mass_matrix.m()-1, mass_matrix.m());
-  const Number *S = &eigenvectors(0,0);
-  Number *t = tmp_array.begin();
+  this->mass_matrix = mass_matrix;
+  this->derivative_matrix = derivative_matrix;
+  this->check_sizes();
 
-  switch (dim)
-    {
-    case 1:
-      eval.template apply<0, true, false> (S, src, t);
-      for (unsigned int i=0; i<n; ++i)
-        t[i] /= eigenvalues[i];
-      eval.template apply<0, false, false> (S, t, dst);
-      break;
-
-    case 2:
-      eval.template apply<0, true, false> (S, src, t);
-      eval.template apply<1, true, false> (S, t, dst);
-      for (unsigned int i=0, c=0; i<n; ++i)
-        for (unsigned int j=0; j<n; ++j, ++c)
-          dst[c] /= (eigenvalues[i] + eigenvalues[j]);
-      eval.template apply<1, false, false> (S, dst, t);
-      eval.template apply<0, false, false> (S, t, dst);
-      break;
-
-    case 3:
-      eval.template apply<0, true, false> (S, src, t);
-      eval.template apply<1, true, false> (S, t, dst);
-      eval.template apply<2, true, false> (S, dst, t);
-      for (unsigned int i=0, c=0; i<n; ++i)
-        for (unsigned int j=0; j<n; ++j)
-          for (unsigned int k=0; k<n; ++k, ++c)
-            t[c] /= (eigenvalues[i] + eigenvalues[j] + eigenvalues[k]);
-      eval.template apply<2, false, false> (S, t, dst);
-      eval.template apply<1, false, false> (S, dst, t);
-      eval.template apply<0, false, false> (S, t, dst);
-      break;
-
-    default:
-      Assert(false, ExcNotImplemented());
-    }
+  for (unsigned int d=0; d<dim; ++d)
+    internal::TensorProductMatrix::spectral_assembly(this->mass_matrix[d],
+                                                     this->derivative_matrix[d],
+                                                     this->eigenvalues[d],
+                                                     this->eigenvectors[d]);
 }
 
 
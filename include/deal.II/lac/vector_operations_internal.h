@@ -827,6 +827,87 @@ namespace internal
       const Number *X;
     };
 
+    // a small array of results with the operations needed by the
+    // accumulation loops below, used for computing several reductions in the
+    // same loop
+    template <typename Number, unsigned int n_components>
+    struct MultiResult
+    {
+      MultiResult ()
+      {
+        for (unsigned int c=0; c<n_components; ++c)
+          values[c] = Number();
+      }
+
+      MultiResult &operator += (const MultiResult &other)
+      {
+        for (unsigned int c=0; c<n_components; ++c)
+          values[c] += other.values[c];
+        return *this;
+      }
+
+      MultiResult operator + (const MultiResult &other) const
+      {
+        MultiResult result (*this);
+        result += other;
+        return result;
+      }
+
+      Number values[n_components];
+    };
+
+    // computes the inner products of X with up to max_vectors vectors Y[v] in
+    // one sweep, loading each entry of X only once
+    template <typename Number>
+    struct MultiDot
+    {
+      static const bool vectorizes = VectorizedArray<Number>::n_array_elements > 1;
+
+      static const unsigned int max_vectors = 4;
+
+      typedef MultiResult<Number,max_vectors> ResultType;
+
+      MultiDot(const Number        *X,
+               const Number *const *Y,
+               const unsigned int   n_vectors)
+        :
+        X(X),
+        n_vectors(n_vectors)
+      {
+        Assert (n_vectors <= max_vectors, ExcIndexRange(n_vectors, 0, max_vectors+1));
+        for (unsigned int v=0; v<n_vectors; ++v)
+          this->Y[v] = Y[v];
+      }
+
+      ResultType
+      operator() (const size_type i) const
+      {
+        ResultType result;
+        const Number x = X[i];
+        for (unsigned int v=0; v<n_vectors; ++v)
+          result.values[v] = x * Number(numbers::NumberTraits<Number>::conjugate(Y[v][i]));
+        return result;
+      }
+
+      MultiResult<VectorizedArray<Number>,max_vectors>
+      do_vectorized(const size_type i) const
+      {
+        MultiResult<VectorizedArray<Number>,max_vectors> result;
+        VectorizedArray<Number> x, y;
+        x.load(X+i);
+        for (unsigned int v=0; v<n_vectors; ++v)
+          {
+            y.load(Y[v]+i);
+            result.values[v] = x * y;
+          }
+        return result;
+      }
+
+      const Number *X;
+      const Number *Y[max_vectors];
+      const unsigned int n_vectors;
+    };
+
     template <typename Number>
     struct AddAndDot
     {
@@ -1136,6 +1217,63 @@ namespace internal
 
 
 
+    // same as above for operations that compute several results at once,
+    // such as MultiDot. each component is accumulated in exactly the same
+    // way as a single result in the function above
+    template <typename Operation, typename Number, unsigned int n_components>
+    void
+    accumulate_regular(const Operation &op,
+                       size_type       &n_chunks,
+                       size_type       &index,
+                       MultiResult<Number,n_components> (&outer_results)[vector_accumulation_recursion_threshold],
+                       std::integral_constant<bool, true>)
+    {
+      const unsigned int nvecs = VectorizedArray<Number>::n_array_elements;
+      const size_type regular_chunks = n_chunks/nvecs;
+      for (size_type i=0; i<regular_chunks; ++i)
+        {
+          MultiResult<VectorizedArray<Number>,n_components> r0 = op.do_vectorized(index);
+          MultiResult<VectorizedArray<Number>,n_components> r1 = op.do_vectorized(index+nvecs);
+          MultiResult<VectorizedArray<Number>,n_components> r2 = op.do_vectorized(index+2*nvecs);
+          MultiResult<VectorizedArray<Number>,n_components> r3 = op.do_vectorized(index+3*nvecs);
+          index += nvecs*4;
+          for (size_type j=1; j<8; ++j, index += nvecs*4)
+            {
+              r0 += op.do_vectorized(index);
+              r1 += op.do_vectorized(index+nvecs);
+              r2 += op.do_vectorized(index+2*nvecs);
+              r3 += op.do_vectorized(index+3*nvecs);
+            }
+          r0 += r1;
+          r2 += r3;
+          r0 += r2;
+          for (unsigned int v=0; v<nvecs; ++v)
+            for (unsigned int c=0; c<n_components; ++c)
+              outer_results[i*nvecs+v].values[c] = r0.values[c][v];
+        }
+
+      Assert (16 % nvecs == 0,
+              ExcInternalError());
+      if (n_chunks % nvecs != 0)
+        {
+          MultiResult<VectorizedArray<Number>,n_components> r0, r1;
+          const size_type start_irreg = regular_chunks * nvecs;
+          for (size_type c=start_irreg; c<n_chunks; ++c)
+            for (size_type j=0; j<32; j+=2*nvecs, index+=2*nvecs)
+              {
+                r0 += op.do_vectorized(index);
+                r1 += op.do_vectorized(index+nvecs);
+              }
+          r0 += r1;
+          for (unsigned int v=0; v<nvecs; ++v)
+            for (unsigned int c=0; c<n_components; ++c)
+              outer_results[start_irreg+v].values[c] = r0.values[c][v];
+          n_chunks = start_irreg + nvecs;
+        }
+    }
+
+
+
 #ifdef DEAL_II_WITH_THREADS
     /**
      * This struct takes the loop range from the tbb parallel for loop and
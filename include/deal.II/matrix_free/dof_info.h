@@ -155,6 +155,18 @@ namespace internal
                              ConstraintValues<double> &constraint_values,
                              bool                            &cell_at_boundary);
 
+      /**
+       * Read the indices of a cell owned by another MPI process that is
+       * accessed on the exterior side of a face by FEFaceEvaluation. The
+       * indices are stored without resolving constraints in the field @p
+       * ghost_cell_dof_indices in lexicographic order. Indices owned by other
+       * processors get a temporary number in the same way as in @p
+       * read_dof_indices, and must be converted by a subsequent call to @p
+       * assign_ghosts.
+       */
+      void read_ghost_cell_dof_indices (const std::vector<types::global_dof_index> &local_indices,
+                                        const std::vector<unsigned int> &lexicographic_inv);
+
       /**
        * This method assigns the correct indices to ghost indices from the
        * temporary numbering employed by the @p read_dof_indices function. The
@@ -366,6 +378,16 @@ namespace internal
        */
       std::vector<unsigned int> plain_dof_indices;
 
+      /**
+       * Stores the indices of the degrees of freedom on the cells owned by
+       * other MPI processes that are accessed on the exterior side of faces
+       * with FEFaceEvaluation, using <code>dofs_per_cell[0]</code> entries
+       * per ghost cell in lexicographic order. The indices are stored without
+       * resolving constraints and refer to the local numbering of vector
+       * entries including ghosts.
+       */
+      std::vector<unsigned int> ghost_cell_dof_indices;
+
       /**
        * Stores the dimension of the underlying DoFHandler. Since the indices
        * are not templated, this is the variable that makes the dimension
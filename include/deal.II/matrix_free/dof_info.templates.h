@@ -139,6 +139,7 @@ namespace internal
       constrained_dofs (dof_info_in.constrained_dofs),
       row_starts_plain_indices (dof_info_in.row_starts_plain_indices),
       plain_dof_indices (dof_info_in.plain_dof_indices),
+      ghost_cell_dof_indices (dof_info_in.ghost_cell_dof_indices),
       dimension (dof_info_in.dimension),
       n_components (dof_info_in.n_components),
       dofs_per_cell (dof_info_in.dofs_per_cell),
@@ -166,6 +167,7 @@ namespace internal
       n_components = 0;
       row_starts_plain_indices.clear();
       plain_dof_indices.clear();
+      ghost_cell_dof_indices.clear();
       store_plain_indices = false;
       cell_active_fe_index.clear();
       max_fe_index = 0;
@@ -329,6 +331,35 @@ no_constraint:
 
 
 
+    void
+    DoFInfo::read_ghost_cell_dof_indices
+    (const std::vector<types::global_dof_index> &local_indices,
+     const std::vector<unsigned int>            &lexicographic_inv)
+    {
+      Assert (vector_partitioner.get() != nullptr, ExcInternalError());
+      Assert (cell_active_fe_index.empty(), ExcNotImplemented());
+      const types::global_dof_index first_owned = vector_partitioner->local_range().first;
+      const types::global_dof_index last_owned  = vector_partitioner->local_range().second;
+      const unsigned int n_owned = last_owned - first_owned;
+      AssertDimension (local_indices.size(), dofs_per_cell[0]);
+
+      for (unsigned int i=0; i<dofs_per_cell[0]; ++i)
+        {
+          const types::global_dof_index current_dof =
+            local_indices[lexicographic_inv[i]];
+          if (current_dof < first_owned || current_dof >= last_owned)
+            {
+              ghost_dofs.push_back (current_dof);
+              ghost_cell_dof_indices.push_back (n_owned + ghost_dofs.size() - 1);
+            }
+          else
+            ghost_cell_dof_indices.push_back (static_cast<unsigned int>
+                                              (current_dof - first_owned));
+        }
+    }
+
+
+
     void
     DoFInfo::assign_ghosts (const std::vector<unsigned int> &boundary_cells)
     {
@@ -424,6 +455,11 @@ no_constraint:
                     }
                 }
             }
+
+          // finally the indices of the cells on the exterior side of faces
+          for (unsigned int &index : ghost_cell_dof_indices)
+            if (index >= n_owned)
+              index = n_owned + ghost_numbering[index - n_owned];
         }
 
       std::vector<types::global_dof_index> empty;
@@ -1928,6 +1964,7 @@ not_connect:
       memory += MemoryConsumption::memory_consumption (dof_indices);
       memory += MemoryConsumption::memory_consumption (row_starts_plain_indices);
       memory += MemoryConsumption::memory_consumption (plain_dof_indices);
+      memory += MemoryConsumption::memory_consumption (ghost_cell_dof_indices);
       memory += MemoryConsumption::memory_consumption (constraint_indicator);
       memory += MemoryConsumption::memory_consumption (*vector_partitioner);
       return memory;
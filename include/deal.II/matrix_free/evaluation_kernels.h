@@ -870,6 +870,232 @@ namespace internal
       }
   }
 
+
+
+
+  /**
+   * This struct implements the evaluation of function values and gradients
+   * on faces of tensor-product finite elements. The operation is split into
+   * two steps: First, the cell values are interpolated to the face by the
+   * function interpolate(), which computes the values of the degrees of
+   * freedom restricted to the face and, if requested, their derivative in
+   * the direction normal to the face. In a second step, evaluate_in_face()
+   * applies the (dim-1)-dimensional tensor product kernels to get values and
+   * gradients in the face quadrature points. The integration is implemented
+   * as the transpose of these operations.
+   *
+   * The face degrees of freedom of each component are stored contiguously
+   * with <code>2*dofs_per_face</code> entries, the values followed by the
+   * normal derivatives. The gradients in quadrature points are given in the
+   * face-local coordinate system, i.e., the first dim-1 entries of
+   * @p gradients_quad refer to the derivatives along the face coordinates
+   * and the last entry to the derivative in normal direction, all with
+   * respect to the reference coordinates of the cell.
+   */
+  template <int dim, int fe_degree, int n_q_points_1d, int n_components,
+            typename Number>
+  struct FEFaceEvaluationImpl
+  {
+    static
+    void evaluate_in_face (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &data,
+                           VectorizedArray<Number> *values_dofs,
+                           VectorizedArray<Number> *values_quad[],
+                           VectorizedArray<Number> *gradients_quad[][dim],
+                           VectorizedArray<Number> *scratch_data,
+                           const bool               evaluate_values,
+                           const bool               evaluate_gradients)
+    {
+      typedef EvaluatorTensorProduct<evaluate_general, (dim>1?dim-1:1), fe_degree,
+              n_q_points_1d, VectorizedArray<Number> > Eval;
+      Eval eval (data.shape_values, data.shape_gradients, data.shape_hessians,
+                 data.fe_degree, data.n_q_points_1d);
+
+      const unsigned int dofs_per_face = data.dofs_per_face;
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          VectorizedArray<Number> *face_dofs = values_dofs + 2*c*dofs_per_face;
+          switch (dim)
+            {
+            case 1:
+              if (evaluate_values)
+                values_quad[c][0] = face_dofs[0];
+              if (evaluate_gradients)
+                gradients_quad[c][dim-1][0] = face_dofs[dofs_per_face];
+              break;
+            case 2:
+              if (evaluate_values)
+                eval.template values<0,true,false>(face_dofs, values_quad[c]);
+              if (evaluate_gradients)
+                {
+                  eval.template gradients<0,true,false>(face_dofs, gradients_quad[c][0]);
+                  eval.template values<0,true,false>(face_dofs+dofs_per_face,
+                                                     gradients_quad[c][dim-1]);
+                }
+              break;
+            case 3:
+              if (evaluate_gradients)
+                {
+                  eval.template gradients<0,true,false>(face_dofs, scratch_data);
+                  eval.template values<1,true,false>(scratch_data, gradients_quad[c][0]);
+                  eval.template values<0,true,false>(face_dofs+dofs_per_face, scratch_data);
+                  eval.template values<1,true,false>(scratch_data, gradients_quad[c][dim-1]);
+                }
+              eval.template values<0,true,false>(face_dofs, scratch_data);
+              if (evaluate_gradients)
+                eval.template gradients<1,true,false>(scratch_data, gradients_quad[c][1]);
+              if (evaluate_values)
+                eval.template values<1,true,false>(scratch_data, values_quad[c]);
+              break;
+            default:
+              AssertThrow(false, ExcNotImplemented());
+            }
+        }
+    }
+
+    static
+    void integrate_in_face (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &data,
+                            VectorizedArray<Number> *values_dofs,
+                            VectorizedArray<Number> *values_quad[],
+                            VectorizedArray<Number> *gradients_quad[][dim],
+                            VectorizedArray<Number> *scratch_data,
+                            const bool               integrate_values,
+                            const bool               integrate_gradients)
+    {
+      typedef EvaluatorTensorProduct<evaluate_general, (dim>1?dim-1:1), fe_degree,
+              n_q_points_1d, VectorizedArray<Number> > Eval;
+      Eval eval (data.shape_values, data.shape_gradients, data.shape_hessians,
+                 data.fe_degree, data.n_q_points_1d);
+
+      const unsigned int dofs_per_face = data.dofs_per_face;
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          VectorizedArray<Number> *face_dofs = values_dofs + 2*c*dofs_per_face;
+          switch (dim)
+            {
+            case 1:
+              face_dofs[0] = integrate_values ? values_quad[c][0] :
+                             VectorizedArray<Number>();
+              if (integrate_gradients)
+                face_dofs[dofs_per_face] = gradients_quad[c][dim-1][0];
+              break;
+            case 2:
+              if (integrate_values)
+                eval.template values<0,false,false>(values_quad[c], face_dofs);
+              if (integrate_gradients)
+                {
+                  if (integrate_values)
+                    eval.template gradients<0,false,true>(gradients_quad[c][0], face_dofs);
+                  else
+                    eval.template gradients<0,false,false>(gradients_quad[c][0], face_dofs);
+                  eval.template values<0,false,false>(gradients_quad[c][dim-1],
+                                                      face_dofs+dofs_per_face);
+                }
+              break;
+            case 3:
+              if (integrate_gradients)
+                {
+                  eval.template gradients<0,false,false>(gradients_quad[c][0], scratch_data);
+                  if (integrate_values)
+                    eval.template values<0,false,true>(values_quad[c], scratch_data);
+                  eval.template values<1,false,false>(scratch_data, face_dofs);
+                  eval.template values<0,false,false>(gradients_quad[c][1], scratch_data);
+                  eval.template gradients<1,false,true>(scratch_data, face_dofs);
+                  eval.template values<0,false,false>(gradients_quad[c][dim-1], scratch_data);
+                  eval.template values<1,false,false>(scratch_data, face_dofs+dofs_per_face);
+                }
+              else
+                {
+                  eval.template values<0,false,false>(values_quad[c], scratch_data);
+                  eval.template values<1,false,false>(scratch_data, face_dofs);
+                }
+              break;
+            default:
+              AssertThrow(false, ExcNotImplemented());
+            }
+        }
+    }
+
+    /**
+     * Interpolate between the degrees of freedom on the cell and the face
+     * degrees of freedom of face @p face_no (values and, if @p
+     * with_normal_derivative is set, normal derivatives). For @p
+     * cell_to_face set to true, the cell values in @p cell_dofs are
+     * restricted to the face and written into @p face_dofs, otherwise the
+     * transpose operation is performed and the result written into @p
+     * cell_dofs (overwriting the previous content).
+     */
+    static
+    void interpolate (const MatrixFreeFunctions::ShapeInfo<VectorizedArray<Number>> &data,
+                      const unsigned int       face_no,
+                      const bool               cell_to_face,
+                      const bool               with_normal_derivative,
+                      VectorizedArray<Number> *cell_dofs,
+                      VectorizedArray<Number> *face_dofs)
+    {
+      AssertIndexRange (face_no, 2*dim);
+      const VectorizedArray<Number> *shape_data =
+        data.shape_data_on_face[face_no%2].begin();
+      const int n_dofs_1d = data.fe_degree+1;
+      const unsigned int dofs_per_cell = Utilities::fixed_power<dim>(data.fe_degree+1);
+      const unsigned int dofs_per_face = data.dofs_per_face;
+      for (unsigned int c=0; c<n_components; ++c)
+        {
+          VectorizedArray<Number> *in_cell = cell_dofs + c*dofs_per_cell;
+          VectorizedArray<Number> *in_face = face_dofs + 2*c*dofs_per_face;
+          switch (face_no/2)
+            {
+            case 0:
+              interpolate_direction<0>(shape_data, cell_to_face,
+                                       with_normal_derivative,
+                                       n_dofs_1d, in_cell, in_face);
+              break;
+            case 1:
+              interpolate_direction<1>(shape_data, cell_to_face,
+                                       with_normal_derivative,
+                                       n_dofs_1d, in_cell, in_face);
+              break;
+            case 2:
+              interpolate_direction<2>(shape_data, cell_to_face,
+                                       with_normal_derivative,
+                                       n_dofs_1d, in_cell, in_face);
+              break;
+            default:
+              Assert (false, ExcInternalError());
+            }
+        }
+    }
+
+  private:
+    template <int face_direction>
+    static
+    void interpolate_direction (const VectorizedArray<Number> *shape_data,
+                                const bool                     cell_to_face,
+                                const bool                     with_normal_derivative,
+                                const int                      n_dofs_1d,
+                                VectorizedArray<Number>       *cell_dofs,
+                                VectorizedArray<Number>       *face_dofs)
+    {
+      if (cell_to_face)
+        {
+          if (with_normal_derivative)
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,face_direction,true,false,1>
+            (shape_data, cell_dofs, face_dofs, n_dofs_1d);
+          else
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,face_direction,true,false,0>
+            (shape_data, cell_dofs, face_dofs, n_dofs_1d);
+        }
+      else
+        {
+          if (with_normal_derivative)
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,face_direction,false,false,1>
+            (shape_data, face_dofs, cell_dofs, n_dofs_1d);
+          else
+            apply_tensor_product_face<dim,fe_degree,VectorizedArray<Number>,face_direction,false,false,0>
+            (shape_data, face_dofs, cell_dofs, n_dofs_1d);
+        }
+    }
+  };
+
 } // end of namespace internal
 
 
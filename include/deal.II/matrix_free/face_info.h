@@ -0,0 +1,192 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_face_info_h
+#define dealii_matrix_free_face_info_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/types.h>
+
+#include <vector>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Data type for information about the batches build for vectorization of
+     * the face integrals. The setup of the batches for the faces is
+     * independent of the cells, and thus, we must store the relation to the
+     * cell indexing for accessing the degrees of freedom.
+     *
+     * The cells are identified by the number they obtain in the cell loop of
+     * MatrixFree, i.e., <code>macro_cell * vectorization_width + lane</code>.
+     * Cells owned by another MPI process that are visited on the exterior
+     * side of a face get the numbers <code>n_macro_cells *
+     * vectorization_width + g</code> where @p g is the index into the list
+     * of ghost cells stored by MatrixFree. Unfilled lanes of a batch are
+     * marked by numbers::invalid_unsigned_int.
+     *
+     * Interior and exterior faces are defined such that the normal vector
+     * points from the interior side to the exterior side.
+     */
+    template <int vectorization_width>
+    struct FaceToCellTopology
+    {
+      /**
+       * Indices of the faces in the current face batch as compared to the
+       * numbers of the cells on the logical "interior" side of the face which
+       * is aligned to the direction of FEFaceEvaluation::get_normal_vector().
+       */
+      unsigned int cells_interior[vectorization_width];
+
+      /**
+       * Indices of the faces in the current face batch as compared to the
+       * numbers of the cells on the logical "exterior" side of the face which
+       * is aligned to the opposite direction of
+       * FEFaceEvaluation::get_normal_vector(). Note that the distinction into
+       * interior and exterior faces is purely logical and refers to the
+       * direction of the normal only. For boundary faces, these indices are
+       * set to numbers::invalid_unsigned_int.
+       */
+      unsigned int cells_exterior[vectorization_width];
+
+      /**
+       * Index of the face between 0 and GeometryInfo::faces_per_cell within
+       * the cells on the "interior" side of the faces.
+       */
+      unsigned char interior_face_no;
+
+      /**
+       * Index of the face between 0 and GeometryInfo::faces_per_cell within
+       * the cells on the "exterior" side of the faces. For a boundary face,
+       * this entry is not used.
+       */
+      unsigned char exterior_face_no;
+
+      /**
+       * The boundary id of the face. Only set for boundary faces, where all
+       * lanes in a batch share the same boundary id.
+       */
+      types::boundary_id boundary_id;
+
+      /**
+       * Return the number of filled lanes in this batch, assuming that the
+       * unused lanes are at the end of the batch.
+       */
+      unsigned int n_filled_lanes () const
+      {
+        unsigned int n = 0;
+        while (n < vectorization_width &&
+               cells_interior[n] != numbers::invalid_unsigned_int)
+          ++n;
+        return n;
+      }
+    };
+
+
+
+    /**
+     * A data structure that holds the connectivity between the faces and the
+     * cells of the matrix-free loops. The faces are grouped into batches of
+     * @p vectorization_width entries that share the same local face numbers
+     * on the interior and exterior side (or the same boundary id) and are
+     * stored in the following order:
+     * <ol>
+     * <li> inner faces that do not touch any ghosted vector entry,
+     * <li> inner faces that need ghosted vector entries (either because the
+     * exterior cell is owned by another MPI process or because one of the
+     * cells has degrees of freedom shared with another process),
+     * <li> boundary faces that do not touch any ghosted vector entry,
+     * <li> boundary faces that need ghosted vector entries.
+     * </ol>
+     * This ordering allows MatrixFree::loop() to overlap the ghost exchange
+     * with computations on faces in the same way as for cells.
+     */
+    template <int vectorization_width>
+    struct FaceInfo
+    {
+      /**
+       * Constructor.
+       */
+      FaceInfo ()
+      {
+        clear();
+      }
+
+      /**
+       * Clear all data fields to be in a state similar to after having
+       * called the default constructor.
+       */
+      void clear ()
+      {
+        faces.clear();
+        n_inner_face_batches = 0;
+        n_inner_face_batches_ghosted = 0;
+        n_boundary_face_batches = 0;
+        n_boundary_face_batches_ghosted = 0;
+      }
+
+      /**
+       * Return the memory consumption of the present data structure.
+       */
+      std::size_t memory_consumption () const
+      {
+        return sizeof(*this) +
+               faces.capacity()*sizeof(FaceToCellTopology<vectorization_width>);
+      }
+
+      /**
+       * Vectorized storage of interior and boundary face batches, in the
+       * order described in the documentation of this class.
+       */
+      std::vector<FaceToCellTopology<vectorization_width> > faces;
+
+      /**
+       * The total number of batches of inner faces.
+       */
+      unsigned int n_inner_face_batches;
+
+      /**
+       * The number of inner face batches that need ghosted vector entries,
+       * placed at the end of the range of inner face batches.
+       */
+      unsigned int n_inner_face_batches_ghosted;
+
+      /**
+       * The total number of batches of boundary faces.
+       */
+      unsigned int n_boundary_face_batches;
+
+      /**
+       * The number of boundary face batches that need ghosted vector entries,
+       * placed at the end of the range of boundary face batches.
+       */
+      unsigned int n_boundary_face_batches_ghosted;
+    };
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -0,0 +1,431 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+#ifndef dealii_matrix_free_face_setup_internal_h
+#define dealii_matrix_free_face_setup_internal_h
+
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/distributed/tria_base.h>
+#include <deal.II/matrix_free/helper_functions.h>
+#include <deal.II/matrix_free/face_info.h>
+
+#include <algorithm>
+#include <map>
+
+
+DEAL_II_NAMESPACE_OPEN
+
+
+
+namespace internal
+{
+  namespace MatrixFreeFunctions
+  {
+    /**
+     * Return whether the face between a cell owned by the MPI process @p
+     * my_pid and a cell owned by the MPI process @p neighbor_pid should be
+     * computed on @p my_pid. Rather than assigning all faces to the process
+     * with the lower rank, we alternate between the lower and the higher rank
+     * depending on the parity of the sum of ranks, which balances the work
+     * better between the processes.
+     */
+    inline
+    bool
+    face_is_computed_on_this_process (const unsigned int my_pid,
+                                      const unsigned int neighbor_pid)
+    {
+      Assert (my_pid != neighbor_pid, ExcInternalError());
+      return (my_pid < neighbor_pid) == ((my_pid + neighbor_pid) % 2 == 0);
+    }
+
+
+
+    /**
+     * A class that collects the faces of the cells handled by MatrixFree and
+     * groups them into batches for vectorized face integrals. The setup is
+     * done in two stages: Before the cells are reordered by MatrixFree, the
+     * cells owned by other MPI processes that are accessed on the exterior
+     * side of faces are collected in initialize(), such that their indices
+     * can be read into the DoFInfo structures. Once the final numbering of
+     * the cells is known, generate_faces() builds the face batches.
+     *
+     * Only faces between cells of the same refinement level are supported,
+     * i.e., meshes without hanging nodes, and all faces must be in standard
+     * orientation.
+     */
+    template <int dim>
+    struct FaceSetup
+    {
+      /**
+       * Constructor.
+       */
+      FaceSetup ();
+
+      /**
+       * Collect the cells on remote MPI processes next to the locally owned
+       * cells given by @p cells (a list of level and index pairs) for the
+       * faces that are computed on the current process. If @p mg_level is
+       * numbers::invalid_unsigned_int, the active cells are considered,
+       * otherwise the cells on the given level.
+       */
+      void initialize (const dealii::Triangulation<dim>                         &triangulation,
+                       const unsigned int                                        mg_level,
+                       const unsigned int                                        my_pid,
+                       const std::vector<std::pair<unsigned int,unsigned int> > &cells);
+
+      /**
+       * Build the face batches based on the final ordering of the cells in
+       * @p cell_level_index (with vectorization_width entries per macro
+       * cell) and the number of filled lanes in each macro cell given by @p
+       * n_filled_lanes. The ghost cells collected by initialize() get the
+       * numbers following the locally owned cells.
+       */
+      template <int vectorization_width>
+      void generate_faces (const std::vector<std::pair<unsigned int,unsigned int> > &cell_level_index,
+                           const std::vector<unsigned int>                          &n_filled_lanes,
+                           const SizeInfo                                           &size_info,
+                           FaceInfo<vectorization_width>                            &face_info) const;
+
+      /**
+       * Return the MPI process that owns the given cell.
+       */
+      unsigned int
+      get_cell_owner (const typename dealii::Triangulation<dim>::cell_iterator &cell) const;
+
+      /**
+       * Return the neighbor of the given cell behind face @p face_no,
+       * checking that the face is supported by the face integrals.
+       */
+      typename dealii::Triangulation<dim>::cell_iterator
+      get_neighbor (const typename dealii::Triangulation<dim>::cell_iterator &cell,
+                    const unsigned int face_no) const;
+
+      /**
+       * Pointer to the triangulation.
+       */
+      const dealii::Triangulation<dim> *triangulation;
+
+      /**
+       * The level for which the faces are set up, or
+       * numbers::invalid_unsigned_int for the active cells.
+       */
+      unsigned int mg_level;
+
+      /**
+       * The rank of the present process.
+       */
+      unsigned int my_pid;
+
+      /**
+       * Stores whether the triangulation is distributed among several
+       * processes.
+       */
+      bool is_parallel;
+
+      /**
+       * The list of cells owned by other processes that are accessed on the
+       * exterior side of faces computed on the present process, given as
+       * pairs of level and index.
+       */
+      std::vector<std::pair<unsigned int,unsigned int> > ghost_cells;
+    };
+
+
+
+    /* ------------------- inline/template functions ---------------------- */
+
+    template <int dim>
+    FaceSetup<dim>::FaceSetup ()
+      :
+      triangulation (nullptr),
+      mg_level (numbers::invalid_unsigned_int),
+      my_pid (0),
+      is_parallel (false)
+    {}
+
+
+
+    template <int dim>
+    unsigned int
+    FaceSetup<dim>::get_cell_owner (const typename dealii::Triangulation<dim>::cell_iterator &cell) const
+    {
+      if (is_parallel == false)
+        return my_pid;
+      const unsigned int owner = (mg_level == numbers::invalid_unsigned_int) ?
+                                 cell->subdomain_id() : cell->level_subdomain_id();
+      Assert (owner != numbers::artificial_subdomain_id &&
+              owner != numbers::invalid_subdomain_id,
+              ExcMessage("Face integrals need the cells across processor "
+                         "boundaries to be present as ghost cells. For "
+                         "level cells, use the flag "
+                         "construct_multigrid_hierarchy."));
+      return owner;
+    }
+
+
+
+    template <int dim>
+    typename dealii::Triangulation<dim>::cell_iterator
+    FaceSetup<dim>::get_neighbor (const typename dealii::Triangulation<dim>::cell_iterator &cell,
+                                  const unsigned int face_no) const
+    {
+      Assert (!cell->at_boundary(face_no), ExcInternalError());
+      const typename dealii::Triangulation<dim>::cell_iterator
+      neighbor = cell->neighbor(face_no);
+      Assert (neighbor->level() == cell->level() &&
+              (mg_level != numbers::invalid_unsigned_int || neighbor->active()),
+              ExcMessage("Face integrals in MatrixFree are only implemented "
+                         "for meshes without hanging nodes."));
+      Assert (dim < 3 ||
+              (cell->face_orientation(face_no) == true &&
+               cell->face_flip(face_no) == false &&
+               cell->face_rotation(face_no) == false &&
+               neighbor->face_orientation(cell->neighbor_of_neighbor(face_no)) == true &&
+               neighbor->face_flip(cell->neighbor_of_neighbor(face_no)) == false &&
+               neighbor->face_rotation(cell->neighbor_of_neighbor(face_no)) == false),
+              ExcMessage("Face integrals in MatrixFree are only implemented "
+                         "for faces in standard orientation."));
+      return neighbor;
+    }
+
+
+
+    template <int dim>
+    void
+    FaceSetup<dim>::initialize
+    (const dealii::Triangulation<dim>                         &tria,
+     const unsigned int                                        level,
+     const unsigned int                                        pid,
+     const std::vector<std::pair<unsigned int,unsigned int> > &cells)
+    {
+      triangulation = &tria;
+      mg_level = level;
+      my_pid = pid;
+      is_parallel = (dynamic_cast<const parallel::Triangulation<dim> *>(&tria)
+                     != nullptr);
+      ghost_cells.clear();
+      if (is_parallel == false)
+        return;
+
+      for (unsigned int i=0; i<cells.size(); ++i)
+        {
+          typename dealii::Triangulation<dim>::cell_iterator
+          cell (&tria, cells[i].first, cells[i].second);
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            if (cell->at_boundary(f) == false)
+              {
+                const typename dealii::Triangulation<dim>::cell_iterator
+                neighbor = get_neighbor (cell, f);
+                const unsigned int neighbor_pid = get_cell_owner (neighbor);
+                if (neighbor_pid != my_pid &&
+                    face_is_computed_on_this_process (my_pid, neighbor_pid))
+                  ghost_cells.emplace_back (neighbor->level(), neighbor->index());
+              }
+        }
+
+      std::sort (ghost_cells.begin(), ghost_cells.end());
+      ghost_cells.erase (std::unique (ghost_cells.begin(), ghost_cells.end()),
+                         ghost_cells.end());
+    }
+
+
+
+    /**
+     * Group the faces given in @p faces_in into batches of @p
+     * vectorization_width faces with the same face numbers (or the same
+     * boundary id), and append them to @p faces_out. Within one group, the
+     * order of the faces is kept to preserve data locality.
+     */
+    template <int vectorization_width>
+    void
+    collect_face_batches (std::vector<FaceToCellTopology<1> >                   &faces_in,
+                          const bool                                             is_boundary,
+                          std::vector<FaceToCellTopology<vectorization_width> > &faces_out)
+    {
+      std::stable_sort (faces_in.begin(), faces_in.end(),
+                        [is_boundary] (const FaceToCellTopology<1> &face1,
+                                       const FaceToCellTopology<1> &face2)
+      {
+        if (face1.interior_face_no != face2.interior_face_no)
+          return face1.interior_face_no < face2.interior_face_no;
+        if (is_boundary)
+          return face1.boundary_id < face2.boundary_id;
+        else
+          return face1.exterior_face_no < face2.exterior_face_no;
+      });
+
+      FaceToCellTopology<vectorization_width> batch;
+      unsigned int n_filled = 0;
+      for (unsigned int i=0; i<faces_in.size(); ++i)
+        {
+          if (n_filled == 0)
+            {
+              batch.interior_face_no = faces_in[i].interior_face_no;
+              batch.exterior_face_no = faces_in[i].exterior_face_no;
+              batch.boundary_id = faces_in[i].boundary_id;
+            }
+          batch.cells_interior[n_filled] = faces_in[i].cells_interior[0];
+          batch.cells_exterior[n_filled] = faces_in[i].cells_exterior[0];
+          ++n_filled;
+
+          // close the batch if it is full or if the next face has different
+          // face numbers
+          if (n_filled == vectorization_width ||
+              i+1 == faces_in.size() ||
+              faces_in[i+1].interior_face_no != batch.interior_face_no ||
+              (is_boundary ?
+               faces_in[i+1].boundary_id != batch.boundary_id :
+               faces_in[i+1].exterior_face_no != batch.exterior_face_no))
+            {
+              for (unsigned int v=n_filled; v<vectorization_width; ++v)
+                {
+                  batch.cells_interior[v] = numbers::invalid_unsigned_int;
+                  batch.cells_exterior[v] = numbers::invalid_unsigned_int;
+                }
+              faces_out.push_back (batch);
+              n_filled = 0;
+            }
+        }
+    }
+
+
+
+    template <int dim>
+    template <int vectorization_width>
+    void
+    FaceSetup<dim>::generate_faces
+    (const std::vector<std::pair<unsigned int,unsigned int> > &cell_level_index,
+     const std::vector<unsigned int>                          &n_filled_lanes,
+     const SizeInfo                                           &size_info,
+     FaceInfo<vectorization_width>                            &face_info) const
+    {
+      Assert (triangulation != nullptr, ExcNotInitialized());
+      AssertDimension (n_filled_lanes.size(), size_info.n_macro_cells);
+      AssertDimension (cell_level_index.size(),
+                       size_info.n_macro_cells*vectorization_width);
+      face_info.clear();
+
+      const unsigned int n_owned_cells =
+        size_info.n_macro_cells * vectorization_width;
+      std::map<std::pair<unsigned int,unsigned int>, unsigned int> cell_numbers;
+      for (unsigned int macro=0; macro<size_info.n_macro_cells; ++macro)
+        for (unsigned int v=0; v<n_filled_lanes[macro]; ++v)
+          cell_numbers[cell_level_index[macro*vectorization_width+v]] =
+            macro*vectorization_width+v;
+      for (unsigned int g=0; g<ghost_cells.size(); ++g)
+        cell_numbers[ghost_cells[g]] = n_owned_cells + g;
+
+      // ghosted vector entries are accessed by cells in the boundary range
+      // and by ghost cells
+      auto touches_ghosts = [&] (const unsigned int cell_number) -> bool
+      {
+        const unsigned int macro = cell_number / vectorization_width;
+        return (cell_number >= n_owned_cells ||
+                (macro >= size_info.boundary_cells_start &&
+                 macro < size_info.boundary_cells_end));
+      };
+
+      // collect the faces, split into faces that do not touch ghosted vector
+      // entries (index 0) and faces that do (index 1)
+      std::vector<FaceToCellTopology<1> > inner_faces[2], boundary_faces[2];
+      for (unsigned int macro=0; macro<size_info.n_macro_cells; ++macro)
+        for (unsigned int v=0; v<n_filled_lanes[macro]; ++v)
+          {
+            const unsigned int cell_number = macro*vectorization_width+v;
+            const std::pair<unsigned int,unsigned int> &level_index =
+              cell_level_index[cell_number];
+            typename dealii::Triangulation<dim>::cell_iterator
+            cell (triangulation, level_index.first, level_index.second);
+            for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+              {
+                FaceToCellTopology<1> face;
+                face.cells_interior[0] = cell_number;
+                face.interior_face_no = f;
+                if (cell->at_boundary(f))
+                  {
+                    face.cells_exterior[0] = numbers::invalid_unsigned_int;
+                    face.exterior_face_no = f;
+                    face.boundary_id = cell->face(f)->boundary_id();
+                    boundary_faces[touches_ghosts(cell_number)].push_back(face);
+                    continue;
+                  }
+
+                const typename dealii::Triangulation<dim>::cell_iterator
+                neighbor = get_neighbor (cell, f);
+                const unsigned int neighbor_pid = get_cell_owner (neighbor);
+
+                // faces between two locally owned cells are visited twice, so
+                // only add them from the cell with the lower number. faces to
+                // cells of other processes are only added on one of the two
+                // processes.
+                if (neighbor_pid == my_pid)
+                  {
+                    Assert (cell_numbers.find(std::make_pair(neighbor->level(),
+                                                             neighbor->index()))
+                            != cell_numbers.end(), ExcInternalError());
+                    const unsigned int neighbor_number =
+                      cell_numbers[std::make_pair(neighbor->level(),
+                                                  neighbor->index())];
+                    if (neighbor_number < cell_number)
+                      continue;
+                    face.cells_exterior[0] = neighbor_number;
+                  }
+                else if (face_is_computed_on_this_process(my_pid, neighbor_pid))
+                  {
+                    Assert (cell_numbers.find(std::make_pair(neighbor->level(),
+                                                             neighbor->index()))
+                            != cell_numbers.end(), ExcInternalError());
+                    face.cells_exterior[0] =
+                      cell_numbers[std::make_pair(neighbor->level(),
+                                                  neighbor->index())];
+                  }
+                else
+                  continue;
+
+                face.exterior_face_no = cell->neighbor_of_neighbor(f);
+                face.boundary_id = numbers::internal_face_boundary_id;
+                inner_faces[touches_ghosts(cell_number) ||
+                            touches_ghosts(face.cells_exterior[0])].push_back(face);
+              }
+          }
+
+      collect_face_batches (inner_faces[0], false, face_info.faces);
+      const unsigned int n_inner_plain = face_info.faces.size();
+      collect_face_batches (inner_faces[1], false, face_info.faces);
+      face_info.n_inner_face_batches = face_info.faces.size();
+      face_info.n_inner_face_batches_ghosted = face_info.faces.size() - n_inner_plain;
+
+      collect_face_batches (boundary_faces[0], true, face_info.faces);
+      const unsigned int n_boundary_plain = face_info.faces.size() -
+                                            face_info.n_inner_face_batches;
+      collect_face_batches (boundary_faces[1], true, face_info.faces);
+      face_info.n_boundary_face_batches = face_info.faces.size() -
+                                          face_info.n_inner_face_batches;
+      face_info.n_boundary_face_batches_ghosted = face_info.n_boundary_face_batches -
+                                                  n_boundary_plain;
+    }
+
+  } // end of namespace MatrixFreeFunctions
+} // end of namespace internal
+
+DEAL_II_NAMESPACE_CLOSE
+
+#endif
@@ -51,6 +51,8 @@ namespace internal
 
 template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1,
           int n_components_ = 1, typename Number = double > class FEEvaluation;
+template <int dim, int fe_degree, int n_q_points_1d = fe_degree+1,
+          int n_components_ = 1, typename Number = double > class FEFaceEvaluation;
 
 
 /**
@@ -873,6 +875,13 @@ protected:
    */
   unsigned int cell_data_number;
 
+  /**
+   * The number of quadrature points the current object works on. For
+   * FEEvaluation, this is the number of quadrature points on the cell, for
+   * FEFaceEvaluation the number of quadrature points on a face.
+   */
+  unsigned int n_quadrature_points;
+
   /**
    * Debug information to track whether dof values have been initialized
    * before accessed. Used to control exceptions when uninitialized data is
@@ -951,6 +960,7 @@ private:
    */
   template <int, int, typename> friend class FEEvaluationBase;
   template <int, int, int, int, typename> friend class FEEvaluation;
+  template <int, int, int, int, typename> friend class FEFaceEvaluation;
 };
 
 
@@ -2046,6 +2056,264 @@ private:
 
 
 
+/**
+ * The class that provides all functions necessary to evaluate functions at
+ * quadrature points and face integrations on the faces of a mesh. It is used
+ * together with MatrixFree::loop(), which hands over ranges of face batches
+ * (as opposed to cell batches in FEEvaluation) to the face worker
+ * functions. The design of the class is similar to FEEvaluation: After a
+ * call to reinit() with the index of a face batch, the degrees of freedom of
+ * the cells adjacent to the faces are read from a vector with
+ * read_dof_values(), the values and gradients on the quadrature points of
+ * the faces are computed with evaluate(), the quadrature point data is
+ * accessed and modified with the functions get_value(), get_gradient(),
+ * submit_value() and submit_gradient() inherited from FEEvaluationAccess,
+ * and the contributions are summed back into the cell degrees of freedom by
+ * integrate() and distribute_local_to_global().
+ *
+ * Each face batch has two sides, an "interior" and an "exterior" one, with
+ * the normal vector returned by get_normal_vector() pointing from the
+ * interior to the exterior side. The side a FEFaceEvaluation object works on
+ * is selected at construction. A typical face integral term of a
+ * discontinuous Galerkin method thus uses two objects of this class, one for
+ * each side, whereas boundary faces only have an interior side.
+ *
+ * The face evaluation first interpolates the values and normal derivatives
+ * of the cell polynomial to the face with the 1D shape functions evaluated
+ * at the two end points of the unit interval, and then applies the
+ * sum-factorization kernels in dim-1 dimensions on the face. This requires
+ * the element to be of tensor product type, i.e., FE_Q, FE_DGQ and similar
+ * elements described by ShapeInfo as one of the tensor types. The present
+ * implementation supports meshes without hanging nodes on faces, and the
+ * values on faces are always computed from the unconstrained degrees of
+ * freedom of the cells, which is the setting of discontinuous Galerkin
+ * methods.
+ *
+ * @tparam dim Dimension in which this class is to be used
+ *
+ * @tparam fe_degree Degree of the tensor product finite element with
+ * fe_degree+1 degrees of freedom per coordinate direction. Can be set to -1
+ * if the degree is not known at compile time.
+ *
+ * @tparam n_q_points_1d Number of points in the quadrature formula in 1D,
+ * defaults to fe_degree+1
+ *
+ * @tparam n_components Number of vector components when solving a system of
+ * PDEs. Defaults to 1.
+ *
+ * @tparam Number Number format, usually @p double or @p float. Defaults to @p
+ * double
+ */
+template <int dim, int fe_degree, int n_q_points_1d, int n_components_,
+          typename Number >
+class FEFaceEvaluation : public FEEvaluationAccess<dim,n_components_,Number>
+{
+public:
+  typedef FEEvaluationAccess<dim,n_components_,Number> BaseClass;
+  typedef Number                            number_type;
+  typedef typename BaseClass::value_type    value_type;
+  typedef typename BaseClass::gradient_type gradient_type;
+  static const unsigned int dimension     = dim;
+  static const unsigned int n_components  = n_components_;
+  static const unsigned int static_n_q_points    = Utilities::fixed_int_power<n_q_points_1d,dim-1>::value;
+  static const unsigned int static_n_q_points_cell = Utilities::fixed_int_power<n_q_points_1d,dim>::value;
+  static const unsigned int tensor_dofs_per_cell = Utilities::fixed_int_power<fe_degree+1,dim>::value;
+
+  /**
+   * Constructor. Takes all data stored in MatrixFree. The argument @p
+   * is_interior_face selects which of the two cells adjacent to the faces of
+   * a face batch the present object should work with. If applied to problems
+   * with more than one finite element or more than one quadrature formula
+   * selected during construction of @p matrix_free, @p fe_no and @p quad_no
+   * allow to select the appropriate components.
+   */
+  FEFaceEvaluation (const MatrixFree<dim,Number> &matrix_free,
+                    const bool                    is_interior_face = true,
+                    const unsigned int            fe_no   = 0,
+                    const unsigned int            quad_no = 0);
+
+  /**
+   * Initialize the operation pointer to the given face batch, i.e., an index
+   * between zero and MatrixFree::n_inner_face_batches() +
+   * MatrixFree::n_boundary_face_batches() (exclusive). The exterior side of
+   * a face batch can only be selected for inner faces.
+   */
+  void reinit (const unsigned int face_batch_number);
+
+  /**
+   * For the vector @p src, read out the values on the degrees of freedom of
+   * the cells adjacent to the current face batch on the side selected at
+   * construction, and store them internally. As opposed to
+   * FEEvaluationBase::read_dof_values(), the values are read without
+   * resolving constraints and also from cells owned by other MPI processes,
+   * which requires @p src to have its ghost values updated. Entries of
+   * unfilled lanes of the vectorization are set to zero.
+   */
+  template <typename VectorType>
+  void read_dof_values (const VectorType  &src,
+                        const unsigned int first_index = 0);
+
+  /**
+   * Take the values stored internally on the dof values of the cells
+   * adjacent to the current face batch and sum them into the vector @p
+   * dst. Entries belonging to cells owned by other MPI processes are added
+   * into the ghost entries of @p dst, which need to be sent to their owner
+   * by a subsequent call to compress() (as done by MatrixFree::loop()).
+   */
+  template <typename VectorType>
+  void distribute_local_to_global (VectorType        &dst,
+                                   const unsigned int first_index = 0) const;
+
+  /**
+   * Evaluate the function values and the gradients of the FE function given
+   * at the DoF values of the adjacent cells on the quadrature points of the
+   * face. The function arguments specify which parts shall actually be
+   * computed. Needs to be called before the functions @p get_value(), @p
+   * get_gradient() or @p get_normal_derivative() give useful information.
+   */
+  void evaluate (const bool evaluate_values,
+                 const bool evaluate_gradients);
+
+  /**
+   * This function takes the values and/or gradients that are stored on
+   * quadrature points of the face, tests them by all the basis
+   * functions/gradients of the adjacent cells and performs the face
+   * integration. The result is written into the cell degrees of freedom,
+   * overwriting the previous content.
+   */
+  void integrate (const bool integrate_values,
+                  const bool integrate_gradients);
+
+  /**
+   * Return the normal vector on the face in quadrature point @p q_point. The
+   * normal vector points from the interior to the exterior side of the face
+   * and is therefore the same for both FEFaceEvaluation objects of a face.
+   */
+  Tensor<1,dim,VectorizedArray<Number> >
+  get_normal_vector (const unsigned int q_point) const;
+
+  /**
+   * Return the derivative of the finite element function in direction of
+   * the normal vector in quadrature point @p q_point.
+   */
+  value_type get_normal_derivative (const unsigned int q_point) const;
+
+  /**
+   * Write a contribution that is tested by the derivative of the test
+   * functions in direction of the normal vector. Equivalent to calling
+   * submit_gradient() with @p value multiplied by the normal vector.
+   */
+  void submit_normal_derivative (const value_type   value,
+                                 const unsigned int q_point);
+
+  /**
+   * Return the q-th quadrature point on the face stored in MappingInfo.
+   */
+  Point<dim,VectorizedArray<Number> >
+  quadrature_point (const unsigned int q_point) const;
+
+  /**
+   * Return the boundary id of the current face batch. For inner faces, the
+   * value is numbers::internal_face_boundary_id.
+   */
+  types::boundary_id boundary_id () const;
+
+  /**
+   * Return the number of the face within the cells on the side selected at
+   * construction, between 0 and GeometryInfo<dim>::faces_per_cell.
+   */
+  unsigned int get_face_no () const;
+
+  /**
+   * The number of scalar degrees of freedom on the cells adjacent to the
+   * face.
+   */
+  const unsigned int dofs_per_cell;
+
+  /**
+   * The number of quadrature points on the face.
+   */
+  const unsigned int n_q_points;
+
+private:
+  /**
+   * Return a pointer to the index of the first degree of freedom of the
+   * cell in the given lane of the current batch, together with the stride
+   * between consecutive indices.
+   */
+  const unsigned int *
+  get_lane_dof_indices (const unsigned int lane,
+                        unsigned int      &stride) const;
+
+  /**
+   * Set up pointers to the gradients on quadrature points such that the
+   * first dim-1 entries correspond to the directions along the face and the
+   * last one to the direction normal to the face, which is the layout used
+   * by the face kernels.
+   */
+  void set_face_gradient_pointers
+  (VectorizedArray<Number> *gradients_face[][dim]) const;
+
+  /**
+   * Helper functions to contract a gradient with the normal vector and to
+   * compute the outer product of a value with the normal vector for the
+   * different gradient types of FEEvaluationAccess.
+   */
+  static VectorizedArray<Number>
+  contract_normal (const Tensor<1,dim,VectorizedArray<Number> > &gradient,
+                   const Tensor<1,dim,VectorizedArray<Number> > &normal);
+  static Tensor<1,dim,VectorizedArray<Number> >
+  contract_normal (const Tensor<2,dim,VectorizedArray<Number> > &gradient,
+                   const Tensor<1,dim,VectorizedArray<Number> > &normal);
+  template <int n_comp>
+  static Tensor<1,n_comp,VectorizedArray<Number> >
+  contract_normal (const Tensor<1,n_comp,Tensor<1,dim,VectorizedArray<Number> > > &gradient,
+                   const Tensor<1,dim,VectorizedArray<Number> >                  &normal);
+  static Tensor<1,dim,VectorizedArray<Number> >
+  multiply_normal (const VectorizedArray<Number>                &value,
+                   const Tensor<1,dim,VectorizedArray<Number> > &normal);
+  template <int n_comp>
+  static Tensor<1,n_comp,Tensor<1,dim,VectorizedArray<Number> > >
+  multiply_normal (const Tensor<1,n_comp,VectorizedArray<Number> > &value,
+                   const Tensor<1,dim,VectorizedArray<Number> >    &normal);
+
+  /**
+   * Stores whether the present object works on the interior or the exterior
+   * side of the faces.
+   */
+  const bool is_interior_face;
+
+  /**
+   * The number of the face within the cells on the selected side of the
+   * current face batch.
+   */
+  unsigned int face_no;
+
+  /**
+   * The boundary id of the current face batch.
+   */
+  types::boundary_id face_boundary_id;
+
+  /**
+   * The number of lanes of the current face batch that are filled with
+   * actual faces.
+   */
+  unsigned int n_filled_lanes;
+
+  /**
+   * The numbers of the cells on the selected side of the current face
+   * batch, in the numbering of MatrixFree::get_face_info().
+   */
+  unsigned int cell_numbers[VectorizedArray<Number>::n_array_elements];
+
+  /**
+   * A pointer to the normal vectors of the current face batch.
+   */
+  const Tensor<1,dim,VectorizedArray<Number> > *normal_vectors;
+};
+
+
+
 namespace internal
 {
   namespace MatrixFreeFunctions
@@ -2117,6 +2385,7 @@ FEEvaluationBase<dim,n_components_,Number>
   cell               (numbers::invalid_unsigned_int),
   cell_type          (internal::MatrixFreeFunctions::undefined),
   cell_data_number   (numbers::invalid_unsigned_int),
+  n_quadrature_points(data->n_q_points),
   dof_values_initialized    (false),
   values_quad_initialized   (false),
   gradients_quad_initialized(false),
@@ -2179,6 +2448,7 @@ FEEvaluationBase<dim,n_components_,Number>
   cell               (0),
   cell_type          (internal::MatrixFreeFunctions::general),
   cell_data_number   (numbers::invalid_unsigned_int),
+  n_quadrature_points(data->n_q_points),
   dof_values_initialized    (false),
   values_quad_initialized   (false),
   gradients_quad_initialized(false),
@@ -2246,6 +2516,7 @@ FEEvaluationBase<dim,n_components_,Number>
   cell               (numbers::invalid_unsigned_int),
   cell_type          (internal::MatrixFreeFunctions::general),
   cell_data_number   (numbers::invalid_unsigned_int),
+  n_quadrature_points(other.n_quadrature_points),
   dof_values_initialized    (false),
   values_quad_initialized   (false),
   gradients_quad_initialized(false),
@@ -2325,6 +2596,7 @@ FEEvaluationBase<dim,n_components_,Number>
   cell = numbers::invalid_unsigned_int;
   cell_type = internal::MatrixFreeFunctions::general;
   cell_data_number = numbers::invalid_unsigned_int;
+  n_quadrature_points = other.n_quadrature_points;
 
   // Create deep copy of mapped geometry for use in parallel...
   if (other.mapped_geometry.get() != nullptr)
@@ -3672,7 +3944,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
   Assert (this->values_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   Tensor<1,n_components_,VectorizedArray<Number> > return_value;
   for (unsigned int comp=0; comp<n_components; comp++)
     return_value[comp] = this->values_quad[comp][q_point];
@@ -3689,7 +3961,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
   Assert (this->gradients_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   Tensor<1,n_components_,Tensor<1,dim,VectorizedArray<Number> > > grad_out;
 
@@ -3789,7 +4061,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
   Assert (this->hessians_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   Tensor<2,dim,VectorizedArray<Number> > hessian_out [n_components];
 
@@ -3914,7 +4186,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
   Assert (this->hessians_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   Tensor<1,n_components_,Tensor<1,dim,VectorizedArray<Number> > > hessian_out;
 
@@ -3992,7 +4264,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
   Assert (this->hessians_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   Tensor<1,n_components_,VectorizedArray<Number> > laplacian_out;
   const Tensor<1,n_components_,Tensor<1,dim,VectorizedArray<Number> > > hess_diag
     = get_hessian_diagonal(q_point);
@@ -4033,7 +4305,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->values_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::general)
@@ -4062,7 +4334,7 @@ FEEvaluationBase<dim,n_components_,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->gradients_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
@@ -4108,7 +4380,7 @@ FEEvaluationBase<dim,n_components_,Number>
   Tensor<1,n_components_,VectorizedArray<Number> > return_value;
   for (unsigned int comp=0; comp<n_components; ++comp)
     return_value[comp] = this->values_quad[comp][0];
-  const unsigned int n_q_points = this->data->n_q_points;
+  const unsigned int n_q_points = this->n_quadrature_points;
   for (unsigned int q=1; q<n_q_points; ++q)
     for (unsigned int comp=0; comp<n_components; ++comp)
       return_value[comp] += this->values_quad[comp][q];
@@ -4251,7 +4523,7 @@ FEEvaluationAccess<dim,1,Number>
 {
   Assert (this->values_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   return this->values_quad[0][q_point];
 }
 
@@ -4268,7 +4540,7 @@ FEEvaluationAccess<dim,1,Number>
 
   Assert (this->gradients_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   Tensor<1,dim,VectorizedArray<Number> > grad_out;
 
@@ -4355,7 +4627,7 @@ FEEvaluationAccess<dim,1,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->values_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::general)
@@ -4381,7 +4653,7 @@ FEEvaluationAccess<dim,1,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->gradients_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
@@ -4501,7 +4773,7 @@ FEEvaluationAccess<dim,dim,Number>
 {
   Assert (this->gradients_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   VectorizedArray<Number> divergence;
 
@@ -4607,7 +4879,7 @@ FEEvaluationAccess<dim,dim,Number>
 {
   Assert (this->hessians_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   return BaseClass::get_hessian_diagonal (q_point);
 }
@@ -4622,7 +4894,7 @@ FEEvaluationAccess<dim,dim,Number>
 {
   Assert (this->hessians_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   return BaseClass::get_hessian(q_point);
 }
 
@@ -4662,7 +4934,7 @@ FEEvaluationAccess<dim,dim,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->gradients_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
@@ -4712,7 +4984,7 @@ FEEvaluationAccess<dim,dim,Number>
   // that saves some operations
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->gradients_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
@@ -4874,7 +5146,7 @@ FEEvaluationAccess<1,1,Number>
 {
   Assert (this->values_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   return this->values_quad[0][q_point];
 }
 
@@ -4891,7 +5163,7 @@ FEEvaluationAccess<1,1,Number>
 
   Assert (this->gradients_quad_initialized==true,
           internal::ExcAccessToUninitializedField());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
 
   Tensor<1,1,VectorizedArray<Number> > grad_out;
 
@@ -4973,7 +5245,7 @@ FEEvaluationAccess<1,1,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->values_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::general)
@@ -4999,7 +5271,7 @@ FEEvaluationAccess<1,1,Number>
 {
 #ifdef DEBUG
   Assert (this->cell != numbers::invalid_unsigned_int, ExcNotInitialized());
-  AssertIndexRange (q_point, this->data->n_q_points);
+  AssertIndexRange (q_point, this->n_quadrature_points);
   this->gradients_quad_submitted = true;
 #endif
   if (this->cell_type == internal::MatrixFreeFunctions::cartesian)
@@ -5496,6 +5768,493 @@ FEEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
 
 
 
+/*-------------------------- FEFaceEvaluation -------------------------------*/
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::FEFaceEvaluation (const MatrixFree<dim,Number> &data_in,
+                    const bool                    is_interior_face,
+                    const unsigned int            fe_no,
+                    const unsigned int            quad_no)
+  :
+  BaseClass (data_in, fe_no, quad_no, fe_degree, static_n_q_points_cell),
+  dofs_per_cell (this->data->dofs_per_cell),
+  n_q_points (this->data->n_q_points_face),
+  is_interior_face (is_interior_face),
+  face_no (numbers::invalid_unsigned_int),
+  face_boundary_id (numbers::invalid_boundary_id),
+  n_filled_lanes (0),
+  normal_vectors (nullptr)
+{
+  this->n_quadrature_points = this->data->n_q_points_face;
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    cell_numbers[v] = numbers::invalid_unsigned_int;
+
+  Assert (quad_no < this->mapping_info->face_data.size() &&
+          this->mapping_info->face_data[quad_no].JxW_values.size() > 0,
+          ExcMessage("FEFaceEvaluation needs the face data in MatrixFree. Did "
+                     "you set AdditionalData::mapping_update_flags_inner_faces "
+                     "or AdditionalData::mapping_update_flags_boundary_faces?"));
+  Assert (this->data->element_type <= internal::MatrixFreeFunctions::tensor_general,
+          ExcNotImplemented());
+  if (fe_degree != -1)
+    {
+      AssertDimension (static_cast<unsigned int>(fe_degree),
+                       this->data->fe_degree);
+      AssertDimension (static_cast<unsigned int>(n_q_points_1d),
+                       this->data->n_q_points_1d);
+    }
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::reinit (const unsigned int face_batch_number)
+{
+  Assert (this->mapping_info != nullptr, ExcNotInitialized());
+  Assert (is_interior_face == true ||
+          face_batch_number < this->matrix_info->n_inner_face_batches(),
+          ExcMessage("Boundary faces do not have an exterior side"));
+
+  const internal::MatrixFreeFunctions::FaceToCellTopology
+  <VectorizedArray<Number>::n_array_elements> &face_info =
+    this->matrix_info->get_face_info(face_batch_number);
+
+  this->cell = face_batch_number;
+  this->cell_type = internal::MatrixFreeFunctions::general;
+  face_no = is_interior_face ? face_info.interior_face_no :
+            face_info.exterior_face_no;
+  face_boundary_id = face_info.boundary_id;
+  n_filled_lanes = face_info.n_filled_lanes();
+  for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+    cell_numbers[v] = is_interior_face ? face_info.cells_interior[v] :
+                      face_info.cells_exterior[v];
+
+  const typename internal::MatrixFreeFunctions::MappingInfo<dim,Number>::FaceMappingInfo &
+  face_data = this->mapping_info->face_data[this->quad_no];
+  const unsigned int offset = face_batch_number * n_q_points;
+  AssertIndexRange (offset, face_data.JxW_values.size());
+  this->J_value = &face_data.JxW_values[offset];
+  normal_vectors = &face_data.normal_vectors[offset];
+  const unsigned int side = is_interior_face ? 0 : 1;
+  this->jacobian = face_data.jacobians[side].size() > 0 ?
+                   &face_data.jacobians[side][offset] : nullptr;
+  this->quadrature_points = face_data.quadrature_points.size() > 0 ?
+                            &face_data.quadrature_points[offset] : nullptr;
+
+#ifdef DEBUG
+  this->dof_values_initialized     = false;
+  this->values_quad_initialized    = false;
+  this->gradients_quad_initialized = false;
+  this->hessians_quad_initialized  = false;
+#endif
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+const unsigned int *
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_lane_dof_indices (const unsigned int lane,
+                        unsigned int      &stride) const
+{
+  const unsigned int n_lanes = VectorizedArray<Number>::n_array_elements;
+  const unsigned int n_owned_cells = this->matrix_info->n_macro_cells() * n_lanes;
+  const unsigned int cell_number = cell_numbers[lane];
+  AssertIndexRange (lane, n_filled_lanes);
+
+  // cells owned by other processes: indices stored separately in DoFInfo
+  if (cell_number >= n_owned_cells)
+    {
+      stride = 1;
+      const unsigned int index = (cell_number - n_owned_cells) *
+                                 this->dof_info->dofs_per_cell[0];
+      AssertIndexRange (index, this->dof_info->ghost_cell_dof_indices.size());
+      return &this->dof_info->ghost_cell_dof_indices[index];
+    }
+
+  // locally owned cells: the indices of the lanes of a cell batch are
+  // interleaved, with as many entries as there are filled lanes
+  const unsigned int macro = cell_number / n_lanes;
+  const unsigned int n_filled = this->dof_info->row_starts[macro][2] > 0 ?
+                                this->dof_info->row_starts[macro][2] : n_lanes;
+  stride = n_filled;
+  Assert (this->dof_info->row_length_indicators(macro) == 0 ||
+          this->dof_info->store_plain_indices == true,
+          ExcMessage("FEFaceEvaluation needs the unconstrained indices on "
+                     "constrained cells. Set AdditionalData::store_plain_indices."));
+  return this->dof_info->begin_indices_plain(macro) + cell_number % n_lanes;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::read_dof_values (const VectorType  &src,
+                   const unsigned int first_index)
+{
+  // select between block vectors and non-block vectors. Note that the number
+  // of components is checked in the internal data
+  const typename internal::BlockVectorSelector<VectorType,
+        IsBlockVector<VectorType>::value>::BaseVectorType *src_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    src_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(const_cast<VectorType &>(src), d+first_index);
+  Assert (this->n_fe_components == 1 || this->n_fe_components == n_components_,
+          ExcNotImplemented());
+
+  if (n_filled_lanes < VectorizedArray<Number>::n_array_elements)
+    for (unsigned int c=0; c<n_components; ++c)
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        this->values_dofs[c][i] = VectorizedArray<Number>();
+
+  for (unsigned int v=0; v<n_filled_lanes; ++v)
+    {
+      unsigned int stride = 0;
+      const unsigned int *dof_indices = get_lane_dof_indices(v, stride);
+
+      // scalar case (or case when all components have the same degrees of
+      // freedom and sit on a different vector each)
+      if (this->n_fe_components == 1)
+        for (unsigned int c=0; c<n_components; ++c)
+          {
+            internal::check_vector_compatibility (*src_data[c], *this->dof_info);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              this->values_dofs[c][i][v] =
+                internal::vector_access (*src_data[c], dof_indices[i*stride]);
+          }
+      // vector-valued element with all components in one vector, ordered by
+      // components
+      else
+        {
+          internal::check_vector_compatibility (*src_data[0], *this->dof_info);
+          for (unsigned int i=0; i<n_components*dofs_per_cell; ++i)
+            this->values_dofs[0][i][v] =
+              internal::vector_access (*src_data[0], dof_indices[i*stride]);
+        }
+    }
+
+#ifdef DEBUG
+  this->dof_values_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+template <typename VectorType>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::distribute_local_to_global (VectorType        &dst,
+                              const unsigned int first_index) const
+{
+  Assert (this->dof_values_initialized==true,
+          internal::ExcAccessToUninitializedField());
+
+  // select between block vectors and non-block vectors. Note that the number
+  // of components is checked in the internal data
+  typename internal::BlockVectorSelector<VectorType,
+           IsBlockVector<VectorType>::value>::BaseVectorType *dst_data[n_components];
+  for (unsigned int d=0; d<n_components; ++d)
+    dst_data[d] = internal::BlockVectorSelector<VectorType, IsBlockVector<VectorType>::value>::get_vector_component(dst, d+first_index);
+
+  for (unsigned int v=0; v<n_filled_lanes; ++v)
+    {
+      unsigned int stride = 0;
+      const unsigned int *dof_indices = get_lane_dof_indices(v, stride);
+
+      if (this->n_fe_components == 1)
+        for (unsigned int c=0; c<n_components; ++c)
+          {
+            internal::check_vector_compatibility (*dst_data[c], *this->dof_info);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              internal::vector_access (*dst_data[c], dof_indices[i*stride])
+                += this->values_dofs[c][i][v];
+          }
+      else
+        {
+          internal::check_vector_compatibility (*dst_data[0], *this->dof_info);
+          for (unsigned int i=0; i<n_components*dofs_per_cell; ++i)
+            internal::vector_access (*dst_data[0], dof_indices[i*stride])
+              += this->values_dofs[0][i][v];
+        }
+    }
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::set_face_gradient_pointers (VectorizedArray<Number> *gradients_face[][dim]) const
+{
+  // the face kernels work in the coordinate system of the face where the
+  // tangential direction k corresponds to the cell direction
+  // (face_direction+1+k)%dim, and the last slot is the normal direction
+  const unsigned int face_direction = face_no / 2;
+  for (unsigned int c=0; c<n_components; ++c)
+    {
+      for (unsigned int k=0; k+1<dim; ++k)
+        gradients_face[c][k] = this->gradients_quad[c][(face_direction+1+k)%dim];
+      gradients_face[c][dim-1] = this->gradients_quad[c][face_direction];
+    }
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::evaluate (const bool evaluate_values,
+            const bool evaluate_gradients)
+{
+  Assert (this->dof_values_initialized == true,
+          internal::ExcAccessToUninitializedField());
+  Assert (face_no != numbers::invalid_unsigned_int, ExcNotInitialized());
+  Assert (evaluate_gradients == false || this->jacobian != nullptr,
+          ExcMessage("Gradients on faces need update_gradients in "
+                     "the face update flags of MatrixFree::AdditionalData"));
+
+  // Since some template combinations do not work for fe_degree==-1, create
+  // safe template values for the calls below.
+  const unsigned int n_q_points_1d_adjusted = fe_degree == -1 ? 0 : n_q_points_1d;
+  typedef internal::FEFaceEvaluationImpl<dim, fe_degree, n_q_points_1d_adjusted,
+          n_components_, Number> Impl;
+
+  VectorizedArray<Number> *face_dofs = this->scratch_data;
+  VectorizedArray<Number> *temp_data = face_dofs +
+                                       2*n_components_*this->data->dofs_per_face;
+  Impl::interpolate (*this->data, face_no, true, evaluate_gradients,
+                     this->values_dofs[0], face_dofs);
+
+  VectorizedArray<Number> *gradients_face[n_components_][dim];
+  set_face_gradient_pointers (gradients_face);
+  Impl::evaluate_in_face (*this->data, face_dofs, this->values_quad,
+                          gradients_face, temp_data, evaluate_values,
+                          evaluate_gradients);
+
+#ifdef DEBUG
+  if (evaluate_values == true)
+    this->values_quad_initialized = true;
+  if (evaluate_gradients == true)
+    this->gradients_quad_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::integrate (const bool integrate_values,
+             const bool integrate_gradients)
+{
+  Assert (integrate_values == true || integrate_gradients == true,
+          ExcMessage("Must integrate at least values or gradients"));
+#ifdef DEBUG
+  if (integrate_values == true)
+    Assert (this->values_quad_submitted == true,
+            internal::ExcAccessToUninitializedField());
+  if (integrate_gradients == true)
+    Assert (this->gradients_quad_submitted == true,
+            internal::ExcAccessToUninitializedField());
+#endif
+
+  const unsigned int n_q_points_1d_adjusted = fe_degree == -1 ? 0 : n_q_points_1d;
+  typedef internal::FEFaceEvaluationImpl<dim, fe_degree, n_q_points_1d_adjusted,
+          n_components_, Number> Impl;
+
+  VectorizedArray<Number> *face_dofs = this->scratch_data;
+  VectorizedArray<Number> *temp_data = face_dofs +
+                                       2*n_components_*this->data->dofs_per_face;
+
+  VectorizedArray<Number> *gradients_face[n_components_][dim];
+  set_face_gradient_pointers (gradients_face);
+  Impl::integrate_in_face (*this->data, face_dofs, this->values_quad,
+                           gradients_face, temp_data, integrate_values,
+                           integrate_gradients);
+  Impl::interpolate (*this->data, face_no, false, integrate_gradients,
+                     this->values_dofs[0], face_dofs);
+
+#ifdef DEBUG
+  this->dof_values_initialized = true;
+#endif
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_vector (const unsigned int q_point) const
+{
+  Assert (normal_vectors != nullptr, ExcNotInitialized());
+  AssertIndexRange (q_point, n_q_points);
+  return normal_vectors[q_point];
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+typename FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>::value_type
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_normal_derivative (const unsigned int q_point) const
+{
+  return contract_normal (this->get_gradient(q_point),
+                          get_normal_vector(q_point));
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+void
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::submit_normal_derivative (const value_type   value,
+                            const unsigned int q_point)
+{
+  this->submit_gradient (multiply_normal (value, get_normal_vector(q_point)),
+                         q_point);
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Point<dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::quadrature_point (const unsigned int q_point) const
+{
+  Assert (this->quadrature_points != nullptr, ExcNotInitialized());
+  AssertIndexRange (q_point, n_q_points);
+  return this->quadrature_points[q_point];
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+types::boundary_id
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::boundary_id () const
+{
+  return face_boundary_id;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+unsigned int
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::get_face_no () const
+{
+  return face_no;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+VectorizedArray<Number>
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::contract_normal (const Tensor<1,dim,VectorizedArray<Number> > &gradient,
+                   const Tensor<1,dim,VectorizedArray<Number> > &normal)
+{
+  return gradient * normal;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::contract_normal (const Tensor<2,dim,VectorizedArray<Number> > &gradient,
+                   const Tensor<1,dim,VectorizedArray<Number> > &normal)
+{
+  return gradient * normal;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+template <int n_comp>
+inline
+Tensor<1,n_comp,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::contract_normal (const Tensor<1,n_comp,Tensor<1,dim,VectorizedArray<Number> > > &gradient,
+                   const Tensor<1,dim,VectorizedArray<Number> >                  &normal)
+{
+  Tensor<1,n_comp,VectorizedArray<Number> > result;
+  for (unsigned int c=0; c<n_comp; ++c)
+    result[c] = gradient[c] * normal;
+  return result;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+inline
+Tensor<1,dim,VectorizedArray<Number> >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::multiply_normal (const VectorizedArray<Number>                &value,
+                   const Tensor<1,dim,VectorizedArray<Number> > &normal)
+{
+  return value * normal;
+}
+
+
+
+template <int dim, int fe_degree,  int n_q_points_1d, int n_components_,
+          typename Number>
+template <int n_comp>
+inline
+Tensor<1,n_comp,Tensor<1,dim,VectorizedArray<Number> > >
+FEFaceEvaluation<dim,fe_degree,n_q_points_1d,n_components_,Number>
+::multiply_normal (const Tensor<1,n_comp,VectorizedArray<Number> > &value,
+                   const Tensor<1,dim,VectorizedArray<Number> >    &normal)
+{
+  Tensor<1,n_comp,Tensor<1,dim,VectorizedArray<Number> > > result;
+  for (unsigned int c=0; c<n_comp; ++c)
+    result[c] = value[c] * normal;
+  return result;
+}
+
+
+
 #endif  // ifndef DOXYGEN
 
 
@@ -25,6 +25,7 @@
 #include <deal.II/fe/fe.h>
 #include <deal.II/fe/mapping.h>
 #include <deal.II/matrix_free/helper_functions.h>
+#include <deal.II/matrix_free/face_info.h>
 
 #include <memory>
 
@@ -83,6 +84,21 @@ namespace internal
                        const std::vector<dealii::hp::QCollection<1> >  &quad,
                        const UpdateFlags                        update_flags);
 
+      /**
+       * Compute the information in the given faces, called internally by the
+       * MatrixFree::reinit() method after the cell data has been set up by
+       * initialize(). The numbers of the cells in @p faces refer to the
+       * vectorized cell storage in @p cells, or, for indices beyond the
+       * range of @p cells, to the list of cells of other MPI processes given
+       * by @p ghost_cells.
+       */
+      void initialize_faces (const dealii::Triangulation<dim>                         &tria,
+                             const std::vector<std::pair<unsigned int,unsigned int> > &cells,
+                             const std::vector<std::pair<unsigned int,unsigned int> > &ghost_cells,
+                             const std::vector<FaceToCellTopology<n_vector_elements> > &faces,
+                             const Mapping<dim>                                       &mapping,
+                             const UpdateFlags                                         update_flags);
+
       /**
        * Helper function to determine which update flags must be set in the
        * internal functions to initialize all data as requested by the user.
@@ -289,6 +305,51 @@ namespace internal
        */
       std::vector<MappingInfoDependent> mapping_data_gen;
 
+      /**
+       * The mapping data evaluated on the faces for one quadrature formula,
+       * stored in all quadrature points of all face batches. The data of face
+       * batch @p f is located at the positions <code>f*n_q_points_face</code>
+       * to <code>(f+1)*n_q_points_face</code>. As opposed to the cells, no
+       * compression of Cartesian or affine geometries is done.
+       */
+      struct FaceMappingInfo
+      {
+        /**
+         * The Jacobian determinant on the face times the quadrature weight.
+         */
+        AlignedVector<VectorizedArray<Number> > JxW_values;
+
+        /**
+         * The unit outer normal vector of the cells on the interior side of
+         * the face, which coincides with the inner normal vector of the cells
+         * on the exterior side.
+         */
+        AlignedVector<Tensor<1,dim,VectorizedArray<Number> > > normal_vectors;
+
+        /**
+         * The inverse Jacobians (in transposed form) of the cells on the
+         * interior side (index 0) and the exterior side (index 1) of the face.
+         * The field for the exterior side is not filled for boundary faces.
+         */
+        AlignedVector<Tensor<2,dim,VectorizedArray<Number> > > jacobians[2];
+
+        /**
+         * The quadrature points in real space.
+         */
+        AlignedVector<Point<dim,VectorizedArray<Number> > > quadrature_points;
+
+        /**
+         * Return the memory consumption in bytes.
+         */
+        std::size_t memory_consumption () const;
+      };
+
+      /**
+       * Contains the face data for all quadrature formulas, with the same
+       * indexing as @p mapping_data_gen.
+       */
+      std::vector<FaceMappingInfo> face_data;
+
       /**
        * Stores whether JxW values have been initialized
        */
@@ -52,6 +52,7 @@ namespace internal
       quadrature_points_initialized = false;
       second_derivatives_initialized = false;
       mapping_data_gen.clear();
+      face_data.clear();
       cell_type.clear();
       cartesian_data.clear();
       affine_data.clear();
@@ -603,6 +604,155 @@ namespace internal
 
 
 
+    template <int dim, typename Number>
+    void
+    MappingInfo<dim,Number>::initialize_faces
+    (const dealii::Triangulation<dim>                          &tria,
+     const std::vector<std::pair<unsigned int,unsigned int> >  &cells,
+     const std::vector<std::pair<unsigned int,unsigned int> >  &ghost_cells,
+     const std::vector<FaceToCellTopology<n_vector_elements> > &faces,
+     const Mapping<dim>                                        &mapping,
+     const UpdateFlags                                          update_flags_input)
+    {
+      face_data.clear();
+      face_data.resize (mapping_data_gen.size());
+      if (faces.empty())
+        return;
+
+      // on faces, we always store the JxW values and the normal vectors, and
+      // the inverse Jacobians only when gradients are requested
+      const bool compute_jacobians = (update_flags_input & update_gradients) ||
+                                     (update_flags_input & update_inverse_jacobians);
+      const bool compute_points = (update_flags_input & update_quadrature_points);
+      const UpdateFlags update_flags_feval = update_JxW_values | update_normal_vectors |
+                                             (compute_jacobians ? update_jacobians : update_default) |
+                                             (compute_points ? update_quadrature_points : update_default);
+      const UpdateFlags update_flags_exterior = update_quadrature_points |
+                                                (compute_jacobians ? update_jacobians : update_default);
+
+      // dummy FE as in the cell case
+      FE_Nothing<dim> dummy_fe;
+
+      const unsigned int n_cells = cells.size();
+      Assert (n_cells%n_vector_elements == 0, ExcInternalError());
+      auto get_cell = [&] (const unsigned int cell_number)
+                      -> typename dealii::Triangulation<dim>::cell_iterator
+      {
+        AssertIndexRange (cell_number, n_cells + ghost_cells.size());
+        const std::pair<unsigned int,unsigned int> &level_index =
+          cell_number < n_cells ? cells[cell_number] : ghost_cells[cell_number-n_cells];
+        return typename dealii::Triangulation<dim>::cell_iterator
+               (&tria, level_index.first, level_index.second);
+      };
+
+      for (unsigned int my_q=0; my_q<mapping_data_gen.size(); ++my_q)
+        {
+          Assert (mapping_data_gen[my_q].face_quadrature.size() == 1,
+                  ExcNotImplemented());
+          const Quadrature<dim-1> &quad = mapping_data_gen[my_q].face_quadrature[0];
+          const unsigned int n_q_points = quad.size();
+
+          FaceMappingInfo &data = face_data[my_q];
+          data.JxW_values.resize (faces.size()*n_q_points);
+          data.normal_vectors.resize (faces.size()*n_q_points);
+          if (compute_jacobians)
+            for (unsigned int side=0; side<2; ++side)
+              data.jacobians[side].resize (faces.size()*n_q_points);
+          if (compute_points)
+            data.quadrature_points.resize (faces.size()*n_q_points);
+
+          FEFaceValues<dim> fe_face_values (mapping, dummy_fe, quad,
+                                            update_flags_feval);
+          FEFaceValues<dim> fe_face_values_exterior (mapping, dummy_fe, quad,
+                                                     update_flags_exterior);
+
+          for (unsigned int face=0; face<faces.size(); ++face)
+            {
+              const FaceToCellTopology<n_vector_elements> &face_info = faces[face];
+              const unsigned int offset = face*n_q_points;
+              for (unsigned int v=0; v<n_vector_elements; ++v)
+                {
+                  // unfilled lanes get the data of the first lane in order
+                  // to avoid divisions by zero or similar
+                  if (face_info.cells_interior[v] == numbers::invalid_unsigned_int)
+                    {
+                      for (unsigned int q=0; q<n_q_points; ++q)
+                        {
+                          data.JxW_values[offset+q][v] = data.JxW_values[offset+q][0];
+                          for (unsigned int d=0; d<dim; ++d)
+                            data.normal_vectors[offset+q][d][v] =
+                              data.normal_vectors[offset+q][d][0];
+                          if (compute_points)
+                            for (unsigned int d=0; d<dim; ++d)
+                              data.quadrature_points[offset+q][d][v] =
+                                data.quadrature_points[offset+q][d][0];
+                          if (compute_jacobians)
+                            for (unsigned int side=0; side<2; ++side)
+                              for (unsigned int d=0; d<dim; ++d)
+                                for (unsigned int e=0; e<dim; ++e)
+                                  data.jacobians[side][offset+q][d][e][v] =
+                                    data.jacobians[side][offset+q][d][e][0];
+                        }
+                      continue;
+                    }
+
+                  fe_face_values.reinit (get_cell(face_info.cells_interior[v]),
+                                         face_info.interior_face_no);
+                  const bool has_exterior =
+                    face_info.cells_exterior[v] != numbers::invalid_unsigned_int;
+                  if (has_exterior)
+                    fe_face_values_exterior.reinit (get_cell(face_info.cells_exterior[v]),
+                                                    face_info.exterior_face_no);
+
+                  for (unsigned int q=0; q<n_q_points; ++q)
+                    {
+                      data.JxW_values[offset+q][v] = fe_face_values.JxW(q);
+                      const Tensor<1,dim> normal = fe_face_values.normal_vector(q);
+                      for (unsigned int d=0; d<dim; ++d)
+                        data.normal_vectors[offset+q][d][v] = normal[d];
+                      if (compute_points)
+                        for (unsigned int d=0; d<dim; ++d)
+                          data.quadrature_points[offset+q][d][v] =
+                            fe_face_values.quadrature_point(q)[d];
+
+                      // the face data is only usable if the quadrature points
+                      // of both sides match, which is the case for standard
+                      // orientation of faces without hanging nodes
+                      Assert (!has_exterior ||
+                              fe_face_values.quadrature_point(q).distance
+                              (fe_face_values_exterior.quadrature_point(q)) <
+                              1e-10*fe_face_values.get_cell()->diameter(),
+                              ExcMessage("Quadrature points on the two sides "
+                                         "of a face do not match. Only faces "
+                                         "in standard orientation are "
+                                         "supported."));
+
+                      if (compute_jacobians)
+                        for (unsigned int side=0; side<2; ++side)
+                          {
+                            // leave the exterior data of boundary faces at
+                            // the interior values
+                            const DerivativeForm<1,dim,dim> &jac =
+                              (side == 1 && has_exterior) ?
+                              fe_face_values_exterior.jacobian(q) :
+                              fe_face_values.jacobian(q);
+                            Tensor<2,dim> jac_tensor;
+                            for (unsigned int d=0; d<dim; ++d)
+                              for (unsigned int e=0; e<dim; ++e)
+                                jac_tensor[d][e] = jac[d][e];
+                            const Tensor<2,dim> inv_jac = transpose(invert(jac_tensor));
+                            for (unsigned int d=0; d<dim; ++d)
+                              for (unsigned int e=0; e<dim; ++e)
+                                data.jacobians[side][offset+q][d][e][v] = inv_jac[d][e];
+                          }
+                    }
+                }
+            }
+        }
+    }
+
+
+
     template <int dim, typename Number>
     void
     MappingInfo<dim,Number>::evaluate_on_cell (const dealii::Triangulation<dim> &tria,
@@ -844,11 +994,26 @@ namespace internal
 
 
 
+    template <int dim, typename Number>
+    std::size_t MappingInfo<dim,Number>::FaceMappingInfo::memory_consumption() const
+    {
+      std::size_t
+      memory = MemoryConsumption::memory_consumption (JxW_values);
+      memory += MemoryConsumption::memory_consumption (normal_vectors);
+      memory += MemoryConsumption::memory_consumption (jacobians[0]);
+      memory += MemoryConsumption::memory_consumption (jacobians[1]);
+      memory += MemoryConsumption::memory_consumption (quadrature_points);
+      return memory;
+    }
+
+
+
     template <int dim, typename Number>
     std::size_t MappingInfo<dim,Number>::memory_consumption() const
     {
       std::size_t
       memory= MemoryConsumption::memory_consumption (mapping_data_gen);
+      memory += MemoryConsumption::memory_consumption (face_data);
       memory += MemoryConsumption::memory_consumption (affine_data);
       memory += MemoryConsumption::memory_consumption (cartesian_data);
       memory += MemoryConsumption::memory_consumption (cell_type);
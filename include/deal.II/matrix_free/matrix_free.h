@@ -38,6 +38,7 @@
 #include <deal.II/matrix_free/shape_info.h>
 #include <deal.II/matrix_free/dof_info.h>
 #include <deal.II/matrix_free/mapping_info.h>
+#include <deal.II/matrix_free/face_info.h>
 
 #ifdef DEAL_II_WITH_THREADS
 #include <tbb/task.h>
@@ -130,13 +131,19 @@ public:
    * class should also allow for access to vectors without resolving
    * constraints.
    *
-   * The last two parameters allow the user to disable some of the
+   * The next two parameters allow the user to disable some of the
    * initialization processes. For example, if only the scheduling that avoids
    * touching the same vector/matrix indices simultaneously is to be found,
    * the mapping needs not be initialized. Likewise, if the mapping has
    * changed from one iteration to the next but the topology has not (like
    * when using a deforming mesh with MappingQEulerian), it suffices to
    * initialize the mapping only.
+   *
+   * The last two parameters specify the update flags for the mapping data on
+   * boundary faces and on inner faces, respectively. If either of them is
+   * different from update_default, the faces of the mesh are collected and
+   * grouped into batches that can be worked on with FEFaceEvaluation in
+   * MatrixFree::loop().
    */
   struct AdditionalData
   {
@@ -175,7 +182,9 @@ public:
                     const unsigned int level_mg_handler = numbers::invalid_unsigned_int,
                     const bool                store_plain_indices = true,
                     const bool                initialize_indices = true,
-                    const bool                initialize_mapping = true)
+                    const bool                initialize_mapping = true,
+                    const UpdateFlags         mapping_update_flags_boundary_faces = update_default,
+                    const UpdateFlags         mapping_update_flags_inner_faces = update_default)
       :
       tasks_parallel_scheme (tasks_parallel_scheme),
       tasks_block_size      (tasks_block_size),
@@ -183,7 +192,9 @@ public:
       level_mg_handler      (level_mg_handler),
       store_plain_indices   (store_plain_indices),
       initialize_indices    (initialize_indices),
-      initialize_mapping    (initialize_mapping)
+      initialize_mapping    (initialize_mapping),
+      mapping_update_flags_boundary_faces (mapping_update_flags_boundary_faces),
+      mapping_update_flags_inner_faces (mapping_update_flags_inner_faces)
     {};
 
 
@@ -276,6 +287,34 @@ public:
      * independent cells should be computed).
      */
     bool                initialize_mapping;
+
+    /**
+     * This flag determines the mapping data on boundary faces to be
+     * cached. Note that MatrixFree uses a separate loop layout for face
+     * integrals, where faces with the same local face number on the cells
+     * are grouped into batches of a VectorizedArray, independently of the
+     * grouping of the cells.
+     *
+     * If set to a value different from update_default (default), the face
+     * information is explicitly built. Currently, MatrixFree supports to
+     * cache the following data on faces: inverse Jacobians, Jacobian
+     * determinants (JxW), quadrature points, and normal vectors. The
+     * Jacobian determinants and normal vectors are always stored when faces
+     * are set up, the inverse Jacobians are stored if update_gradients is
+     * given, and the quadrature points if update_quadrature_points is given.
+     *
+     * Face integrals are currently only supported for a DoFHandler (no
+     * hp::DoFHandler) on meshes without hanging nodes and with all faces in
+     * standard orientation.
+     */
+    UpdateFlags         mapping_update_flags_boundary_faces;
+
+    /**
+     * This flag determines the mapping data on interior faces to be
+     * cached. See the description of @p mapping_update_flags_boundary_faces
+     * for the supported flags.
+     */
+    UpdateFlags         mapping_update_flags_inner_faces;
   };
 
   /**
@@ -447,6 +486,18 @@ public:
    * a pointer to an object in this place if it has an <code>operator()</code>
    * with the correct set of arguments since such a pointer can be converted
    * to the function object.
+   *
+   * For vectors of type LinearAlgebra::distributed::Vector (or block vectors
+   * and collections thereof), the MPI data exchange is overlapped with the
+   * computations: The import of the ghost values of @p src is started before
+   * the first cells are visited and only completed before the cells whose
+   * degrees of freedom touch ghost entries are worked on. Likewise, the
+   * communication of the contributions to ghost entries of @p dst to their
+   * owners is started as soon as the last cell touching ghost entries has
+   * been visited, and finished after the remaining cells. To this end, the
+   * cells are ordered such that the cells touching ghosts are placed in the
+   * middle of the range of cells. If @p src already has its ghost values
+   * set when entering this function, no data exchange on @p src takes place.
    */
   template <typename OutVector, typename InVector>
   void cell_loop (const std::function<void (const MatrixFree<dim,Number> &,
@@ -489,6 +540,105 @@ public:
                   OutVector      &dst,
                   const InVector &src) const;
 
+  /**
+   * This method runs a loop over all cells (in parallel) and performs the
+   * MPI data exchange on the source vector and destination vector. As
+   * opposed to the other variants that only runs a function on cells, this
+   * method also takes as arguments a function for the interior faces and
+   * for the boundary faces, respectively. The arguments of these functions
+   * have the same signature as the one for the cells, where the last
+   * argument defines the range of face batches, i.e., the numbers to be
+   * passed to FEFaceEvaluation::reinit(). Interior faces are numbered from
+   * zero to n_inner_face_batches() (exclusive), and boundary faces follow
+   * in the range from n_inner_face_batches() to n_inner_face_batches() +
+   * n_boundary_face_batches().
+   *
+   * The face batches are only available if the MatrixFree object has been
+   * initialized with
+   * MatrixFree::AdditionalData::mapping_update_flags_inner_faces or
+   * MatrixFree::AdditionalData::mapping_update_flags_boundary_faces set to
+   * a value different from update_default.
+   *
+   * In the same way as for cell_loop(), the communication of ghost values
+   * of the source vector is overlapped with the work on cells and faces that
+   * only access locally owned vector entries, and the compress of the
+   * destination vector is started as soon as all cells and faces writing
+   * into ghost entries have been processed. Note that this loop currently
+   * does not use thread parallelism, i.e., the task parallel scheme selected
+   * in MatrixFree::AdditionalData is ignored.
+   */
+  template <typename OutVector, typename InVector>
+  void loop (const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &cell_operation,
+             const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &face_operation,
+             const std::function<void (const MatrixFree<dim,Number> &,
+                                       OutVector &,
+                                       const InVector &,
+                                       const std::pair<unsigned int,
+                                       unsigned int> &)> &boundary_operation,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * This is the second variant to run the loop over all cells, interior
+   * faces, and boundary faces, now providing three function pointers to
+   * member functions of class @p CLASS with the signature
+   * <code>operation (const MatrixFree<dim,Number> &, OutVector &, InVector
+   * &, std::pair<unsigned int,unsigned int>&)const</code>. This method
+   * obviates the need to call std::bind to bind the class into the given
+   * function in case the local function needs to access data in the class
+   * (i.e., it is a non-static member function).
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &)const,
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &)const,
+             const CLASS    *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
+  /**
+   * Same as above, but for class member functions which are non-const.
+   */
+  template <typename CLASS, typename OutVector, typename InVector>
+  void loop (void (CLASS::*cell_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*face_operation)(const MatrixFree &,
+                                           OutVector &,
+                                           const InVector &,
+                                           const std::pair<unsigned int,
+                                           unsigned int> &),
+             void (CLASS::*boundary_operation)(const MatrixFree &,
+                                               OutVector &,
+                                               const InVector &,
+                                               const std::pair<unsigned int,
+                                               unsigned int> &),
+             CLASS          *owning_class,
+             OutVector      &dst,
+             const InVector &src) const;
+
   /**
    * In the hp adaptive case, a subrange of cells as computed during the cell
    * loop might contain elements of different degrees. Use this function to
@@ -650,6 +800,29 @@ public:
    */
   unsigned int n_macro_cells () const;
 
+  /**
+   * Return the number of batches of interior faces that this structure
+   * works on, i.e., the range of face batches passed to the face operation
+   * in loop(). This number is zero unless the face data has been requested
+   * by MatrixFree::AdditionalData::mapping_update_flags_inner_faces or
+   * MatrixFree::AdditionalData::mapping_update_flags_boundary_faces.
+   */
+  unsigned int n_inner_face_batches () const;
+
+  /**
+   * Return the number of batches of boundary faces that this structure works
+   * on. The boundary face batches are numbered after the inner face batches,
+   * i.e., in the range from n_inner_face_batches() to n_inner_face_batches()
+   * + n_boundary_face_batches().
+   */
+  unsigned int n_boundary_face_batches () const;
+
+  /**
+   * Return the boundary id of the face batch with the given index. All faces
+   * in a batch of boundary faces share the same boundary id.
+   */
+  types::boundary_id get_boundary_id (const unsigned int face_batch_number) const;
+
   /**
    * In case this structure was built based on a DoFHandler, this returns the
    * DoFHandler.
@@ -657,6 +830,14 @@ public:
   const DoFHandler<dim> &
   get_dof_handler (const unsigned int fe_component = 0) const;
 
+  /**
+   * Return the level of the mesh hierarchy this object works on, as given by
+   * AdditionalData::level_mg_handler, or numbers::invalid_unsigned_int if it
+   * works on the active cells.
+   */
+  unsigned int
+  get_mg_level () const;
+
   /**
    * This returns the cell iterator in deal.II speak to a given cell in the
    * renumbering of this structure.
@@ -818,6 +999,14 @@ public:
   const internal::MatrixFreeFunctions::DoFInfo &
   get_dof_info (const unsigned int fe_component = 0) const;
 
+  /**
+   * Return the connectivity information between the face batch with the
+   * given index and the cells on the interior and exterior side of the
+   * faces.
+   */
+  const internal::MatrixFreeFunctions::FaceToCellTopology<VectorizedArray<Number>::n_array_elements> &
+  get_face_info (const unsigned int face_batch_number) const;
+
   /**
    * Return the number of weights in the constraint pool.
    */
@@ -901,7 +1090,8 @@ private:
    */
   void
   initialize_indices (const std::vector<const ConstraintMatrix *> &constraint,
-                      const std::vector<IndexSet> &locally_owned_set);
+                      const std::vector<IndexSet> &locally_owned_set,
+                      const AdditionalData        &additional_data);
 
   /**
    * Initializes the DoFHandlers based on a DoFHandler<dim> argument.
@@ -996,6 +1186,19 @@ private:
    */
   internal::MatrixFreeFunctions::SizeInfo size_info;
 
+  /**
+   * Stores the batches of interior and boundary faces for face integrals.
+   */
+  internal::MatrixFreeFunctions::FaceInfo<VectorizedArray<Number>::n_array_elements> face_info;
+
+  /**
+   * Stores the level and index of the cells owned by other MPI processes
+   * that are accessed on the exterior side of the faces in @p face_info. In
+   * the face batches, these cells are numbered after the cells in @p
+   * cell_level_index.
+   */
+  std::vector<std::pair<unsigned int,unsigned int> > ghost_cell_level_index;
+
   /**
    * Information regarding the shared memory parallelization.
    */
@@ -1117,6 +1320,42 @@ MatrixFree<dim,Number>::n_macro_cells () const
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_inner_face_batches () const
+{
+  return face_info.n_inner_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::n_boundary_face_batches () const
+{
+  return face_info.n_boundary_face_batches;
+}
+
+
+
+template <int dim, typename Number>
+inline
+types::boundary_id
+MatrixFree<dim,Number>::get_boundary_id (const unsigned int face_batch_number) const
+{
+  Assert (face_batch_number >= face_info.n_inner_face_batches &&
+          face_batch_number < face_info.n_inner_face_batches +
+          face_info.n_boundary_face_batches,
+          ExcIndexRange (face_batch_number, face_info.n_inner_face_batches,
+                         face_info.n_inner_face_batches +
+                         face_info.n_boundary_face_batches));
+  return face_info.faces[face_batch_number].boundary_id;
+}
+
+
+
 template <int dim, typename Number>
 inline
 unsigned int
@@ -1148,6 +1387,17 @@ MatrixFree<dim,Number>::get_dof_info (unsigned int dof_index) const
 
 
 
+template <int dim, typename Number>
+inline
+const internal::MatrixFreeFunctions::FaceToCellTopology<VectorizedArray<Number>::n_array_elements> &
+MatrixFree<dim,Number>::get_face_info (const unsigned int face_batch_number) const
+{
+  AssertIndexRange (face_batch_number, face_info.faces.size());
+  return face_info.faces[face_batch_number];
+}
+
+
+
 template <int dim, typename Number>
 inline
 unsigned int
@@ -1263,6 +1513,16 @@ MatrixFree<dim,Number>::renumber_dofs (std::vector<types::global_dof_index> &ren
 
 
 
+template <int dim, typename Number>
+inline
+unsigned int
+MatrixFree<dim,Number>::get_mg_level () const
+{
+  return dof_handlers.level;
+}
+
+
+
 template <int dim, typename Number>
 inline
 const DoFHandler<dim> &
@@ -1822,13 +2082,17 @@ namespace internal
 
 
 
+  // if the vector already holds valid ghost values (e.g. because the user
+  // called update_ghost_values() before entering the loop), there is no need
+  // to exchange the data once again
   template <typename Number>
   inline
   bool update_ghost_values_start (const LinearAlgebra::distributed::Vector<Number> &vec,
                                   const unsigned int                  channel = 0)
   {
     bool return_value = !vec.has_ghost_elements();
-    vec.update_ghost_values_start(channel);
+    if (return_value == true)
+      vec.update_ghost_values_start(channel);
     return return_value;
   }
 
@@ -1941,11 +2205,15 @@ namespace internal
 
 
 
+  // only wait for the exchange if it was started in
+  // update_ghost_values_start(), i.e., if the vector is not yet in ghosted
+  // state
   template <typename Number>
   inline
   void update_ghost_values_finish (const LinearAlgebra::distributed::Vector<Number> &vec)
   {
-    vec.update_ghost_values_finish();
+    if (vec.has_ghost_elements() == false)
+      vec.update_ghost_values_finish();
   }
 
 
@@ -2689,6 +2957,194 @@ MatrixFree<dim,Number>::cell_loop
 }
 
 
+
+template <int dim, typename Number>
+template <typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim, Number>::loop
+(const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &cell_operation,
+ const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &face_operation,
+ const std::function<void (const MatrixFree<dim,Number> &,
+                           OutVector &,
+                           const InVector &,
+                           const std::pair<unsigned int,
+                           unsigned int> &)> &boundary_operation,
+ OutVector       &dst,
+ const InVector  &src) const
+{
+  // in any case, need to start the ghost import at the beginning
+  bool ghosts_were_not_set = internal::update_ghost_values_start (src);
+
+  const unsigned int n_inner_faces_plain =
+    face_info.n_inner_face_batches - face_info.n_inner_face_batches_ghosted;
+  const unsigned int boundary_faces_start = face_info.n_inner_face_batches;
+  const unsigned int n_boundary_faces_plain =
+    face_info.n_boundary_face_batches - face_info.n_boundary_face_batches_ghosted;
+
+  std::pair<unsigned int,unsigned int> range;
+
+  // First operate on cells and faces where no ghost data is needed
+  range = std::make_pair (0U, size_info.boundary_cells_start);
+  if (range.second > range.first)
+    cell_operation (*this, dst, src, range);
+
+  range = std::make_pair (0U, n_inner_faces_plain);
+  if (range.second > range.first)
+    face_operation (*this, dst, src, range);
+
+  range = std::make_pair (boundary_faces_start,
+                          boundary_faces_start + n_boundary_faces_plain);
+  if (range.second > range.first)
+    boundary_operation (*this, dst, src, range);
+
+  // before starting operations on cells and faces that contain ghost nodes,
+  // wait for the MPI commands to finish
+  internal::update_ghost_values_finish(src);
+
+  range = std::make_pair (size_info.boundary_cells_start,
+                          size_info.boundary_cells_end);
+  if (range.second > range.first)
+    cell_operation (*this, dst, src, range);
+
+  range = std::make_pair (n_inner_faces_plain, face_info.n_inner_face_batches);
+  if (range.second > range.first)
+    face_operation (*this, dst, src, range);
+
+  range = std::make_pair (boundary_faces_start + n_boundary_faces_plain,
+                          boundary_faces_start + face_info.n_boundary_face_batches);
+  if (range.second > range.first)
+    boundary_operation (*this, dst, src, range);
+
+  // all contributions to ghost entries of the destination vector are done,
+  // so start sending them to the owners
+  internal::compress_start(dst);
+
+  // Finally operate on the remaining cells where no ghost data is needed
+  range = std::make_pair (size_info.boundary_cells_end,
+                          size_info.n_macro_cells);
+  if (range.second > range.first)
+    cell_operation (*this, dst, src, range);
+
+  internal::compress_finish(dst);
+  internal::reset_ghost_values(src, ghosts_were_not_set);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &)const,
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &)const,
+ const CLASS    *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  typedef std::function<void (const MatrixFree<dim,Number> &,
+                              OutVector &,
+                              const InVector &,
+                              const std::pair<unsigned int,
+                              unsigned int> &)> function_type;
+  const function_type
+  cell_function = std::bind<void>(cell_operation,
+                                  owning_class,
+                                  std::placeholders::_1,
+                                  std::placeholders::_2,
+                                  std::placeholders::_3,
+                                  std::placeholders::_4),
+  face_function = std::bind<void>(face_operation,
+                                  owning_class,
+                                  std::placeholders::_1,
+                                  std::placeholders::_2,
+                                  std::placeholders::_3,
+                                  std::placeholders::_4),
+  boundary_function = std::bind<void>(boundary_operation,
+                                      owning_class,
+                                      std::placeholders::_1,
+                                      std::placeholders::_2,
+                                      std::placeholders::_3,
+                                      std::placeholders::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
+
+template <int dim, typename Number>
+template <typename CLASS, typename OutVector, typename InVector>
+inline
+void
+MatrixFree<dim,Number>::loop
+(void (CLASS::*cell_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*face_operation)(const MatrixFree<dim,Number> &,
+                               OutVector &,
+                               const InVector &,
+                               const std::pair<unsigned int,
+                               unsigned int> &),
+ void (CLASS::*boundary_operation)(const MatrixFree<dim,Number> &,
+                                   OutVector &,
+                                   const InVector &,
+                                   const std::pair<unsigned int,
+                                   unsigned int> &),
+ CLASS          *owning_class,
+ OutVector      &dst,
+ const InVector &src) const
+{
+  typedef std::function<void (const MatrixFree<dim,Number> &,
+                              OutVector &,
+                              const InVector &,
+                              const std::pair<unsigned int,
+                              unsigned int> &)> function_type;
+  const function_type
+  cell_function = std::bind<void>(cell_operation,
+                                  owning_class,
+                                  std::placeholders::_1,
+                                  std::placeholders::_2,
+                                  std::placeholders::_3,
+                                  std::placeholders::_4),
+  face_function = std::bind<void>(face_operation,
+                                  owning_class,
+                                  std::placeholders::_1,
+                                  std::placeholders::_2,
+                                  std::placeholders::_3,
+                                  std::placeholders::_4),
+  boundary_function = std::bind<void>(boundary_operation,
+                                      owning_class,
+                                      std::placeholders::_1,
+                                      std::placeholders::_2,
+                                      std::placeholders::_3,
+                                      std::placeholders::_4);
+  loop (cell_function, face_function, boundary_function, dst, src);
+}
+
+
 #endif  // ifndef DOXYGEN
 
 
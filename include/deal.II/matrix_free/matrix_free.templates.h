@@ -31,6 +31,7 @@
 #include <deal.II/matrix_free/shape_info.templates.h>
 #include <deal.II/matrix_free/mapping_info.templates.h>
 #include <deal.II/matrix_free/dof_info.templates.h>
+#include <deal.II/matrix_free/face_setup_internal.h>
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -78,6 +79,8 @@ copy_from (const MatrixFree<dim,Number> &v)
   cell_level_index = v.cell_level_index;
   task_info = v.task_info;
   size_info = v.size_info;
+  face_info = v.face_info;
+  ghost_cell_level_index = v.ghost_cell_level_index;
   indices_are_initialized = v.indices_are_initialized;
   mapping_is_initialized  = v.mapping_is_initialized;
 }
@@ -163,7 +166,7 @@ internal_reinit(const Mapping<dim>                          &mapping,
       // constraint_pool_data. It also reorders the way cells are gone through
       // (to separate cells with overlap to other processors from others
       // without).
-      initialize_indices (constraint, locally_owned_set);
+      initialize_indices (constraint, locally_owned_set, additional_data);
     }
 
   // initialize bare structures
@@ -204,6 +207,14 @@ internal_reinit(const Mapping<dim>                          &mapping,
                                dof_info[0].cell_active_fe_index, mapping, quad,
                                additional_data.mapping_update_flags);
 
+      // the face data is set up for the face batches collected together with
+      // the indices
+      mapping_info.initialize_faces (dof_handler[0]->get_triangulation(),
+                                     cell_level_index, ghost_cell_level_index,
+                                     face_info.faces, mapping,
+                                     additional_data.mapping_update_flags_boundary_faces |
+                                     additional_data.mapping_update_flags_inner_faces);
+
       mapping_is_initialized = true;
     }
 }
@@ -297,7 +308,7 @@ internal_reinit(const Mapping<dim>                            &mapping,
       // constraint_pool_data. It also reorders the way cells are gone through
       // (to separate cells with overlap to other processors from others
       // without).
-      initialize_indices (constraint, locally_owned_set);
+      initialize_indices (constraint, locally_owned_set, additional_data);
     }
 
   // initialize bare structures
@@ -501,7 +512,8 @@ initialize_dof_handlers (const std::vector<const hp::DoFHandler<dim>*> &dof_hand
 template <int dim, typename Number>
 void MatrixFree<dim,Number>::initialize_indices
 (const std::vector<const ConstraintMatrix *> &constraint,
- const std::vector<IndexSet>                 &locally_owned_set)
+ const std::vector<IndexSet>                 &locally_owned_set,
+ const AdditionalData                        &additional_data)
 {
   const unsigned int n_fe = dof_handlers.n_dof_handlers;
   const unsigned int n_active_cells = cell_level_index.size();
@@ -664,6 +676,41 @@ void MatrixFree<dim,Number>::initialize_indices
         boundary_cells.push_back(counter);
     }
 
+  // in case face integrals are requested, collect the cells of other MPI
+  // processes on the exterior side of faces computed on this process and
+  // read their indices. The indices must be known before the ghost indices
+  // are assigned.
+  const bool setup_faces =
+    (additional_data.mapping_update_flags_boundary_faces != update_default ||
+     additional_data.mapping_update_flags_inner_faces != update_default);
+  internal::MatrixFreeFunctions::FaceSetup<dim> face_setup;
+  if (setup_faces == true)
+    {
+      AssertThrow (dof_handlers.active_dof_handler == DoFHandlers::usual,
+                   ExcNotImplemented());
+      face_setup.initialize (dof_handlers.dof_handler[0]->get_triangulation(),
+                             dof_handlers.level, size_info.my_pid,
+                             cell_level_index);
+      ghost_cell_level_index = face_setup.ghost_cells;
+      for (unsigned int g=0; g<ghost_cell_level_index.size(); ++g)
+        for (unsigned int no=0; no<n_fe; ++no)
+          {
+            const DoFHandler<dim> *dofh = dof_handlers.dof_handler[no];
+            typename DoFHandler<dim>::cell_iterator
+            cell_it (&dofh->get_triangulation(),
+                     ghost_cell_level_index[g].first,
+                     ghost_cell_level_index[g].second,
+                     dofh);
+            local_dof_indices.resize (dof_info[no].dofs_per_cell[0]);
+            if (dof_handlers.level == numbers::invalid_unsigned_int)
+              cell_it->get_dof_indices(local_dof_indices);
+            else
+              cell_it->get_mg_dof_indices(local_dof_indices);
+            dof_info[no].read_ghost_cell_dof_indices
+            (local_dof_indices, shape_info(no,0,0,0).lexicographic_numbering);
+          }
+    }
+
   const unsigned int vectorization_length =
     VectorizedArray<Number>::n_array_elements;
   std::vector<unsigned int> irregular_cells;
@@ -771,6 +818,16 @@ void MatrixFree<dim,Number>::initialize_indices
                                constraint_pool_row_index,
                                irregular_cells, vectorization_length);
 
+  // set up the face batches based on the final cell numbering
+  if (setup_faces == true)
+    {
+      std::vector<unsigned int> n_filled_lanes (size_info.n_macro_cells);
+      for (unsigned int i=0; i<size_info.n_macro_cells; ++i)
+        n_filled_lanes[i] = n_components_filled(i);
+      face_setup.generate_faces (cell_level_index, n_filled_lanes, size_info,
+                                 face_info);
+    }
+
   indices_are_initialized = true;
 }
 
@@ -782,7 +839,9 @@ void MatrixFree<dim,Number>::clear()
   dof_info.clear();
   mapping_info.clear();
   cell_level_index.clear();
+  ghost_cell_level_index.clear();
   size_info.clear();
+  face_info.clear();
   task_info.clear();
   dof_handlers.dof_handler.clear();
   dof_handlers.hp_dof_handler.clear();
@@ -797,6 +856,8 @@ std::size_t MatrixFree<dim,Number>::memory_consumption () const
 {
   std::size_t memory = MemoryConsumption::memory_consumption (dof_info);
   memory += MemoryConsumption::memory_consumption (cell_level_index);
+  memory += MemoryConsumption::memory_consumption (ghost_cell_level_index);
+  memory += face_info.memory_consumption();
   memory += MemoryConsumption::memory_consumption (shape_info);
   memory += MemoryConsumption::memory_consumption (constraint_pool_data);
   memory += MemoryConsumption::memory_consumption (constraint_pool_row_index);
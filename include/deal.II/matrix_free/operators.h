@@ -24,6 +24,7 @@
 
 #include <deal.II/lac/diagonal_matrix.h>
 #include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/tensor_product_matrix.h>
 #include <deal.II/lac/vector_view.h>
 #include <deal.II/multigrid/mg_constrained_dofs.h>
 #include <deal.II/matrix_free/matrix_free.h>
@@ -768,6 +769,176 @@ namespace MatrixFreeOperators
 
 
 
+  /**
+   * This class implements a block-Jacobi method for matrix-free operators
+   * where the blocks are the cells of the mesh and the inverse of every
+   * block is applied by the fast diagonalization method of
+   * TensorProductMatrixSymmetricSum. This gives a cell-wise smoother for
+   * operators that, on every cell, can be written as a sum of tensor products
+   * of 1D mass and derivative matrices, like the Laplacian discretized by
+   * the symmetric interior penalty discontinuous Galerkin method on
+   * axis-aligned cells. For such operators, the 1D derivative matrices
+   * contain the cell and face terms of the cell in one direction. On other
+   * cells, the tensor product matrices can still be used as an
+   * approximation of the cell matrices.
+   *
+   * The 1D matrices are given for every batch of cells of the MatrixFree
+   * object, with the matrices of the individual cells in the lanes of the
+   * VectorizedArray entries, and in the order of the degrees of freedom of
+   * FEEvaluation, i.e., lexicographic. The tensor product matrices of all
+   * cells of a batch are set up and applied simultaneously with vectorized
+   * instructions. For discontinuous elements, the cells are the diagonal
+   * blocks of the matrix and this is a true block-Jacobi method. For
+   * continuous elements, the contributions of cells that share a degree of
+   * freedom are added, which gives an additive Schwarz method with one cell
+   * per subdomain.
+   *
+   * The class provides the interface of a preconditioner with vmult(), which
+   * computes $\omega \sum_K R_K^T L_K^{-1} R_K \, src$ for the relaxation
+   * parameter $\omega$, and an initialize() function that takes the operator
+   * as the relaxation methods in PreconditionRelaxation do. Therefore, it can
+   * be used as a smoother in Multigrid through MGSmootherPrecondition, or as
+   * the inner preconditioner of PreconditionChebyshev:
+   * @code
+   * typedef MatrixFreeOperators::TensorProductBlockJacobi<dim,fe_degree> BlockJacobi;
+   * MGLevelObject<typename BlockJacobi::AdditionalData> smoother_data;
+   * smoother_data.resize(0, max_level);
+   * for (unsigned int level=0; level<=max_level; ++level)
+   *   {
+   *     smoother_data[level].relaxation = 0.7;
+   *     fill_1d_matrices(level, smoother_data[level].mass_matrices,
+   *                      smoother_data[level].derivative_matrices);
+   *   }
+   * MGSmootherPrecondition<LevelMatrixType,BlockJacobi,VectorType> smoother;
+   * smoother.initialize(level_matrices, smoother_data);
+   * @endcode
+   *
+   * Only the non-blocked vector variant is supported, since a single
+   * FEEvaluation object is used in the apply function. The components of a
+   * vector-valued element are all treated by the same tensor product matrix.
+   */
+  template <int dim, int fe_degree, int n_components = 1, typename VectorType = LinearAlgebra::distributed::Vector<double> >
+  class TensorProductBlockJacobi : public Subscriptor
+  {
+  public:
+    /**
+     * Number typedef.
+     */
+    typedef typename VectorType::value_type value_type;
+
+    /**
+     * size_type needed for preconditioner classes.
+     */
+    typedef typename VectorType::size_type size_type;
+
+    /**
+     * Standardized data struct to pipe additional parameters to the
+     * preconditioner.
+     */
+    struct AdditionalData
+    {
+      /**
+       * Constructor.
+       */
+      AdditionalData (const double       relaxation = 1.,
+                      const unsigned int dof_handler_index = 0);
+
+      /**
+       * The relaxation parameter $\omega$ the result of the block-Jacobi
+       * method is multiplied with.
+       */
+      double relaxation;
+
+      /**
+       * The number of the DoFHandler within the MatrixFree object whose
+       * degrees of freedom the preconditioner works on.
+       */
+      unsigned int dof_handler_index;
+
+      /**
+       * The 1D mass matrices of the coordinate directions for every batch
+       * of cells of the MatrixFree object. If the vector has a single entry,
+       * the same matrices are used for all batches, which is useful for
+       * uniform meshes.
+       */
+      std::vector<std::array<Table<2,VectorizedArray<value_type> >, dim> > mass_matrices;
+
+      /**
+       * The 1D derivative matrices of the coordinate directions for every
+       * batch of cells, in the same format as #mass_matrices.
+       */
+      std::vector<std::array<Table<2,VectorizedArray<value_type> >, dim> > derivative_matrices;
+    };
+
+    /**
+     * Default constructor.
+     */
+    TensorProductBlockJacobi ();
+
+    /**
+     * Set up the tensor product matrices for the MatrixFree object of the
+     * given operator, which needs to provide a function
+     * <tt>get_matrix_free()</tt> like the classes derived from Base.
+     */
+    template <typename OperatorType>
+    void initialize (const OperatorType     &op,
+                     const AdditionalData   &additional_data = AdditionalData());
+
+    /**
+     * Set up the tensor product matrices for the given MatrixFree object.
+     */
+    void initialize (std::shared_ptr<const MatrixFree<dim,value_type> > data,
+                     const AdditionalData   &additional_data = AdditionalData());
+
+    /**
+     * Release all memory and return to a state just like after having called
+     * the default constructor.
+     */
+    void clear ();
+
+    /**
+     * Apply the block-Jacobi method, i.e., the inverse of the tensor product
+     * matrix of every cell to @p src, multiplied by the relaxation parameter.
+     */
+    void vmult (VectorType       &dst,
+                const VectorType &src) const;
+
+    /**
+     * Apply the transpose of the block-Jacobi method. Since the tensor
+     * product matrices are symmetric, this is the same as vmult().
+     */
+    void Tvmult (VectorType       &dst,
+                 const VectorType &src) const;
+
+  private:
+    /**
+     * Apply the inverses of the tensor product matrices on a range of cell
+     * batches.
+     */
+    void local_apply_cell (const MatrixFree<dim,value_type>            &data,
+                           VectorType                                  &dst,
+                           const VectorType                            &src,
+                           const std::pair<unsigned int,unsigned int>  &cell_range) const;
+
+    /**
+     * The MatrixFree object the preconditioner works on.
+     */
+    std::shared_ptr<const MatrixFree<dim,value_type> > data;
+
+    /**
+     * The relaxation parameter and the DoFHandler index.
+     */
+    AdditionalData additional_data;
+
+    /**
+     * The tensor product matrices of the cell batches, or a single one used
+     * for all batches.
+     */
+    std::vector<TensorProductMatrixSymmetricSum<dim,VectorizedArray<value_type>,fe_degree+1> > cell_matrices;
+  };
+
+
+
   // ------------------------------------ inline functions ---------------------
 
   template <int dim, int fe_degree, int n_components, typename Number>
@@ -1747,6 +1918,143 @@ namespace MatrixFreeOperators
   }
 
 
+  //------------------------- TensorProductBlockJacobi -------------------------
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::AdditionalData::
+  AdditionalData (const double       relaxation,
+                  const unsigned int dof_handler_index)
+    :
+    relaxation (relaxation),
+    dof_handler_index (dof_handler_index)
+  {}
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  TensorProductBlockJacobi ()
+    :
+    Subscriptor()
+  {}
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  template <typename OperatorType>
+  void
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  initialize (const OperatorType     &op,
+              const AdditionalData   &additional_data)
+  {
+    initialize (op.get_matrix_free(), additional_data);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  void
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  initialize (std::shared_ptr<const MatrixFree<dim,value_type> > data_in,
+              const AdditionalData   &additional_data_in)
+  {
+    Assert (data_in.get() != nullptr, ExcNotInitialized());
+    AssertDimension (additional_data_in.mass_matrices.size(),
+                     additional_data_in.derivative_matrices.size());
+    Assert (additional_data_in.mass_matrices.size() == 1 ||
+            additional_data_in.mass_matrices.size() == data_in->n_macro_cells(),
+            ExcDimensionMismatch (additional_data_in.mass_matrices.size(),
+                                  data_in->n_macro_cells()));
+
+    data = data_in;
+    additional_data.relaxation = additional_data_in.relaxation;
+    additional_data.dof_handler_index = additional_data_in.dof_handler_index;
+
+    // the matrices are only kept in the tensor product matrices, so they
+    // are not copied into the additional data
+    cell_matrices.resize (additional_data_in.mass_matrices.size());
+    parallel::apply_to_subranges
+    (0U, static_cast<unsigned int>(cell_matrices.size()),
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      for (unsigned int i=begin; i<end; ++i)
+        cell_matrices[i].reinit (additional_data_in.mass_matrices[i],
+                                 additional_data_in.derivative_matrices[i]);
+    },
+    16);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  void
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  clear ()
+  {
+    data.reset();
+    cell_matrices.clear();
+    additional_data = AdditionalData();
+  }
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  void
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  vmult (VectorType       &dst,
+         const VectorType &src) const
+  {
+    Assert (data.get() != nullptr, ExcNotInitialized());
+    dst = 0;
+    data->cell_loop (&TensorProductBlockJacobi::local_apply_cell,
+                     this, dst, src);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  void
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  Tvmult (VectorType       &dst,
+          const VectorType &src) const
+  {
+    vmult (dst, src);
+  }
+
+
+
+  template <int dim, int fe_degree, int n_components, typename VectorType>
+  void
+  TensorProductBlockJacobi<dim, fe_degree, n_components, VectorType>::
+  local_apply_cell (const MatrixFree<dim,value_type>            &data,
+                    VectorType                                  &dst,
+                    const VectorType                            &src,
+                    const std::pair<unsigned int,unsigned int>  &cell_range) const
+  {
+    FEEvaluation<dim,fe_degree,fe_degree+1,n_components,value_type>
+    phi (data, additional_data.dof_handler_index);
+    AssertDimension (phi.dofs_per_cell, phi.tensor_dofs_per_cell);
+    const VectorizedArray<value_type> relaxation
+      = make_vectorized_array<value_type> (additional_data.relaxation);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        const TensorProductMatrixSymmetricSum<dim,VectorizedArray<value_type>,fe_degree+1>
+        &cell_matrix = cell_matrices[cell_matrices.size() == 1 ? 0 : cell];
+        for (unsigned int c=0; c<n_components; ++c)
+          {
+            VectorizedArray<value_type> *values = phi.begin_dof_values() +
+                                                  c*phi.dofs_per_cell;
+            cell_matrix.apply_inverse (values, values);
+            for (unsigned int i=0; i<phi.dofs_per_cell; ++i)
+              values[i] *= relaxation;
+          }
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+
 } // end of namespace MatrixFreeOperators
 
 
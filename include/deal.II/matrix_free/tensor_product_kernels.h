@@ -212,23 +212,36 @@ namespace internal
   // out from cell values. As opposed to the apply_tensor_product method, this
   // method assumes that the directions orthogonal to the face have
   // fe_degree+1 degrees of freedom per direction and not n_q_points_1d for
-  // those directions lower than the one currently applied
+  // those directions lower than the one currently applied. The argument
+  // shape_data is expected to contain the values of the 1D shape functions
+  // on the face, followed by the first and second derivatives, as stored in
+  // ShapeInfo::shape_data_on_face. If max_derivative is larger than zero,
+  // also the derivatives normal to the face are computed (or, in the
+  // direction from face to cell, integrated) and placed after the face
+  // values at an offset of (fe_degree+1)^(dim-1). For fe_degree == -1, the
+  // number of 1D degrees of freedom is taken from the argument
+  // n_dofs_1d_runtime.
   template <int dim, int fe_degree, typename Number, int face_direction,
-            bool dof_to_quad, bool add>
+            bool dof_to_quad, bool add, int max_derivative = 0>
   inline
   void
   apply_tensor_product_face (const Number *shape_data,
                              const Number in [],
-                             Number       out [])
+                             Number       out [],
+                             const int    n_dofs_1d_runtime = fe_degree+1)
   {
-    const int n_blocks1 = dim > 1 ? (fe_degree+1) : 1;
-    const int n_blocks2 = dim > 2 ? (fe_degree+1) : 1;
+    const int n_dofs_1d = fe_degree >= 0 ? fe_degree+1 : n_dofs_1d_runtime;
+    const int n_blocks1 = dim > 1 ? n_dofs_1d : 1;
+    const int n_blocks2 = dim > 2 ? n_dofs_1d : 1;
 
     AssertIndexRange (face_direction, dim);
-    const int mm     = dof_to_quad ? (fe_degree+1) : 1,
-              nn     = dof_to_quad ? 1 : (fe_degree+1);
+    AssertIndexRange (max_derivative, 3);
+    const int mm     = dof_to_quad ? n_dofs_1d : 1,
+              nn     = dof_to_quad ? 1 : n_dofs_1d;
 
-    const int stride = Utilities::fixed_int_power<fe_degree+1,face_direction>::value;
+    const int stride = face_direction == 0 ? 1 :
+                       (face_direction == 1 ? n_dofs_1d : n_dofs_1d*n_dofs_1d);
+    const int face_stride = dim > 2 ? n_dofs_1d*n_dofs_1d : (dim > 1 ? n_dofs_1d : 1);
 
     for (int i2=0; i2<n_blocks2; ++i2)
       {
@@ -237,20 +250,50 @@ namespace internal
             if (dof_to_quad == true)
               {
                 Number res0 = shape_data[0] * in[0];
+                Number res1, res2;
+                if (max_derivative > 0)
+                  res1 = shape_data[n_dofs_1d] * in[0];
+                if (max_derivative > 1)
+                  res2 = shape_data[2*n_dofs_1d] * in[0];
                 for (int ind=1; ind<mm; ++ind)
-                  res0 += shape_data[ind] * in[stride*ind];
+                  {
+                    res0 += shape_data[ind] * in[stride*ind];
+                    if (max_derivative > 0)
+                      res1 += shape_data[ind+n_dofs_1d] * in[stride*ind];
+                    if (max_derivative > 1)
+                      res2 += shape_data[ind+2*n_dofs_1d] * in[stride*ind];
+                  }
                 if (add == false)
-                  out[0]  = res0;
+                  {
+                    out[0]  = res0;
+                    if (max_derivative > 0)
+                      out[face_stride] = res1;
+                    if (max_derivative > 1)
+                      out[2*face_stride] = res2;
+                  }
                 else
-                  out[0] += res0;
+                  {
+                    out[0] += res0;
+                    if (max_derivative > 0)
+                      out[face_stride] += res1;
+                    if (max_derivative > 1)
+                      out[2*face_stride] += res2;
+                  }
               }
             else
               {
                 for (int col=0; col<nn; ++col)
-                  if (add == false)
-                    out[col*stride]  = shape_data[col] * in[0];
-                  else
-                    out[col*stride] += shape_data[col] * in[0];
+                  {
+                    Number res = shape_data[col] * in[0];
+                    if (max_derivative > 0)
+                      res += shape_data[col+n_dofs_1d] * in[face_stride];
+                    if (max_derivative > 1)
+                      res += shape_data[col+2*n_dofs_1d] * in[2*face_stride];
+                    if (add == false)
+                      out[col*stride]  = res;
+                    else
+                      out[col*stride] += res;
+                  }
               }
 
             // increment: in regular case, just go to the next point in
@@ -271,9 +314,9 @@ namespace internal
                 if (dim == 3)
                   {
                     if (dof_to_quad)
-                      out += fe_degree;
+                      out += n_dofs_1d-1;
                     else
-                      in += fe_degree;
+                      in += n_dofs_1d-1;
                   }
                 break;
               case 2:
@@ -290,9 +333,9 @@ namespace internal
             out += nn*(nn-1);
             // adjust for local coordinate system zx
             if (dof_to_quad)
-              out -= (fe_degree+1)*(fe_degree+1)-1;
+              out -= n_dofs_1d*n_dofs_1d-1;
             else
-              in -= (fe_degree+1)*(fe_degree+1)-1;
+              in -= n_dofs_1d*n_dofs_1d-1;
           }
       }
   }
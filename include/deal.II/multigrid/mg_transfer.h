@@ -303,6 +303,16 @@ public:
   /**
    * Transfer from a vector on the global grid to vectors defined on each of
    * the levels separately, i.a. an @p MGVector.
+   *
+   * The number type @p Number2 of the global vector can be different from
+   * the number type @p Number of the level vectors. This allows to run the
+   * multigrid cycle in single precision as a preconditioner for an outer
+   * solver in double precision, see the discussion in the class
+   * MGTransferMatrixFree.
+   *
+   * If partitioners for the level vectors have been passed to the build()
+   * function of a derived class, the level vectors in @p dst are initialized
+   * with these partitioners.
    */
   template <int dim, typename Number2, int spacedim>
   void
@@ -436,6 +446,14 @@ protected:
    * ghost entries for inserting the result into a global vector.
    */
   mutable MGLevelObject<LinearAlgebra::distributed::Vector<Number> > ghosted_level_vector;
+
+  /**
+   * Partitioners for the level vectors set by the build() function of a
+   * derived class, e.g. the ones of the MatrixFree objects used for the level
+   * operators. If empty, the level vectors are initialized with the locally
+   * owned level degrees of freedom only.
+   */
+  std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> > external_partitioners;
 };
 
 
@@ -371,6 +371,18 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::copy_to_mg
 {
   AssertIndexRange(dst.max_level(), mg_dof_handler.get_triangulation().n_global_levels());
   AssertIndexRange(dst.min_level(), dst.max_level()+1);
+
+  // use the partitioners given to build(), if any, such that the level
+  // vectors are directly compatible with the level operators. The call to
+  // reinit_vector below then only zeros the vectors
+  if (!external_partitioners.empty())
+    {
+      AssertDimension(external_partitioners.size(),
+                      mg_dof_handler.get_triangulation().n_global_levels());
+      for (unsigned int level=dst.min_level(); level<=dst.max_level(); ++level)
+        if (dst[level].get_partitioner().get() != external_partitioners[level].get())
+          dst[level].reinit(external_partitioners[level]);
+    }
   reinit_vector(mg_dof_handler, component_to_block_map, dst);
 
   if (perform_plain_copy)
@@ -45,6 +45,33 @@ DEAL_II_NAMESPACE_OPEN
  * of one of these elements. Systems with different elements or other elements
  * are currently not implemented.
  *
+ * <h3>Mixed-precision multigrid</h3>
+ *
+ * The number type @p Number of this class, the level vectors, the level
+ * operators and the smoothers can be chosen independently of the number type
+ * of the outer solver: The functions copy_to_mg() and copy_from_mg() accept
+ * global vectors of type LinearAlgebra::distributed::Vector<Number2> and
+ * convert between the two precisions. As a consequence, PreconditionMG can
+ * be used with a multigrid cycle running in single precision, e.g. with
+ * level operators based on MatrixFree<dim,float> working on
+ * VectorizedArray<float> with twice as many SIMD lanes as for double, as a
+ * preconditioner for SolverCG working with vectors in double precision:
+ * @code
+ * MGTransferMatrixFree<dim,float> mg_transfer(mg_constrained_dofs);
+ * mg_transfer.build(dof_handler, partitioners);
+ * ...
+ * Multigrid<LinearAlgebra::distributed::Vector<float> > mg(...);
+ * PreconditionMG<dim, LinearAlgebra::distributed::Vector<float>,
+ *                MGTransferMatrixFree<dim,float> >
+ *   preconditioner(dof_handler, mg, mg_transfer);
+ *
+ * SolverCG<LinearAlgebra::distributed::Vector<double> > solver(control);
+ * solver.solve(system_matrix, solution, rhs, preconditioner);
+ * @endcode
+ * Since multigrid is only used as a preconditioner, the reduced accuracy of
+ * single precision does not affect the accuracy of the final solution, while
+ * the memory transfer in the multigrid cycle is roughly cut in half.
+ *
  * @author Martin Kronbichler
  * @date 2016
  */
@@ -81,8 +108,17 @@ public:
 
   /**
    * Actually build the information for the prolongation for each level.
+   *
+   * The optional argument @p external_partitioners allows to specify the
+   * parallel layout of the level vectors created by copy_to_mg(), one
+   * partitioner per level. Passing the partitioners of the level operators,
+   * e.g. MatrixFree::get_vector_partitioner(), avoids that the vector layout
+   * needs to be adjusted inside the level operators. If empty, the level
+   * vectors only contain the locally owned level degrees of freedom.
    */
-  void build (const DoFHandler<dim,dim> &mg_dof);
+  void build (const DoFHandler<dim,dim> &mg_dof,
+              const std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> > &external_partitioners
+              = std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> >());
 
   /**
    * Prolongate a vector from level <tt>to_level-1</tt> to level
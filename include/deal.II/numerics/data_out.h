@@ -286,6 +286,48 @@ public:
                               const unsigned int n_subdivisions = 0,
                               const CurvedCellRegion curved_region = curved_boundary);
 
+  /**
+   * Collective MPI call that builds the patches and writes them from all
+   * participating processors to a single .vtu file in one go, without ever
+   * storing the patches of all cells in memory. In contrast to calling
+   * build_patches() followed by DataOutInterface::write_vtu_in_parallel(),
+   * the locally owned cells are split into batches of @p n_cells_per_batch
+   * cells. The patches of one batch are built, written to the file, and
+   * released before the next batch is processed, so the peak memory
+   * consumption of the output is bounded by the size of one batch rather than
+   * by the size of the mesh.
+   *
+   * The data is stored in the raw binary appended data section of the VTU
+   * format, compressed with zlib in parallel if deal.II was configured with
+   * zlib and the compression level set in the DataOutBase::VtkFlags is not
+   * DataOutBase::VtkFlags::no_compression. Each batch becomes a separate
+   * piece of the unstructured grid in the file. See
+   * DataOutInterface::write_vtu_in_parallel_batched() for details on the
+   * layout of the file.
+   *
+   * The @p n_subdivisions argument has the same meaning as for
+   * build_patches(). Since the patches are released after they have been
+   * written, this object does not store any patches after this function
+   * returns, i.e., the function can not be combined with the other output
+   * functions of the base classes.
+   */
+  void write_vtu_in_parallel_streaming (const char        *filename,
+                                        MPI_Comm           comm,
+                                        const unsigned int n_subdivisions = 0,
+                                        const unsigned int n_cells_per_batch = 10000);
+
+  /**
+   * Same as above, except that the additional parameters @p mapping and
+   * @p curved_region have the same meaning as for the second build_patches()
+   * function.
+   */
+  void write_vtu_in_parallel_streaming (const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &mapping,
+                                        const char                                                              *filename,
+                                        MPI_Comm                                                                 comm,
+                                        const unsigned int                                                       n_subdivisions = 0,
+                                        const CurvedCellRegion                                                   curved_region = curved_boundary,
+                                        const unsigned int                                                       n_cells_per_batch = 10000);
+
   /**
    * Return the first cell which we want output for. The default
    * implementation returns the first active cell, but you might want to
@@ -322,6 +364,30 @@ private:
    */
   virtual cell_iterator next_locally_owned_cell (const cell_iterator &cell);
 
+  /**
+   * Collect the locally owned cells for which patches are built, along with
+   * their index among the active cells, in @p all_cells. Furthermore, set up
+   * @p cell_to_patch_index_map such that
+   * <code>cell_to_patch_index_map[cell->level()][cell->index()]</code> is the
+   * position of a cell in @p all_cells.
+   */
+  void collect_cells (std::vector<std::pair<cell_iterator, unsigned int> > &all_cells,
+                      std::vector<std::vector<unsigned int> >              &cell_to_patch_index_map);
+
+  /**
+   * Build the patches for the cells in the range <code>[begin,end)</code>
+   * and store them in the @p patches member variable. The entries of
+   * @p cell_to_patch_index_map for these cells must be numbered from zero in
+   * the order of the range.
+   */
+  void build_patches_on_cell_range
+  (const Mapping<DoFHandlerType::dimension, DoFHandlerType::space_dimension> &mapping,
+   const unsigned int                                                        n_subdivisions,
+   const CurvedCellRegion                                                    curved_region,
+   const std::pair<cell_iterator, unsigned int>                             *begin,
+   const std::pair<cell_iterator, unsigned int>                             *end,
+   const std::vector<std::vector<unsigned int> >                            &cell_to_patch_index_map);
+
   /**
    * Build one patch. This function is called in a WorkStream context.
    *
@@ -20,6 +20,7 @@
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_accessor.h>
 #include <deal.II/fe/mapping_q1.h>
+#include <deal.II/grid/grid_tools_cache.h>
 #include <deal.II/base/function.h>
 #include <deal.II/base/point.h>
 #include <deal.II/base/tensor.h>
@@ -105,11 +106,14 @@ namespace Functions
    * computations across different, possibly non matching, grids. No knowledge
    * of the location of the points is assumed in this class, which makes it
    * rely entirely on the GridTools::find_active_cell_around_point utility for
-   * its job. However the class can be fed an "educated guess" of where the
-   * points that will be computed actually are by using the
-   * FEFieldFunction::set_active_cell method, so if you have a smart way to
-   * tell where your points are, you will save a lot of computational time by
-   * letting this class know.
+   * its job. To make this fast for many points, the class keeps a
+   * GridTools::Cache object for the triangulation and the mapping, whose
+   * search structures are built upon the first evaluation and rebuilt
+   * automatically when the triangulation changes. In addition, the class can
+   * be fed an "educated guess" of where the points that will be computed
+   * actually are by using the FEFieldFunction::set_active_cell method, so if
+   * you have a smart way to tell where your points are, you will save
+   * computational time by letting this class know.
    *
    *
    * <h3>Using FEFieldFunction with parallel::distributed::Triangulation</h3>
@@ -403,9 +407,11 @@ namespace Functions
      * points, the second is a list of quadrature points matching each cell of
      * the first list, and the third contains the index of the given
      * quadrature points, i.e., @p points[maps[3][4]] ends up as the 5th
-     * quadrature point in the 4th cell. This is where optimization would
-     * help. This function returns the number of cells that contain the given
-     * set of points.
+     * quadrature point in the 4th cell. This function returns the number of
+     * cells that contain the given set of points.
+     *
+     * The points are located in parallel through
+     * GridTools::compute_point_locations().
      */
     unsigned int
     compute_point_locations
@@ -437,11 +443,26 @@ namespace Functions
      */
     const Mapping<dim> &mapping;
 
+    /**
+     * The search structures for the triangulation of the DoF handler and the
+     * mapping.
+     */
+    const GridTools::Cache<dim,dim> cache;
+
     /**
      * The latest cell hint.
      */
     mutable cell_hint_t cell_hint;
 
+    /**
+     * Return the cell around the point @p p along with the reference
+     * coordinates of the point in it, using the cell hint of the current
+     * thread as a first guess and the search structures of #cache otherwise.
+     * Throw an exception if the cell is artificial.
+     */
+    std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+    find_cell_around_point (const Point<dim> &p) const;
+
     /**
      * Given a cell, return the reference coordinates of the given point
      * within this cell if it indeed lies within the cell. Otherwise return an
@@ -20,6 +20,7 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
 #include <deal.II/hp/fe_collection.h>
 #include <deal.II/hp/fe_values.h>
 #include <deal.II/hp/mapping_collection.h>
@@ -44,6 +45,7 @@ namespace Functions
     dh(&mydh, "FEFieldFunction"),
     data_vector(myv),
     mapping(mymapping),
+    cache(mydh.get_triangulation(), mymapping),
     cell_hint(dh->end())
   {
   }
@@ -66,31 +68,12 @@ namespace Functions
   {
     Assert (values.size() == this->n_components,
             ExcDimensionMismatch(values.size(), this->n_components));
-    typename DoFHandlerType::active_cell_iterator cell = cell_hint.get();
-    if (cell == dh->end())
-      cell = dh->begin_active();
-
-    boost::optional<Point<dim> >
-    qp = get_reference_coordinates (cell, p);
-    if (!qp)
-      {
-        const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-          = GridTools::find_active_cell_around_point (mapping, *dh, p);
-        AssertThrow (!my_pair.first->is_artificial(),
-                     VectorTools::ExcPointNotAvailableHere());
-
-        cell = my_pair.first;
-        qp = my_pair.second;
-      }
-
-    cell_hint.get() = cell;
-
-    // check that the current cell is available:
-    AssertThrow (!cell->is_artificial(),
-                 VectorTools::ExcPointNotAvailableHere());
+    const std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+    cell_and_point = find_cell_around_point (p);
+    const typename DoFHandlerType::active_cell_iterator &cell = cell_and_point.first;
 
     // Now we can find out about the point
-    Quadrature<dim> quad(qp.get());
+    Quadrature<dim> quad(cell_and_point.second);
     FEValues<dim> fe_v(mapping, cell->get_fe(), quad,
                        update_values);
     fe_v.reinit(cell);
@@ -123,31 +106,12 @@ namespace Functions
     typedef typename VectorType::value_type number;
     Assert (gradients.size() == this->n_components,
             ExcDimensionMismatch(gradients.size(), this->n_components));
-    typename DoFHandlerType::active_cell_iterator cell = cell_hint.get();
-    if (cell == dh->end())
-      cell = dh->begin_active();
-
-    boost::optional<Point<dim> >
-    qp = get_reference_coordinates (cell, p);
-    if (!qp)
-      {
-        const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-          = GridTools::find_active_cell_around_point (mapping, *dh, p);
-        AssertThrow (!my_pair.first->is_artificial(),
-                     VectorTools::ExcPointNotAvailableHere());
-
-        cell = my_pair.first;
-        qp = my_pair.second;
-      }
-
-    // check that the current cell is available:
-    AssertThrow (!cell->is_artificial(),
-                 VectorTools::ExcPointNotAvailableHere());
-
-    cell_hint.get() = cell;
+    const std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+    cell_and_point = find_cell_around_point (p);
+    const typename DoFHandlerType::active_cell_iterator &cell = cell_and_point.first;
 
     // Now we can find out about the point
-    Quadrature<dim> quad(qp.get());
+    Quadrature<dim> quad(cell_and_point.second);
     FEValues<dim> fe_v(mapping, cell->get_fe(), quad,
                        update_gradients);
     fe_v.reinit(cell);
@@ -195,31 +159,12 @@ namespace Functions
   {
     Assert (values.size() == this->n_components,
             ExcDimensionMismatch(values.size(), this->n_components));
-    typename DoFHandlerType::active_cell_iterator cell = cell_hint.get();
-    if (cell == dh->end())
-      cell = dh->begin_active();
-
-    boost::optional<Point<dim> >
-    qp = get_reference_coordinates (cell, p);
-    if (!qp)
-      {
-        const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-          = GridTools::find_active_cell_around_point (mapping, *dh, p);
-        AssertThrow (!my_pair.first->is_artificial(),
-                     VectorTools::ExcPointNotAvailableHere());
-
-        cell = my_pair.first;
-        qp = my_pair.second;
-      }
-
-    // check that the current cell is available:
-    AssertThrow (!cell->is_artificial(),
-                 VectorTools::ExcPointNotAvailableHere());
-
-    cell_hint.get() = cell;
+    const std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+    cell_and_point = find_cell_around_point (p);
+    const typename DoFHandlerType::active_cell_iterator &cell = cell_and_point.first;
 
     // Now we can find out about the point
-    Quadrature<dim> quad(qp.get());
+    Quadrature<dim> quad(cell_and_point.second);
     FEValues<dim> fe_v(mapping, cell->get_fe(), quad,
                        update_hessians);
     fe_v.reinit(cell);
@@ -438,162 +383,80 @@ namespace Functions
    std::vector<std::vector<Point<dim> > >                      &qpoints,
    std::vector<std::vector<unsigned int> >                     &maps) const
   {
-    // How many points are here?
-    const unsigned int np = points.size();
-
     // Reset output maps.
     cells.clear();
     qpoints.clear();
     maps.clear();
 
     // Now the easy case.
-    if (np==0) return 0;
+    if (points.size() == 0) return 0;
+
+    // Locate all points at once, using the cell hint for the first point
+    typename DoFHandlerType::active_cell_iterator hint = cell_hint.get();
+    if (hint == dh->end())
+      hint = dh->begin_active();
+
+    std::tuple<std::vector<typename Triangulation<dim>::active_cell_iterator>,
+        std::vector<std::vector<Point<dim> > >,
+        std::vector<std::vector<unsigned int> > >
+        locations = GridTools::compute_point_locations
+                    (cache, points, typename Triangulation<dim>::active_cell_iterator(hint));
+
+    // Convert the cells of the triangulation into cells of the DoF handler,
+    // and check that they are available
+    const std::vector<typename Triangulation<dim>::active_cell_iterator>
+    &tria_cells = std::get<0>(locations);
+    cells.reserve (tria_cells.size());
+    for (unsigned int c=0; c<tria_cells.size(); ++c)
+      {
+        AssertThrow (!tria_cells[c]->is_artificial(),
+                     VectorTools::ExcPointNotAvailableHere());
+        cells.push_back (typename DoFHandlerType::active_cell_iterator
+                         (&dh->get_triangulation(),
+                          tria_cells[c]->level(), tria_cells[c]->index(),
+                          &*dh));
+      }
+    qpoints.swap (std::get<1>(locations));
+    maps.swap (std::get<2>(locations));
+
+    cell_hint.get() = cells.back();
+
+    return cells.size();
+  }
 
-    // Keep track of the points we
-    // found
-    std::vector<bool> point_flags(np, false);
 
-    // Set this to true until all
-    // points have been classified
-    bool left_over = true;
 
-    // Current quadrature point
+  template <int dim, typename DoFHandlerType, typename VectorType>
+  std::pair<typename DoFHandlerType::active_cell_iterator, Point<dim> >
+  FEFieldFunction<dim, DoFHandlerType, VectorType>::
+  find_cell_around_point (const Point<dim> &p) const
+  {
     typename DoFHandlerType::active_cell_iterator cell = cell_hint.get();
     if (cell == dh->end())
       cell = dh->begin_active();
 
-    {
-      // see if the point is
-      // inside the
-      // cell. there are two
-      // ways that
-      // transform_real_to_unit_cell
-      // can indicate that a
-      // point is outside: by
-      // returning
-      // coordinates that lie
-      // outside the
-      // reference cell, or
-      // by throwing an
-      // exception. handle
-      // both
-      boost::optional<Point<dim> >
-      qp = get_reference_coordinates (cell, points[0]);
-      if (!qp)
-        {
-          const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> >
-          my_pair  = GridTools::find_active_cell_around_point
-                     (mapping, *dh, points[0]);
-          AssertThrow (!my_pair.first->is_artificial(),
-                       VectorTools::ExcPointNotAvailableHere());
-
-          cell = my_pair.first;
-          qp = my_pair.second;
-          point_flags[0] = true;
-        }
-
-      // check that the cell is available:
-      AssertThrow (!cell->is_artificial(),
-                   VectorTools::ExcPointNotAvailableHere());
-
-      // Put in the first point.
-      cells.push_back(cell);
-      qpoints.emplace_back(1, qp.get());
-      maps.emplace_back(1, 0);
-    }
-
-
-    // Check if we need to do anything else
-    if (points.size() > 1)
-      left_over = true;
-    else
-      left_over = false;
-
-
-    // This is the first index of a non processed point
-    unsigned int first_outside = 1;
-
-    // And this is the index of the current cell
-    unsigned int c = 0;
-
-    while (left_over == true)
+    // see if the point is inside the hint. otherwise, search through the
+    // cache
+    boost::optional<Point<dim> >
+    qp = get_reference_coordinates (cell, p);
+    if (!qp)
       {
-        // Assume this is the last one
-        left_over = false;
-        Assert(first_outside < np,
-               ExcIndexRange(first_outside, 0, np));
-
-        // If we found one in this cell, keep looking in the same cell
-        for (unsigned int p=first_outside; p<np; ++p)
-          if (point_flags[p] == false)
-            {
-              // same logic as above
-              const boost::optional<Point<dim> >
-              qp = get_reference_coordinates (cells[c], points[p]);
-              if (qp)
-                {
-                  point_flags[p] = true;
-                  qpoints[c].push_back(qp.get());
-                  maps[c].push_back(p);
-                }
-              else
-                {
-                  // Set things up for next round
-                  if (left_over == false)
-                    first_outside = p;
-                  left_over = true;
-                }
-            }
-        // If we got here and there is
-        // no left over, we are
-        // done. Else we need to find
-        // the next cell
-        if (left_over == true)
-          {
-            const std::pair<typename dealii::internal::ActiveCellIterator<dim, dim, DoFHandlerType>::type, Point<dim> > my_pair
-              = GridTools::find_active_cell_around_point (mapping, *dh, points[first_outside]);
-            AssertThrow (!my_pair.first->is_artificial(),
-                         VectorTools::ExcPointNotAvailableHere());
-
-            cells.push_back(my_pair.first);
-            qpoints.emplace_back(1, my_pair.second);
-            maps.emplace_back(1, first_outside);
-            c++;
-            point_flags[first_outside] = true;
-            // And check if we can exit the loop now
-            if (first_outside == np-1)
-              left_over = false;
-          }
+        const std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+        my_pair = GridTools::find_active_cell_around_point (cache, p);
+        cell = typename DoFHandlerType::active_cell_iterator
+               (&dh->get_triangulation(),
+                my_pair.first->level(), my_pair.first->index(),
+                &*dh);
+        qp = my_pair.second;
       }
 
-    // Augment of one the number of cells
-    ++c;
-    // Debug Checking
-    Assert(c == cells.size(), ExcInternalError());
-
-    Assert(c == maps.size(),
-           ExcDimensionMismatch(c, maps.size()));
-
-    Assert(c == qpoints.size(),
-           ExcDimensionMismatch(c, qpoints.size()));
+    // check that the current cell is available:
+    AssertThrow (!cell->is_artificial(),
+                 VectorTools::ExcPointNotAvailableHere());
 
-#ifdef DEBUG
-    unsigned int qps = 0;
-    // The number of points in all
-    // the cells must be the same as
-    // the number of points we
-    // started off from.
-    for (unsigned int n=0; n<c; ++n)
-      {
-        Assert(qpoints[n].size() == maps[n].size(),
-               ExcDimensionMismatch(qpoints[n].size(), maps[n].size()));
-        qps += qpoints[n].size();
-      }
-    Assert(qps == np,
-           ExcDimensionMismatch(qps, np));
-#endif
+    cell_hint.get() = cell;
 
-    return c;
+    return std::make_pair (cell, qp.get());
   }
 
 
@@ -0,0 +1,467 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/checkpoint.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#ifdef DEAL_II_HAVE_UNISTD_H
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * The string at the start of every checkpoint file, including the
+   * terminating zero.
+   */
+  const char checkpoint_magic[16] = "deal.II chkpnt";
+
+  /**
+   * The version of the file format.
+   */
+  const unsigned long long int checkpoint_version = 1;
+
+  /**
+   * A number whose representation in memory allows to detect whether the
+   * file was written on a machine with the same byte order.
+   */
+  const unsigned long long int byte_order_marker = 0x0102030405060708ULL;
+
+  /**
+   * The layout of the header at the start of the file. It is followed by
+   * padding up to CheckpointWriter::page_size bytes.
+   */
+  struct CheckpointHeader
+  {
+    char                   magic[16];
+    unsigned long long int version;
+    unsigned long long int byte_order;
+    unsigned long long int n_writers;
+    unsigned long long int n_blocks;
+    unsigned long long int directory_offset;
+    unsigned long long int directory_size;
+  };
+
+
+
+  /**
+   * Round the given number up to the next multiple of @p alignment.
+   */
+  inline
+  unsigned long long int
+  round_up (const unsigned long long int n,
+            const unsigned long long int alignment)
+  {
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+
+
+  /**
+   * Append the bytes of the given object to @p out.
+   */
+  template <typename T>
+  void append_bytes (const T           &object,
+                     std::vector<char> &out)
+  {
+    const char *bytes = reinterpret_cast<const char *>(&object);
+    out.insert (out.end(), bytes, bytes+sizeof(T));
+  }
+
+
+
+  /**
+   * Read an object of type @p T from position @p position of @p data and
+   * advance the position.
+   */
+  template <typename T>
+  T read_bytes (const char  *data,
+                std::size_t &position)
+  {
+    T object;
+    std::memcpy (&object, data+position, sizeof(T));
+    position += sizeof(T);
+    return object;
+  }
+}
+
+
+
+CheckpointWriter::CheckpointWriter (const std::string &filename,
+                                    const MPI_Comm    &comm)
+  :
+  comm (comm),
+  filename (filename),
+  is_open (true),
+  file_size (page_size)
+{
+#ifdef DEAL_II_WITH_MPI
+  int ierr = MPI_File_open (comm, const_cast<char *>(filename.c_str()),
+                            MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                            &file_handle);
+  AssertThrowMPI(ierr);
+
+  ierr = MPI_File_set_size (file_handle, 0); // delete the file contents
+  AssertThrowMPI(ierr);
+  // this barrier is necessary, because otherwise others might already
+  // write while one core is still setting the size to zero.
+  ierr = MPI_Barrier (comm);
+  AssertThrowMPI(ierr);
+#else
+  file.open (filename.c_str(), std::ios::binary | std::ios::trunc);
+  AssertThrow (file, ExcIO());
+#endif
+}
+
+
+
+CheckpointWriter::~CheckpointWriter ()
+{
+  AssertNothrow (is_open == false,
+                 ExcMessage ("You need to call CheckpointWriter::close() "
+                             "before the object is destroyed."));
+}
+
+
+
+void
+CheckpointWriter::write_at (const unsigned long long int offset,
+                            const void                  *data,
+                            const std::size_t            n_bytes,
+                            const bool                   collective)
+{
+#ifdef DEAL_II_WITH_MPI
+  // MPI counts the bytes in an int, so write parts larger than 2 GB in
+  // several chunks. in the collective case, all processors need to take part
+  // in the same number of calls, possibly with nothing left to write
+  const std::size_t max_chunk_size = std::size_t(1) << 30;
+  unsigned long long int n_chunks = (n_bytes + max_chunk_size - 1) / max_chunk_size;
+  if (collective)
+    n_chunks = Utilities::MPI::max (n_chunks, comm);
+
+  const char *bytes = static_cast<const char *>(data);
+  std::size_t n_written = 0;
+  for (unsigned long long int c=0; c<n_chunks; ++c)
+    {
+      const int chunk_size = static_cast<int>(std::min (n_bytes - n_written, max_chunk_size));
+      const int ierr = (collective ?
+                        MPI_File_write_at_all (file_handle, offset + n_written,
+                                               const_cast<char *>(bytes + n_written),
+                                               chunk_size, MPI_BYTE, MPI_STATUS_IGNORE) :
+                        MPI_File_write_at (file_handle, offset + n_written,
+                                           const_cast<char *>(bytes + n_written),
+                                           chunk_size, MPI_BYTE, MPI_STATUS_IGNORE));
+      AssertThrowMPI(ierr);
+      n_written += chunk_size;
+    }
+#else
+  (void)collective;
+  file.seekp (offset);
+  file.write (static_cast<const char *>(data), n_bytes);
+  AssertThrow (file, ExcIO());
+#endif
+}
+
+
+
+void
+CheckpointWriter::write_block (const std::string &name,
+                               const void        *data,
+                               const std::size_t  n_bytes)
+{
+  Assert (is_open, ExcMessage ("The checkpoint file has already been closed."));
+  AssertThrow (std::find (block_names.begin(), block_names.end(), name) ==
+               block_names.end(),
+               ExcDuplicateBlockName (name));
+
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (comm);
+  const unsigned int n_ranks = Utilities::MPI::n_mpi_processes (comm);
+
+  // the parts of the processors follow each other, each one padded to a
+  // multiple of the alignment
+  const unsigned long long int block_start = round_up (file_size, page_size);
+  const unsigned long long int my_size = n_bytes;
+  const unsigned long long int my_padded_size = round_up (my_size, alignment);
+  unsigned long long int my_offset = 0;
+  std::vector<unsigned long long int> sizes (my_rank == 0 ? n_ranks : 0);
+#ifdef DEAL_II_WITH_MPI
+  int ierr = MPI_Exscan (&my_padded_size, &my_offset, 1, MPI_UNSIGNED_LONG_LONG,
+                         MPI_SUM, comm);
+  AssertThrowMPI(ierr);
+  if (my_rank == 0)
+    my_offset = 0;
+
+  ierr = MPI_Gather (&my_size, 1, MPI_UNSIGNED_LONG_LONG,
+                     sizes.data(), 1, MPI_UNSIGNED_LONG_LONG, 0, comm);
+  AssertThrowMPI(ierr);
+#else
+  sizes[0] = my_size;
+#endif
+  const unsigned long long int block_size = Utilities::MPI::sum (my_padded_size, comm);
+
+  write_at (block_start + my_offset, data, n_bytes, true);
+
+  block_names.push_back (name);
+  if (my_rank == 0)
+    {
+      block_layout.emplace_back (1, block_start);
+      block_layout.back().insert (block_layout.back().end(),
+                                  sizes.begin(), sizes.end());
+    }
+  file_size = block_start + block_size;
+}
+
+
+
+void
+CheckpointWriter::close ()
+{
+  Assert (is_open, ExcMessage ("The checkpoint file has already been closed."));
+
+  if (Utilities::MPI::this_mpi_process (comm) == 0)
+    {
+      const unsigned int n_ranks = Utilities::MPI::n_mpi_processes (comm);
+
+      // the directory contains, for each block, the length of its name, the
+      // name, and the offset and size of the part of each processor
+      std::vector<char> directory;
+      for (unsigned int b=0; b<block_names.size(); ++b)
+        {
+          append_bytes (static_cast<unsigned long long int>(block_names[b].size()),
+                        directory);
+          directory.insert (directory.end(), block_names[b].begin(),
+                            block_names[b].end());
+          unsigned long long int offset = block_layout[b][0];
+          for (unsigned int p=0; p<n_ranks; ++p)
+            {
+              const unsigned long long int size = block_layout[b][1+p];
+              append_bytes (offset, directory);
+              append_bytes (size, directory);
+              offset += round_up (size, alignment);
+            }
+        }
+
+      CheckpointHeader header;
+      std::memset (&header, 0, sizeof(header));
+      std::memcpy (header.magic, checkpoint_magic, sizeof(checkpoint_magic));
+      header.version = checkpoint_version;
+      header.byte_order = byte_order_marker;
+      header.n_writers = n_ranks;
+      header.n_blocks = block_names.size();
+      header.directory_offset = round_up (file_size, alignment);
+      header.directory_size = directory.size();
+
+      write_at (header.directory_offset, directory.data(), directory.size(), false);
+      write_at (0, &header, sizeof(header), false);
+    }
+
+#ifdef DEAL_II_WITH_MPI
+  const int ierr = MPI_File_close (&file_handle);
+  AssertThrowMPI(ierr);
+#else
+  file.close ();
+  AssertThrow (file, ExcIO());
+#endif
+
+  is_open = false;
+}
+
+
+
+CheckpointReader::CheckpointReader (const std::string &filename,
+                                    const MPI_Comm    &comm)
+  :
+  filename (filename),
+  my_rank (Utilities::MPI::this_mpi_process (comm)),
+  n_ranks (Utilities::MPI::n_mpi_processes (comm)),
+  file_data (nullptr),
+  file_size (0),
+  is_mapped (false),
+  n_writers (0)
+{
+#ifdef DEAL_II_HAVE_UNISTD_H
+  const int fd = open (filename.c_str(), O_RDONLY);
+  AssertThrow (fd >= 0, ExcFileNotOpen (filename.c_str()));
+  struct stat file_status;
+  const int ierr = fstat (fd, &file_status);
+  if (ierr != 0 || file_status.st_size < static_cast<off_t>(sizeof(CheckpointHeader)))
+    {
+      ::close (fd);
+      AssertThrow (false, ExcInvalidCheckpointFile (filename));
+    }
+  file_size = file_status.st_size;
+
+  void *mapped = mmap (nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping stays valid after closing the file descriptor
+  ::close (fd);
+  AssertThrow (mapped != MAP_FAILED, ExcIO());
+  file_data = static_cast<const char *>(mapped);
+  is_mapped = true;
+#else
+  {
+    std::ifstream file (filename.c_str(), std::ios::binary);
+    AssertThrow (file, ExcFileNotOpen (filename.c_str()));
+    file_buffer.assign (std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>());
+  }
+  file_data = file_buffer.data();
+  file_size = file_buffer.size();
+  AssertThrow (file_size >= sizeof(CheckpointHeader),
+               ExcInvalidCheckpointFile (filename));
+#endif
+
+  // do not leak the mapping if the file turns out to be invalid, since the
+  // destructor is not called if the constructor throws
+  try
+    {
+      read_directory ();
+    }
+  catch (...)
+    {
+#ifdef DEAL_II_HAVE_UNISTD_H
+      munmap (const_cast<char *>(file_data), file_size);
+#endif
+      throw;
+    }
+}
+
+
+
+void
+CheckpointReader::read_directory ()
+{
+  CheckpointHeader header;
+  std::memcpy (&header, file_data, sizeof(header));
+  // write the checks on offsets and sizes such that they cannot overflow
+  // for corrupted files
+  AssertThrow (std::memcmp (header.magic, checkpoint_magic, sizeof(checkpoint_magic)) == 0 &&
+               header.byte_order == byte_order_marker &&
+               header.directory_offset <= file_size &&
+               header.directory_size <= file_size - header.directory_offset,
+               ExcInvalidCheckpointFile (filename));
+  AssertThrow (header.version == checkpoint_version,
+               ExcMessage ("The checkpoint file <" + filename + "> was written "
+                           "with an unsupported version of the file format."));
+
+  const char *directory = file_data + header.directory_offset;
+  const unsigned long long int directory_size = header.directory_size;
+  std::size_t position = 0;
+  const auto check_available = [&] (const unsigned long long int n_bytes)
+  {
+    AssertThrow (n_bytes <= directory_size - position,
+                 ExcInvalidCheckpointFile (filename));
+  };
+
+  // each processor contributes the offset and the size of its part to the
+  // directory entry of every block
+  const unsigned long long int bytes_per_writer = 2 * sizeof(unsigned long long int);
+  AssertThrow (header.n_writers <= directory_size / bytes_per_writer &&
+               header.n_writers <= std::numeric_limits<unsigned int>::max(),
+               ExcInvalidCheckpointFile (filename));
+  n_writers = header.n_writers;
+
+  for (unsigned long long int b=0; b<header.n_blocks; ++b)
+    {
+      check_available (sizeof(unsigned long long int));
+      const unsigned long long int name_length
+        = read_bytes<unsigned long long int> (directory, position);
+      check_available (name_length);
+      const std::string name (directory+position, name_length);
+      position += name_length;
+
+      check_available (n_writers * bytes_per_writer);
+      std::vector<std::pair<unsigned long long int, unsigned long long int> > &parts
+        = blocks[name];
+      parts.resize (n_writers);
+      for (unsigned int p=0; p<n_writers; ++p)
+        {
+          parts[p].first = read_bytes<unsigned long long int> (directory, position);
+          parts[p].second = read_bytes<unsigned long long int> (directory, position);
+          AssertThrow (parts[p].first <= file_size &&
+                       parts[p].second <= file_size - parts[p].first,
+                       ExcInvalidCheckpointFile (filename));
+        }
+    }
+}
+
+
+
+CheckpointReader::~CheckpointReader ()
+{
+#ifdef DEAL_II_HAVE_UNISTD_H
+  if (is_mapped)
+    munmap (const_cast<char *>(file_data), file_size);
+#endif
+}
+
+
+
+unsigned int
+CheckpointReader::n_writer_processes () const
+{
+  return n_writers;
+}
+
+
+
+unsigned int
+CheckpointReader::this_process () const
+{
+  return my_rank;
+}
+
+
+
+unsigned int
+CheckpointReader::n_processes () const
+{
+  return n_ranks;
+}
+
+
+
+bool
+CheckpointReader::has_block (const std::string &name) const
+{
+  return blocks.find (name) != blocks.end();
+}
+
+
+
+ArrayView<const char>
+CheckpointReader::get_block (const std::string  &name,
+                             const unsigned int  writer_process) const
+{
+  const auto block = blocks.find (name);
+  AssertThrow (block != blocks.end(), ExcBlockNotFound (name));
+  AssertIndexRange (writer_process, n_writers);
+
+  return ArrayView<const char> (file_data + block->second[writer_process].first,
+                                block->second[writer_process].second);
+}
+
+
+DEAL_II_NAMESPACE_CLOSE
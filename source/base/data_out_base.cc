@@ -37,6 +37,7 @@
 #include <deal.II/base/thread_management.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/mpi.h>
+#include <deal.II/base/parallel.h>
 
 #include <cstring>
 #include <algorithm>
@@ -6477,6 +6478,567 @@ void DataOutInterface<dim,spacedim>::write_vtu_in_parallel (const char *filename
 }
 
 
+
+namespace
+{
+  /**
+   * A class with the interface expected by DataOutBase::write_nodes() and
+   * DataOutBase::write_cells() that collects the coordinates of the vertices
+   * and the connectivity of the cells in the arrays written to the appended
+   * data section by DataOutInterface::write_vtu_in_parallel_batched().
+   */
+  class VtuAppendedStream
+  {
+  public:
+    template <int dim>
+    void write_point (const unsigned int,
+                      const Point<dim> &p)
+    {
+      for (unsigned int i=0; i<dim; ++i)
+        vertices.push_back (p[i]);
+      for (unsigned int i=dim; i<3; ++i)
+        vertices.push_back (0);
+    }
+
+    void flush_points ()
+    {}
+
+    template <int dim>
+    void write_cell (const unsigned int,
+                     const unsigned int start,
+                     const unsigned int d1,
+                     const unsigned int d2,
+                     const unsigned int d3)
+    {
+      cells.push_back (start);
+      if (dim >= 1)
+        {
+          cells.push_back (start+d1);
+          if (dim >= 2)
+            {
+              cells.push_back (start+d2+d1);
+              cells.push_back (start+d2);
+              if (dim >= 3)
+                {
+                  cells.push_back (start+d3);
+                  cells.push_back (start+d3+d1);
+                  cells.push_back (start+d3+d2+d1);
+                  cells.push_back (start+d3+d2);
+                }
+            }
+        }
+    }
+
+    void flush_cells ()
+    {}
+
+    std::vector<double>  vertices;
+    std::vector<int32_t> cells;
+  };
+
+
+
+  /**
+   * The data of one piece of a VTU file written with appended data, i.e.,
+   * the number of points and cells of the piece along with the binary data
+   * of all of its data arrays and the position of each array within this
+   * binary data.
+   */
+  struct VtuAppendedPiece
+  {
+    unsigned long long int n_nodes;
+    unsigned long long int n_cells;
+
+    std::vector<unsigned long long int> array_offsets;
+    std::vector<char>                   data;
+  };
+
+
+
+  /**
+   * Append the given array to @p out in the format of VTK's raw appended
+   * data with 64 bit headers. Without compression, the array is preceded by
+   * its size in bytes. With compression, the array is split into blocks of
+   * 64 kB that are compressed with zlib in parallel, and the blocks are
+   * preceded by the header of vtkZLibDataCompressor consisting of the number
+   * of blocks, the block size, the size of the last partial block, and the
+   * compressed size of each block.
+   */
+  template <typename T>
+  void append_vtu_array (const std::vector<T>        &data,
+                         const DataOutBase::VtkFlags &flags,
+                         const bool                   compress,
+                         std::vector<char>           &out)
+  {
+    const unsigned long long int n_bytes = data.size() * sizeof(T);
+    const char *bytes = (data.size() > 0 ?
+                         reinterpret_cast<const char *>(&data[0]) :
+                         nullptr);
+
+    if (compress == false)
+      {
+        const char *header = reinterpret_cast<const char *>(&n_bytes);
+        out.insert (out.end(), header, header+sizeof(n_bytes));
+        out.insert (out.end(), bytes, bytes+n_bytes);
+        return;
+      }
+
+#ifdef DEAL_II_WITH_ZLIB
+    const unsigned long long int block_size = 1 << 16;
+    const std::size_t n_blocks = (n_bytes + block_size - 1) / block_size;
+
+    std::vector<std::vector<char> > compressed_blocks (n_blocks);
+    parallel::apply_to_subranges
+    (std::size_t(0), n_blocks,
+     [&](const std::size_t begin, const std::size_t end)
+    {
+      for (std::size_t b=begin; b<end; ++b)
+        {
+          const uLong size = std::min (block_size, n_bytes - b*block_size);
+          uLongf compressed_size = compressBound (size);
+          compressed_blocks[b].resize (compressed_size);
+          const int err = compress2 ((Bytef *) &compressed_blocks[b][0],
+                                     &compressed_size,
+                                     (const Bytef *) bytes + b*block_size,
+                                     size,
+                                     get_zlib_compression_level(flags.compression_level));
+          (void)err;
+          Assert (err == Z_OK, ExcInternalError());
+          compressed_blocks[b].resize (compressed_size);
+        }
+    },
+    4);
+
+    std::vector<unsigned long long int> header (3 + n_blocks);
+    header[0] = n_blocks;
+    header[1] = block_size;
+    header[2] = n_bytes % block_size;
+    for (std::size_t b=0; b<n_blocks; ++b)
+      header[3+b] = compressed_blocks[b].size();
+
+    const char *header_bytes = reinterpret_cast<const char *>(&header[0]);
+    out.insert (out.end(), header_bytes,
+                header_bytes + header.size()*sizeof(header[0]));
+    for (std::size_t b=0; b<n_blocks; ++b)
+      out.insert (out.end(), compressed_blocks[b].begin(),
+                  compressed_blocks[b].end());
+#else
+    (void)flags;
+    Assert (false, ExcInternalError());
+#endif
+  }
+
+
+
+  /**
+   * Convert the given patches into a piece of a VTU file with appended data.
+   * The data arrays are, in this order, the points, the connectivity, the
+   * offsets and the types of the cells, followed by the vector-valued and
+   * then the scalar data sets in the same order as write_vtu() uses.
+   */
+  template <int dim, int spacedim>
+  void
+  build_vtu_appended_piece (const std::vector<DataOutBase::Patch<dim,spacedim> > &patches,
+                            const std::vector<std::string>                       &data_names,
+                            const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                            const DataOutBase::VtkFlags                          &flags,
+                            const bool                                            compress,
+                            VtuAppendedPiece                                     &piece)
+  {
+    const unsigned int n_data_sets = data_names.size();
+    if (patches.size() > 0)
+      {
+        if (patches[0].points_are_available)
+          {
+            AssertDimension(n_data_sets + spacedim, patches[0].data.n_rows())
+          }
+        else
+          {
+            AssertDimension(n_data_sets, patches[0].data.n_rows())
+          }
+      }
+
+    unsigned int n_nodes;
+    unsigned int n_cells;
+    compute_sizes<dim,spacedim>(patches, n_nodes, n_cells);
+    piece.n_nodes = n_nodes;
+    piece.n_cells = n_cells;
+    piece.array_offsets.clear ();
+    piece.data.clear ();
+
+    // reorder the data vectors on a separate task while we compute the
+    // vertices and cells, like write_vtu() does
+    Table<2,double> data_vectors (n_data_sets, n_nodes);
+    Threads::TaskGroup<> reorder_task;
+    if (patches.size() > 0)
+      {
+        void (*fun_ptr) (const std::vector<DataOutBase::Patch<dim,spacedim> > &,
+                         Table<2,double> &)
+          = &DataOutBase::write_gmv_reorder_data_vectors<dim,spacedim>;
+        reorder_task += Threads::new_task (fun_ptr, patches, data_vectors);
+      }
+
+    {
+      VtuAppendedStream vtu_out;
+      DataOutBase::write_nodes (patches, vtu_out);
+      DataOutBase::write_cells (patches, vtu_out);
+
+      piece.array_offsets.push_back (piece.data.size());
+      append_vtu_array (vtu_out.vertices, flags, compress, piece.data);
+      piece.array_offsets.push_back (piece.data.size());
+      append_vtu_array (vtu_out.cells, flags, compress, piece.data);
+    }
+
+    {
+      std::vector<int32_t> offsets (n_cells);
+      for (unsigned int i=0; i<n_cells; ++i)
+        offsets[i] = (i+1)*GeometryInfo<dim>::vertices_per_cell;
+      piece.array_offsets.push_back (piece.data.size());
+      append_vtu_array (offsets, flags, compress, piece.data);
+
+      const std::vector<uint8_t> cell_types (n_cells,
+                                             static_cast<uint8_t>(vtk_cell_type[dim]));
+      piece.array_offsets.push_back (piece.data.size());
+      append_vtu_array (cell_types, flags, compress, piece.data);
+    }
+
+    reorder_task.join_all ();
+
+    std::vector<bool> data_set_written (n_data_sets, false);
+    std::vector<double> data;
+    for (unsigned int n_th_vector=0; n_th_vector<vector_data_ranges.size(); ++n_th_vector)
+      {
+        const unsigned int first_component = std::get<0>(vector_data_ranges[n_th_vector]);
+        const unsigned int last_component  = std::get<1>(vector_data_ranges[n_th_vector]);
+        AssertThrow (last_component >= first_component,
+                     ExcLowerRange (last_component, first_component));
+        AssertThrow (last_component < n_data_sets,
+                     ExcIndexRange (last_component, 0, n_data_sets));
+        AssertThrow (last_component + 1 - first_component <= 3,
+                     ExcMessage ("Can't declare a vector with more than 3 components "
+                                 "in VTK"));
+
+        for (unsigned int i=first_component; i<=last_component; ++i)
+          data_set_written[i] = true;
+
+        // pad all vectors to have three components
+        data.assign (3*n_nodes, 0.);
+        for (unsigned int n=0; n<n_nodes; ++n)
+          for (unsigned int i=first_component; i<=last_component; ++i)
+            data[3*n+i-first_component] = data_vectors(i, n);
+
+        piece.array_offsets.push_back (piece.data.size());
+        append_vtu_array (data, flags, compress, piece.data);
+      }
+
+    for (unsigned int data_set=0; data_set<n_data_sets; ++data_set)
+      if (data_set_written[data_set] == false)
+        {
+          data.assign (data_vectors[data_set].begin(),
+                       data_vectors[data_set].end());
+          piece.array_offsets.push_back (piece.data.size());
+          append_vtu_array (data, flags, compress, piece.data);
+        }
+  }
+
+
+
+  /**
+   * Write the XML description of a piece with appended data, where
+   * @p array_offsets contains the offsets of the data arrays relative to the
+   * start of the appended data section. All numbers are written with a fixed
+   * width, such that the length of the description only depends on the names
+   * of the data sets. This allows to reserve space for the descriptions of
+   * all pieces at the beginning of the file before their data is known.
+   */
+  void
+  write_vtu_appended_piece_xml (const VtuAppendedPiece                                          &piece,
+                                const std::vector<unsigned long long int>                       &array_offsets,
+                                const std::vector<std::string>                                  &data_names,
+                                const std::vector<std::tuple<unsigned int, unsigned int, std::string> > &vector_data_ranges,
+                                std::ostream                                                    &out)
+  {
+    const unsigned int width = std::numeric_limits<unsigned long long int>::digits10 + 1;
+    unsigned int array = 0;
+
+    out << "<Piece NumberOfPoints=\"" << std::setw(width) << piece.n_nodes
+        << "\" NumberOfCells=\"" << std::setw(width) << piece.n_cells << "\" >\n";
+    out << "  <Points>\n";
+    out << "    <DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"appended\" offset=\""
+        << std::setw(width) << array_offsets[array++] << "\"/>\n";
+    out << "  </Points>\n";
+    out << "  <Cells>\n";
+    out << "    <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\""
+        << std::setw(width) << array_offsets[array++] << "\"/>\n";
+    out << "    <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\""
+        << std::setw(width) << array_offsets[array++] << "\"/>\n";
+    out << "    <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""
+        << std::setw(width) << array_offsets[array++] << "\"/>\n";
+    out << "  </Cells>\n";
+    out << "  <PointData Scalars=\"scalars\">\n";
+
+    std::vector<bool> data_set_written (data_names.size(), false);
+    for (unsigned int n_th_vector=0; n_th_vector<vector_data_ranges.size(); ++n_th_vector)
+      {
+        for (unsigned int i=std::get<0>(vector_data_ranges[n_th_vector]);
+             i<=std::get<1>(vector_data_ranges[n_th_vector]);
+             ++i)
+          data_set_written[i] = true;
+
+        out << "    <DataArray type=\"Float64\" Name=\"";
+        if (std::get<2>(vector_data_ranges[n_th_vector]) != "")
+          out << std::get<2>(vector_data_ranges[n_th_vector]);
+        else
+          {
+            for (unsigned int i=std::get<0>(vector_data_ranges[n_th_vector]);
+                 i<std::get<1>(vector_data_ranges[n_th_vector]);
+                 ++i)
+              out << data_names[i] << "__";
+            out << data_names[std::get<1>(vector_data_ranges[n_th_vector])];
+          }
+        out << "\" NumberOfComponents=\"3\" format=\"appended\" offset=\""
+            << std::setw(width) << array_offsets[array++] << "\"/>\n";
+      }
+
+    for (unsigned int data_set=0; data_set<data_names.size(); ++data_set)
+      if (data_set_written[data_set] == false)
+        out << "    <DataArray type=\"Float64\" Name=\""
+            << data_names[data_set]
+            << "\" format=\"appended\" offset=\""
+            << std::setw(width) << array_offsets[array++] << "\"/>\n";
+
+    out << "  </PointData>\n";
+    out << "</Piece>\n";
+
+    AssertDimension (array, array_offsets.size());
+  }
+}
+
+
+
+template <int dim, int spacedim>
+void
+DataOutInterface<dim,spacedim>::
+write_vtu_in_parallel_batched (const char                                     *filename,
+                               MPI_Comm                                        comm,
+                               const unsigned int                              n_batches,
+                               const std::function<void (const unsigned int)> &build_batch) const
+{
+  const std::vector<std::string> data_names = get_dataset_names();
+  const std::vector<std::tuple<unsigned int, unsigned int, std::string> >
+  vector_data_ranges = get_vector_data_ranges();
+
+#ifdef DEAL_II_WITH_ZLIB
+  const bool compress = (vtk_flags.compression_level !=
+                         DataOutBase::VtkFlags::no_compression);
+#else
+  const bool compress = false;
+#endif
+
+  const unsigned int my_rank = Utilities::MPI::this_mpi_process (comm);
+  const unsigned int n_ranks = Utilities::MPI::n_mpi_processes (comm);
+
+  // every processor needs to take part in the same number of collective
+  // write operations, so all of them go through as many rounds as the
+  // processor with the most batches. processor zero writes at least one,
+  // possibly empty, piece in order to produce a valid file in case there are
+  // no cells at all
+  const unsigned int n_rounds = std::max (Utilities::MPI::max (n_batches, comm), 1U);
+
+  // the layout of the file is: the header, then one slot for the XML
+  // description of a piece per round and processor, and finally the
+  // appended data of all pieces. slots of processors that have run out of
+  // batches are filled with white space
+  std::string header;
+  if (my_rank == 0)
+    {
+      std::ostringstream ss;
+      ss << "<?xml version=\"1.0\" ?> \n";
+      ss << "<!-- \n";
+      ss << "# vtk DataFile Version 3.0"
+         << '\n'
+         << "#This file was generated by the deal.II library";
+      if (vtk_flags.print_date_and_time)
+        ss << " on " << Utilities::System::get_time()
+           << " at " << Utilities::System::get_date();
+      else
+        ss << ".";
+      ss << "\n-->\n";
+      ss << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" header_type=\"UInt64\"";
+      if (compress)
+        ss << " compressor=\"vtkZLibDataCompressor\"";
+#ifdef DEAL_II_WORDS_BIGENDIAN
+      ss << " byte_order=\"BigEndian\"";
+#else
+      ss << " byte_order=\"LittleEndian\"";
+#endif
+      ss << ">\n";
+      ss << "<UnstructuredGrid>\n";
+
+      // if desired, output time and cycle of the simulation as global field
+      // data of the grid
+      const bool output_cycle = (vtk_flags.cycle != std::numeric_limits<unsigned int>::min());
+      const bool output_time = (vtk_flags.time != std::numeric_limits<double>::min());
+      if (output_cycle || output_time)
+        {
+          ss << "<FieldData>\n";
+          if (output_cycle)
+            ss << "<DataArray type=\"Float32\" Name=\"CYCLE\" NumberOfTuples=\"1\" format=\"ascii\">"
+               << vtk_flags.cycle
+               << "</DataArray>\n";
+          if (output_time)
+            ss << "<DataArray type=\"Float32\" Name=\"TIME\" NumberOfTuples=\"1\" format=\"ascii\">"
+               << vtk_flags.time
+               << "</DataArray>\n";
+          ss << "</FieldData>\n";
+        }
+      header = ss.str();
+    }
+  const unsigned long long int header_size
+    = Utilities::MPI::max (static_cast<unsigned long long int>(header.size()), comm);
+
+  std::size_t slot_size;
+  {
+    VtuAppendedPiece empty_piece;
+    build_vtu_appended_piece (std::vector<DataOutBase::Patch<dim,spacedim> >(),
+                              data_names, vector_data_ranges,
+                              vtk_flags, compress, empty_piece);
+    std::ostringstream ss;
+    write_vtu_appended_piece_xml (empty_piece, empty_piece.array_offsets,
+                                  data_names, vector_data_ranges, ss);
+    slot_size = ss.str().size();
+  }
+
+  const std::string appended_data_begin = "</UnstructuredGrid>\n<AppendedData encoding=\"raw\">\n_";
+  const std::string footer = "\n</AppendedData>\n</VTKFile>\n";
+  const unsigned long long int appended_data_start
+    = header_size + static_cast<unsigned long long int>(n_rounds) * n_ranks * slot_size
+      + appended_data_begin.size();
+
+#ifdef DEAL_II_WITH_MPI
+  MPI_Info info;
+  int ierr = MPI_Info_create(&info);
+  AssertThrowMPI(ierr);
+  MPI_File fh;
+  ierr = MPI_File_open(comm, const_cast<char *>(filename),
+                       MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &fh);
+  AssertThrowMPI(ierr);
+
+  ierr = MPI_File_set_size(fh, 0); // delete the file contents
+  AssertThrowMPI(ierr);
+  // this barrier is necessary, because otherwise others might already
+  // write while one core is still setting the size to zero.
+  ierr = MPI_Barrier(comm);
+  AssertThrowMPI(ierr);
+  ierr = MPI_Info_free(&info);
+  AssertThrowMPI(ierr);
+
+  const auto write_at = [&fh](const unsigned long long int offset,
+                              const char *data,
+                              const std::size_t size,
+                              const bool collective)
+  {
+    AssertThrow (size <= static_cast<std::size_t>(std::numeric_limits<int>::max()),
+                 ExcMessage ("A piece of the VTU file is too large for MPI I/O. "
+                             "Use a smaller number of cells per batch."));
+    const int ierr = (collective ?
+                      MPI_File_write_at_all (fh, offset, const_cast<char *>(data),
+                                             size, MPI_CHAR, MPI_STATUS_IGNORE) :
+                      MPI_File_write_at (fh, offset, const_cast<char *>(data),
+                                         size, MPI_CHAR, MPI_STATUS_IGNORE));
+    AssertThrowMPI(ierr);
+  };
+#else
+  std::ofstream file (filename, std::ios::binary);
+  AssertThrow (file, ExcIO());
+
+  const auto write_at = [&file](const unsigned long long int offset,
+                                const char *data,
+                                const std::size_t size,
+                                const bool)
+  {
+    file.seekp (offset);
+    file.write (data, size);
+    AssertThrow (file, ExcIO());
+  };
+#endif
+
+  if (my_rank == 0)
+    {
+      write_at (0, header.c_str(), header.size(), false);
+      write_at (appended_data_start - appended_data_begin.size(),
+                appended_data_begin.c_str(), appended_data_begin.size(), false);
+    }
+
+  // the number of bytes in the appended data section written by all
+  // processors in the previous rounds
+  unsigned long long int appended_data_size = 0;
+  VtuAppendedPiece piece;
+  std::vector<unsigned long long int> array_offsets;
+  for (unsigned int round=0; round<n_rounds; ++round)
+    {
+      const bool have_piece = (round < n_batches || (round == 0 && my_rank == 0));
+      if (round < n_batches)
+        {
+          build_batch (round);
+          build_vtu_appended_piece (get_patches(), data_names, vector_data_ranges,
+                                    vtk_flags, compress, piece);
+        }
+      else if (have_piece)
+        build_vtu_appended_piece (std::vector<DataOutBase::Patch<dim,spacedim> >(),
+                                  data_names, vector_data_ranges,
+                                  vtk_flags, compress, piece);
+      else
+        piece.data.clear ();
+
+      // the data of this round is stored in the order of the processors, so
+      // find out where this processor's data starts and how much data all
+      // processors write in this round
+      unsigned long long int my_size = piece.data.size();
+      unsigned long long int my_start = 0;
+#ifdef DEAL_II_WITH_MPI
+      ierr = MPI_Exscan (&my_size, &my_start, 1, MPI_UNSIGNED_LONG_LONG,
+                         MPI_SUM, comm);
+      AssertThrowMPI(ierr);
+      if (my_rank == 0)
+        my_start = 0;
+#endif
+      const unsigned long long int round_size = Utilities::MPI::sum (my_size, comm);
+
+      std::string piece_xml;
+      if (have_piece)
+        {
+          array_offsets = piece.array_offsets;
+          for (unsigned int i=0; i<array_offsets.size(); ++i)
+            array_offsets[i] += appended_data_size + my_start;
+          std::ostringstream ss;
+          write_vtu_appended_piece_xml (piece, array_offsets,
+                                        data_names, vector_data_ranges, ss);
+          piece_xml = ss.str();
+          AssertDimension (piece_xml.size(), slot_size);
+        }
+      else
+        piece_xml.assign (slot_size, ' ');
+
+      write_at (header_size + (static_cast<unsigned long long int>(round) * n_ranks + my_rank) * slot_size,
+                piece_xml.c_str(), piece_xml.size(), true);
+      write_at (appended_data_start + appended_data_size + my_start,
+                piece.data.data(), piece.data.size(), true);
+
+      appended_data_size += round_size;
+    }
+
+  if (my_rank == 0)
+    write_at (appended_data_start + appended_data_size,
+              footer.c_str(), footer.size(), false);
+
+#ifdef DEAL_II_WITH_MPI
+  ierr = MPI_File_close( &fh );
+  AssertThrowMPI(ierr);
+#endif
+}
+
+
 template <int dim, int spacedim>
 void
 DataOutInterface<dim,spacedim>::write_pvtu_record (std::ostream &out,
@@ -448,6 +448,25 @@ namespace internal
     size_t (&functions<2>::connectivity_memory_used) (types<2>::connectivity *p4est)
       = p4est_connectivity_memory_used;
 
+#if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+    void (&functions<2>::comm_count_pertree) (types<2>::forest *p4est,
+                                              p4est_gloidx_t *pertree)
+      = p4est_comm_count_pertree;
+
+    sc_array_t *(&functions<2>::deflate_quadrants) (types<2>::forest *p4est,
+                                                    sc_array_t **data)
+      = p4est_deflate_quadrants;
+
+    types<2>::forest *(&functions<2>::inflate) (MPI_Comm mpicomm,
+                                                types<2>::connectivity *connectivity,
+                                                const p4est_gloidx_t *global_first_quadrant,
+                                                const p4est_gloidx_t *pertree,
+                                                sc_array_t *quadrants,
+                                                sc_array_t *data,
+                                                void *user_pointer)
+      = p4est_inflate;
+#endif
+
     template <int dim, int spacedim>
     std::map<unsigned int, std::set<dealii::types::subdomain_id> >
     compute_vertices_with_ghost_neighbors(const typename dealii::parallel::distributed::Triangulation<dim,spacedim> &tria,
@@ -676,6 +695,25 @@ namespace internal
     size_t (&functions<3>::connectivity_memory_used) (types<3>::connectivity *p4est)
       = p8est_connectivity_memory_used;
 
+#if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+    void (&functions<3>::comm_count_pertree) (types<3>::forest *p4est,
+                                              p4est_gloidx_t *pertree)
+      = p8est_comm_count_pertree;
+
+    sc_array_t *(&functions<3>::deflate_quadrants) (types<3>::forest *p4est,
+                                                    sc_array_t **data)
+      = p8est_deflate_quadrants;
+
+    types<3>::forest *(&functions<3>::inflate) (MPI_Comm mpicomm,
+                                                types<3>::connectivity *connectivity,
+                                                const p4est_gloidx_t *global_first_quadrant,
+                                                const p4est_gloidx_t *pertree,
+                                                sc_array_t *quadrants,
+                                                sc_array_t *data,
+                                                void *user_pointer)
+      = p8est_inflate;
+#endif
+
     const unsigned int functions<3>::max_level;
 
 
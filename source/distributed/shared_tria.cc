@@ -42,9 +42,10 @@ namespace parallel
       settings (settings),
       allow_artificial_cells(allow_artificial_cells)
     {
-      Assert((settings & (partition_metis | partition_zorder | partition_custom_signal)) == partition_metis ||
-             (settings & (partition_metis | partition_zorder | partition_custom_signal)) == partition_zorder ||
-             (settings & (partition_metis | partition_zorder | partition_custom_signal)) == partition_custom_signal,
+      Assert((settings & (partition_metis | partition_zorder | partition_custom_signal | partition_hilbert)) == partition_metis ||
+             (settings & (partition_metis | partition_zorder | partition_custom_signal | partition_hilbert)) == partition_zorder ||
+             (settings & (partition_metis | partition_zorder | partition_custom_signal | partition_hilbert)) == partition_custom_signal ||
+             (settings & (partition_metis | partition_zorder | partition_custom_signal | partition_hilbert)) == partition_hilbert,
              ExcMessage ("Settings must contain exactly one type of active cell partitioning scheme."))
 
       if (settings & construct_multigrid_hierarchy)
@@ -65,6 +66,10 @@ namespace parallel
         {
           dealii::GridTools::partition_triangulation_zorder (this->n_subdomains, *this);
         }
+      else if (settings & partition_hilbert)
+        {
+          dealii::GridTools::partition_triangulation_hilbert (this->n_subdomains, *this);
+        }
       else if (settings & partition_custom_signal)
         {
           // User partitions mesh manually
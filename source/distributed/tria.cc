@@ -15,6 +15,7 @@
 
 
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/checkpoint.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/lac/sparsity_tools.h>
@@ -1892,6 +1893,244 @@ namespace parallel
 
 
 
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    save (CheckpointWriter &writer) const
+    {
+#if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+      Assert(n_attached_deserialize==0,
+             ExcMessage ("not all SolutionTransfer's got deserialized after the last load()"));
+      Assert(this->n_cells()>0, ExcMessage("Can not save() an empty Triangulation."));
+
+      const unsigned long long int real_data_size
+        = (attached_data_size>0 ? attached_data_size+sizeof(CellStatus) : 0);
+
+      // the global information is only written by the first processor: the
+      // version of the format, the number of coarse cells, the size of the
+      // data attached to each cell and the number of attached objects, as
+      // well as the partitioning of the quadrants and their number per tree
+      const unsigned long long int info[4]
+        = { 3, this->n_cells(0), real_data_size, attached_data_pack_callbacks.size() };
+      const bool write_global_info = (this->my_subdomain == 0);
+      writer.write_block ("triangulation/info", info, write_global_info ? 4 : 0);
+
+      std::vector<p4est_gloidx_t> pertree (parallel_forest->connectivity->num_trees+1);
+      dealii::internal::p4est::functions<dim>::comm_count_pertree (parallel_forest,
+          pertree.data());
+      writer.write_block ("triangulation/global_first_quadrant",
+                          parallel_forest->global_first_quadrant,
+                          write_global_info ?
+                          Utilities::MPI::n_mpi_processes (this->mpi_communicator)+1 : 0);
+      writer.write_block ("triangulation/pertree", pertree.data(),
+                          write_global_info ? pertree.size() : 0);
+
+      if (attached_data_size>0)
+        {
+          const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this)
+          ->attach_mesh_data();
+        }
+
+      // the locally owned quadrants and the data attached to them, each as
+      // one contiguous array
+      sc_array_t *data = nullptr;
+      sc_array_t *quadrants
+        = dealii::internal::p4est::functions<dim>::deflate_quadrants (parallel_forest,
+            attached_data_size>0 ? &data : nullptr);
+      writer.write_block ("triangulation/quadrants", quadrants->array,
+                          quadrants->elem_count * quadrants->elem_size);
+      writer.write_block ("triangulation/data",
+                          data != nullptr ? data->array : nullptr,
+                          data != nullptr ? data->elem_count * data->elem_size : 0);
+      sc_array_destroy (quadrants);
+      if (data != nullptr)
+        sc_array_destroy (data);
+
+      dealii::parallel::distributed::Triangulation<dim, spacedim> *tria
+        = const_cast<dealii::parallel::distributed::Triangulation<dim, spacedim>*>(this);
+
+      tria->n_attached_datas = 0;
+      tria->attached_data_size = 0;
+      tria->attached_data_pack_callbacks.clear();
+
+      // and release the data
+      void *userptr = parallel_forest->user_pointer;
+      dealii::internal::p4est::functions<dim>::reset_data (parallel_forest, 0, nullptr, nullptr);
+      parallel_forest->user_pointer = userptr;
+#else
+      (void)writer;
+      AssertThrow (false,
+                   ExcMessage ("Saving a parallel::distributed::Triangulation to a "
+                               "checkpoint file requires p4est version 2.0 or newer."));
+#endif
+    }
+
+
+
+    template <int dim, int spacedim>
+    void
+    Triangulation<dim,spacedim>::
+    load (const CheckpointReader &reader)
+    {
+#if DEAL_II_P4EST_VERSION_GTE(2,0,0,0)
+      Assert(this->n_cells()>0, ExcMessage("load() only works if the Triangulation already contains a coarse mesh!"));
+      Assert(this->n_levels()==1, ExcMessage("Triangulation may only contain coarse cells when calling load()."));
+
+      const ArrayView<const unsigned long long int> info
+        = reader.get_block<unsigned long long int> ("triangulation/info", 0);
+      AssertThrow(info.size() == 4 && info[0] == 3,
+                  ExcMessage("Incompatible version of the triangulation found in the checkpoint file."));
+      AssertThrow(this->n_cells(0) == info[1], ExcMessage("Number of coarse cells differ!"));
+      const std::size_t data_size = info[2];
+
+      const unsigned int n_writers = reader.n_writer_processes();
+      const unsigned int n_procs = Utilities::MPI::n_mpi_processes (this->mpi_communicator);
+      const unsigned int my_rank = Utilities::MPI::this_mpi_process (this->mpi_communicator);
+      const ArrayView<const p4est_gloidx_t> saved_first_quadrant
+        = reader.get_block<p4est_gloidx_t> ("triangulation/global_first_quadrant", 0);
+      const ArrayView<const p4est_gloidx_t> pertree
+        = reader.get_block<p4est_gloidx_t> ("triangulation/pertree", 0);
+      AssertThrow(saved_first_quadrant.size() == n_writers+1 &&
+                  pertree.size() == static_cast<std::size_t>(connectivity->num_trees)+1,
+                  ExcMessage("The partitioning of the triangulation in the checkpoint "
+                             "file is inconsistent."));
+
+      if (parallel_ghost != nullptr)
+        {
+          dealii::internal::p4est::functions<dim>::ghost_destroy (parallel_ghost);
+          parallel_ghost = nullptr;
+        }
+      dealii::internal::p4est::functions<dim>::destroy (parallel_forest);
+      parallel_forest = nullptr;
+
+      attached_data_size = 0;
+      n_attached_datas = 0;
+      n_attached_deserialize = info[3];
+
+      // every quadrant is stored by its coordinates and its level
+      const std::size_t quadrant_size = (dim+1) * sizeof(p4est_qcoord_t);
+      if (n_writers == n_procs)
+        {
+          // restart on the same number of processors: keep the partitioning
+          // and build the forest directly from the mapped file
+          const ArrayView<const char> quadrants
+            = reader.get_block ("triangulation/quadrants", my_rank);
+          const ArrayView<const char> data
+            = reader.get_block ("triangulation/data", my_rank);
+          AssertThrow (quadrants.size() ==
+                       (saved_first_quadrant[my_rank+1]-saved_first_quadrant[my_rank]) * quadrant_size &&
+                       data.size() ==
+                       (saved_first_quadrant[my_rank+1]-saved_first_quadrant[my_rank]) * data_size,
+                       ExcMessage("The number of cells in the checkpoint file is inconsistent."));
+
+          sc_array_t *quadrant_array
+            = sc_array_new_data (const_cast<char *>(quadrants.begin()),
+                                 sizeof(p4est_qcoord_t),
+                                 quadrants.size() / sizeof(p4est_qcoord_t));
+          sc_array_t *data_array
+            = (data_size > 0 ?
+               sc_array_new_data (const_cast<char *>(data.begin()),
+                                  data_size, data.size() / data_size) :
+               nullptr);
+          parallel_forest
+            = dealii::internal::p4est::functions<dim>::inflate (this->mpi_communicator,
+                                                                connectivity,
+                                                                saved_first_quadrant.begin(),
+                                                                pertree.begin(),
+                                                                quadrant_array,
+                                                                data_array,
+                                                                this);
+          sc_array_destroy (quadrant_array);
+          if (data_array != nullptr)
+            sc_array_destroy (data_array);
+        }
+      else
+        {
+          // otherwise distribute the quadrants evenly and collect the
+          // local ones from the parts of all processors that wrote the file
+          const p4est_gloidx_t n_global_quadrants = saved_first_quadrant[n_writers];
+          std::vector<p4est_gloidx_t> first_quadrant (n_procs+1);
+          for (unsigned int p=0; p<=n_procs; ++p)
+            first_quadrant[p] = n_global_quadrants * p / n_procs;
+
+          const p4est_gloidx_t my_begin = first_quadrant[my_rank];
+          const p4est_gloidx_t my_end = first_quadrant[my_rank+1];
+          std::vector<char> local_quadrants ((my_end-my_begin) * quadrant_size);
+          std::vector<char> local_data ((my_end-my_begin) * data_size);
+          for (unsigned int w=0; w<n_writers; ++w)
+            {
+              const p4est_gloidx_t begin = std::max (saved_first_quadrant[w], my_begin);
+              const p4est_gloidx_t end = std::min (saved_first_quadrant[w+1], my_end);
+              if (begin >= end)
+                continue;
+
+              const ArrayView<const char> quadrants
+                = reader.get_block ("triangulation/quadrants", w);
+              const ArrayView<const char> data
+                = reader.get_block ("triangulation/data", w);
+              AssertThrow (quadrants.size() ==
+                           (saved_first_quadrant[w+1]-saved_first_quadrant[w]) * quadrant_size &&
+                           data.size() ==
+                           (saved_first_quadrant[w+1]-saved_first_quadrant[w]) * data_size,
+                           ExcMessage("The number of cells in the checkpoint file is inconsistent."));
+              std::copy (quadrants.begin() + (begin-saved_first_quadrant[w]) * quadrant_size,
+                         quadrants.begin() + (end-saved_first_quadrant[w]) * quadrant_size,
+                         local_quadrants.begin() + (begin-my_begin) * quadrant_size);
+              std::copy (data.begin() + (begin-saved_first_quadrant[w]) * data_size,
+                         data.begin() + (end-saved_first_quadrant[w]) * data_size,
+                         local_data.begin() + (begin-my_begin) * data_size);
+            }
+
+          sc_array_t *quadrant_array
+            = sc_array_new_data (local_quadrants.data(), sizeof(p4est_qcoord_t),
+                                 local_quadrants.size() / sizeof(p4est_qcoord_t));
+          sc_array_t *data_array
+            = (data_size > 0 ?
+               sc_array_new_data (local_data.data(), data_size, my_end-my_begin) :
+               nullptr);
+          parallel_forest
+            = dealii::internal::p4est::functions<dim>::inflate (this->mpi_communicator,
+                                                                connectivity,
+                                                                first_quadrant.data(),
+                                                                pertree.begin(),
+                                                                quadrant_array,
+                                                                data_array,
+                                                                this);
+          sc_array_destroy (quadrant_array);
+          if (data_array != nullptr)
+            sc_array_destroy (data_array);
+
+          // the even distribution of quadrants does not take into account
+          // families of cells and weights, so repartition the forest the same
+          // way as after refinement
+          repartition();
+        }
+
+      try
+        {
+          copy_local_forest_to_triangulation ();
+        }
+      catch (const typename Triangulation<dim>::DistortedCellList &)
+        {
+          // the underlying
+          // triangulation should not
+          // be checking for
+          // distorted cells
+          Assert (false, ExcInternalError());
+        }
+
+      this->update_number_cache ();
+      this->update_periodic_face_map();
+#else
+      (void)reader;
+      AssertThrow (false,
+                   ExcMessage ("Loading a parallel::distributed::Triangulation from a "
+                               "checkpoint file requires p4est version 2.0 or newer."));
+#endif
+    }
+
+
+
     template <int dim, int spacedim>
     unsigned int
     Triangulation<dim,spacedim>::get_checksum () const
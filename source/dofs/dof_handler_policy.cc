@@ -19,6 +19,7 @@
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/dofs/dof_handler.h>
@@ -42,6 +43,7 @@ DEAL_II_ENABLE_EXTRA_DIAGNOSTICS
 #include <set>
 #include <algorithm>
 #include <numeric>
+#include <atomic>
 
 DEAL_II_NAMESPACE_OPEN
 
@@ -272,148 +274,211 @@ namespace internal
         /* -------------- distribute_dofs functionality ------------- */
 
         /**
-         * Distribute dofs on the given cell, with new dofs starting with index
-         * @p next_free_dof. Return the next unused index number.
-         *
-         * This function is refactored from the main @p distribute_dofs function since
-         * it can not be implemented dimension independent.
+         * Set the index of the <i>d</i>th dof on the quad with number @p quad
+         * of a cell. Quads only have dofs of their own in 3d, and the
+         * specialization for 1d only exists so that the calling code
+         * compiles.
          */
-        template <int spacedim>
+        template <int dim, int spacedim>
         static
-        types::global_dof_index
-        distribute_dofs_on_cell (const DoFHandler<1,spacedim>                                &dof_handler,
-                                 const typename DoFHandler<1,spacedim>::active_cell_iterator &cell,
-                                 types::global_dof_index                                      next_free_dof)
+        void
+        set_quad_dof_index (const TriaActiveIterator<dealii::DoFCellAccessor<DoFHandler<dim,spacedim>,false> > &cell,
+                            const unsigned int                                                                   quad,
+                            const unsigned int                                                                   d,
+                            const types::global_dof_index                                                        index)
         {
-
-          // distribute dofs of vertices
-          if (dof_handler.get_fe().dofs_per_vertex > 0)
-            for (unsigned int v=0; v<GeometryInfo<1>::vertices_per_cell; ++v)
-              {
-                if (cell->vertex_dof_index (v,0) == numbers::invalid_dof_index)
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                    {
-                      Assert ((cell->vertex_dof_index (v,d) ==
-                               numbers::invalid_dof_index),
-                              ExcInternalError());
-                      cell->set_vertex_dof_index (v, d, next_free_dof++);
-                    }
-                else
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                    Assert ((cell->vertex_dof_index (v,d) !=
-                             numbers::invalid_dof_index),
-                            ExcInternalError());
-              }
-
-          // dofs of line
-          for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_line; ++d)
-            cell->set_dof_index (d, next_free_dof++);
-
-          return next_free_dof;
+          cell->quad(quad)->set_dof_index (d, index);
         }
 
 
 
         template <int spacedim>
         static
-        types::global_dof_index
-        distribute_dofs_on_cell (const DoFHandler<2,spacedim>                                &dof_handler,
-                                 const typename DoFHandler<2,spacedim>::active_cell_iterator &cell,
-                                 types::global_dof_index                                      next_free_dof)
+        void
+        set_quad_dof_index (const TriaActiveIterator<dealii::DoFCellAccessor<DoFHandler<1,spacedim>,false> > &,
+                            const unsigned int,
+                            const unsigned int,
+                            const types::global_dof_index)
         {
-          if (dof_handler.get_fe().dofs_per_vertex > 0)
-            // number dofs on vertices
-            for (unsigned int vertex=0; vertex<GeometryInfo<2>::vertices_per_cell; ++vertex)
-              // check whether dofs for this vertex have been distributed
-              // (checking the first dof should be good enough)
-              if (cell->vertex_dof_index(vertex, 0) == numbers::invalid_dof_index)
-                for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                  cell->set_vertex_dof_index (vertex, d, next_free_dof++);
-
-          // for the four sides
-          if (dof_handler.get_fe().dofs_per_line > 0)
-            for (unsigned int side=0; side<GeometryInfo<2>::faces_per_cell; ++side)
-              {
-                const typename DoFHandler<2,spacedim>::line_iterator
-                line = cell->line(side);
-
-                // distribute dofs if necessary: check whether line dof is already
-                // numbered (checking the first dof should be good enough)
-                if (line->dof_index(0) == numbers::invalid_dof_index)
-                  // if not: distribute dofs
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_line; ++d)
-                    line->set_dof_index (d, next_free_dof++);
-              }
-
-
-          // dofs of quad
-          if (dof_handler.get_fe().dofs_per_quad > 0)
-            for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_quad; ++d)
-              cell->set_dof_index (d, next_free_dof++);
-
-          return next_free_dof;
+          Assert (false, ExcImpossibleInDim(1));
         }
 
 
 
-        template <int spacedim>
+        /**
+         * Distribute dofs on the given cells of a DoFHandler, in the order in
+         * which they are given, and return the number of dofs distributed.
+         *
+         * The result is the same as if we looped over the cells and numbered
+         * the dofs on the vertices, lines, and quads of each cell that have
+         * not been numbered before, followed by the dofs in the interior of
+         * the cell, i.e., each of these objects receives its dofs from the
+         * first cell it belongs to, in the order of the objects within this
+         * cell. However, we do not need to know about the previous cells to
+         * number the dofs of a cell: we first determine, for every vertex,
+         * line and quad, which cell it receives its dofs from, then count the
+         * number of dofs each cell provides, and from the offsets computed by
+         * a prefix sum over these counts, set all dof indices. All steps but
+         * the prefix sum work on different cells independently, and we do
+         * them in parallel.
+         */
+        template <int dim, int spacedim>
         static
         types::global_dof_index
-        distribute_dofs_on_cell (const DoFHandler<3,spacedim>                                &dof_handler,
-                                 const typename DoFHandler<3,spacedim>::active_cell_iterator &cell,
-                                 types::global_dof_index                                      next_free_dof)
+        distribute_dofs_on_cells (const DoFHandler<dim,spacedim> &dof_handler,
+                                  const std::vector<typename DoFHandler<dim,spacedim>::active_cell_iterator> &cells)
         {
-          if (dof_handler.get_fe().dofs_per_vertex > 0)
-            // number dofs on vertices
-            for (unsigned int vertex=0; vertex<GeometryInfo<3>::vertices_per_cell; ++vertex)
-              // check whether dofs for this vertex have been distributed
-              // (checking the first dof should be good enough)
-              if (cell->vertex_dof_index(vertex, 0) == numbers::invalid_dof_index)
-                for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_vertex; ++d)
-                  cell->set_vertex_dof_index (vertex, d, next_free_dof++);
-
-          // for the lines
-          if (dof_handler.get_fe().dofs_per_line > 0)
-            for (unsigned int l=0; l<GeometryInfo<3>::lines_per_cell; ++l)
+          typedef typename DoFHandler<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+          const FiniteElement<dim,spacedim> &fe = dof_handler.get_fe();
+          const dealii::Triangulation<dim,spacedim> &tria = dof_handler.get_triangulation();
+          const unsigned int n_cells = cells.size();
+
+          // the objects that can be shared between cells are vertices,
+          // lines (in 2d and 3d), and quads (in 3d)
+          const unsigned int n_object_kinds = dim;
+          const unsigned int dofs_per_object[3]
+            = { fe.dofs_per_vertex,
+                (dim > 1 ? fe.dofs_per_line : 0),
+                (dim > 2 ? fe.dofs_per_quad : 0)
+              };
+          const unsigned int objects_per_cell[3]
+            = { GeometryInfo<dim>::vertices_per_cell,
+                (dim > 1 ? GeometryInfo<dim>::lines_per_cell : 0),
+                (dim > 2 ? GeometryInfo<dim>::quads_per_cell : 0)
+              };
+          const unsigned int n_objects[3]
+            = { tria.n_vertices(),
+                (dim > 1 ? tria.n_raw_lines() : 0),
+                (dim > 2 ? tria.n_raw_quads() : 0)
+              };
+          const unsigned int dofs_per_cell_interior
+            = (dim == 1 ? fe.dofs_per_line :
+               (dim == 2 ? fe.dofs_per_quad : fe.dofs_per_hex));
+
+          const auto object_index = [] (const active_cell_iterator &cell,
+                                        const unsigned int          kind,
+                                        const unsigned int          i)
+                                    -> unsigned int
+          {
+            switch (kind)
               {
-                const typename DoFHandler<3,spacedim>::line_iterator
-                line = cell->line(l);
-
-                // distribute dofs if necessary: check whether line dof is already
-                // numbered (checking the first dof should be good enough)
-                if (line->dof_index(0) == numbers::invalid_dof_index)
-                  // if not: distribute dofs
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_line; ++d)
-                    line->set_dof_index (d, next_free_dof++);
+              case 0:
+                return cell->vertex_index (i);
+              case 1:
+                return cell->line_index (i);
+              default:
+                return cell->quad_index (i);
               }
+          };
 
-          // for the quads
-          if (dof_handler.get_fe().dofs_per_quad > 0)
-            for (unsigned int q=0; q<GeometryInfo<3>::quads_per_cell; ++q)
+          // Step 1: find the owner of each object, i.e., the first cell it
+          // belongs to. several threads may try to claim the same object, so
+          // keep the minimum in an atomic variable
+          std::vector<std::atomic<unsigned int> > owners[3];
+          for (unsigned int kind=0; kind<n_object_kinds; ++kind)
+            if (dofs_per_object[kind] > 0)
               {
-                const typename DoFHandler<3,spacedim>::quad_iterator
-                quad = cell->quad(q);
-
-                // distribute dofs if necessary: check whether line dof is already
-                // numbered (checking the first dof should be good enough)
-                if (quad->dof_index(0) == numbers::invalid_dof_index)
-                  // if not: distribute dofs
-                  for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_quad; ++d)
-                    quad->set_dof_index (d, next_free_dof++);
+                owners[kind] = std::vector<std::atomic<unsigned int> > (n_objects[kind]);
+                for (auto &owner : owners[kind])
+                  owner.store (numbers::invalid_unsigned_int, std::memory_order_relaxed);
               }
 
+          parallel::apply_to_subranges
+          (0U, n_cells,
+           [&] (const unsigned int begin,
+                const unsigned int end)
+          {
+            for (unsigned int c=begin; c<end; ++c)
+              for (unsigned int kind=0; kind<n_object_kinds; ++kind)
+                if (dofs_per_object[kind] > 0)
+                  for (unsigned int i=0; i<objects_per_cell[kind]; ++i)
+                    {
+                      std::atomic<unsigned int> &owner
+                        = owners[kind][object_index (cells[c], kind, i)];
+                      unsigned int current_owner = owner.load (std::memory_order_relaxed);
+                      while (c < current_owner &&
+                             !owner.compare_exchange_weak (current_owner, c,
+                                                           std::memory_order_relaxed))
+                        ;
+                    }
+          },
+          128);
+
+          // Step 2: count the dofs each cell provides and compute the first
+          // index of these dofs by a prefix sum
+          std::vector<types::global_dof_index> first_dof (n_cells+1, 0);
+          parallel::apply_to_subranges
+          (0U, n_cells,
+           [&] (const unsigned int begin,
+                const unsigned int end)
+          {
+            for (unsigned int c=begin; c<end; ++c)
+              {
+                types::global_dof_index n_dofs_on_cell = dofs_per_cell_interior;
+                for (unsigned int kind=0; kind<n_object_kinds; ++kind)
+                  if (dofs_per_object[kind] > 0)
+                    for (unsigned int i=0; i<objects_per_cell[kind]; ++i)
+                      if (owners[kind][object_index (cells[c], kind, i)] == c)
+                        n_dofs_on_cell += dofs_per_object[kind];
+                first_dof[c+1] = n_dofs_on_cell;
+              }
+          },
+          128);
+          std::partial_sum (first_dof.begin(), first_dof.end(), first_dof.begin());
+
+          // Step 3: set the dof indices of the objects each cell owns and of
+          // the interior of the cell, in the same order as when numbering
+          // cell by cell
+          parallel::apply_to_subranges
+          (0U, n_cells,
+           [&] (const unsigned int begin,
+                const unsigned int end)
+          {
+            for (unsigned int c=begin; c<end; ++c)
+              {
+                const active_cell_iterator &cell = cells[c];
+                types::global_dof_index next_free_dof = first_dof[c];
+
+                for (unsigned int kind=0; kind<n_object_kinds; ++kind)
+                  if (dofs_per_object[kind] > 0)
+                    for (unsigned int i=0; i<objects_per_cell[kind]; ++i)
+                      if (owners[kind][object_index (cell, kind, i)] == c)
+                        for (unsigned int d=0; d<dofs_per_object[kind]; ++d)
+                          switch (kind)
+                            {
+                            case 0:
+                              cell->set_vertex_dof_index (i, d, next_free_dof++);
+                              break;
+                            case 1:
+                              cell->line(i)->set_dof_index (d, next_free_dof++);
+                              break;
+                            default:
+                              set_quad_dof_index (cell, i, d, next_free_dof++);
+                              break;
+                            }
+
+                for (unsigned int d=0; d<dofs_per_cell_interior; ++d)
+                  cell->set_dof_index (d, next_free_dof++);
+
+                Assert (next_free_dof == first_dof[c+1], ExcInternalError());
+              }
+          },
+          128);
 
-          // dofs of hex
-          if (dof_handler.get_fe().dofs_per_hex > 0)
-            for (unsigned int d=0; d<dof_handler.get_fe().dofs_per_hex; ++d)
-              cell->set_dof_index (d, next_free_dof++);
-
-          return next_free_dof;
+          return first_dof[n_cells];
         }
 
 
 
-        // same for the hp::DoFHandler
+        /**
+         * Distribute dofs on the given cell of an hp::DoFHandler, with new
+         * dofs starting with index @p next_free_dof. Return the next unused
+         * index number.
+         *
+         * This function is refactored from the main @p distribute_dofs function since
+         * it can not be implemented dimension independent.
+         */
         template <int spacedim>
         static
         types::global_dof_index
@@ -1113,6 +1178,27 @@ namespace internal
 
 
 
+        /**
+         * Distribute dofs on the given cells of an hp::DoFHandler, in the
+         * order in which they are given, and return the number of dofs
+         * distributed. Unlike for the DoFHandler, this is done cell by cell.
+         */
+        template <int dim, int spacedim>
+        static
+        types::global_dof_index
+        distribute_dofs_on_cells (const hp::DoFHandler<dim,spacedim> &dof_handler,
+                                  const std::vector<typename hp::DoFHandler<dim,spacedim>::active_cell_iterator> &cells)
+        {
+          types::global_dof_index next_free_dof = 0;
+          for (const auto &cell : cells)
+            next_free_dof = Implementation::distribute_dofs_on_cell (dof_handler,
+                                                                     cell,
+                                                                     next_free_dof);
+          return next_free_dof;
+        }
+
+
+
         /**
          * Distribute degrees of freedom on all cells, or on cells with the
          * correct subdomain_id if the corresponding argument is not equal to
@@ -1130,7 +1216,7 @@ namespace internal
 
           // Step 1: distribute dofs on all cells, but definitely
           // exclude artificial cells
-          types::global_dof_index next_free_dof = 0;
+          std::vector<typename DoFHandlerType::active_cell_iterator> cells;
           typename DoFHandlerType::active_cell_iterator
           cell = dof_handler.begin_active(),
           endc = dof_handler.end();
@@ -1140,10 +1226,10 @@ namespace internal
               if ((subdomain_id == numbers::invalid_subdomain_id)
                   ||
                   (cell->subdomain_id() == subdomain_id))
-                next_free_dof
-                  = Implementation::distribute_dofs_on_cell (dof_handler,
-                                                             cell,
-                                                             next_free_dof);
+                cells.push_back (cell);
+
+          types::global_dof_index next_free_dof
+            = Implementation::distribute_dofs_on_cells (dof_handler, cells);
 
           // Step 2: unify dof indices in case this is an hp DoFHandler
           next_free_dof = unify_dof_indices (dof_handler, next_free_dof);
@@ -31,6 +31,7 @@
 
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_tools.h>
 
 #include <deal.II/fe/fe.h>
 #include <deal.II/hp/dof_handler.h>
@@ -39,6 +40,8 @@
 
 #include <deal.II/multigrid/mg_tools.h>
 
+#include <deal.II/matrix_free/matrix_free.h>
+
 #include <deal.II/distributed/tria.h>
 
 #include <boost/config.hpp>
@@ -1807,6 +1810,70 @@ namespace DoFRenumbering
 
 
 
+  template <typename DoFHandlerType>
+  void
+  hilbert (DoFHandlerType &dof)
+  {
+    std::vector<types::global_dof_index> renumbering(dof.n_dofs());
+    compute_hilbert(renumbering, dof);
+
+    dof.renumber_dofs(renumbering);
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void
+  compute_hilbert (std::vector<types::global_dof_index> &new_indices,
+                   const DoFHandlerType                 &dof)
+  {
+    std::vector<typename DoFHandlerType::active_cell_iterator> cells;
+    std::vector<Point<DoFHandlerType::space_dimension> > centers;
+    cells.reserve (dof.get_triangulation().n_active_cells());
+    centers.reserve (dof.get_triangulation().n_active_cells());
+    for (typename DoFHandlerType::active_cell_iterator cell = dof.begin_active();
+         cell != dof.end(); ++cell)
+      {
+        cells.push_back (cell);
+        centers.push_back (cell->center());
+      }
+
+    const std::vector<unsigned int> order = GridTools::compute_hilbert_order (centers);
+    std::vector<typename DoFHandlerType::active_cell_iterator> ordered_cells (cells.size());
+    for (unsigned int i=0; i<order.size(); ++i)
+      ordered_cells[i] = cells[order[i]];
+
+    std::vector<types::global_dof_index> reverse(new_indices.size());
+    compute_cell_wise(new_indices, reverse, dof, ordered_cells);
+  }
+
+
+
+  template <typename DoFHandlerType>
+  void hilbert (DoFHandlerType     &dof,
+                const unsigned int  level)
+  {
+    std::vector<typename DoFHandlerType::level_cell_iterator> cells;
+    std::vector<Point<DoFHandlerType::space_dimension> > centers;
+    cells.reserve (dof.get_triangulation().n_cells(level));
+    centers.reserve (dof.get_triangulation().n_cells(level));
+    for (typename DoFHandlerType::level_cell_iterator cell = dof.begin(level);
+         cell != dof.end(level); ++cell)
+      {
+        cells.push_back (cell);
+        centers.push_back (cell->center());
+      }
+
+    const std::vector<unsigned int> order = GridTools::compute_hilbert_order (centers);
+    std::vector<typename DoFHandlerType::level_cell_iterator> ordered_cells (cells.size());
+    for (unsigned int i=0; i<order.size(); ++i)
+      ordered_cells[i] = cells[order[i]];
+
+    cell_wise(dof, level, ordered_cells);
+  }
+
+
+
   template <typename DoFHandlerType>
   void
   random (DoFHandlerType &dof_handler)
@@ -1910,6 +1977,94 @@ namespace DoFRenumbering
             ExcInternalError());
   }
 
+
+
+  template <int dim, typename Number>
+  void
+  matrix_free_data_locality (DoFHandler<dim>              &dof_handler,
+                             const MatrixFree<dim,Number> &matrix_free)
+  {
+    const unsigned int level = matrix_free.get_mg_level();
+    std::vector<types::global_dof_index> renumbering
+    ((level == numbers::invalid_unsigned_int ?
+      dof_handler.locally_owned_dofs() :
+      dof_handler.locally_owned_mg_dofs(level)).n_elements(),
+     numbers::invalid_dof_index);
+    compute_matrix_free_data_locality (renumbering, dof_handler, matrix_free);
+
+    if (level == numbers::invalid_unsigned_int)
+      dof_handler.renumber_dofs (renumbering);
+    else
+      dof_handler.renumber_dofs (level, renumbering);
+  }
+
+
+
+  template <int dim, typename Number>
+  void
+  compute_matrix_free_data_locality (std::vector<types::global_dof_index> &new_dof_indices,
+                                     const DoFHandler<dim>                &dof_handler,
+                                     const MatrixFree<dim,Number>         &matrix_free)
+  {
+    // find out which of the DoFHandler objects of the MatrixFree object we
+    // work on
+    unsigned int dof_handler_index = numbers::invalid_unsigned_int;
+    for (unsigned int i=0; i<matrix_free.n_components(); ++i)
+      if (&matrix_free.get_dof_handler(i) == &dof_handler)
+        {
+          dof_handler_index = i;
+          break;
+        }
+    AssertThrow (dof_handler_index != numbers::invalid_unsigned_int,
+                 ExcMessage ("The given DoFHandler is not one of the DoFHandler "
+                             "objects the MatrixFree object was set up with."));
+
+    const unsigned int level = matrix_free.get_mg_level();
+    const IndexSet &owned_dofs = (level == numbers::invalid_unsigned_int ?
+                                  dof_handler.locally_owned_dofs() :
+                                  dof_handler.locally_owned_mg_dofs(level));
+    Assert (new_dof_indices.size() == owned_dofs.n_elements(),
+            ExcDimensionMismatch (new_dof_indices.size(), owned_dofs.n_elements()));
+    std::fill (new_dof_indices.begin(), new_dof_indices.end(),
+               numbers::invalid_dof_index);
+
+    // go through the cells in the order of the cell loop of the MatrixFree
+    // object and number the locally owned dofs when they are first
+    // accessed. the new indices are taken from the set of locally owned
+    // dofs, so that this set does not change
+    types::global_dof_index next_free_index = 0;
+    std::vector<types::global_dof_index> dof_indices;
+    for (unsigned int macro_cell=0; macro_cell<matrix_free.n_macro_cells(); ++macro_cell)
+      for (unsigned int v=0; v<matrix_free.n_components_filled(macro_cell); ++v)
+        {
+          const typename DoFHandler<dim>::cell_iterator
+          cell = matrix_free.get_cell_iterator (macro_cell, v, dof_handler_index);
+          dof_indices.resize (cell->get_fe().dofs_per_cell);
+          if (level == numbers::invalid_unsigned_int)
+            cell->get_dof_indices (dof_indices);
+          else
+            cell->get_mg_dof_indices (dof_indices);
+
+          for (unsigned int i=0; i<dof_indices.size(); ++i)
+            if (owned_dofs.is_element (dof_indices[i]))
+              {
+                const types::global_dof_index local_index
+                  = owned_dofs.index_within_set (dof_indices[i]);
+                if (new_dof_indices[local_index] == numbers::invalid_dof_index)
+                  new_dof_indices[local_index]
+                    = owned_dofs.nth_index_in_set (next_free_index++);
+              }
+        }
+
+    // put the dofs that are not accessed by the cell loop at the end, in
+    // their old order
+    for (types::global_dof_index i=0; i<new_dof_indices.size(); ++i)
+      if (new_dof_indices[i] == numbers::invalid_dof_index)
+        new_dof_indices[i] = owned_dofs.nth_index_in_set (next_free_index++);
+
+    Assert (next_free_index == owned_dofs.n_elements(), ExcInternalError());
+  }
+
 } // namespace DoFRenumbering
 
 
@@ -14,6 +14,8 @@
 // ---------------------------------------------------------------------
 
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/thread_local_storage.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/template_constraints.h>
@@ -41,6 +43,7 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
 DEAL_II_NAMESPACE_OPEN
@@ -109,6 +112,250 @@ namespace DoFTools
 
 
 
+  template <typename DoFHandlerType>
+  void
+  make_compressed_sparsity_pattern (const DoFHandlerType      &dof,
+                                    SparsityPattern           &sparsity,
+                                    const ConstraintMatrix    &constraints,
+                                    const bool                 keep_constrained_dofs,
+                                    const types::subdomain_id  subdomain_id)
+  {
+    // If we have a distributed::Triangulation only allow locally_owned
+    // subdomain. Not setting a subdomain is also okay, because we skip
+    // ghost cells in the loop below.
+    Assert (
+      (dof.get_triangulation().locally_owned_subdomain() == numbers::invalid_subdomain_id)
+      ||
+      (subdomain_id == numbers::invalid_subdomain_id)
+      ||
+      (subdomain_id == dof.get_triangulation().locally_owned_subdomain()),
+      ExcMessage ("For parallel::distributed::Triangulation objects and "
+                  "associated DoF handler objects, asking for any subdomain other "
+                  "than the locally owned one does not make sense."));
+
+    const types::global_dof_index n_dofs = dof.n_dofs();
+
+    // collect the cells that contribute to the sparsity pattern. these are
+    // the same as in make_sparsity_pattern()
+    std::vector<typename DoFHandlerType::active_cell_iterator> cells;
+    for (typename DoFHandlerType::active_cell_iterator cell = dof.begin_active();
+         cell != dof.end(); ++cell)
+      if (((subdomain_id == numbers::invalid_subdomain_id)
+           ||
+           (subdomain_id == cell->subdomain_id()))
+          &&
+          cell->is_locally_owned())
+        cells.push_back (cell);
+    const unsigned int n_cells = cells.size();
+
+    // ConstraintMatrix::add_entries_local_to_global() couples all of the dof
+    // indices that remain on a cell after resolving the constraints, i.e.,
+    // the unconstrained dof indices and the indices the constrained ones
+    // are constrained to. with keep_constrained_dofs, it additionally
+    // couples each constrained dof index with all dof indices of the cell
+    // in both directions; otherwise only the diagonal entry of constrained
+    // dofs is added, which the SparsityPattern always contains anyway. in
+    // order to reproduce this row by row, store the sorted dof indices and
+    // the sorted resolved indices of each cell in compressed row storage
+    const auto resolve_constraints
+      = [&constraints] (const types::global_dof_index *begin,
+                        const types::global_dof_index *end,
+                        std::vector<types::global_dof_index> &resolved)
+    {
+      resolved.clear ();
+      for (const types::global_dof_index *p=begin; p!=end; ++p)
+        if (constraints.is_constrained (*p) == false)
+          resolved.push_back (*p);
+        else
+          {
+            const std::vector<std::pair<types::global_dof_index,double> > &entries
+              = *constraints.get_constraint_entries (*p);
+            for (unsigned int q=0; q<entries.size(); ++q)
+              resolved.push_back (entries[q].first);
+          }
+      std::sort (resolved.begin(), resolved.end());
+      resolved.erase (std::unique (resolved.begin(), resolved.end()),
+                      resolved.end());
+    };
+
+    std::vector<std::size_t> cell_dof_start (n_cells+1, 0);
+    for (unsigned int c=0; c<n_cells; ++c)
+      cell_dof_start[c+1] = cell_dof_start[c] + cells[c]->get_fe().dofs_per_cell;
+    std::vector<types::global_dof_index> cell_dofs (cell_dof_start[n_cells]);
+
+    // the number of resolved indices of each cell is only known after
+    // resolving the constraints, so resolve them twice: once to count, and
+    // once to store them
+    std::vector<std::size_t> resolved_start (n_cells+1, 0);
+    parallel::apply_to_subranges
+    (0U, n_cells,
+     [&] (const unsigned int begin,
+          const unsigned int end)
+    {
+      std::vector<types::global_dof_index> local_dof_indices, resolved;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          local_dof_indices.resize (cells[c]->get_fe().dofs_per_cell);
+          cells[c]->get_dof_indices (local_dof_indices);
+          std::sort (local_dof_indices.begin(), local_dof_indices.end());
+          std::copy (local_dof_indices.begin(), local_dof_indices.end(),
+                     cell_dofs.begin() + cell_dof_start[c]);
+
+          resolve_constraints (cell_dofs.data() + cell_dof_start[c],
+                               cell_dofs.data() + cell_dof_start[c+1],
+                               resolved);
+          resolved_start[c+1] = resolved.size();
+        }
+    },
+    64);
+    std::partial_sum (resolved_start.begin(), resolved_start.end(),
+                      resolved_start.begin());
+
+    std::vector<types::global_dof_index> resolved_dofs (resolved_start[n_cells]);
+    parallel::apply_to_subranges
+    (0U, n_cells,
+     [&] (const unsigned int begin,
+          const unsigned int end)
+    {
+      std::vector<types::global_dof_index> resolved;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          resolve_constraints (cell_dofs.data() + cell_dof_start[c],
+                               cell_dofs.data() + cell_dof_start[c+1],
+                               resolved);
+          std::copy (resolved.begin(), resolved.end(),
+                     resolved_dofs.begin() + resolved_start[c]);
+        }
+    },
+    64);
+
+    // next find, for each row, the cells that write into it. these are the
+    // cells on which the row is among the resolved indices and, with
+    // keep_constrained_dofs, the ones on which it is among the dof indices
+    const auto rows_of_cell
+      = [&] (const unsigned int                    c,
+             std::vector<types::global_dof_index> &rows)
+    {
+      rows.clear ();
+      if (keep_constrained_dofs)
+        std::set_union (cell_dofs.begin() + cell_dof_start[c],
+                        cell_dofs.begin() + cell_dof_start[c+1],
+                        resolved_dofs.begin() + resolved_start[c],
+                        resolved_dofs.begin() + resolved_start[c+1],
+                        std::back_inserter (rows));
+      else
+        rows.insert (rows.end(),
+                     resolved_dofs.begin() + resolved_start[c],
+                     resolved_dofs.begin() + resolved_start[c+1]);
+    };
+
+    std::vector<std::atomic<unsigned int> > n_cells_of_row (n_dofs);
+    parallel::apply_to_subranges
+    (0U, n_cells,
+     [&] (const unsigned int begin,
+          const unsigned int end)
+    {
+      std::vector<types::global_dof_index> rows;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          rows_of_cell (c, rows);
+          for (unsigned int i=0; i<rows.size(); ++i)
+            ++n_cells_of_row[rows[i]];
+        }
+    },
+    64);
+
+    std::vector<std::size_t> row_start (n_dofs+1, 0);
+    for (types::global_dof_index row=0; row<n_dofs; ++row)
+      {
+        row_start[row+1] = row_start[row] + n_cells_of_row[row];
+        n_cells_of_row[row] = 0;
+      }
+
+    std::vector<unsigned int> cells_of_row (row_start[n_dofs]);
+    parallel::apply_to_subranges
+    (0U, n_cells,
+     [&] (const unsigned int begin,
+          const unsigned int end)
+    {
+      std::vector<types::global_dof_index> rows;
+      for (unsigned int c=begin; c<end; ++c)
+        {
+          rows_of_cell (c, rows);
+          for (unsigned int i=0; i<rows.size(); ++i)
+            cells_of_row[row_start[rows[i]] + n_cells_of_row[rows[i]]++] = c;
+        }
+    },
+    64);
+
+    // now we can compute the sorted column indices of each row
+    // independently of all other rows
+    const auto compute_columns
+      = [&] (const types::global_dof_index         row,
+             std::vector<types::global_dof_index> &columns)
+    {
+      columns.clear ();
+      columns.push_back (row);
+      const bool row_is_constrained = constraints.is_constrained (row);
+      for (std::size_t k=row_start[row]; k<row_start[row+1]; ++k)
+        {
+          const unsigned int c = cells_of_row[k];
+          const auto dofs_begin = cell_dofs.begin() + cell_dof_start[c];
+          const auto dofs_end = cell_dofs.begin() + cell_dof_start[c+1];
+          const auto resolved_begin = resolved_dofs.begin() + resolved_start[c];
+          const auto resolved_end = resolved_dofs.begin() + resolved_start[c+1];
+
+          if (std::binary_search (resolved_begin, resolved_end, row))
+            columns.insert (columns.end(), resolved_begin, resolved_end);
+
+          if (keep_constrained_dofs &&
+              std::binary_search (dofs_begin, dofs_end, row))
+            {
+              // a constrained row couples with all dofs of the cell,
+              // other rows with the constrained dofs of the cell
+              if (row_is_constrained)
+                columns.insert (columns.end(), dofs_begin, dofs_end);
+              else
+                for (auto p=dofs_begin; p!=dofs_end; ++p)
+                  if (constraints.is_constrained (*p))
+                    columns.push_back (*p);
+            }
+        }
+      std::sort (columns.begin(), columns.end());
+      columns.erase (std::unique (columns.begin(), columns.end()),
+                     columns.end());
+    };
+
+    // first pass over the rows: count the entries of each row
+    std::vector<unsigned int> row_lengths (n_dofs);
+    parallel::apply_to_subranges
+    (types::global_dof_index(0), n_dofs,
+     [&] (const types::global_dof_index begin,
+          const types::global_dof_index end)
+    {
+      std::vector<types::global_dof_index> columns;
+      for (types::global_dof_index row=begin; row<end; ++row)
+        {
+          compute_columns (row, columns);
+          row_lengths[row] = columns.size();
+        }
+    },
+    256);
+
+    // second pass: allocate the final pattern and write the rows into it
+    Threads::ThreadLocalStorage<std::vector<types::global_dof_index> > scratch;
+    sparsity.copy_from (n_dofs, n_dofs, row_lengths,
+                        [&] (const types::global_dof_index  row,
+                             types::global_dof_index       *column_indices)
+    {
+      std::vector<types::global_dof_index> &columns = scratch.get();
+      compute_columns (row, columns);
+      std::copy (columns.begin(), columns.end(), column_indices);
+    });
+  }
+
+
+
   template <typename DoFHandlerType, typename SparsityPatternType>
   void
   make_sparsity_pattern (const DoFHandlerType      &dof,
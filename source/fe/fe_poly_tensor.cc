@@ -32,107 +32,98 @@ namespace internal
 {
   namespace FE_PolyTensor
   {
-    namespace
+    //---------------------------------------------------------------------------
+    // Utility method, which is used to determine the change of sign for
+    // the DoFs on the faces of the given cell.
+    //---------------------------------------------------------------------------
+
+    void
+    get_face_sign_change_rt (const dealii::Triangulation<1>::cell_iterator &,
+                             const unsigned int,
+                             std::vector<double>                           &face_sign)
     {
-      //---------------------------------------------------------------------------
-      // Utility method, which is used to determine the change of sign for
-      // the DoFs on the faces of the given cell.
-      //---------------------------------------------------------------------------
-
-      /**
-       * On noncartesian grids, the sign of the DoFs associated with the faces of
-       * the elements has to be changed in some cases.  This procedure implements an
-       * algorithm, which determines the DoFs, which need this sign change for a
-       * given cell.
-       */
-      void
-      get_face_sign_change_rt (const dealii::Triangulation<1>::cell_iterator &,
-                               const unsigned int,
-                               std::vector<double>                           &face_sign)
-      {
-        // nothing to do in 1d
-        std::fill (face_sign.begin (), face_sign.end (), 1.0);
-      }
-
-
-
-      void
-      get_face_sign_change_rt (const dealii::Triangulation<2>::cell_iterator &cell,
-                               const unsigned int                             dofs_per_face,
-                               std::vector<double>                           &face_sign)
-      {
-        const unsigned int dim = 2;
-        const unsigned int spacedim = 2;
-
-        // Default is no sign
-        // change. I.e. multiply by one.
-        std::fill (face_sign.begin (), face_sign.end (), 1.0);
-
-        for (unsigned int f = GeometryInfo<dim>::faces_per_cell / 2;
-             f < GeometryInfo<dim>::faces_per_cell; ++f)
-          {
-            dealii::Triangulation<dim,spacedim>::face_iterator face = cell->face (f);
-            if (!face->at_boundary ())
-              {
-                const unsigned int nn = cell->neighbor_face_no(f);
-
-                if (nn < GeometryInfo<dim>::faces_per_cell / 2)
-                  for (unsigned int j = 0; j < dofs_per_face; ++j)
-                    {
-                      Assert (f * dofs_per_face + j < face_sign.size(),
-                              ExcInternalError());
-
-                      //TODO: This is probably only going to work for those elements for which all dofs are face dofs
-                      face_sign[f * dofs_per_face + j] = -1.0;
-                    }
-              }
-          }
-      }
-
-
-
-      void
-      get_face_sign_change_rt (const dealii::Triangulation<3>::cell_iterator &/*cell*/,
-                               const unsigned int                             /*dofs_per_face*/,
-                               std::vector<double>                           &face_sign)
-      {
-        std::fill (face_sign.begin (), face_sign.end (), 1.0);
-        //TODO: think about what it would take here
-      }
-
-      void
-      get_face_sign_change_nedelec (const dealii::Triangulation<1>::cell_iterator &/*cell*/,
-                                    const unsigned int                             /*dofs_per_face*/,
-                                    std::vector<double>                           &face_sign)
-      {
-        // nothing to do in 1d
-        std::fill (face_sign.begin (), face_sign.end (), 1.0);
-      }
-
-
-
-      void
-      get_face_sign_change_nedelec (const dealii::Triangulation<2>::cell_iterator &/*cell*/,
-                                    const unsigned int                             /*dofs_per_face*/,
-                                    std::vector<double>                           &face_sign)
-      {
-        std::fill (face_sign.begin (), face_sign.end (), 1.0);
-        //TODO: think about what it would take here
-      }
-
-
-      void
-      get_face_sign_change_nedelec (const dealii::Triangulation<3>::cell_iterator &cell,
-                                    const unsigned int                             /*dofs_per_face*/,
-                                    std::vector<double>                           &face_sign)
-      {
-        const unsigned int dim = 3;
-        std::fill (face_sign.begin (), face_sign.end (), 1.0);
-        //TODO: This is probably only going to work for those elements for which all dofs are face dofs
-        for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
-          if (!(cell->line_orientation (l)))
-            face_sign[l] = -1.0;
-      }
+      // nothing to do in 1d
+      std::fill (face_sign.begin (), face_sign.end (), 1.0);
+    }
+
+
+
+    void
+    get_face_sign_change_rt (const dealii::Triangulation<2>::cell_iterator &cell,
+                             const unsigned int                             dofs_per_face,
+                             std::vector<double>                           &face_sign)
+    {
+      const unsigned int dim = 2;
+      const unsigned int spacedim = 2;
+
+      // Default is no sign
+      // change. I.e. multiply by one.
+      std::fill (face_sign.begin (), face_sign.end (), 1.0);
+
+      for (unsigned int f = GeometryInfo<dim>::faces_per_cell / 2;
+           f < GeometryInfo<dim>::faces_per_cell; ++f)
+        {
+          dealii::Triangulation<dim,spacedim>::face_iterator face = cell->face (f);
+          if (!face->at_boundary ())
+            {
+              const unsigned int nn = cell->neighbor_face_no(f);
+
+              if (nn < GeometryInfo<dim>::faces_per_cell / 2)
+                for (unsigned int j = 0; j < dofs_per_face; ++j)
+                  {
+                    Assert (f * dofs_per_face + j < face_sign.size(),
+                            ExcInternalError());
+
+                    //TODO: This is probably only going to work for those elements for which all dofs are face dofs
+                    face_sign[f * dofs_per_face + j] = -1.0;
+                  }
+            }
+        }
+    }
+
+
+
+    void
+    get_face_sign_change_rt (const dealii::Triangulation<3>::cell_iterator &/*cell*/,
+                             const unsigned int                             /*dofs_per_face*/,
+                             std::vector<double>                           &face_sign)
+    {
+      std::fill (face_sign.begin (), face_sign.end (), 1.0);
+      //TODO: think about what it would take here
+    }
+
+    void
+    get_face_sign_change_nedelec (const dealii::Triangulation<1>::cell_iterator &/*cell*/,
+                                  const unsigned int                             /*dofs_per_face*/,
+                                  std::vector<double>                           &face_sign)
+    {
+      // nothing to do in 1d
+      std::fill (face_sign.begin (), face_sign.end (), 1.0);
+    }
+
+
+
+    void
+    get_face_sign_change_nedelec (const dealii::Triangulation<2>::cell_iterator &/*cell*/,
+                                  const unsigned int                             /*dofs_per_face*/,
+                                  std::vector<double>                           &face_sign)
+    {
+      std::fill (face_sign.begin (), face_sign.end (), 1.0);
+      //TODO: think about what it would take here
+    }
+
+
+    void
+    get_face_sign_change_nedelec (const dealii::Triangulation<3>::cell_iterator &cell,
+                                  const unsigned int                             /*dofs_per_face*/,
+                                  std::vector<double>                           &face_sign)
+    {
+      const unsigned int dim = 3;
+      std::fill (face_sign.begin (), face_sign.end (), 1.0);
+      //TODO: This is probably only going to work for those elements for which all dofs are face dofs
+      for (unsigned int l = 0; l < GeometryInfo<dim>::lines_per_cell; ++l)
+        if (!(cell->line_orientation (l)))
+          face_sign[l] = -1.0;
     }
   }
 }
@@ -0,0 +1,525 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/polynomials_abf.h>
+#include <deal.II/base/polynomials_bdm.h>
+#include <deal.II/base/polynomials_nedelec.h>
+#include <deal.II/base/polynomials_raviart_thomas.h>
+#include <deal.II/fe/fe_poly_tensor.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <int dim, typename Number>
+FEValuesBatch<dim,Number>::FEValuesBatch (const Mapping<dim>       &mapping,
+                                          const FiniteElement<dim> &fe,
+                                          const Quadrature<dim>    &quadrature,
+                                          const UpdateFlags         update_flags)
+  :
+  n_quadrature_points (quadrature.size()),
+  dofs_per_cell (fe.dofs_per_cell),
+  mapping (&mapping, typeid(*this).name()),
+  mapping_q (dynamic_cast<const MappingQGeneric<dim,dim> *>(&mapping),
+             typeid(*this).name()),
+  fe (&fe, typeid(*this).name()),
+  quadrature (quadrature),
+  update_flags (update_flags),
+  need_mapping_second_derivatives (false),
+  n_filled_lanes (0)
+{
+  initialize ();
+}
+
+
+
+template <int dim, typename Number>
+FEValuesBatch<dim,Number>::FEValuesBatch (const FiniteElement<dim> &fe,
+                                          const Quadrature<dim>    &quadrature,
+                                          const UpdateFlags         update_flags)
+  :
+  n_quadrature_points (quadrature.size()),
+  dofs_per_cell (fe.dofs_per_cell),
+  mapping (&StaticMappingQ1<dim>::mapping, typeid(*this).name()),
+  mapping_q (&StaticMappingQ1<dim>::mapping, typeid(*this).name()),
+  fe (&fe, typeid(*this).name()),
+  quadrature (quadrature),
+  update_flags (update_flags),
+  need_mapping_second_derivatives (false),
+  n_filled_lanes (0)
+{
+  initialize ();
+}
+
+
+
+template <int dim, typename Number>
+void
+FEValuesBatch<dim,Number>::get_transformation (const FiniteElement<dim> &fe,
+                                               Transformation           &transformation,
+                                               MappingType              &sign_change_type)
+{
+  sign_change_type = mapping_none;
+
+  // vector-valued elements whose shape functions are transformed by one of
+  // the Piola transformations are all derived from FE_PolyTensor. the
+  // polynomial spaces listed here are the ones FE_PolyTensor is
+  // instantiated for
+  MappingType mapping_type = mapping_none;
+  if (const FE_PolyTensor<PolynomialsRaviartThomas<dim>,dim> *fe_poly
+      = dynamic_cast<const FE_PolyTensor<PolynomialsRaviartThomas<dim>,dim> *>(&fe))
+    mapping_type = fe_poly->mapping_type;
+  else if (const FE_PolyTensor<PolynomialsNedelec<dim>,dim> *fe_poly
+           = dynamic_cast<const FE_PolyTensor<PolynomialsNedelec<dim>,dim> *>(&fe))
+    mapping_type = fe_poly->mapping_type;
+  else if (const FE_PolyTensor<PolynomialsBDM<dim>,dim> *fe_poly
+           = dynamic_cast<const FE_PolyTensor<PolynomialsBDM<dim>,dim> *>(&fe))
+    mapping_type = fe_poly->mapping_type;
+  else if (const FE_PolyTensor<PolynomialsABF<dim>,dim> *fe_poly
+           = dynamic_cast<const FE_PolyTensor<PolynomialsABF<dim>,dim> *>(&fe))
+    mapping_type = fe_poly->mapping_type;
+  else
+    {
+      // for all other elements, we can only deal with primitive elements
+      // whose shape function values do not need any information from the
+      // mapping, i.e., which are the same on the real cell as on the
+      // reference cell. the gradients of such elements are transformed by
+      // the covariant transformation
+      const UpdateFlags required_flags
+        = fe.requires_update_flags (update_values | update_gradients);
+      AssertThrow (fe.is_primitive() &&
+                   (required_flags & ~(update_values | update_gradients |
+                                       update_covariant_transformation)) == 0,
+                   ExcUnsupportedElement (fe.get_name()));
+      mapping_type = mapping_none;
+    }
+
+  switch (mapping_type)
+    {
+    case mapping_none:
+      transformation = identity;
+      break;
+    case mapping_covariant:
+      transformation = covariant;
+      break;
+    case mapping_nedelec:
+      transformation = covariant;
+      sign_change_type = mapping_nedelec;
+      break;
+    case mapping_contravariant:
+      transformation = contravariant;
+      break;
+    case mapping_piola:
+      transformation = piola;
+      break;
+    case mapping_raviart_thomas:
+      transformation = piola;
+      sign_change_type = mapping_raviart_thomas;
+      break;
+    default:
+      AssertThrow (false, ExcUnsupportedElement (fe.get_name()));
+    }
+}
+
+
+
+template <int dim, typename Number>
+void
+FEValuesBatch<dim,Number>::initialize ()
+{
+  AssertThrow (mapping_q != nullptr, ExcUnsupportedMapping());
+  Assert ((update_flags & ~(update_values | update_gradients |
+                            update_quadrature_points | update_JxW_values |
+                            update_jacobians | update_inverse_jacobians)) == 0,
+          ExcMessage ("FEValuesBatch only supports the flags update_values, "
+                      "update_gradients, update_quadrature_points, "
+                      "update_JxW_values, update_jacobians, and "
+                      "update_inverse_jacobians."));
+
+  // find out how the shape functions of each base element are transformed
+  // and set up the rows of the shape function tables. primitive shape
+  // functions occupy one row, non-primitive ones one row for each of their
+  // nonzero components
+  std::vector<Transformation> base_transformations (fe->n_base_elements());
+  std::vector<unsigned int> base_sign_change_index (fe->n_base_elements(),
+                                                    numbers::invalid_unsigned_int);
+  for (unsigned int b=0; b<fe->n_base_elements(); ++b)
+    {
+      MappingType sign_change_type;
+      get_transformation (fe->base_element(b), base_transformations[b],
+                          sign_change_type);
+      if (base_transformations[b] != identity)
+        {
+          AssertThrow (fe->base_element(b).n_components() == dim,
+                       ExcUnsupportedElement (fe->base_element(b).get_name()));
+          if (update_flags & update_gradients)
+            need_mapping_second_derivatives = true;
+        }
+      if (sign_change_type != mapping_none)
+        {
+          base_sign_change_index[b] = sign_change_base_elements.size();
+          sign_change_base_elements.push_back (std::make_pair (b, sign_change_type));
+        }
+    }
+
+  shape_function_to_row.resize (dofs_per_cell);
+  first_component.resize (dofs_per_cell);
+  transformations.resize (dofs_per_cell);
+  sign_change_index.resize (dofs_per_cell, numbers::invalid_unsigned_int);
+  unsigned int n_rows = 0;
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    {
+      const unsigned int base = fe->system_to_base_index(i).first.first;
+      shape_function_to_row[i] = n_rows;
+      first_component[i] = fe->get_nonzero_components(i).first_selected_component();
+      transformations[i] = base_transformations[base];
+      if (base_sign_change_index[base] != numbers::invalid_unsigned_int)
+        sign_change_index[i] = base_sign_change_index[base];
+
+      if (fe->is_primitive(i))
+        ++n_rows;
+      else
+        {
+          // the shape functions of vector-valued base elements are nonzero
+          // in all of the base element's components
+          Assert (fe->get_nonzero_components(i).n_selected_components() == dim,
+                  ExcInternalError());
+          n_rows += dim;
+        }
+    }
+
+  // compute the values and gradients of all shape functions on the
+  // reference cell
+  reference_values.reinit (n_rows, n_quadrature_points);
+  reference_gradients.reinit (n_rows, n_quadrature_points);
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    {
+      const unsigned int n_components_i = (fe->is_primitive(i) ? 1 : dim);
+      for (unsigned int c=0; c<n_components_i; ++c)
+        for (unsigned int q=0; q<n_quadrature_points; ++q)
+          {
+            reference_values(shape_function_to_row[i]+c, q)
+              = fe->shape_value_component (i, quadrature.point(q),
+                                           first_component[i]+c);
+            reference_gradients(shape_function_to_row[i]+c, q)
+              = fe->shape_grad_component (i, quadrature.point(q),
+                                          first_component[i]+c);
+          }
+    }
+
+  shape_values.reinit (n_rows, n_quadrature_points);
+  shape_gradients.reinit (n_rows, n_quadrature_points);
+
+  // the values of shape functions that are not transformed are the same on
+  // all cells, so set them once and for all
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    if (transformations[i] == identity)
+      for (unsigned int q=0; q<n_quadrature_points; ++q)
+        shape_values(shape_function_to_row[i], q)
+          = make_vectorized_array (Number(reference_values(shape_function_to_row[i], q)));
+
+  // evaluate the shape functions of the mapping at the quadrature points
+  typename MappingQGeneric<dim,dim>::InternalData
+  mapping_data (mapping_q->get_degree());
+  mapping_data.initialize (update_quadrature_points | update_jacobians |
+                           (need_mapping_second_derivatives ?
+                            update_jacobian_grads : update_default),
+                           quadrature, n_quadrature_points);
+  const unsigned int n_mapping_shape_functions = mapping_data.n_shape_functions;
+  mapping_values.reinit (n_quadrature_points, n_mapping_shape_functions);
+  mapping_derivatives.reinit (n_quadrature_points, n_mapping_shape_functions);
+  if (need_mapping_second_derivatives)
+    mapping_second_derivatives.reinit (n_quadrature_points, n_mapping_shape_functions);
+  for (unsigned int q=0; q<n_quadrature_points; ++q)
+    for (unsigned int k=0; k<n_mapping_shape_functions; ++k)
+      {
+        mapping_values(q,k) = mapping_data.shape(q,k);
+        mapping_derivatives(q,k) = mapping_data.derivative(q,k);
+        if (need_mapping_second_derivatives)
+          mapping_second_derivatives(q,k) = mapping_data.second_derivative(q,k);
+      }
+
+  quadrature_points.resize (n_quadrature_points);
+  JxW_values.resize (n_quadrature_points);
+  jacobians.resize (n_quadrature_points);
+  inverse_jacobians.resize (n_quadrature_points);
+  inverse_determinants.resize (n_quadrature_points);
+  if (need_mapping_second_derivatives)
+    jacobian_pushed_forward_grads.resize (n_quadrature_points);
+  mapping_support_points.resize (n_mapping_shape_functions);
+  sign_changes.resize (sign_change_base_elements.size());
+  for (unsigned int s=0; s<sign_change_base_elements.size(); ++s)
+    sign_changes[s].resize (fe->base_element(sign_change_base_elements[s].first).dofs_per_cell);
+  cells.resize (n_lanes);
+}
+
+
+
+template <int dim, typename Number>
+void
+FEValuesBatch<dim,Number>::compute_values ()
+{
+  typedef VectorizedArray<Number> VectorizedNumber;
+
+  // collect the mapping support points of all cells of the batch into
+  // vectorized points. the unused lanes duplicate the first cell
+  const unsigned int n_mapping_shape_functions = mapping_support_points.size();
+  for (unsigned int lane=0; lane<n_lanes; ++lane)
+    {
+      if (lane > 0 && lane >= n_filled_lanes)
+        {
+          for (unsigned int k=0; k<n_mapping_shape_functions; ++k)
+            for (unsigned int d=0; d<dim; ++d)
+              mapping_support_points[k][d][lane] = mapping_support_points[k][d][0];
+          continue;
+        }
+
+      const std::vector<Point<dim> > points
+        = mapping_q->compute_mapping_support_points (cells[lane]);
+      Assert (points.size() == n_mapping_shape_functions, ExcInternalError());
+      for (unsigned int k=0; k<n_mapping_shape_functions; ++k)
+        for (unsigned int d=0; d<dim; ++d)
+          mapping_support_points[k][d][lane] = points[k][d];
+    }
+
+  // the mask that zeros out JxW on unused lanes
+  VectorizedNumber lane_mask;
+  for (unsigned int lane=0; lane<n_lanes; ++lane)
+    lane_mask[lane] = (lane < n_filled_lanes ? 1. : 0.);
+
+  // compute the geometric quantities at all quadrature points with
+  // vectorized arithmetic
+  const std::vector<double> &weights = quadrature.get_weights();
+  for (unsigned int q=0; q<n_quadrature_points; ++q)
+    {
+      Tensor<2,dim,VectorizedNumber> jacobian;
+      for (unsigned int k=0; k<n_mapping_shape_functions; ++k)
+        for (unsigned int i=0; i<dim; ++i)
+          for (unsigned int j=0; j<dim; ++j)
+            jacobian[i][j] += (mapping_support_points[k][i] *
+                               Number(mapping_derivatives(q,k)[j]));
+      jacobians[q] = jacobian;
+      inverse_jacobians[q] = invert (jacobian);
+
+      const VectorizedNumber det = determinant (jacobian);
+#ifdef DEBUG
+      for (unsigned int lane=0; lane<n_filled_lanes; ++lane)
+        Assert (det[lane] > 1e-12*Utilities::fixed_power<dim>(cells[lane]->diameter()/
+                                                              std::sqrt(double(dim))),
+                (typename Mapping<dim>::ExcDistortedMappedCell(cells[lane]->center(),
+                                                                det[lane], q)));
+#endif
+      JxW_values[q] = det * Number(weights[q]) * lane_mask;
+      inverse_determinants[q] = Number(1.) / det;
+
+      if (update_flags & update_quadrature_points)
+        {
+          Point<dim,VectorizedNumber> point;
+          for (unsigned int k=0; k<n_mapping_shape_functions; ++k)
+            for (unsigned int d=0; d<dim; ++d)
+              point[d] += mapping_support_points[k][d] * Number(mapping_values(q,k));
+          quadrature_points[q] = point;
+        }
+
+      // the derivatives of the Jacobian, pushed forward to the real cell,
+      // i.e., the same as update_jacobian_pushed_forward_grads computes
+      if (need_mapping_second_derivatives)
+        {
+          Tensor<3,dim,VectorizedNumber> jacobian_grad;
+          for (unsigned int k=0; k<n_mapping_shape_functions; ++k)
+            for (unsigned int i=0; i<dim; ++i)
+              for (unsigned int j=0; j<dim; ++j)
+                for (unsigned int l=0; l<dim; ++l)
+                  jacobian_grad[i][j][l] += (mapping_support_points[k][i] *
+                                             Number(mapping_second_derivatives(q,k)[j][l]));
+
+          const Tensor<2,dim,VectorizedNumber> &inverse_jacobian = inverse_jacobians[q];
+          Tensor<3,dim,VectorizedNumber> tmp;
+          for (unsigned int i=0; i<dim; ++i)
+            for (unsigned int j=0; j<dim; ++j)
+              for (unsigned int l=0; l<dim; ++l)
+                for (unsigned int jr=0; jr<dim; ++jr)
+                  tmp[i][j][l] += jacobian_grad[i][jr][l] * inverse_jacobian[jr][j];
+          Tensor<3,dim,VectorizedNumber> &pushed_forward_grad = jacobian_pushed_forward_grads[q];
+          for (unsigned int i=0; i<dim; ++i)
+            for (unsigned int j=0; j<dim; ++j)
+              for (unsigned int l=0; l<dim; ++l)
+                {
+                  pushed_forward_grad[i][j][l] = tmp[i][j][0] * inverse_jacobian[0][l];
+                  for (unsigned int lr=1; lr<dim; ++lr)
+                    pushed_forward_grad[i][j][l] += tmp[i][j][lr] * inverse_jacobian[lr][l];
+                }
+        }
+    }
+
+  // compute the signs of shape functions that depend on the cell. this is
+  // done in the same way as in FE_PolyTensor
+  for (unsigned int s=0; s<sign_change_base_elements.size(); ++s)
+    {
+      const FiniteElement<dim> &base = fe->base_element (sign_change_base_elements[s].first);
+      std::vector<double> signs (base.dofs_per_cell);
+      for (unsigned int lane=0; lane<n_lanes; ++lane)
+        {
+          if (sign_change_base_elements[s].second == mapping_raviart_thomas)
+            internal::FE_PolyTensor::get_face_sign_change_rt (cells[lane], base.dofs_per_face,
+                                                              signs);
+          else
+            internal::FE_PolyTensor::get_face_sign_change_nedelec (cells[lane], base.dofs_per_face,
+                                                                   signs);
+          for (unsigned int i=0; i<base.dofs_per_cell; ++i)
+            sign_changes[s][i][lane] = signs[i];
+        }
+    }
+
+  // finally transform the shape functions. the operations for the
+  // vector-valued elements are the same, and done in the same order, as in
+  // FE_PolyTensor::fill_fe_values() and MappingQGeneric::transform()
+  for (unsigned int i=0; i<dofs_per_cell; ++i)
+    {
+      const unsigned int row = shape_function_to_row[i];
+      if (transformations[i] == identity)
+        {
+          if (update_flags & update_gradients)
+            for (unsigned int q=0; q<n_quadrature_points; ++q)
+              {
+                const Tensor<2,dim,VectorizedNumber> &inverse_jacobian = inverse_jacobians[q];
+                const Tensor<1,dim> &reference_gradient = reference_gradients(row,q);
+                Tensor<1,dim,VectorizedNumber> gradient;
+                for (unsigned int d=0; d<dim; ++d)
+                  for (unsigned int e=0; e<dim; ++e)
+                    gradient[d] += inverse_jacobian[e][d] * Number(reference_gradient[e]);
+                shape_gradients(row,q) = gradient;
+              }
+          continue;
+        }
+
+      VectorizedNumber sign = make_vectorized_array (Number(1.));
+      if (sign_change_index[i] != numbers::invalid_unsigned_int)
+        sign = sign_changes[sign_change_index[i]][fe->system_to_base_index(i).second];
+
+      for (unsigned int q=0; q<n_quadrature_points; ++q)
+        {
+          const Tensor<2,dim,VectorizedNumber> &jacobian = jacobians[q];
+          const Tensor<2,dim,VectorizedNumber> &inverse_jacobian = inverse_jacobians[q];
+          const VectorizedNumber &inverse_det = inverse_determinants[q];
+
+          Tensor<1,dim,VectorizedNumber> value;
+          Tensor<2,dim,VectorizedNumber> gradient;
+          for (unsigned int d=0; d<dim; ++d)
+            for (unsigned int e=0; e<dim; ++e)
+              {
+                const Number reference_value = reference_values(row+e,q);
+                switch (transformations[i])
+                  {
+                  case covariant:
+                    value[d] += inverse_jacobian[e][d] * reference_value;
+                    break;
+                  case contravariant:
+                  case piola:
+                    value[d] += jacobian[d][e] * reference_value;
+                    break;
+                  default:
+                    Assert (false, ExcInternalError());
+                  }
+              }
+          if (transformations[i] == piola)
+            value *= inverse_det;
+          value *= sign;
+
+          for (unsigned int d=0; d<dim; ++d)
+            shape_values(row+d,q) = value[d];
+
+          if (!(update_flags & update_gradients))
+            continue;
+
+          // the gradient of component a in direction b on the reference
+          // cell
+          Tensor<2,dim,VectorizedNumber> reference_gradient;
+          for (unsigned int a=0; a<dim; ++a)
+            for (unsigned int b=0; b<dim; ++b)
+              reference_gradient[a][b] = Number(reference_gradients(row+a,q)[b]);
+
+          const Tensor<3,dim,VectorizedNumber> &pushed_forward_grad
+            = jacobian_pushed_forward_grads[q];
+          switch (transformations[i])
+            {
+            case covariant:
+              // J^{-T} D J^{-1}, minus the derivative of the mapping
+              gradient = transpose(inverse_jacobian) * reference_gradient * inverse_jacobian;
+              for (unsigned int d=0; d<dim; ++d)
+                for (unsigned int n=0; n<dim; ++n)
+                  gradient[d] -= value[n] * pushed_forward_grad[n][d];
+              break;
+            case contravariant:
+              // J D J^{-1}, plus the derivative of the mapping
+              gradient = jacobian * reference_gradient * inverse_jacobian;
+              for (unsigned int d=0; d<dim; ++d)
+                for (unsigned int n=0; n<dim; ++n)
+                  gradient[d] += value[n] * pushed_forward_grad[d][n];
+              break;
+            case piola:
+              // J D J^{-1} / det J, plus the derivatives of the mapping and
+              // its determinant
+              gradient = jacobian * reference_gradient * inverse_jacobian;
+              gradient *= inverse_det;
+              for (unsigned int d=0; d<dim; ++d)
+                for (unsigned int n=0; n<dim; ++n)
+                  gradient[d] += (value[n] * pushed_forward_grad[d][n] -
+                                  value[d] * pushed_forward_grad[n][n]);
+              break;
+            default:
+              Assert (false, ExcInternalError());
+            }
+          gradient *= sign;
+
+          for (unsigned int d=0; d<dim; ++d)
+            shape_gradients(row+d,q) = gradient[d];
+        }
+    }
+}
+
+
+
+template <int dim, typename Number>
+std::size_t
+FEValuesBatch<dim,Number>::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (mapping_values) +
+          MemoryConsumption::memory_consumption (mapping_derivatives) +
+          MemoryConsumption::memory_consumption (mapping_second_derivatives) +
+          MemoryConsumption::memory_consumption (shape_function_to_row) +
+          MemoryConsumption::memory_consumption (first_component) +
+          MemoryConsumption::memory_consumption (sign_change_index) +
+          MemoryConsumption::memory_consumption (reference_values) +
+          MemoryConsumption::memory_consumption (reference_gradients) +
+          MemoryConsumption::memory_consumption (shape_values) +
+          MemoryConsumption::memory_consumption (shape_gradients) +
+          MemoryConsumption::memory_consumption (quadrature_points) +
+          MemoryConsumption::memory_consumption (JxW_values) +
+          MemoryConsumption::memory_consumption (jacobians) +
+          MemoryConsumption::memory_consumption (inverse_jacobians) +
+          MemoryConsumption::memory_consumption (inverse_determinants) +
+          MemoryConsumption::memory_consumption (jacobian_pushed_forward_grads) +
+          MemoryConsumption::memory_consumption (mapping_support_points));
+}
+
+
+#include "fe_values_batch.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -17,6 +17,7 @@
 #include <deal.II/base/path_search.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/exceptions.h>
+#include <deal.II/base/parallel.h>
 
 #include <deal.II/grid/grid_in.h>
 #include <deal.II/grid/tria.h>
@@ -25,9 +26,16 @@
 
 #include <map>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <functional>
 #include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
 
 
 #ifdef DEAL_II_WITH_NETCDF
@@ -80,9 +88,519 @@ namespace
   }
 }
 
+
+namespace internal
+{
+  namespace Gmsh
+  {
+    /**
+     * The data of one element of a Gmsh file as we read it: its type, its
+     * number in the file, the physical tag that we interpret as material or
+     * boundary id, and the tags of its nodes. None of the element types we
+     * know about has more than eight nodes.
+     */
+    struct Element
+    {
+      unsigned int type;
+      unsigned int n_nodes;
+      unsigned int material_id;
+      std::size_t  number;
+      unsigned int nodes[8];
+    };
+
+
+
+    /**
+     * Return the number of nodes of an element of the given Gmsh element
+     * type. Besides the types read_msh() can deal with, we also know about
+     * triangles, tetrahedra, prisms and pyramids, so that we can give a
+     * helpful error message for them. Return zero for all other types.
+     */
+    unsigned int
+    n_nodes_of_element_type (const unsigned int type)
+    {
+      switch (type)
+        {
+        case 1:
+          return 2;   // line
+        case 2:
+          return 3;   // triangle
+        case 3:
+          return 4;   // quadrilateral
+        case 4:
+          return 4;   // tetrahedron
+        case 5:
+          return 8;   // hexahedron
+        case 6:
+          return 6;   // prism
+        case 7:
+          return 5;   // pyramid
+        case 15:
+          return 1;   // point
+        default:
+          return 0;
+        }
+    }
+
+
+
+    /**
+     * A position in a buffer that holds (part of) a Gmsh file, along with
+     * functions that read whitespace separated words and numbers, or binary
+     * data, from this position on and advance it. Errors, such as reading
+     * beyond the end of the range the object was created for, do not throw
+     * an exception but set a flag that can be queried through failed(). This
+     * allows to use objects of this type on several threads at once.
+     */
+    class Cursor
+    {
+    public:
+      Cursor (const char *begin,
+              const char *end)
+        :
+        position (begin),
+        end (end),
+        has_failed (false)
+      {}
+
+      const char *get_position () const
+      {
+        return position;
+      }
+
+      const char *get_end () const
+      {
+        return end;
+      }
+
+      void set_position (const char *new_position)
+      {
+        position = new_position;
+      }
+
+      bool failed () const
+      {
+        return has_failed;
+      }
+
+      /**
+       * Skip whitespace and return whether the end of the range has been
+       * reached.
+       */
+      bool at_end ()
+      {
+        skip_whitespace ();
+        return position == end;
+      }
+
+      /**
+       * If only blanks follow on the current line, move to the beginning of
+       * the next line. Otherwise, stay where we are.
+       */
+      void skip_end_of_line ()
+      {
+        const char *p = position;
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+          ++p;
+        if (p == end)
+          position = end;
+        else if (*p == '\n')
+          position = p+1;
+      }
+
+      /**
+       * Move behind the line that starts with the given marker, e.g., the
+       * end of a section of the file.
+       */
+      void skip_past (const std::string &marker)
+      {
+        const char *p = std::search (position, end, marker.begin(), marker.end());
+        if (p == end)
+          {
+            has_failed = true;
+            position = end;
+          }
+        else
+          position = p + marker.size();
+      }
+
+      std::string read_word ()
+      {
+        skip_whitespace ();
+        const char *begin = position;
+        while (position != end && !is_space (*position))
+          ++position;
+        if (begin == position)
+          has_failed = true;
+        return std::string (begin, position);
+      }
+
+      long long read_integer ()
+      {
+        skip_whitespace ();
+        bool negative = false;
+        if (position != end && (*position == '-' || *position == '+'))
+          {
+            negative = (*position == '-');
+            ++position;
+          }
+        if (position == end || !is_digit (*position))
+          {
+            has_failed = true;
+            return 0;
+          }
+
+        long long value = 0;
+        while (position != end && is_digit (*position))
+          value = 10*value + (*position++ - '0');
+        check_end_of_number ();
+        return (negative ? -value : value);
+      }
+
+      /**
+       * Read a floating point number. Numbers with at most 15 significant
+       * digits and a decimal exponent of at most 22 in magnitude, i.e., all
+       * numbers Gmsh usually writes, are converted by a single
+       * multiplication or division of two numbers that are exactly
+       * representable, which gives the correctly rounded result (this is
+       * Clinger's fast path). All other numbers are converted by
+       * std::strtod().
+       */
+      double read_double ()
+      {
+        static const double powers_of_ten[]
+          = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+              1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+        skip_whitespace ();
+        const char *p = position;
+        bool negative = false;
+        if (p != end && (*p == '-' || *p == '+'))
+          {
+            negative = (*p == '-');
+            ++p;
+          }
+
+        std::uint64_t mantissa = 0;
+        unsigned int  n_significant_digits = 0;
+        int           exponent = 0;
+        bool          found_digits = false;
+        for (; p != end && is_digit (*p); ++p)
+          {
+            mantissa = 10*mantissa + (*p - '0');
+            if (mantissa != 0 && ++n_significant_digits > 15)
+              break;
+            found_digits = true;
+          }
+        if (p != end && *p == '.' && n_significant_digits <= 15)
+          for (++p; p != end && is_digit (*p); ++p)
+            {
+              mantissa = 10*mantissa + (*p - '0');
+              --exponent;
+              if (mantissa != 0 && ++n_significant_digits > 15)
+                break;
+              found_digits = true;
+            }
+        if (p != end && (*p == 'e' || *p == 'E') && n_significant_digits <= 15)
+          {
+            ++p;
+            bool negative_exponent = false;
+            if (p != end && (*p == '-' || *p == '+'))
+              {
+                negative_exponent = (*p == '-');
+                ++p;
+              }
+            int explicit_exponent = 0;
+            if (p == end || !is_digit (*p))
+              found_digits = false;
+            for (; p != end && is_digit (*p) && explicit_exponent < 10000; ++p)
+              explicit_exponent = 10*explicit_exponent + (*p - '0');
+            exponent += (negative_exponent ? -explicit_exponent : explicit_exponent);
+          }
+
+        if (found_digits && n_significant_digits <= 15 &&
+            exponent >= -22 && exponent <= 22 &&
+            (p == end || is_space (*p)))
+          {
+            double value = static_cast<double>(mantissa);
+            if (exponent < 0)
+              value /= powers_of_ten[-exponent];
+            else
+              value *= powers_of_ten[exponent];
+            position = p;
+            return (negative ? -value : value);
+          }
+
+        // the buffer is terminated by a zero character, so std::strtod can
+        // not read beyond its end
+        char *number_end = nullptr;
+        const double value = std::strtod (position, &number_end);
+        if (number_end == position || number_end > end)
+          {
+            has_failed = true;
+            return 0;
+          }
+        position = number_end;
+        check_end_of_number ();
+        return value;
+      }
+
+      template <typename T>
+      T read_binary ()
+      {
+        T value = T();
+        if (static_cast<std::size_t>(end - position) < sizeof(T))
+          {
+            has_failed = true;
+            position = end;
+            return value;
+          }
+        std::memcpy (&value, position, sizeof(T));
+        position += sizeof(T);
+        return value;
+      }
+
+      /**
+       * Read a number of type @p T, either in binary form or as text.
+       */
+      template <typename T>
+      T read (const bool binary)
+      {
+        if (binary)
+          return read_binary<T>();
+        else if (std::is_floating_point<T>::value)
+          return static_cast<T>(read_double());
+        else
+          return static_cast<T>(read_integer());
+      }
+
+      void skip_bytes (const std::size_t n_bytes)
+      {
+        if (static_cast<std::size_t>(end - position) < n_bytes)
+          {
+            has_failed = true;
+            position = end;
+          }
+        else
+          position += n_bytes;
+      }
+
+    private:
+      static bool is_space (const char c)
+      {
+        return std::isspace (static_cast<unsigned char>(c));
+      }
+
+      static bool is_digit (const char c)
+      {
+        return (c >= '0' && c <= '9');
+      }
+
+      void skip_whitespace ()
+      {
+        while (position != end && is_space (*position))
+          ++position;
+      }
+
+      void check_end_of_number ()
+      {
+        if (position != end && !is_space (*position))
+          has_failed = true;
+      }
+
+      const char *position;
+      const char *end;
+      bool        has_failed;
+    };
+
+
+
+    /**
+     * Parse @p n_records records of a text file, starting at the current
+     * position of @p cursor, by calling <tt>parse_record(i, record)</tt> for
+     * each of them, where <tt>record</tt> is a Cursor positioned at the
+     * beginning of the record. If each record is on a line of its own, as in
+     * the files Gmsh writes, the lines are parsed in parallel. Otherwise,
+     * the records are parsed one after the other. Afterwards, @p cursor is
+     * positioned behind the last record. Return whether all records could be
+     * parsed.
+     */
+    template <typename RecordParser>
+    bool
+    parse_records (Cursor             &cursor,
+                   const std::size_t   n_records,
+                   const RecordParser &parse_record)
+    {
+      cursor.skip_end_of_line ();
+      const char *const begin = cursor.get_position();
+      const char *const end = cursor.get_end();
+      if (n_records == 0)
+        return true;
+
+      std::vector<const char *> line_starts;
+      line_starts.reserve (n_records+1);
+      line_starts.push_back (begin);
+      while (line_starts.size() <= n_records && line_starts.back() != end)
+        {
+          const char *next_line
+            = static_cast<const char *>(std::memchr (line_starts.back(), '\n',
+                                                     end - line_starts.back()));
+          line_starts.push_back (next_line == nullptr ? end : next_line+1);
+        }
+
+      if (line_starts.size() == n_records+1)
+        {
+          std::atomic<bool> success (true);
+          parallel::apply_to_subranges
+          (std::size_t(0), n_records,
+           [&] (const std::size_t first,
+                const std::size_t last)
+          {
+            for (std::size_t i=first; i<last; ++i)
+              {
+                Cursor record (line_starts[i], line_starts[i+1]);
+                parse_record (i, record);
+                if (record.failed() || !record.at_end())
+                  success = false;
+              }
+          },
+          1024);
+
+          if (success)
+            {
+              cursor.set_position (line_starts[n_records]);
+              return true;
+            }
+        }
+
+      // the records are not on lines of their own
+      cursor.set_position (begin);
+      for (std::size_t i=0; i<n_records && !cursor.failed(); ++i)
+        parse_record (i, cursor);
+      return !cursor.failed();
+    }
+
+
+
+    /**
+     * Like parse_records(), but for @p n_records records of binary data of
+     * @p record_size bytes each. These can always be parsed in parallel.
+     */
+    template <typename RecordParser>
+    bool
+    parse_binary_records (Cursor             &cursor,
+                          const std::size_t   n_records,
+                          const std::size_t   record_size,
+                          const RecordParser &parse_record)
+    {
+      const char *const begin = cursor.get_position();
+      if (record_size == 0 ||
+          n_records > static_cast<std::size_t>(cursor.get_end() - begin) / record_size)
+        return false;
+
+      parallel::apply_to_subranges
+      (std::size_t(0), n_records,
+       [&] (const std::size_t first,
+            const std::size_t last)
+      {
+        for (std::size_t i=first; i<last; ++i)
+          {
+            Cursor record (begin + i*record_size, begin + (i+1)*record_size);
+            parse_record (i, record);
+          }
+      },
+      1024);
+
+      cursor.set_position (begin + n_records*record_size);
+      return true;
+    }
+
+
+
+    /**
+     * Read the <tt>$Entities</tt> section of a file in version 4 of the
+     * format, and return the first physical tag of each point, curve,
+     * surface, and volume that has one.
+     */
+    std::array<std::map<int,int>,4>
+    read_entities (Cursor     &cursor,
+                   const bool  binary)
+    {
+      std::array<std::map<int,int>,4> physical_tags;
+      if (binary)
+        cursor.skip_end_of_line ();
+
+      std::uint64_t n_entities[4];
+      for (unsigned int d=0; d<4; ++d)
+        n_entities[d] = cursor.read<std::uint64_t>(binary);
+
+      for (unsigned int d=0; d<4; ++d)
+        for (std::uint64_t e=0; e<n_entities[d] && !cursor.failed(); ++e)
+          {
+            const int tag = cursor.read<int>(binary);
+
+            // points are described by their coordinates, all other entities
+            // by their bounding box
+            for (unsigned int i=0; i<(d == 0 ? 3U : 6U); ++i)
+              cursor.read<double>(binary);
+
+            const std::uint64_t n_physical_tags = cursor.read<std::uint64_t>(binary);
+            for (std::uint64_t i=0; i<n_physical_tags && !cursor.failed(); ++i)
+              {
+                const int physical_tag = cursor.read<int>(binary);
+                if (i == 0)
+                  physical_tags[d][tag] = physical_tag;
+              }
+
+            if (d > 0)
+              {
+                const std::uint64_t n_bounding_entities = cursor.read<std::uint64_t>(binary);
+                for (std::uint64_t i=0; i<n_bounding_entities && !cursor.failed(); ++i)
+                  cursor.read<int>(binary);
+              }
+          }
+
+      return physical_tags;
+    }
+
+
+
+    /**
+     * Read the rest of the stream @p in into memory and terminate the
+     * result by a zero character.
+     */
+    std::vector<char>
+    read_stream (std::istream &in)
+    {
+      std::vector<char> buffer;
+
+      // if the stream can tell us its size, read everything at once
+      const std::istream::pos_type start = in.tellg();
+      if (start != std::istream::pos_type(-1) && in.seekg (0, std::ios::end))
+        {
+          const std::istream::pos_type stop = in.tellg();
+          in.seekg (start);
+          buffer.resize (static_cast<std::size_t>(stop - start));
+          in.read (buffer.data(), buffer.size());
+          buffer.resize (in.gcount());
+        }
+      else
+        {
+          in.clear ();
+          buffer.assign (std::istreambuf_iterator<char>(in),
+                         std::istreambuf_iterator<char>());
+        }
+
+      buffer.push_back ('\0');
+      return buffer;
+    }
+  }
+}
+
 template <int dim, int spacedim>
 GridIn<dim, spacedim>::GridIn () :
-  tria(nullptr, typeid(*this).name()), default_format(ucd)
+  tria(nullptr, typeid(*this).name()), default_format(ucd), reorder_cells(true)
 {}
 
 
@@ -94,6 +612,14 @@ void GridIn<dim, spacedim>::attach_triangulation (Triangulation<dim, spacedim> &
 
 
 
+template <int dim, int spacedim>
+void GridIn<dim, spacedim>::set_reorder_cells (const bool reorder)
+{
+  reorder_cells = reorder;
+}
+
+
+
 template <int dim, int spacedim>
 void GridIn<dim, spacedim>::read_vtk(std::istream &in)
 {
@@ -367,7 +893,8 @@ void GridIn<dim, spacedim>::read_vtk(std::istream &in)
         GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
             cells);
 
-      GridReordering<dim, spacedim>::reorder_cells(cells);
+      if (reorder_cells)
+        GridReordering<dim, spacedim>::reorder_cells(cells);
       tria->create_triangulation_compatibility(vertices,
                                                cells,
                                                subcelldata);
@@ -608,7 +1135,8 @@ void GridIn<dim, spacedim>::read_unv(std::istream &in)
     GridReordering<dim, spacedim>::invert_all_cells_of_negative_grid(vertices,
         cells);
 
-  GridReordering<dim, spacedim>::reorder_cells(cells);
+  if (reorder_cells)
+    GridReordering<dim, spacedim>::reorder_cells(cells);
 
   tria->create_triangulation_compatibility(vertices,
                                            cells,
@@ -819,7 +1347,8 @@ void GridIn<dim, spacedim>::read_ucd (std::istream                            &i
   // ... and cells
   if (dim==spacedim)
     GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1056,7 +1585,8 @@ void GridIn<dim, spacedim>::read_dbmesh (std::istream &in)
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ...and cells
   GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1135,7 +1665,8 @@ void GridIn<2>::read_xda (std::istream &in)
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ... and cells
   GridReordering<2>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<2>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<2>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1213,7 +1744,8 @@ void GridIn<3>::read_xda (std::istream &in)
   GridTools::delete_unused_vertices (vertices, cells, subcelldata);
   // ... and cells
   GridReordering<3>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<3>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<3>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
@@ -1226,204 +1758,495 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   Assert (tria != nullptr, ExcNoTriangulationSelected());
   AssertThrow (in, ExcIO());
 
-  unsigned int n_vertices;
-  unsigned int n_cells;
-  unsigned int dummy;
-  std::string line;
+  // read the whole file into memory at once. all of the parsing below
+  // works on this buffer, which allows us to split the long lists of nodes
+  // and elements into chunks that are converted in parallel
+  const std::vector<char> buffer = internal::Gmsh::read_stream (in);
+  internal::Gmsh::Cursor cursor (buffer.data(), buffer.data() + buffer.size() - 1);
 
-  in >> line;
+  std::string line = cursor.read_word();
 
-  // first determine file format
+  // first determine file format. we understand version 1, versions 2.0
+  // to 2.2, and version 4.1 of the format. the latter two may also be
+  // stored in binary form
   unsigned int gmsh_file_format = 0;
+  bool binary = false;
+  std::array<std::map<int,int>,4> entity_physical_tags;
   if (line == "$NOD")
     gmsh_file_format = 1;
   else if (line == "$MeshFormat")
-    gmsh_file_format = 2;
-  else
-    AssertThrow (false, ExcInvalidGMSHInput(line));
-
-  // if file format is 2 or greater
-  // then we also have to read the
-  // rest of the header
-  if (gmsh_file_format == 2)
     {
-      double version;
-      unsigned int file_type, data_size;
-
-      in >> version >> file_type >> data_size;
-
-      Assert ( (version >= 2.0) &&
-               (version <= 2.2), ExcNotImplemented());
-      Assert (file_type == 0, ExcNotImplemented());
-      Assert (data_size == sizeof(double), ExcNotImplemented());
-
-      // read the end of the header
-      // and the first line of the
-      // nodes description to synch
-      // ourselves with the format 1
-      // handling above
-      in >> line;
+      const std::string version_string = cursor.read_word();
+      const double version = std::strtod (version_string.c_str(), nullptr);
+      const long long file_type = cursor.read_integer();
+      const long long data_size = cursor.read_integer();
+
+      if ((version >= 2.0) && (version <= 2.2))
+        gmsh_file_format = 2;
+      else if ((version >= 4.1) && (version < 5))
+        gmsh_file_format = 4;
+      else
+        AssertThrow (false,
+                     ExcMessage ("Version " + version_string + " of the Gmsh "
+                                 "file format is not supported. Please "
+                                 "write your mesh in version 2.2 or 4.1 of "
+                                 "the format."));
+      AssertThrow ((file_type == 0) || (file_type == 1),
+                   ExcInvalidGMSHInput(Utilities::to_string(file_type)));
+      // this is the size of a double in version 2, and the size of a size_t
+      // in version 4 of the format
+      AssertThrow (data_size == 8,
+                   ExcInvalidGMSHInput(Utilities::to_string(data_size)));
+
+      // binary files contain the integer one to determine the byte order
+      binary = (file_type == 1);
+      if (binary)
+        {
+          cursor.skip_end_of_line ();
+          AssertThrow (cursor.read_binary<int>() == 1,
+                       ExcMessage ("The binary Gmsh file was written on a "
+                                   "machine with a different byte order."));
+        }
+
+      line = cursor.read_word();
       AssertThrow (line == "$EndMeshFormat",
                    ExcInvalidGMSHInput(line));
 
-      in >> line;
-      // if the next block is of kind
-      // $PhysicalNames, ignore it
-      if (line == "$PhysicalNames")
+      // skip all sections up to the list of nodes, except for the
+      // $Entities section of version 4 files that contains the physical
+      // tags we interpret as material and boundary ids
+      line = cursor.read_word();
+      while ((line != "$Nodes") && !cursor.failed())
         {
-          do
-            {
-              in >> line;
-            }
-          while (line != "$EndPhysicalNames");
-          in >> line;
+          AssertThrow ((line.size() > 1) && (line[0] == '$'),
+                       ExcInvalidGMSHInput(line));
+          if ((line == "$Entities") && (gmsh_file_format == 4))
+            entity_physical_tags = internal::Gmsh::read_entities (cursor, binary);
+          cursor.skip_past ("$End" + line.substr(1));
+          AssertThrow (!cursor.failed(), ExcInvalidGMSHInput(line));
+
+          line = cursor.read_word();
         }
 
-      // but the next thing should,
-      // in any case, be the list of
-      // nodes:
+      // but the next thing should, in any case, be the list of nodes:
       AssertThrow (line == "$Nodes",
                    ExcInvalidGMSHInput(line));
     }
+  else
+    AssertThrow (false, ExcInvalidGMSHInput(line));
 
-  // now read the nodes list
-  in >> n_vertices;
-  std::vector<Point<spacedim> >     vertices (n_vertices);
-  // set up mapping between numbering
-  // in msh-file (nod) and in the
-  // vertices vector
-  std::map<int,int> vertex_indices;
+  // now read the nodes list, along with the tags by which the elements
+  // refer to them
+  std::vector<Point<spacedim> > vertices;
+  std::vector<unsigned int>     vertex_tags;
+  bool                          parsed_nodes = true;
 
-  for (unsigned int vertex=0; vertex<n_vertices; ++vertex)
+  const auto read_coordinates = [&] (const std::size_t   vertex,
+                                     const unsigned int  n_parameters,
+                                     internal::Gmsh::Cursor       &record)
+  {
+    double x[3];
+    for (unsigned int d=0; d<3; ++d)
+      x[d] = record.read<double>(binary);
+    for (unsigned int d=0; d<spacedim; ++d)
+      vertices[vertex](d) = x[d];
+
+    // skip the parametric coordinates of the node, if any
+    for (unsigned int p=0; p<n_parameters; ++p)
+      record.read<double>(binary);
+  };
+
+  if (gmsh_file_format < 4)
     {
-      int vertex_number;
-      double x[3];
+      // the number of nodes is stored as text even in binary files,
+      // followed by one record per node
+      const long long n_vertices = cursor.read_integer();
+      AssertThrow (!cursor.failed() && (n_vertices >= 0),
+                   ExcInvalidGMSHInput(line));
+      vertices.resize (n_vertices);
+      vertex_tags.resize (n_vertices);
 
-      // read vertex
-      in >> vertex_number
-         >> x[0] >> x[1] >> x[2];
+      const auto read_node = [&] (const std::size_t  vertex,
+                                  internal::Gmsh::Cursor      &record)
+      {
+        vertex_tags[vertex] = record.read<int>(binary);
+        read_coordinates (vertex, 0, record);
+      };
 
-      for (unsigned int d=0; d<spacedim; ++d)
-        vertices[vertex](d) = x[d];
-      // store mapping
-      vertex_indices[vertex_number] = vertex;
+      if (binary)
+        {
+          cursor.skip_end_of_line ();
+          parsed_nodes = internal::Gmsh::parse_binary_records (cursor, n_vertices,
+                                                     sizeof(int) + 3*sizeof(double),
+                                                     read_node);
+        }
+      else
+        parsed_nodes = internal::Gmsh::parse_records (cursor, n_vertices, read_node);
     }
+  else
+    {
+      // in version 4 of the format, the nodes are grouped into blocks by
+      // the geometric entity they belong to. each block first lists the
+      // tags of its nodes, and then their coordinates
+      if (binary)
+        cursor.skip_end_of_line ();
+      const std::uint64_t n_blocks = cursor.read<std::uint64_t>(binary);
+      const std::uint64_t n_vertices = cursor.read<std::uint64_t>(binary);
+      cursor.read<std::uint64_t>(binary);  // smallest node tag
+      cursor.read<std::uint64_t>(binary);  // largest node tag
+      AssertThrow (!cursor.failed(), ExcInvalidGMSHInput(line));
+      vertices.resize (n_vertices);
+      vertex_tags.resize (n_vertices);
+
+      std::size_t n_read_vertices = 0;
+      for (std::uint64_t block=0; (block<n_blocks) && parsed_nodes; ++block)
+        {
+          const int entity_dim = cursor.read<int>(binary);
+          cursor.read<int>(binary);  // entity tag
+          const int parametric = cursor.read<int>(binary);
+          const std::uint64_t n_block_vertices = cursor.read<std::uint64_t>(binary);
+          AssertThrow (!cursor.failed() &&
+                       (n_block_vertices <= n_vertices - n_read_vertices) &&
+                       (entity_dim >= 0) && (entity_dim <= 3),
+                       ExcInvalidGMSHInput(line));
+          const unsigned int n_parameters = (parametric != 0 ? entity_dim : 0);
+
+          const auto read_tag = [&] (const std::size_t  i,
+                                     internal::Gmsh::Cursor      &record)
+          {
+            vertex_tags[n_read_vertices+i]
+              = static_cast<unsigned int>(record.read<std::uint64_t>(binary));
+          };
+          const auto read_node = [&] (const std::size_t  i,
+                                      internal::Gmsh::Cursor      &record)
+          {
+            read_coordinates (n_read_vertices+i, n_parameters, record);
+          };
+
+          if (binary)
+            parsed_nodes
+              = (internal::Gmsh::parse_binary_records (cursor, n_block_vertices,
+                                             sizeof(std::uint64_t), read_tag) &&
+                 internal::Gmsh::parse_binary_records (cursor, n_block_vertices,
+                                             (3+n_parameters)*sizeof(double),
+                                             read_node));
+          else
+            parsed_nodes
+              = (internal::Gmsh::parse_records (cursor, n_block_vertices, read_tag) &&
+                 internal::Gmsh::parse_records (cursor, n_block_vertices, read_node));
+
+          n_read_vertices += n_block_vertices;
+        }
+      AssertThrow (n_read_vertices == n_vertices,
+                   ExcInvalidGMSHInput(line));
+    }
+  AssertThrow (parsed_nodes, ExcInvalidGMSHInput(line));
 
   // Assert we reached the end of the block
-  in >> line;
+  line = cursor.read_word();
   static const std::string end_nodes_marker[] = {"$ENDNOD", "$EndNodes" };
-  AssertThrow (line==end_nodes_marker[gmsh_file_format-1],
+  AssertThrow (line==end_nodes_marker[gmsh_file_format == 1 ? 0 : 1],
                ExcInvalidGMSHInput(line));
 
   // Now read in next bit
-  in >> line;
+  line = cursor.read_word();
   static const std::string begin_elements_marker[] = {"$ELM", "$Elements" };
-  AssertThrow (line==begin_elements_marker[gmsh_file_format-1],
+  AssertThrow (line==begin_elements_marker[gmsh_file_format == 1 ? 0 : 1],
                ExcInvalidGMSHInput(line));
 
-  in >> n_cells;
-
-  // set up array of cells and subcells (faces). In 1d, there is currently no
-  // standard way in deal.II to pass boundary indicators attached to individual
-  // vertices, so do this by hand via the boundary_ids_1d array
-  std::vector<CellData<dim> >                cells;
-  SubCellData                                subcelldata;
-  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
+  // cannot read elements of other types than lines, quadrilaterals,
+  // hexahedra, and points, so throw an exception. treat triangles and
+  // tetrahedra specially since this deserves a more explicit error message
+  const auto check_element_type = [] (const unsigned int cell_type)
+  {
+    AssertThrow (cell_type != 2,
+                 ExcMessage("Found triangles while reading a file "
+                            "in gmsh format. deal.II does not "
+                            "support triangles"));
+    AssertThrow (cell_type != 11,
+                 ExcMessage("Found tetrahedra while reading a file "
+                            "in gmsh format. deal.II does not "
+                            "support tetrahedra"));
+    AssertThrow ((cell_type == 1) ||
+                 ((cell_type == 3) && (dim >= 2)) ||
+                 ((cell_type == 5) && (dim == 3)) ||
+                 (cell_type == 15),
+                 ExcGmshUnsupportedGeometry(cell_type));
+  };
 
-  for (unsigned int cell=0; cell<n_cells; ++cell)
+  std::vector<internal::Gmsh::Element> elements;
+  bool                       parsed_elements = true;
+  if (gmsh_file_format < 4)
     {
-      // note that since in the input
-      // file we found the number of
-      // cells at the top, there
-      // should still be input here,
-      // so check this:
-      AssertThrow (in, ExcIO());
-
-      unsigned int cell_type;
-      unsigned int material_id;
-      unsigned int nod_num;
-
-      /*
-        For file format version 1, the format of each cell is as follows:
-          elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
+      const long long n_elements = cursor.read_integer();
+      AssertThrow (!cursor.failed() && (n_elements >= 0),
+                   ExcInvalidGMSHInput(line));
+      elements.resize (n_elements, internal::Gmsh::Element());
 
-        However, for version 2, the format reads like this:
-          elm-number elm-type number-of-tags < tag > ... node-number-list
+      if (binary)
+        {
+          // binary files of version 2 store the elements in blocks of
+          // elements of the same type and with the same number of tags:
+          //   elm-type number-of-elements number-of-tags
+          // followed by the records
+          //   elm-number < tag > ... node-number-list
+          cursor.skip_end_of_line ();
+          std::size_t n_read_elements = 0;
+          while ((n_read_elements < elements.size()) && parsed_elements)
+            {
+              const int cell_type = cursor.read_binary<int>();
+              const int n_block_elements = cursor.read_binary<int>();
+              const int n_tags = cursor.read_binary<int>();
+              AssertThrow (!cursor.failed() &&
+                           (n_block_elements >= 0) &&
+                           (static_cast<std::size_t>(n_block_elements)
+                            <= elements.size() - n_read_elements) &&
+                           (n_tags >= 0),
+                           ExcInvalidGMSHInput(line));
+              check_element_type (cell_type);
+              const unsigned int n_nodes = internal::Gmsh::n_nodes_of_element_type (cell_type);
+
+              parsed_elements = internal::Gmsh::parse_binary_records
+                                (cursor, n_block_elements,
+                                 (1+n_tags+n_nodes)*sizeof(int),
+                                 [&] (const std::size_t  i,
+                                      internal::Gmsh::Cursor      &record)
+              {
+                internal::Gmsh::Element &element = elements[n_read_elements+i];
+                element.type = cell_type;
+                element.n_nodes = n_nodes;
+                element.number = record.read_binary<int>();
+                for (int t=0; t<n_tags; ++t)
+                  {
+                    const int tag = record.read_binary<int>();
+                    if (t == 0)
+                      element.material_id = tag;
+                  }
+                for (unsigned int v=0; v<n_nodes; ++v)
+                  element.nodes[v] = record.read_binary<int>();
+              });
 
-        In the following, we will ignore the element number (we simply enumerate
-        them in the order in which we read them, and we will take reg-phys
-        (version 1) or the first tag (version 2, if any tag is given at all) as
-        material id.
-      */
+              n_read_elements += n_block_elements;
+            }
+        }
+      else
+        {
+          /*
+            For file format version 1, the format of each cell is as follows:
+              elm-number elm-type reg-phys reg-elem number-of-nodes node-number-list
+
+            However, for version 2, the format reads like this:
+              elm-number elm-type number-of-tags < tag > ... node-number-list
+
+            In the following, we will ignore the element number (we simply
+            enumerate them in the order in which we read them, and we will
+            take reg-phys (version 1) or the first tag (version 2, if any tag
+            is given at all) as material id.
+          */
+          parsed_elements = internal::Gmsh::parse_records
+                            (cursor, elements.size(),
+                             [&] (const std::size_t  i,
+                                  internal::Gmsh::Cursor      &record)
+          {
+            internal::Gmsh::Element &element = elements[i];
+            element.number = record.read_integer();
+            element.type = record.read_integer();
+            element.n_nodes = internal::Gmsh::n_nodes_of_element_type (element.type);
+            if (gmsh_file_format == 1)
+              {
+                element.material_id = record.read_integer();  // REG-PHYS
+                record.read_integer();                        // reg_elm
+                element.n_nodes = record.read_integer();
+              }
+            else
+              {
+                const long long n_tags = record.read_integer();
+                for (long long t=0; t<n_tags && !record.failed(); ++t)
+                  {
+                    const long long tag = record.read_integer();
+                    if (t == 0)
+                      element.material_id = tag;
+                  }
 
-      unsigned int elm_number;
-      in >> elm_number     // ELM-NUMBER
-         >> cell_type;     // ELM-TYPE
+                // we do not know how many nodes elements of this type have,
+                // so skip the rest of the record. this is an error that is
+                // reported below
+                if (element.n_nodes == 0)
+                  {
+                    record.set_position (record.get_end());
+                    return;
+                  }
+              }
 
-      switch (gmsh_file_format)
-        {
-        case 1:
-        {
-          in >> material_id  // REG-PHYS
-             >> dummy        // reg_elm
-             >> nod_num;
-          break;
+            for (unsigned int v=0; v<element.n_nodes && !record.failed(); ++v)
+              {
+                const unsigned int node = record.read_integer();
+                if (v < 8)
+                  element.nodes[v] = node;
+                // points in files of version 1 may list more than one node,
+                // of which we use the last one
+                if (element.type == 15)
+                  element.nodes[0] = node;
+              }
+            if (element.type == 15)
+              element.n_nodes = 1;
+          });
         }
-
-        case 2:
+    }
+  else
+    {
+      // in version 4 of the format, the elements are grouped into blocks of
+      // elements of the same type that belong to the same geometric
+      // entity, whose physical tag we use as material or boundary id
+      if (binary)
+        cursor.skip_end_of_line ();
+      const std::uint64_t n_blocks = cursor.read<std::uint64_t>(binary);
+      const std::uint64_t n_elements = cursor.read<std::uint64_t>(binary);
+      cursor.read<std::uint64_t>(binary);  // smallest element tag
+      cursor.read<std::uint64_t>(binary);  // largest element tag
+      AssertThrow (!cursor.failed(), ExcInvalidGMSHInput(line));
+      elements.resize (n_elements, internal::Gmsh::Element());
+
+      std::size_t n_read_elements = 0;
+      for (std::uint64_t block=0; (block<n_blocks) && parsed_elements; ++block)
         {
-          // read the tags; ignore all but the first one which we will
-          // interpret as the material_id (for cells) or boundary_id
-          // (for faces)
-          unsigned int n_tags;
-          in >> n_tags;
-          if (n_tags > 0)
-            in >> material_id;
+          const int entity_dim = cursor.read<int>(binary);
+          const int entity_tag = cursor.read<int>(binary);
+          const int cell_type = cursor.read<int>(binary);
+          const std::uint64_t n_block_elements = cursor.read<std::uint64_t>(binary);
+          AssertThrow (!cursor.failed() &&
+                       (n_block_elements <= elements.size() - n_read_elements) &&
+                       (entity_dim >= 0) && (entity_dim <= 3),
+                       ExcInvalidGMSHInput(line));
+          check_element_type (cell_type);
+          const unsigned int n_nodes = internal::Gmsh::n_nodes_of_element_type (cell_type);
+
+          const std::map<int,int>::const_iterator physical_tag
+            = entity_physical_tags[entity_dim].find (entity_tag);
+          const unsigned int material_id
+            = (physical_tag != entity_physical_tags[entity_dim].end() ?
+               physical_tag->second : 0);
+
+          const auto read_element = [&] (const std::size_t  i,
+                                         internal::Gmsh::Cursor      &record)
+          {
+            internal::Gmsh::Element &element = elements[n_read_elements+i];
+            element.type = cell_type;
+            element.n_nodes = n_nodes;
+            element.material_id = material_id;
+            element.number = record.read<std::uint64_t>(binary);
+            for (unsigned int v=0; v<n_nodes; ++v)
+              element.nodes[v] = record.read<std::uint64_t>(binary);
+          };
+
+          if (binary)
+            parsed_elements = internal::Gmsh::parse_binary_records (cursor, n_block_elements,
+                                                          (1+n_nodes)*sizeof(std::uint64_t),
+                                                          read_element);
           else
-            material_id = 0;
+            parsed_elements = internal::Gmsh::parse_records (cursor, n_block_elements,
+                                                   read_element);
 
-          for (unsigned int i=1; i<n_tags; ++i)
-            in >> dummy;
+          n_read_elements += n_block_elements;
+        }
+      AssertThrow (n_read_elements == elements.size(),
+                   ExcInvalidGMSHInput(line));
+    }
 
-          nod_num = GeometryInfo<dim>::vertices_per_cell;
+  // a text file with elements of a type we can not read can not have been
+  // parsed completely, so first look for such elements to give a more
+  // helpful error message. no element type has the number zero, so we
+  // stop at the first element that was not parsed
+  for (const internal::Gmsh::Element &element : elements)
+    {
+      if (element.type == 0)
+        break;
+      check_element_type (element.type);
+    }
+  AssertThrow (parsed_elements, ExcInvalidGMSHInput(line));
 
-          break;
-        }
+  // Assert we reached the end of the block
+  line = cursor.read_word();
+  static const std::string end_elements_marker[] = {"$ENDELM", "$EndElements" };
+  AssertThrow (line==end_elements_marker[gmsh_file_format == 1 ? 0 : 1],
+               ExcInvalidGMSHInput(line));
 
-        default:
-          AssertThrow (false, ExcNotImplemented());
-        }
+  // set up mapping between numbering in msh-file (nod) and in the vertices
+  // vector. node tags are usually numbered consecutively, in which case a
+  // vector is the fastest way to look them up
+  const unsigned int max_vertex_tag
+    = (vertex_tags.size() > 0 ?
+       *std::max_element (vertex_tags.begin(), vertex_tags.end()) :
+       0);
+  const bool dense_vertex_tags
+    = (max_vertex_tag < 4*static_cast<std::size_t>(vertex_tags.size()) + 1024);
+  std::vector<unsigned int>              vertex_index_of_tag;
+  std::map<unsigned int, unsigned int>   vertex_indices;
+  if (dense_vertex_tags)
+    {
+      vertex_index_of_tag.resize (static_cast<std::size_t>(max_vertex_tag)+1,
+                                  numbers::invalid_unsigned_int);
+      for (unsigned int vertex=0; vertex<vertex_tags.size(); ++vertex)
+        vertex_index_of_tag[vertex_tags[vertex]] = vertex;
+    }
+  else
+    for (unsigned int vertex=0; vertex<vertex_tags.size(); ++vertex)
+      vertex_indices[vertex_tags[vertex]] = vertex;
 
+  const auto vertex_index = [&] (const unsigned int tag) -> unsigned int
+  {
+    if (dense_vertex_tags)
+      return (tag < vertex_index_of_tag.size() ?
+              vertex_index_of_tag[tag] :
+              numbers::invalid_unsigned_int);
+    const std::map<unsigned int, unsigned int>::const_iterator
+    p = vertex_indices.find (tag);
+    return (p != vertex_indices.end() ? p->second : numbers::invalid_unsigned_int);
+  };
 
-      /*       `ELM-TYPE'
-               defines the geometrical type of the N-th element:
-               `1'
-               Line (2 nodes, 1 edge).
+  /*       `ELM-TYPE'
+           defines the geometrical type of the N-th element:
+           `1'
+           Line (2 nodes, 1 edge).
 
-               `3'
-               Quadrangle (4 nodes, 4 edges).
+           `3'
+           Quadrangle (4 nodes, 4 edges).
 
-               `5'
-               Hexahedron (8 nodes, 12 edges, 6 faces).
+           `5'
+           Hexahedron (8 nodes, 12 edges, 6 faces).
 
-               `15'
-               Point (1 node).
-      */
+           `15'
+           Point (1 node).
+  */
+  const auto is_cell = [] (const unsigned int cell_type)
+  {
+    return (((cell_type == 1) && (dim == 1)) ||
+            ((cell_type == 3) && (dim == 2)) ||
+            ((cell_type == 5) && (dim == 3)));
+  };
 
-      if (((cell_type == 1) && (dim == 1)) ||
-          ((cell_type == 3) && (dim == 2)) ||
-          ((cell_type == 5) && (dim == 3)))
-        // found a cell
-        {
-          AssertThrow (nod_num == GeometryInfo<dim>::vertices_per_cell,
-                       ExcMessage ("Number of nodes does not coincide with the "
-                                   "number required for this object"));
+  // set up array of cells and subcells (faces). In 1d, there is currently no
+  // standard way in deal.II to pass boundary indicators attached to individual
+  // vertices, so do this by hand via the boundary_ids_1d array. we first
+  // determine where in these arrays each element goes, and then fill them in
+  // parallel
+  std::vector<CellData<dim> >                cells;
+  SubCellData                                subcelldata;
+  std::map<unsigned int, types::boundary_id> boundary_ids_1d;
+  std::vector<unsigned int>                  object_index (elements.size());
+  unsigned int n_cells = 0, n_boundary_lines = 0, n_boundary_quads = 0;
 
-          // allocate and read indices
-          cells.emplace_back ();
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            in >> cells.back().vertices[i];
+  for (unsigned int e=0; e<elements.size(); ++e)
+    {
+      const internal::Gmsh::Element &element = elements[e];
+      const unsigned int material_id = element.material_id;
 
+      AssertThrow (element.n_nodes == internal::Gmsh::n_nodes_of_element_type (element.type),
+                   ExcMessage ("Number of nodes does not coincide with the "
+                               "number required for this object"));
+
+      if (is_cell (element.type))
+        {
           // to make sure that the cast wont fail
           Assert(material_id<= std::numeric_limits<types::material_id>::max(),
                  ExcIndexRange(material_id,0,std::numeric_limits<types::material_id>::max()));
@@ -1431,65 +2254,11 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
           Assert(material_id < numbers::invalid_material_id,
                  ExcIndexRange(material_id,0,numbers::invalid_material_id));
 
-          cells.back().material_id = static_cast<types::material_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<GeometryInfo<dim>::vertices_per_cell; ++i)
-            {
-              AssertThrow (vertex_indices.find (cells.back().vertices[i]) !=
-                           vertex_indices.end(),
-                           ExcInvalidVertexIndexGmsh(cell, elm_number,
-                                                     cells.back().vertices[i]));
-
-              // vertex with this index exists
-              cells.back().vertices[i] = vertex_indices[cells.back().vertices[i]];
-            }
-        }
-      else if ((cell_type == 1) && ((dim == 2) || (dim == 3)))
-        // boundary info
-        {
-          subcelldata.boundary_lines.emplace_back ();
-          in >> subcelldata.boundary_lines.back().vertices[0]
-             >> subcelldata.boundary_lines.back().vertices[1];
-
-          // to make sure that the cast wont fail
-          Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
-                 ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
-          // we use only boundary_ids in the range from 0 to numbers::internal_face_boundary_id-1
-          Assert(material_id < numbers::internal_face_boundary_id,
-                 ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
-
-          subcelldata.boundary_lines.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
-
-          // transform from ucd to
-          // consecutive numbering
-          for (unsigned int i=0; i<2; ++i)
-            if (vertex_indices.find (subcelldata.boundary_lines.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_lines.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_lines.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                AssertThrow (false,
-                             ExcInvalidVertexIndex(cell,
-                                                   subcelldata.boundary_lines.back().vertices[i]));
-                subcelldata.boundary_lines.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              };
+          object_index[e] = n_cells++;
         }
-      else if ((cell_type == 3) && (dim == 3))
+      else if ((element.type == 1) || ((element.type == 3) && (dim == 3)))
         // boundary info
         {
-          subcelldata.boundary_quads.emplace_back ();
-          in >> subcelldata.boundary_quads.back().vertices[0]
-             >> subcelldata.boundary_quads.back().vertices[1]
-             >> subcelldata.boundary_quads.back().vertices[2]
-             >> subcelldata.boundary_quads.back().vertices[3];
-
           // to make sure that the cast wont fail
           Assert(material_id<= std::numeric_limits<types::boundary_id>::max(),
                  ExcIndexRange(material_id,0,std::numeric_limits<types::boundary_id>::max()));
@@ -1497,84 +2266,96 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
           Assert(material_id < numbers::internal_face_boundary_id,
                  ExcIndexRange(material_id,0,numbers::internal_face_boundary_id));
 
-          subcelldata.boundary_quads.back().boundary_id
-            = static_cast<types::boundary_id>(material_id);
-
-          // transform from gmsh to
-          // consecutive numbering
-          for (unsigned int i=0; i<4; ++i)
-            if (vertex_indices.find (subcelldata.boundary_quads.back().vertices[i]) !=
-                vertex_indices.end())
-              // vertex with this index exists
-              subcelldata.boundary_quads.back().vertices[i]
-                = vertex_indices[subcelldata.boundary_quads.back().vertices[i]];
-            else
-              {
-                // no such vertex index
-                Assert (false,
-                        ExcInvalidVertexIndex(cell,
-                                              subcelldata.boundary_quads.back().vertices[i]));
-                subcelldata.boundary_quads.back().vertices[i] =
-                  numbers::invalid_unsigned_int;
-              }
-
+          object_index[e] = (element.type == 1 ?
+                             n_boundary_lines++ :
+                             n_boundary_quads++);
         }
-      else if (cell_type == 15)
+      else if (element.type == 15)
         {
-          // read the indices of nodes given
-          unsigned int node_index;
-          switch (gmsh_file_format)
-            {
-            case 1:
-            {
-              for (unsigned int i=0; i<nod_num; ++i)
-                in >> node_index;
-              break;
-            }
-            case 2:
-            {
-              in >> node_index;
-              break;
-            }
-            }
-
           // we only care about boundary indicators assigned to individual
           // vertices in 1d (because otherwise the vertices are not faces)
           if (dim == 1)
-            boundary_ids_1d[vertex_indices[node_index]] = material_id;
+            {
+              const unsigned int vertex = vertex_index (element.nodes[0]);
+              AssertThrow (vertex != numbers::invalid_unsigned_int,
+                           ExcInvalidVertexIndex(e, element.nodes[0]));
+              boundary_ids_1d[vertex] = material_id;
+            }
         }
       else
-        // cannot read this, so throw
-        // an exception. treat
-        // triangles and tetrahedra
-        // specially since this
-        // deserves a more explicit
-        // error message
-        {
-          AssertThrow (cell_type != 2,
-                       ExcMessage("Found triangles while reading a file "
-                                  "in gmsh format. deal.II does not "
-                                  "support triangles"));
-          AssertThrow (cell_type != 11,
-                       ExcMessage("Found tetrahedra while reading a file "
-                                  "in gmsh format. deal.II does not "
-                                  "support tetrahedra"));
-
-          AssertThrow (false, ExcGmshUnsupportedGeometry(cell_type));
-        }
+        check_element_type (element.type);
     }
 
-  // Assert we reached the end of the block
-  in >> line;
-  static const std::string end_elements_marker[] = {"$ENDELM", "$EndElements" };
-  AssertThrow (line==end_elements_marker[gmsh_file_format-1],
-               ExcInvalidGMSHInput(line));
+  cells.resize (n_cells);
+  subcelldata.boundary_lines.resize (n_boundary_lines);
+  subcelldata.boundary_quads.resize (n_boundary_quads);
+
+  // transform from gmsh to consecutive numbering
+  std::atomic<bool> all_vertices_found (true);
+  parallel::apply_to_subranges
+  (0U, static_cast<unsigned int>(elements.size()),
+   [&] (const unsigned int begin,
+        const unsigned int end)
+  {
+    for (unsigned int e=begin; e<end; ++e)
+      {
+        const internal::Gmsh::Element &element = elements[e];
+        unsigned int *object_vertices = nullptr;
+        if (is_cell (element.type))
+          {
+            cells[object_index[e]].material_id
+              = static_cast<types::material_id>(element.material_id);
+            object_vertices = cells[object_index[e]].vertices;
+          }
+        else if (element.type == 1)
+          {
+            subcelldata.boundary_lines[object_index[e]].boundary_id
+              = static_cast<types::boundary_id>(element.material_id);
+            object_vertices = subcelldata.boundary_lines[object_index[e]].vertices;
+          }
+        else if ((element.type == 3) && (dim == 3))
+          {
+            subcelldata.boundary_quads[object_index[e]].boundary_id
+              = static_cast<types::boundary_id>(element.material_id);
+            object_vertices = subcelldata.boundary_quads[object_index[e]].vertices;
+          }
+        else
+          continue;
+
+        for (unsigned int v=0; v<element.n_nodes; ++v)
+          {
+            object_vertices[v] = vertex_index (element.nodes[v]);
+            if (object_vertices[v] == numbers::invalid_unsigned_int)
+              all_vertices_found = false;
+          }
+      }
+  },
+  1024);
+
+  // if some element referenced a vertex that does not exist, find the first
+  // one to produce a useful error message
+  if (!all_vertices_found)
+    for (unsigned int e=0; e<elements.size(); ++e)
+      if (is_cell (elements[e].type) ||
+          (elements[e].type == 1) ||
+          ((elements[e].type == 3) && (dim == 3)))
+        for (unsigned int v=0; v<elements[e].n_nodes; ++v)
+          if (vertex_index (elements[e].nodes[v]) == numbers::invalid_unsigned_int)
+            {
+              AssertThrow (!is_cell (elements[e].type),
+                           ExcInvalidVertexIndexGmsh(e, elements[e].number,
+                                                     elements[e].nodes[v]));
+              AssertThrow (false,
+                           ExcInvalidVertexIndex(e, elements[e].nodes[v]));
+            }
+
+  // the element list is no longer needed; release its memory before
+  // building the triangulation
+  std::vector<internal::Gmsh::Element>().swap (elements);
 
   // check that no forbidden arrays are used
   Assert (subcelldata.check_consistency(dim), ExcInternalError());
 
-  AssertThrow (in, ExcIO());
-
   // check that we actually read some
   // cells.
   AssertThrow(cells.size() > 0, ExcGmshNoCellInformation());
@@ -1585,7 +2366,8 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
   // ... and cells
   if (dim==spacedim)
     GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 
   // in 1d, we also have to attach boundary ids to vertices, which does not
@@ -1594,7 +2376,6 @@ void GridIn<dim, spacedim>::read_msh (std::istream &in)
     assign_1d_boundary_ids (boundary_ids_1d, *tria);
 }
 
-
 template <>
 void GridIn<1>::read_netcdf (const std::string &)
 {
@@ -1885,7 +2666,8 @@ void GridIn<2>::read_netcdf (const std::string &filename)
 
   SubCellData subcelldata;
   GridTools::delete_unused_vertices(vertices, cells, subcelldata);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 #endif
 }
@@ -2095,7 +2877,8 @@ void GridIn<3>::read_netcdf (const std::string &filename)
 
   GridTools::delete_unused_vertices(vertices, cells, subcelldata);
   GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 #endif
 }
@@ -2529,7 +3312,8 @@ void GridIn<2>::read_tecplot (std::istream &in)
 
   // do some cleanup on cells
   GridReordering<dim,spacedim>::invert_all_cells_of_negative_grid (vertices, cells);
-  GridReordering<dim,spacedim>::reorder_cells (cells);
+  if (reorder_cells)
+    GridReordering<dim,spacedim>::reorder_cells (cells);
   tria->create_triangulation_compatibility (vertices, cells, subcelldata);
 }
 
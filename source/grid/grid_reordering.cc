@@ -18,6 +18,7 @@
 #include <deal.II/grid/grid_tools.h>
 #include <deal.II/base/utilities.h>
 #include <deal.II/base/timer.h>
+#include <deal.II/base/parallel.h>
 
 #include <algorithm>
 #include <set>
@@ -55,53 +56,77 @@ namespace
       return ((v0 < e.v0) || ((v0 == e.v0) && (v1 < e.v1)));
     }
 
+    /**
+     * Comparison operator for edges.
+     */
+    bool operator == (const CheapEdge &e) const
+    {
+      return ((v0 == e.v0) && (v1 == e.v1));
+    }
+
+    /**
+     * Return the edge with the two vertices exchanged.
+     */
+    CheapEdge reverse () const
+    {
+      return CheapEdge (v1, v0);
+    }
+
   private:
     /**
-     * The global indices of the vertices that define the edge.
+     * The global indices of the vertices that define the edge. These are
+     * not const so that edges can be sorted.
      */
-    const unsigned int v0, v1;
+    unsigned int v0, v1;
   };
 
 
   /**
    * A function that determines whether the edges in a mesh are
-   * already consistently oriented. It does so by adding all edges
-   * of all cells into a set (which automatically eliminates
-   * duplicates) but before that checks whether the reverse edge is
-   * already in the set -- which would imply that a neighboring cell
-   * is inconsistently oriented.
+   * already consistently oriented. It does so by collecting all
+   * edges of all cells, sorting them (in parallel if possible) and
+   * eliminating duplicates, and then checking for each edge whether
+   * the reverse edge is also in the list -- which would imply that a
+   * neighboring cell is inconsistently oriented.
    */
   template <int dim>
   bool
   is_consistent  (const std::vector<CellData<dim> > &cells)
   {
-    std::set<CheapEdge> edges;
-
-    for (typename std::vector<CellData<dim> >::const_iterator c = cells.begin();
-         c != cells.end(); ++c)
-      {
-        // construct the edges in reverse order. for each of them,
-        // ensure that the reverse edge is not yet in the list of
-        // edges (return false if the reverse edge already *is* in
-        // the list) and then add the actual edge to it; std::set
-        // eliminates duplicates automatically
-        for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
-          {
-            const CheapEdge reverse_edge (c->vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 1)],
-                                          c->vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 0)]);
-            if (edges.find (reverse_edge) != edges.end())
-              return false;
-
-
-            // ok, not. insert edge in correct order
-            const CheapEdge correct_edge (c->vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 0)],
-                                          c->vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 1)]);
-            edges.insert (correct_edge);
-          }
-      }
-
-    // no conflicts found, so return true
-    return true;
+    const unsigned int lines_per_cell = GeometryInfo<dim>::lines_per_cell;
+
+    std::vector<CheapEdge> edges (cells.size() * lines_per_cell,
+                                  CheapEdge (0, 0));
+    parallel::apply_to_subranges
+    (std::size_t(0), cells.size(),
+     [&] (const std::size_t begin,
+          const std::size_t end)
+    {
+      for (std::size_t c=begin; c<end; ++c)
+        for (unsigned int l=0; l<lines_per_cell; ++l)
+          edges[c*lines_per_cell+l]
+            = CheapEdge (cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 0)],
+                         cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 1)]);
+    },
+    1000);
+    parallel::sort (edges.begin(), edges.end());
+    edges.erase (std::unique (edges.begin(), edges.end()), edges.end());
+
+    // now look up the reverse of each edge. the lookups are independent
+    // of each other, so do them in parallel
+    return parallel::accumulate_from_subranges<unsigned int>
+           ([&] (const std::size_t begin,
+                 const std::size_t end) -> unsigned int
+    {
+      unsigned int n_reversed_edges = 0;
+      for (std::size_t i=begin; i<end; ++i)
+        if (!(edges[i].reverse() == edges[i]) &&
+            std::binary_search (edges.begin(), edges.end(), edges[i].reverse()))
+          ++n_reversed_edges;
+      return n_reversed_edges;
+    },
+    std::size_t(0), edges.size(),
+    10000) == 0;
   }
 
 
@@ -15,6 +15,7 @@
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/thread_management.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/vector_memory.h>
 #include <deal.II/lac/filtered_matrix.h>
@@ -51,6 +52,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <numeric>
 #include <list>
 #include <set>
@@ -2728,6 +2730,190 @@ next_cell:
   }
 
 
+  namespace
+  {
+    /**
+     * Return the position along a Hilbert curve of the point with the
+     * given integer coordinates, each of which uses the lowest @p
+     * bits_per_dim bits. This is the algorithm of J. Skilling, "Programming
+     * the Hilbert curve", AIP Conference Proceedings 707 (2004): the
+     * coordinates are first transformed in place into the "transposed"
+     * Hilbert index, whose bits are then interleaved.
+     */
+    template <int spacedim>
+    std::uint64_t
+    hilbert_index (std::array<std::uint64_t,spacedim> x,
+                   const unsigned int                 bits_per_dim)
+    {
+      if (spacedim == 1)
+        return x[0];
+
+      const std::uint64_t m = std::uint64_t(1) << (bits_per_dim-1);
+
+      // inverse undo
+      for (std::uint64_t q=m; q>1; q>>=1)
+        {
+          const std::uint64_t p = q-1;
+          for (unsigned int i=0; i<spacedim; ++i)
+            if (x[i] & q)
+              x[0] ^= p;
+            else
+              {
+                const std::uint64_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+              }
+        }
+
+      // Gray encode
+      for (unsigned int i=1; i<spacedim; ++i)
+        x[i] ^= x[i-1];
+      std::uint64_t t = 0;
+      for (std::uint64_t q=m; q>1; q>>=1)
+        if (x[spacedim-1] & q)
+          t ^= q-1;
+      for (unsigned int i=0; i<spacedim; ++i)
+        x[i] ^= t;
+
+      // interleave the bits, starting with the most significant bit of the
+      // first coordinate
+      std::uint64_t index = 0;
+      for (int b=bits_per_dim-1; b>=0; --b)
+        for (unsigned int i=0; i<spacedim; ++i)
+          index = (index << 1) | ((x[i] >> b) & 1);
+      return index;
+    }
+  }
+
+
+
+  template <int spacedim>
+  std::vector<unsigned int>
+  compute_hilbert_order (const std::vector<Point<spacedim> > &points)
+  {
+    if (points.size() == 0)
+      return std::vector<unsigned int>();
+
+    // the position along the curve has to fit into 64 bits
+    const unsigned int bits_per_dim = (spacedim == 3 ? 21 : 32);
+    const double max_int_coordinate = (std::uint64_t(1) << bits_per_dim) - 1;
+
+    Point<spacedim> lower = points[0], upper = points[0];
+    for (unsigned int i=1; i<points.size(); ++i)
+      for (unsigned int d=0; d<spacedim; ++d)
+        {
+          lower[d] = std::min (lower[d], points[i][d]);
+          upper[d] = std::max (upper[d], points[i][d]);
+        }
+
+    // compute the position of each point along the curve in parallel, then
+    // sort. ties are broken by the index of the point
+    std::vector<std::pair<std::uint64_t,unsigned int> > positions (points.size());
+    parallel::apply_to_subranges
+    (0U, static_cast<unsigned int>(points.size()),
+     [&] (const unsigned int begin,
+          const unsigned int end)
+    {
+      for (unsigned int i=begin; i<end; ++i)
+        {
+          std::array<std::uint64_t,spacedim> coordinates;
+          for (unsigned int d=0; d<spacedim; ++d)
+            coordinates[d] = (upper[d] > lower[d]
+                              ?
+                              static_cast<std::uint64_t>((points[i][d]-lower[d]) /
+                                                         (upper[d]-lower[d]) *
+                                                         max_int_coordinate)
+                              :
+                              0);
+          positions[i] = std::make_pair (hilbert_index<spacedim>(coordinates,
+                                                                 bits_per_dim),
+                                         i);
+        }
+    },
+    256);
+    std::sort (positions.begin(), positions.end());
+
+    std::vector<unsigned int> order (points.size());
+    for (unsigned int i=0; i<points.size(); ++i)
+      order[i] = positions[i].second;
+    return order;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  partition_triangulation_hilbert (const unsigned int          n_partitions,
+                                   Triangulation<dim,spacedim> &triangulation,
+                                   const std::vector<double>   &cell_weights)
+  {
+    Assert ((dynamic_cast<parallel::distributed::Triangulation<dim,spacedim>*>
+             (&triangulation)
+             == nullptr),
+            ExcMessage ("Objects of type parallel::distributed::Triangulation "
+                        "are already partitioned implicitly and can not be "
+                        "partitioned again explicitly."));
+    Assert (n_partitions > 0, ExcInvalidNumberOfPartitions(n_partitions));
+    Assert (cell_weights.size() == 0 ||
+            cell_weights.size() == triangulation.n_active_cells(),
+            ExcDimensionMismatch (cell_weights.size(),
+                                  triangulation.n_active_cells()));
+
+    // check for an easy return
+    if (n_partitions == 1)
+      {
+        for (typename dealii::internal::ActiveCellIterator<dim, spacedim, Triangulation<dim, spacedim> >::type
+             cell = triangulation.begin_active();
+             cell != triangulation.end(); ++cell)
+          cell->set_subdomain_id (0);
+        return;
+      }
+
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator>
+    cells (triangulation.n_active_cells());
+    std::vector<Point<spacedim> > centers (triangulation.n_active_cells());
+    for (typename Triangulation<dim,spacedim>::active_cell_iterator
+         cell = triangulation.begin_active();
+         cell != triangulation.end(); ++cell)
+      {
+        cells[cell->active_cell_index()] = cell;
+        centers[cell->active_cell_index()] = cell->center();
+      }
+
+    const std::vector<unsigned int> order = compute_hilbert_order (centers);
+
+    const double total_weight
+      = (cell_weights.size() == 0
+         ?
+         static_cast<double>(cells.size())
+         :
+         std::accumulate (cell_weights.begin(), cell_weights.end(), 0.));
+    Assert (total_weight > 0,
+            ExcMessage ("The sum of the cell weights must be positive."));
+
+    // cut the curve into pieces of equal weight. each cell goes to the
+    // piece that contains the middle of its own part of the curve
+    double weight_before = 0;
+    for (unsigned int i=0; i<order.size(); ++i)
+      {
+        const double weight = (cell_weights.size() == 0
+                               ?
+                               1.
+                               :
+                               cell_weights[order[i]]);
+        Assert (weight >= 0,
+                ExcMessage ("The cell weights must not be negative."));
+
+        const unsigned int subdomain
+          = std::min (static_cast<unsigned int>((weight_before + 0.5*weight) /
+                                                total_weight * n_partitions),
+                      n_partitions-1);
+        cells[order[i]]->set_subdomain_id (subdomain);
+        weight_before += weight;
+      }
+  }
+
+
   template <int dim, int spacedim>
   void
   partition_multigrid_levels (Triangulation<dim,spacedim> &triangulation)
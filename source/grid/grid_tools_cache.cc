@@ -0,0 +1,553 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/base/geometry_info.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <set>
+
+DEAL_II_NAMESPACE_OPEN
+
+namespace GridTools
+{
+  namespace
+  {
+    /**
+     * Sort the indices in the range [begin,end) into sort-tile-recursive
+     * order: sort them by the coordinate @p direction of their centers,
+     * split them into slabs such that the number of slabs in each of the
+     * remaining directions is roughly the same, and sort each slab in the
+     * next direction. Consecutive groups of @p node_size indices then form
+     * compact tiles.
+     */
+    template <int spacedim>
+    void
+    sort_tile_recursive (const std::vector<unsigned int>::iterator &begin,
+                         const std::vector<unsigned int>::iterator &end,
+                         const unsigned int                         direction,
+                         const std::vector<Point<spacedim> >       &centers,
+                         const unsigned int                         node_size)
+    {
+      std::sort (begin, end,
+                 [&] (const unsigned int a, const unsigned int b)
+      {
+        return centers[a][direction] < centers[b][direction];
+      });
+
+      if (direction+1 == spacedim)
+        return;
+
+      const std::size_t n = end - begin;
+      const std::size_t n_nodes = (n + node_size - 1) / node_size;
+      const std::size_t n_slabs
+        = static_cast<std::size_t>(std::ceil(std::pow (static_cast<double>(n_nodes),
+                                                       1./(spacedim-direction))));
+      const std::size_t slab_size
+        = node_size * ((n_nodes + n_slabs - 1) / std::max<std::size_t>(n_slabs, 1));
+      for (std::size_t s=0; s<n; s+=slab_size)
+        sort_tile_recursive (begin + s, begin + std::min (s+slab_size, n),
+                             direction+1, centers, node_size);
+    }
+
+
+
+    /**
+     * Arrange the vertex indices in the range [begin,end) as a balanced
+     * KD-tree whose root, the middle element of the range, splits the
+     * vertices in direction @p direction.
+     */
+    template <int spacedim>
+    void
+    build_kdtree (const std::vector<unsigned int>::iterator &begin,
+                  const std::vector<unsigned int>::iterator &end,
+                  const unsigned int                         direction,
+                  const std::vector<Point<spacedim> >       &vertices)
+    {
+      if (end - begin <= 1)
+        return;
+
+      const std::vector<unsigned int>::iterator middle = begin + (end-begin)/2;
+      std::nth_element (begin, middle, end,
+                        [&] (const unsigned int a, const unsigned int b)
+      {
+        return vertices[a][direction] < vertices[b][direction];
+      });
+
+      build_kdtree (begin, middle, (direction+1)%spacedim, vertices);
+      build_kdtree (middle+1, end, (direction+1)%spacedim, vertices);
+    }
+
+
+
+    /**
+     * Search the KD-tree given by the range [begin,end) for the vertex
+     * closest to @p p. Among vertices with the same distance, the one with
+     * the smallest index is chosen, like in GridTools::find_closest_vertex().
+     */
+    template <int spacedim>
+    void
+    search_kdtree (const Point<spacedim>               &p,
+                   const unsigned int                  *begin,
+                   const unsigned int                  *end,
+                   const unsigned int                   direction,
+                   const std::vector<Point<spacedim> > &vertices,
+                   unsigned int                        &closest_vertex,
+                   double                              &closest_distance_square)
+    {
+      if (begin == end)
+        return;
+
+      const unsigned int *middle = begin + (end-begin)/2;
+      const double distance_square = p.distance_square (vertices[*middle]);
+      if (distance_square < closest_distance_square ||
+          (distance_square == closest_distance_square && *middle < closest_vertex))
+        {
+          closest_vertex = *middle;
+          closest_distance_square = distance_square;
+        }
+
+      // search the half that contains the point first, and the other half
+      // only if it can contain a closer vertex
+      const double difference = p[direction] - vertices[*middle][direction];
+      const unsigned int next_direction = (direction+1)%spacedim;
+      if (difference < 0)
+        {
+          search_kdtree (p, begin, middle, next_direction, vertices,
+                         closest_vertex, closest_distance_square);
+          if (difference*difference <= closest_distance_square)
+            search_kdtree (p, middle+1, end, next_direction, vertices,
+                           closest_vertex, closest_distance_square);
+        }
+      else
+        {
+          search_kdtree (p, middle+1, end, next_direction, vertices,
+                         closest_vertex, closest_distance_square);
+          if (difference*difference <= closest_distance_square)
+            search_kdtree (p, begin, middle, next_direction, vertices,
+                           closest_vertex, closest_distance_square);
+        }
+    }
+  }
+
+
+
+  template <int dim, int spacedim>
+  const unsigned int Cache<dim,spacedim>::rtree_node_size;
+
+
+
+  template <int dim, int spacedim>
+  Cache<dim,spacedim>::Cache (const Triangulation<dim,spacedim> &triangulation,
+                              const Mapping<dim,spacedim>       &mapping)
+    :
+    tria (&triangulation, typeid(*this).name()),
+    mapping (&mapping, typeid(*this).name()),
+    is_up_to_date (false)
+  {
+    tria_change_signal
+      = triangulation.signals.any_change.connect ([this]()
+    {
+      this->mark_for_update();
+    });
+  }
+
+
+
+  template <int dim, int spacedim>
+  Cache<dim,spacedim>::Cache (const Cache<dim,spacedim> &other)
+    :
+    Cache (other.get_triangulation(), other.get_mapping())
+  {}
+
+
+
+  template <int dim, int spacedim>
+  Cache<dim,spacedim>::~Cache ()
+  {
+    tria_change_signal.disconnect ();
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  Cache<dim,spacedim>::mark_for_update ()
+  {
+    Threads::Mutex::ScopedLock lock (mutex);
+    is_up_to_date = false;
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  Cache<dim,spacedim>::update () const
+  {
+    if (is_up_to_date)
+      return;
+
+    Threads::Mutex::ScopedLock lock (mutex);
+    if (!is_up_to_date)
+      {
+        build ();
+        is_up_to_date = true;
+      }
+  }
+
+
+
+  template <int dim, int spacedim>
+  void
+  Cache<dim,spacedim>::build () const
+  {
+    typedef typename Triangulation<dim,spacedim>::active_cell_iterator active_cell_iterator;
+
+    // collect the cells along with their bounding boxes and the location of
+    // the vertices given by the mapping
+    const unsigned int n_cells = tria->n_active_cells();
+    std::vector<active_cell_iterator> cells;
+    std::vector<BoundingBox>          boxes;
+    std::vector<Point<spacedim> >     centers;
+    cells.reserve (n_cells);
+    boxes.reserve (n_cells);
+    centers.reserve (n_cells);
+    vertices = tria->get_vertices();
+    for (active_cell_iterator cell = tria->begin_active(); cell != tria->end(); ++cell)
+      {
+        const std::array<Point<spacedim>, GeometryInfo<dim>::vertices_per_cell>
+        cell_vertices = mapping->get_vertices (cell);
+
+        BoundingBox box;
+        box.lower = box.upper = cell_vertices[0];
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            vertices[cell->vertex_index(v)] = cell_vertices[v];
+            for (unsigned int d=0; d<spacedim; ++d)
+              {
+                box.lower[d] = std::min (box.lower[d], cell_vertices[v][d]);
+                box.upper[d] = std::max (box.upper[d], cell_vertices[v][d]);
+              }
+          }
+
+        // enlarge the box slightly, such that points that are found within
+        // the cell up to roundoff also lie within the box
+        double extent = 0;
+        for (unsigned int d=0; d<spacedim; ++d)
+          extent = std::max (extent, box.upper[d] - box.lower[d]);
+        for (unsigned int d=0; d<spacedim; ++d)
+          {
+            box.lower[d] -= 1e-8 * extent;
+            box.upper[d] += 1e-8 * extent;
+          }
+
+        cells.push_back (cell);
+        boxes.push_back (box);
+        centers.push_back (0.5 * (box.lower + box.upper));
+      }
+
+    // sort the cells into tiles and build the levels of the R-tree bottom
+    // up
+    std::vector<unsigned int> order (cells.size());
+    std::iota (order.begin(), order.end(), 0U);
+    sort_tile_recursive (order.begin(), order.end(), 0, centers,
+                         rtree_node_size);
+
+    rtree_cells.resize (cells.size());
+    rtree.clear ();
+    rtree.emplace_back (cells.size());
+    for (unsigned int i=0; i<cells.size(); ++i)
+      {
+        rtree_cells[i] = cells[order[i]];
+        rtree[0][i] = boxes[order[i]];
+      }
+    while (rtree.back().size() > 1)
+      {
+        const std::vector<BoundingBox> &children = rtree.back();
+        std::vector<BoundingBox> parents ((children.size() + rtree_node_size - 1) /
+                                          rtree_node_size);
+        for (unsigned int i=0; i<parents.size(); ++i)
+          {
+            parents[i] = children[i*rtree_node_size];
+            for (unsigned int c=i*rtree_node_size+1;
+                 c<std::min<std::size_t>((i+1)*rtree_node_size, children.size()); ++c)
+              for (unsigned int d=0; d<spacedim; ++d)
+                {
+                  parents[i].lower[d] = std::min (parents[i].lower[d], children[c].lower[d]);
+                  parents[i].upper[d] = std::max (parents[i].upper[d], children[c].upper[d]);
+                }
+          }
+        rtree.push_back (std::move (parents));
+      }
+
+    // build the KD-tree of the used vertices
+    kdtree_vertices.clear ();
+    for (unsigned int v=0; v<tria->n_vertices(); ++v)
+      if (tria->vertex_used(v))
+        kdtree_vertices.push_back (v);
+    build_kdtree (kdtree_vertices.begin(), kdtree_vertices.end(), 0, vertices);
+
+    vertex_to_cells = GridTools::vertex_to_cell_map (*tria);
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator>
+  Cache<dim,spacedim>::get_cells_with_bounding_box_around_point (const Point<spacedim> &p) const
+  {
+    update ();
+
+    std::vector<typename Triangulation<dim,spacedim>::active_cell_iterator> cells;
+    if (rtree_cells.size() == 0)
+      return cells;
+
+    // traverse the tree from the root, descending into all nodes whose box
+    // contains the point
+    std::vector<std::pair<unsigned int, unsigned int> > nodes (1, std::make_pair (rtree.size()-1, 0U));
+    while (nodes.size() > 0)
+      {
+        const std::pair<unsigned int, unsigned int> node = nodes.back();
+        nodes.pop_back ();
+        if (rtree[node.first][node.second].contains (p) == false)
+          continue;
+
+        if (node.first == 0)
+          cells.push_back (rtree_cells[node.second]);
+        else
+          {
+            const unsigned int begin = node.second * rtree_node_size;
+            const unsigned int end = std::min<std::size_t> (begin + rtree_node_size,
+                                                            rtree[node.first-1].size());
+            for (unsigned int c=begin; c<end; ++c)
+              nodes.emplace_back (node.first-1, c);
+          }
+      }
+
+    std::sort (cells.begin(), cells.end());
+    return cells;
+  }
+
+
+
+  template <int dim, int spacedim>
+  unsigned int
+  Cache<dim,spacedim>::find_closest_vertex (const Point<spacedim> &p) const
+  {
+    update ();
+    Assert (kdtree_vertices.size() > 0,
+            ExcMessage ("The triangulation does not have any vertices."));
+
+    unsigned int closest_vertex = numbers::invalid_unsigned_int;
+    double closest_distance_square = std::numeric_limits<double>::max();
+    search_kdtree (p, kdtree_vertices.data(),
+                   kdtree_vertices.data() + kdtree_vertices.size(), 0,
+                   vertices, closest_vertex, closest_distance_square);
+    return closest_vertex;
+  }
+
+
+
+  template <int dim, int spacedim>
+  const std::vector<std::set<typename Triangulation<dim,spacedim>::active_cell_iterator> > &
+  Cache<dim,spacedim>::get_vertex_to_cell_map () const
+  {
+    update ();
+    return vertex_to_cells;
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::size_t
+  Cache<dim,spacedim>::memory_consumption () const
+  {
+    std::size_t memory = sizeof(*this) +
+                         MemoryConsumption::memory_consumption (vertices) +
+                         MemoryConsumption::memory_consumption (kdtree_vertices) +
+                         rtree_cells.capacity() * sizeof(rtree_cells[0]);
+    for (unsigned int l=0; l<rtree.size(); ++l)
+      memory += rtree[l].capacity() * sizeof(BoundingBox);
+    for (unsigned int v=0; v<vertex_to_cells.size(); ++v)
+      memory += sizeof(vertex_to_cells[v]) +
+                vertex_to_cells[v].size() * sizeof(rtree_cells[0]);
+    return memory;
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::pair<typename Triangulation<dim, spacedim>::active_cell_iterator, Point<dim> >
+  find_active_cell_around_point (const Cache<dim,spacedim>                                         &cache,
+                                 const Point<spacedim>                                             &p,
+                                 const typename Triangulation<dim, spacedim>::active_cell_iterator &cell_hint)
+  {
+    typedef typename Triangulation<dim, spacedim>::active_cell_iterator active_cell_iterator;
+    const Mapping<dim,spacedim> &mapping = cache.get_mapping();
+
+    if (cell_hint.state() == IteratorState::valid)
+      {
+        try
+          {
+            const Point<dim> p_cell = mapping.transform_real_to_unit_cell (cell_hint, p);
+            if (GeometryInfo<dim>::is_inside_unit_cell (p_cell))
+              return std::make_pair (cell_hint, p_cell);
+          }
+        catch (const typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+          {
+            // the point is not within the hint, so search the tree
+          }
+      }
+
+    // among the cells whose bounding boxes contain the point, choose the
+    // best one with the same criterion as the other variants of this
+    // function: the smallest distance to the unit cell up to a deviation of
+    // 1e-10 and, among cells with the same distance, the most refined one
+    double best_distance = 1e-10;
+    int    best_level = -1;
+    std::pair<active_cell_iterator, Point<dim> > best_cell;
+    const auto check_cell = [&] (const active_cell_iterator &cell)
+    {
+      try
+        {
+          const Point<dim> p_cell = mapping.transform_real_to_unit_cell (cell, p);
+          const double dist = GeometryInfo<dim>::distance_to_unit_cell (p_cell);
+          if ((dist < best_distance)
+              ||
+              ((dist == best_distance) && (cell->level() > best_level)))
+            {
+              best_distance = dist;
+              best_level    = cell->level();
+              best_cell     = std::make_pair (cell, p_cell);
+            }
+        }
+      catch (const typename Mapping<dim,spacedim>::ExcTransformationFailed &)
+        {
+          // the point is not within this cell, so move on to the next one
+        }
+    };
+
+    const std::vector<active_cell_iterator> cells
+      = cache.get_cells_with_bounding_box_around_point (p);
+    for (unsigned int c=0; c<cells.size(); ++c)
+      check_cell (cells[c]);
+
+    if (best_cell.first.state() == IteratorState::valid)
+      return best_cell;
+
+    // the point is not within any of the bounding boxes of the cells, which
+    // can only happen if it is outside the mesh or the mapping moves parts
+    // of a cell outside the box around its vertices. in the latter case, the
+    // point is close to the boundary of the cell, so look at the cells
+    // around the closest vertex and at the cells sharing a vertex with
+    // them, using the search structures of the cache rather than a walk
+    // through the whole mesh
+    const std::vector<std::set<active_cell_iterator> > &vertex_to_cells
+      = cache.get_vertex_to_cell_map ();
+    const std::set<active_cell_iterator> &adjacent_cells
+      = vertex_to_cells[cache.find_closest_vertex (p)];
+    std::set<active_cell_iterator> candidates (adjacent_cells);
+    for (const active_cell_iterator &cell : adjacent_cells)
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        candidates.insert (vertex_to_cells[cell->vertex_index(v)].begin(),
+                           vertex_to_cells[cell->vertex_index(v)].end());
+    for (const active_cell_iterator &cell : candidates)
+      if (std::binary_search (cells.begin(), cells.end(), cell) == false)
+        check_cell (cell);
+
+    AssertThrow (best_cell.first.state() == IteratorState::valid,
+                 ExcPointNotFound<spacedim>(p));
+    return best_cell;
+  }
+
+
+
+  template <int dim, int spacedim>
+  std::tuple<std::vector<typename Triangulation<dim, spacedim>::active_cell_iterator>,
+             std::vector<std::vector<Point<dim> > >,
+             std::vector<std::vector<unsigned int> > >
+  compute_point_locations (const Cache<dim,spacedim>                                         &cache,
+                           const std::vector<Point<spacedim> >                               &points,
+                           const typename Triangulation<dim, spacedim>::active_cell_iterator &cell_hint)
+  {
+    typedef typename Triangulation<dim, spacedim>::active_cell_iterator active_cell_iterator;
+
+    // build the search structures before starting the threads
+    cache.update ();
+
+    // locate the points in parallel. each thread uses the cell of the
+    // previous point as hint for the next one. points that can not be found
+    // keep an invalid cell iterator
+    std::vector<std::pair<active_cell_iterator, Point<dim> > > locations (points.size());
+    parallel::apply_to_subranges
+    (0U, static_cast<unsigned int>(points.size()),
+     [&] (const unsigned int begin, const unsigned int end)
+    {
+      active_cell_iterator hint = cell_hint;
+      for (unsigned int i=begin; i<end; ++i)
+        try
+          {
+            locations[i] = find_active_cell_around_point (cache, points[i], hint);
+            hint = locations[i].first;
+          }
+        catch (const ExcPointNotFound<spacedim> &)
+          {
+            hint = cell_hint;
+          }
+    },
+    128);
+
+    // group the points by cells, in the order of the first point in each cell
+    std::tuple<std::vector<active_cell_iterator>,
+        std::vector<std::vector<Point<dim> > >,
+        std::vector<std::vector<unsigned int> > > result;
+    std::vector<active_cell_iterator>       &cells   = std::get<0>(result);
+    std::vector<std::vector<Point<dim> > >   &qpoints = std::get<1>(result);
+    std::vector<std::vector<unsigned int> > &maps    = std::get<2>(result);
+
+    std::map<active_cell_iterator, unsigned int> cell_indices;
+    for (unsigned int i=0; i<points.size(); ++i)
+      {
+        AssertThrow (locations[i].first.state() == IteratorState::valid,
+                     ExcPointNotFound<spacedim>(points[i]));
+
+        const std::pair<typename std::map<active_cell_iterator, unsigned int>::iterator, bool>
+        entry = cell_indices.insert (std::make_pair (locations[i].first,
+                                                     static_cast<unsigned int>(cells.size())));
+        if (entry.second)
+          {
+            cells.push_back (locations[i].first);
+            qpoints.emplace_back ();
+            maps.emplace_back ();
+          }
+        qpoints[entry.first->second].push_back (locations[i].second);
+        maps[entry.first->second].push_back (i);
+      }
+
+    return result;
+  }
+}
+
+// explicit instantiations
+#include "grid_tools_cache.inst"
+
+DEAL_II_NAMESPACE_CLOSE
@@ -53,6 +53,15 @@ Manifold<dim, spacedim>::~Manifold ()
 
 
 
+template <int dim, int spacedim>
+bool
+Manifold<dim, spacedim>::is_thread_safe () const
+{
+  return false;
+}
+
+
+
 template <int dim, int spacedim>
 Point<spacedim>
 Manifold<dim, spacedim>::
@@ -541,6 +550,15 @@ FlatManifold<dim,spacedim>::FlatManifold (const Tensor<1,spacedim> &periodicity,
 
 
 
+template <int dim, int spacedim>
+bool
+FlatManifold<dim,spacedim>::is_thread_safe () const
+{
+  return true;
+}
+
+
+
 template <int dim, int spacedim>
 Point<spacedim>
 FlatManifold<dim, spacedim>::
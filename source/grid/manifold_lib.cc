@@ -35,6 +35,15 @@ PolarManifold<dim,spacedim>::PolarManifold(const Point<spacedim> center):
   center(center)
 {}
 
+
+template <int dim, int spacedim>
+bool
+PolarManifold<dim,spacedim>::is_thread_safe () const
+{
+  return true;
+}
+
+
 template <int dim, int spacedim>
 Tensor<1,spacedim>
 PolarManifold<dim,spacedim>::get_periodicity()
@@ -170,6 +179,15 @@ SphericalManifold<dim,spacedim>::SphericalManifold(const Point<spacedim> center)
   center(center)
 {}
 
+
+template <int dim, int spacedim>
+bool
+SphericalManifold<dim,spacedim>::is_thread_safe () const
+{
+  return true;
+}
+
+
 template <int dim, int spacedim>
 Point<spacedim>
 SphericalManifold<dim,spacedim>::
@@ -364,6 +382,15 @@ CylindricalManifold<dim, spacedim>::CylindricalManifold(const Point<spacedim> &d
 {}
 
 
+template <int dim, int spacedim>
+bool
+CylindricalManifold<dim,spacedim>::is_thread_safe () const
+{
+  return true;
+}
+
+
+
 
 template <int dim, int spacedim>
 Point<spacedim>
@@ -603,6 +630,15 @@ TorusManifold<dim>::TorusManifold (const double R, const double r)
 }
 
 
+template <int dim>
+bool
+TorusManifold<dim>::is_thread_safe () const
+{
+  return true;
+}
+
+
+
 
 template <int dim>
 DerivativeForm<1,3,3>
@@ -641,6 +677,15 @@ TransfiniteInterpolationManifold<dim,spacedim>::TransfiniteInterpolationManifold
 }
 
 
+template <int dim, int spacedim>
+bool
+TransfiniteInterpolationManifold<dim,spacedim>::is_thread_safe () const
+{
+  return true;
+}
+
+
+
 
 template <int dim, int spacedim>
 void
@@ -18,6 +18,7 @@
 #include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/table.h>
 #include <deal.II/base/geometry_info.h>
+#include <deal.II/base/parallel.h>
 
 #include <deal.II/grid/tria.h>
 #include <deal.II/grid/tria_levels.h>
@@ -1789,6 +1790,230 @@ namespace internal
       }
 
 
+      /**
+       * A line of a cell, given by the indices of its two vertices, along
+       * with the position <tt>cell*lines_per_cell+line</tt> at which it
+       * appears in the list of lines of all cells. Sorting objects of this
+       * type brings all occurrences of the same line next to each other, in
+       * the order in which the cells list them.
+       */
+      struct CellLine
+      {
+        unsigned int vertices[2];
+        unsigned int position;
+
+        bool operator < (const CellLine &l) const
+        {
+          return ((vertices[0] < l.vertices[0]) ||
+                  ((vertices[0] == l.vertices[0]) &&
+                   ((vertices[1] < l.vertices[1]) ||
+                    ((vertices[1] == l.vertices[1]) &&
+                     (position < l.position)))));
+        }
+      };
+
+
+      /**
+       * Determine the lines of a triangulation with the given cells. On
+       * return, @p lines contains the vertex pairs of all lines in
+       * lexicographic order, i.e., in the order in which lines are numbered,
+       * @p line_indices contains for each line of each cell (at position
+       * <tt>cell*lines_per_cell+line</tt>) the index of this line in @p
+       * lines, and @p first_positions contains for each line the first
+       * position at which it appears in the cells.
+       *
+       * If @p ignore_direction is true, then a pair of vertices and the
+       * reversed pair denote the same line, whose direction is then the one
+       * in which the first cell that contains it sees it. Otherwise, these
+       * are two different lines.
+       *
+       * This function does the same as inserting all lines of all cells into
+       * a std::map, but by sorting, in parallel if possible, rather than
+       * one insertion after the other.
+       */
+      template <int dim>
+      static
+      void
+      find_unique_lines (const std::vector<CellData<dim> >                  &cells,
+                         const bool                                          ignore_direction,
+                         std::vector<std::pair<unsigned int,unsigned int> > &lines,
+                         std::vector<unsigned int>                          &line_indices,
+                         std::vector<unsigned int>                          &first_positions)
+      {
+        const unsigned int lines_per_cell = GeometryInfo<dim>::lines_per_cell;
+        AssertThrow (cells.size() < std::numeric_limits<unsigned int>::max() / lines_per_cell,
+                     ExcMessage ("Too many cells to create a triangulation from."));
+
+        std::vector<CellLine> cell_lines (cells.size() * lines_per_cell);
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(cells.size()),
+         [&] (const unsigned int begin,
+              const unsigned int end)
+        {
+          for (unsigned int c=begin; c<end; ++c)
+            for (unsigned int l=0; l<lines_per_cell; ++l)
+              {
+                CellLine &cell_line = cell_lines[c*lines_per_cell+l];
+                cell_line.vertices[0] = cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 0)];
+                cell_line.vertices[1] = cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 1)];
+                cell_line.position = c*lines_per_cell+l;
+                if (ignore_direction && (cell_line.vertices[0] > cell_line.vertices[1]))
+                  std::swap (cell_line.vertices[0], cell_line.vertices[1]);
+              }
+        },
+        1000);
+        parallel::sort (cell_lines.begin(), cell_lines.end());
+
+        // each group of equal vertex pairs is one line. its direction is the
+        // one in which it appears first
+        lines.clear ();
+        first_positions.clear ();
+        line_indices.resize (cell_lines.size());
+        for (unsigned int i=0; i<cell_lines.size(); ++i)
+          {
+            if ((i == 0) ||
+                (cell_lines[i].vertices[0] != cell_lines[i-1].vertices[0]) ||
+                (cell_lines[i].vertices[1] != cell_lines[i-1].vertices[1]))
+              {
+                const unsigned int position = cell_lines[i].position;
+                const unsigned int c = position / lines_per_cell;
+                const unsigned int l = position % lines_per_cell;
+                lines.emplace_back (cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 0)],
+                                    cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(l, 1)]);
+                first_positions.push_back (position);
+              }
+            line_indices[cell_lines[i].position] = lines.size()-1;
+          }
+
+        // if we have merged lines of opposite directions, the lines are not
+        // yet in lexicographic order. sort them and renumber
+        if (ignore_direction)
+          {
+            std::vector<unsigned int> permutation (lines.size());
+            std::iota (permutation.begin(), permutation.end(), 0U);
+            parallel::sort (permutation.begin(), permutation.end(),
+                            [&] (const unsigned int a,
+                                 const unsigned int b)
+            {
+              return lines[a] < lines[b];
+            });
+
+            std::vector<unsigned int> new_indices (lines.size());
+            std::vector<std::pair<unsigned int,unsigned int> > sorted_lines (lines.size());
+            std::vector<unsigned int> sorted_first_positions (lines.size());
+            for (unsigned int i=0; i<permutation.size(); ++i)
+              {
+                new_indices[permutation[i]] = i;
+                sorted_lines[i] = lines[permutation[i]];
+                sorted_first_positions[i] = first_positions[permutation[i]];
+              }
+            lines.swap (sorted_lines);
+            first_positions.swap (sorted_first_positions);
+
+            parallel::apply_to_subranges
+            (0U, static_cast<unsigned int>(line_indices.size()),
+             [&] (const unsigned int begin,
+                  const unsigned int end)
+            {
+              for (unsigned int i=begin; i<end; ++i)
+                line_indices[i] = new_indices[line_indices[i]];
+            },
+            10000);
+          }
+      }
+
+
+      /**
+       * Return the index of the line with vertices @p v0 and @p v1 in the
+       * sorted list @p lines, or numbers::invalid_unsigned_int if there is
+       * no such line.
+       */
+      static
+      unsigned int
+      find_line (const std::vector<std::pair<unsigned int,unsigned int> > &lines,
+                 const unsigned int                                        v0,
+                 const unsigned int                                        v1)
+      {
+        const std::pair<unsigned int,unsigned int> line (v0, v1);
+        const std::vector<std::pair<unsigned int,unsigned int> >::const_iterator
+        p = std::lower_bound (lines.begin(), lines.end(), line);
+        if ((p != lines.end()) && (*p == line))
+          return p - lines.begin();
+        else
+          return numbers::invalid_unsigned_int;
+      }
+
+
+      /**
+       * Given the lines of a triangulation as computed by
+       * find_unique_lines() without ignoring their direction, return the
+       * index of the first cell that lists a line whose reverse has been
+       * listed before (by the same or an earlier cell), or
+       * numbers::invalid_unsigned_int if there is no such cell.
+       */
+      static
+      unsigned int
+      find_cell_with_reversed_line (const std::vector<std::pair<unsigned int,unsigned int> > &lines,
+                                    const std::vector<unsigned int>                          &first_positions,
+                                    const unsigned int                                        lines_per_cell)
+      {
+        Threads::Mutex mutex;
+        unsigned int first_invalid_position = numbers::invalid_unsigned_int;
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(lines.size()),
+         [&] (const unsigned int begin,
+              const unsigned int end)
+        {
+          unsigned int my_first_invalid_position = numbers::invalid_unsigned_int;
+          for (unsigned int i=begin; i<end; ++i)
+            {
+              const unsigned int reverse = find_line (lines, lines[i].second, lines[i].first);
+              if ((reverse != numbers::invalid_unsigned_int) && (reverse != i))
+                my_first_invalid_position
+                  = std::min (my_first_invalid_position,
+                              std::max (first_positions[i], first_positions[reverse]));
+            }
+
+          Threads::Mutex::ScopedLock lock (mutex);
+          first_invalid_position = std::min (first_invalid_position,
+                                             my_first_invalid_position);
+        },
+        1000);
+
+        return (first_invalid_position == numbers::invalid_unsigned_int ?
+                numbers::invalid_unsigned_int :
+                first_invalid_position / lines_per_cell);
+      }
+
+
+      /**
+       * For each line (in 2d) or quad (in 3d) of a triangulation with
+       * @p n_faces faces, given the face indices of all cells in @p
+       * cell_faces at positions <tt>cell*faces_per_cell+face</tt>, compute
+       * the number of adjacent cells and the (at most two) adjacent cells
+       * with the smallest indices, in the order in which the cells are
+       * listed.
+       */
+      static
+      void
+      find_adjacent_cells (const std::vector<unsigned int>          &cell_faces,
+                           const unsigned int                        faces_per_cell,
+                           const unsigned int                        n_faces,
+                           std::vector<unsigned int>                &n_adjacent_cells,
+                           std::vector<std::array<unsigned int,2> > &adjacent_cells)
+      {
+        n_adjacent_cells.assign (n_faces, 0);
+        adjacent_cells.resize (n_faces);
+        for (unsigned int i=0; i<cell_faces.size(); ++i)
+          {
+            const unsigned int face = cell_faces[i];
+            if (n_adjacent_cells[face] < 2)
+              adjacent_cells[face][n_adjacent_cells[face]] = i / faces_per_cell;
+            ++n_adjacent_cells[face];
+          }
+      }
+
+
       /**
        * Create a triangulation from
        * given data. This function does
@@ -1833,80 +2058,55 @@ namespace internal
           }
 #endif
 
-        // make up a list of the needed
-        // lines each line is a pair of
-        // vertices. The list is kept
-        // sorted and it is guaranteed that
-        // each line is inserted only once.
-        // While the key of such an entry
-        // is the pair of vertices, the
-        // thing it points to is an
-        // iterator pointing to the line
-        // object itself. In the first run,
-        // these iterators are all invalid
-        // ones, but they are filled
-        // afterwards
-        std::map<std::pair<int,int>,
-            typename Triangulation<dim,spacedim>::line_iterator> needed_lines;
+        // check that all vertex indices are valid ones
         for (unsigned int cell=0; cell<cells.size(); ++cell)
-          {
-            for (unsigned int vertex=0; vertex<4; ++vertex)
-              AssertThrow (cells[cell].vertices[vertex] < triangulation.vertices.size(),
-                           ExcInvalidVertexIndex (cell, cells[cell].vertices[vertex],
-                                                  triangulation.vertices.size()));
-
-            for (unsigned int line=0; line<GeometryInfo<dim>::faces_per_cell; ++line)
-              {
-                // given a line vertex number (0,1) on a specific line
-                // we get the cell vertex number (0-4) through the
-                // line_to_cell_vertices function
-                std::pair<int,int> line_vertices(
-                  cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)],
-                  cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)]);
-
-                // assert that the line was not already inserted in
-                // reverse order. This happens in spite of the vertex
-                // rotation above, if the sense of the cell was
-                // incorrect.
-                //
-                // Here is what usually happened when this exception
-                // is thrown: consider these two cells and the
-                // vertices
-                //  3---4---5
-                //  |   |   |
-                //  0---1---2
-                // If in the input vector the two cells are given with
-                // vertices <0 1 3 4> and <4 1 5 2>, in the first cell
-                // the middle line would have direction 1->4, while in
-                // the second it would be 4->1.  This will cause the
-                // exception.
-                AssertThrow (needed_lines.find(std::make_pair(line_vertices.second,
-                                                              line_vertices.first))
-                             ==
-                             needed_lines.end(),
-                             ExcGridHasInvalidCell(cell));
-
-                // insert line, with
-                // invalid iterator if line
-                // already exists, then
-                // nothing bad happens here
-                needed_lines[line_vertices] = triangulation.end_line();
-              }
-          }
+          for (unsigned int vertex=0; vertex<4; ++vertex)
+            AssertThrow (cells[cell].vertices[vertex] < triangulation.vertices.size(),
+                         ExcInvalidVertexIndex (cell, cells[cell].vertices[vertex],
+                                                triangulation.vertices.size()));
+
+        // make up a list of the needed lines. each line is a pair of
+        // vertices; the list is sorted and it is guaranteed that each line
+        // appears only once. for each line of each cell, line_indices
+        // stores the index of this line within the list, which is also the
+        // index of the line object we create from it below
+        std::vector<std::pair<unsigned int,unsigned int> > needed_lines;
+        std::vector<unsigned int> line_indices;
+        std::vector<unsigned int> first_positions;
+        find_unique_lines (cells, false, needed_lines, line_indices, first_positions);
+
+        // assert that no line appears in both directions. This happens in
+        // spite of the vertex rotation above, if the sense of the cell was
+        // incorrect.
+        //
+        // Here is what usually happened when this exception is thrown:
+        // consider these two cells and the vertices
+        //  3---4---5
+        //  |   |   |
+        //  0---1---2
+        // If in the input vector the two cells are given with vertices <0 1
+        // 3 4> and <4 1 5 2>, in the first cell the middle line would have
+        // direction 1->4, while in the second it would be 4->1.  This will
+        // cause the exception.
+        {
+          const unsigned int invalid_cell
+            = find_cell_with_reversed_line (needed_lines, first_positions,
+                                            GeometryInfo<dim>::lines_per_cell);
+          AssertThrow (invalid_cell == numbers::invalid_unsigned_int,
+                       ExcGridHasInvalidCell(invalid_cell));
+        }
 
 
         // check that every vertex has at
         // least two adjacent lines
         {
           std::vector<unsigned short int> vertex_touch_count (v.size(), 0);
-          typename std::map<std::pair<int,int>,
-                   typename Triangulation<dim,spacedim>::line_iterator>::iterator i;
-          for (i=needed_lines.begin(); i!=needed_lines.end(); ++i)
+          for (unsigned int i=0; i<needed_lines.size(); ++i)
             {
               // touch the vertices of
               // this line
-              ++vertex_touch_count[i->first.first];
-              ++vertex_touch_count[i->first.second];
+              ++vertex_touch_count[needed_lines[i].first];
+              ++vertex_touch_count[needed_lines[i].second];
             }
 
           // assert minimum touch count
@@ -1932,25 +2132,23 @@ namespace internal
         {
           typename Triangulation<dim,spacedim>::raw_line_iterator
           line = triangulation.begin_raw_line();
-          typename std::map<std::pair<int,int>,
-                   typename Triangulation<dim,spacedim>::line_iterator>::iterator i;
-          for (i = needed_lines.begin();
-               line!=triangulation.end_line(); ++line, ++i)
+          for (unsigned int i=0; line!=triangulation.end_line(); ++line, ++i)
             {
-              line->set (internal::Triangulation::TriaObject<1>(i->first.first,
-                                                                i->first.second));
+              line->set (internal::Triangulation::TriaObject<1>(needed_lines[i].first,
+                                                                needed_lines[i].second));
               line->set_used_flag ();
               line->clear_user_flag ();
               line->clear_user_data ();
-              i->second = line;
             }
         }
 
 
         // store for each line index
         // the adjacent cells
-        std::map<int,std::vector<typename Triangulation<dim,spacedim>::cell_iterator> >
-        adjacent_cells;
+        std::vector<unsigned int>                n_adjacent_cells;
+        std::vector<std::array<unsigned int,2> > adjacent_cells;
+        find_adjacent_cells (line_indices, GeometryInfo<dim>::lines_per_cell,
+                             needed_lines.size(), n_adjacent_cells, adjacent_cells);
 
         // finally make up cells
         {
@@ -1958,29 +2156,17 @@ namespace internal
           cell = triangulation.begin_raw_quad();
           for (unsigned int c=0; c<cells.size(); ++c, ++cell)
             {
-              typename Triangulation<dim,spacedim>::line_iterator
-              lines[GeometryInfo<dim>::lines_per_cell];
-              for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
-                lines[line]=needed_lines[std::make_pair(
-                                           cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)],
-                                           cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)])];
-
-              cell->set (internal::Triangulation::TriaObject<2> (lines[0]->index(),
-                                                                 lines[1]->index(),
-                                                                 lines[2]->index(),
-                                                                 lines[3]->index()));
+              const unsigned int *lines = &line_indices[c*GeometryInfo<dim>::lines_per_cell];
+              cell->set (internal::Triangulation::TriaObject<2> (lines[0],
+                                                                 lines[1],
+                                                                 lines[2],
+                                                                 lines[3]));
 
               cell->set_used_flag ();
               cell->set_material_id (cells[c].material_id);
               cell->set_manifold_id (cells[c].manifold_id);
               cell->clear_user_data ();
               cell->set_subdomain_id (0);
-
-              // note that this cell is
-              // adjacent to the four
-              // lines
-              for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
-                adjacent_cells[lines[line]->index()].push_back (cell);
             }
         }
 
@@ -1989,7 +2175,7 @@ namespace internal
              line=triangulation.begin_line();
              line!=triangulation.end_line(); ++line)
           {
-            const unsigned int n_adj_cells = adjacent_cells[line->index()].size();
+            const unsigned int n_adj_cells = n_adjacent_cells[line->index()];
 
             // assert that every line has one or two adjacent cells.
             // this has to be the case for 2d triangulations in 2d.
@@ -2035,23 +2221,25 @@ namespace internal
           = subcelldata.boundary_lines.end();
         for (; boundary_line!=end_boundary_line; ++boundary_line)
           {
-            typename Triangulation<dim,spacedim>::line_iterator line;
             std::pair<int,int> line_vertices(std::make_pair(boundary_line->vertices[0],
                                                             boundary_line->vertices[1]));
-            if (needed_lines.find(line_vertices) != needed_lines.end())
-              // line found in this direction
-              line = needed_lines[line_vertices];
-            else
+            unsigned int line_index = find_line (needed_lines,
+                                                 line_vertices.first,
+                                                 line_vertices.second);
+            if (line_index == numbers::invalid_unsigned_int)
               {
                 // look whether it exists in reverse direction
                 std::swap (line_vertices.first, line_vertices.second);
-                if (needed_lines.find(line_vertices) != needed_lines.end())
-                  line = needed_lines[line_vertices];
-                else
-                  // line does not exist
-                  AssertThrow (false, ExcLineInexistant(line_vertices.first,
-                                                        line_vertices.second));
+                line_index = find_line (needed_lines,
+                                        line_vertices.first,
+                                        line_vertices.second);
+                // line does not exist
+                AssertThrow (line_index != numbers::invalid_unsigned_int,
+                             ExcLineInexistant(line_vertices.first,
+                                               line_vertices.second));
               }
+            const typename Triangulation<dim,spacedim>::line_iterator
+            line (&triangulation, 0, line_index);
 
             // assert that we only set boundary info once
             AssertThrow (! (line->boundary_id() != 0 &&
@@ -2100,22 +2288,28 @@ namespace internal
         for (typename Triangulation<dim,spacedim>::cell_iterator
              cell=triangulation.begin(); cell!=triangulation.end(); ++cell)
           for (unsigned int side=0; side<4; ++side)
-            if (adjacent_cells[cell->line(side)->index()][0] == cell)
-              // first adjacent cell is
-              // this one
-              {
-                if (adjacent_cells[cell->line(side)->index()].size() == 2)
-                  // there is another
-                  // adjacent cell
-                  cell->set_neighbor (side,
-                                      adjacent_cells[cell->line(side)->index()][1]);
-              }
-        // first adjacent cell is not this
-        // one, -> it must be the neighbor
-        // we are looking for
-            else
-              cell->set_neighbor (side,
-                                  adjacent_cells[cell->line(side)->index()][0]);
+            {
+              const unsigned int line
+                = line_indices[cell->index()*GeometryInfo<dim>::lines_per_cell+side];
+              if (adjacent_cells[line][0] == static_cast<unsigned int>(cell->index()))
+                // first adjacent cell is
+                // this one
+                {
+                  if (n_adjacent_cells[line] == 2)
+                    // there is another
+                    // adjacent cell
+                    cell->set_neighbor (side,
+                                        typename Triangulation<dim,spacedim>::cell_iterator
+                                        (&triangulation, 0, adjacent_cells[line][1]));
+                }
+              // first adjacent cell is not this
+              // one, -> it must be the neighbor
+              // we are looking for
+              else
+                cell->set_neighbor (side,
+                                    typename Triangulation<dim,spacedim>::cell_iterator
+                                    (&triangulation, 0, adjacent_cells[line][0]));
+            }
       }
 
 
@@ -2157,6 +2351,147 @@ namespace internal
       };
 
 
+      /**
+       * Return the eight variants in which a quad with the given lines can
+       * appear as the face of a cell, depending on the orientation of the
+       * face with respect to the cell: the quad itself, followed by the
+       * variants for the combinations of face_orientation, face_flip, and
+       * face_rotation flags given by quad_variant_orientation().
+       */
+      static
+      std::array<internal::Triangulation::TriaObject<2>,8>
+      quad_variants (const internal::Triangulation::TriaObject<2> &quad)
+      {
+        const std::array<internal::Triangulation::TriaObject<2>,8>
+        variants = {{ quad,
+                      internal::Triangulation::TriaObject<2>(quad.face(2), quad.face(3),
+                                                             quad.face(0), quad.face(1)),
+                      internal::Triangulation::TriaObject<2>(quad.face(0), quad.face(1),
+                                                             quad.face(3), quad.face(2)),
+                      internal::Triangulation::TriaObject<2>(quad.face(3), quad.face(2),
+                                                             quad.face(1), quad.face(0)),
+                      internal::Triangulation::TriaObject<2>(quad.face(1), quad.face(0),
+                                                             quad.face(2), quad.face(3)),
+                      internal::Triangulation::TriaObject<2>(quad.face(2), quad.face(3),
+                                                             quad.face(1), quad.face(0)),
+                      internal::Triangulation::TriaObject<2>(quad.face(1), quad.face(0),
+                                                             quad.face(3), quad.face(2)),
+                      internal::Triangulation::TriaObject<2>(quad.face(3), quad.face(2),
+                                                             quad.face(0), quad.face(1))
+                    }
+        };
+        return variants;
+      }
+
+
+      /**
+       * Return the face_orientation, face_flip, and face_rotation flags of
+       * a face of a cell whose lines, as seen from the cell, are given by the
+       * variant with number @p variant returned by quad_variants() for the
+       * quad actually stored in the triangulation.
+       */
+      static
+      std::array<bool,3>
+      quad_variant_orientation (const unsigned int variant)
+      {
+        static const bool orientations[8][3]
+          = { { true,  false, false },
+              { false, false, false },
+              { false, false, true  },
+              { false, true,  false },
+              { false, true,  true  },
+              { true,  false, true  },
+              { true,  true,  false },
+              { true,  true,  true  }
+            };
+        AssertIndexRange (variant, 8);
+        const std::array<bool,3> orientation = {{ orientations[variant][0],
+                                                  orientations[variant][1],
+                                                  orientations[variant][2]
+                                                }
+        };
+        return orientation;
+      }
+
+
+      /**
+       * Return whether two quads consist of the same lines in the same
+       * order.
+       */
+      static
+      bool
+      same_quad (const internal::Triangulation::TriaObject<2> &q1,
+                 const internal::Triangulation::TriaObject<2> &q2)
+      {
+        return ((q1.face(0) == q2.face(0)) &&
+                (q1.face(1) == q2.face(1)) &&
+                (q1.face(2) == q2.face(2)) &&
+                (q1.face(3) == q2.face(3)));
+      }
+
+
+      /**
+       * Return the quad made up of the lines of face @p face of cell @p
+       * cell, given the line indices of all lines of all cells as computed
+       * by find_unique_lines().
+       */
+      static
+      internal::Triangulation::TriaObject<2>
+      face_lines (const std::vector<unsigned int> &line_indices,
+                  const unsigned int               cell,
+                  const unsigned int               face)
+      {
+        const unsigned int *lines = &line_indices[cell*GeometryInfo<3>::lines_per_cell];
+        return internal::Triangulation::TriaObject<2>
+               (lines[GeometryInfo<3>::face_to_cell_lines(face,0)],
+                lines[GeometryInfo<3>::face_to_cell_lines(face,1)],
+                lines[GeometryInfo<3>::face_to_cell_lines(face,2)],
+                lines[GeometryInfo<3>::face_to_cell_lines(face,3)]);
+      }
+
+
+      /**
+       * A face of a cell, given by the smallest of the variants of its lines
+       * returned by quad_variants(), along with its position
+       * <tt>cell*faces_per_cell+face</tt> in the list of faces of all
+       * cells. Sorting objects of this type brings all occurrences of the
+       * same quad next to each other, in the order in which the cells list
+       * them.
+       */
+      struct CellQuad
+      {
+        int          lines[4];
+        unsigned int position;
+
+        bool operator < (const CellQuad &q) const
+        {
+          for (unsigned int l=0; l<4; ++l)
+            if (lines[l] != q.lines[l])
+              return (lines[l] < q.lines[l]);
+          return (position < q.position);
+        }
+      };
+
+
+      /**
+       * Return the index of the quad @p quad in the list @p quads sorted by
+       * QuadComparator, or numbers::invalid_unsigned_int if there is no such
+       * quad.
+       */
+      static
+      unsigned int
+      find_quad (const std::vector<internal::Triangulation::TriaObject<2> > &quads,
+                 const internal::Triangulation::TriaObject<2>               &quad)
+      {
+        const std::vector<internal::Triangulation::TriaObject<2> >::const_iterator
+        p = std::lower_bound (quads.begin(), quads.end(), quad, QuadComparator());
+        if ((p != quads.end()) && same_quad (*p, quad))
+          return p - quads.begin();
+        else
+          return numbers::invalid_unsigned_int;
+      }
+
+
       /**
       * Create a triangulation from
       * given data. This function does
@@ -2199,61 +2534,35 @@ namespace internal
         ///////////////////////////////////////
         // first set up some collections of data
         //
+        // check whether vertex indices
+        // are valid ones
+        for (unsigned int cell=0; cell<cells.size(); ++cell)
+          for (unsigned int vertex=0; vertex<GeometryInfo<dim>::vertices_per_cell; ++vertex)
+            AssertThrow (cells[cell].vertices[vertex] < triangulation.vertices.size(),
+                         ExcInvalidVertexIndex (cell, cells[cell].vertices[vertex],
+                                                triangulation.vertices.size()));
+
         // make up a list of the needed
         // lines
         //
         // each line is a pair of
         // vertices. The list is kept
         // sorted and it is guaranteed that
-        // each line is inserted only once.
-        // While the key of such an entry
-        // is the pair of vertices, the
-        // thing it points to is an
-        // iterator pointing to the line
-        // object itself. In the first run,
-        // these iterators are all invalid
-        // ones, but they are filled
-        // afterwards same applies for the
-        // quads
-        typename std::map<std::pair<int,int>,
-                 typename Triangulation<dim,spacedim>::line_iterator> needed_lines;
-        for (unsigned int cell=0; cell<cells.size(); ++cell)
-          {
-            // check whether vertex indices
-            // are valid ones
-            for (unsigned int vertex=0; vertex<GeometryInfo<dim>::vertices_per_cell; ++vertex)
-              AssertThrow (cells[cell].vertices[vertex] < triangulation.vertices.size(),
-                           ExcInvalidVertexIndex (cell, cells[cell].vertices[vertex],
-                                                  triangulation.vertices.size()));
-
-            for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
-              {
-                // given a line vertex number
-                // (0,1) on a specific line we
-                // get the cell vertex number
-                // (0-7) through the
-                // line_to_cell_vertices
-                // function
-                std::pair<int,int> line_vertices(
-                  cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)],
-                  cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)]);
-
-                // if that line was already inserted
-                // in reverse order do nothing, else
-                // insert the line
-                if ( (needed_lines.find(std::make_pair(line_vertices.second,
-                                                       line_vertices.first))
-                      ==
-                      needed_lines.end()))
-                  {
-                    // insert line, with
-                    // invalid iterator. if line
-                    // already exists, then
-                    // nothing bad happens here
-                    needed_lines[line_vertices] = triangulation.end_line();
-                  }
-              }
-          }
+        // each line appears only once,
+        // in the direction in which the
+        // first cell that contains it
+        // sees it. for each line of each
+        // cell, line_indices stores the
+        // index of this line within the
+        // list, which is also the index of
+        // the line object we create from
+        // it below
+        std::vector<std::pair<unsigned int,unsigned int> > needed_lines;
+        std::vector<unsigned int> line_indices;
+        {
+          std::vector<unsigned int> first_positions;
+          find_unique_lines (cells, true, needed_lines, line_indices, first_positions);
+        }
 
 
         /////////////////////////////////
@@ -2263,14 +2572,12 @@ namespace internal
         // least tree adjacent lines
         {
           std::vector<unsigned short int> vertex_touch_count (v.size(), 0);
-          typename std::map<std::pair<int,int>,
-                   typename Triangulation<dim,spacedim>::line_iterator>::iterator i;
-          for (i=needed_lines.begin(); i!=needed_lines.end(); ++i)
+          for (unsigned int i=0; i<needed_lines.size(); ++i)
             {
               // touch the vertices of
               // this line
-              ++vertex_touch_count[i->first.first];
-              ++vertex_touch_count[i->first.second];
+              ++vertex_touch_count[needed_lines[i].first];
+              ++vertex_touch_count[needed_lines[i].second];
             }
 
           // assert minimum touch count
@@ -2299,19 +2606,13 @@ namespace internal
         {
           typename Triangulation<dim,spacedim>::raw_line_iterator
           line = triangulation.begin_raw_line();
-          typename std::map<std::pair<int,int>,
-                   typename Triangulation<dim,spacedim>::line_iterator>::iterator i;
-          for (i = needed_lines.begin(); line!=triangulation.end_line(); ++line, ++i)
+          for (unsigned int i=0; line!=triangulation.end_line(); ++line, ++i)
             {
-              line->set (internal::Triangulation::TriaObject<1>(i->first.first,
-                                                                i->first.second));
+              line->set (internal::Triangulation::TriaObject<1>(needed_lines[i].first,
+                                                                needed_lines[i].second));
               line->set_used_flag ();
               line->clear_user_flag ();
               line->clear_user_data ();
-
-              // now set the iterator for
-              // this line
-              i->second = line;
             }
         }
 
@@ -2319,157 +2620,119 @@ namespace internal
         ///////////////////////////////////////////
         // make up the quads of this triangulation
         //
-        // same thing: the iterators are
-        // set to the invalid value at
-        // first, we only collect the data
-        // now
+        // the faces are quads which
+        // consist of four numbers
+        // denoting the index of the
+        // four lines bounding the
+        // quad. a face that is shared
+        // by two cells appears in one
+        // of eight variants in each of
+        // them (see quad_variants()),
+        // depending on its orientation
+        // with respect to the
+        // cell. the quad is stored in
+        // the variant in which the
+        // first cell that contains it
+        // sees it, along with the
+        // information whether its lines
+        // are in standard orientation,
+        // and the list of quads is
+        // sorted using QuadComparator.
+        //
+        // to find the unique quads, we
+        // represent each face of each
+        // cell by the smallest of its
+        // eight variants and sort
+        std::vector<CellQuad> cell_quads (cells.size() * GeometryInfo<dim>::faces_per_cell);
+        parallel::apply_to_subranges
+        (0U, static_cast<unsigned int>(cells.size()),
+         [&] (const unsigned int begin,
+              const unsigned int end)
+        {
+          for (unsigned int c=begin; c<end; ++c)
+            for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+              {
+                const std::array<internal::Triangulation::TriaObject<2>,8>
+                variants = quad_variants (face_lines (line_indices, c, face));
+                unsigned int smallest = 0;
+                for (unsigned int i=1; i<8; ++i)
+                  if (QuadComparator() (variants[i], variants[smallest]))
+                    smallest = i;
+
+                CellQuad &cell_quad = cell_quads[c*GeometryInfo<dim>::faces_per_cell+face];
+                for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_face; ++l)
+                  cell_quad.lines[l] = variants[smallest].face(l);
+                cell_quad.position = c*GeometryInfo<dim>::faces_per_cell+face;
+              }
+        },
+        1000);
+        parallel::sort (cell_quads.begin(), cell_quads.end());
 
         // the bool array stores, whether the lines
         // are in the standard orientation or not
-
-        // note that QuadComparator is a
-        // class declared and defined in
-        // this file
-        std::map<internal::Triangulation::TriaObject<2>,
-            std::pair<typename Triangulation<dim,spacedim>::quad_iterator,
-            std::array<bool,GeometryInfo<dim>::lines_per_face> >,
-            QuadComparator>
-            needed_quads;
-        for (unsigned int cell=0; cell<cells.size(); ++cell)
+        std::vector<internal::Triangulation::TriaObject<2> > needed_quads;
+        std::vector<std::array<bool,GeometryInfo<dim>::lines_per_face> > quad_line_orientations;
+        std::vector<unsigned int> quad_indices (cell_quads.size());
+        for (unsigned int i=0; i<cell_quads.size(); ++i)
           {
-            // the faces are quads which
-            // consist of four numbers
-            // denoting the index of the
-            // four lines bounding the
-            // quad. we can get this index
-            // by asking @p{needed_lines}
-            // for an iterator to this
-            // line, dereferencing it and
-            // thus return an iterator into
-            // the @p{lines} array of the
-            // triangulation, which is
-            // already set up. we can then
-            // ask this iterator for its
-            // index within the present
-            // level (the level is zero, of
-            // course)
-            //
-            // to make things easier, we
-            // don't create the lines
-            // (pairs of their vertex
-            // indices) in place, but
-            // before they are really
-            // needed.
-            std::pair<int,int> line_list[GeometryInfo<dim>::lines_per_cell],
-                inverse_line_list[GeometryInfo<dim>::lines_per_cell];
-            unsigned int face_line_list[GeometryInfo<dim>::lines_per_face];
-            std::array<bool,GeometryInfo<dim>::lines_per_face> orientation;
-
-            for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
+            if ((i == 0) ||
+                !std::equal (&cell_quads[i].lines[0],
+                             &cell_quads[i].lines[0] + GeometryInfo<dim>::lines_per_face,
+                             &cell_quads[i-1].lines[0]))
               {
-                line_list[line]=std::pair<int,int> (
-                                  cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)],
-                                  cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)]);
-                inverse_line_list[line]=std::pair<int,int> (
-                                          cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)],
-                                          cells[cell].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)]);
-              }
+                const unsigned int c = cell_quads[i].position / GeometryInfo<dim>::faces_per_cell;
+                const unsigned int face = cell_quads[i].position % GeometryInfo<dim>::faces_per_cell;
+                needed_quads.push_back (face_lines (line_indices, c, face));
 
-            for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
-              {
-                // set up a list of the lines to be
-                // used for this face. check the
-                // direction for each line
-                //
-                // given a face line number (0-3) on
-                // a specific face we get the cell
-                // line number (0-11) through the
-                // face_to_cell_lines function
+                std::array<bool,GeometryInfo<dim>::lines_per_face> orientation;
                 for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_face; ++l)
-                  if (needed_lines.find (inverse_line_list[GeometryInfo<dim>::
-                                                           face_to_cell_lines(face,l)]) == needed_lines.end())
-                    {
-                      face_line_list[l]=needed_lines[line_list[GeometryInfo<dim>::
-                                                               face_to_cell_lines(face,l)]]->index();
-                      orientation[l]=true;
-                    }
-                  else
-                    {
-                      face_line_list[l]=needed_lines[inverse_line_list[GeometryInfo<dim>::
-                                                                       face_to_cell_lines(face,l)]]->index();
-                      orientation[l]=false;
-                    }
-
-
-                internal::Triangulation::TriaObject<2>
-                quad(face_line_list[0],
-                     face_line_list[1],
-                     face_line_list[2],
-                     face_line_list[3]);
-
-                // insert quad, with
-                // invalid iterator
-                //
-                // if quad already exists,
-                // then nothing bad happens
-                // here, as this will then
-                // simply become an
-                // interior face of the
-                // triangulation. however,
-                // we will run into major
-                // trouble if the face was
-                // already inserted in the
-                // opposite
-                // direction. there are
-                // really only two
-                // orientations for a face
-                // to be in, since the edge
-                // directions are already
-                // set. thus, vertex 0 is
-                // the one from which two
-                // edges originate, and
-                // vertex 3 is the one to
-                // which they converge. we
-                // are then left with
-                // orientations 0-1-2-3 and
-                // 2-3-0-1 for the order of
-                // lines. the
-                // corresponding quad can
-                // be easily constructed by
-                // exchanging lines. we do
-                // so here, just to check
-                // that that flipped quad
-                // isn't already in the
-                // triangulation. if it is,
-                // then don't insert the
-                // new one and instead
-                // later set the
-                // face_orientation flag
-                const internal::Triangulation::TriaObject<2>
-                test_quad_1(quad.face(2), quad.face(3),
-                            quad.face(0), quad.face(1)),//face_orientation=false, face_flip=false, face_rotation=false
-                                      test_quad_2(quad.face(0), quad.face(1),
-                                                  quad.face(3), quad.face(2)),//face_orientation=false, face_flip=false, face_rotation=true
-                                      test_quad_3(quad.face(3), quad.face(2),
-                                                  quad.face(1), quad.face(0)),//face_orientation=false, face_flip=true,  face_rotation=false
-                                      test_quad_4(quad.face(1), quad.face(0),
-                                                  quad.face(2), quad.face(3)),//face_orientation=false, face_flip=true,  face_rotation=true
-                                      test_quad_5(quad.face(2), quad.face(3),
-                                                  quad.face(1), quad.face(0)),//face_orientation=true,  face_flip=false, face_rotation=true
-                                      test_quad_6(quad.face(1), quad.face(0),
-                                                  quad.face(3), quad.face(2)),//face_orientation=true,  face_flip=true,  face_rotation=false
-                                      test_quad_7(quad.face(3), quad.face(2),
-                                                  quad.face(0), quad.face(1));//face_orientation=true,  face_flip=true,  face_rotation=true
-                if (needed_quads.find (test_quad_1) == needed_quads.end() &&
-                    needed_quads.find (test_quad_2) == needed_quads.end() &&
-                    needed_quads.find (test_quad_3) == needed_quads.end() &&
-                    needed_quads.find (test_quad_4) == needed_quads.end() &&
-                    needed_quads.find (test_quad_5) == needed_quads.end() &&
-                    needed_quads.find (test_quad_6) == needed_quads.end() &&
-                    needed_quads.find (test_quad_7) == needed_quads.end())
-                  needed_quads[quad] = std::make_pair(triangulation.end_quad(),orientation);
+                  {
+                    const unsigned int line = GeometryInfo<dim>::face_to_cell_lines(face,l);
+                    orientation[l]
+                      = (needed_lines[line_indices[c*GeometryInfo<dim>::lines_per_cell+line]].first
+                         ==
+                         cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)]);
+                  }
+                quad_line_orientations.push_back (orientation);
               }
+            quad_indices[cell_quads[i].position] = needed_quads.size()-1;
           }
+        std::vector<CellQuad>().swap (cell_quads);
+
+        // sort the quads and renumber
+        {
+          std::vector<unsigned int> permutation (needed_quads.size());
+          std::iota (permutation.begin(), permutation.end(), 0U);
+          parallel::sort (permutation.begin(), permutation.end(),
+                          [&] (const unsigned int a,
+                               const unsigned int b)
+          {
+            return QuadComparator() (needed_quads[a], needed_quads[b]);
+          });
+
+          std::vector<unsigned int> new_indices (needed_quads.size());
+          std::vector<internal::Triangulation::TriaObject<2> > sorted_quads (needed_quads.size());
+          std::vector<std::array<bool,GeometryInfo<dim>::lines_per_face> >
+          sorted_orientations (needed_quads.size());
+          for (unsigned int i=0; i<permutation.size(); ++i)
+            {
+              new_indices[permutation[i]] = i;
+              sorted_quads[i] = needed_quads[permutation[i]];
+              sorted_orientations[i] = quad_line_orientations[permutation[i]];
+            }
+          needed_quads.swap (sorted_quads);
+          quad_line_orientations.swap (sorted_orientations);
+
+          parallel::apply_to_subranges
+          (0U, static_cast<unsigned int>(quad_indices.size()),
+           [&] (const unsigned int begin,
+                const unsigned int end)
+          {
+            for (unsigned int i=begin; i<end; ++i)
+              quad_indices[i] = new_indices[quad_indices[i]];
+          },
+          10000);
+        }
 
 
         /////////////////////////////////
@@ -2482,27 +2745,17 @@ namespace internal
         {
           typename Triangulation<dim,spacedim>::raw_quad_iterator
           quad = triangulation.begin_raw_quad();
-          typename std::map<internal::Triangulation::TriaObject<2>,
-                   std::pair<typename Triangulation<dim,spacedim>::quad_iterator,
-                   std::array<bool,GeometryInfo<dim>::lines_per_face> >,
-                   QuadComparator>
-                   ::iterator q;
-          for (q = needed_quads.begin(); quad!=triangulation.end_quad(); ++quad, ++q)
+          for (unsigned int q=0; quad!=triangulation.end_quad(); ++quad, ++q)
             {
-              quad->set (q->first);
+              quad->set (needed_quads[q]);
               quad->set_used_flag ();
               quad->clear_user_flag ();
               quad->clear_user_data ();
               // set the line orientation
-              quad->set_line_orientation(0,q->second.second[0]);
-              quad->set_line_orientation(1,q->second.second[1]);
-              quad->set_line_orientation(2,q->second.second[2]);
-              quad->set_line_orientation(3,q->second.second[3]);
-
-
-              // now set the iterator for
-              // this quad
-              q->second.first = quad;
+              quad->set_line_orientation(0,quad_line_orientations[q][0]);
+              quad->set_line_orientation(1,quad_line_orientations[q][1]);
+              quad->set_line_orientation(2,quad_line_orientations[q][2]);
+              quad->set_line_orientation(3,quad_line_orientations[q][3]);
             }
         }
 
@@ -2512,8 +2765,10 @@ namespace internal
 
         // store for each quad index the
         // adjacent cells
-        std::map<int,std::vector<typename Triangulation<dim,spacedim>::cell_iterator> >
-        adjacent_cells;
+        std::vector<unsigned int>                n_adjacent_cells;
+        std::vector<std::array<unsigned int,2> > adjacent_cells;
+        find_adjacent_cells (quad_indices, GeometryInfo<dim>::faces_per_cell,
+                             needed_quads.size(), n_adjacent_cells, adjacent_cells);
 
         // finally make up cells
         {
@@ -2524,32 +2779,13 @@ namespace internal
               // first find for each of
               // the cells the quad
               // iterator of the
-              // respective faces.
-              //
-              // to this end, set up the
-              // lines of this cell and
-              // find the quads that are
-              // bounded by these lines;
-              // these are then the faces
-              // of the present cell
-              std::pair<int,int> line_list[GeometryInfo<dim>::lines_per_cell],
-                  inverse_line_list[GeometryInfo<dim>::lines_per_cell];
-              unsigned int face_line_list[4];
-              for (unsigned int line=0; line<GeometryInfo<dim>::lines_per_cell; ++line)
-                {
-                  line_list[line]=std::make_pair(
-                                    cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)],
-                                    cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)]);
-                  inverse_line_list[line]=std::pair<int,int> (
-                                            cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 1)],
-                                            cells[c].vertices[GeometryInfo<dim>::line_to_cell_vertices(line, 0)]);
-                }
-
-              // get the iterators
-              // corresponding to the
-              // faces. also store
+              // respective faces, and
               // whether they are
-              // reversed or not
+              // reversed or not. to
+              // this end, find the
+              // variant of the face as
+              // seen from this cell that
+              // coincides with the quad
               typename Triangulation<dim,spacedim>::quad_iterator
               face_iterator[GeometryInfo<dim>::faces_per_cell];
               bool face_orientation[GeometryInfo<dim>::faces_per_cell];
@@ -2557,117 +2793,27 @@ namespace internal
               bool face_rotation[GeometryInfo<dim>::faces_per_cell];
               for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
                 {
-                  for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_face; ++l)
-                    if (needed_lines.find (inverse_line_list[GeometryInfo<dim>::
-                                                             face_to_cell_lines(face,l)]) == needed_lines.end())
-                      face_line_list[l]=needed_lines[line_list[GeometryInfo<dim>::
-                                                               face_to_cell_lines(face,l)]]->index();
-                    else
-                      face_line_list[l]=needed_lines[inverse_line_list[GeometryInfo<dim>::
-                                                                       face_to_cell_lines(face,l)]]->index();
-
-                  internal::Triangulation::TriaObject<2>
-                  quad(face_line_list[0],
-                       face_line_list[1],
-                       face_line_list[2],
-                       face_line_list[3]);
-
-                  if (needed_quads.find (quad) != needed_quads.end())
-                    {
-                      // face is in standard
-                      // orientation (and not
-                      // flipped or rotated). this
-                      // must be true for at least
-                      // one of the two cells
-                      // containing this face
-                      // (i.e. for the cell which
-                      // originally inserted the
-                      // face)
-                      face_iterator[face] = needed_quads[quad].first;
-                      face_orientation[face] = true;
-                      face_flip[face]=false;
-                      face_rotation[face]=false;
-                    }
-                  else
-                    {
-                      // face must be available in
-                      // reverse order
-                      // then. construct all
-                      // possibilities and check
-                      // them one after the other
-                      const internal::Triangulation::TriaObject<2>
-                      test_quad_1(quad.face(2), quad.face(3),
-                                  quad.face(0), quad.face(1)),//face_orientation=false, face_flip=false, face_rotation=false
-                                            test_quad_2(quad.face(0), quad.face(1),
-                                                        quad.face(3), quad.face(2)),//face_orientation=false, face_flip=false, face_rotation=true
-                                            test_quad_3(quad.face(3), quad.face(2),
-                                                        quad.face(1), quad.face(0)),//face_orientation=false, face_flip=true,  face_rotation=false
-                                            test_quad_4(quad.face(1), quad.face(0),
-                                                        quad.face(2), quad.face(3)),//face_orientation=false, face_flip=true,  face_rotation=true
-                                            test_quad_5(quad.face(2), quad.face(3),
-                                                        quad.face(1), quad.face(0)),//face_orientation=true,  face_flip=false, face_rotation=true
-                                            test_quad_6(quad.face(1), quad.face(0),
-                                                        quad.face(3), quad.face(2)),//face_orientation=true,  face_flip=true,  face_rotation=false
-                                            test_quad_7(quad.face(3), quad.face(2),
-                                                        quad.face(0), quad.face(1));//face_orientation=true,  face_flip=true,  face_rotation=true
-                      if (needed_quads.find (test_quad_1) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_1].first;
-                          face_orientation[face] = false;
-                          face_flip[face]=false;
-                          face_rotation[face]=false;
-                        }
-                      else if (needed_quads.find (test_quad_2) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_2].first;
-                          face_orientation[face] = false;
-                          face_flip[face]=false;
-                          face_rotation[face]=true;
-                        }
-                      else if (needed_quads.find (test_quad_3) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_3].first;
-                          face_orientation[face] = false;
-                          face_flip[face]=true;
-                          face_rotation[face]=false;
-                        }
-                      else if (needed_quads.find (test_quad_4) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_4].first;
-                          face_orientation[face] = false;
-                          face_flip[face]=true;
-                          face_rotation[face]=true;
-                        }
-                      else if (needed_quads.find (test_quad_5) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_5].first;
-                          face_orientation[face] = true;
-                          face_flip[face]=false;
-                          face_rotation[face]=true;
-                        }
-                      else if (needed_quads.find (test_quad_6) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_6].first;
-                          face_orientation[face] = true;
-                          face_flip[face]=true;
-                          face_rotation[face]=false;
-                        }
-                      else if (needed_quads.find (test_quad_7) != needed_quads.end())
-                        {
-                          face_iterator[face] = needed_quads[test_quad_7].first;
-                          face_orientation[face] = true;
-                          face_flip[face]=true;
-                          face_rotation[face]=true;
-                        }
-
-                      else
-                        // we didn't find the
-                        // face in any direction,
-                        // so something went
-                        // wrong above
-                        Assert(false,ExcInternalError());
-
-                    }
+                  const unsigned int quad_index
+                    = quad_indices[c*GeometryInfo<dim>::faces_per_cell+face];
+                  const std::array<internal::Triangulation::TriaObject<2>,8>
+                  variants = quad_variants (face_lines (line_indices, c, face));
+
+                  unsigned int variant = 0;
+                  while ((variant < 8) &&
+                         !same_quad (variants[variant], needed_quads[quad_index]))
+                    ++variant;
+                  // we must have found the
+                  // face in one of its
+                  // variants
+                  Assert (variant < 8, ExcInternalError());
+
+                  face_iterator[face]
+                    = typename Triangulation<dim,spacedim>::quad_iterator (&triangulation, 0,
+                                                                           quad_index);
+                  const std::array<bool,3> orientation = quad_variant_orientation (variant);
+                  face_orientation[face] = orientation[0];
+                  face_flip[face]        = orientation[1];
+                  face_rotation[face]    = orientation[2];
                 }// for all faces
 
               // make the cell out of
@@ -2697,12 +2843,6 @@ namespace internal
                 }
 
 
-              // note that this cell is
-              // adjacent to the six
-              // quads
-              for (unsigned int quad=0; quad<GeometryInfo<dim>::faces_per_cell; ++quad)
-                adjacent_cells[face_iterator[quad]->index()].push_back (cell);
-
 #ifdef DEBUG
               // make some checks on the
               // lines and their
@@ -2768,7 +2908,7 @@ namespace internal
         for (typename Triangulation<dim,spacedim>::quad_iterator
              quad=triangulation.begin_quad(); quad!=triangulation.end_quad(); ++quad)
           {
-            const unsigned int n_adj_cells = adjacent_cells[quad->index()].size();
+            const unsigned int n_adj_cells = n_adjacent_cells[quad->index()];
             // assert that every quad has
             // one or two adjacent cells
             AssertThrow ((n_adj_cells >= 1) &&
@@ -2837,26 +2977,26 @@ namespace internal
           = subcelldata.boundary_lines.end();
         for (; boundary_line!=end_boundary_line; ++boundary_line)
           {
-            typename Triangulation<dim,spacedim>::line_iterator line;
             std::pair <int, int> line_vertices(std::make_pair(boundary_line->vertices[0],
                                                               boundary_line->vertices[1]));
-            if (needed_lines.find(line_vertices) != needed_lines.end())
-              // line found in this
-              // direction
-              line = needed_lines[line_vertices];
-
-            else
+            unsigned int line_index = find_line (needed_lines,
+                                                 line_vertices.first,
+                                                 line_vertices.second);
+            if (line_index == numbers::invalid_unsigned_int)
               {
                 // look whether it exists in
                 // reverse direction
                 std::swap (line_vertices.first, line_vertices.second);
-                if (needed_lines.find(line_vertices) != needed_lines.end())
-                  line = needed_lines[line_vertices];
-                else
-                  // line does not exist
-                  AssertThrow (false, ExcLineInexistant(line_vertices.first,
-                                                        line_vertices.second));
+                line_index = find_line (needed_lines,
+                                        line_vertices.first,
+                                        line_vertices.second);
+                // line does not exist
+                AssertThrow (line_index != numbers::invalid_unsigned_int,
+                             ExcLineInexistant(line_vertices.first,
+                                               line_vertices.second));
               }
+            const typename Triangulation<dim,spacedim>::line_iterator
+            line (&triangulation, 0, line_index);
             // Assert that only exterior
             // lines are given a boundary
             // indicator
@@ -2906,21 +3046,25 @@ namespace internal
 
                 // check whether line
                 // already exists
-                if (needed_lines.find(line_vertices) != needed_lines.end())
-                  line[i] = needed_lines[line_vertices];
-                else
+                unsigned int line_index = find_line (needed_lines,
+                                                     line_vertices.first,
+                                                     line_vertices.second);
+                if (line_index == numbers::invalid_unsigned_int)
                   // look whether it exists
                   // in reverse direction
                   {
                     std::swap (line_vertices.first, line_vertices.second);
-                    if (needed_lines.find(line_vertices) != needed_lines.end())
-                      line[i] = needed_lines[line_vertices];
-                    else
-                      // line does
-                      // not exist
-                      AssertThrow (false, ExcLineInexistant(line_vertices.first,
-                                                            line_vertices.second));
+                    line_index = find_line (needed_lines,
+                                            line_vertices.first,
+                                            line_vertices.second);
+                    // line does
+                    // not exist
+                    AssertThrow (line_index != numbers::invalid_unsigned_int,
+                                 ExcLineInexistant(line_vertices.first,
+                                                   line_vertices.second));
                   }
+                line[i] = typename Triangulation<dim,spacedim>::line_iterator
+                          (&triangulation, 0, line_index);
               }
 
 
@@ -2966,8 +3110,8 @@ namespace internal
               line_counterclock[lex2cclock[i]]=line[i];
             unsigned int n_rotations=0;
             bool not_found_quad_1;
-            while ( (not_found_quad_1=(needed_quads.find(quad_compare_1) == needed_quads.end())) &&
-                    (                  needed_quads.find(quad_compare_2) == needed_quads.end()) &&
+            while ( (not_found_quad_1=(find_quad(needed_quads, quad_compare_1) == numbers::invalid_unsigned_int)) &&
+                    (                  find_quad(needed_quads, quad_compare_2) == numbers::invalid_unsigned_int) &&
                     (n_rotations<4))
               {
                 // use the rotate defined
@@ -2990,9 +3134,11 @@ namespace internal
                                            line[2]->index(), line[3]->index()));
 
             if (not_found_quad_1)
-              quad = needed_quads[quad_compare_2].first;
+              quad = typename Triangulation<dim,spacedim>::quad_iterator
+                     (&triangulation, 0, find_quad (needed_quads, quad_compare_2));
             else
-              quad = needed_quads[quad_compare_1].first;
+              quad = typename Triangulation<dim,spacedim>::quad_iterator
+                     (&triangulation, 0, find_quad (needed_quads, quad_compare_1));
 
             // check whether this face is
             // really an exterior one
@@ -3023,22 +3169,28 @@ namespace internal
         for (typename Triangulation<dim,spacedim>::cell_iterator
              cell=triangulation.begin(); cell!=triangulation.end(); ++cell)
           for (unsigned int face=0; face<6; ++face)
-            if (adjacent_cells[cell->quad(face)->index()][0] == cell)
-              // first adjacent cell is
-              // this one
-              {
-                if (adjacent_cells[cell->quad(face)->index()].size() == 2)
-                  // there is another
-                  // adjacent cell
-                  cell->set_neighbor (face,
-                                      adjacent_cells[cell->quad(face)->index()][1]);
-              }
-        // first adjacent cell is not this
-        // one, -> it must be the neighbor
-        // we are looking for
-            else
-              cell->set_neighbor (face,
-                                  adjacent_cells[cell->quad(face)->index()][0]);
+            {
+              const unsigned int quad
+                = quad_indices[cell->index()*GeometryInfo<dim>::faces_per_cell+face];
+              if (adjacent_cells[quad][0] == static_cast<unsigned int>(cell->index()))
+                // first adjacent cell is
+                // this one
+                {
+                  if (n_adjacent_cells[quad] == 2)
+                    // there is another
+                    // adjacent cell
+                    cell->set_neighbor (face,
+                                        typename Triangulation<dim,spacedim>::cell_iterator
+                                        (&triangulation, 0, adjacent_cells[quad][1]));
+                }
+              // first adjacent cell is not this
+              // one, -> it must be the neighbor
+              // we are looking for
+              else
+                cell->set_neighbor (face,
+                                    typename Triangulation<dim,spacedim>::cell_iterator
+                                    (&triangulation, 0, adjacent_cells[quad][0]));
+            }
       }
 
 
@@ -3611,14 +3763,14 @@ namespace internal
                           const int switch_1_index=switch_1->index();
                           const int switch_2_index=switch_2->index();
                           for (unsigned int l=0; l<triangulation.levels.size(); ++l)
-                            for (unsigned int h=0; h<triangulation.levels[l]->cells.cells.size(); ++h)
+                            for (unsigned int h=0; h<triangulation.levels[l]->cells.records.size(); ++h)
                               for (unsigned int q=0; q<GeometryInfo<dim>::faces_per_cell; ++q)
                                 {
-                                  const int index=triangulation.levels[l]->cells.cells[h].face(q);
+                                  const int index=triangulation.levels[l]->cells.records[h].object.face(q);
                                   if (index==switch_1_index)
-                                    triangulation.levels[l]->cells.cells[h].set_face(q,switch_2_index);
+                                    triangulation.levels[l]->cells.records[h].object.set_face(q,switch_2_index);
                                   else if (index==switch_2_index)
-                                    triangulation.levels[l]->cells.cells[h].set_face(q,switch_1_index);
+                                    triangulation.levels[l]->cells.records[h].object.set_face(q,switch_1_index);
                                 }
                           // now we have to copy
                           // all information of the
@@ -3837,6 +3989,141 @@ namespace internal
       }
 
 
+      /**
+       * Compute the locations of the new vertices of the objects given
+       * by @p objects, by calling @p compute_vertex for each of them.
+       *
+       * The new vertices of different objects are independent of each
+       * other, and evaluating the manifold descriptions is usually the
+       * most expensive part of the refinement. This function
+       * therefore works on the objects in parallel, whereas the
+       * actual creation of the new objects afterwards is done
+       * sequentially: the places where new objects are stored are
+       * found by searching for the next free slot, and keeping this
+       * search sequential ensures that the refined triangulation is
+       * the same, independent of the number of threads. Since each
+       * location is computed by the same function as in the
+       * sequential case, also the vertex locations do not depend on
+       * the number of threads.
+       *
+       * The manifold descriptions are evaluated concurrently only if all
+       * manifolds attached to the triangulation declare through
+       * Manifold::is_thread_safe() that this is allowed. Otherwise, the
+       * vertices are computed one after the other.
+       */
+      template <int dim, int spacedim, typename IteratorType, typename FunctionType>
+      static
+      std::vector<Point<spacedim> >
+      compute_new_vertices (const Triangulation<dim,spacedim> &triangulation,
+                            const std::vector<IteratorType>   &objects,
+                            const FunctionType                &compute_vertex)
+      {
+        bool thread_safe = true;
+        for (const auto &manifold : triangulation.manifold)
+          if (manifold.second->is_thread_safe() == false)
+            thread_safe = false;
+
+        std::vector<Point<spacedim> > new_vertices (objects.size());
+        const auto compute_range = [&] (const unsigned int begin,
+                                        const unsigned int end)
+        {
+          for (unsigned int i=begin; i<end; ++i)
+            new_vertices[i] = compute_vertex (objects[i]);
+        };
+        if (thread_safe)
+          parallel::apply_to_subranges
+          (0U, static_cast<unsigned int>(objects.size()), compute_range, 32);
+        else
+          compute_range (0U, static_cast<unsigned int>(objects.size()));
+        return new_vertices;
+      }
+
+
+
+      /**
+       * Compute the location of the vertex in the center of a 2d cell
+       * that is refined isotropically. This function only reads from
+       * the triangulation, and may therefore be called for several
+       * cells concurrently. It must be called after the lines of the
+       * cell have been refined.
+       */
+      template <int spacedim>
+      static
+      Point<spacedim>
+      compute_new_center_vertex (const typename Triangulation<2,spacedim>::cell_iterator &cell)
+      {
+        const unsigned int dim = 2;
+
+        // if this quad lives in 2d, then we can compute the new
+        // central vertex location just from the surrounding ones. If
+        // this is not the case, then we need to ask a boundary object
+        if (dim == spacedim)
+          {
+            // if the cell is at the boundary, use a different
+            // calculation of the middle vertex here. this is of
+            // advantage, if the boundary is strongly curved and the
+            // cell has a high aspect ratio. this can happen for
+            // example, if it was refined anisotropically before.
+            if (cell->at_boundary())
+              {
+                // if only one face is at the boundary, set the new
+                // middle vertex in a different way to avoid some
+                // mis-shaped elements if the new point on the
+                // boundary is not where we expect it, especially if
+                // it is to far inside the current cell
+                unsigned int boundary_face=GeometryInfo<dim>::faces_per_cell;
+                for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
+                  if (cell->face(face)->at_boundary())
+                    {
+                      if (boundary_face == GeometryInfo<dim>::faces_per_cell)
+                        // no boundary face found so far, so set it now
+                        boundary_face=face;
+                      else
+                        // there is another boundary face, so reset
+                        // boundary_face to invalid value as a flag to
+                        // do nothing in the following
+                        boundary_face=GeometryInfo<dim>::faces_per_cell+1;
+                    }
+
+                if (boundary_face<GeometryInfo<dim>::faces_per_cell)
+                  // return the middle of the straight connection
+                  // between the new points on this face and on the
+                  // opposite face, as returned by the underlying
+                  // manifold object.
+                  {
+                    std::vector<Point<spacedim> > ps(2);
+                    std::vector<double> ws(2, 0.5);
+                    ps[0] = cell->face(boundary_face)
+                            ->child(0)->vertex(1);
+                    ps[1] = cell->face(GeometryInfo<dim>
+                                       ::opposite_face[boundary_face])
+                            ->child(0)->vertex(1);
+                    return cell->get_manifold().get_new_point(ps,ws);
+                  }
+              }
+
+            return cell->center(true);
+          }
+        else
+          {
+            // if this quad lives in a higher dimensional space then
+            // we don't need to worry if it is at the boundary of the
+            // manifold -- we always have to use the boundary object
+            // anyway.
+
+            // An assert to make sure that the static_cast in the
+            // next line has the chance to give reasonable results.
+            Assert(cell->material_id()<= std::numeric_limits<types::material_id>::max(),
+                   ExcIndexRange(cell->material_id(),0,std::numeric_limits<types::material_id>::max()));
+
+            // new vertex is placed on the surface according to the
+            // information stored in the boundary class
+            return cell->center(true);
+          }
+      }
+
+
+
       /**
        * Create the children of a 2d
        * cell. The arguments indicate
@@ -3853,6 +4140,10 @@ namespace internal
        * lines, quads and cells have to
        * be passed, which point at (or
        * "before") the reserved space.
+       *
+       * If the cell is refined isotropically, @p new_center_vertex is
+       * the location of the new vertex in its center as computed by
+       * compute_new_center_vertex().
        */
       template <int spacedim>
       static
@@ -3861,7 +4152,8 @@ namespace internal
                        unsigned int &next_unused_vertex,
                        typename Triangulation<2,spacedim>::raw_line_iterator &next_unused_line,
                        typename Triangulation<2,spacedim>::raw_cell_iterator &next_unused_cell,
-                       typename Triangulation<2,spacedim>::cell_iterator &cell)
+                       typename Triangulation<2,spacedim>::cell_iterator &cell,
+                       const Point<spacedim> &new_center_vertex)
       {
         const unsigned int dim=2;
         // clear refinement flag
@@ -3985,97 +4277,13 @@ namespace internal
 
             new_vertices[8] = next_unused_vertex;
 
-            // if this quad lives
-            // in 2d, then we can
-            // compute the new
-            // central vertex
-            // location just from
-            // the surrounding
-            // ones. If this is
-            // not the case, then
-            // we need to ask a
-            // boundary object
-            if (dim == spacedim)
-              {
-                // triangulation.vertices[next_unused_vertex] = new_point;
-                triangulation.vertices[next_unused_vertex] = cell->center(true);
-
-                // if the user_flag is set, i.e. if the
-                // cell is at the boundary, use a
-                // different calculation of the middle
-                // vertex here. this is of advantage, if
-                // the boundary is strongly curved and
-                // the cell has a high aspect ratio. this
-                // can happen for example, if it was
-                // refined anisotropically before.
-                if (cell->user_flag_set())
-                  {
-                    // first reset the user_flag
-                    cell->clear_user_flag();
-                    // the user flag indicates: at least
-                    // one face is at the boundary. if it
-                    // is only one, set the new middle
-                    // vertex in a different way to avoid
-                    // some mis-shaped elements if the
-                    // new point on the boundary is not
-                    // where we expect it, especially if
-                    // it is to far inside the current
-                    // cell
-                    unsigned int boundary_face=GeometryInfo<dim>::faces_per_cell;
-                    for (unsigned int face=0; face<GeometryInfo<dim>::faces_per_cell; ++face)
-                      if (cell->face(face)->at_boundary())
-                        {
-                          if (boundary_face == GeometryInfo<dim>::faces_per_cell)
-                            // no boundary face found so
-                            // far, so set it now
-                            boundary_face=face;
-                          else
-                            // there is another boundary
-                            // face, so reset boundary_face to
-                            // invalid value as a flag to
-                            // do nothing in the following
-                            boundary_face=GeometryInfo<dim>::faces_per_cell+1;
-                        }
+            // the location of the new vertex has been computed
+            // before, see compute_new_center_vertex()
+            triangulation.vertices[next_unused_vertex] = new_center_vertex;
 
-                    if (boundary_face<GeometryInfo<dim>::faces_per_cell)
-                      // reset the cell's middle vertex to the middle
-                      // of the straight connection between the new
-                      // points on this face and on the opposite face,
-                      // as returned by the underlying manifold
-                      // object.
-                      {
-                        std::vector<Point<spacedim> > ps(2);
-                        std::vector<double> ws(2, 0.5);
-                        ps[0] = cell->face(boundary_face)
-                                ->child(0)->vertex(1);
-                        ps[1] = cell->face(GeometryInfo<dim>
-                                           ::opposite_face[boundary_face])
-                                ->child(0)->vertex(1);
-                        triangulation.vertices[next_unused_vertex]
-                          = cell->get_manifold().get_new_point(ps,ws);
-                      }
-                  }
-              }
-            else
-              {
-                // if this quad lives in a higher dimensional space
-                // then we don't need to worry if it is at the
-                // boundary of the manifold -- we always have to use
-                // the boundary object anyway; so ignore whether the
-                // user flag is set or not
-                cell->clear_user_flag();
-
-                // An assert to make sure that the static_cast in the
-                // next line has the chance to give reasonable
-                // results.
-                Assert(cell->material_id()<= std::numeric_limits<types::material_id>::max(),
-                       ExcIndexRange(cell->material_id(),0,std::numeric_limits<types::material_id>::max()));
-
-                // new vertex is placed on the surface according to
-                // the information stored in the boundary class
-                triangulation.vertices[next_unused_vertex] =
-                  cell->center(true);
-              }
+            // the user flag was set in execute_refinement() if the
+            // cell is at the boundary and is not needed any more
+            cell->clear_user_flag();
           }
 
 
@@ -4368,10 +4576,10 @@ namespace internal
 
             // count number of used cells
             // on the next higher level
-            const unsigned int used_cells
-              =  std::count_if (triangulation.levels[level+1]->cells.used.begin(),
-                                triangulation.levels[level+1]->cells.used.end(),
-                                std::bind (std::equal_to<bool>(), std::placeholders::_1, true));
+            unsigned int used_cells = 0;
+            for (unsigned int c=0; c<triangulation.levels[level+1]->cells.records.size(); ++c)
+              if (triangulation.levels[level+1]->cells.records[c].used)
+                ++used_cells;
 
             // reserve space for the used_cells cells already existing
             // on the next higher level as well as for the
@@ -4691,10 +4899,10 @@ namespace internal
 
 
             // count number of used cells on the next higher level
-            const unsigned int used_cells
-              = std::count_if (triangulation.levels[level+1]->cells.used.begin(),
-                               triangulation.levels[level+1]->cells.used.end(),
-                               std::bind (std::equal_to<bool>(), std::placeholders::_1, true));
+            unsigned int used_cells = 0;
+            for (unsigned int c=0; c<triangulation.levels[level+1]->cells.records.size(); ++c)
+              if (triangulation.levels[level+1]->cells.records[c].used)
+                ++used_cells;
 
 
             // reserve space for the used_cells cells already existing
@@ -4751,108 +4959,122 @@ namespace internal
         // pairwise
         if (true)
           {
-            // only active objects can be refined further
-            typename Triangulation<dim,spacedim>::active_line_iterator
-            line = triangulation.begin_active_line(),
-            endl = triangulation.end_line();
-            typename Triangulation<dim,spacedim>::raw_line_iterator
-            next_unused_line = triangulation.begin_raw_line ();
-
-            for (; line!=endl; ++line)
+            // only active objects can be refined further. collect
+            // the lines that need to be refined and compute the new
+            // vertices in their middle in parallel
+            std::vector<typename Triangulation<dim,spacedim>::active_line_iterator>
+            lines_to_refine;
+            for (typename Triangulation<dim,spacedim>::active_line_iterator
+                 line = triangulation.begin_active_line();
+                 line!=triangulation.end_line(); ++line)
               if (line->user_flag_set())
-                {
-                  // this line needs to be refined
+                lines_to_refine.push_back (line);
 
-                  // find the next unused vertex and set it
-                  // appropriately
-                  while (triangulation.vertices_used[next_unused_vertex] == true)
-                    ++next_unused_vertex;
-                  Assert (next_unused_vertex < triangulation.vertices.size(),
-                          ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
-                  triangulation.vertices_used[next_unused_vertex] = true;
+            const std::vector<Point<spacedim> > new_line_vertices
+              = compute_new_vertices
+                (triangulation, lines_to_refine,
+                 [&triangulation] (const typename Triangulation<dim,spacedim>::active_line_iterator &line)
+                 -> Point<spacedim>
+            {
+              if (spacedim == dim)
+                // for the case of a domain in an equal-dimensional
+                // space we only have to treat boundary lines
+                // differently; for interior lines we can compute the
+                // midpoint as the mean of the two vertices: if
+                // (line->at_boundary())
+                return line->center(true);
+              else
+                // however, if spacedim>dim, we always have to ask the
+                // boundary object for its answer. We use the same
+                // object of the cell (which was stored in
+                // line->user_index() before) unless a manifold_id has
+                // been set on this very line.
+                if (line->manifold_id() == numbers::invalid_manifold_id)
+                  return triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
+                else
+                  return line->center(true);
+            });
+
+            typename Triangulation<dim,spacedim>::raw_line_iterator
+            next_unused_line = triangulation.begin_raw_line ();
+            const typename Triangulation<dim,spacedim>::raw_line_iterator
+            endl = triangulation.end_line();
 
-                  if (spacedim == dim)
+            for (unsigned int l=0; l<lines_to_refine.size(); ++l)
+              {
+                // this line needs to be refined
+                const typename Triangulation<dim,spacedim>::active_line_iterator
+                &line = lines_to_refine[l];
+
+                // find the next unused vertex and set it
+                // appropriately
+                while (triangulation.vertices_used[next_unused_vertex] == true)
+                  ++next_unused_vertex;
+                Assert (next_unused_vertex < triangulation.vertices.size(),
+                        ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
+                triangulation.vertices_used[next_unused_vertex] = true;
+
+                triangulation.vertices[next_unused_vertex] = new_line_vertices[l];
+
+                // now that we created the right point, make up the
+                // two child lines.  To this end, find a pair of
+                // unused lines
+                bool pair_found=false;
+                (void)pair_found;
+                for (; next_unused_line!=endl; ++next_unused_line)
+                  if (!next_unused_line->used() &&
+                      !(++next_unused_line)->used())
                     {
-                      // for the case of a domain in an
-                      // equal-dimensional space we only have to treat
-                      // boundary lines differently; for interior
-                      // lines we can compute the midpoint as the mean
-                      // of the two vertices: if (line->at_boundary())
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
+                      // go back to the first of the two unused
+                      // lines
+                      --next_unused_line;
+                      pair_found=true;
+                      break;
                     }
-                  else
-                    // however, if spacedim>dim, we always have to ask
-                    // the boundary object for its answer. We use the
-                    // same object of the cell (which was stored in
-                    // line->user_index() before) unless a manifold_id
-                    // has been set on this very line.
-                    if (line->manifold_id() == numbers::invalid_manifold_id)
-                      triangulation.vertices[next_unused_vertex]
-                        = triangulation.get_manifold(line->user_index()).get_new_point_on_line (line);
-                    else
-                      triangulation.vertices[next_unused_vertex]
-                        = line->center(true);
-
-                  // now that we created the right point, make up the
-                  // two child lines.  To this end, find a pair of
-                  // unused lines
-                  bool pair_found=false;
-                  (void)pair_found;
-                  for (; next_unused_line!=endl; ++next_unused_line)
-                    if (!next_unused_line->used() &&
-                        !(++next_unused_line)->used())
-                      {
-                        // go back to the first of the two unused
-                        // lines
-                        --next_unused_line;
-                        pair_found=true;
-                        break;
-                      }
-                  Assert (pair_found, ExcInternalError());
-
-                  // there are now two consecutive unused lines, such
-                  // that the children of a line will be consecutive.
-                  // then set the child pointer of the present line
-                  line->set_children (0, next_unused_line->index());
-
-                  // set the two new lines
-                  const typename Triangulation<dim,spacedim>::raw_line_iterator
-                  children[2] = { next_unused_line,
-                                  ++next_unused_line
-                                };
-                  // some tests; if any of the iterators should be
-                  // invalid, then already dereferencing will fail
-                  Assert (children[0]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-                  Assert (children[1]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-
-                  children[0]->set (internal::Triangulation
-                                    ::TriaObject<1>(line->vertex_index(0),
-                                                    next_unused_vertex));
-                  children[1]->set (internal::Triangulation
-                                    ::TriaObject<1>(next_unused_vertex,
-                                                    line->vertex_index(1)));
-
-                  children[0]->set_used_flag();
-                  children[1]->set_used_flag();
-                  children[0]->clear_children();
-                  children[1]->clear_children();
-                  children[0]->clear_user_data();
-                  children[1]->clear_user_data();
-                  children[0]->clear_user_flag();
-                  children[1]->clear_user_flag();
-
-
-                  children[0]->set_boundary_id_internal(line->boundary_id());
-                  children[1]->set_boundary_id_internal(line->boundary_id());
-
-                  children[0]->set_manifold_id (line->manifold_id());
-                  children[1]->set_manifold_id (line->manifold_id());
-
-                  // finally clear flag indicating the need for
-                  // refinement
-                  line->clear_user_flag ();
-                }
+                Assert (pair_found, ExcInternalError());
+
+                // there are now two consecutive unused lines, such
+                // that the children of a line will be consecutive.
+                // then set the child pointer of the present line
+                line->set_children (0, next_unused_line->index());
+
+                // set the two new lines
+                const typename Triangulation<dim,spacedim>::raw_line_iterator
+                children[2] = { next_unused_line,
+                                ++next_unused_line
+                              };
+                // some tests; if any of the iterators should be
+                // invalid, then already dereferencing will fail
+                Assert (children[0]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
+                Assert (children[1]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
+
+                children[0]->set (internal::Triangulation
+                                  ::TriaObject<1>(line->vertex_index(0),
+                                                  next_unused_vertex));
+                children[1]->set (internal::Triangulation
+                                  ::TriaObject<1>(next_unused_vertex,
+                                                  line->vertex_index(1)));
+
+                children[0]->set_used_flag();
+                children[1]->set_used_flag();
+                children[0]->clear_children();
+                children[1]->clear_children();
+                children[0]->clear_user_data();
+                children[1]->clear_user_data();
+                children[0]->clear_user_flag();
+                children[1]->clear_user_flag();
+
+
+                children[0]->set_boundary_id_internal(line->boundary_id());
+                children[1]->set_boundary_id_internal(line->boundary_id());
+
+                children[0]->set_manifold_id (line->manifold_id());
+                children[1]->set_manifold_id (line->manifold_id());
+
+                // finally clear flag indicating the need for
+                // refinement
+                line->clear_user_flag ();
+              }
           }
 
 
@@ -4871,6 +5093,23 @@ namespace internal
         typename Triangulation<dim,spacedim>::raw_line_iterator
         next_unused_line = triangulation.begin_raw_line ();
 
+        // compute the new vertices in the centers of the cells that
+        // are refined isotropically in parallel. the loop below visits
+        // these cells in the same order, since the children it creates
+        // are not flagged for refinement
+        std::vector<typename Triangulation<dim,spacedim>::cell_iterator>
+        cells_to_refine_isotropically;
+        for (typename Triangulation<dim,spacedim>::active_cell_iterator
+             cell = triangulation.begin_active(); cell!=triangulation.end(); ++cell)
+          if (cell->refine_flag_set() == RefinementCase<dim>::cut_xy)
+            cells_to_refine_isotropically.push_back (cell);
+
+        const std::vector<Point<spacedim> > new_center_vertices
+          = compute_new_vertices
+            (triangulation, cells_to_refine_isotropically,
+             &compute_new_center_vertex<spacedim>);
+        unsigned int next_center_vertex = 0;
+
         for (int level=0; level<static_cast<int>(triangulation.levels.size())-1; ++level)
           {
 
@@ -4895,13 +5134,23 @@ namespace internal
                   if (cell->at_boundary())
                     cell->set_user_flag();
 
+                  Point<spacedim> new_center_vertex;
+                  if (cell->refine_flag_set() == RefinementCase<dim>::cut_xy)
+                    {
+                      Assert (cells_to_refine_isotropically[next_center_vertex]
+                              == cell, ExcInternalError());
+                      new_center_vertex = new_center_vertices[next_center_vertex];
+                      ++next_center_vertex;
+                    }
+
                   // actually set up the children and update neighbor
                   // information
                   create_children (triangulation,
                                    next_unused_vertex,
                                    next_unused_line,
                                    next_unused_cell,
-                                   cell);
+                                   cell,
+                                   new_center_vertex);
 
                   if ((check_for_distorted_cells == true)
                       &&
@@ -5097,10 +5346,10 @@ namespace internal
 
 
             // count number of used cells on the next higher level
-            const unsigned int used_cells
-              = std::count_if (triangulation.levels[level+1]->cells.used.begin(),
-                               triangulation.levels[level+1]->cells.used.end(),
-                               std::bind (std::equal_to<bool>(), std::placeholders::_1, true));
+            unsigned int used_cells = 0;
+            for (unsigned int c=0; c<triangulation.levels[level+1]->cells.records.size(); ++c)
+              if (triangulation.levels[level+1]->cells.records[c].used)
+                ++used_cells;
 
 
             // reserve space for the used_cells cells already existing
@@ -5220,79 +5469,94 @@ namespace internal
         // first for lines
         if (true)
           {
-            // only active objects can be refined further
-            typename Triangulation<dim,spacedim>::active_line_iterator
-            line = triangulation.begin_active_line(),
-            endl = triangulation.end_line();
-            typename Triangulation<dim,spacedim>::raw_line_iterator
-            next_unused_line = triangulation.begin_raw_line ();
-
-            for (; line!=endl; ++line)
+            // only active objects can be refined further. collect
+            // the lines that need to be refined and compute the new
+            // vertices in their middle in parallel
+            std::vector<typename Triangulation<dim,spacedim>::active_line_iterator>
+            lines_to_refine;
+            for (typename Triangulation<dim,spacedim>::active_line_iterator
+                 line = triangulation.begin_active_line();
+                 line!=triangulation.end_line(); ++line)
               if (line->user_flag_set())
-                {
-                  // this line needs to be refined
+                lines_to_refine.push_back (line);
 
-                  // find the next unused vertex and set it
-                  // appropriately
-                  while (triangulation.vertices_used[next_unused_vertex] == true)
-                    ++next_unused_vertex;
-                  Assert (next_unused_vertex < triangulation.vertices.size(),
-                          ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
-                  triangulation.vertices_used[next_unused_vertex] = true;
+            const std::vector<Point<spacedim> > new_line_vertices
+              = compute_new_vertices
+                (triangulation, lines_to_refine,
+                 [] (const typename Triangulation<dim,spacedim>::active_line_iterator &line)
+            {
+              return line->center(true);
+            });
 
-                  triangulation.vertices[next_unused_vertex]
-                    = line->center(true);
+            typename Triangulation<dim,spacedim>::raw_line_iterator
+            next_unused_line = triangulation.begin_raw_line ();
 
-                  // now that we created the right point, make up the
-                  // two child lines (++ takes care of the end of the
-                  // vector)
-                  next_unused_line=triangulation.faces->lines.next_free_pair_object(triangulation);
-                  Assert(next_unused_line.state() == IteratorState::valid,
-                         ExcInternalError());
+            for (unsigned int l=0; l<lines_to_refine.size(); ++l)
+              {
+                // this line needs to be refined
+                const typename Triangulation<dim,spacedim>::active_line_iterator
+                &line = lines_to_refine[l];
+
+                // find the next unused vertex and set it
+                // appropriately
+                while (triangulation.vertices_used[next_unused_vertex] == true)
+                  ++next_unused_vertex;
+                Assert (next_unused_vertex < triangulation.vertices.size(),
+                        ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
+                triangulation.vertices_used[next_unused_vertex] = true;
+
+                triangulation.vertices[next_unused_vertex] = new_line_vertices[l];
+
+                // now that we created the right point, make up the
+                // two child lines (++ takes care of the end of the
+                // vector)
+                next_unused_line=triangulation.faces->lines.next_free_pair_object(triangulation);
+                Assert(next_unused_line.state() == IteratorState::valid,
+                       ExcInternalError());
 
-                  // now we found two consecutive unused lines, such
-                  // that the children of a line will be consecutive.
-                  // then set the child pointer of the present line
-                  line->set_children (0, next_unused_line->index());
-
-                  // set the two new lines
-                  const typename Triangulation<dim,spacedim>::raw_line_iterator
-                  children[2] = { next_unused_line,
-                                  ++next_unused_line
-                                };
-
-                  // some tests; if any of the iterators should be
-                  // invalid, then already dereferencing will fail
-                  Assert (children[0]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-                  Assert (children[1]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
-
-                  children[0]->set (internal::Triangulation
-                                    ::TriaObject<1>(line->vertex_index(0),
-                                                    next_unused_vertex));
-                  children[1]->set (internal::Triangulation
-                                    ::TriaObject<1>(next_unused_vertex,
-                                                    line->vertex_index(1)));
-
-                  children[0]->set_used_flag();
-                  children[1]->set_used_flag();
-                  children[0]->clear_children();
-                  children[1]->clear_children();
-                  children[0]->clear_user_data();
-                  children[1]->clear_user_data();
-                  children[0]->clear_user_flag();
-                  children[1]->clear_user_flag();
-
-                  children[0]->set_boundary_id_internal(line->boundary_id());
-                  children[1]->set_boundary_id_internal(line->boundary_id());
-
-                  children[0]->set_manifold_id (line->manifold_id());
-                  children[1]->set_manifold_id (line->manifold_id());
-
-                  // finally clear flag
-                  // indicating the need
-                  // for refinement
-                  line->clear_user_flag ();
-                }
+                // now we found two consecutive unused lines, such
+                // that the children of a line will be consecutive.
+                // then set the child pointer of the present line
+                line->set_children (0, next_unused_line->index());
+
+                // set the two new lines
+                const typename Triangulation<dim,spacedim>::raw_line_iterator
+                children[2] = { next_unused_line,
+                                ++next_unused_line
+                              };
+
+                // some tests; if any of the iterators should be
+                // invalid, then already dereferencing will fail
+                Assert (children[0]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
+                Assert (children[1]->used() == false, ExcMessage("Internal error: We want to use a cell during refinement that should be unused, but turns out not to be."));
+
+                children[0]->set (internal::Triangulation
+                                  ::TriaObject<1>(line->vertex_index(0),
+                                                  next_unused_vertex));
+                children[1]->set (internal::Triangulation
+                                  ::TriaObject<1>(next_unused_vertex,
+                                                  line->vertex_index(1)));
+
+                children[0]->set_used_flag();
+                children[1]->set_used_flag();
+                children[0]->clear_children();
+                children[1]->clear_children();
+                children[0]->clear_user_data();
+                children[1]->clear_user_data();
+                children[0]->clear_user_flag();
+                children[1]->clear_user_flag();
+
+                children[0]->set_boundary_id_internal(line->boundary_id());
+                children[1]->set_boundary_id_internal(line->boundary_id());
+
+                children[0]->set_manifold_id (line->manifold_id());
+                children[1]->set_manifold_id (line->manifold_id());
+
+                // finally clear flag
+                // indicating the need
+                // for refinement
+                line->clear_user_flag ();
+              }
           }
 
 
@@ -5542,14 +5806,14 @@ namespace internal
 
                             // loop over all quads and replace the old
                             // lines
-                            for (unsigned int q=0; q<triangulation.faces->quads.cells.size(); ++q)
+                            for (unsigned int q=0; q<triangulation.faces->quads.records.size(); ++q)
                               for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_face; ++l)
                                 {
-                                  const int this_index=triangulation.faces->quads.cells[q].face(l);
+                                  const int this_index=triangulation.faces->quads.records[q].object.face(l);
                                   if (this_index==old_index_0)
-                                    triangulation.faces->quads.cells[q].set_face(l,new_index_0);
+                                    triangulation.faces->quads.records[q].object.set_face(l,new_index_0);
                                   else if (this_index==old_index_1)
-                                    triangulation.faces->quads.cells[q].set_face(l,new_index_1);
+                                    triangulation.faces->quads.records[q].object.set_face(l,new_index_1);
                                 }
                             // now we have to copy all information of
                             // the two lines
@@ -5622,14 +5886,14 @@ namespace internal
                             const int switch_1_index=switch_1->index();
                             const int switch_2_index=switch_2->index();
                             for (unsigned int l=0; l<triangulation.levels.size(); ++l)
-                              for (unsigned int h=0; h<triangulation.levels[l]->cells.cells.size(); ++h)
+                              for (unsigned int h=0; h<triangulation.levels[l]->cells.records.size(); ++h)
                                 for (unsigned int q=0; q<GeometryInfo<dim>::faces_per_cell; ++q)
                                   {
-                                    const int face_index=triangulation.levels[l]->cells.cells[h].face(q);
+                                    const int face_index=triangulation.levels[l]->cells.records[h].object.face(q);
                                     if (face_index==switch_1_index)
-                                      triangulation.levels[l]->cells.cells[h].set_face(q,switch_2_index);
+                                      triangulation.levels[l]->cells.records[h].object.set_face(q,switch_2_index);
                                     else if (face_index==switch_2_index)
-                                      triangulation.levels[l]->cells.cells[h].set_face(q,switch_1_index);
+                                      triangulation.levels[l]->cells.records[h].object.set_face(q,switch_1_index);
                                   }
                             // now we have to copy all information of
                             // the two quads
@@ -6064,6 +6328,30 @@ namespace internal
         typename Triangulation<3,spacedim>::DistortedCellList
         cells_with_distorted_children;
 
+        // compute the new vertices in the centers of the cells that
+        // are refined isotropically in parallel. the loop below visits
+        // these cells in the same order, since the children it creates
+        // are not flagged for refinement. the new vertex is definitely
+        // in the interior, so we need not worry about the
+        // boundary. However we need to worry about Manifolds. Let the
+        // cell compute its own center, by querying the underlying
+        // manifold object.
+        std::vector<typename Triangulation<dim,spacedim>::active_hex_iterator>
+        hexes_to_refine_isotropically;
+        for (typename Triangulation<dim,spacedim>::active_hex_iterator
+             hex = triangulation.begin_active_hex(); hex!=triangulation.end_hex(); ++hex)
+          if (hex->refine_flag_set() == RefinementCase<dim>::cut_xyz)
+            hexes_to_refine_isotropically.push_back (hex);
+
+        const std::vector<Point<spacedim> > new_center_vertices
+          = compute_new_vertices
+            (triangulation, hexes_to_refine_isotropically,
+             [] (const typename Triangulation<dim,spacedim>::active_hex_iterator &hex)
+        {
+          return hex->center(true, true);
+        });
+        unsigned int next_center_vertex = 0;
+
         for (unsigned int level=0; level!=triangulation.levels.size()-1; ++level)
           {
             // only active objects can be refined further; remember
@@ -8000,14 +8288,13 @@ namespace internal
                               ExcMessage("Internal error: During refinement, the triangulation wants to access an element of the 'vertices' array but it turns out that the array is not large enough."));
                       triangulation.vertices_used[next_unused_vertex] = true;
 
-                      // the new vertex is definitely in the interior,
-                      // so we need not worry about the
-                      // boundary. However we need to worry about
-                      // Manifolds. Let the cell compute its own
-                      // center, by querying the underlying manifold
-                      // object.
+                      // the location of the new vertex has been
+                      // computed above
+                      Assert (hexes_to_refine_isotropically[next_center_vertex]
+                              == hex, ExcInternalError());
                       triangulation.vertices[next_unused_vertex] =
-                        hex->center(true, true);
+                        new_center_vertices[next_center_vertex];
+                      ++next_center_vertex;
 
                       // set the data of the six lines.  first collect
                       // the indices of the seven vertices (consider
@@ -10657,14 +10944,14 @@ Triangulation<dim,spacedim>::last () const
   const unsigned int level = levels.size()-1;
 
   Assert (level<n_global_levels() || level<levels.size(), ExcInvalidLevel(level));
-  if (levels[level]->cells.cells.size() ==0)
+  if (levels[level]->cells.records.size() ==0)
     return end(level);
 
   // find the last raw iterator on
   // this level
   raw_cell_iterator ri (const_cast<Triangulation<dim,spacedim>*>(this),
                         level,
-                        levels[level]->cells.cells.size()-1);
+                        levels[level]->cells.records.size()-1);
 
   // then move to the last used one
   if (ri->used()==true)
@@ -10922,7 +11209,7 @@ Triangulation<dim, spacedim>::begin_raw_line (const unsigned int level) const
     case 1:
       Assert (level<n_global_levels() || level<levels.size(), ExcInvalidLevel(level));
 
-      if (level >= levels.size() || levels[level]->cells.cells.size() == 0)
+      if (level >= levels.size() || levels[level]->cells.records.size() == 0)
         return end_line();
 
       return raw_line_iterator (const_cast<Triangulation<dim,spacedim>*>(this),
@@ -10997,7 +11284,7 @@ Triangulation<dim,spacedim>::begin_raw_quad (const unsigned int level) const
     {
       Assert (level<n_global_levels() || level<levels.size(), ExcInvalidLevel(level));
 
-      if (level >= levels.size() || levels[level]->cells.cells.size() == 0)
+      if (level >= levels.size() || levels[level]->cells.records.size() == 0)
         return end_quad();
 
       return raw_quad_iterator (const_cast<Triangulation<dim,spacedim>*>(this),
@@ -11082,7 +11369,7 @@ Triangulation<dim,spacedim>::begin_raw_hex (const unsigned int level) const
     {
       Assert (level<n_global_levels() || level<levels.size(), ExcInvalidLevel(level));
 
-      if (level >= levels.size() || levels[level]->cells.cells.size() == 0)
+      if (level >= levels.size() || levels[level]->cells.records.size() == 0)
         return end_hex();
 
       return raw_hex_iterator (const_cast<Triangulation<dim,spacedim>*>(this),
@@ -11352,7 +11639,7 @@ template <>
 unsigned int Triangulation<1,1>::n_raw_lines (const unsigned int level) const
 {
   Assert(level < n_levels(), ExcIndexRange(level,0,n_levels()));
-  return levels[level]->cells.cells.size();
+  return levels[level]->cells.records.size();
 }
 
 
@@ -11369,7 +11656,7 @@ template <>
 unsigned int Triangulation<1,2>::n_raw_lines (const unsigned int level) const
 {
   Assert(level < n_levels(), ExcIndexRange(level,0,n_levels()));
-  return levels[level]->cells.cells.size();
+  return levels[level]->cells.records.size();
 }
 
 
@@ -11385,7 +11672,7 @@ template <>
 unsigned int Triangulation<1,3>::n_raw_lines (const unsigned int level) const
 {
   Assert(level < n_levels(), ExcIndexRange(level,0,n_levels()));
-  return levels[level]->cells.cells.size();
+  return levels[level]->cells.records.size();
 }
 
 template <>
@@ -11408,7 +11695,7 @@ unsigned int Triangulation<dim, spacedim>::n_raw_lines (const unsigned int) cons
 template <int dim, int spacedim>
 unsigned int Triangulation<dim, spacedim>::n_raw_lines () const
 {
-  return faces->lines.cells.size();
+  return faces->lines.records.size();
 }
 
 
@@ -11591,7 +11878,7 @@ template <>
 unsigned int Triangulation<2,2>::n_raw_quads (const unsigned int level) const
 {
   Assert(level < n_levels(), ExcIndexRange(level,0,n_levels()));
-  return levels[level]->cells.cells.size();
+  return levels[level]->cells.records.size();
 }
 
 
@@ -11600,7 +11887,7 @@ template <>
 unsigned int Triangulation<2,3>::n_raw_quads (const unsigned int level) const
 {
   Assert(level < n_levels(), ExcIndexRange(level,0,n_levels()));
-  return levels[level]->cells.cells.size();
+  return levels[level]->cells.records.size();
 }
 
 
@@ -11627,7 +11914,7 @@ unsigned int Triangulation<dim, spacedim>::n_raw_quads () const
 template <>
 unsigned int Triangulation<3,3>::n_raw_quads () const
 {
-  return faces->quads.cells.size();
+  return faces->quads.records.size();
 }
 
 
@@ -11711,7 +11998,7 @@ template <>
 unsigned int Triangulation<3,3>::n_raw_hexs (const unsigned int level) const
 {
   Assert(level < n_levels(), ExcIndexRange(level,0,n_levels()));
-  return levels[level]->cells.cells.size();
+  return levels[level]->cells.records.size();
 }
 
 
@@ -1080,7 +1080,7 @@ void
 TriaAccessor<structdim, dim, spacedim>::
 set (const internal::Triangulation::TriaObject<structdim> &object) const
 {
-  this->objects().cells[this->present_index] = object;
+  this->objects().records[this->present_index].object = object;
 }
 
 
@@ -1746,19 +1746,19 @@ void CellAccessor<dim, spacedim>::set_neighbor (const unsigned int i,
   if (pointer.state() == IteratorState::valid)
     {
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].first
+      cell_records[this->present_index].neighbors[i].first
         = pointer->present_level;
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].second
+      cell_records[this->present_index].neighbors[i].second
         = pointer->present_index;
     }
   else
     {
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].first
+      cell_records[this->present_index].neighbors[i].first
         = -1;
       this->tria->levels[this->present_level]->
-      neighbors[this->present_index*GeometryInfo<dim>::faces_per_cell+i].second
+      cell_records[this->present_index].neighbors[i].second
         = -1;
     };
 }
@@ -35,17 +35,10 @@ namespace internal
       //
       // note that all arrays should have equal sizes (checked by
       // @p{monitor_memory}
-      if (total_cells > refine_flags.size())
+      if (total_cells > cell_records.size())
         {
-          refine_flags.reserve (total_cells);
-          refine_flags.insert (refine_flags.end(),
-                               total_cells - refine_flags.size(),
-                               RefinementCase<dim>::no_refinement);
-
-          coarsen_flags.reserve (total_cells);
-          coarsen_flags.insert (coarsen_flags.end(),
-                                total_cells - coarsen_flags.size(),
-                                false);
+          cell_records.reserve (total_cells);
+          cell_records.resize (total_cells);
 
           active_cell_indices.reserve (total_cells);
           active_cell_indices.insert (active_cell_indices.end(),
@@ -76,11 +69,6 @@ namespace internal
           parents.insert (parents.end (),
                           (total_cells + 1) / 2 - parents.size (),
                           -1);
-
-          neighbors.reserve (total_cells*(2*dimension));
-          neighbors.insert (neighbors.end(),
-                            total_cells*(2*dimension) - neighbors.size(),
-                            std::make_pair(-1,-1));
         };
     }
 
@@ -90,10 +78,10 @@ namespace internal
     TriaLevel<dim>::monitor_memory (const unsigned int true_dimension) const
     {
       (void)true_dimension;
-      Assert (2*true_dimension*refine_flags.size() == neighbors.size(),
-              ExcMemoryInexact (refine_flags.size(), neighbors.size()));
-      Assert (2*true_dimension*coarsen_flags.size() == neighbors.size(),
-              ExcMemoryInexact (coarsen_flags.size(), neighbors.size()));
+      Assert (cell_records.size() == active_cell_indices.size(),
+              ExcMemoryInexact (cell_records.size(), active_cell_indices.size()));
+      Assert (cell_records.size() == subdomain_ids.size(),
+              ExcMemoryInexact (cell_records.size(), subdomain_ids.size()));
     }
 
 
@@ -101,10 +89,8 @@ namespace internal
     std::size_t
     TriaLevel<dim>::memory_consumption () const
     {
-      return (MemoryConsumption::memory_consumption (refine_flags) +
-              MemoryConsumption::memory_consumption (coarsen_flags) +
+      return (cell_records.capacity() * sizeof(CellRecord<dim>) + sizeof(cell_records) +
               MemoryConsumption::memory_consumption (active_cell_indices) +
-              MemoryConsumption::memory_consumption (neighbors) +
               MemoryConsumption::memory_consumption (subdomain_ids) +
               MemoryConsumption::memory_consumption (level_subdomain_ids) +
               MemoryConsumption::memory_consumption (parents) +
@@ -127,17 +113,10 @@ namespace internal
       //
       // note that all arrays should have equal
       // sizes (checked by @p{monitor_memory}
-      if (total_cells > refine_flags.size())
+      if (total_cells > cell_records.size())
         {
-          refine_flags.reserve (total_cells);
-          refine_flags.insert (refine_flags.end(),
-                               total_cells - refine_flags.size(),
-                               RefinementCase<3>::no_refinement);
-
-          coarsen_flags.reserve (total_cells);
-          coarsen_flags.insert (coarsen_flags.end(),
-                                total_cells - coarsen_flags.size(),
-                                false);
+          cell_records.reserve (total_cells);
+          cell_records.resize (total_cells);
 
           active_cell_indices.reserve (total_cells);
           active_cell_indices.insert (active_cell_indices.end(),
@@ -168,11 +147,6 @@ namespace internal
           parents.insert (parents.end (),
                           (total_cells + 1) / 2 - parents.size (),
                           -1);
-
-          neighbors.reserve (total_cells*(2*dimension));
-          neighbors.insert (neighbors.end(),
-                            total_cells*(2*dimension) - neighbors.size(),
-                            std::make_pair(-1,-1));
         };
     }
 
@@ -181,20 +155,18 @@ namespace internal
     TriaLevel<3>::monitor_memory (const unsigned int true_dimension) const
     {
       (void)true_dimension;
-      Assert (2*true_dimension*refine_flags.size() == neighbors.size(),
-              ExcMemoryInexact (refine_flags.size(), neighbors.size()));
-      Assert (2*true_dimension*coarsen_flags.size() == neighbors.size(),
-              ExcMemoryInexact (coarsen_flags.size(), neighbors.size()));
+      Assert (cell_records.size() == active_cell_indices.size(),
+              ExcMemoryInexact (cell_records.size(), active_cell_indices.size()));
+      Assert (cell_records.size() == subdomain_ids.size(),
+              ExcMemoryInexact (cell_records.size(), subdomain_ids.size()));
     }
 
 
     std::size_t
     TriaLevel<3>::memory_consumption () const
     {
-      return (MemoryConsumption::memory_consumption (refine_flags) +
-              MemoryConsumption::memory_consumption (coarsen_flags) +
+      return (cell_records.capacity() * sizeof(CellRecord<3>) + sizeof(cell_records) +
               MemoryConsumption::memory_consumption (active_cell_indices) +
-              MemoryConsumption::memory_consumption (neighbors) +
               MemoryConsumption::memory_consumption (subdomain_ids) +
               MemoryConsumption::memory_consumption (parents) +
               MemoryConsumption::memory_consumption (direction_flags) +
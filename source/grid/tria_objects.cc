@@ -19,9 +19,6 @@
 #include <deal.II/grid/tria_iterator.h>
 #include <deal.II/grid/tria_accessor.h>
 
-#include <algorithm>
-#include <functional>
-
 
 
 DEAL_II_NAMESPACE_OPEN
@@ -46,13 +43,13 @@ namespace internal
       unsigned int n_objects=0;
       unsigned int n_unused_pairs=0;
       unsigned int n_unused_singles=0;
-      for (unsigned int i=0; i<used.size(); ++i)
+      for (unsigned int i=0; i<records.size(); ++i)
         {
-          if (used[i])
+          if (records[i].used)
             ++n_objects;
-          else if (i+1<used.size())
+          else if (i+1<records.size())
             {
-              if (used[i+1])
+              if (records[i+1].used)
                 {
                   ++n_unused_singles;
                   if (next_free_single==0)
@@ -69,7 +66,7 @@ namespace internal
           else
             ++n_unused_singles;
         }
-      Assert(n_objects+2*n_unused_pairs+n_unused_singles==used.size(),
+      Assert(n_objects+2*n_unused_pairs+n_unused_singles==records.size(),
              ExcInternalError());
 
       // how many single objects are needed in addition to
@@ -78,44 +75,18 @@ namespace internal
         new_objects_single-n_unused_singles;
 
       unsigned int new_size=
-        used.size() + new_objects_in_pairs - 2*n_unused_pairs;
+        records.size() + new_objects_in_pairs - 2*n_unused_pairs;
       if (additional_single_objects>0)
         new_size+=additional_single_objects;
 
       // only allocate space if necessary
-      if (new_size>cells.size())
+      if (new_size>records.size())
         {
-          cells.reserve (new_size);
-          cells.insert (cells.end(),
-                        new_size-cells.size(),
-                        G ());
-
-          used.reserve (new_size);
-          used.insert (used.end(),
-                       new_size-used.size(),
-                       false);
-
-          user_flags.reserve (new_size);
-          user_flags.insert (user_flags.end(),
-                             new_size-user_flags.size(),
-                             false);
-
-          const unsigned int factor = GeometryInfo<G::dimension>::max_children_per_cell / 2;
-          children.reserve (factor*new_size);
-          children.insert (children.end(),
-                           factor*new_size-children.size(),
-                           -1);
-
-          if (G::dimension > 1)
-            {
-              refinement_cases.reserve (new_size);
-              refinement_cases.insert (refinement_cases.end(),
-                                       new_size - refinement_cases.size(),
-                                       RefinementCase<G::dimension>::no_refinement);
-            }
-
           // first reserve, then resize. Otherwise the std library can decide to allocate
           // more entries.
+          records.reserve (new_size);
+          records.resize (new_size);
+
           boundary_or_material_id.reserve (new_size);
           boundary_or_material_id.resize (new_size);
 
@@ -146,12 +117,12 @@ namespace internal
       // TODO: Think of a way to ensure that we are using the correct triangulation, i.e. the one containing *this.
 
       int pos=next_free_pair,
-          last=used.size()-1;
+          last=records.size()-1;
       for (; pos<last; ++pos)
-        if (!used[pos])
+        if (!records[pos].used)
           {
             // this should be a pair slot
-            Assert(!used[pos+1], ExcInternalError());
+            Assert(!records[pos+1].used, ExcInternalError());
             break;
           }
       if (pos>=last)
@@ -167,38 +138,21 @@ namespace internal
     void
     TriaObjectsHex::reserve_space (const unsigned int new_hexes)
     {
-      const unsigned int new_size = new_hexes +
-                                    std::count_if (used.begin(),
-                                                   used.end(),
-                                                   std::bind (std::equal_to<bool>(), std::placeholders::_1, true));
+      unsigned int new_size = new_hexes;
+      for (unsigned int i=0; i<records.size(); ++i)
+        if (records[i].used)
+          ++new_size;
 
       // see above...
-      if (new_size>cells.size())
+      if (new_size>records.size())
         {
-          cells.reserve (new_size);
-          cells.insert (cells.end(),
-                        new_size-cells.size(),
-                        TriaObject<3> ());
-
-          used.reserve (new_size);
-          used.insert (used.end(),
-                       new_size-used.size(),
-                       false);
-
-          user_flags.reserve (new_size);
-          user_flags.insert (user_flags.end(),
-                             new_size-user_flags.size(),
-                             false);
-
-          children.reserve (4*new_size);
-          children.insert (children.end(),
-                           4*new_size-children.size(),
-                           -1);
-
           // for the following fields, we know exactly how many elements
           // we need, so first reserve then resize (resize itself, at least
           // with some compiler libraries, appears to round up the size it
           // actually reserves)
+          records.reserve (new_size);
+          records.resize (new_size);
+
           boundary_or_material_id.reserve (new_size);
           boundary_or_material_id.resize (new_size);
 
@@ -210,27 +164,12 @@ namespace internal
           user_data.reserve (new_size);
           user_data.resize (new_size);
 
+          // faces are in standard orientation, not flipped and not rotated
           face_orientations.reserve (new_size * GeometryInfo<3>::faces_per_cell);
           face_orientations.insert (face_orientations.end(),
                                     new_size * GeometryInfo<3>::faces_per_cell
                                     - face_orientations.size(),
-                                    true);
-
-          refinement_cases.reserve (new_size);
-          refinement_cases.insert (refinement_cases.end(),
-                                   new_size-refinement_cases.size(),
-                                   RefinementCase<3>::no_refinement);
-
-          face_flips.reserve (new_size * GeometryInfo<3>::faces_per_cell);
-          face_flips.insert (face_flips.end(),
-                             new_size * GeometryInfo<3>::faces_per_cell
-                             - face_flips.size(),
-                             false);
-          face_rotations.reserve (new_size * GeometryInfo<3>::faces_per_cell);
-          face_rotations.insert (face_rotations.end(),
-                                 new_size * GeometryInfo<3>::faces_per_cell
-                                 - face_rotations.size(),
-                                 false);
+                                    static_cast<unsigned char>(orientation_bit));
         }
       next_free_single=next_free_pair=0;
     }
@@ -251,13 +190,13 @@ namespace internal
       unsigned int n_quads=0;
       unsigned int n_unused_pairs=0;
       unsigned int n_unused_singles=0;
-      for (unsigned int i=0; i<used.size(); ++i)
+      for (unsigned int i=0; i<records.size(); ++i)
         {
-          if (used[i])
+          if (records[i].used)
             ++n_quads;
-          else if (i+1<used.size())
+          else if (i+1<records.size())
             {
-              if (used[i+1])
+              if (records[i+1].used)
                 {
                   ++n_unused_singles;
                   if (next_free_single==0)
@@ -274,7 +213,7 @@ namespace internal
           else
             ++n_unused_singles;
         }
-      Assert(n_quads+2*n_unused_pairs+n_unused_singles==used.size(),
+      Assert(n_quads+2*n_unused_pairs+n_unused_singles==records.size(),
              ExcInternalError());
 
       // how many single quads are needed in addition to n_unused_quads?
@@ -282,12 +221,12 @@ namespace internal
         new_quads_single-n_unused_singles;
 
       unsigned int new_size=
-        used.size() + new_quads_in_pairs - 2*n_unused_pairs;
+        records.size() + new_quads_in_pairs - 2*n_unused_pairs;
       if (additional_single_quads>0)
         new_size+=additional_single_quads;
 
       // see above...
-      if (new_size>cells.size())
+      if (new_size>records.size())
         {
           // reseve space for the base class
           TriaObjects<TriaObject<2> >::reserve_space(new_quads_in_pairs,new_quads_single);
@@ -311,18 +250,12 @@ namespace internal
     void
     TriaObjects<TriaObject<1> >::monitor_memory (const unsigned int) const
     {
-      Assert (cells.size() == used.size(),
-              ExcMemoryInexact (cells.size(), used.size()));
-      Assert (cells.size() == user_flags.size(),
-              ExcMemoryInexact (cells.size(), user_flags.size()));
-      Assert (cells.size() == children.size(),
-              ExcMemoryInexact (cells.size(), children.size()));
-      Assert (cells.size() == boundary_or_material_id.size(),
-              ExcMemoryInexact (cells.size(), boundary_or_material_id.size()));
-      Assert (cells.size() == manifold_id.size(),
-              ExcMemoryInexact (cells.size(), manifold_id.size()));
-      Assert (cells.size() == user_data.size(),
-              ExcMemoryInexact (cells.size(), user_data.size()));
+      Assert (records.size() == boundary_or_material_id.size(),
+              ExcMemoryInexact (records.size(), boundary_or_material_id.size()));
+      Assert (records.size() == manifold_id.size(),
+              ExcMemoryInexact (records.size(), manifold_id.size()));
+      Assert (records.size() == user_data.size(),
+              ExcMemoryInexact (records.size(), user_data.size()));
     }
 
 
@@ -330,62 +263,37 @@ namespace internal
     void
     TriaObjects<TriaObject<2> >::monitor_memory (const unsigned int) const
     {
-      Assert (cells.size() == used.size(),
-              ExcMemoryInexact (cells.size(), used.size()));
-      Assert (cells.size() == user_flags.size(),
-              ExcMemoryInexact (cells.size(), user_flags.size()));
-      Assert (2*cells.size() == children.size(),
-              ExcMemoryInexact (cells.size(), children.size()));
-      Assert (cells.size() == refinement_cases.size(),
-              ExcMemoryInexact (cells.size(), refinement_cases.size()));
-      Assert (cells.size() == boundary_or_material_id.size(),
-              ExcMemoryInexact (cells.size(), boundary_or_material_id.size()));
-      Assert (cells.size() == manifold_id.size(),
-              ExcMemoryInexact (cells.size(), manifold_id.size()));
-      Assert (cells.size() == user_data.size(),
-              ExcMemoryInexact (cells.size(), user_data.size()));
+      Assert (records.size() == boundary_or_material_id.size(),
+              ExcMemoryInexact (records.size(), boundary_or_material_id.size()));
+      Assert (records.size() == manifold_id.size(),
+              ExcMemoryInexact (records.size(), manifold_id.size()));
+      Assert (records.size() == user_data.size(),
+              ExcMemoryInexact (records.size(), user_data.size()));
     }
 
 
     void
     TriaObjectsHex::monitor_memory (const unsigned int) const
     {
-      Assert (cells.size() == used.size(),
-              ExcMemoryInexact (cells.size(), used.size()));
-      Assert (cells.size() == user_flags.size(),
-              ExcMemoryInexact (cells.size(), user_flags.size()));
-      Assert (4*cells.size() == children.size(),
-              ExcMemoryInexact (cells.size(), children.size()));
-      Assert (cells.size() == boundary_or_material_id.size(),
-              ExcMemoryInexact (cells.size(), boundary_or_material_id.size()));
-      Assert (cells.size() == manifold_id.size(),
-              ExcMemoryInexact (cells.size(), manifold_id.size()));
-      Assert (cells.size() == user_data.size(),
-              ExcMemoryInexact (cells.size(), user_data.size()));
-      Assert (cells.size() * GeometryInfo<3>::faces_per_cell
+      Assert (records.size() == boundary_or_material_id.size(),
+              ExcMemoryInexact (records.size(), boundary_or_material_id.size()));
+      Assert (records.size() == manifold_id.size(),
+              ExcMemoryInexact (records.size(), manifold_id.size()));
+      Assert (records.size() == user_data.size(),
+              ExcMemoryInexact (records.size(), user_data.size()));
+      Assert (records.size() * GeometryInfo<3>::faces_per_cell
               == face_orientations.size(),
-              ExcMemoryInexact (cells.size() * GeometryInfo<3>::faces_per_cell,
+              ExcMemoryInexact (records.size() * GeometryInfo<3>::faces_per_cell,
                                 face_orientations.size()));
-      Assert (cells.size() * GeometryInfo<3>::faces_per_cell
-              == face_flips.size(),
-              ExcMemoryInexact (cells.size() * GeometryInfo<3>::faces_per_cell,
-                                face_flips.size()));
-      Assert (cells.size() * GeometryInfo<3>::faces_per_cell
-              == face_rotations.size(),
-              ExcMemoryInexact (cells.size() * GeometryInfo<3>::faces_per_cell,
-                                face_rotations.size()));
     }
 
 
     void
     TriaObjectsQuad3D::monitor_memory (const unsigned int) const
     {
-      // check that we have not allocated too much memory. note that bool
-      // vectors allocate their memory in chunks of whole integers, so they
-      // may over-allocate by up to as many elements as an integer has bits
-      Assert (cells.size() * GeometryInfo<2>::lines_per_cell
+      Assert (records.size() * GeometryInfo<2>::lines_per_cell
               == line_orientations.size(),
-              ExcMemoryInexact (cells.size() * GeometryInfo<2>::lines_per_cell,
+              ExcMemoryInexact (records.size() * GeometryInfo<2>::lines_per_cell,
                                 line_orientations.size()));
       TriaObjects<TriaObject<2> >::monitor_memory (3);
 
@@ -396,11 +304,7 @@ namespace internal
     void
     TriaObjects<G>::clear()
     {
-      cells.clear();
-      children.clear();
-      refinement_cases.clear();
-      used.clear();
-      user_flags.clear();
+      records.clear();
       boundary_or_material_id.clear();
       manifold_id.clear();
       user_data.clear();
@@ -413,8 +317,6 @@ namespace internal
     {
       TriaObjects<TriaObject<3> >::clear();
       face_orientations.clear();
-      face_flips.clear();
-      face_rotations.clear();
     }
 
 
@@ -430,13 +332,9 @@ namespace internal
     std::size_t
     TriaObjects<G>::memory_consumption () const
     {
-      return (MemoryConsumption::memory_consumption (cells) +
-              MemoryConsumption::memory_consumption (children) +
-              MemoryConsumption::memory_consumption (used) +
-              MemoryConsumption::memory_consumption (user_flags) +
+      return (records.capacity() * sizeof(ObjectRecord) + sizeof(records) +
               MemoryConsumption::memory_consumption (boundary_or_material_id) +
               MemoryConsumption::memory_consumption (manifold_id) +
-              MemoryConsumption::memory_consumption (refinement_cases) +
               user_data.capacity() * sizeof(UserData) + sizeof(user_data));
     }
 
@@ -445,8 +343,6 @@ namespace internal
     TriaObjectsHex::memory_consumption () const
     {
       return (MemoryConsumption::memory_consumption (face_orientations) +
-              MemoryConsumption::memory_consumption (face_flips) +
-              MemoryConsumption::memory_consumption (face_rotations) +
               TriaObjects<TriaObject<3> >::memory_consumption() );
     }
 
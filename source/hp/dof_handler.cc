@@ -1543,23 +1543,11 @@ namespace hp
         const unsigned int cells_on_level = tria->n_raw_cells(i);
         std::unique_ptr<std::vector<bool> > has_children_level(new std::vector<bool> (cells_on_level));
 
-        // Check for each cell, if it has children. in 1d, we don't
-        // store refinement cases, so use the 'children' vector
-        // instead
-        if (dim == 1)
-          std::transform (tria->levels[i]->cells.children.begin (),
-                          tria->levels[i]->cells.children.end (),
-                          has_children_level->begin (),
-                          std::bind(std::not_equal_to<int>(),
-                                    std::placeholders::_1,
-                                    -1));
-        else
-          std::transform (tria->levels[i]->cells.refinement_cases.begin (),
-                          tria->levels[i]->cells.refinement_cases.end (),
-                          has_children_level->begin (),
-                          std::bind (std::not_equal_to<unsigned char>(),
-                                     std::placeholders::_1,
-                                     static_cast<unsigned char>(RefinementCase<dim>::no_refinement)));
+        // Check for each cell, if it has children, i.e., if the index of
+        // its first set of children is set
+        for (unsigned int c=0; c<cells_on_level; ++c)
+          (*has_children_level)[c]
+            = (tria->levels[i]->cells.records[c].children[0] != -1);
 
         has_children.emplace_back (std::move(has_children_level));
       }
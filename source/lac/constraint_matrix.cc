@@ -17,6 +17,7 @@
 #include <deal.II/lac/constraint_matrix.templates.h>
 
 #include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/multithread_info.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/block_vector.h>
 #include <deal.II/lac/block_sparse_matrix.h>
@@ -97,6 +98,18 @@ ConstraintMatrix::ConstraintLine::memory_consumption () const
 
 
 
+ConstraintMatrix::RowLocks::RowLocks (const unsigned int n_stripes,
+                                      const unsigned int rows_per_block)
+  :
+  rows_per_block (rows_per_block),
+  mutexes (n_stripes > 0 ? n_stripes : 16*MultithreadInfo::n_threads())
+{
+  Assert (rows_per_block > 0,
+          ExcMessage ("The number of rows per block must be positive."));
+}
+
+
+
 const ConstraintMatrix::LineRange ConstraintMatrix::get_lines() const
 {
   return boost::make_iterator_range(lines.begin(), lines.end());
@@ -1333,6 +1346,16 @@ PARALLEL_VECTOR_FUNCTIONS(TrilinosWrappers::MPI::BlockVector);
       Vector<MatrixType::value_type>                  &, \
       bool                             , \
       std::integral_constant<bool, false>) const
+#define LOCKED_MATRIX_VECTOR_FUNCTIONS(MatrixType, VectorType) \
+  template void ConstraintMatrix:: \
+  distribute_local_to_global<MatrixType,VectorType > (const FullMatrix<MatrixType::value_type>        &, \
+                                                      const Vector<VectorType::value_type>            &, \
+                                                      const std::vector<ConstraintMatrix::size_type> &, \
+                                                      MatrixType                      &, \
+                                                      VectorType                      &, \
+                                                      bool                             , \
+                                                      std::integral_constant<bool, false>, \
+                                                      const ConstraintMatrix::RowLocks *) const
 #define BLOCK_MATRIX_VECTOR_FUNCTIONS(MatrixType, VectorType)   \
   template void ConstraintMatrix:: \
   distribute_local_to_global<MatrixType,VectorType > (const FullMatrix<MatrixType::value_type>        &, \
@@ -1360,6 +1383,13 @@ MATRIX_FUNCTIONS(FullMatrix<std::complex<double> >);
 MATRIX_FUNCTIONS(SparseMatrix<std::complex<double> >);
 MATRIX_FUNCTIONS(SparseMatrix<std::complex<float> >);
 
+LOCKED_MATRIX_VECTOR_FUNCTIONS(SparseMatrix<double>, Vector<double>);
+LOCKED_MATRIX_VECTOR_FUNCTIONS(SparseMatrix<float>,  Vector<float>);
+LOCKED_MATRIX_VECTOR_FUNCTIONS(SparseMatrix<double>, LinearAlgebra::distributed::Vector<double>);
+LOCKED_MATRIX_VECTOR_FUNCTIONS(SparseMatrix<float>,  LinearAlgebra::distributed::Vector<float>);
+LOCKED_MATRIX_VECTOR_FUNCTIONS(FullMatrix<double>,   Vector<double>);
+LOCKED_MATRIX_VECTOR_FUNCTIONS(FullMatrix<float>,    Vector<float>);
+
 BLOCK_MATRIX_FUNCTIONS(BlockSparseMatrix<double>);
 BLOCK_MATRIX_FUNCTIONS(BlockSparseMatrix<float>);
 BLOCK_MATRIX_VECTOR_FUNCTIONS(BlockSparseMatrix<double>, BlockVector<double>);
@@ -0,0 +1,832 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_local_storage.h>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+template <typename number>
+SparseAMG<number>::AdditionalData::AdditionalData (const double       strong_threshold,
+                                                   const unsigned int max_coarse_size,
+                                                   const unsigned int max_levels,
+                                                   const unsigned int smoother_degree,
+                                                   const double       smoother_smoothing_range,
+                                                   const double       prolongation_damping)
+  :
+  strong_threshold (strong_threshold),
+  max_coarse_size (max_coarse_size),
+  max_levels (max_levels),
+  smoother_degree (smoother_degree),
+  smoother_smoothing_range (smoother_smoothing_range),
+  prolongation_damping (prolongation_damping)
+{}
+
+
+
+template <typename number>
+SparseAMG<number>::SparseAMG ()
+{}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::clear ()
+{
+  // delete the objects in the reverse order of their dependencies: the
+  // smoothers point to the matrices, and the matrices point to their
+  // sparsity patterns
+  smoothers.clear ();
+#ifdef DEAL_II_WITH_UMFPACK
+  coarse_solver.clear ();
+  coarse_vector.reinit (0);
+#else
+  coarse_inverse.reinit (0, 0);
+#endif
+  restriction_matrices.clear ();
+  restriction_sparsity.clear ();
+  prolongation_matrices.clear ();
+  prolongation_sparsity.clear ();
+  level_matrices.clear ();
+  level_sparsity.clear ();
+
+  rhs.clear ();
+  solution.clear ();
+  residual.clear ();
+
+  matrix = nullptr;
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::multiply (const SparseMatrix<number> &A,
+                             const SparseMatrix<number> &B,
+                             SparsityPattern            &sparsity_C,
+                             SparseMatrix<number>       &C)
+{
+  AssertDimension (A.n(), B.m());
+
+  const SparsityPattern &sparsity_A = *A.cols;
+  const SparsityPattern &sparsity_B = *B.cols;
+  const size_type n_rows = A.m();
+  const size_type n_cols = B.n();
+  const bool square = (n_rows == n_cols);
+
+  // the columns of row i of C are the union of the columns of those rows of
+  // B whose indices are the columns of row i of A. we skip entries that are
+  // zero, as they are often present in matrices with constraints and would
+  // only fill up the product. in order to find the union, every thread
+  // marks the columns it has seen in row i with the value i in an array as
+  // long as a row of C. we need to go through the rows twice, once to count
+  // and once to store the columns, so use two different arrays for that
+  const auto find_columns = [&] (const size_type         row,
+                                 std::vector<size_type> &marker,
+                                 size_type              *columns)
+  {
+    unsigned int n_entries = 0;
+    if (square)
+      {
+        marker[row] = row;
+        if (columns != nullptr)
+          columns[n_entries] = row;
+        ++n_entries;
+      }
+    for (std::size_t a=sparsity_A.rowstart[row]; a<sparsity_A.rowstart[row+1]; ++a)
+      if (A.val[a] != number())
+        {
+          const size_type k = sparsity_A.colnums[a];
+          for (std::size_t b=sparsity_B.rowstart[k]; b<sparsity_B.rowstart[k+1]; ++b)
+            if (B.val[b] != number() &&
+                marker[sparsity_B.colnums[b]] != row)
+              {
+                marker[sparsity_B.colnums[b]] = row;
+                if (columns != nullptr)
+                  columns[n_entries] = sparsity_B.colnums[b];
+                ++n_entries;
+              }
+        }
+    return n_entries;
+  };
+
+  std::vector<unsigned int> row_lengths (n_rows);
+  {
+    Threads::ThreadLocalStorage<std::vector<size_type> >
+    markers (std::vector<size_type>(n_cols, numbers::invalid_size_type));
+    parallel::apply_to_subranges
+    (size_type(0), n_rows,
+     [&] (const size_type begin,
+          const size_type end)
+    {
+      std::vector<size_type> &marker = markers.get();
+      for (size_type row=begin; row<end; ++row)
+        row_lengths[row] = find_columns (row, marker, nullptr);
+    },
+    256);
+  }
+
+  {
+    Threads::ThreadLocalStorage<std::vector<size_type> >
+    markers (std::vector<size_type>(n_cols, numbers::invalid_size_type));
+    sparsity_C.copy_from (n_rows, n_cols, row_lengths,
+                          [&] (const size_type  row,
+                               size_type       *columns)
+    {
+      const unsigned int n_entries = find_columns (row, markers.get(), columns);
+      std::sort (columns, columns+n_entries);
+    });
+  }
+  C.reinit (sparsity_C);
+
+  // now compute the values of each row in an array as long as a row of C,
+  // and copy them to the places given by the sparsity pattern
+  Threads::ThreadLocalStorage<std::vector<number> >
+  accumulators (std::vector<number>(n_cols, number()));
+  parallel::apply_to_subranges
+  (size_type(0), n_rows,
+   [&] (const size_type begin,
+        const size_type end)
+  {
+    std::vector<number> &accumulator = accumulators.get();
+    for (size_type row=begin; row<end; ++row)
+      {
+        for (std::size_t a=sparsity_A.rowstart[row]; a<sparsity_A.rowstart[row+1]; ++a)
+          if (A.val[a] != number())
+            {
+              const number value = A.val[a];
+              const size_type k = sparsity_A.colnums[a];
+              for (std::size_t b=sparsity_B.rowstart[k]; b<sparsity_B.rowstart[k+1]; ++b)
+                accumulator[sparsity_B.colnums[b]] += value * B.val[b];
+            }
+
+        for (std::size_t c=sparsity_C.rowstart[row]; c<sparsity_C.rowstart[row+1]; ++c)
+          {
+            C.val[c] = accumulator[sparsity_C.colnums[c]];
+            accumulator[sparsity_C.colnums[c]] = number();
+          }
+      }
+  },
+  256);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::transpose (const SparseMatrix<number> &A,
+                              SparsityPattern            &sparsity_B,
+                              SparseMatrix<number>       &B)
+{
+  // a square sparsity pattern would store the diagonal entry first, which
+  // the code below does not take into account. we only need to transpose
+  // the prolongation matrices, which are never square
+  Assert (A.m() != A.n(), ExcInternalError());
+
+  const SparsityPattern &sparsity_A = *A.cols;
+  const std::size_t n_entries = sparsity_A.rowstart[A.m()];
+
+  // sort the entries of A by columns. since we go through the rows in
+  // ascending order, the column indices of the transpose come out sorted
+  std::vector<unsigned int> row_lengths (A.n(), 0);
+  for (std::size_t k=0; k<n_entries; ++k)
+    ++row_lengths[sparsity_A.colnums[k]];
+
+  std::vector<std::size_t> row_start (A.n()+1, 0);
+  for (size_type row=0; row<A.n(); ++row)
+    row_start[row+1] = row_start[row] + row_lengths[row];
+
+  std::vector<size_type> columns (n_entries);
+  std::vector<std::size_t> positions (n_entries);
+  {
+    std::vector<std::size_t> next (row_start.begin(), row_start.end()-1);
+    for (size_type row=0; row<A.m(); ++row)
+      for (std::size_t k=sparsity_A.rowstart[row]; k<sparsity_A.rowstart[row+1]; ++k)
+        {
+          const size_type col = sparsity_A.colnums[k];
+          columns[next[col]] = row;
+          positions[next[col]] = k;
+          ++next[col];
+        }
+  }
+
+  sparsity_B.copy_from (A.n(), A.m(), row_lengths,
+                        [&] (const size_type  row,
+                             size_type       *cols)
+  {
+    std::copy (columns.begin()+row_start[row], columns.begin()+row_start[row+1],
+               cols);
+  });
+  B.reinit (sparsity_B);
+
+  parallel::apply_to_subranges
+  (std::size_t(0), n_entries,
+   [&] (const std::size_t begin,
+        const std::size_t end)
+  {
+    for (std::size_t k=begin; k<end; ++k)
+      B.val[k] = A.val[positions[k]];
+  },
+  4096);
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::initialize (const SparseMatrix<number> &matrix,
+                               const AdditionalData       &data)
+{
+  AssertDimension (matrix.m(), matrix.n());
+  Assert (data.max_levels > 0, ExcMessage ("Need at least one level."));
+
+  clear ();
+  this->matrix = &matrix;
+
+  std::vector<Vector<double> > near_null_space = data.near_null_space;
+  if (near_null_space.empty())
+    {
+      near_null_space.resize (1);
+      near_null_space[0].reinit (matrix.m());
+      near_null_space[0] = 1.;
+    }
+  for (unsigned int c=0; c<near_null_space.size(); ++c)
+    AssertDimension (near_null_space[c].size(), matrix.m());
+  const unsigned int n_vectors = near_null_space.size();
+
+  // the finest level uses the given matrix directly
+  level_sparsity.emplace_back ();
+  level_matrices.emplace_back ();
+
+  for (unsigned int level=0; ; ++level)
+    {
+      const SparseMatrix<number> &A = get_matrix (level);
+      const SparsityPattern &sparsity = *A.cols;
+      const size_type n_fine = A.m();
+      if (n_fine <= data.max_coarse_size)
+        break;
+
+      Vector<number> diagonal (n_fine);
+      for (size_type i=0; i<n_fine; ++i)
+        {
+          diagonal(i) = A.diag_element (i);
+          AssertThrow (diagonal(i) != number(),
+                       ExcMessage ("The diagonal entry in row " +
+                                   Utilities::to_string (i) + " on level " +
+                                   Utilities::to_string (level) +
+                                   " of the AMG hierarchy is zero."));
+        }
+
+      // estimate the largest eigenvalue of D^{-1}A by a few steps of the
+      // power method, starting from a random vector that contains all
+      // eigenmodes. use a generator with fixed seed to get the same
+      // hierarchy every time. the estimate is needed for smoothing
+      // the prolongation, and we also pass it to the Chebyshev smoother
+      // rather than letting it compute its own estimate by a CG iteration on
+      // the first application
+      Vector<number> inverse_diagonal (n_fine);
+      for (size_type i=0; i<n_fine; ++i)
+        inverse_diagonal(i) = number(1.) / diagonal(i);
+      double max_eigenvalue = 1.;
+      {
+        Vector<number> x (n_fine), y (n_fine), scaled_x (n_fine);
+        boost::random::mt19937 rng;
+        boost::random::uniform_real_distribution<> uniform_distribution(-1,1);
+        for (size_type i=0; i<n_fine; ++i)
+          x(i) = uniform_distribution (rng);
+        for (unsigned int it=0; it<15; ++it)
+          {
+            A.vmult (y, x);
+            scaled_x = x;
+            scaled_x.scale (diagonal);
+            max_eigenvalue = (x * y) / (x * scaled_x);
+            x = y;
+            x.scale (inverse_diagonal);
+            x /= x.l2_norm ();
+          }
+      }
+
+      // set up the smoother on the current level. if this turns out to be
+      // the coarsest level because we cannot coarsen any further, the
+      // smoother also takes the place of the coarse solver
+      typename SmootherType::AdditionalData smoother_data;
+      smoother_data.degree = data.smoother_degree;
+      smoother_data.smoothing_range = data.smoother_smoothing_range;
+      smoother_data.eig_cg_n_iterations = 0;
+      smoother_data.max_eigenvalue = 1.2 * max_eigenvalue;
+      smoother_data.preconditioner = std::make_shared<DiagonalMatrix<Vector<number> > > ();
+      smoother_data.preconditioner->get_vector() = inverse_diagonal;
+      smoothers.emplace_back (new SmootherType);
+      smoothers.back()->initialize (A, smoother_data);
+
+      if (level+1 >= data.max_levels)
+        break;
+
+      // determine the strongly coupled neighbors of each unknown. store them
+      // in compressed row format, together with the strength of the
+      // coupling relative to the diagonal entries
+      const double threshold = data.strong_threshold * data.strong_threshold;
+      const auto coupling_strength = [&] (const size_type   row,
+                                          const std::size_t index)
+      {
+        const size_type col = sparsity.colnums[index];
+        const double value = A.val[index];
+        if (col == row || value == 0.)
+          return 0.;
+        const double strength = value * value / std::abs (double(diagonal(row)) *
+                                                          double(diagonal(col)));
+        return (strength >= threshold ? strength : 0.);
+      };
+
+      std::vector<std::size_t> strong_start (n_fine+1, 0);
+      parallel::apply_to_subranges
+      (size_type(0), n_fine,
+       [&] (const size_type begin,
+            const size_type end)
+      {
+        for (size_type row=begin; row<end; ++row)
+          for (std::size_t k=sparsity.rowstart[row]; k<sparsity.rowstart[row+1]; ++k)
+            if (coupling_strength (row, k) > 0.)
+              ++strong_start[row+1];
+      },
+      1024);
+      for (size_type row=0; row<n_fine; ++row)
+        strong_start[row+1] += strong_start[row];
+
+      std::vector<size_type> strong_neighbors (strong_start[n_fine]);
+      std::vector<double> strong_values (strong_start[n_fine]);
+      parallel::apply_to_subranges
+      (size_type(0), n_fine,
+       [&] (const size_type begin,
+            const size_type end)
+      {
+        for (size_type row=begin; row<end; ++row)
+          {
+            std::size_t position = strong_start[row];
+            for (std::size_t k=sparsity.rowstart[row]; k<sparsity.rowstart[row+1]; ++k)
+              {
+                const double strength = coupling_strength (row, k);
+                if (strength > 0.)
+                  {
+                    strong_neighbors[position] = sparsity.colnums[k];
+                    strong_values[position] = strength;
+                    ++position;
+                  }
+              }
+          }
+      },
+      1024);
+
+      // form the aggregates. first, every unknown whose strongly coupled
+      // neighbors are all still free forms an aggregate together with them.
+      // second, the remaining unknowns join the aggregate from the first
+      // phase they are most strongly coupled to. finally, whatever is left
+      // forms new aggregates with its free neighbors. unknowns without any
+      // strong couplings are not aggregated
+      const unsigned int unaggregated = numbers::invalid_unsigned_int;
+      std::vector<unsigned int> aggregate (n_fine, unaggregated);
+      unsigned int n_aggregates = 0;
+      for (size_type i=0; i<n_fine; ++i)
+        if (aggregate[i] == unaggregated && strong_start[i] != strong_start[i+1])
+          {
+            bool neighbors_are_free = true;
+            for (std::size_t k=strong_start[i]; k<strong_start[i+1]; ++k)
+              if (aggregate[strong_neighbors[k]] != unaggregated)
+                {
+                  neighbors_are_free = false;
+                  break;
+                }
+            if (neighbors_are_free)
+              {
+                aggregate[i] = n_aggregates;
+                for (std::size_t k=strong_start[i]; k<strong_start[i+1]; ++k)
+                  aggregate[strong_neighbors[k]] = n_aggregates;
+                ++n_aggregates;
+              }
+          }
+
+      {
+        const std::vector<unsigned int> first_phase_aggregate = aggregate;
+        for (size_type i=0; i<n_fine; ++i)
+          if (aggregate[i] == unaggregated)
+            {
+              double max_strength = 0.;
+              for (std::size_t k=strong_start[i]; k<strong_start[i+1]; ++k)
+                if (first_phase_aggregate[strong_neighbors[k]] != unaggregated &&
+                    strong_values[k] > max_strength)
+                  {
+                    aggregate[i] = first_phase_aggregate[strong_neighbors[k]];
+                    max_strength = strong_values[k];
+                  }
+            }
+      }
+
+      for (size_type i=0; i<n_fine; ++i)
+        if (aggregate[i] == unaggregated && strong_start[i] != strong_start[i+1])
+          {
+            aggregate[i] = n_aggregates;
+            for (std::size_t k=strong_start[i]; k<strong_start[i+1]; ++k)
+              if (aggregate[strong_neighbors[k]] == unaggregated)
+                aggregate[strong_neighbors[k]] = n_aggregates;
+            ++n_aggregates;
+          }
+
+      if (n_aggregates == 0)
+        break;
+
+      // list the unknowns of each aggregate
+      std::vector<std::size_t> aggregate_start (n_aggregates+1, 0);
+      for (size_type i=0; i<n_fine; ++i)
+        if (aggregate[i] != unaggregated)
+          ++aggregate_start[aggregate[i]+1];
+      for (unsigned int a=0; a<n_aggregates; ++a)
+        aggregate_start[a+1] += aggregate_start[a];
+      std::vector<size_type> members (aggregate_start[n_aggregates]);
+      std::vector<std::size_t> member_position (n_fine, numbers::invalid_size_type);
+      {
+        std::vector<std::size_t> next (aggregate_start.begin(), aggregate_start.end()-1);
+        for (size_type i=0; i<n_fine; ++i)
+          if (aggregate[i] != unaggregated)
+            {
+              member_position[i] = next[aggregate[i]];
+              members[next[aggregate[i]]++] = i;
+            }
+      }
+
+      // orthonormalize the near null space on each aggregate by the modified
+      // Gram-Schmidt method. vectors that are linearly dependent on the
+      // previous ones on an aggregate (e.g., because they vanish there) are
+      // dropped, so the number of coarse unknowns of an aggregate is the
+      // rank of the near null space restricted to it. the orthonormal
+      // vectors give the tentative prolongation, the coefficients the near
+      // null space on the coarse level
+      std::vector<double> q_values (members.size() * n_vectors);
+      std::vector<double> r_values (n_aggregates * n_vectors * n_vectors, 0.);
+      std::vector<unsigned int> aggregate_rank (n_aggregates);
+      parallel::apply_to_subranges
+      (0U, n_aggregates,
+       [&] (const unsigned int begin,
+            const unsigned int end)
+      {
+        for (unsigned int a=begin; a<end; ++a)
+          {
+            const std::size_t first = aggregate_start[a];
+            const std::size_t size = aggregate_start[a+1] - first;
+            double *r = &r_values[a * n_vectors * n_vectors];
+            unsigned int rank = 0;
+            for (unsigned int c=0; c<n_vectors; ++c)
+              {
+                double norm_before = 0.;
+                for (std::size_t p=0; p<size; ++p)
+                  {
+                    const double value = near_null_space[c](members[first+p]);
+                    q_values[(first+p)*n_vectors + rank] = value;
+                    norm_before += value * value;
+                  }
+                for (unsigned int s=0; s<rank; ++s)
+                  {
+                    double product = 0.;
+                    for (std::size_t p=0; p<size; ++p)
+                      product += q_values[(first+p)*n_vectors + s] *
+                                 q_values[(first+p)*n_vectors + rank];
+                    for (std::size_t p=0; p<size; ++p)
+                      q_values[(first+p)*n_vectors + rank] -=
+                        product * q_values[(first+p)*n_vectors + s];
+                    r[s*n_vectors + c] = product;
+                  }
+                double norm = 0.;
+                for (std::size_t p=0; p<size; ++p)
+                  norm += q_values[(first+p)*n_vectors + rank] *
+                          q_values[(first+p)*n_vectors + rank];
+                if (norm > 1e-20 * norm_before && norm > 0.)
+                  {
+                    norm = std::sqrt (norm);
+                    for (std::size_t p=0; p<size; ++p)
+                      q_values[(first+p)*n_vectors + rank] /= norm;
+                    r[rank*n_vectors + c] = norm;
+                    ++rank;
+                  }
+              }
+            aggregate_rank[a] = rank;
+          }
+      },
+      256);
+
+      std::vector<size_type> coarse_start (n_aggregates+1, 0);
+      for (unsigned int a=0; a<n_aggregates; ++a)
+        coarse_start[a+1] = coarse_start[a] + aggregate_rank[a];
+      const size_type n_coarse = coarse_start[n_aggregates];
+
+      // stop if coarsening has stalled
+      if (n_coarse == 0 || 10*n_coarse > 9*n_fine)
+        break;
+
+      SparsityPattern tentative_sparsity;
+      SparseMatrix<number> tentative_prolongation;
+      {
+        std::vector<unsigned int> row_lengths (n_fine, 0);
+        for (size_type i=0; i<n_fine; ++i)
+          if (aggregate[i] != unaggregated)
+            row_lengths[i] = aggregate_rank[aggregate[i]];
+        tentative_sparsity.copy_from (n_fine, n_coarse, row_lengths,
+                                      [&] (const size_type  row,
+                                           size_type       *columns)
+        {
+          for (unsigned int s=0; s<row_lengths[row]; ++s)
+            columns[s] = coarse_start[aggregate[row]] + s;
+        });
+        tentative_prolongation.reinit (tentative_sparsity);
+        for (size_type i=0; i<n_fine; ++i)
+          for (unsigned int s=0; s<row_lengths[i]; ++s)
+            tentative_prolongation.val[tentative_sparsity.rowstart[i]+s]
+              = q_values[member_position[i]*n_vectors + s];
+      }
+
+      // smooth the tentative prolongation by one step of damped Jacobi,
+      // P = T - omega/lambda D^{-1} A T. since the diagonal of A is nonzero,
+      // the sparsity pattern of A T contains the nonzero entries of T, so
+      // add T into A T
+      std::unique_ptr<SparsityPattern> P_sparsity (new SparsityPattern);
+      std::unique_ptr<SparseMatrix<number> > P (new SparseMatrix<number>);
+      multiply (A, tentative_prolongation, *P_sparsity, *P);
+      const double damping = data.prolongation_damping / max_eigenvalue;
+      parallel::apply_to_subranges
+      (size_type(0), n_fine,
+       [&] (const size_type begin,
+            const size_type end)
+      {
+        for (size_type row=begin; row<end; ++row)
+          {
+            const number factor = -damping * inverse_diagonal(row);
+            std::size_t k = P_sparsity->rowstart[row];
+            for (; k<P_sparsity->rowstart[row+1]; ++k)
+              P->val[k] *= factor;
+            k = P_sparsity->rowstart[row];
+            for (std::size_t t=tentative_sparsity.rowstart[row];
+                 t<tentative_sparsity.rowstart[row+1]; ++t)
+              if (tentative_prolongation.val[t] != number())
+                {
+                  while (P_sparsity->colnums[k] != tentative_sparsity.colnums[t])
+                    ++k;
+                  P->val[k] += tentative_prolongation.val[t];
+                }
+          }
+      },
+      1024);
+
+      // form the restriction as the transpose of the prolongation and the
+      // coarse matrix by the Galerkin product R A P
+      std::unique_ptr<SparsityPattern> R_sparsity (new SparsityPattern);
+      std::unique_ptr<SparseMatrix<number> > R (new SparseMatrix<number>);
+      transpose (*P, *R_sparsity, *R);
+
+      std::unique_ptr<SparsityPattern> coarse_sparsity (new SparsityPattern);
+      std::unique_ptr<SparseMatrix<number> > coarse_matrix (new SparseMatrix<number>);
+      {
+        SparsityPattern AP_sparsity;
+        SparseMatrix<number> AP;
+        multiply (A, *P, AP_sparsity, AP);
+        multiply (*R, AP, *coarse_sparsity, *coarse_matrix);
+      }
+
+      prolongation_sparsity.push_back (std::move (P_sparsity));
+      prolongation_matrices.push_back (std::move (P));
+      restriction_sparsity.push_back (std::move (R_sparsity));
+      restriction_matrices.push_back (std::move (R));
+      level_sparsity.push_back (std::move (coarse_sparsity));
+      level_matrices.push_back (std::move (coarse_matrix));
+
+      // the near null space on the coarse level
+      std::vector<Vector<double> > coarse_near_null_space (n_vectors,
+                                                           Vector<double>(n_coarse));
+      for (unsigned int a=0; a<n_aggregates; ++a)
+        for (unsigned int s=0; s<aggregate_rank[a]; ++s)
+          for (unsigned int c=0; c<n_vectors; ++c)
+            coarse_near_null_space[c](coarse_start[a]+s)
+              = r_values[(a*n_vectors + s)*n_vectors + c];
+      near_null_space.swap (coarse_near_null_space);
+    }
+
+  // factorize the matrix on the coarsest level unless coarsening stopped
+  // early, in which case the smoother set up above acts as coarse solver
+  if (smoothers.size() < n_levels())
+    {
+      const SparseMatrix<number> &coarse_matrix = get_matrix (n_levels()-1);
+#ifdef DEAL_II_WITH_UMFPACK
+      coarse_solver.initialize (coarse_matrix);
+      coarse_vector.reinit (coarse_matrix.m());
+#else
+      coarse_inverse.copy_from (coarse_matrix);
+      coarse_inverse.gauss_jordan ();
+#endif
+    }
+
+  rhs.resize (n_levels());
+  solution.resize (n_levels());
+  residual.resize (n_levels());
+  for (unsigned int level=0; level<n_levels(); ++level)
+    {
+      rhs[level].reinit (n_rows_on_level(level));
+      solution[level].reinit (n_rows_on_level(level));
+      if (level+1 < n_levels())
+        residual[level].reinit (n_rows_on_level(level));
+    }
+}
+
+
+
+template <typename number>
+const SparseMatrix<number> &
+SparseAMG<number>::get_matrix (const unsigned int level) const
+{
+  AssertIndexRange (level, n_levels());
+  if (level == 0)
+    return *matrix;
+  else
+    return *level_matrices[level];
+}
+
+
+
+template <typename number>
+void
+SparseAMG<number>::v_cycle (const unsigned int level) const
+{
+  if (level == n_levels()-1 && smoothers.size() == n_levels())
+    {
+      smoothers[level]->vmult (solution[level], rhs[level]);
+      return;
+    }
+  else if (level == n_levels()-1)
+    {
+#ifdef DEAL_II_WITH_UMFPACK
+      coarse_vector = rhs[level];
+      coarse_solver.solve (coarse_vector);
+      solution[level] = coarse_vector;
+#else
+      coarse_inverse.vmult (solution[level], rhs[level]);
+#endif
+      return;
+    }
+
+  smoothers[level]->vmult (solution[level], rhs[level]);
+  get_matrix(level).residual (residual[level], solution[level], rhs[level]);
+  restriction_matrices[level]->vmult (rhs[level+1], residual[level]);
+  v_cycle (level+1);
+  prolongation_matrices[level]->vmult_add (solution[level], solution[level+1]);
+  smoothers[level]->step (solution[level], rhs[level]);
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseAMG<number>::vmult (Vector<somenumber>       &dst,
+                          const Vector<somenumber> &src) const
+{
+  Assert (n_levels() > 0, ExcNotInitialized());
+  AssertDimension (dst.size(), m());
+  AssertDimension (src.size(), n());
+
+  Threads::Mutex::ScopedLock lock (mutex);
+  rhs[0] = src;
+  v_cycle (0);
+  dst = solution[0];
+}
+
+
+
+template <typename number>
+template <typename somenumber>
+void
+SparseAMG<number>::Tvmult (Vector<somenumber>       &dst,
+                           const Vector<somenumber> &src) const
+{
+  vmult (dst, src);
+}
+
+
+
+template <typename number>
+typename SparseAMG<number>::size_type
+SparseAMG<number>::m () const
+{
+  Assert (matrix != nullptr, ExcNotInitialized());
+  return matrix->m();
+}
+
+
+
+template <typename number>
+typename SparseAMG<number>::size_type
+SparseAMG<number>::n () const
+{
+  Assert (matrix != nullptr, ExcNotInitialized());
+  return matrix->n();
+}
+
+
+
+template <typename number>
+unsigned int
+SparseAMG<number>::n_levels () const
+{
+  return level_matrices.size();
+}
+
+
+
+template <typename number>
+typename SparseAMG<number>::size_type
+SparseAMG<number>::n_rows_on_level (const unsigned int level) const
+{
+  return get_matrix(level).m();
+}
+
+
+
+template <typename number>
+double
+SparseAMG<number>::operator_complexity () const
+{
+  Assert (n_levels() > 0, ExcNotInitialized());
+  std::size_t n_nonzero_elements = 0;
+  for (unsigned int level=0; level<n_levels(); ++level)
+    n_nonzero_elements += get_matrix(level).n_nonzero_elements();
+  return static_cast<double>(n_nonzero_elements) / matrix->n_nonzero_elements();
+}
+
+
+
+template <typename number>
+std::size_t
+SparseAMG<number>::memory_consumption () const
+{
+  std::size_t memory = sizeof(*this);
+  for (unsigned int level=1; level<n_levels(); ++level)
+    memory += level_sparsity[level]->memory_consumption() +
+              level_matrices[level]->memory_consumption();
+  for (unsigned int level=0; level+1<n_levels(); ++level)
+    memory += prolongation_sparsity[level]->memory_consumption() +
+              prolongation_matrices[level]->memory_consumption() +
+              restriction_sparsity[level]->memory_consumption() +
+              restriction_matrices[level]->memory_consumption();
+#ifdef DEAL_II_WITH_UMFPACK
+  memory += coarse_solver.memory_consumption() +
+            MemoryConsumption::memory_consumption (coarse_vector);
+#else
+  memory += coarse_inverse.memory_consumption();
+#endif
+  memory += MemoryConsumption::memory_consumption (rhs) +
+            MemoryConsumption::memory_consumption (solution) +
+            MemoryConsumption::memory_consumption (residual);
+  return memory;
+}
+
+
+
+// explicit instantiations
+template class SparseAMG<double>;
+template void SparseAMG<double>::vmult<double> (Vector<double> &,
+                                                const Vector<double> &) const;
+template void SparseAMG<double>::Tvmult<double> (Vector<double> &,
+                                                 const Vector<double> &) const;
+template void SparseAMG<double>::vmult<float> (Vector<float> &,
+                                               const Vector<float> &) const;
+template void SparseAMG<double>::Tvmult<float> (Vector<float> &,
+                                                const Vector<float> &) const;
+
+template class SparseAMG<float>;
+template void SparseAMG<float>::vmult<double> (Vector<double> &,
+                                               const Vector<double> &) const;
+template void SparseAMG<float>::Tvmult<double> (Vector<double> &,
+                                                const Vector<double> &) const;
+template void SparseAMG<float>::vmult<float> (Vector<float> &,
+                                              const Vector<float> &) const;
+template void SparseAMG<float>::Tvmult<float> (Vector<float> &,
+                                               const Vector<float> &) const;
+
+DEAL_II_NAMESPACE_CLOSE
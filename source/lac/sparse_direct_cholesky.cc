@@ -0,0 +1,1040 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/sparse_direct_cholesky.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/thread_management.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/lapack_templates.h>
+#include <deal.II/lac/sparsity_tools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+namespace
+{
+  /**
+   * Subtract the contributions of the pivots @p pivot_begin to @p pivot_end
+   * from the columns @p begin to @p end of a frontal matrix with @p n_rows
+   * rows stored column by column, on and below the diagonal. The columns of
+   * the factor L are stored in the corresponding columns of the frontal
+   * matrix, and the columns of L D (or L for the Cholesky factorization) in
+   * @p w with leading dimension @p ldw.
+   */
+  void
+  update_columns (double             *front,
+                  const unsigned int  n_rows,
+                  const double       *w,
+                  const unsigned int  ldw,
+                  const unsigned int  begin,
+                  const unsigned int  end,
+                  const unsigned int  pivot_begin,
+                  const unsigned int  pivot_end)
+  {
+    if (begin >= end || pivot_begin >= pivot_end)
+      return;
+
+    const double work = 1. * (end-begin) * (n_rows-begin) * (pivot_end-pivot_begin);
+
+#ifdef DEAL_II_WITH_LAPACK
+    // BLAS also fills the part of the columns above the diagonal, which we
+    // never read, but is so much faster that this does not matter
+    if (work > 1e5)
+      {
+        const int m = n_rows-begin;
+        const int n = end-begin;
+        const int k = pivot_end-pivot_begin;
+        const int ld_front = n_rows;
+        const int ld_w = ldw;
+        const double alpha = -1.;
+        const double beta = 1.;
+        gemm ("n", "t", &m, &n, &k, &alpha,
+              front + std::size_t(pivot_begin)*n_rows + begin, &ld_front,
+              w + std::size_t(pivot_begin)*ldw + begin, &ld_w, &beta,
+              front + std::size_t(begin)*n_rows + begin, &ld_front);
+        return;
+      }
+#endif
+
+    const auto update = [&] (const unsigned int column_begin,
+                             const unsigned int column_end)
+    {
+      for (unsigned int j=column_begin; j<column_end; ++j)
+        {
+          double *column = front + std::size_t(j)*n_rows;
+          for (unsigned int p=pivot_begin; p<pivot_end; ++p)
+            {
+              const double factor = w[std::size_t(p)*ldw + j];
+              if (factor != 0.)
+                {
+                  const double *l = front + std::size_t(p)*n_rows;
+                  for (unsigned int i=j; i<n_rows; ++i)
+                    column[i] -= l[i] * factor;
+                }
+            }
+        }
+    };
+
+    if (work > 1e6 && MultithreadInfo::n_threads() > 1)
+      parallel::apply_to_subranges (begin, end, update,
+                                    std::max (1U, static_cast<unsigned int>
+                                              (2e5 / ((n_rows-begin) *
+                                                      (pivot_end-pivot_begin)))));
+    else
+      update (begin, end);
+  }
+
+
+
+  /**
+   * Interchange the rows and columns @p a < @p b of a symmetric frontal
+   * matrix of which only the part on and below the diagonal is stored,
+   * column by column. The rows of the columns left of @p a, i.e., the
+   * columns of L computed so far, are interchanged as well.
+   */
+  void
+  symmetric_swap (double             *front,
+                  const unsigned int  n_rows,
+                  const unsigned int  a,
+                  const unsigned int  b)
+  {
+    const auto entry = [&] (const unsigned int i,
+                            const unsigned int j) -> double &
+    {
+      return front[std::size_t(j)*n_rows + i];
+    };
+
+    for (unsigned int j=0; j<a; ++j)
+      std::swap (entry(a,j), entry(b,j));
+    for (unsigned int j=a+1; j<b; ++j)
+      std::swap (entry(j,a), entry(b,j));
+    for (unsigned int i=b+1; i<n_rows; ++i)
+      std::swap (entry(i,a), entry(i,b));
+    std::swap (entry(a,a), entry(b,b));
+  }
+}
+
+
+
+SparseDirectCholesky::AdditionalData::AdditionalData (const Factorization factorization,
+                                                      const Ordering      ordering,
+                                                      const double        pivot_threshold)
+  :
+  factorization (factorization),
+  ordering (ordering),
+  pivot_threshold (pivot_threshold)
+{}
+
+
+
+SparseDirectCholesky::SparseDirectCholesky ()
+  :
+  n_rows (0),
+  n_matrix_entries (0),
+  perturbation (0.)
+{}
+
+
+
+void
+SparseDirectCholesky::clear ()
+{
+  n_rows = 0;
+  n_matrix_entries = 0;
+  perturbation = 0.;
+  std::vector<size_type>().swap (new_index);
+  std::vector<size_type>().swap (supernode_start);
+  std::vector<unsigned int>().swap (supernode_parent);
+  std::vector<unsigned int>().swap (children);
+  std::vector<unsigned int>().swap (children_start);
+  std::vector<unsigned int>().swap (first_descendant);
+  std::vector<size_type>().swap (row_indices);
+  std::vector<std::size_t>().swap (row_start);
+  std::vector<unsigned int>().swap (parent_position);
+  std::vector<std::pair<std::size_t,std::size_t> >().swap (assembly);
+  std::vector<std::size_t>().swap (assembly_start);
+  std::vector<double>().swap (subtree_work);
+  std::vector<std::size_t>().swap (value_start);
+  std::vector<double>().swap (factor_values);
+  std::vector<size_type>().swap (pivot_order);
+  std::vector<double>().swap (diagonal);
+  std::vector<double>().swap (off_diagonal);
+  std::vector<std::vector<double> >().swap (schur_complements);
+  std::vector<size_type>().swap (perturbed_pivots);
+  std::vector<std::pair<size_type,double> >().swap (failed_pivot);
+}
+
+
+
+void
+SparseDirectCholesky::initialize (const SparsityPattern &sparsity_pattern,
+                                  const AdditionalData  &data)
+{
+  Assert (sparsity_pattern.n_rows() == sparsity_pattern.n_cols(),
+          ExcNotQuadratic());
+  Assert (sparsity_pattern.is_compressed(), SparsityPattern::ExcNotCompressed());
+
+  clear ();
+  additional_data = data;
+  compute_symbolic_factorization (sparsity_pattern);
+}
+
+
+
+void
+SparseDirectCholesky::compute_symbolic_factorization (const SparsityPattern &sparsity)
+{
+  const size_type n = sparsity.n_rows();
+  n_rows = n;
+  n_matrix_entries = sparsity.n_nonzero_elements();
+
+  // store the entries below the diagonal of the matrix renumbered by the
+  // given permutation, row by row, in ascending order and without the
+  // duplicates that an entry and its transpose create
+  const auto make_lower_triangle = [&] (const std::vector<size_type> &permutation,
+                                        std::vector<std::size_t>     &start,
+                                        std::vector<size_type>       &columns)
+  {
+    start.assign (n+1, 0);
+    for (size_type row=0; row<n; ++row)
+      for (SparsityPattern::iterator it=sparsity.begin(row);
+           it!=sparsity.end(row); ++it)
+        if (it->column() != row)
+          ++start[std::max (permutation[row], permutation[it->column()])+1];
+    for (size_type row=0; row<n; ++row)
+      start[row+1] += start[row];
+    columns.resize (start[n]);
+    std::vector<std::size_t> position (start.begin(), start.end()-1);
+    for (size_type row=0; row<n; ++row)
+      for (SparsityPattern::iterator it=sparsity.begin(row);
+           it!=sparsity.end(row); ++it)
+        if (it->column() != row)
+          {
+            const size_type i = permutation[row], j = permutation[it->column()];
+            columns[position[std::max(i,j)]++] = std::min(i,j);
+          }
+    std::size_t next_free = 0;
+    for (size_type row=0; row<n; ++row)
+      {
+        const std::size_t begin = start[row];
+        std::sort (columns.begin()+begin, columns.begin()+start[row+1]);
+        const std::size_t end = std::unique (columns.begin()+begin,
+                                             columns.begin()+start[row+1])
+                                - columns.begin();
+        start[row] = next_free;
+        for (std::size_t j=begin; j<end; ++j)
+          columns[next_free++] = columns[j];
+      }
+    start[n] = next_free;
+    columns.resize (next_free);
+  };
+
+  // the elimination tree by the algorithm of Liu, with path compression
+  const auto make_elimination_tree = [&] (const std::vector<std::size_t> &start,
+                                          const std::vector<size_type>   &columns,
+                                          std::vector<size_type>         &parent)
+  {
+    parent.assign (n, numbers::invalid_size_type);
+    std::vector<size_type> ancestor (n, numbers::invalid_size_type);
+    for (size_type i=0; i<n; ++i)
+      for (std::size_t k=start[i]; k<start[i+1]; ++k)
+        {
+          size_type r = columns[k];
+          while (ancestor[r] != numbers::invalid_size_type && ancestor[r] != i)
+            {
+              const size_type next = ancestor[r];
+              ancestor[r] = i;
+              r = next;
+            }
+          if (ancestor[r] == numbers::invalid_size_type)
+            {
+              ancestor[r] = i;
+              parent[r] = i;
+            }
+        }
+  };
+
+  // compute the fill-reducing ordering, and then number the columns in a
+  // postorder of the elimination tree, which keeps the fill-in but makes
+  // the columns of every subtree, and in particular those of supernodes,
+  // contiguous
+  std::vector<size_type> ordering (n);
+  if (additional_data.ordering == nested_dissection)
+    SparsityTools::reorder_nested_dissection (sparsity, ordering);
+  else
+    for (size_type i=0; i<n; ++i)
+      ordering[i] = i;
+
+  std::vector<std::size_t> lower_start;
+  std::vector<size_type> lower_columns;
+  std::vector<size_type> parent;
+  make_lower_triangle (ordering, lower_start, lower_columns);
+  make_elimination_tree (lower_start, lower_columns, parent);
+
+  std::vector<size_type> column_children_start (n+2, 0);
+  std::vector<size_type> column_children (n);
+  const auto make_children = [&] ()
+  {
+    // the roots of the forest are stored as the children of a virtual node n
+    std::fill (column_children_start.begin(), column_children_start.end(), 0);
+    for (size_type j=0; j<n; ++j)
+      ++column_children_start[(parent[j] == numbers::invalid_size_type ?
+                               n : parent[j]) + 1];
+    for (size_type j=0; j<=n; ++j)
+      column_children_start[j+1] += column_children_start[j];
+    std::vector<size_type> position (column_children_start.begin(),
+                                     column_children_start.end()-1);
+    for (size_type j=0; j<n; ++j)
+      column_children[position[parent[j] == numbers::invalid_size_type ?
+                                n : parent[j]]++] = j;
+  };
+  make_children ();
+
+  {
+    std::vector<size_type> postorder (n);
+    size_type next_number = 0;
+    std::vector<std::pair<size_type,size_type> > stack;
+    stack.emplace_back (n, column_children_start[n]);
+    while (!stack.empty())
+      {
+        const size_type node = stack.back().first;
+        if (stack.back().second < column_children_start[node+1])
+          {
+            const size_type child = column_children[stack.back().second++];
+            stack.emplace_back (child, column_children_start[child]);
+          }
+        else
+          {
+            if (node != n)
+              postorder[node] = next_number++;
+            stack.pop_back ();
+          }
+      }
+
+    new_index.resize (n);
+    for (size_type i=0; i<n; ++i)
+      new_index[i] = postorder[ordering[i]];
+  }
+
+  make_lower_triangle (new_index, lower_start, lower_columns);
+  make_elimination_tree (lower_start, lower_columns, parent);
+  make_children ();
+
+  // the entries below the diagonal column by column. since the rows are
+  // traversed in order, the rows within each column are sorted
+  std::vector<std::size_t> column_start (n+1, 0);
+  std::vector<size_type> column_rows (lower_columns.size());
+  for (std::size_t k=0; k<lower_columns.size(); ++k)
+    ++column_start[lower_columns[k]+1];
+  for (size_type j=0; j<n; ++j)
+    column_start[j+1] += column_start[j];
+  {
+    std::vector<std::size_t> position (column_start.begin(), column_start.end()-1);
+    for (size_type i=0; i<n; ++i)
+      for (std::size_t k=lower_start[i]; k<lower_start[i+1]; ++k)
+        column_rows[position[lower_columns[k]]++] = i;
+  }
+
+  // compute the structure of every column of L below the diagonal as the
+  // union of the structure of the column of the matrix and the structures
+  // of the children in the elimination tree. a column is merged into the
+  // supernode of the previous column if it is the only child and has the
+  // same structure minus the column itself (fundamental supernodes). the
+  // structures of the children are not needed any more afterwards
+  std::vector<std::vector<size_type> > structure (n);
+  std::vector<size_type> marker (n, numbers::invalid_size_type);
+  supernode_start.clear ();
+  row_start.assign (1, 0);
+  row_indices.clear ();
+  const auto close_supernode = [&] (const size_type last_column)
+  {
+    for (size_type j=supernode_start.back(); j<=last_column; ++j)
+      row_indices.push_back (j);
+    const std::size_t begin = row_indices.size();
+    row_indices.insert (row_indices.end(), structure[last_column].begin(),
+                        structure[last_column].end());
+    std::sort (row_indices.begin()+begin, row_indices.end());
+    row_start.push_back (row_indices.size());
+  };
+  for (size_type j=0; j<n; ++j)
+    {
+      std::vector<size_type> &s = structure[j];
+      marker[j] = j;
+      for (std::size_t k=column_start[j]; k<column_start[j+1]; ++k)
+        if (marker[column_rows[k]] != j)
+          {
+            marker[column_rows[k]] = j;
+            s.push_back (column_rows[k]);
+          }
+      for (size_type c=column_children_start[j]; c<column_children_start[j+1]; ++c)
+        for (const size_type i : structure[column_children[c]])
+          if (marker[i] != j)
+            {
+              marker[i] = j;
+              s.push_back (i);
+            }
+
+      const bool merge = (j > 0 && parent[j-1] == j &&
+                          column_children_start[j+1]-column_children_start[j] == 1 &&
+                          structure[j-1].size() == s.size()+1);
+      if (!merge)
+        {
+          if (j > 0)
+            close_supernode (j-1);
+          supernode_start.push_back (j);
+        }
+
+      for (size_type c=column_children_start[j]; c<column_children_start[j+1]; ++c)
+        std::vector<size_type>().swap (structure[column_children[c]]);
+    }
+  if (n > 0)
+    close_supernode (n-1);
+  supernode_start.push_back (n);
+  std::vector<std::vector<size_type> >().swap (structure);
+
+  // the tree of supernodes
+  const unsigned int n_sn = supernode_start.size()-1;
+  std::vector<unsigned int> supernode_of_column (n);
+  for (unsigned int s=0; s<n_sn; ++s)
+    for (size_type j=supernode_start[s]; j<supernode_start[s+1]; ++j)
+      supernode_of_column[j] = s;
+  supernode_parent.resize (n_sn);
+  children_start.assign (n_sn+1, 0);
+  for (unsigned int s=0; s<n_sn; ++s)
+    {
+      const size_type p = parent[supernode_start[s+1]-1];
+      supernode_parent[s] = (p == numbers::invalid_size_type ?
+                             numbers::invalid_unsigned_int :
+                             supernode_of_column[p]);
+      if (p != numbers::invalid_size_type)
+        ++children_start[supernode_parent[s]+1];
+    }
+  for (unsigned int s=0; s<n_sn; ++s)
+    children_start[s+1] += children_start[s];
+  children.resize (children_start[n_sn]);
+  {
+    std::vector<unsigned int> position (children_start.begin(), children_start.end()-1);
+    for (unsigned int s=0; s<n_sn; ++s)
+      if (supernode_parent[s] != numbers::invalid_unsigned_int)
+        children[position[supernode_parent[s]]++] = s;
+  }
+  first_descendant.resize (n_sn);
+  for (unsigned int s=0; s<n_sn; ++s)
+    first_descendant[s] = (children_start[s+1] > children_start[s] ?
+                           first_descendant[children[children_start[s]]] : s);
+
+  // the positions of the rows of every supernode in the rows of its parent,
+  // the layout of the factor, and the work for the subtrees
+  parent_position.assign (row_indices.size(), numbers::invalid_unsigned_int);
+  value_start.assign (n_sn+1, 0);
+  subtree_work.assign (n_sn, 0.);
+  std::vector<unsigned int> position (n);
+  for (unsigned int s=0; s<n_sn; ++s)
+    {
+      const unsigned int width = supernode_start[s+1]-supernode_start[s];
+      const unsigned int n_front = row_start[s+1]-row_start[s];
+
+      for (unsigned int i=0; i<n_front; ++i)
+        position[row_indices[row_start[s]+i]] = i;
+      for (unsigned int c=children_start[s]; c<children_start[s+1]; ++c)
+        {
+          const unsigned int child = children[c];
+          const unsigned int child_width = supernode_start[child+1]-supernode_start[child];
+          for (std::size_t i=row_start[child]+child_width; i<row_start[child+1]; ++i)
+            parent_position[i] = position[row_indices[i]];
+          subtree_work[s] += subtree_work[child];
+        }
+
+      value_start[s+1] = value_start[s] + std::size_t(n_front)*width;
+      for (unsigned int k=0; k<width; ++k)
+        subtree_work[s] += 1. * (n_front-k) * (n_front-k);
+    }
+
+  // for every entry of the matrix on or below the diagonal after
+  // renumbering, find the supernode and the position in its frontal matrix
+  // it is assembled into
+  assembly_start.assign (n_sn+1, 0);
+  for (size_type row=0; row<n; ++row)
+    for (SparsityPattern::iterator it=sparsity.begin(row);
+         it!=sparsity.end(row); ++it)
+      if (new_index[row] >= new_index[it->column()])
+        ++assembly_start[supernode_of_column[new_index[it->column()]]+1];
+  for (unsigned int s=0; s<n_sn; ++s)
+    assembly_start[s+1] += assembly_start[s];
+  assembly.resize (assembly_start[n_sn]);
+  {
+    std::vector<std::size_t> next (assembly_start.begin(), assembly_start.end()-1);
+    std::size_t entry = 0;
+    for (size_type row=0; row<n; ++row)
+      for (SparsityPattern::iterator it=sparsity.begin(row);
+           it!=sparsity.end(row); ++it, ++entry)
+        {
+          const size_type i = new_index[row];
+          const size_type j = new_index[it->column()];
+          if (i < j)
+            continue;
+          const unsigned int s = supernode_of_column[j];
+          const size_type *rows_begin = &row_indices[0] + row_start[s];
+          const size_type *rows_end = &row_indices[0] + row_start[s+1];
+          const std::size_t local_row = std::lower_bound (rows_begin, rows_end, i)
+                                        - rows_begin;
+          Assert (local_row < std::size_t(rows_end-rows_begin) &&
+                  rows_begin[local_row] == i, ExcInternalError());
+          assembly[next[s]++]
+            = std::make_pair (entry,
+                              (j-supernode_start[s]) * (rows_end-rows_begin) + local_row);
+        }
+  }
+
+  pivot_order.resize (n);
+  for (size_type i=0; i<n; ++i)
+    pivot_order[i] = i;
+  schur_complements.resize (n_sn);
+  perturbed_pivots.assign (n_sn, 0);
+  failed_pivot.assign (n_sn, std::make_pair (numbers::invalid_size_type, 0.));
+}
+
+
+
+void
+SparseDirectCholesky::factorize_supernode (const unsigned int         supernode,
+                                           const std::vector<double> &matrix_values)
+{
+  const size_type first = supernode_start[supernode];
+  const unsigned int width = supernode_start[supernode+1] - first;
+  const unsigned int n_front = row_start[supernode+1] - row_start[supernode];
+  const bool cholesky_factorization = (additional_data.factorization == cholesky);
+
+  // assemble the frontal matrix, of which we only use the part on and below
+  // the diagonal
+  std::vector<double> front_storage (std::size_t(n_front)*n_front, 0.);
+  double *front = front_storage.data();
+  for (std::size_t k=assembly_start[supernode]; k<assembly_start[supernode+1]; ++k)
+    front[assembly[k].second] += matrix_values[assembly[k].first];
+
+  for (unsigned int c=children_start[supernode]; c<children_start[supernode+1]; ++c)
+    {
+      const unsigned int child = children[c];
+      const unsigned int child_width = supernode_start[child+1]-supernode_start[child];
+      const unsigned int m = row_start[child+1]-row_start[child]-child_width;
+      const unsigned int *positions = &parent_position[row_start[child]+child_width];
+      const double *schur_complement = schur_complements[child].data();
+      for (unsigned int b=0; b<m; ++b)
+        {
+          double *column = front + std::size_t(positions[b])*n_front;
+          const double *update = schur_complement + std::size_t(b)*m;
+          for (unsigned int a=b; a<m; ++a)
+            column[positions[a]] += update[a];
+        }
+      std::vector<double>().swap (schur_complements[child]);
+    }
+
+  // factorize the columns of the supernode. for the Cholesky factorization,
+  // we go through them in blocks, updating the columns right of a block
+  // only once the whole block has been factorized. for the LDL^T
+  // factorization, the pivot search needs all columns of the supernode to
+  // be up to date, so we update them after every pivot, and only the
+  // columns right of the supernode once at the end
+  std::vector<double> w_storage;
+  const double *w = front;
+  if (!cholesky_factorization)
+    {
+      w_storage.resize (std::size_t(n_front)*width);
+      w = w_storage.data();
+    }
+  const auto entry = [&] (const unsigned int i,
+                          const unsigned int j) -> double &
+  {
+    return front[std::size_t(j)*n_front + i];
+  };
+  const auto w_entry = [&] (const unsigned int i,
+                            const unsigned int j) -> double &
+  {
+    return w_storage[std::size_t(j)*n_front + i];
+  };
+
+  size_type *pivots = &pivot_order[first];
+  for (unsigned int k=0; k<width; ++k)
+    pivots[k] = first + k;
+  perturbed_pivots[supernode] = 0;
+  failed_pivot[supernode] = std::make_pair (numbers::invalid_size_type, 0.);
+
+  const unsigned int block_size = cholesky_factorization ? 48 : width;
+  for (unsigned int block_begin=0; block_begin<width; block_begin+=block_size)
+    {
+      const unsigned int block_end = std::min (width, block_begin+block_size);
+      unsigned int k = block_begin;
+      while (k < block_end)
+        {
+          unsigned int pivot_size = 1;
+          if (cholesky_factorization)
+            {
+              double d = entry(k,k);
+              if (!(d > 0.))
+                {
+                  if (failed_pivot[supernode].first == numbers::invalid_size_type)
+                    failed_pivot[supernode] = std::make_pair (pivots[k], d);
+                  d = 1.;
+                }
+              const double l = std::sqrt (d);
+              entry(k,k) = l;
+              const double inverse = 1./l;
+              for (unsigned int i=k+1; i<n_front; ++i)
+                entry(i,k) *= inverse;
+            }
+          else
+            {
+              // Bunch-Kaufman pivot search among the remaining columns of the
+              // supernode
+              const double alpha = (1.+std::sqrt(17.))/8.;
+              const double abs_akk = std::abs (entry(k,k));
+              unsigned int imax = k;
+              double colmax = 0.;
+              for (unsigned int i=k+1; i<width; ++i)
+                if (std::abs (entry(i,k)) > colmax)
+                  {
+                    colmax = std::abs (entry(i,k));
+                    imax = i;
+                  }
+              if (colmax > 0. && abs_akk < alpha*colmax)
+                {
+                  double rowmax = 0.;
+                  for (unsigned int j=k; j<imax; ++j)
+                    rowmax = std::max (rowmax, std::abs (entry(imax,j)));
+                  for (unsigned int i=imax+1; i<width; ++i)
+                    rowmax = std::max (rowmax, std::abs (entry(i,imax)));
+                  if (abs_akk*rowmax >= alpha*colmax*colmax)
+                    ;
+                  else if (std::abs (entry(imax,imax)) >= alpha*rowmax)
+                    {
+                      symmetric_swap (front, n_front, k, imax);
+                      std::swap (pivots[k], pivots[imax]);
+                    }
+                  else
+                    {
+                      if (imax != k+1)
+                        {
+                          symmetric_swap (front, n_front, k+1, imax);
+                          std::swap (pivots[k+1], pivots[imax]);
+                        }
+                      pivot_size = 2;
+                    }
+                }
+
+              if (pivot_size == 1)
+                {
+                  double d = entry(k,k);
+                  if (std::abs (d) < perturbation)
+                    {
+                      d = (d < 0. ? -perturbation : perturbation);
+                      ++perturbed_pivots[supernode];
+                    }
+                  diagonal[first+k] = d;
+                  off_diagonal[first+k] = 0.;
+                  const double inverse = 1./d;
+                  for (unsigned int i=k+1; i<n_front; ++i)
+                    {
+                      w_entry(i,k) = entry(i,k);
+                      entry(i,k) *= inverse;
+                    }
+                }
+              else
+                {
+                  const double a = entry(k,k);
+                  const double b = entry(k+1,k);
+                  const double c = entry(k+1,k+1);
+                  const double inverse_determinant = 1./(a*c-b*b);
+                  diagonal[first+k] = a;
+                  diagonal[first+k+1] = c;
+                  off_diagonal[first+k] = b;
+                  off_diagonal[first+k+1] = 0.;
+                  entry(k+1,k) = 0.;
+                  for (unsigned int i=k+2; i<n_front; ++i)
+                    {
+                      const double w1 = entry(i,k), w2 = entry(i,k+1);
+                      w_entry(i,k) = w1;
+                      w_entry(i,k+1) = w2;
+                      entry(i,k) = (c*w1 - b*w2) * inverse_determinant;
+                      entry(i,k+1) = (a*w2 - b*w1) * inverse_determinant;
+                    }
+                }
+            }
+
+          update_columns (front, n_front, w, n_front, k+pivot_size, block_end,
+                          k, k+pivot_size);
+          k += pivot_size;
+        }
+
+      update_columns (front, n_front, w, n_front, block_end, n_front,
+                      block_begin, block_end);
+    }
+
+  // store the columns of L and the Schur complement for the parent
+  std::copy (front, front + std::size_t(n_front)*width,
+             factor_values.begin() + value_start[supernode]);
+  if (supernode_parent[supernode] != numbers::invalid_unsigned_int)
+    {
+      const unsigned int m = n_front - width;
+      std::vector<double> &schur_complement = schur_complements[supernode];
+      schur_complement.resize (std::size_t(m)*m);
+      for (unsigned int b=0; b<m; ++b)
+        {
+          const double *column = front + std::size_t(width+b)*n_front;
+          std::copy (column + width + b, column + n_front,
+                     schur_complement.begin() + std::size_t(b)*m + b);
+        }
+    }
+}
+
+
+
+template <typename number>
+void
+SparseDirectCholesky::factorize (const SparseMatrix<number> &matrix)
+{
+  Assert (matrix.m() == n_rows, ExcDimensionMismatch (matrix.m(), n_rows));
+  Assert (matrix.n() == n_rows, ExcDimensionMismatch (matrix.n(), n_rows));
+  Assert (matrix.n_nonzero_elements() == n_matrix_entries,
+          ExcSparsityPatternMismatch());
+
+  // copy the entries of the matrix to an array, in the order of the
+  // sparsity pattern, so that they can be accessed by their index
+  std::vector<double> values (n_matrix_entries);
+  double max_entry = 0.;
+  {
+    std::size_t index = 0;
+    for (size_type row=0; row<n_rows; ++row)
+      for (typename SparseMatrix<number>::const_iterator it=matrix.begin(row);
+           it!=matrix.end(row); ++it, ++index)
+        {
+          values[index] = it->value();
+          max_entry = std::max (max_entry, std::abs (values[index]));
+        }
+  }
+  perturbation = additional_data.pivot_threshold * (max_entry > 0. ? max_entry : 1.);
+
+  factor_values.resize (value_start.back());
+  if (additional_data.factorization == ldlt)
+    {
+      diagonal.resize (n_rows);
+      off_diagonal.resize (n_rows);
+    }
+
+  // factorize the supernodes in an order in which the children come before
+  // their parents, which the postorder of the supernodes is. with more
+  // than one thread, the subtrees whose work is small are given to tasks
+  // that factorize them sequentially. the thread that completes the last
+  // child of a larger supernode then goes on to factorize that supernode
+  // as well
+  const unsigned int n_sn = n_supernodes();
+  if (MultithreadInfo::n_threads() == 1 || n_sn < 2)
+    for (unsigned int s=0; s<n_sn; ++s)
+      factorize_supernode (s, values);
+  else
+    {
+      double total_work = 0.;
+      for (unsigned int s=0; s<n_sn; ++s)
+        if (supernode_parent[s] == numbers::invalid_unsigned_int)
+          total_work += subtree_work[s];
+      const double threshold = std::max (1e5, total_work /
+                                         (8.*MultithreadInfo::n_threads()));
+
+      std::unique_ptr<std::atomic<unsigned int>[]> pending_children
+      (new std::atomic<unsigned int>[n_sn]);
+      for (unsigned int s=0; s<n_sn; ++s)
+        pending_children[s] = children_start[s+1] - children_start[s];
+
+      const auto factorize_ancestors = [&] (unsigned int s)
+      {
+        while (supernode_parent[s] != numbers::invalid_unsigned_int &&
+               pending_children[supernode_parent[s]].fetch_sub(1) == 1)
+          {
+            s = supernode_parent[s];
+            factorize_supernode (s, values);
+          }
+      };
+
+      Threads::TaskGroup<> tasks;
+      for (unsigned int s=0; s<n_sn; ++s)
+        {
+          const unsigned int parent = supernode_parent[s];
+          if (subtree_work[s] <= threshold &&
+              (parent == numbers::invalid_unsigned_int ||
+               subtree_work[parent] > threshold))
+            tasks += Threads::new_task ([&,s] ()
+          {
+            for (unsigned int t=first_descendant[s]; t<=s; ++t)
+              factorize_supernode (t, values);
+            factorize_ancestors (s);
+          });
+          else if (subtree_work[s] > threshold &&
+                   children_start[s+1] == children_start[s])
+            tasks += Threads::new_task ([&,s] ()
+          {
+            factorize_supernode (s, values);
+            factorize_ancestors (s);
+          });
+        }
+      tasks.join_all ();
+    }
+
+  for (unsigned int s=0; s<n_sn; ++s)
+    if (failed_pivot[s].first != numbers::invalid_size_type)
+      {
+        const size_type row = std::find (new_index.begin(), new_index.end(),
+                                         failed_pivot[s].first) - new_index.begin();
+        AssertThrow (false, ExcNotPositiveDefinite (row, failed_pivot[s].second));
+      }
+}
+
+
+
+template <typename number>
+void
+SparseDirectCholesky::initialize (const SparseMatrix<number> &matrix,
+                                  const AdditionalData       &data)
+{
+  initialize (matrix.get_sparsity_pattern(), data);
+  factorize (matrix);
+}
+
+
+
+template <typename number>
+void
+SparseDirectCholesky::solve (Vector<number> &rhs_and_solution) const
+{
+  AssertDimension (rhs_and_solution.size(), n_rows);
+  Assert (factor_values.size() == value_start.back(), ExcNotInitialized());
+
+  const bool cholesky_factorization = (additional_data.factorization == cholesky);
+  std::vector<double> y (n_rows);
+  for (size_type i=0; i<n_rows; ++i)
+    y[new_index[i]] = rhs_and_solution(i);
+
+  std::vector<double> x_local;
+  const unsigned int n_sn = n_supernodes();
+
+  // forward substitution with L, and the solution with D
+  for (unsigned int s=0; s<n_sn; ++s)
+    {
+      const size_type first = supernode_start[s];
+      const unsigned int width = supernode_start[s+1] - first;
+      const unsigned int n_front = row_start[s+1] - row_start[s];
+      const size_type *rows = &row_indices[row_start[s]];
+      const size_type *pivots = &pivot_order[first];
+      const double *l = &factor_values[value_start[s]];
+
+      x_local.resize (width);
+      for (unsigned int k=0; k<width; ++k)
+        x_local[k] = y[pivots[k]];
+      for (unsigned int k=0; k<width; ++k)
+        {
+          const double *column = l + std::size_t(k)*n_front;
+          if (cholesky_factorization)
+            x_local[k] /= column[k];
+          const double value = x_local[k];
+          for (unsigned int i=k+1; i<width; ++i)
+            x_local[i] -= column[i] * value;
+          for (unsigned int i=width; i<n_front; ++i)
+            y[rows[i]] -= column[i] * value;
+        }
+
+      if (!cholesky_factorization)
+        for (unsigned int k=0; k<width; ++k)
+          {
+            if (off_diagonal[first+k] == 0.)
+              x_local[k] /= diagonal[first+k];
+            else
+              {
+                const double a = diagonal[first+k];
+                const double b = off_diagonal[first+k];
+                const double c = diagonal[first+k+1];
+                const double inverse_determinant = 1./(a*c-b*b);
+                const double x1 = x_local[k], x2 = x_local[k+1];
+                x_local[k] = (c*x1 - b*x2) * inverse_determinant;
+                x_local[k+1] = (a*x2 - b*x1) * inverse_determinant;
+                ++k;
+              }
+          }
+
+      for (unsigned int k=0; k<width; ++k)
+        y[pivots[k]] = x_local[k];
+    }
+
+  // backward substitution with L^T
+  for (unsigned int s=n_sn; s>0; )
+    {
+      --s;
+      const size_type first = supernode_start[s];
+      const unsigned int width = supernode_start[s+1] - first;
+      const unsigned int n_front = row_start[s+1] - row_start[s];
+      const size_type *rows = &row_indices[row_start[s]];
+      const size_type *pivots = &pivot_order[first];
+      const double *l = &factor_values[value_start[s]];
+
+      x_local.resize (width);
+      for (unsigned int k=0; k<width; ++k)
+        {
+          const double *column = l + std::size_t(k)*n_front;
+          double value = y[pivots[k]];
+          for (unsigned int i=width; i<n_front; ++i)
+            value -= column[i] * y[rows[i]];
+          x_local[k] = value;
+        }
+      for (unsigned int k=width; k>0; )
+        {
+          --k;
+          const double *column = l + std::size_t(k)*n_front;
+          double value = x_local[k];
+          for (unsigned int i=k+1; i<width; ++i)
+            value -= column[i] * x_local[i];
+          x_local[k] = (cholesky_factorization ? value / column[k] : value);
+        }
+
+      for (unsigned int k=0; k<width; ++k)
+        y[pivots[k]] = x_local[k];
+    }
+
+  for (size_type i=0; i<n_rows; ++i)
+    rhs_and_solution(i) = y[new_index[i]];
+}
+
+
+
+template <typename number>
+void
+SparseDirectCholesky::vmult (Vector<number>       &dst,
+                             const Vector<number> &src) const
+{
+  dst = src;
+  solve (dst);
+}
+
+
+
+template <typename number>
+void
+SparseDirectCholesky::Tvmult (Vector<number>       &dst,
+                              const Vector<number> &src) const
+{
+  dst = src;
+  solve (dst);
+}
+
+
+
+SparseDirectCholesky::size_type
+SparseDirectCholesky::m () const
+{
+  return n_rows;
+}
+
+
+
+SparseDirectCholesky::size_type
+SparseDirectCholesky::n () const
+{
+  return n_rows;
+}
+
+
+
+unsigned int
+SparseDirectCholesky::n_supernodes () const
+{
+  return supernode_start.empty() ? 0 : supernode_start.size()-1;
+}
+
+
+
+std::size_t
+SparseDirectCholesky::n_nonzero_elements () const
+{
+  std::size_t n_entries = 0;
+  for (unsigned int s=0; s<n_supernodes(); ++s)
+    {
+      const std::size_t width = supernode_start[s+1] - supernode_start[s];
+      n_entries += (value_start[s+1]-value_start[s]) - width*(width-1)/2;
+    }
+  return n_entries;
+}
+
+
+
+SparseDirectCholesky::size_type
+SparseDirectCholesky::n_perturbed_pivots () const
+{
+  size_type n_perturbed = 0;
+  for (unsigned int s=0; s<perturbed_pivots.size(); ++s)
+    n_perturbed += perturbed_pivots[s];
+  return n_perturbed;
+}
+
+
+
+std::size_t
+SparseDirectCholesky::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (new_index) +
+          MemoryConsumption::memory_consumption (supernode_start) +
+          MemoryConsumption::memory_consumption (supernode_parent) +
+          MemoryConsumption::memory_consumption (children) +
+          MemoryConsumption::memory_consumption (children_start) +
+          MemoryConsumption::memory_consumption (first_descendant) +
+          MemoryConsumption::memory_consumption (row_indices) +
+          MemoryConsumption::memory_consumption (row_start) +
+          MemoryConsumption::memory_consumption (parent_position) +
+          MemoryConsumption::memory_consumption (assembly) +
+          MemoryConsumption::memory_consumption (assembly_start) +
+          MemoryConsumption::memory_consumption (subtree_work) +
+          MemoryConsumption::memory_consumption (value_start) +
+          MemoryConsumption::memory_consumption (factor_values) +
+          MemoryConsumption::memory_consumption (pivot_order) +
+          MemoryConsumption::memory_consumption (diagonal) +
+          MemoryConsumption::memory_consumption (off_diagonal) +
+          MemoryConsumption::memory_consumption (perturbed_pivots) +
+          MemoryConsumption::memory_consumption (failed_pivot));
+}
+
+
+
+// explicit instantiations
+template void SparseDirectCholesky::factorize (const SparseMatrix<double> &);
+template void SparseDirectCholesky::factorize (const SparseMatrix<float> &);
+template void SparseDirectCholesky::initialize (const SparseMatrix<double> &,
+                                                const AdditionalData &);
+template void SparseDirectCholesky::initialize (const SparseMatrix<float> &,
+                                                const AdditionalData &);
+template void SparseDirectCholesky::solve (Vector<double> &) const;
+template void SparseDirectCholesky::solve (Vector<float> &) const;
+template void SparseDirectCholesky::vmult (Vector<double> &,
+                                           const Vector<double> &) const;
+template void SparseDirectCholesky::vmult (Vector<float> &,
+                                           const Vector<float> &) const;
+template void SparseDirectCholesky::Tvmult (Vector<double> &,
+                                            const Vector<double> &) const;
+template void SparseDirectCholesky::Tvmult (Vector<float> &,
+                                            const Vector<float> &) const;
+
+DEAL_II_NAMESPACE_CLOSE
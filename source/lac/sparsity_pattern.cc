@@ -16,6 +16,7 @@
 
 #include <deal.II/base/vector_slice.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/base/parallel.h>
 #include <deal.II/lac/sparsity_pattern.h>
 #include <deal.II/lac/sparsity_tools.h>
 #include <deal.II/lac/full_matrix.h>
@@ -538,6 +539,56 @@ SparsityPattern::copy_from (const DynamicSparsityPattern &dsp)
 
 
 
+void
+SparsityPattern::copy_from (const size_type                                          n_rows,
+                            const size_type                                          n_cols,
+                            const std::vector<unsigned int>                         &row_lengths,
+                            const std::function<void (const size_type, size_type *)> &fill_row)
+{
+  AssertDimension (row_lengths.size(), n_rows);
+  reinit (n_rows, n_cols, row_lengths);
+
+  if (n_rows == 0 || n_cols == 0)
+    return;
+
+  // let the caller write the sorted column indices of each row into the
+  // space we have just allocated. if the matrix is quadratic, move the
+  // diagonal entry to the front afterwards
+  parallel::apply_to_subranges
+  (size_type(0), n_rows,
+   [&] (const size_type begin,
+        const size_type end)
+  {
+    for (size_type row=begin; row<end; ++row)
+      {
+        size_type *const row_begin = &colnums[rowstart[row]];
+        size_type *const row_end = &colnums[rowstart[row+1]];
+        Assert (row_lengths[row] == static_cast<size_type>(row_end-row_begin),
+                ExcMessage ("Rows of a square sparsity pattern need at least "
+                            "one entry for the diagonal."));
+        fill_row (row, row_begin);
+        Assert (std::adjacent_find (row_begin, row_end,
+                                    std::greater_equal<size_type>()) == row_end,
+                ExcMessage ("The column indices of each row must be unique "
+                            "and sorted."));
+
+        if (store_diagonal_first_in_row)
+          {
+            size_type *diagonal = std::lower_bound (row_begin, row_end, row);
+            Assert (diagonal != row_end && *diagonal == row,
+                    ExcMessage ("The rows of a square sparsity pattern must "
+                                "contain the diagonal entry."));
+            std::rotate (row_begin, diagonal, diagonal+1);
+          }
+      }
+  },
+  256);
+
+  compressed = true;
+}
+
+
+
 template <typename number>
 void SparsityPattern::copy_from (const FullMatrix<number> &matrix)
 {
@@ -500,6 +500,288 @@ namespace SparsityTools
 
 
 
+  namespace internal
+  {
+    /**
+     * Store the graph of the sparsity pattern plus its transpose, without
+     * the diagonal, in compressed row storage.
+     */
+    void
+    make_symmetric_graph (const SparsityPattern                   &sparsity,
+                          std::vector<std::size_t>                &adjacency_start,
+                          std::vector<SparsityPattern::size_type> &adjacency)
+    {
+      typedef SparsityPattern::size_type size_type;
+      const size_type n = sparsity.n_rows();
+
+      adjacency_start.assign (n+1, 0);
+      for (size_type row=0; row<n; ++row)
+        for (SparsityPattern::iterator it=sparsity.begin(row);
+             it!=sparsity.end(row); ++it)
+          if (it->column() != row)
+            {
+              ++adjacency_start[row+1];
+              ++adjacency_start[it->column()+1];
+            }
+      for (size_type row=0; row<n; ++row)
+        adjacency_start[row+1] += adjacency_start[row];
+
+      adjacency.resize (adjacency_start[n]);
+      std::vector<std::size_t> position (adjacency_start.begin(),
+                                         adjacency_start.end()-1);
+      for (size_type row=0; row<n; ++row)
+        for (SparsityPattern::iterator it=sparsity.begin(row);
+             it!=sparsity.end(row); ++it)
+          if (it->column() != row)
+            {
+              adjacency[position[row]++] = it->column();
+              adjacency[position[it->column()]++] = row;
+            }
+
+      // remove the duplicates that an entry and its transpose create, and
+      // compress the arrays
+      std::size_t next_free = 0;
+      for (size_type row=0; row<n; ++row)
+        {
+          const std::size_t begin = adjacency_start[row];
+          std::sort (adjacency.begin()+begin, adjacency.begin()+adjacency_start[row+1]);
+          const std::size_t end = std::unique (adjacency.begin()+begin,
+                                               adjacency.begin()+adjacency_start[row+1])
+                                  - adjacency.begin();
+          adjacency_start[row] = next_free;
+          for (std::size_t j=begin; j<end; ++j)
+            adjacency[next_free++] = adjacency[j];
+        }
+      adjacency_start[n] = next_free;
+      adjacency.resize (next_free);
+    }
+
+
+
+    /**
+     * Compute a nested dissection ordering of a symmetric graph given in
+     * compressed row storage, with separators from breadth-first search
+     * level structures.
+     */
+    void
+    nested_dissection_by_level_structures (const std::vector<std::size_t>                &adjacency_start,
+                                           const std::vector<SparsityPattern::size_type> &adjacency,
+                                           std::vector<SparsityPattern::size_type>       &new_indices)
+    {
+      typedef SparsityPattern::size_type size_type;
+      const size_type n = adjacency_start.size()-1;
+      const size_type max_leaf_size = 64;
+
+      // the parts that still need to be numbered, together with the first
+      // number given to their vertices
+      std::vector<std::pair<std::vector<size_type>,size_type> > parts;
+      if (n > 0)
+        {
+          parts.emplace_back (std::vector<size_type>(n), 0);
+          for (size_type i=0; i<n; ++i)
+            parts.back().first[i] = i;
+        }
+
+      // a vertex belongs to the part currently processed if its entry in
+      // part_tag equals the current tag, and was reached by the current
+      // breadth-first search if its entry in visit_tag does
+      std::vector<size_type> part_tag (n, numbers::invalid_size_type);
+      std::vector<size_type> visit_tag (n, numbers::invalid_size_type);
+      std::vector<unsigned int> level (n);
+      size_type current_part = 0, current_search = 0;
+
+      std::vector<size_type> bfs_order;
+      std::vector<size_type> level_start;
+      const auto breadth_first_search = [&] (const size_type root)
+      {
+        ++current_search;
+        bfs_order.clear ();
+        level_start.assign (1, 0);
+        bfs_order.push_back (root);
+        visit_tag[root] = current_search;
+        level[root] = 0;
+        for (std::size_t i=0; i<bfs_order.size(); ++i)
+          {
+            const size_type v = bfs_order[i];
+            if (level[v] == level_start.size())
+              level_start.push_back (i);
+            for (std::size_t j=adjacency_start[v]; j<adjacency_start[v+1]; ++j)
+              {
+                const size_type w = adjacency[j];
+                if (part_tag[w] == current_part && visit_tag[w] != current_search)
+                  {
+                    visit_tag[w] = current_search;
+                    level[w] = level[v] + 1;
+                    bfs_order.push_back (w);
+                  }
+              }
+          }
+        level_start.push_back (bfs_order.size());
+      };
+      const auto degree = [&] (const size_type v)
+      {
+        return adjacency_start[v+1] - adjacency_start[v];
+      };
+
+      while (parts.size() > 0)
+        {
+          std::vector<size_type> vertices;
+          vertices.swap (parts.back().first);
+          const size_type first_number = parts.back().second;
+          parts.pop_back ();
+
+          const auto number_in_order = [&] (std::vector<size_type> &list,
+                                            const size_type         first)
+          {
+            std::sort (list.begin(), list.end());
+            for (size_type i=0; i<list.size(); ++i)
+              new_indices[list[i]] = first + i;
+          };
+
+          if (vertices.size() <= max_leaf_size)
+            {
+              number_in_order (vertices, first_number);
+              continue;
+            }
+
+          ++current_part;
+          for (const size_type v : vertices)
+            part_tag[v] = current_part;
+
+          size_type root = vertices[0];
+          for (const size_type v : vertices)
+            if (degree(v) < degree(root))
+              root = v;
+          breadth_first_search (root);
+
+          // a part that is not connected is split into the component we just
+          // found and the rest, without a separator
+          if (bfs_order.size() < vertices.size())
+            {
+              std::vector<size_type> rest;
+              rest.reserve (vertices.size() - bfs_order.size());
+              for (const size_type v : vertices)
+                if (visit_tag[v] != current_search)
+                  rest.push_back (v);
+              parts.emplace_back (bfs_order, first_number);
+              parts.emplace_back (std::move(rest), first_number + bfs_order.size());
+              continue;
+            }
+
+          // find a pseudo-peripheral vertex, i.e., one whose level structure
+          // is as deep as possible, by starting the search again from a
+          // vertex of minimal degree in the last level as long as this
+          // increases the number of levels
+          for (unsigned int iteration=0; iteration<10; ++iteration)
+            {
+              const size_type n_levels = level_start.size()-1;
+              size_type candidate = bfs_order[level_start[n_levels-1]];
+              for (std::size_t i=level_start[n_levels-1]; i<bfs_order.size(); ++i)
+                if (degree(bfs_order[i]) < degree(candidate))
+                  candidate = bfs_order[i];
+              breadth_first_search (candidate);
+              if (level_start.size()-1 > n_levels)
+                root = candidate;
+              else
+                {
+                  breadth_first_search (root);
+                  break;
+                }
+            }
+
+          const unsigned int n_levels = level_start.size()-1;
+          if (n_levels < 3)
+            {
+              number_in_order (vertices, first_number);
+              continue;
+            }
+
+          // take the level in which the first half of the vertices ends as
+          // separator level, but neither the first nor the last one. only
+          // those vertices of that level that are coupled to the next level
+          // are needed to separate the two parts
+          unsigned int separator_level = 1;
+          while (separator_level < n_levels-2 &&
+                 level_start[separator_level+1] < vertices.size()/2)
+            ++separator_level;
+
+          std::vector<size_type> part_1 (bfs_order.begin(),
+                                         bfs_order.begin()+level_start[separator_level]);
+          std::vector<size_type> part_2 (bfs_order.begin()+level_start[separator_level+1],
+                                         bfs_order.end());
+          std::vector<size_type> separator;
+          for (std::size_t i=level_start[separator_level];
+               i<level_start[separator_level+1]; ++i)
+            {
+              const size_type v = bfs_order[i];
+              bool coupled_to_next_level = false;
+              for (std::size_t j=adjacency_start[v]; j<adjacency_start[v+1]; ++j)
+                if (part_tag[adjacency[j]] == current_part &&
+                    level[adjacency[j]] == separator_level+1)
+                  {
+                    coupled_to_next_level = true;
+                    break;
+                  }
+              if (coupled_to_next_level)
+                separator.push_back (v);
+              else
+                part_1.push_back (v);
+            }
+
+          number_in_order (separator, first_number + part_1.size() + part_2.size());
+          const size_type first_number_2 = first_number + part_1.size();
+          parts.emplace_back (std::move(part_1), first_number);
+          parts.emplace_back (std::move(part_2), first_number_2);
+        }
+    }
+  }
+
+
+
+  void
+  reorder_nested_dissection (const SparsityPattern                   &sparsity,
+                             std::vector<SparsityPattern::size_type> &new_indices)
+  {
+    Assert (sparsity.n_rows() == sparsity.n_cols(),
+            ExcDimensionMismatch (sparsity.n_rows(), sparsity.n_cols()));
+    AssertDimension (new_indices.size(), sparsity.n_rows());
+
+    std::vector<std::size_t> adjacency_start;
+    std::vector<SparsityPattern::size_type> adjacency;
+    internal::make_symmetric_graph (sparsity, adjacency_start, adjacency);
+
+#ifdef DEAL_II_WITH_METIS
+    if (sparsity.n_rows() == 0)
+      return;
+
+    idx_t n = static_cast<idx_t>(sparsity.n_rows());
+    std::vector<idx_t> int_adjacency_start (adjacency_start.begin(),
+                                            adjacency_start.end());
+    std::vector<idx_t> int_adjacency (adjacency.begin(), adjacency.end());
+    // METIS does not like empty arrays
+    if (int_adjacency.empty())
+      int_adjacency.push_back (0);
+    std::vector<idx_t> permutation (n), inverse_permutation (n);
+
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions (options);
+    const int ierr = METIS_NodeND (&n, &int_adjacency_start[0], &int_adjacency[0],
+                                   nullptr, &options[0],
+                                   &permutation[0], &inverse_permutation[0]);
+    AssertThrow (ierr == METIS_OK, ExcMETISError (ierr));
+
+    // METIS returns the old index of each new index in 'permutation' and the
+    // new index of each old index in 'inverse_permutation'
+    std::copy (inverse_permutation.begin(), inverse_permutation.end(),
+               new_indices.begin());
+#else
+    internal::nested_dissection_by_level_structures (adjacency_start, adjacency,
+                                                     new_indices);
+#endif
+  }
+
+
+
 #ifdef DEAL_II_WITH_MPI
   void distribute_sparsity_pattern
   (DynamicSparsityPattern                               &dsp,
@@ -0,0 +1,151 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+#include <deal.II/lac/sweep_schedule.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/lac/exceptions.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+#include <algorithm>
+
+DEAL_II_NAMESPACE_OPEN
+
+
+SweepSchedule::SweepSchedule ()
+  :
+  ordering (level_scheduling)
+{}
+
+
+
+void
+SweepSchedule::initialize (const SparsityPattern &sparsity,
+                           const Ordering         ordering)
+{
+  Assert (sparsity.n_rows() == sparsity.n_cols(), ExcNotQuadratic());
+  Assert (sparsity.is_compressed(), SparsityPattern::ExcNotCompressed());
+
+  clear ();
+  this->ordering = ordering;
+
+  const size_type n = sparsity.n_rows();
+  const std::size_t *const rowstart = sparsity.rowstart.get();
+  const size_type *const colnums = sparsity.colnums.get();
+  row_group.resize (n, 0);
+
+  if (ordering == level_scheduling)
+    {
+      // go through the rows in their natural order. when we get to a row,
+      // all rows with smaller index that it is coupled to have been
+      // assigned their levels, either by an entry left of the diagonal in
+      // the current row, which we look at now, or by an entry right of the
+      // diagonal in the earlier row, which pushed its level forward to the
+      // current row when we were there
+      for (size_type row=0; row<n; ++row)
+        {
+          unsigned int level = row_group[row];
+          for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+            if (colnums[j] < row)
+              level = std::max (level, row_group[colnums[j]]+1);
+          row_group[row] = level;
+          for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+            if (colnums[j] > row)
+              row_group[colnums[j]] = std::max (row_group[colnums[j]], level+1);
+        }
+    }
+  else
+    {
+      // for a greedy coloring, we need to know all neighbors of a row that
+      // have already been colored. those left of the diagonal in the
+      // current row are readily available, but for a pattern that is not
+      // symmetric, we also need the rows with smaller index that have an
+      // entry in the column of the current row. collect them by a counting
+      // sort of the entries right of the diagonal
+      std::vector<std::size_t> transpose_start (n+1, 0);
+      for (size_type row=0; row<n; ++row)
+        for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+          if (colnums[j] > row)
+            ++transpose_start[colnums[j]+1];
+      for (size_type row=0; row<n; ++row)
+        transpose_start[row+1] += transpose_start[row];
+      std::vector<size_type> transpose_rows (transpose_start[n]);
+      {
+        std::vector<std::size_t> position (transpose_start.begin(),
+                                           transpose_start.end()-1);
+        for (size_type row=0; row<n; ++row)
+          for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+            if (colnums[j] > row)
+              transpose_rows[position[colnums[j]]++] = row;
+      }
+
+      // mark the colors of the neighbors with the index of the current row,
+      // and take the first color that is not marked
+      std::vector<size_type> color_used_by (1, numbers::invalid_size_type);
+      for (size_type row=0; row<n; ++row)
+        {
+          for (std::size_t j=rowstart[row]+1; j<rowstart[row+1]; ++j)
+            if (colnums[j] < row)
+              color_used_by[row_group[colnums[j]]] = row;
+          for (std::size_t j=transpose_start[row]; j<transpose_start[row+1]; ++j)
+            color_used_by[row_group[transpose_rows[j]]] = row;
+
+          unsigned int color = 0;
+          while (color < color_used_by.size() && color_used_by[color] == row)
+            ++color;
+          if (color == color_used_by.size())
+            color_used_by.push_back (numbers::invalid_size_type);
+          row_group[row] = color;
+        }
+    }
+
+  // sort the rows by their group, keeping the natural order within each
+  // group
+  const unsigned int n_groups = (n == 0 ? 0 :
+                                 *std::max_element (row_group.begin(),
+                                                    row_group.end()) + 1);
+  group_start.resize (n_groups+1, 0);
+  for (size_type row=0; row<n; ++row)
+    ++group_start[row_group[row]+1];
+  for (unsigned int group=0; group<n_groups; ++group)
+    group_start[group+1] += group_start[group];
+  rows.resize (n);
+  std::vector<size_type> position (group_start.begin(), group_start.end()-1);
+  for (size_type row=0; row<n; ++row)
+    rows[position[row_group[row]]++] = row;
+}
+
+
+
+void
+SweepSchedule::clear ()
+{
+  ordering = level_scheduling;
+  std::vector<unsigned int>().swap (row_group);
+  std::vector<size_type>().swap (rows);
+  std::vector<size_type>().swap (group_start);
+}
+
+
+
+std::size_t
+SweepSchedule::memory_consumption () const
+{
+  return (sizeof(*this) +
+          MemoryConsumption::memory_consumption (row_group) +
+          MemoryConsumption::memory_consumption (rows) +
+          MemoryConsumption::memory_consumption (group_start));
+}
+
+DEAL_II_NAMESPACE_CLOSE
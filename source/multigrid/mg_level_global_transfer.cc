@@ -288,6 +288,7 @@ MGLevelGlobalTransfer<LinearAlgebra::distributed::Vector<Number> >::clear()
   mg_constrained_dofs = nullptr;
   ghosted_global_vector.reinit(0);
   ghosted_level_vector.resize(0, 0);
+  external_partitioners.clear();
 }
 
 
@@ -93,8 +93,15 @@ void MGTransferMatrixFree<dim,Number>::clear ()
 
 template <int dim, typename Number>
 void MGTransferMatrixFree<dim,Number>::build
-(const DoFHandler<dim,dim>  &mg_dof)
+(const DoFHandler<dim,dim>  &mg_dof,
+ const std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> > &external_partitioners)
 {
+  Assert(external_partitioners.empty() ||
+         external_partitioners.size() == mg_dof.get_triangulation().n_global_levels(),
+         ExcDimensionMismatch(external_partitioners.size(),
+                              mg_dof.get_triangulation().n_global_levels()));
+  this->external_partitioners = external_partitioners;
+
   this->fill_and_communicate_copy_indices(mg_dof);
 
   std::vector<std::vector<Number> > weights_unvectorized;
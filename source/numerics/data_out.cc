@@ -325,7 +325,7 @@ void DataOut<dim,DoFHandlerType>::build_patches (const unsigned int n_subdivisio
 template <int dim, typename DoFHandlerType>
 void DataOut<dim,DoFHandlerType>::build_patches
 (const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
- const unsigned int                                                        n_subdivisions_,
+ const unsigned int                                                        n_subdivisions,
  const CurvedCellRegion                                                    curved_region)
 {
   // Check consistency of redundant template parameter
@@ -334,14 +334,24 @@ void DataOut<dim,DoFHandlerType>::build_patches
   Assert (this->triangulation != nullptr,
           Exceptions::DataOut::ExcNoTriangulationSelected());
 
-  const unsigned int n_subdivisions = (n_subdivisions_ != 0)
-                                      ? n_subdivisions_
-                                      : this->default_subdivisions;
-  Assert (n_subdivisions >= 1,
-          Exceptions::DataOut::ExcInvalidNumberOfSubdivisions(n_subdivisions));
-
   this->validate_dataset_names();
 
+  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  std::vector<std::vector<unsigned int> > cell_to_patch_index_map;
+  collect_cells (all_cells, cell_to_patch_index_map);
+
+  build_patches_on_cell_range (mapping, n_subdivisions, curved_region,
+                               all_cells.data(), all_cells.data()+all_cells.size(),
+                               cell_to_patch_index_map);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::collect_cells
+(std::vector<std::pair<cell_iterator, unsigned int> > &all_cells,
+ std::vector<std::vector<unsigned int> >              &cell_to_patch_index_map)
+{
   // First count the cells we want to create patches of. Also fill the object
   // that maps the cell indices to the patch numbers, as this will be needed
   // for generation of neighborship information.
@@ -355,7 +365,7 @@ void DataOut<dim,DoFHandlerType>::build_patches
   // It turns out that we create one patch for each selected cell, so patch_index==cell_index.
   //
   // will be cell_to_patch_index_map[cell->level][cell->index] = patch_index
-  std::vector<std::vector<unsigned int> > cell_to_patch_index_map;
+  cell_to_patch_index_map.clear ();
   cell_to_patch_index_map.resize (this->triangulation->n_levels());
   for (unsigned int l=0; l<this->triangulation->n_levels(); ++l)
     {
@@ -373,7 +383,7 @@ void DataOut<dim,DoFHandlerType>::build_patches
     }
 
   // will be all_cells[patch_index] = pair(cell, active_index)
-  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  all_cells.clear ();
   {
     // important: we need to compute the active_index of the cell in the range
     // 0..n_active_cells() because this is where we need to look up cell
@@ -409,9 +419,27 @@ void DataOut<dim,DoFHandlerType>::build_patches
         all_cells.emplace_back (cell, active_index);
       }
   }
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::build_patches_on_cell_range
+(const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
+ const unsigned int                                                        n_subdivisions_,
+ const CurvedCellRegion                                                    curved_region,
+ const std::pair<cell_iterator, unsigned int>                             *begin,
+ const std::pair<cell_iterator, unsigned int>                             *end,
+ const std::vector<std::vector<unsigned int> >                            &cell_to_patch_index_map)
+{
+  const unsigned int n_subdivisions = (n_subdivisions_ != 0)
+                                      ? n_subdivisions_
+                                      : this->default_subdivisions;
+  Assert (n_subdivisions >= 1,
+          Exceptions::DataOut::ExcInvalidNumberOfSubdivisions(n_subdivisions));
 
   this->patches.clear ();
-  this->patches.resize(all_cells.size());
+  this->patches.resize(end-begin);
 
   // now create a default object for the WorkStream object to work with
   unsigned int n_datasets=this->cell_data.size();
@@ -450,9 +478,9 @@ void DataOut<dim,DoFHandlerType>::build_patches
                cell_to_patch_index_map);
 
   // now build the patches in parallel
-  if (all_cells.size() > 0)
-    WorkStream::run (&all_cells[0],
-                     &all_cells[0]+all_cells.size(),
+  if (begin != end)
+    WorkStream::run (begin,
+                     end,
                      std::bind(&DataOut<dim,DoFHandlerType>::build_one_patch,
                                this,
                                std::placeholders::_1,
@@ -478,6 +506,85 @@ void DataOut<dim,DoFHandlerType>::build_patches
 
 
 
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::write_vtu_in_parallel_streaming
+(const char        *filename,
+ MPI_Comm           comm,
+ const unsigned int n_subdivisions,
+ const unsigned int n_cells_per_batch)
+{
+  write_vtu_in_parallel_streaming (StaticMappingQ1<DoFHandlerType::dimension,DoFHandlerType::space_dimension>::mapping,
+                                   filename, comm, n_subdivisions, no_curved_cells,
+                                   n_cells_per_batch);
+}
+
+
+
+template <int dim, typename DoFHandlerType>
+void DataOut<dim,DoFHandlerType>::write_vtu_in_parallel_streaming
+(const Mapping<DoFHandlerType::dimension,DoFHandlerType::space_dimension> &mapping,
+ const char                                                               *filename,
+ MPI_Comm                                                                  comm,
+ const unsigned int                                                        n_subdivisions,
+ const CurvedCellRegion                                                    curved_region,
+ const unsigned int                                                        n_cells_per_batch)
+{
+  Assert (dim==DoFHandlerType::dimension, ExcDimensionMismatch(dim, DoFHandlerType::dimension));
+
+  Assert (this->triangulation != nullptr,
+          Exceptions::DataOut::ExcNoTriangulationSelected());
+  Assert (n_cells_per_batch > 0,
+          ExcMessage ("The number of cells per batch must be positive."));
+
+  this->validate_dataset_names();
+
+  std::vector<std::pair<cell_iterator, unsigned int> > all_cells;
+  std::vector<std::vector<unsigned int> > cell_to_patch_index_map;
+  collect_cells (all_cells, cell_to_patch_index_map);
+
+  // the patches of a batch are stored in this->patches starting at index
+  // zero, so only the cells of the current batch get an entry in the map
+  // from cells to patches. this also means that the neighbor information
+  // of the patches only refers to cells of the same batch, which is of no
+  // concern for the VTU format
+  for (unsigned int i=0; i<all_cells.size(); ++i)
+    cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()]
+      = dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+      DoFHandlerType::space_dimension>::no_neighbor;
+
+  const unsigned int n_batches = (all_cells.size() + n_cells_per_batch - 1) / n_cells_per_batch;
+  unsigned int previous_batch = numbers::invalid_unsigned_int;
+
+  const auto build_batch = [&](const unsigned int batch)
+  {
+    if (previous_batch != numbers::invalid_unsigned_int)
+      for (unsigned int i=previous_batch*n_cells_per_batch;
+           i<std::min<std::size_t>((previous_batch+1)*n_cells_per_batch, all_cells.size()); ++i)
+        cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()]
+          = dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+          DoFHandlerType::space_dimension>::no_neighbor;
+
+    const unsigned int begin = batch*n_cells_per_batch;
+    const unsigned int end = std::min<std::size_t>(begin+n_cells_per_batch, all_cells.size());
+    for (unsigned int i=begin; i<end; ++i)
+      cell_to_patch_index_map[all_cells[i].first->level()][all_cells[i].first->index()]
+        = i-begin;
+
+    build_patches_on_cell_range (mapping, n_subdivisions, curved_region,
+                                 all_cells.data()+begin, all_cells.data()+end,
+                                 cell_to_patch_index_map);
+    previous_batch = batch;
+  };
+
+  this->write_vtu_in_parallel_batched (filename, comm, n_batches, build_batch);
+
+  // release the memory of the last batch
+  std::vector<dealii::DataOutBase::Patch<DoFHandlerType::dimension,
+      DoFHandlerType::space_dimension> >().swap (this->patches);
+}
+
+
+
 template <int dim, typename DoFHandlerType>
 typename DataOut<dim,DoFHandlerType>::cell_iterator
 DataOut<dim,DoFHandlerType>::first_cell ()
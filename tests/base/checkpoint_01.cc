@@ -0,0 +1,105 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// write a few blocks of different types and sizes, including an empty one,
+// to a checkpoint file with CheckpointWriter and read them back with
+// CheckpointReader
+
+#include "../tests.h"
+#include <deal.II/base/checkpoint.h>
+#include <deal.II/base/mpi.h>
+
+#include <cstdint>
+
+
+void test ()
+{
+  std::vector<double> doubles (5);
+  for (unsigned int i=0; i<doubles.size(); ++i)
+    doubles[i] = 1.5 * i;
+  std::vector<int> ints (1000);
+  for (unsigned int i=0; i<ints.size(); ++i)
+    ints[i] = 3 * i - 7;
+  const std::string text = "restart";
+
+  {
+    CheckpointWriter writer ("checkpoint", MPI_COMM_SELF);
+    writer.write_block ("doubles", doubles.data(), doubles.size());
+    writer.write_block ("empty", doubles.data(), 0);
+    writer.write_block ("ints", ints.data(), ints.size());
+    writer.write_block ("text", text.c_str(), text.size());
+
+    try
+      {
+        writer.write_block ("ints", ints.data(), ints.size());
+      }
+    catch (const CheckpointWriter::ExcDuplicateBlockName &)
+      {
+        deallog << "Duplicate block name detected" << std::endl;
+      }
+    writer.close ();
+  }
+
+  CheckpointReader reader ("checkpoint", MPI_COMM_SELF);
+  deallog << "Writers: " << reader.n_writer_processes() << std::endl;
+  deallog << "Has block 'ints': " << reader.has_block ("ints") << std::endl;
+  deallog << "Has block 'other': " << reader.has_block ("other") << std::endl;
+
+  const ArrayView<const double> read_doubles = reader.get_block<double> ("doubles", 0);
+  deallog << "doubles:";
+  for (unsigned int i=0; i<read_doubles.size(); ++i)
+    deallog << " " << read_doubles[i];
+  deallog << std::endl;
+
+  deallog << "empty: " << reader.get_block ("empty", 0).size() << " bytes" << std::endl;
+
+  const ArrayView<const int> read_ints = reader.get_block<int> ("ints", 0);
+  bool ints_agree = (read_ints.size() == ints.size());
+  for (unsigned int i=0; i<read_ints.size() && ints_agree; ++i)
+    ints_agree = (read_ints[i] == ints[i]);
+  deallog << "ints: " << read_ints.size() << " entries, agree: "
+          << (ints_agree ? "yes" : "no") << std::endl;
+
+  const ArrayView<const char> read_text = reader.get_block ("text", 0);
+  deallog << "text: " << std::string (read_text.begin(), read_text.end()) << std::endl;
+
+  // all blocks must be aligned in memory
+  deallog << "Aligned: "
+          << (reinterpret_cast<std::uintptr_t>(read_doubles.begin()) % CheckpointWriter::alignment == 0 &&
+              reinterpret_cast<std::uintptr_t>(read_ints.begin()) % CheckpointWriter::alignment == 0 &&
+              reinterpret_cast<std::uintptr_t>(read_text.begin()) % CheckpointWriter::alignment == 0
+              ? "yes" : "no")
+          << std::endl;
+
+  try
+    {
+      reader.get_block ("other", 0);
+    }
+  catch (const CheckpointReader::ExcBlockNotFound &)
+    {
+      deallog << "Missing block detected" << std::endl;
+    }
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  initlog();
+
+  test ();
+}
@@ -0,0 +1,140 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// CheckpointReader must reject files whose header or directory contains
+// offsets or sizes pointing beyond the end of the file or the directory,
+// rather than reading outside of the mapped memory. corrupt the fields of a
+// valid file one at a time, using the layout of the header: a 16 byte
+// magic string followed by the version, the byte order marker, the number
+// of writers, the number of blocks, and the offset and size of the
+// directory, each as 8 byte integer
+
+#include "../tests.h"
+#include <deal.II/base/checkpoint.h>
+#include <deal.II/base/mpi.h>
+
+#include <fstream>
+
+
+const unsigned long long int huge = static_cast<unsigned long long int>(-1) - 7;
+
+
+void write_file ()
+{
+  std::vector<double> doubles (5, 1.);
+  CheckpointWriter writer ("checkpoint", MPI_COMM_SELF);
+  writer.write_block ("doubles", doubles.data(), doubles.size());
+  writer.write_block ("more doubles", doubles.data(), doubles.size());
+  writer.close ();
+}
+
+
+
+unsigned long long int read_value (const std::streamoff position)
+{
+  std::ifstream file ("checkpoint", std::ios::binary);
+  file.seekg (position);
+  unsigned long long int value;
+  file.read (reinterpret_cast<char *>(&value), sizeof(value));
+  return value;
+}
+
+
+
+void write_value (const std::streamoff          position,
+                  const unsigned long long int value)
+{
+  std::fstream file ("checkpoint", std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp (position);
+  file.write (reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+
+
+void check (const std::string &name)
+{
+  try
+    {
+      CheckpointReader reader ("checkpoint", MPI_COMM_SELF);
+      deallog << name << ": accepted" << std::endl;
+    }
+  catch (const CheckpointReader::ExcInvalidCheckpointFile &)
+    {
+      deallog << name << ": rejected" << std::endl;
+    }
+}
+
+
+
+void test ()
+{
+  const std::streamoff n_writers_position = 32;
+  const std::streamoff n_blocks_position = 40;
+  const std::streamoff directory_offset_position = 48;
+  const std::streamoff directory_size_position = 56;
+
+  write_file ();
+  check ("valid file");
+  const std::streamoff directory_offset = read_value (directory_offset_position);
+  const unsigned long long int directory_size = read_value (directory_size_position);
+
+  write_value (directory_size_position, directory_size + 1);
+  check ("directory size beyond end of file");
+
+  write_file ();
+  write_value (directory_offset_position, huge);
+  check ("directory offset overflowing");
+
+  write_file ();
+  write_value (directory_size_position, huge);
+  check ("directory size overflowing");
+
+  write_file ();
+  write_value (n_blocks_position, 3);
+  check ("too many blocks");
+
+  write_file ();
+  write_value (n_writers_position, huge);
+  check ("too many writers");
+
+  write_file ();
+  write_value (directory_offset, directory_size);
+  check ("name length beyond end of directory");
+
+  write_file ();
+  write_value (directory_offset, huge);
+  check ("name length overflowing");
+
+  // the offset of the part of the first writer follows the name
+  write_file ();
+  write_value (directory_offset + 8 + 7, huge);
+  check ("block offset overflowing");
+
+  write_file ();
+  write_value (directory_offset + 8 + 7 + 8, huge);
+  check ("block size overflowing");
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  initlog();
+
+  test ();
+}
@@ -0,0 +1,163 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the operations that every specialization of VectorizedArray
+// implements with intrinsics against their scalar definition: gather and
+// scatter with unordered offsets, vectorized_load_and_transpose and
+// vectorized_transpose_and_store for all numbers of entries up to several
+// times the vector width (to cover the blocked part as well as the
+// remainder), and the math functions sqrt, abs, max and min. The output does
+// not depend on the vector width, so the same comparison file serves for
+// SSE2, AVX and AVX-512 as well as for the 128-bit NEON and VSX
+// specializations, e.g. when running the testsuite under QEMU with one of
+// the toolchain files in doc/developers/.
+
+#include "../tests.h"
+
+#include <deal.II/base/vectorization.h>
+#include <deal.II/base/aligned_vector.h>
+
+
+template <typename Number>
+void test ()
+{
+  const unsigned int n_vectors = VectorizedArray<Number>::n_array_elements;
+
+  // the number of lanes must match the width of the registers selected at
+  // configure time
+  const unsigned int register_bits[4] = {0, 128, 256, 512};
+  const unsigned int expected_n_vectors =
+    DEAL_II_COMPILER_VECTORIZATION_LEVEL == 0 ? 1 :
+    register_bits[DEAL_II_COMPILER_VECTORIZATION_LEVEL]/(8*sizeof(Number));
+  deallog << "Vector width matches vectorization level: "
+          << (n_vectors == expected_n_vectors &&
+              sizeof(VectorizedArray<Number>) == n_vectors*sizeof(Number) ?
+              "yes" : "no") << std::endl;
+
+  // offsets that are neither sorted nor multiples of the vector width, with
+  // enough space in between for the largest number of entries transposed
+  // below
+  const unsigned int max_entries = 4*n_vectors+3;
+  const unsigned int stride = max_entries+2;
+  unsigned int offsets[n_vectors];
+  for (unsigned int v=0; v<n_vectors; ++v)
+    offsets[v] = stride*((3*v+1)%n_vectors) + v%3;
+
+  std::vector<Number> values (stride*(n_vectors+1));
+  for (unsigned int i=0; i<values.size(); ++i)
+    values[i] = Number(1)+i;
+
+  unsigned int n_errors = 0;
+  VectorizedArray<Number> gathered;
+  gathered.gather (values.data()+1, offsets);
+  for (unsigned int v=0; v<n_vectors; ++v)
+    if (gathered[v] != values[offsets[v]+1])
+      ++n_errors;
+
+  std::vector<Number> scattered (values.size(), Number(-1));
+  gathered.scatter (offsets, scattered.data()+1);
+  for (unsigned int i=0; i<scattered.size(); ++i)
+    {
+      bool is_target = false;
+      for (unsigned int v=0; v<n_vectors; ++v)
+        if (offsets[v]+1 == i)
+          is_target = true;
+      if (scattered[i] != (is_target ? values[i] : Number(-1)))
+        ++n_errors;
+    }
+  deallog << "gather/scatter #errors: " << n_errors << std::endl;
+
+  n_errors = 0;
+  AlignedVector<VectorizedArray<Number> > transposed (max_entries);
+  for (unsigned int n_entries=1; n_entries<=max_entries; ++n_entries)
+    {
+      vectorized_load_and_transpose (n_entries, values.data(), offsets,
+                                     transposed.begin());
+      for (unsigned int i=0; i<n_entries; ++i)
+        for (unsigned int v=0; v<n_vectors; ++v)
+          if (transposed[i][v] != values[offsets[v]+i])
+            ++n_errors;
+
+      std::vector<Number> stored (values);
+      vectorized_transpose_and_store (true, n_entries, transposed.begin(),
+                                      offsets, stored.data());
+      for (unsigned int v=0; v<n_vectors; ++v)
+        for (unsigned int i=0; i<n_entries; ++i)
+          if (stored[offsets[v]+i] != Number(2)*values[offsets[v]+i])
+            ++n_errors;
+
+      std::fill (stored.begin(), stored.end(), Number(-1));
+      vectorized_transpose_and_store (false, n_entries, transposed.begin(),
+                                      offsets, stored.data());
+      for (unsigned int i=0; i<stored.size(); ++i)
+        {
+          bool is_target = false;
+          for (unsigned int v=0; v<n_vectors; ++v)
+            if (i >= offsets[v] && i < offsets[v]+n_entries)
+              is_target = true;
+          if (stored[i] != (is_target ? values[i] : Number(-1)))
+            ++n_errors;
+        }
+    }
+  deallog << "load_and_transpose/transpose_and_store for up to "
+          << "4*width+3 entries #errors: " << n_errors << std::endl;
+
+  n_errors = 0;
+  VectorizedArray<Number> a, b;
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      a[v] = (v%2 ? Number(-1) : Number(1)) * (Number(0.5)+v);
+      b[v] = Number(3.25) - Number(0.75)*v;
+    }
+  const VectorizedArray<Number> sqrt_a = std::sqrt(std::abs(a));
+  const VectorizedArray<Number> abs_a = std::abs(a);
+  const VectorizedArray<Number> max_ab = std::max(a, b);
+  const VectorizedArray<Number> min_ab = std::min(a, b);
+  const VectorizedArray<Number> quotient = a / b;
+  const VectorizedArray<Number> negated = -a;
+  for (unsigned int v=0; v<n_vectors; ++v)
+    {
+      if (sqrt_a[v] != std::sqrt(std::abs(a[v])))
+        ++n_errors;
+      if (abs_a[v] != std::abs(a[v]))
+        ++n_errors;
+      if (max_ab[v] != std::max(a[v], b[v]))
+        ++n_errors;
+      if (min_ab[v] != std::min(a[v], b[v]))
+        ++n_errors;
+      if (quotient[v] != a[v] / b[v])
+        ++n_errors;
+      if (negated[v] != -a[v])
+        ++n_errors;
+    }
+  deallog << "sqrt/abs/max/min/division/negation #errors: " << n_errors
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  deallog.push("double");
+  test<double> ();
+  deallog.pop();
+  deallog.push("float");
+  test<float> ();
+  deallog.pop();
+}
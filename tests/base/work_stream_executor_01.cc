@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the work stealing executors of WorkStream::run: with
+// WorkStream::work_stealing the copier must see the elements in the order of
+// the range, with WorkStream::work_stealing_unordered_copier it must see all
+// of them exactly once. the worker has a strongly varying cost. also check
+// the colored version of WorkStream::run with the work stealing executor
+
+#include "../tests.h"
+
+#include <deal.II/base/work_stream.h>
+
+#include <thread>
+#include <chrono>
+
+
+struct ScratchData
+{};
+
+
+struct CopyData
+{
+  unsigned int computed;
+};
+
+
+void worker (const std::vector<unsigned int>::iterator &i,
+             ScratchData &,
+             CopyData &copy_data)
+{
+  // make a few elements much more expensive than the others
+  if (*i % 37 == 0)
+    std::this_thread::sleep_for (std::chrono::milliseconds(2));
+  copy_data.computed = *i;
+}
+
+
+std::vector<unsigned int> copied;
+
+void copier (const CopyData &copy_data)
+{
+  copied.push_back (copy_data.computed);
+}
+
+
+// in the colored run, elements with the same remainder modulo 10 conflict,
+// so the copier may write into the slot of that remainder without a race
+std::vector<types::global_dof_index>
+conflictor (const std::vector<unsigned int>::iterator &i)
+{
+  return std::vector<types::global_dof_index> (1, *i % 10);
+}
+
+
+std::vector<unsigned int> copied_sum (10);
+
+void colored_copier (const CopyData &copy_data)
+{
+  copied_sum[copy_data.computed % 10] += copy_data.computed;
+}
+
+
+
+void test (const WorkStream::Executor executor)
+{
+  WorkStream::set_executor (executor);
+
+  std::vector<unsigned int> v;
+  for (unsigned int i=0; i<1000; ++i)
+    v.push_back (i);
+
+  // use a small queue to get many waves
+  copied.clear ();
+  WorkStream::run (v.begin(), v.end(), &worker, &copier,
+                   ScratchData(), CopyData(), 3, 4);
+
+  AssertThrow (copied.size() == v.size(), ExcInternalError());
+  if (executor == WorkStream::work_stealing)
+    deallog << "Copier in order: "
+            << (copied == v ? "yes" : "no") << std::endl;
+  else
+    {
+      std::sort (copied.begin(), copied.end());
+      deallog << "Copier saw all elements: "
+              << (copied == v ? "yes" : "no") << std::endl;
+    }
+
+  std::fill (copied_sum.begin(), copied_sum.end(), 0U);
+  WorkStream::run (GraphColoring::make_graph_coloring (v.begin(), v.end(),
+                                                       std::function<std::vector<types::global_dof_index>
+                                                       (const std::vector<unsigned int>::iterator &)>
+                                                       (&conflictor)),
+                   &worker, &colored_copier,
+                   ScratchData(), CopyData());
+  bool all_seen = true;
+  for (unsigned int r=0; r<10; ++r)
+    {
+      unsigned int sum = 0;
+      for (unsigned int i=r; i<v.size(); i+=10)
+        sum += i;
+      if (sum != copied_sum[r])
+        all_seen = false;
+    }
+  deallog << "Colored run saw all elements: "
+          << (all_seen ? "yes" : "no") << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  deallog.push ("work_stealing");
+  test (WorkStream::work_stealing);
+  deallog.pop ();
+
+  deallog.push ("work_stealing_unordered_copier");
+  test (WorkStream::work_stealing_unordered_copier);
+  deallog.pop ();
+
+  WorkStream::set_executor (WorkStream::pipeline);
+}
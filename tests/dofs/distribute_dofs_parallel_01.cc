@@ -0,0 +1,128 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// DoFHandler::distribute_dofs numbers the dofs in parallel. check that the
+// result is the same as when numbering cell by cell, i.e., that the dofs on
+// each vertex, line and quad are numbered when the first cell that contains
+// the object is visited, for several numbers of threads
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_accessor.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <map>
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+        if (index % 5 == 0)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+
+  FE_Q<dim> fe (3);
+  DoFHandler<dim> dof_handler (tria);
+
+  for (unsigned int n_threads=1; n_threads<=4; n_threads*=2)
+    {
+      MultithreadInfo::set_thread_limit (n_threads);
+      dof_handler.distribute_dofs (fe);
+
+      // number the dofs cell by cell and compare with the dof indices
+      // stored in the DoFHandler
+      std::map<unsigned int, types::global_dof_index> first_vertex_dof, first_line_dof, first_quad_dof;
+      types::global_dof_index next_free_dof = 0;
+      bool same = true;
+      for (typename DoFHandler<dim>::active_cell_iterator
+           cell = dof_handler.begin_active(); cell != dof_handler.end(); ++cell)
+        {
+          for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+            {
+              if (first_vertex_dof.find (cell->vertex_index(v)) == first_vertex_dof.end())
+                {
+                  first_vertex_dof[cell->vertex_index(v)] = next_free_dof;
+                  next_free_dof += fe.dofs_per_vertex;
+                }
+              for (unsigned int d=0; d<fe.dofs_per_vertex; ++d)
+                if (cell->vertex_dof_index(v,d) != first_vertex_dof[cell->vertex_index(v)] + d)
+                  same = false;
+            }
+
+          if (dim > 1)
+            for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+              {
+                if (first_line_dof.find (cell->line_index(l)) == first_line_dof.end())
+                  {
+                    first_line_dof[cell->line_index(l)] = next_free_dof;
+                    next_free_dof += fe.dofs_per_line;
+                  }
+                for (unsigned int d=0; d<fe.dofs_per_line; ++d)
+                  if (cell->line(l)->dof_index(d) != first_line_dof[cell->line_index(l)] + d)
+                    same = false;
+              }
+
+          if (dim > 2)
+            for (unsigned int q=0; q<GeometryInfo<dim>::quads_per_cell; ++q)
+              {
+                if (first_quad_dof.find (cell->quad_index(q)) == first_quad_dof.end())
+                  {
+                    first_quad_dof[cell->quad_index(q)] = next_free_dof;
+                    next_free_dof += fe.dofs_per_quad;
+                  }
+                for (unsigned int d=0; d<fe.dofs_per_quad; ++d)
+                  if (cell->quad(q)->dof_index(d) != first_quad_dof[cell->quad_index(q)] + d)
+                    same = false;
+              }
+
+          const unsigned int dofs_per_cell_interior
+            = (dim == 2 ? fe.dofs_per_quad : fe.dofs_per_hex);
+          for (unsigned int d=0; d<dofs_per_cell_interior; ++d)
+            if (cell->dof_index(d) != next_free_dof++)
+              same = false;
+        }
+
+      deallog << "dim=" << dim << ", threads=" << n_threads
+              << ", n_dofs=" << dof_handler.n_dofs()
+              << ", same as cell by cell: "
+              << (same && next_free_dof == dof_handler.n_dofs() ? "yes" : "no")
+              << std::endl;
+    }
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,115 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// DoFTools::make_compressed_sparsity_pattern must produce the same
+// SparsityPattern as DoFTools::make_sparsity_pattern with a
+// DynamicSparsityPattern, for a vector-valued element with hanging node and
+// boundary constraints, with and without keeping constrained dofs, and for
+// several numbers of threads
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+
+bool identical (const SparsityPattern &a,
+                const SparsityPattern &b)
+{
+  if (a.n_rows() != b.n_rows() || a.n_cols() != b.n_cols() ||
+      a.n_nonzero_elements() != b.n_nonzero_elements())
+    return false;
+  for (unsigned int row=0; row<a.n_rows(); ++row)
+    {
+      if (a.row_length(row) != b.row_length(row))
+        return false;
+      SparsityPattern::iterator p = a.begin(row), q = b.begin(row);
+      for (; p != a.end(row); ++p, ++q)
+        if (p->column() != q->column())
+          return false;
+    }
+  return true;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+        if (index % 4 == 0)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+
+  FESystem<dim> fe (FE_Q<dim>(2), dim);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  DoFTools::make_zero_boundary_constraints (dof_handler, 0, constraints);
+  constraints.close ();
+
+  for (unsigned int keep=0; keep<2; ++keep)
+    {
+      DynamicSparsityPattern dsp (dof_handler.n_dofs());
+      DoFTools::make_sparsity_pattern (dof_handler, dsp, constraints, keep);
+      SparsityPattern reference;
+      reference.copy_from (dsp);
+
+      for (unsigned int n_threads=1; n_threads<=4; n_threads*=2)
+        {
+          MultithreadInfo::set_thread_limit (n_threads);
+          SparsityPattern sparsity;
+          DoFTools::make_compressed_sparsity_pattern (dof_handler, sparsity,
+                                                      constraints, keep);
+          deallog << "dim=" << dim
+                  << ", keep_constrained_dofs=" << (keep ? "true" : "false")
+                  << ", threads=" << n_threads
+                  << ", n_nonzero=" << sparsity.n_nonzero_elements()
+                  << ", identical: "
+                  << (identical (sparsity, reference) ? "yes" : "no")
+                  << std::endl;
+        }
+      MultithreadInfo::set_thread_limit (testing_max_num_threads());
+    }
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
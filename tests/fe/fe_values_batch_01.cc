@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that FEValuesBatch computes the same values, gradients, and
+// geometric quantities as FEValues, for scalar and vector-valued elements
+// on a curved mesh, including batches that are not completely filled
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_nedelec.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_raviart_thomas.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/fe_values_batch.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+
+template <int dim>
+void test (const FiniteElement<dim> &fe)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  static const SphericalManifold<dim> manifold;
+  tria.set_all_manifold_ids_on_boundary (0);
+  tria.set_manifold (0, manifold);
+  tria.refine_global (1);
+
+  const MappingQGeneric<dim> mapping (2);
+  const QGauss<dim> quadrature (fe.degree+1);
+  const UpdateFlags flags = update_values | update_gradients |
+                            update_quadrature_points | update_JxW_values |
+                            update_jacobians | update_inverse_jacobians;
+  FEValues<dim> fe_values (mapping, fe, quadrature, flags);
+  FEValuesBatch<dim> fe_values_batch (mapping, fe, quadrature, flags);
+  const unsigned int n_lanes = FEValuesBatch<dim>::n_lanes;
+
+  std::vector<typename Triangulation<dim>::active_cell_iterator> cells;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    cells.push_back (cell);
+  // leave out the last cell so that the last batch is not full
+  cells.pop_back ();
+
+  double max_difference = 0;
+  bool unused_lanes_zero = true;
+  for (unsigned int first=0; first<cells.size(); first+=n_lanes)
+    {
+      std::vector<typename Triangulation<dim>::active_cell_iterator>
+      batch (cells.begin()+first,
+             cells.begin()+std::min<std::size_t>(first+n_lanes, cells.size()));
+      fe_values_batch.reinit (batch);
+
+      for (unsigned int lane=0; lane<batch.size(); ++lane)
+        {
+          fe_values.reinit (batch[lane]);
+          for (unsigned int q=0; q<quadrature.size(); ++q)
+            {
+              const double scale = std::abs (fe_values.JxW(q));
+              max_difference = std::max (max_difference,
+                                         std::abs (fe_values.JxW(q) -
+                                                   fe_values_batch.JxW(q)[lane]) / scale);
+              for (unsigned int d=0; d<dim; ++d)
+                {
+                  max_difference = std::max (max_difference,
+                                             std::abs (fe_values.quadrature_point(q)[d] -
+                                                       fe_values_batch.quadrature_point(q)[d][lane]));
+                  for (unsigned int e=0; e<dim; ++e)
+                    max_difference = std::max (max_difference,
+                                               std::abs (fe_values.jacobian(q)[d][e] -
+                                                         fe_values_batch.jacobian(q)[d][e][lane]) +
+                                               std::abs (fe_values.inverse_jacobian(q)[d][e] -
+                                                         fe_values_batch.inverse_jacobian(q)[d][e][lane]));
+                }
+
+              for (unsigned int i=0; i<fe.dofs_per_cell; ++i)
+                for (unsigned int c=0; c<fe.n_components(); ++c)
+                  {
+                    max_difference = std::max (max_difference,
+                                               std::abs (fe_values.shape_value_component(i,q,c) -
+                                                         fe_values_batch.shape_value_component(i,q,c)[lane]));
+                    for (unsigned int d=0; d<dim; ++d)
+                      max_difference = std::max (max_difference,
+                                                 std::abs (fe_values.shape_grad_component(i,q,c)[d] -
+                                                           fe_values_batch.shape_grad_component(i,q,c)[d][lane]));
+                  }
+            }
+        }
+
+      for (unsigned int lane=batch.size(); lane<n_lanes; ++lane)
+        for (unsigned int q=0; q<quadrature.size(); ++q)
+          if (fe_values_batch.JxW(q)[lane] != 0.)
+            unused_lanes_zero = false;
+    }
+
+  deallog << fe.get_name() << ": " << cells.size() << " cells, "
+          << (max_difference < 1e-10 ? "values agree" : "values differ")
+          << ", JxW on unused lanes "
+          << (unused_lanes_zero ? "zero" : "nonzero") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> (FE_Q<2>(2));
+  test<2> (FESystem<2>(FE_Q<2>(2), 2, FE_DGQ<2>(1), 1));
+  test<2> (FE_Nedelec<2>(1));
+  test<2> (FE_RaviartThomas<2>(1));
+  test<2> (FESystem<2>(FE_RaviartThomas<2>(0), 1, FE_DGQ<2>(0), 1));
+
+  test<3> (FE_Q<3>(1));
+  test<3> (FE_Nedelec<3>(0));
+  test<3> (FE_RaviartThomas<3>(0));
+  test<3> (FESystem<3>(FE_Nedelec<3>(0), 1, FE_Q<3>(1), 1));
+}
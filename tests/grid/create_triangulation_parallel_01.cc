@@ -0,0 +1,168 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Triangulation::create_triangulation finds the lines and quads of the
+// coarse mesh by sorting in parallel. check for a mesh large enough to be
+// split up, with cells in all kinds of orientations, that the result does
+// not depend on the number of threads: all lines and faces must be
+// numbered and oriented the same way and the neighbors must be the same
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_reordering.h>
+#include <deal.II/grid/grid_tools.h>
+
+
+// rotate the vertices of a cell by 90 degrees around the z-axis (in 3d) or
+// the origin (in 2d)
+void rotate (CellData<2> &cell)
+{
+  const unsigned int permutation[4] = { 1, 3, 0, 2 };
+  const CellData<2> old_cell = cell;
+  for (unsigned int v=0; v<4; ++v)
+    cell.vertices[v] = old_cell.vertices[permutation[v]];
+}
+
+
+void rotate (CellData<3> &cell)
+{
+  const unsigned int permutation[8] = { 1, 3, 0, 2, 5, 7, 4, 6 };
+  const CellData<3> old_cell = cell;
+  for (unsigned int v=0; v<8; ++v)
+    cell.vertices[v] = old_cell.vertices[permutation[v]];
+}
+
+
+
+template <int dim>
+void create_grid (Triangulation<dim> &tria,
+                  const unsigned int  n_subdivisions)
+{
+  Triangulation<dim> tmp;
+  std::vector<unsigned int> repetitions (dim, n_subdivisions);
+  Point<dim> p;
+  for (unsigned int d=0; d<dim; ++d)
+    p[d] = 1;
+  GridGenerator::subdivided_hyper_rectangle (tmp, repetitions, Point<dim>(), p);
+
+  std::vector<Point<dim> > vertices = tmp.get_vertices();
+  std::vector<CellData<dim> > cells;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tmp.begin_active(); cell != tmp.end(); ++cell)
+    {
+      CellData<dim> c;
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        c.vertices[v] = cell->vertex_index (v);
+      c.material_id = 0;
+      for (unsigned int r=0; r<cells.size() % 4; ++r)
+        rotate (c);
+      cells.push_back (c);
+    }
+
+  // in 2d, the rotated cells are inconsistently oriented and need to be
+  // reordered first. in 3d, we keep them as they are to get faces in
+  // non-standard orientation
+  if (dim == 2)
+    GridReordering<dim>::reorder_cells (cells, true);
+  tria.create_triangulation (vertices, cells, SubCellData());
+}
+
+
+
+template <int dim>
+void print_info (const Triangulation<dim> &tria)
+{
+  unsigned int n_boundary_faces = 0;
+  unsigned int n_non_standard_faces = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      {
+        if (cell->at_boundary(f))
+          ++n_boundary_faces;
+        if (!cell->face_orientation(f) || cell->face_flip(f) || cell->face_rotation(f))
+          ++n_non_standard_faces;
+      }
+
+  deallog << "cells: " << tria.n_cells()
+          << ", lines: " << tria.n_lines()
+          << ", quads: " << tria.n_quads()
+          << ", boundary faces: " << n_boundary_faces
+          << ", faces in non-standard orientation: " << n_non_standard_faces
+          << std::endl;
+}
+
+
+
+template <int dim>
+void test (const unsigned int n_subdivisions)
+{
+  Triangulation<dim> serial_tria, parallel_tria;
+  MultithreadInfo::set_thread_limit (1);
+  create_grid (serial_tria, n_subdivisions);
+  MultithreadInfo::set_thread_limit (4);
+  create_grid (parallel_tria, n_subdivisions);
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+
+  print_info (serial_tria);
+
+  bool identical = (serial_tria.n_lines() == parallel_tria.n_lines() &&
+                    serial_tria.n_quads() == parallel_tria.n_quads());
+
+  typename Triangulation<dim>::active_cell_iterator
+  cell = serial_tria.begin_active(), other_cell = parallel_tria.begin_active();
+  for (; identical && cell != serial_tria.end(); ++cell, ++other_cell)
+    {
+      for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+        if (cell->line_index(l) != other_cell->line_index(l) ||
+            cell->line_orientation(l) != other_cell->line_orientation(l) ||
+            cell->line(l)->vertex_index(0) != other_cell->line(l)->vertex_index(0) ||
+            cell->line(l)->vertex_index(1) != other_cell->line(l)->vertex_index(1))
+          identical = false;
+
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->face_index(f) != other_cell->face_index(f) ||
+            cell->face_orientation(f) != other_cell->face_orientation(f) ||
+            cell->face_flip(f) != other_cell->face_flip(f) ||
+            cell->face_rotation(f) != other_cell->face_rotation(f) ||
+            cell->at_boundary(f) != other_cell->at_boundary(f) ||
+            (!cell->at_boundary(f) &&
+             cell->neighbor_index(f) != other_cell->neighbor_index(f)))
+          identical = false;
+    }
+
+  deallog << "Serial and parallel triangulation identical: "
+          << (identical ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> (40);
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> (12);
+  deallog.pop ();
+}
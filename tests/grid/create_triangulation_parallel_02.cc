@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// benchmark the setup of a large generated coarse mesh: read a mesh in msh
+// format with GridIn, with and without GridReordering::reorder_cells (see
+// GridIn::set_reorder_cells), and with one and several threads in
+// Triangulation::create_triangulation. the timings are printed to the
+// screen, whereas the output file only records that all variants result in
+// the same mesh
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_in.h>
+#include <deal.II/grid/grid_out.h>
+
+#include <sstream>
+
+
+template <int dim>
+bool identical (const Triangulation<dim> &tria1,
+                const Triangulation<dim> &tria2)
+{
+  if (tria1.n_vertices() != tria2.n_vertices() ||
+      tria1.n_cells() != tria2.n_cells() ||
+      tria1.n_lines() != tria2.n_lines() ||
+      tria1.n_quads() != tria2.n_quads())
+    return false;
+
+  typename Triangulation<dim>::active_cell_iterator
+  cell = tria1.begin_active(), other_cell = tria2.begin_active();
+  for (; cell != tria1.end(); ++cell, ++other_cell)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (cell->face_index(f) != other_cell->face_index(f) ||
+          cell->face_orientation(f) != other_cell->face_orientation(f) ||
+          cell->at_boundary(f) != other_cell->at_boundary(f))
+        return false;
+  return true;
+}
+
+
+
+template <int dim>
+void read (Triangulation<dim> &tria,
+           const std::string  &mesh,
+           const bool          reorder,
+           const unsigned int  n_threads,
+           const std::string  &name)
+{
+  MultithreadInfo::set_thread_limit (n_threads);
+  Timer timer;
+  std::istringstream in (mesh);
+  GridIn<dim> grid_in;
+  grid_in.attach_triangulation (tria);
+  grid_in.set_reorder_cells (reorder);
+  grid_in.read_msh (in);
+  timer.stop ();
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+
+  std::cout << dim << "d, " << tria.n_cells() << " cells, " << name
+            << ": " << timer.wall_time() << " s" << std::endl;
+}
+
+
+
+template <int dim>
+void test (const unsigned int n_subdivisions)
+{
+  std::string mesh;
+  {
+    Triangulation<dim> tria;
+    GridGenerator::subdivided_hyper_cube (tria, n_subdivisions);
+    std::ostringstream out;
+    GridOut().write_msh (tria, out);
+    mesh = out.str();
+  }
+
+  Triangulation<dim> reference, no_reordering, serial;
+  read (reference, mesh, true, 4, "reordering, 4 threads");
+  read (no_reordering, mesh, false, 4, "no reordering, 4 threads");
+  read (serial, mesh, true, 1, "reordering, 1 thread");
+
+  deallog << "cells: " << reference.n_cells()
+          << ", lines: " << reference.n_lines()
+          << ", quads: " << reference.n_quads() << std::endl;
+  deallog << "Same mesh without reordering: "
+          << (identical (reference, no_reordering) ? "yes" : "no") << std::endl;
+  deallog << "Same mesh with one thread: "
+          << (identical (reference, serial) ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> (300);
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> (40);
+  deallog.pop ();
+}
@@ -0,0 +1,110 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// read the same meshes from files in version 1 of the MSH format, in version
+// 4.1 as text and in binary form, and in version 2.2 in binary form, and
+// check that we get the same triangulation, including material and boundary
+// ids, each time
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_in.h>
+
+#include <string>
+
+
+template <int dim>
+void read_file (const std::string  &name,
+                Triangulation<dim> &tria)
+{
+  GridIn<dim> gi;
+  gi.attach_triangulation (tria);
+  std::ifstream in (name.c_str(), std::ios::binary);
+  gi.read_msh (in);
+}
+
+
+
+template <int dim>
+bool identical (const Triangulation<dim> &a,
+                const Triangulation<dim> &b)
+{
+  if (a.n_vertices() != b.n_vertices() ||
+      a.n_active_cells() != b.n_active_cells())
+    return false;
+  for (unsigned int v=0; v<a.n_vertices(); ++v)
+    if (a.get_vertices()[v].distance (b.get_vertices()[v]) != 0)
+      return false;
+
+  typename Triangulation<dim>::active_cell_iterator
+  cell_a = a.begin_active(), cell_b = b.begin_active();
+  for (; cell_a != a.end(); ++cell_a, ++cell_b)
+    {
+      if (cell_a->material_id() != cell_b->material_id())
+        return false;
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        if (cell_a->vertex_index(v) != cell_b->vertex_index(v))
+          return false;
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell_a->face(f)->boundary_id() != cell_b->face(f)->boundary_id())
+          return false;
+    }
+  return true;
+}
+
+
+
+template <int dim>
+void check (const std::string &reference_name,
+            const std::string &name)
+{
+  Triangulation<dim> reference;
+  read_file (SOURCE_DIR "/grids/" + reference_name, reference);
+
+  unsigned int n_boundary_faces = 0;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = reference.begin_active(); cell != reference.end(); ++cell)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (cell->at_boundary(f) && (cell->face(f)->boundary_id() == 1))
+        ++n_boundary_faces;
+  deallog << dim << "d: " << reference.n_vertices() << " vertices, "
+          << reference.n_active_cells() << " cells with material id "
+          << static_cast<int>(reference.begin_active()->material_id())
+          << ", " << n_boundary_faces << " boundary faces with id 1"
+          << std::endl;
+
+  const char *variants[] = { "v41", "v41_binary", "v22_binary" };
+  for (unsigned int i=0; i<3; ++i)
+    {
+      Triangulation<dim> tria;
+      read_file (SOURCE_DIR "/grids/" + name + "." + variants[i] + ".msh", tria);
+      deallog << variants[i] << " identical: "
+              << (identical (reference, tria) ? "yes" : "no") << std::endl;
+    }
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  check<2> ("grid_in_msh_01.2da.msh", "grid_in_msh_04.2d");
+  check<3> ("grid_in_msh_01.3da.msh", "grid_in_msh_04.3d");
+}
@@ -0,0 +1,142 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check GridTools::Cache: compare the closest vertex and the cell around
+// random points with the results of the functions of GridTools that do not
+// use the cache, on an adaptively refined mesh, before and after further
+// refinement, and check the grouping of GridTools::compute_point_locations
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/fe/mapping_q1.h>
+
+
+template <int dim>
+void check (const GridTools::Cache<dim> &cache)
+{
+  const Triangulation<dim> &tria = cache.get_triangulation();
+  const Mapping<dim> &mapping = cache.get_mapping();
+
+  std::vector<Point<dim> > points;
+  for (unsigned int i=0; i<1000; ++i)
+    {
+      Point<dim> p;
+      for (unsigned int d=0; d<dim; ++d)
+        p[d] = 2. * Testing::rand() / RAND_MAX - 1.;
+      points.push_back (p);
+    }
+  // add some vertices, which lie on the boundary of several cells
+  for (unsigned int v=0; v<tria.n_vertices(); v+=7)
+    if (tria.vertex_used(v))
+      points.push_back (tria.get_vertices()[v]);
+
+  unsigned int n_vertices_agree = 0, n_cells_agree = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      if (cache.find_closest_vertex (points[i]) ==
+          GridTools::find_closest_vertex (tria, points[i]))
+        ++n_vertices_agree;
+
+      const std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+      cell_and_point = GridTools::find_active_cell_around_point (cache, points[i]),
+      reference = GridTools::find_active_cell_around_point (mapping, tria, points[i]);
+      if (cell_and_point.first == reference.first &&
+          cell_and_point.second.distance (reference.second) < 1e-12)
+        ++n_cells_agree;
+    }
+  deallog << "Number of cells: " << tria.n_active_cells()
+          << ", number of points: " << points.size() << std::endl;
+  deallog << "Closest vertex agrees for " << n_vertices_agree << " points"
+          << std::endl;
+  deallog << "Cell agrees for " << n_cells_agree << " points" << std::endl;
+
+  const std::tuple<std::vector<typename Triangulation<dim>::active_cell_iterator>,
+        std::vector<std::vector<Point<dim> > >,
+        std::vector<std::vector<unsigned int> > >
+        locations = GridTools::compute_point_locations (cache, points);
+  const std::vector<typename Triangulation<dim>::active_cell_iterator> &cells
+    = std::get<0>(locations);
+
+  std::vector<bool> point_found (points.size(), false);
+  bool all_inside = true;
+  for (unsigned int c=0; c<cells.size(); ++c)
+    for (unsigned int q=0; q<std::get<2>(locations)[c].size(); ++q)
+      {
+        const unsigned int i = std::get<2>(locations)[c][q];
+        AssertThrow (point_found[i] == false, ExcInternalError());
+        point_found[i] = true;
+        // the Newton iteration of transform_real_to_unit_cell() stops once
+        // the residual, measured in unit coordinates, is below 1e-11
+        if (mapping.transform_unit_to_real_cell (cells[c], std::get<1>(locations)[c][q])
+            .distance (points[i]) > 1e-10)
+          all_inside = false;
+      }
+  deallog << "compute_point_locations found "
+          << std::count (point_found.begin(), point_found.end(), true)
+          << " points in " << cells.size() << " cells, all inside: "
+          << (all_inside ? "yes" : "no") << std::endl;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, -1, 1);
+  tria.refine_global (2);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      for (typename Triangulation<dim>::active_cell_iterator cell = tria.begin_active();
+           cell != tria.end(); ++cell)
+        if (cell->center().norm() < 0.6)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+
+  // distort the mesh such that cells are not aligned with the coordinate
+  // axes
+  GridTools::distort_random (0.2, tria, true);
+
+  GridTools::Cache<dim> cache (tria);
+  check (cache);
+
+  // the cache must notice the refinement
+  for (typename Triangulation<dim>::active_cell_iterator cell = tria.begin_active();
+       cell != tria.end(); ++cell)
+    if (cell->center()[0] > 0.3)
+      cell->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+  check (cache);
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> ();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> ();
+  deallog.pop ();
+}
@@ -0,0 +1,104 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check GridTools::find_active_cell_around_point with a GridTools::Cache for
+// points close to the curved boundary of a ball described by a higher order
+// mapping. these points lie outside the bounding boxes of the vertices of
+// all cells, so they must be found through the cells around the closest
+// vertex. points outside the ball must be reported as not found
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/grid/grid_tools_cache.h>
+#include <deal.II/grid/manifold_lib.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+
+template <int dim>
+void test ()
+{
+  const SphericalManifold<dim> manifold;
+  Triangulation<dim> tria;
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+  tria.set_manifold (0, manifold);
+
+  const MappingQGeneric<dim> mapping (4);
+  GridTools::Cache<dim> cache (tria, mapping);
+
+  // the vertices on the boundary of the coarse ball lie on the diagonals, so
+  // points close to the boundary in the direction of the coordinate axes
+  // are far outside the bounding boxes of the vertices of the cells
+  std::vector<Point<dim> > points;
+  for (unsigned int d=0; d<dim; ++d)
+    for (int sign=-1; sign<=1; sign+=2)
+      for (unsigned int i=0; i<3; ++i)
+        {
+          Point<dim> p;
+          p[d] = sign;
+          p[(d+1)%dim] = 0.1 * i;
+          points.push_back (p / p.norm() * 0.99);
+        }
+
+  unsigned int n_outside_boxes = 0, n_found = 0, n_agree = 0;
+  for (unsigned int i=0; i<points.size(); ++i)
+    {
+      if (cache.get_cells_with_bounding_box_around_point (points[i]).size() == 0)
+        ++n_outside_boxes;
+      const std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+      cell_and_point = GridTools::find_active_cell_around_point (cache, points[i]);
+      if (mapping.transform_unit_to_real_cell (cell_and_point.first, cell_and_point.second)
+          .distance (points[i]) < 1e-10)
+        ++n_found;
+
+      const std::pair<typename Triangulation<dim>::active_cell_iterator, Point<dim> >
+      reference = GridTools::find_active_cell_around_point (mapping, tria, points[i]);
+      if (cell_and_point.first == reference.first)
+        ++n_agree;
+    }
+  deallog << "Number of points: " << points.size()
+          << ", outside all bounding boxes: " << n_outside_boxes << std::endl;
+  deallog << "Found: " << n_found << ", same cell as without cache: "
+          << n_agree << std::endl;
+
+  Point<dim> outside;
+  outside[0] = 1.1;
+  try
+    {
+      GridTools::find_active_cell_around_point (cache, outside);
+    }
+  catch (const GridTools::ExcPointNotFound<dim> &)
+    {
+      deallog << "Point outside the ball not found" << std::endl;
+    }
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> ();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> ();
+  deallog.pop ();
+}
@@ -0,0 +1,135 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check GridTools::compute_hilbert_order, which must visit the cells of a
+// uniform mesh such that consecutive cells are face neighbors,
+// GridTools::partition_triangulation_hilbert with and without cell weights,
+// and DoFRenumbering::hilbert
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (dim == 2 ? 4 : 3);
+
+  std::vector<typename Triangulation<dim>::active_cell_iterator> cells;
+  std::vector<Point<dim> > centers;
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    {
+      cells.push_back (cell);
+      centers.push_back (cell->center());
+    }
+
+  const std::vector<unsigned int> order = GridTools::compute_hilbert_order (centers);
+  bool all_neighbors = true;
+  for (unsigned int i=1; i<order.size(); ++i)
+    {
+      bool neighbors = false;
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (!cells[order[i-1]]->at_boundary(f) &&
+            cells[order[i-1]]->neighbor(f) == cells[order[i]])
+          neighbors = true;
+      if (!neighbors)
+        all_neighbors = false;
+    }
+  deallog << "Consecutive cells are neighbors: "
+          << (all_neighbors ? "yes" : "no") << std::endl;
+
+  const unsigned int n_partitions = 5;
+  GridTools::partition_triangulation_hilbert (n_partitions, tria);
+  std::vector<unsigned int> n_cells (n_partitions);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    ++n_cells[cell->subdomain_id()];
+  deallog << "Cells per subdomain:";
+  for (unsigned int p=0; p<n_partitions; ++p)
+    deallog << ' ' << n_cells[p];
+  deallog << std::endl;
+
+  // cells in the left half of the domain are three times as expensive
+  std::vector<double> weights (tria.n_active_cells());
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    weights[cell->active_cell_index()] = (cell->center()[0] < 0.5 ? 3. : 1.);
+  GridTools::partition_triangulation_hilbert (n_partitions, tria, weights);
+  std::vector<double> weight_per_partition (n_partitions);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    weight_per_partition[cell->subdomain_id()] += weights[cell->active_cell_index()];
+  deallog << "Weight per subdomain:";
+  for (unsigned int p=0; p<n_partitions; ++p)
+    deallog << ' ' << weight_per_partition[p];
+  deallog << std::endl;
+
+  // renumber the dofs on an adaptively refined mesh
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->center().norm() < 0.4)
+      cell->set_refine_flag ();
+  tria.execute_coarsening_and_refinement ();
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  std::vector<types::global_dof_index> renumbering (dof_handler.n_dofs());
+  DoFRenumbering::compute_hilbert (renumbering, dof_handler);
+  std::vector<bool> seen (dof_handler.n_dofs(), false);
+  for (unsigned int i=0; i<renumbering.size(); ++i)
+    seen[renumbering[i]] = true;
+  deallog << "Renumbering is a permutation: "
+          << (std::find (seen.begin(), seen.end(), false) == seen.end() ? "yes" : "no")
+          << std::endl;
+
+  DoFRenumbering::hilbert (dof_handler);
+  DynamicSparsityPattern dsp (dof_handler.n_dofs());
+  DoFTools::make_sparsity_pattern (dof_handler, dsp);
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+  deallog << "Number of dofs: " << dof_handler.n_dofs()
+          << ", bandwidth: " << sparsity.bandwidth() << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> ();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> ();
+  deallog.pop ();
+}
@@ -0,0 +1,132 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Triangulation::execute_coarsening_and_refinement computes the new
+// vertices in parallel. check that the refined triangulation does not
+// depend on the number of threads, i.e., that all vertices are the same
+// bit by bit and that all objects are stored at the same places
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+
+
+void create_grid (Triangulation<2> &tria)
+{
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+}
+
+
+void create_grid (Triangulation<3> &tria)
+{
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+}
+
+
+void create_grid (Triangulation<2,3> &tria)
+{
+  GridGenerator::hyper_sphere (tria);
+  tria.set_all_manifold_ids (0);
+}
+
+
+
+template <int dim, int spacedim>
+void create_and_refine (Triangulation<dim,spacedim>          &tria,
+                        const SphericalManifold<dim,spacedim> &manifold)
+{
+  create_grid (tria);
+  tria.set_manifold (0, manifold);
+  tria.refine_global (1);
+
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim,spacedim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+        if (index % 3 == 0)
+          cell->set_refine_flag ();
+        else if (dim == 2 && index % 3 == 1)
+          cell->set_refine_flag (RefinementCase<dim>::cut_x);
+      tria.execute_coarsening_and_refinement ();
+    }
+}
+
+
+
+template <int dim, int spacedim>
+void test ()
+{
+  const SphericalManifold<dim,spacedim> manifold;
+
+  Triangulation<dim,spacedim> serial_tria, parallel_tria;
+  MultithreadInfo::set_thread_limit (1);
+  create_and_refine (serial_tria, manifold);
+  MultithreadInfo::set_thread_limit (4);
+  create_and_refine (parallel_tria, manifold);
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+
+  bool identical = (serial_tria.n_vertices() == parallel_tria.n_vertices() &&
+                    serial_tria.n_levels() == parallel_tria.n_levels());
+  for (unsigned int v=0; identical && v<serial_tria.n_vertices(); ++v)
+    if (serial_tria.vertex_used(v) != parallel_tria.vertex_used(v) ||
+        serial_tria.get_vertices()[v] != parallel_tria.get_vertices()[v])
+      identical = false;
+
+  typename Triangulation<dim,spacedim>::cell_iterator
+  cell = serial_tria.begin(), other_cell = parallel_tria.begin();
+  for (; identical && cell != serial_tria.end(); ++cell, ++other_cell)
+    {
+      if (cell->level() != other_cell->level() ||
+          cell->index() != other_cell->index() ||
+          cell->refinement_case() != other_cell->refinement_case())
+        identical = false;
+      for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+        if (cell->vertex_index(v) != other_cell->vertex_index(v))
+          identical = false;
+      for (unsigned int l=0; l<GeometryInfo<dim>::lines_per_cell; ++l)
+        if (cell->line_index(l) != other_cell->line_index(l))
+          identical = false;
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->face_index(f) != other_cell->face_index(f))
+          identical = false;
+      for (unsigned int c=0; c<cell->n_children(); ++c)
+        if (cell->child_index(c) != other_cell->child_index(c))
+          identical = false;
+    }
+
+  deallog << "dim=" << dim << ", spacedim=" << spacedim
+          << ": number of active cells: " << serial_tria.n_active_cells()
+          << ", identical: " << (identical ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2,2> ();
+  test<3,3> ();
+  test<2,3> ();
+}
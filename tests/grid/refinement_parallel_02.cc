@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Triangulation::execute_coarsening_and_refinement may compute the new
+// vertices on several threads, but only if all manifolds attached to the
+// triangulation say that this is safe. check that the manifold functions
+// of a manifold that does not override Manifold::is_thread_safe() are only
+// called from one thread, and that the result is the same as with a
+// manifold that allows concurrent calls
+
+#include "../tests.h"
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/manifold_lib.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+
+// a manifold that describes the same geometry as SphericalManifold and
+// records the threads it is called from, as well as whether a call starts
+// while another one is still running. the mutex only protects the
+// bookkeeping of this test
+template <int dim>
+class RecordingManifold : public SphericalManifold<dim>
+{
+public:
+  virtual
+  bool
+  is_thread_safe () const override
+  {
+    return false;
+  }
+
+  virtual
+  Point<dim>
+  get_new_point (const std::vector<Point<dim> > &surrounding_points,
+                 const std::vector<double>       &weights) const override
+  {
+    if (++active_calls > 1)
+      concurrent_calls = true;
+    {
+      std::lock_guard<std::mutex> lock (mutex);
+      threads.insert (std::this_thread::get_id());
+    }
+    const Point<dim> p = SphericalManifold<dim>::get_new_point (surrounding_points, weights);
+    --active_calls;
+    return p;
+  }
+
+  mutable std::set<std::thread::id> threads;
+  mutable std::mutex mutex;
+  mutable std::atomic<unsigned int> active_calls {0};
+  mutable std::atomic<bool> concurrent_calls {false};
+};
+
+
+
+template <int dim>
+void create_and_refine (Triangulation<dim>  &tria,
+                        const Manifold<dim> &manifold)
+{
+  GridGenerator::hyper_ball (tria);
+  tria.set_all_manifold_ids_on_boundary (0);
+  tria.set_manifold (0, manifold);
+  tria.refine_global (6-dim);
+}
+
+
+
+template <int dim>
+void test ()
+{
+  MultithreadInfo::set_thread_limit (4);
+
+  const SphericalManifold<dim> spherical_manifold;
+  Triangulation<dim> reference_tria;
+  create_and_refine (reference_tria, spherical_manifold);
+
+  const RecordingManifold<dim> recording_manifold;
+  Triangulation<dim> tria;
+  create_and_refine (tria, recording_manifold);
+
+  MultithreadInfo::set_thread_limit (testing_max_num_threads());
+
+  bool identical = (tria.n_vertices() == reference_tria.n_vertices());
+  for (unsigned int v=0; identical && v<tria.n_vertices(); ++v)
+    if (tria.get_vertices()[v] != reference_tria.get_vertices()[v])
+      identical = false;
+
+  deallog << "dim=" << dim << ": number of active cells: " << tria.n_active_cells()
+          << ", called from one thread: "
+          << (recording_manifold.threads.size() == 1 &&
+              !recording_manifold.concurrent_calls ? "yes" : "no")
+          << ", same vertices as SphericalManifold: "
+          << (identical ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
@@ -0,0 +1,151 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// benchmark the operations that read the per-object and per-cell records of
+// a triangulation: a loop over all cells that visits the children of each
+// cell, a loop over the active cells that visits their faces, neighbors and
+// flags, counting the active cells on each level with iterators, and several
+// cycles of execute_coarsening_and_refinement() with a mix of refinement and
+// coarsening flags. the timings are printed to the screen, whereas the
+// output file only records quantities that do not depend on the timings
+
+#include "../tests.h"
+#include <deal.II/base/timer.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+
+template <int dim>
+void test (const unsigned int n_refinements,
+           const unsigned int n_sweeps)
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (n_refinements);
+
+  // all cells: refinement cases and children
+  Timer timer;
+  unsigned long long checksum = 0;
+  for (unsigned int sweep=0; sweep<n_sweeps; ++sweep)
+    for (typename Triangulation<dim>::cell_iterator cell=tria.begin();
+         cell!=tria.end(); ++cell)
+      if (cell->has_children())
+        {
+          checksum += cell->refinement_case();
+          for (unsigned int c=0; c<cell->n_children(); ++c)
+            checksum += cell->child_index(c);
+        }
+  timer.stop ();
+  std::cout << dim << "d, " << tria.n_cells() << " cells, children: "
+            << timer.wall_time() << " s" << std::endl;
+  deallog << "cells: " << tria.n_cells() << ", checksum of children: "
+          << checksum/n_sweeps << std::endl;
+
+  // active cells: faces, neighbors, face orientations and flags
+  timer.restart ();
+  checksum = 0;
+  unsigned int n_flagged = 0;
+  for (unsigned int sweep=0; sweep<n_sweeps; ++sweep)
+    {
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell=tria.begin_active(); cell!=tria.end(); ++cell)
+        {
+          for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+            {
+              checksum += cell->face_index(f);
+              if (!cell->at_boundary(f))
+                checksum += cell->neighbor_level(f) + cell->neighbor_index(f);
+              if (cell->face_orientation(f) &&
+                  !cell->face_flip(f) && !cell->face_rotation(f))
+                ++checksum;
+            }
+          if (cell->index() % 3 == 0)
+            cell->set_user_flag ();
+          if (!cell->refine_flag_set() && !cell->coarsen_flag_set())
+            ++checksum;
+        }
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell=tria.begin_active(); cell!=tria.end(); ++cell)
+        if (cell->user_flag_set())
+          {
+            ++n_flagged;
+            cell->clear_user_flag ();
+          }
+    }
+  timer.stop ();
+  std::cout << dim << "d, " << tria.n_active_cells()
+            << " active cells, faces, neighbors and flags: "
+            << timer.wall_time() << " s" << std::endl;
+  deallog << "active cells: " << tria.n_active_cells()
+          << ", checksum of faces and neighbors: " << checksum/n_sweeps
+          << ", user flags set: " << n_flagged/n_sweeps << std::endl;
+
+  // count the active cells on all levels by iterating over them
+  timer.restart ();
+  unsigned int n_active_cells = 0;
+  for (unsigned int sweep=0; sweep<n_sweeps; ++sweep)
+    for (unsigned int level=0; level<tria.n_levels(); ++level)
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell=tria.begin_active(level); cell!=tria.end_active(level); ++cell)
+        ++n_active_cells;
+  timer.stop ();
+  std::cout << dim << "d, counting active cells: " << timer.wall_time()
+            << " s" << std::endl;
+  deallog << "active cells counted: " << n_active_cells/n_sweeps << std::endl;
+
+  // refine the cells close to a point that moves through the domain and
+  // coarsen the cells far away from it
+  timer.restart ();
+  for (unsigned int cycle=0; cycle<4; ++cycle)
+    {
+      Point<dim> p;
+      for (unsigned int d=0; d<dim; ++d)
+        p[d] = 0.2 + 0.2*cycle;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell=tria.begin_active(); cell!=tria.end(); ++cell)
+        {
+          const double distance = cell->center().distance (p);
+          if (distance < 0.15 && cell->level() < static_cast<int>(n_refinements)+2)
+            cell->set_refine_flag ();
+          else if (distance > 0.4 && cell->level() > 1)
+            cell->set_coarsen_flag ();
+        }
+      tria.execute_coarsening_and_refinement ();
+      deallog << "cycle " << cycle << ": " << tria.n_levels() << " levels, "
+              << tria.n_active_cells() << " active cells, "
+              << tria.n_cells() << " cells" << std::endl;
+    }
+  timer.stop ();
+  std::cout << dim << "d, coarsening and refinement: " << timer.wall_time()
+            << " s" << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2> (8, 50);
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3> (5, 50);
+  deallog.pop ();
+}
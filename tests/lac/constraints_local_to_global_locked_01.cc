@@ -0,0 +1,183 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check ConstraintMatrix::distribute_local_to_global with RowLocks: assemble
+// a Laplace matrix and right hand side on a mesh with hanging nodes and
+// inhomogeneous boundary conditions by calling distribute_local_to_global
+// concurrently from the worker of WorkStream::run without a copier, and
+// compare with the result of the usual serial copier
+
+#include "../tests.h"
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/numerics/vector_tools.h>
+
+
+template <int dim>
+struct ScratchData
+{
+  ScratchData (const FiniteElement<dim> &fe,
+               const Quadrature<dim>    &quadrature)
+    :
+    fe_values (fe, quadrature,
+               update_values | update_gradients | update_JxW_values)
+  {}
+
+  ScratchData (const ScratchData &scratch)
+    :
+    fe_values (scratch.fe_values.get_fe(),
+               scratch.fe_values.get_quadrature(),
+               scratch.fe_values.get_update_flags())
+  {}
+
+  FEValues<dim> fe_values;
+};
+
+
+
+struct CopyData
+{
+  FullMatrix<double>                   cell_matrix;
+  Vector<double>                       cell_rhs;
+  std::vector<types::global_dof_index> local_dof_indices;
+};
+
+
+
+template <int dim>
+void
+assemble_on_cell (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                  ScratchData<dim>                                     &scratch,
+                  CopyData                                             &copy)
+{
+  const unsigned int dofs_per_cell = scratch.fe_values.get_fe().dofs_per_cell;
+  copy.cell_matrix.reinit (dofs_per_cell, dofs_per_cell);
+  copy.cell_rhs.reinit (dofs_per_cell);
+  copy.local_dof_indices.resize (dofs_per_cell);
+
+  scratch.fe_values.reinit (cell);
+  for (unsigned int q=0; q<scratch.fe_values.n_quadrature_points; ++q)
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      {
+        for (unsigned int j=0; j<dofs_per_cell; ++j)
+          copy.cell_matrix(i,j) += (scratch.fe_values.shape_grad(i,q) *
+                                    scratch.fe_values.shape_grad(j,q) *
+                                    scratch.fe_values.JxW(q));
+        copy.cell_rhs(i) += (scratch.fe_values.shape_value(i,q) *
+                             scratch.fe_values.JxW(q));
+      }
+  cell->get_dof_indices (copy.local_dof_indices);
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (5-dim);
+  for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+       cell != tria.end(); ++cell)
+    if (cell->center()[0] < 0.5 && cell->center()[1] < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof, constraints);
+  VectorTools::interpolate_boundary_values (dof, 0, ConstantFunction<dim>(1.),
+                                            constraints);
+  constraints.close();
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp (dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern (dof, dsp, constraints, false);
+    sparsity.copy_from (dsp);
+  }
+  SparseMatrix<double> matrix_ref (sparsity), matrix (sparsity);
+  Vector<double> rhs_ref (dof.n_dofs()), rhs (dof.n_dofs());
+
+  const QGauss<dim> quadrature (fe.degree+1);
+  CopyData copy_data;
+
+  typedef typename DoFHandler<dim>::active_cell_iterator cell_iterator;
+
+  WorkStream::run (dof.begin_active(), dof.end(),
+                   &assemble_on_cell<dim>,
+                   [&] (const CopyData &copy)
+  {
+    constraints.distribute_local_to_global (copy.cell_matrix, copy.cell_rhs,
+                                            copy.local_dof_indices,
+                                            matrix_ref, rhs_ref);
+  },
+  ScratchData<dim>(fe, quadrature), copy_data);
+
+  // use a small number of stripes to provoke contention
+  const ConstraintMatrix::RowLocks row_locks (3, 4);
+  WorkStream::run (dof.begin_active(), dof.end(),
+                   [&] (const cell_iterator    &cell,
+                        ScratchData<dim>       &scratch,
+                        CopyData               &copy)
+  {
+    assemble_on_cell<dim> (cell, scratch, copy);
+    constraints.distribute_local_to_global (copy.cell_matrix, copy.cell_rhs,
+                                            copy.local_dof_indices,
+                                            matrix, rhs, row_locks);
+  },
+  std::function<void(const CopyData &)>(),
+  ScratchData<dim>(fe, quadrature), copy_data);
+
+  deallog << "Testing " << dim << "D" << std::endl;
+
+  matrix.add (-1., matrix_ref);
+  deallog << "Matrix difference below tolerance: "
+          << (matrix.frobenius_norm() < 1e-12 * matrix_ref.frobenius_norm() ? "yes" : "no")
+          << std::endl;
+
+  rhs -= rhs_ref;
+  deallog << "Vector difference below tolerance: "
+          << (rhs.linfty_norm() < 1e-12 * rhs_ref.linfty_norm() ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<2> ();
+  test<3> ();
+}
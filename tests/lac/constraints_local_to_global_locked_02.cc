@@ -0,0 +1,210 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// scaling benchmark for ConstraintMatrix::distribute_local_to_global with
+// RowLocks: assemble a Laplace matrix on a three dimensional mesh with hanging
+// nodes once with the usual serial copier of WorkStream::run and once with
+// distribute_local_to_global called concurrently from the worker, for an
+// increasing number of threads. The timings are written to the screen only,
+// the log file only records that both variants give the same matrix
+
+#include "../tests.h"
+
+#include <deal.II/base/function.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/base/work_stream.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <iostream>
+
+
+template <int dim>
+struct ScratchData
+{
+  ScratchData (const FiniteElement<dim> &fe,
+               const Quadrature<dim>    &quadrature)
+    :
+    fe_values (fe, quadrature,
+               update_values | update_gradients | update_JxW_values)
+  {}
+
+  ScratchData (const ScratchData &scratch)
+    :
+    fe_values (scratch.fe_values.get_fe(),
+               scratch.fe_values.get_quadrature(),
+               scratch.fe_values.get_update_flags())
+  {}
+
+  FEValues<dim> fe_values;
+};
+
+
+
+struct CopyData
+{
+  FullMatrix<double>                   cell_matrix;
+  Vector<double>                       cell_rhs;
+  std::vector<types::global_dof_index> local_dof_indices;
+};
+
+
+
+template <int dim>
+void
+assemble_on_cell (const typename DoFHandler<dim>::active_cell_iterator &cell,
+                  ScratchData<dim>                                     &scratch,
+                  CopyData                                             &copy)
+{
+  const unsigned int dofs_per_cell = scratch.fe_values.get_fe().dofs_per_cell;
+  copy.cell_matrix.reinit (dofs_per_cell, dofs_per_cell);
+  copy.cell_rhs.reinit (dofs_per_cell);
+  copy.local_dof_indices.resize (dofs_per_cell);
+
+  scratch.fe_values.reinit (cell);
+  for (unsigned int q=0; q<scratch.fe_values.n_quadrature_points; ++q)
+    for (unsigned int i=0; i<dofs_per_cell; ++i)
+      {
+        for (unsigned int j=0; j<dofs_per_cell; ++j)
+          copy.cell_matrix(i,j) += (scratch.fe_values.shape_grad(i,q) *
+                                    scratch.fe_values.shape_grad(j,q) *
+                                    scratch.fe_values.JxW(q));
+        copy.cell_rhs(i) += (scratch.fe_values.shape_value(i,q) *
+                             scratch.fe_values.JxW(q));
+      }
+  cell->get_dof_indices (copy.local_dof_indices);
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (4);
+  for (typename Triangulation<dim>::active_cell_iterator cell=tria.begin_active();
+       cell != tria.end(); ++cell)
+    if (cell->center().norm() < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim> fe (2);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  DoFTools::make_hanging_node_constraints (dof, constraints);
+  VectorTools::interpolate_boundary_values (dof, 0, ConstantFunction<dim>(1.),
+                                            constraints);
+  constraints.close();
+
+  SparsityPattern sparsity;
+  {
+    DynamicSparsityPattern dsp (dof.n_dofs(), dof.n_dofs());
+    DoFTools::make_sparsity_pattern (dof, dsp, constraints, false);
+    sparsity.copy_from (dsp);
+  }
+  SparseMatrix<double> matrix_ref (sparsity), matrix (sparsity);
+  Vector<double> rhs_ref (dof.n_dofs()), rhs (dof.n_dofs());
+
+  const QGauss<dim> quadrature (fe.degree+1);
+  CopyData copy_data;
+
+  typedef typename DoFHandler<dim>::active_cell_iterator cell_iterator;
+
+  std::cout << "Number of degrees of freedom: " << dof.n_dofs()
+            << ", number of constraints: " << constraints.n_constraints()
+            << std::endl;
+
+  // go up to the number of cores rather than the thread limit set for the
+  // test suite
+  const unsigned int max_threads = MultithreadInfo::n_cores();
+  bool all_equal = true;
+  for (unsigned int n_threads=1; n_threads<=max_threads; n_threads*=2)
+    {
+      MultithreadInfo::set_thread_limit (n_threads);
+
+      matrix_ref = 0;
+      rhs_ref = 0;
+      Timer timer;
+      WorkStream::run (dof.begin_active(), dof.end(),
+                       &assemble_on_cell<dim>,
+                       [&] (const CopyData &copy)
+      {
+        constraints.distribute_local_to_global (copy.cell_matrix, copy.cell_rhs,
+                                                copy.local_dof_indices,
+                                                matrix_ref, rhs_ref);
+      },
+      ScratchData<dim>(fe, quadrature), copy_data);
+      const double time_copier = timer.wall_time();
+
+      matrix = 0;
+      rhs = 0;
+      timer.restart ();
+      const ConstraintMatrix::RowLocks row_locks;
+      WorkStream::run (dof.begin_active(), dof.end(),
+                       [&] (const cell_iterator    &cell,
+                            ScratchData<dim>       &scratch,
+                            CopyData               &copy)
+      {
+        assemble_on_cell<dim> (cell, scratch, copy);
+        constraints.distribute_local_to_global (copy.cell_matrix, copy.cell_rhs,
+                                                copy.local_dof_indices,
+                                                matrix, rhs, row_locks);
+      },
+      std::function<void(const CopyData &)>(),
+      ScratchData<dim>(fe, quadrature), copy_data);
+      const double time_locked = timer.wall_time();
+
+      std::cout << "Threads: " << n_threads
+                << ", serial copier: " << time_copier << " s"
+                << ", row locks: " << time_locked << " s"
+                << ", speedup: " << time_copier / time_locked
+                << std::endl;
+
+      matrix.add (-1., matrix_ref);
+      rhs -= rhs_ref;
+      if (matrix.frobenius_norm() > 1e-12 * matrix_ref.frobenius_norm() ||
+          rhs.linfty_norm() > 1e-12 * rhs_ref.linfty_norm())
+        all_equal = false;
+    }
+
+  deallog << "Results of serial copier and row locks agree: "
+          << (all_equal ? "yes" : "no") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  test<3> ();
+}
@@ -0,0 +1,115 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SlicedEllpackMatrix::vmult, vmult_add, Tvmult and Tvmult_add against
+// SparseMatrix for a rectangular matrix with rows of random length, with and
+// without sorting of rows, including sizes that do not fill the last chunk
+
+#include "../tests.h"
+
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+
+
+template <typename number>
+void test (const unsigned int n,
+           const unsigned int sorting_scope)
+{
+  const unsigned int n_cols = n+3;
+  DynamicSparsityPattern dsp (n, n_cols);
+  for (unsigned int i=0; i<n; ++i)
+    {
+      dsp.add (i, i);
+      const unsigned int n_entries = Testing::rand() % 9;
+      for (unsigned int j=0; j<n_entries; ++j)
+        dsp.add (i, Testing::rand() % n_cols);
+    }
+  SparsityPattern sp;
+  sp.copy_from (dsp);
+
+  SparseMatrix<number> A (sp);
+  for (typename SparseMatrix<number>::iterator it=A.begin(); it!=A.end(); ++it)
+    it->value() = (1 + Testing::rand() % 100) / 7.;
+
+  SlicedEllpackMatrix<number> B (A, sorting_scope);
+  AssertThrow (B.m() == A.m(), ExcInternalError());
+  AssertThrow (B.n() == A.n(), ExcInternalError());
+  AssertThrow (B.n_nonzero_elements() == A.n_nonzero_elements(),
+               ExcInternalError());
+  AssertThrow (B.n_stored_elements() >= B.n_nonzero_elements(),
+               ExcInternalError());
+
+  Vector<number> src (n_cols), dst (n), dst_ref (n);
+  for (unsigned int i=0; i<n_cols; ++i)
+    src(i) = (1 + Testing::rand() % 100) / 13.;
+
+  A.vmult (dst_ref, src);
+  B.vmult (dst, src);
+  dst -= dst_ref;
+  const double error_vmult = dst.linfty_norm() / dst_ref.linfty_norm();
+
+  A.vmult (dst, src);
+  A.vmult_add (dst_ref, src);
+  B.vmult_add (dst, src);
+  dst -= dst_ref;
+  const double error_vmult_add = dst.linfty_norm() / dst_ref.linfty_norm();
+
+  Vector<number> tsrc (dst_ref), tdst (n_cols), tdst_ref (n_cols);
+  A.Tvmult (tdst_ref, tsrc);
+  B.Tvmult (tdst, tsrc);
+  tdst -= tdst_ref;
+  const double error_Tvmult = tdst.linfty_norm() / tdst_ref.linfty_norm();
+
+  A.Tvmult (tdst, tsrc);
+  A.Tvmult_add (tdst_ref, tsrc);
+  B.Tvmult_add (tdst, tsrc);
+  tdst -= tdst_ref;
+  const double error_Tvmult_add = tdst.linfty_norm() / tdst_ref.linfty_norm();
+
+  const double tolerance = 10. * std::numeric_limits<number>::epsilon();
+  deallog << "n=" << n << " sigma=" << sorting_scope << ": "
+          << (error_vmult < tolerance ? "OK" : "Failed") << " "
+          << (error_vmult_add < tolerance ? "OK" : "Failed") << " "
+          << (error_Tvmult < tolerance ? "OK" : "Failed") << " "
+          << (error_Tvmult_add < tolerance ? "OK" : "Failed")
+          << std::endl;
+}
+
+
+int
+main ()
+{
+  initlog();
+
+  const unsigned int sizes[] = {1, 7, 100, 1001};
+  const unsigned int sorting_scopes[] = {1, 8, 64};
+
+  deallog.push("double");
+  for (unsigned int s=0; s<3; ++s)
+    for (unsigned int i=0; i<4; ++i)
+      test<double> (sizes[i], sorting_scopes[s]);
+  deallog.pop();
+
+  deallog.push("float");
+  for (unsigned int s=0; s<3; ++s)
+    for (unsigned int i=0; i<4; ++i)
+      test<float> (sizes[i], sorting_scopes[s]);
+  deallog.pop();
+}
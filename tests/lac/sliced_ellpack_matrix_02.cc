@@ -0,0 +1,103 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// benchmark the matrix-vector product of SlicedEllpackMatrix against the one
+// of SparseMatrix for the five-point and nine-point stencils. The timings are
+// written to the screen only, the log file only records that the results of
+// both formats agree
+
+#include "../tests.h"
+#include "../testmatrix.h"
+
+#include <deal.II/base/timer.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/sparsity_pattern.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sliced_ellpack_matrix.h>
+
+#include <iostream>
+
+
+template <typename number>
+void test (const unsigned int size,
+           const bool         nine_point)
+{
+  const unsigned int dim = (size-1)*(size-1);
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 9);
+  if (nine_point)
+    testproblem.nine_point_structure (structure);
+  else
+    testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<number> A (structure);
+  if (nine_point)
+    testproblem.nine_point (A);
+  else
+    testproblem.five_point (A);
+
+  SlicedEllpackMatrix<number> B (A);
+
+  Vector<number> src (dim), dst (dim), dst_ref (dim);
+  for (unsigned int i=0; i<dim; ++i)
+    src(i) = (1 + Testing::rand() % 100) / 13.;
+
+  const unsigned int n_repetitions = 50;
+  Timer timer;
+  for (unsigned int r=0; r<n_repetitions; ++r)
+    A.vmult (dst_ref, src);
+  timer.stop ();
+  const double time_csr = timer.wall_time() / n_repetitions;
+
+  timer.restart ();
+  for (unsigned int r=0; r<n_repetitions; ++r)
+    B.vmult (dst, src);
+  timer.stop ();
+  const double time_sell = timer.wall_time() / n_repetitions;
+
+  std::cout << (nine_point ? "Nine" : "Five") << "-point stencil, "
+            << dim << " rows, " << sizeof(number) * 8 << " bit: "
+            << "SparseMatrix " << time_csr << " s, "
+            << "SlicedEllpackMatrix " << time_sell << " s, "
+            << "speedup " << time_csr / time_sell << ", "
+            << "stored/nonzero " << (double)B.n_stored_elements() / B.n_nonzero_elements()
+            << std::endl;
+
+  dst -= dst_ref;
+  deallog << (nine_point ? "Nine" : "Five") << "-point stencil with "
+          << dim << " rows: "
+          << (dst.linfty_norm() < 100. * std::numeric_limits<number>::epsilon() * dst_ref.linfty_norm()
+              ? "OK" : "Failed")
+          << std::endl;
+}
+
+
+int
+main ()
+{
+  initlog();
+
+  deallog.push("double");
+  test<double> (301, false);
+  test<double> (301, true);
+  deallog.pop();
+
+  deallog.push("float");
+  test<float> (301, false);
+  test<float> (301, true);
+  deallog.pop();
+}
@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SolverPipeCG needs about as many iterations as SolverCG and
+// computes the same solution, with and without preconditioner
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_pipe_cg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+
+template <typename PreconditionerType>
+void test (const SparseMatrix<double>  &A,
+           const PreconditionerType   &preconditioner)
+{
+  Vector<double> rhs (A.m()), solution (A.m()), reference (A.m());
+  for (unsigned int i=0; i<rhs.size(); ++i)
+    rhs(i) = 1. + std::sin (1.+i);
+
+  SolverControl control (1000, 1e-8*rhs.l2_norm());
+  SolverCG<> cg (control);
+  cg.solve (A, reference, rhs, preconditioner);
+  const unsigned int cg_steps = control.last_step();
+
+  GrowingVectorMemory<> memory;
+  SolverPipeCG<> pipe_cg (control, memory);
+  check_solver_within_range (pipe_cg.solve (A, solution, rhs, preconditioner),
+                             control.last_step(), cg_steps-1, cg_steps+1);
+
+  solution -= reference;
+  deallog << "Relative difference to CG: "
+          << (solution.l2_norm() < 1e-6 * reference.l2_norm() ? "ok" : "large")
+          << std::endl;
+
+  // start from the solution of CG
+  solution = reference;
+  pipe_cg.solve (A, solution, rhs, preconditioner);
+  deallog << "Steps from converged initial guess: " << control.last_step()
+          << std::endl;
+}
+
+
+
+int main()
+{
+  initlog();
+
+  for (unsigned int size=17; size<=65; size+=48)
+    {
+      const unsigned int dim = (size-1)*(size-1);
+      deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+      FDMatrix testproblem (size, size);
+      SparsityPattern structure (dim, dim, 5);
+      testproblem.five_point_structure (structure);
+      structure.compress ();
+      SparseMatrix<double> A (structure);
+      testproblem.five_point (A);
+
+      PreconditionIdentity identity;
+      test (A, identity);
+
+      PreconditionSSOR<> ssor;
+      ssor.initialize (A, 1.2);
+      test (A, ssor);
+    }
+}
@@ -0,0 +1,116 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SolverSStepGMRES needs about as many iterations as SolverGMRES
+// with right preconditioning for several block sizes, also with restarts and
+// block sizes that do not divide the basis size, and that it finds the exact
+// solution of a system whose Krylov space is small
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/vector_memory.h>
+
+
+template <typename PreconditionerType>
+void test (const SparseMatrix<double>  &A,
+           const PreconditionerType   &preconditioner,
+           const unsigned int          basis_size)
+{
+  Vector<double> rhs (A.m()), solution (A.m()), reference (A.m());
+  for (unsigned int i=0; i<rhs.size(); ++i)
+    rhs(i) = 1. + std::sin (1.+i);
+
+  SolverControl control (2000, 1e-8*rhs.l2_norm());
+  SolverGMRES<> gmres (control, SolverGMRES<>::AdditionalData (basis_size+2, true));
+  gmres.solve (A, reference, rhs, preconditioner);
+  const unsigned int gmres_steps = control.last_step();
+
+  for (unsigned int s=1; s<=6; ++s)
+    {
+      deallog << "Block size " << s << std::endl;
+      GrowingVectorMemory<> memory;
+      SolverSStepGMRES<> sstep_gmres (control, memory,
+                                      SolverSStepGMRES<>::AdditionalData (basis_size, s));
+      solution = 0.;
+      check_solver_within_range (sstep_gmres.solve (A, solution, rhs, preconditioner),
+                                 control.last_step(), gmres_steps-2, gmres_steps+2);
+
+      solution -= reference;
+      deallog << "Relative difference to GMRES: "
+              << (solution.l2_norm() < 1e-6 * reference.l2_norm() ? "ok" : "large")
+              << std::endl;
+    }
+}
+
+
+
+int main()
+{
+  initlog();
+
+  const unsigned int size = 33;
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A, true);
+
+  PreconditionIdentity identity;
+  deallog.push ("Identity");
+  test (A, identity, 30);
+  deallog.pop ();
+
+  PreconditionSOR<> sor;
+  sor.initialize (A, 1.2);
+  deallog.push ("SOR");
+  test (A, sor, 30);
+  deallog.push ("restart");
+  test (A, sor, 10);
+  deallog.pop ();
+  deallog.pop ();
+
+  // a diagonal matrix with three different entries, for which the Krylov
+  // space has dimension three and the solver must find the exact solution
+  // after three iterations, independent of the block size
+  SparsityPattern diagonal_structure (dim, dim, 1);
+  diagonal_structure.compress ();
+  SparseMatrix<double> D (diagonal_structure);
+  for (unsigned int i=0; i<dim; ++i)
+    D.set (i, i, 1. + i%3);
+  Vector<double> rhs (dim), solution (dim);
+  rhs = 1.;
+  deallog.push ("Diagonal");
+  for (unsigned int s=1; s<=5; s+=2)
+    {
+      SolverControl control (20, 1e-12);
+      SolverSStepGMRES<> solver (control,
+                                 SolverSStepGMRES<>::AdditionalData (10, s));
+      solution = 0.;
+      solver.solve (D, solution, rhs, identity);
+      deallog << "Block size " << s << " steps " << control.last_step()
+              << std::endl;
+    }
+  deallog.pop ();
+}
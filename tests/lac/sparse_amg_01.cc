@@ -0,0 +1,76 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// solve the five-point Laplacian with SolverCG and SparseAMG on a sequence
+// of grids. the number of iterations should not grow as the grid is
+// refined. also check the preconditioner in single precision under a
+// double precision solver
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_amg.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+
+template <typename number>
+void test (const unsigned int size)
+{
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A);
+
+  SparseMatrix<number> A_precondition (structure);
+  A_precondition.copy_from (A);
+  SparseAMG<number> amg;
+  amg.initialize (A_precondition);
+
+  deallog << "Size " << size << " Unknowns " << dim
+          << " Levels " << amg.n_levels() << " Coarse size "
+          << amg.n_rows_on_level(amg.n_levels()-1)
+          << " Operator complexity " << amg.operator_complexity()
+          << std::endl;
+
+  Vector<double> solution (dim), rhs (dim);
+  rhs = 1.;
+  SolverControl control (100, 1e-8*rhs.l2_norm());
+  SolverCG<> solver (control);
+  check_solver_within_range (solver.solve (A, solution, rhs, amg),
+                             control.last_step(), 1, 15);
+}
+
+
+
+int main()
+{
+  initlog();
+  deallog << std::setprecision(3);
+
+  for (unsigned int size=32; size <= 256; size *= 2)
+    test<double> (size);
+
+  deallog.push ("float");
+  test<float> (128);
+  deallog.pop ();
+}
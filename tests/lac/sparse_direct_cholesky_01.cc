@@ -0,0 +1,108 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the Cholesky factorization of SparseDirectCholesky for the five and
+// nine point stencils with both orderings, the reuse of the symbolic
+// factorization, and the detection of matrices that are not positive
+// definite
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/sparse_direct_cholesky.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+
+void check_solve (const SparseMatrix<double>   &A,
+                  const SparseDirectCholesky   &cholesky)
+{
+  Vector<double> rhs (A.m()), solution (A.m()), residual (A.m());
+  for (unsigned int i=0; i<rhs.size(); ++i)
+    rhs(i) = 1. + std::sin (1.+i);
+
+  cholesky.vmult (solution, rhs);
+  A.residual (residual, solution, rhs);
+  deallog << "Relative residual: "
+          << (residual.l2_norm() < 1e-10 * rhs.l2_norm() ? "ok" : "large")
+          << std::endl;
+}
+
+
+
+void test (const unsigned int size,
+           const bool         nine_point)
+{
+  const unsigned int dim = (size-1)*(size-1);
+  deallog << "Size " << size << " Unknowns " << dim
+          << (nine_point ? " nine point" : " five point") << std::endl;
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 9);
+  if (nine_point)
+    testproblem.nine_point_structure (structure);
+  else
+    testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  if (nine_point)
+    testproblem.nine_point (A);
+  else
+    testproblem.five_point (A);
+
+  SparseDirectCholesky natural, nested_dissection;
+  natural.initialize (A, SparseDirectCholesky::AdditionalData
+                      (SparseDirectCholesky::cholesky,
+                       SparseDirectCholesky::natural));
+  check_solve (A, natural);
+
+  nested_dissection.initialize (structure);
+  nested_dissection.factorize (A);
+  check_solve (A, nested_dissection);
+  deallog << "Nested dissection reduces fill-in: "
+          << (nested_dissection.n_nonzero_elements() <=
+              natural.n_nonzero_elements() ? "yes" : "no") << std::endl;
+
+  // factorize another matrix with the same sparsity pattern
+  for (unsigned int i=0; i<dim; ++i)
+    A.diag_element(i) += 1. + i%3;
+  nested_dissection.factorize (A);
+  check_solve (A, nested_dissection);
+
+  // and one that is not positive definite
+  for (unsigned int i=0; i<dim; ++i)
+    A.diag_element(i) -= 10.;
+  try
+    {
+      nested_dissection.factorize (A);
+    }
+  catch (const SparseDirectCholesky::ExcNotPositiveDefinite &e)
+    {
+      deallog << "Exception: " << e.get_exc_name() << std::endl;
+    }
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test (3, false);
+  test (33, false);
+  test (33, true);
+  test (120, false);
+}
@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check the LDL^T factorization of SparseDirectCholesky for a shifted
+// Laplacian, which is indefinite, and for a saddle point matrix with a zero
+// block on the diagonal. for the latter, pivots may have to be perturbed,
+// so we improve the solution by iterative refinement
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparse_direct_cholesky.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/vector.h>
+
+
+void check_solve (const SparseMatrix<double>   &A,
+                  const SparseDirectCholesky   &ldlt)
+{
+  Vector<double> rhs (A.m()), solution (A.m()), residual (A.m()),
+         update (A.m());
+  for (unsigned int i=0; i<rhs.size(); ++i)
+    rhs(i) = 1. + std::sin (1.+i);
+
+  ldlt.vmult (solution, rhs);
+  for (unsigned int step=0; step<10; ++step)
+    {
+      A.residual (residual, solution, rhs);
+      if (residual.l2_norm() < 1e-10 * rhs.l2_norm())
+        break;
+      ldlt.vmult (update, residual);
+      solution += update;
+    }
+  A.residual (residual, solution, rhs);
+  deallog << "Relative residual: "
+          << (residual.l2_norm() < 1e-10 * rhs.l2_norm() ? "ok" : "large")
+          << std::endl;
+}
+
+
+
+void test (const unsigned int size)
+{
+  const unsigned int dim = (size-1)*(size-1);
+  deallog << "Size " << size << " Unknowns " << dim << std::endl;
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 5);
+  testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  testproblem.five_point (A);
+
+  // shift the spectrum so that the matrix becomes indefinite
+  for (unsigned int i=0; i<dim; ++i)
+    A.diag_element(i) -= 1.7;
+
+  for (unsigned int ordering=0; ordering<2; ++ordering)
+    {
+      SparseDirectCholesky ldlt;
+      ldlt.initialize (A, SparseDirectCholesky::AdditionalData
+                       (SparseDirectCholesky::ldlt,
+                        ordering == 0 ?
+                        SparseDirectCholesky::natural :
+                        SparseDirectCholesky::nested_dissection));
+      check_solve (A, ldlt);
+    }
+
+  // a saddle point matrix [A B^T; B 0] where every row of B couples two
+  // neighboring unknowns
+  const unsigned int n_constraints = dim/4;
+  DynamicSparsityPattern dsp (dim+n_constraints);
+  for (unsigned int i=0; i<dim; ++i)
+    for (SparsityPattern::iterator it=structure.begin(i); it!=structure.end(i); ++it)
+      dsp.add (i, it->column());
+  for (unsigned int k=0; k<n_constraints; ++k)
+    for (unsigned int c=0; c<2; ++c)
+      {
+        dsp.add (dim+k, 4*k+c);
+        dsp.add (4*k+c, dim+k);
+      }
+  dsp.add (dim, dim);
+  SparsityPattern saddle_structure;
+  saddle_structure.copy_from (dsp);
+  SparseMatrix<double> S (saddle_structure);
+  for (unsigned int i=0; i<dim; ++i)
+    for (SparseMatrix<double>::const_iterator it=A.begin(i); it!=A.end(i); ++it)
+      S.set (i, it->column(), it->value() + (i == it->column() ? 1.7 : 0.));
+  for (unsigned int k=0; k<n_constraints; ++k)
+    for (unsigned int c=0; c<2; ++c)
+      {
+        S.set (dim+k, 4*k+c, c == 0 ? 1. : -1.);
+        S.set (4*k+c, dim+k, c == 0 ? 1. : -1.);
+      }
+
+  SparseDirectCholesky ldlt;
+  ldlt.initialize (saddle_structure, SparseDirectCholesky::AdditionalData
+                   (SparseDirectCholesky::ldlt));
+  ldlt.factorize (S);
+  check_solve (S, ldlt);
+}
+
+
+
+int main()
+{
+  initlog();
+
+  test (3);
+  test (33);
+  test (65);
+}
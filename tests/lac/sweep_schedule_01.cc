@@ -0,0 +1,155 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check SweepSchedule with level scheduling and multicoloring on the
+// five-point and nine-point stencils: no two coupled rows may be in the same
+// group, the sweeps with level scheduling must give exactly the same results
+// as the sequential ones, and SSOR with a multicolor ordering must still be
+// a good preconditioner
+
+#include "../tests.h"
+#include "../testmatrix.h"
+#include <deal.II/lac/precondition.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/sparse_ilu.h>
+#include <deal.II/lac/sparse_matrix.h>
+#include <deal.II/lac/sweep_schedule.h>
+#include <deal.II/lac/vector.h>
+
+
+void check_groups (const SparsityPattern &sparsity,
+                   const SweepSchedule   &schedule)
+{
+  types::global_dof_index n_rows = 0;
+  for (unsigned int g=0; g<schedule.n_groups(); ++g)
+    n_rows += schedule.n_rows_in_group (g);
+  AssertThrow (n_rows == sparsity.n_rows(), ExcInternalError());
+
+  for (types::global_dof_index row=0; row<sparsity.n_rows(); ++row)
+    for (SparsityPattern::iterator it=sparsity.begin(row);
+         it!=sparsity.end(row); ++it)
+      if (it->column() != row)
+        {
+          AssertThrow (schedule.group_of_row (row) !=
+                       schedule.group_of_row (it->column()),
+                       ExcInternalError());
+          if (schedule.get_ordering() == SweepSchedule::level_scheduling)
+            AssertThrow (schedule.precedes (it->column(), row) ==
+                         (it->column() < row),
+                         ExcInternalError());
+        }
+}
+
+
+
+void test (const bool nine_point)
+{
+  const unsigned int size = 48;
+  const unsigned int dim = (size-1)*(size-1);
+
+  FDMatrix testproblem (size, size);
+  SparsityPattern structure (dim, dim, 9);
+  if (nine_point)
+    testproblem.nine_point_structure (structure);
+  else
+    testproblem.five_point_structure (structure);
+  structure.compress ();
+  SparseMatrix<double> A (structure);
+  if (nine_point)
+    testproblem.nine_point (A);
+  else
+    testproblem.five_point (A);
+
+  SweepSchedule levels, colors;
+  levels.initialize (structure);
+  colors.initialize (structure, SweepSchedule::multicoloring);
+  check_groups (structure, levels);
+  check_groups (structure, colors);
+  deallog << "Levels: " << levels.n_groups()
+          << "  Colors: " << colors.n_groups() << std::endl;
+
+  Vector<double> src (dim), dst1 (dim), dst2 (dim);
+  for (unsigned int i=0; i<dim; ++i)
+    src(i) = std::sin (1.+i);
+
+  std::vector<std::size_t> pos_right_of_diagonal (dim);
+  for (unsigned int row=0; row<dim; ++row)
+    {
+      SparseMatrix<double>::const_iterator it = A.begin(row)+1;
+      while (it != A.end(row) && it->column() < row)
+        ++it;
+      pos_right_of_diagonal[row] = it - A.begin();
+    }
+  A.precondition_SSOR (dst1, src, 1.2, pos_right_of_diagonal);
+  A.precondition_SSOR (dst2, src, 1.2, levels);
+  dst2 -= dst1;
+  deallog << "SSOR difference: " << dst2.linfty_norm() << std::endl;
+
+  A.precondition_SOR (dst1, src, 1.2);
+  A.precondition_SOR (dst2, src, 1.2, levels);
+  dst2 -= dst1;
+  deallog << "SOR difference: " << dst2.linfty_norm() << std::endl;
+
+  A.precondition_TSOR (dst1, src, 1.2);
+  A.precondition_TSOR (dst2, src, 1.2, levels);
+  dst2 -= dst1;
+  deallog << "TSOR difference: " << dst2.linfty_norm() << std::endl;
+
+  dst1 = 0.;
+  dst2 = 0.;
+  A.SSOR_step (dst1, src, 1.2);
+  A.SSOR_step (dst2, src, 1.2, levels);
+  dst2 -= dst1;
+  deallog << "SSOR step difference: " << dst2.linfty_norm() << std::endl;
+
+  Vector<double> solution (dim), rhs (dim);
+  rhs = 1.;
+  SolverControl control (500, 1e-8*rhs.l2_norm());
+  SolverCG<> solver (control);
+
+  PreconditionSSOR<> ssor;
+  ssor.initialize (A, PreconditionSSOR<>::AdditionalData (1.2));
+  solver.solve (A, solution, rhs, ssor);
+  const unsigned int ssor_steps = control.last_step();
+
+  ssor.initialize (A, PreconditionSSOR<>::AdditionalData
+                   (1.2, SweepSchedule::multicoloring));
+  solution = 0.;
+  check_solver_within_range (solver.solve (A, solution, rhs, ssor),
+                             control.last_step(), ssor_steps, 2*ssor_steps);
+
+  SparseILU<double> ilu;
+  ilu.initialize (A);
+  solution = 0.;
+  check_solver_within_range (solver.solve (A, solution, rhs, ilu),
+                             control.last_step(), 10, 40);
+}
+
+
+
+int main()
+{
+  initlog();
+
+  deallog.push ("5-point");
+  test (false);
+  deallog.pop ();
+  deallog.push ("9-point");
+  test (true);
+  deallog.pop ();
+}
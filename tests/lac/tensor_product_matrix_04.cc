@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Test the path of TensorProductMatrix with VectorizedArray, with different
+// matrices in each direction and in each lane, by comparing vmult with the
+// full matrix and checking the inverse
+
+#include "../tests.h"
+#include <deal.II/lac/tensor_product_matrix.h>
+#include <deal.II/lac/full_matrix.h>
+#include <deal.II/lac/vector.h>
+
+
+template <int dim, typename Number, int size>
+void do_test(const unsigned int n)
+{
+  deallog << "Testing dim=" << dim << ", degree=" << n
+          << (size == -1 ? ", run time size" : "") << std::endl;
+
+  typedef VectorizedArray<Number> VectorizedNumber;
+  const unsigned int n_lanes = VectorizedNumber::n_array_elements;
+  std::array<Table<2,VectorizedNumber>,dim> mass, laplace;
+  for (unsigned int d=0; d<dim; ++d)
+    {
+      mass[d].reinit(n, n);
+      laplace[d].reinit(n, n);
+      for (unsigned int v=0; v<n_lanes; ++v)
+        {
+          const double h = 1. + 0.3*v + 0.7*d;
+          for (unsigned int i=0; i<n; ++i)
+            {
+              mass[d](i,i)[v] = 2./3.*h;
+              laplace[d](i,i)[v] = 2./h + 0.1*i;
+              if (i > 0)
+                {
+                  mass[d](i,i-1)[v] = mass[d](i-1,i)[v] = 1./6.*h;
+                  laplace[d](i,i-1)[v] = laplace[d](i-1,i)[v] = -1./h + 0.01*v;
+                }
+              if (i > 1)
+                laplace[d](i,i-2)[v] = laplace[d](i-2,i)[v] = 0.05*d;
+            }
+        }
+    }
+
+  TensorProductMatrixSymmetricSum<dim,VectorizedNumber,size> mat(mass, laplace);
+  const unsigned int n_rows = mat.m();
+  AlignedVector<VectorizedNumber> v1(n_rows), v2(n_rows), v3(n_rows);
+  for (unsigned int i=0; i<n_rows; ++i)
+    for (unsigned int v=0; v<n_lanes; ++v)
+      v1[i][v] = (2*i+1+v)%23;
+
+  mat.vmult(v2.begin(), v1.begin());
+  mat.apply_inverse(v3.begin(), v2.begin());
+  double norm = 0;
+  for (unsigned int i=0; i<n_rows; ++i)
+    for (unsigned int v=0; v<n_lanes; ++v)
+      norm = std::max(norm, std::abs(double(v3[i][v] - v1[i][v])));
+  const double tolerance = std::is_same<Number,float>::value ? 1e-3 : 1e-10;
+  deallog << "Verification of vmult and inverse: "
+          << (norm < tolerance ? 0. : norm) << std::endl;
+
+  // compare with the full matrix of every lane
+  norm = 0;
+  for (unsigned int v=0; v<n_lanes; ++v)
+    {
+      FullMatrix<double> full(n_rows, n_rows);
+      for (unsigned int i=0, c=0; i<(dim>2?n:1); ++i)
+        for (unsigned int j=0; j<(dim>1?n:1); ++j)
+          for (unsigned int k=0; k<n; ++k, ++c)
+            for (unsigned int ii=0, cc=0; ii<(dim>2?n:1); ++ii)
+              for (unsigned int jj=0; jj<(dim>1?n:1); ++jj)
+                for (unsigned int kk=0; kk<n; ++kk, ++cc)
+                  if (dim == 1)
+                    full(c,cc) = laplace[0](k,kk)[v];
+                  else if (dim == 2)
+                    full(c,cc) = laplace[0](k,kk)[v]*mass[1](j,jj)[v] +
+                                 mass[0](k,kk)[v]*laplace[1](j,jj)[v];
+                  else if (dim == 3)
+                    full(c,cc) = (laplace[0](k,kk)[v]*mass[1](j,jj)[v] +
+                                  mass[0](k,kk)[v]*laplace[1](j,jj)[v])*mass[2](i,ii)[v] +
+                                 mass[0](k,kk)[v]*mass[1](j,jj)[v]*laplace[2](i,ii)[v];
+      Vector<double> src(n_rows), dst(n_rows);
+      for (unsigned int i=0; i<n_rows; ++i)
+        src(i) = v1[i][v];
+      full.vmult(dst, src);
+      for (unsigned int i=0; i<n_rows; ++i)
+        norm = std::max(norm, std::abs(dst(i) - v2[i][v]) / dst.linfty_norm());
+    }
+  deallog << "Verification of vmult: " << (norm < tolerance ? 0. : norm) << std::endl;
+}
+
+
+int main()
+{
+  initlog();
+
+  do_test<1,double,-1>(1);
+  do_test<1,double,5>(5);
+  do_test<2,double,-1>(2);
+  do_test<2,double,5>(5);
+  do_test<2,float,4>(4);
+  do_test<3,double,-1>(3);
+  do_test<3,double,4>(4);
+  do_test<3,float,6>(6);
+
+  return 0;
+}
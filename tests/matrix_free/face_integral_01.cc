@@ -0,0 +1,322 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests MatrixFree::loop with cell, inner face and boundary face integrals
+// evaluated by FEEvaluation and FEFaceEvaluation for a symmetric interior
+// penalty discretization of the Laplacian with FE_DGQ on a distorted mesh,
+// compared against the result of FEValues and FEFaceValues
+
+#include "../tests.h"
+
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+#include <deal.II/base/utilities.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/grid_tools.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/fe_values.h>
+#include <deal.II/fe/mapping_q_generic.h>
+
+#include <iostream>
+
+
+const double penalty = 10.;
+
+
+template <int dim>
+Point<dim> distort (const Point<dim> &p)
+{
+  Point<dim> q = p;
+  for (unsigned int d=0; d<dim; ++d)
+    q[d] += 0.05 * std::sin(2.*p[(d+1)%dim]) * (1.-p[d]*p[d]);
+  return q;
+}
+
+
+
+template <int dim, int fe_degree>
+class LaplaceOperator
+{
+public:
+  typedef VectorizedArray<double> VA;
+
+  LaplaceOperator (const MatrixFree<dim,double> &data)
+    :
+    data (data)
+  {}
+
+  void vmult (Vector<double> &dst,
+              const Vector<double> &src) const
+  {
+    dst = 0;
+    data.loop (&LaplaceOperator::local_cell,
+               &LaplaceOperator::local_face,
+               &LaplaceOperator::local_boundary,
+               this, dst, src);
+  }
+
+private:
+  void local_cell (const MatrixFree<dim,double> &data,
+                   Vector<double> &dst,
+                   const Vector<double> &src,
+                   const std::pair<unsigned int,unsigned int> &cell_range) const
+  {
+    FEEvaluation<dim,fe_degree> phi (data);
+    for (unsigned int cell=cell_range.first; cell<cell_range.second; ++cell)
+      {
+        phi.reinit (cell);
+        phi.read_dof_values (src);
+        phi.evaluate (false, true);
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          phi.submit_gradient (phi.get_gradient(q), q);
+        phi.integrate (false, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  void local_face (const MatrixFree<dim,double> &data,
+                   Vector<double> &dst,
+                   const Vector<double> &src,
+                   const std::pair<unsigned int,unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim,fe_degree> phi_m (data, true);
+    FEFaceEvaluation<dim,fe_degree> phi_p (data, false);
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        phi_m.reinit (face);
+        phi_p.reinit (face);
+        phi_m.read_dof_values (src);
+        phi_p.read_dof_values (src);
+        phi_m.evaluate (true, true);
+        phi_p.evaluate (true, true);
+        for (unsigned int q=0; q<phi_m.n_q_points; ++q)
+          {
+            const VA jump = phi_m.get_value(q) - phi_p.get_value(q);
+            const VA average_normal_derivative =
+              0.5 * (phi_m.get_normal_derivative(q) +
+                     phi_p.get_normal_derivative(q));
+            const VA flux = penalty * jump - average_normal_derivative;
+            phi_m.submit_value (flux, q);
+            phi_p.submit_value (-flux, q);
+            phi_m.submit_normal_derivative (-0.5 * jump, q);
+            phi_p.submit_normal_derivative (-0.5 * jump, q);
+          }
+        phi_m.integrate (true, true);
+        phi_p.integrate (true, true);
+        phi_m.distribute_local_to_global (dst);
+        phi_p.distribute_local_to_global (dst);
+      }
+  }
+
+  void local_boundary (const MatrixFree<dim,double> &data,
+                       Vector<double> &dst,
+                       const Vector<double> &src,
+                       const std::pair<unsigned int,unsigned int> &face_range) const
+  {
+    FEFaceEvaluation<dim,fe_degree> phi (data, true);
+    for (unsigned int face=face_range.first; face<face_range.second; ++face)
+      {
+        phi.reinit (face);
+        phi.read_dof_values (src);
+        phi.evaluate (true, true);
+        const double factor = 1. + phi.boundary_id();
+        for (unsigned int q=0; q<phi.n_q_points; ++q)
+          {
+            const VA value = phi.get_value(q);
+            phi.submit_value (factor * penalty * value -
+                              phi.get_normal_derivative(q), q);
+            phi.submit_normal_derivative (-value, q);
+          }
+        phi.integrate (true, true);
+        phi.distribute_local_to_global (dst);
+      }
+  }
+
+  const MatrixFree<dim,double> &data;
+};
+
+
+
+template <int dim>
+void reference_vmult (const Mapping<dim> &mapping,
+                      const DoFHandler<dim> &dof,
+                      const unsigned int n_q_points_1d,
+                      const Vector<double> &src,
+                      Vector<double> &dst)
+{
+  const FiniteElement<dim> &fe = dof.get_fe();
+  const unsigned int dofs_per_cell = fe.dofs_per_cell;
+  FEValues<dim> fe_values (mapping, fe, QGauss<dim>(n_q_points_1d),
+                           update_gradients | update_JxW_values);
+  FEFaceValues<dim> fe_face_m (mapping, fe, QGauss<dim-1>(n_q_points_1d),
+                               update_values | update_gradients |
+                               update_normal_vectors | update_JxW_values);
+  FEFaceValues<dim> fe_face_p (mapping, fe, QGauss<dim-1>(n_q_points_1d),
+                               update_values | update_gradients);
+  const unsigned int n_q_points = fe_values.n_quadrature_points;
+  const unsigned int n_face_q_points = fe_face_m.n_quadrature_points;
+
+  std::vector<types::global_dof_index> indices_m (dofs_per_cell),
+      indices_p (dofs_per_cell);
+  std::vector<Tensor<1,dim> > gradients (n_q_points);
+  std::vector<double> values_m (n_face_q_points), values_p (n_face_q_points);
+  std::vector<Tensor<1,dim> > gradients_m (n_face_q_points),
+      gradients_p (n_face_q_points);
+
+  dst = 0;
+  for (typename DoFHandler<dim>::active_cell_iterator cell=dof.begin_active();
+       cell != dof.end(); ++cell)
+    {
+      cell->get_dof_indices (indices_m);
+      fe_values.reinit (cell);
+      fe_values.get_function_gradients (src, gradients);
+      for (unsigned int i=0; i<dofs_per_cell; ++i)
+        {
+          double sum = 0;
+          for (unsigned int q=0; q<n_q_points; ++q)
+            sum += fe_values.shape_grad(i,q) * gradients[q] * fe_values.JxW(q);
+          dst(indices_m[i]) += sum;
+        }
+
+      for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->at_boundary(f))
+          {
+            fe_face_m.reinit (cell, f);
+            fe_face_m.get_function_values (src, values_m);
+            fe_face_m.get_function_gradients (src, gradients_m);
+            const double factor = 1. + cell->face(f)->boundary_id();
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              {
+                double sum = 0;
+                for (unsigned int q=0; q<n_face_q_points; ++q)
+                  {
+                    const Tensor<1,dim> normal = fe_face_m.normal_vector(q);
+                    sum += ((factor * penalty * values_m[q] -
+                             gradients_m[q] * normal) *
+                            fe_face_m.shape_value(i,q)
+                            -
+                            values_m[q] *
+                            (fe_face_m.shape_grad(i,q) * normal)) *
+                           fe_face_m.JxW(q);
+                  }
+                dst(indices_m[i]) += sum;
+              }
+          }
+        else if (cell->neighbor(f)->index() > cell->index())
+          {
+            const typename DoFHandler<dim>::active_cell_iterator neighbor =
+              cell->neighbor(f);
+            neighbor->get_dof_indices (indices_p);
+            fe_face_m.reinit (cell, f);
+            fe_face_p.reinit (neighbor, cell->neighbor_of_neighbor(f));
+            fe_face_m.get_function_values (src, values_m);
+            fe_face_m.get_function_gradients (src, gradients_m);
+            fe_face_p.get_function_values (src, values_p);
+            fe_face_p.get_function_gradients (src, gradients_p);
+            for (unsigned int i=0; i<dofs_per_cell; ++i)
+              {
+                double sum_m = 0, sum_p = 0;
+                for (unsigned int q=0; q<n_face_q_points; ++q)
+                  {
+                    const Tensor<1,dim> normal = fe_face_m.normal_vector(q);
+                    const double jump = values_m[q] - values_p[q];
+                    const double flux = penalty * jump -
+                                        0.5 * (gradients_m[q] + gradients_p[q]) * normal;
+                    sum_m += (flux * fe_face_m.shape_value(i,q) -
+                              0.5 * jump * (fe_face_m.shape_grad(i,q) * normal)) *
+                             fe_face_m.JxW(q);
+                    sum_p += (-flux * fe_face_p.shape_value(i,q) -
+                              0.5 * jump * (fe_face_p.shape_grad(i,q) * normal)) *
+                             fe_face_m.JxW(q);
+                  }
+                dst(indices_m[i]) += sum_m;
+                dst(indices_p[i]) += sum_p;
+              }
+          }
+    }
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria, -1, 1, true);
+  tria.refine_global (4-dim);
+  GridTools::transform (&distort<dim>, tria);
+
+  FE_DGQ<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+  ConstraintMatrix constraints;
+  constraints.close();
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+
+  MappingQGeneric<dim> mapping (1);
+  const unsigned int n_q_points_1d = fe_degree+1;
+
+  MatrixFree<dim,double> mf_data;
+  typename MatrixFree<dim,double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+  data.mapping_update_flags = update_gradients | update_JxW_values;
+  data.mapping_update_flags_inner_faces = (update_values | update_gradients |
+                                           update_JxW_values |
+                                           update_normal_vectors);
+  data.mapping_update_flags_boundary_faces = (update_values | update_gradients |
+                                              update_JxW_values |
+                                              update_normal_vectors);
+  mf_data.reinit (mapping, dof, constraints, QGauss<1>(n_q_points_1d), data);
+
+  Vector<double> src (dof.n_dofs()), dst (dof.n_dofs()), dst_ref (dof.n_dofs());
+  for (unsigned int i=0; i<dof.n_dofs(); ++i)
+    src(i) = Testing::rand()/(double)RAND_MAX;
+
+  LaplaceOperator<dim,fe_degree> mf (mf_data);
+  mf.vmult (dst, src);
+  reference_vmult (mapping, dof, n_q_points_1d, src, dst_ref);
+
+  dst -= dst_ref;
+  const double diff_norm = dst.linfty_norm() / dst_ref.linfty_norm();
+  deallog << "Norm of difference: " << (diff_norm < 1e-12 ? 0. : diff_norm)
+          << std::endl << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog << std::setprecision (3);
+
+  {
+    deallog.push("2d");
+    test<2,1>();
+    test<2,3>();
+    deallog.pop();
+    deallog.push("3d");
+    test<3,1>();
+    test<3,2>();
+    deallog.pop();
+  }
+}
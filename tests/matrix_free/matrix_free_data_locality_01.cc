@@ -0,0 +1,146 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DoFRenumbering::matrix_free_data_locality: after renumbering, the
+// cell loop of MatrixFree must access the dofs in increasing order, and the
+// result of an integration must not change
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/dofs/dof_renumbering.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+
+template <int dim, int fe_degree>
+void setup (const DoFHandler<dim>  &dof_handler,
+            ConstraintMatrix       &constraints,
+            MatrixFree<dim,double> &matrix_free)
+{
+  constraints.clear ();
+  DoFTools::make_hanging_node_constraints (dof_handler, constraints);
+  constraints.close ();
+
+  typename MatrixFree<dim,double>::AdditionalData data;
+  data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+  matrix_free.reinit (dof_handler, constraints, QGauss<1>(fe_degree+1), data);
+}
+
+
+
+template <int dim, int fe_degree>
+double integrate (const MatrixFree<dim,double> &matrix_free)
+{
+  Vector<double> rhs (matrix_free.get_dof_handler().n_dofs());
+  FEEvaluation<dim,fe_degree> phi (matrix_free);
+  for (unsigned int cell=0; cell<matrix_free.n_macro_cells(); ++cell)
+    {
+      phi.reinit (cell);
+      for (unsigned int q=0; q<phi.n_q_points; ++q)
+        phi.submit_value (make_vectorized_array (1.), q);
+      phi.integrate (true, false);
+      phi.distribute_local_to_global (rhs);
+    }
+  return rhs.l2_norm();
+}
+
+
+
+template <int dim, int fe_degree>
+bool accessed_in_order (const MatrixFree<dim,double> &matrix_free)
+{
+  const DoFHandler<dim> &dof_handler = matrix_free.get_dof_handler();
+  std::vector<bool> touched (dof_handler.n_dofs(), false);
+  std::vector<types::global_dof_index> dof_indices (dof_handler.get_fe().dofs_per_cell);
+  types::global_dof_index next_index = 0;
+  for (unsigned int cell=0; cell<matrix_free.n_macro_cells(); ++cell)
+    for (unsigned int v=0; v<matrix_free.n_components_filled(cell); ++v)
+      {
+        matrix_free.get_cell_iterator (cell, v)->get_dof_indices (dof_indices);
+        for (unsigned int i=0; i<dof_indices.size(); ++i)
+          if (touched[dof_indices[i]] == false)
+            {
+              if (dof_indices[i] != next_index)
+                return false;
+              touched[dof_indices[i]] = true;
+              ++next_index;
+            }
+      }
+  return next_index == dof_handler.n_dofs();
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (2);
+  for (unsigned int cycle=0; cycle<2; ++cycle)
+    {
+      unsigned int index = 0;
+      for (typename Triangulation<dim>::active_cell_iterator
+           cell = tria.begin_active(); cell != tria.end(); ++cell, ++index)
+        if (index % 4 == 0)
+          cell->set_refine_flag ();
+      tria.execute_coarsening_and_refinement ();
+    }
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  ConstraintMatrix constraints;
+  MatrixFree<dim,double> matrix_free;
+  setup<dim,fe_degree> (dof_handler, constraints, matrix_free);
+  const double norm_before = integrate<dim,fe_degree> (matrix_free);
+  deallog << "Accessed in order before renumbering: "
+          << (accessed_in_order<dim,fe_degree> (matrix_free) ? "yes" : "no")
+          << std::endl;
+
+  DoFRenumbering::matrix_free_data_locality (dof_handler, matrix_free);
+  setup<dim,fe_degree> (dof_handler, constraints, matrix_free);
+  const double norm_after = integrate<dim,fe_degree> (matrix_free);
+  deallog << "Accessed in order after renumbering: "
+          << (accessed_in_order<dim,fe_degree> (matrix_free) ? "yes" : "no")
+          << std::endl;
+  deallog << "Integral unchanged: "
+          << (std::abs (norm_after - norm_before) < 1e-12 * norm_before ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("2d");
+  test<2,3> ();
+  deallog.pop ();
+  deallog.push ("3d");
+  test<3,2> ();
+  deallog.pop ();
+}
@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// MatrixFree::cell_loop does not import the ghost values of a source vector
+// that is already in ghosted state, and leaves its ghost values in
+// place. check that the result is the same as for a source vector without
+// ghost values, that the ghost values are really not imported a second time
+// by overwriting them before the loop, and that the ghost values are
+// exchanged again once they have been zeroed. the mesh is a
+// parallel::shared::Triangulation, so the test runs in every configuration
+// with MPI
+
+#include "../tests.h"
+
+#include "matrix_vector_mf.h"
+
+#include <deal.II/base/utilities.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/distributed/shared_tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/fe/fe_q.h>
+
+#include <iostream>
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  typedef double number;
+
+  // all processors store the whole mesh, so they all need to set the same
+  // refinement flags
+  parallel::shared::Triangulation<dim> tria (MPI_COMM_WORLD,
+                                             Triangulation<dim>::none,
+                                             true,
+                                             parallel::shared::Triangulation<dim>::partition_zorder);
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global(2);
+  for (typename Triangulation<dim>::active_cell_iterator
+       cell = tria.begin_active(); cell != tria.end(); ++cell)
+    if (cell->center().norm() < 0.5)
+      cell->set_refine_flag();
+  tria.execute_coarsening_and_refinement();
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+
+  IndexSet relevant_set;
+  DoFTools::extract_locally_relevant_dofs (dof, relevant_set);
+  ConstraintMatrix constraints (relevant_set);
+  DoFTools::make_hanging_node_constraints(dof, constraints);
+  constraints.close();
+
+  deallog << "Testing " << dof.get_fe().get_name() << std::endl;
+
+  MatrixFree<dim,number> mf_data;
+  mf_data.reinit (dof, constraints, QGauss<1>(fe_degree+1),
+                  typename MatrixFree<dim,number>::AdditionalData());
+
+  MatrixFreeTest<dim,fe_degree,number,LinearAlgebra::distributed::Vector<number> > mf (mf_data);
+  LinearAlgebra::distributed::Vector<number> in, out, ref;
+  mf_data.initialize_dof_vector (in);
+  out.reinit (in);
+  ref.reinit (in);
+
+  for (unsigned int i=0; i<in.local_size(); ++i)
+    if (!constraints.is_constrained(in.get_partitioner()->local_to_global(i)))
+      in.local_element(i) = (double)Testing::rand()/RAND_MAX;
+
+  // reference result with the ghost values imported inside the loop
+  mf.vmult (ref, in);
+  const double tolerance = 1e-12 * ref.linfty_norm();
+  const unsigned int n_ghosts = in.get_partitioner()->n_ghost_indices();
+
+  // source vector with valid ghost values
+  in.update_ghost_values();
+  mf.vmult (out, in);
+  out -= ref;
+  deallog << "Result unchanged with ghosted source: "
+          << (out.linfty_norm() < tolerance ? "yes" : "no") << std::endl;
+  deallog << "Source still ghosted after loop: "
+          << (Utilities::MPI::min (in.has_ghost_elements() ? 1 : 0,
+                                   MPI_COMM_WORLD) == 1 ? "yes" : "no")
+          << std::endl;
+
+  // overwrite the ghost values while the vector is in ghosted state. if
+  // the loop imported the ghost values again, the result would not change
+  const number marker = 42.;
+  for (unsigned int i=0; i<n_ghosts; ++i)
+    in.local_element(in.local_size()+i) = marker;
+  mf.vmult (out, in);
+  out -= ref;
+  deallog << "Ghost values imported again: "
+          << (out.linfty_norm() < tolerance ? "yes" : "no") << std::endl;
+  bool marker_kept = true;
+  for (unsigned int i=0; i<n_ghosts; ++i)
+    if (in.local_element(in.local_size()+i) != marker)
+      marker_kept = false;
+  deallog << "Ghost values left untouched: "
+          << (Utilities::MPI::min (marker_kept ? 1 : 0,
+                                   MPI_COMM_WORLD) == 1 ? "yes" : "no")
+          << std::endl;
+
+  // after zeroing the ghosts, the loop must import them again and reset
+  // the vector to the non-ghosted state at the end
+  in.zero_out_ghosts();
+  mf.vmult (out, in);
+  out -= ref;
+  deallog << "Result unchanged after zeroing ghosts: "
+          << (out.linfty_norm() < tolerance ? "yes" : "no") << std::endl;
+  deallog << "Source ghosts reset after loop: "
+          << (Utilities::MPI::max (in.has_ghost_elements() ? 1 : 0,
+                                   MPI_COMM_WORLD) == 0 ? "yes" : "no")
+          << std::endl;
+}
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+
+      deallog.push("2d");
+      test<2,2>();
+      deallog.pop();
+
+      deallog.push("3d");
+      test<3,1>();
+      deallog.pop();
+    }
+  else
+    {
+      test<2,2>();
+      test<3,1>();
+    }
+}
@@ -0,0 +1,243 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// tests a mixed-precision geometric multigrid preconditioner: the level
+// operators, the Chebyshev smoother and MGTransferMatrixFree run in float
+// with the level vectors initialized from the partitioners of MatrixFree
+// passed to MGTransferMatrixFree::build, whereas the outer conjugate gradient
+// solver works on double vectors. The solution is compared to the one
+// obtained with the same multigrid preconditioner in double precision.
+
+#include "../tests.h"
+
+#include <deal.II/base/utilities.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/precondition.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/constraint_matrix.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/mapping_q.h>
+#include <deal.II/numerics/vector_tools.h>
+
+#include <deal.II/multigrid/multigrid.h>
+#include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/multigrid/mg_tools.h>
+#include <deal.II/multigrid/mg_coarse.h>
+#include <deal.II/multigrid/mg_smoother.h>
+#include <deal.II/multigrid/mg_matrix.h>
+
+#include <deal.II/matrix_free/operators.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/fe_evaluation.h>
+
+using namespace dealii::MatrixFreeOperators;
+
+
+
+template <typename MatrixType, typename Number>
+class MGCoarseIterative : public MGCoarseGridBase<LinearAlgebra::distributed::Vector<Number> >
+{
+public:
+  MGCoarseIterative() {}
+
+  void initialize(const MatrixType &matrix)
+  {
+    coarse_matrix = &matrix;
+  }
+
+  virtual void operator() (const unsigned int,
+                           LinearAlgebra::distributed::Vector<Number> &dst,
+                           const LinearAlgebra::distributed::Vector<Number> &src) const
+  {
+    ReductionControl solver_control (1e4, 1e-30, 1e-4);
+    SolverCG<LinearAlgebra::distributed::Vector<Number> > solver_coarse (solver_control);
+    solver_coarse.solve (*coarse_matrix, dst, src, PreconditionIdentity());
+  }
+
+  const MatrixType *coarse_matrix;
+};
+
+
+
+// solves the fine-level problem with a multigrid preconditioner whose levels
+// use the number type 'number' and returns the number of iterations
+template <int dim, int fe_degree, typename number>
+unsigned int
+solve_with_mg (const DoFHandler<dim> &dof,
+               const MGConstrainedDoFs &mg_constrained_dofs,
+               const LaplaceOperator<dim,fe_degree,fe_degree+1,1,LinearAlgebra::distributed::Vector<double> > &fine_matrix,
+               const LinearAlgebra::distributed::Vector<double> &rhs,
+               LinearAlgebra::distributed::Vector<double> &solution)
+{
+  const unsigned int n_levels = dof.get_triangulation().n_global_levels();
+  MappingQ<dim> mapping(fe_degree+1);
+
+  typedef LaplaceOperator<dim,fe_degree,fe_degree+1,1,LinearAlgebra::distributed::Vector<number> > LevelMatrixType;
+
+  MGLevelObject<LevelMatrixType> mg_matrices;
+  mg_matrices.resize(0, n_levels-1);
+  std::vector<std::shared_ptr<const Utilities::MPI::Partitioner> > partitioners(n_levels);
+  for (unsigned int level = 0; level<n_levels; ++level)
+    {
+      typename MatrixFree<dim,number>::AdditionalData mg_additional_data;
+      mg_additional_data.tasks_parallel_scheme = MatrixFree<dim,number>::AdditionalData::none;
+      mg_additional_data.level_mg_handler = level;
+
+      ConstraintMatrix level_constraints;
+      level_constraints.add_lines(mg_constrained_dofs.get_boundary_indices(level));
+      level_constraints.close();
+
+      std::shared_ptr<MatrixFree<dim,number> > mg_level_data(new MatrixFree<dim,number>());
+      mg_level_data->reinit (mapping, dof, level_constraints, QGauss<1>(fe_degree+1),
+                             mg_additional_data);
+      partitioners[level] = mg_level_data->get_vector_partitioner();
+      mg_matrices[level].initialize(mg_level_data, mg_constrained_dofs, level);
+      mg_matrices[level].compute_diagonal();
+    }
+
+  MGTransferMatrixFree<dim,number> mg_transfer(mg_constrained_dofs);
+  mg_transfer.build(dof, partitioners);
+
+  MGCoarseIterative<LevelMatrixType,number> mg_coarse;
+  mg_coarse.initialize(mg_matrices[0]);
+
+  typedef PreconditionChebyshev<LevelMatrixType,LinearAlgebra::distributed::Vector<number> > SMOOTHER;
+  MGSmootherPrecondition<LevelMatrixType, SMOOTHER, LinearAlgebra::distributed::Vector<number> >
+  mg_smoother;
+
+  // the eigenvalue estimate of the Chebyshev smoother needs LAPACK, which is
+  // why this test only runs in configurations with LAPACK
+  MGLevelObject<typename SMOOTHER::AdditionalData> smoother_data;
+  smoother_data.resize(0, n_levels-1);
+  for (unsigned int level = 0; level<n_levels; ++level)
+    {
+      smoother_data[level].smoothing_range = 15.;
+      smoother_data[level].degree = 5;
+      smoother_data[level].eig_cg_n_iterations = 15;
+      smoother_data[level].preconditioner = mg_matrices[level].get_matrix_diagonal_inverse();
+    }
+  mg_smoother.initialize(mg_matrices, smoother_data);
+
+  mg::Matrix<LinearAlgebra::distributed::Vector<number> > mg_matrix(mg_matrices);
+
+  Multigrid<LinearAlgebra::distributed::Vector<number> > mg(dof,
+                                                            mg_matrix,
+                                                            mg_coarse,
+                                                            mg_transfer,
+                                                            mg_smoother,
+                                                            mg_smoother);
+  PreconditionMG<dim, LinearAlgebra::distributed::Vector<number>,
+                 MGTransferMatrixFree<dim,number> >
+                 preconditioner(dof, mg, mg_transfer);
+
+  ReductionControl control(100, 1e-30, 1e-8);
+  SolverCG<LinearAlgebra::distributed::Vector<double> > solver(control);
+  solution = 0;
+  solver.solve(fine_matrix, solution, rhs, preconditioner);
+
+  return control.last_step();
+}
+
+
+
+template <int dim, int fe_degree>
+void test ()
+{
+  Triangulation<dim> tria(Triangulation<dim>::limit_level_difference_at_vertices);
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global(6-dim);
+
+  FE_Q<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs(fe);
+  dof.distribute_mg_dofs(fe);
+
+  deallog << "Testing " << fe.get_name() << std::endl;
+  deallog << "Number of degrees of freedom: " << dof.n_dofs() << std::endl;
+
+  ZeroFunction<dim> zero_function;
+  typename FunctionMap<dim>::type dirichlet_boundary;
+  dirichlet_boundary[0] = &zero_function;
+
+  ConstraintMatrix constraints;
+  VectorTools::interpolate_boundary_values(dof, dirichlet_boundary,
+                                           constraints);
+  constraints.close();
+
+  MGConstrainedDoFs mg_constrained_dofs;
+  mg_constrained_dofs.initialize(dof, dirichlet_boundary);
+
+  MappingQ<dim> mapping(fe_degree+1);
+  typename MatrixFree<dim,double>::AdditionalData fine_level_additional_data;
+  fine_level_additional_data.tasks_parallel_scheme = MatrixFree<dim,double>::AdditionalData::none;
+  std::shared_ptr<MatrixFree<dim,double> > fine_level_data(new MatrixFree<dim,double> ());
+  fine_level_data->reinit (mapping, dof, constraints, QGauss<1>(fe_degree+1),
+                           fine_level_additional_data);
+
+  LaplaceOperator<dim,fe_degree,fe_degree+1,1,LinearAlgebra::distributed::Vector<double> > fine_matrix;
+  fine_matrix.initialize(fine_level_data);
+
+  LinearAlgebra::distributed::Vector<double> rhs, sol_double, sol_float;
+  fine_matrix.initialize_dof_vector(rhs);
+  fine_matrix.initialize_dof_vector(sol_double);
+  fine_matrix.initialize_dof_vector(sol_float);
+  for (unsigned int i=0; i<rhs.local_size(); ++i)
+    if (!constraints.is_constrained(rhs.get_partitioner()->local_to_global(i)))
+      rhs.local_element(i) = 1.;
+
+  const unsigned int n_iterations_double =
+    solve_with_mg<dim,fe_degree,double>(dof, mg_constrained_dofs, fine_matrix,
+                                        rhs, sol_double);
+  const unsigned int n_iterations_float =
+    solve_with_mg<dim,fe_degree,float>(dof, mg_constrained_dofs, fine_matrix,
+                                       rhs, sol_float);
+
+  // the single precision multigrid cycle is only used as a preconditioner,
+  // so the outer solver must converge to the same solution in double
+  // precision within almost the same number of iterations
+  deallog << "Iteration counts differ by at most two: "
+          << (std::abs((int)n_iterations_double - (int)n_iterations_float) <= 2
+              ? "yes" : "no") << std::endl;
+  sol_float -= sol_double;
+  deallog << "Relative difference of solutions below 1e-6: "
+          << (sol_float.linfty_norm() < 1e-6 * sol_double.linfty_norm()
+              ? "yes" : "no") << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_init(argc, argv, 1);
+
+  initlog();
+  deallog.depth_file(2);
+
+  {
+    deallog.push("2d");
+    test<2,1>();
+    test<2,3>();
+    deallog.pop();
+    deallog.push("3d");
+    test<3,1>();
+    test<3,2>();
+    deallog.pop();
+  }
+}
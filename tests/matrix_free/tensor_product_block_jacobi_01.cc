@@ -0,0 +1,156 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// Tests MatrixFreeOperators::TensorProductBlockJacobi on the mass matrix of
+// DG elements on a mesh of axis-aligned cells with different extents in
+// the coordinate directions, where the cell matrices are exactly the tensor
+// products of scaled 1D mass matrices. Then, the block-Jacobi method is the
+// inverse of the mass matrix, which is checked directly and through
+// MGSmootherPrecondition with a relaxation parameter
+
+#include "../tests.h"
+#include <deal.II/base/quadrature_lib.h>
+#include <deal.II/matrix_free/matrix_free.h>
+#include <deal.II/matrix_free/operators.h>
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/fe/fe_dgq.h>
+#include <deal.II/fe/mapping_q1.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/multigrid/mg_smoother.h>
+
+
+template <int dim, int fe_degree, typename Number>
+void test ()
+{
+  typedef LinearAlgebra::distributed::Vector<Number> VectorType;
+  typedef MatrixFreeOperators::TensorProductBlockJacobi<dim,fe_degree,1,VectorType> BlockJacobi;
+
+  deallog << "Testing " << dim << "d, degree " << fe_degree << std::endl;
+
+  Triangulation<dim> tria;
+  std::vector<unsigned int> repetitions (dim, 2);
+  repetitions[0] = 3;
+  Point<dim> p1, p2;
+  for (unsigned int d=0; d<dim; ++d)
+    p2[d] = 1. + 0.5*d;
+  GridGenerator::subdivided_hyper_rectangle (tria, repetitions, p1, p2);
+  tria.refine_global (1);
+  tria.begin_active()->set_refine_flag (RefinementCase<dim>::cut_x);
+  tria.execute_coarsening_and_refinement ();
+
+  FE_DGQ<dim> fe (fe_degree);
+  DoFHandler<dim> dof (tria);
+  dof.distribute_dofs (fe);
+
+  std::shared_ptr<MatrixFree<dim,Number> > mf_data (new MatrixFree<dim,Number>());
+  {
+    ConstraintMatrix constraints;
+    constraints.close ();
+    mf_data->reinit (dof, constraints, QGauss<1>(fe_degree+1),
+                     typename MatrixFree<dim,Number>::AdditionalData());
+  }
+
+  MatrixFreeOperators::MassOperator<dim,fe_degree,fe_degree+1,1,VectorType> mass_operator;
+  mass_operator.initialize (mf_data);
+
+  // the 1D mass matrix on the unit interval, scaled by the extent of the
+  // cells. the derivative matrices are chosen such that the sum of the
+  // tensor products is the mass matrix of the cell
+  FE_DGQ<1> fe_1d (fe_degree);
+  QGauss<1> quadrature_1d (fe_degree+1);
+  FullMatrix<double> mass_1d (fe_degree+1, fe_degree+1);
+  for (unsigned int i=0; i<fe_degree+1; ++i)
+    for (unsigned int j=0; j<fe_degree+1; ++j)
+      for (unsigned int q=0; q<quadrature_1d.size(); ++q)
+        mass_1d(i,j) += fe_1d.shape_value(i, quadrature_1d.point(q)) *
+                        fe_1d.shape_value(j, quadrature_1d.point(q)) *
+                        quadrature_1d.weight(q);
+
+  typename BlockJacobi::AdditionalData data;
+  data.mass_matrices.resize (mf_data->n_macro_cells());
+  data.derivative_matrices.resize (mf_data->n_macro_cells());
+  for (unsigned int cell=0; cell<mf_data->n_macro_cells(); ++cell)
+    for (unsigned int d=0; d<dim; ++d)
+      {
+        data.mass_matrices[cell][d].reinit (fe_degree+1, fe_degree+1);
+        data.derivative_matrices[cell][d].reinit (fe_degree+1, fe_degree+1);
+        for (unsigned int v=0; v<VectorizedArray<Number>::n_array_elements; ++v)
+          {
+            // fill unused lanes with the matrices of the first cell
+            const double h = mf_data->get_cell_iterator
+                             (cell, v < mf_data->n_components_filled(cell) ? v : 0)
+                             ->extent_in_direction(d);
+            for (unsigned int i=0; i<fe_degree+1; ++i)
+              for (unsigned int j=0; j<fe_degree+1; ++j)
+                {
+                  data.mass_matrices[cell][d](i,j)[v] = mass_1d(i,j) * h;
+                  data.derivative_matrices[cell][d](i,j)[v] = mass_1d(i,j) * h / dim;
+                }
+          }
+      }
+
+  BlockJacobi block_jacobi;
+  block_jacobi.initialize (mass_operator, data);
+
+  VectorType rhs, solution, residual;
+  mass_operator.initialize_dof_vector (rhs);
+  mass_operator.initialize_dof_vector (solution);
+  mass_operator.initialize_dof_vector (residual);
+  for (unsigned int i=0; i<rhs.local_size(); ++i)
+    rhs.local_element(i) = 1. + std::sin (1.+i);
+
+  block_jacobi.vmult (solution, rhs);
+  mass_operator.vmult (residual, solution);
+  residual -= rhs;
+  const double tolerance = std::is_same<Number,float>::value ? 1e-5 : 1e-12;
+  double norm = residual.l2_norm() / rhs.l2_norm();
+  deallog << "Relative residual block-Jacobi: " << (norm < tolerance ? 0. : norm)
+          << std::endl;
+
+  // use the block-Jacobi method with relaxation parameter 0.5 as a smoother,
+  // which reduces the residual by a factor of two in each step
+  MGLevelObject<MatrixFreeOperators::MassOperator<dim,fe_degree,fe_degree+1,1,VectorType> >
+  level_operators (0, 0);
+  level_operators[0].initialize (mf_data);
+  data.relaxation = 0.5;
+  MGSmootherPrecondition<MatrixFreeOperators::MassOperator<dim,fe_degree,fe_degree+1,1,VectorType>,
+                         BlockJacobi, VectorType> smoother;
+  smoother.initialize (level_operators, data);
+  smoother.set_steps (3);
+  solution = 0;
+  smoother.smooth (0, solution, rhs);
+  mass_operator.vmult (residual, solution);
+  residual -= rhs;
+  deallog << "Residual reduction of three smoothing steps: "
+          << residual.l2_norm() / rhs.l2_norm() << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+  deallog << std::setprecision(4);
+
+  test<2,1,double>();
+  test<2,2,double>();
+  test<2,4,float>();
+  test<3,1,double>();
+  test<3,3,double>();
+}
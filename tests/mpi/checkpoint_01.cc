@@ -0,0 +1,134 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+// save a parallel::distributed::Triangulation and a vector to a single
+// checkpoint file and load them back, once into a vector with the same
+// layout and once into a vector with a different layout, which must throw
+
+#include "../tests.h"
+#include <deal.II/base/checkpoint.h>
+#include <deal.II/base/utilities.h>
+#include <deal.II/distributed/tria.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/lac/la_parallel_vector.h>
+
+
+template <int dim>
+void test()
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  unsigned int checksum = 0;
+  {
+    parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+    GridGenerator::hyper_cube(tr);
+    tr.refine_global(2);
+    for (typename Triangulation<dim>::active_cell_iterator
+         cell = tr.begin_active();
+         cell != tr.end(); ++cell)
+      if (cell->is_locally_owned() && cell->center().norm() < 0.3)
+        cell->set_refine_flag();
+    tr.execute_coarsening_and_refinement ();
+    checksum = tr.get_checksum ();
+
+    FE_Q<dim> fe(1);
+    DoFHandler<dim> dof_handler(tr);
+    dof_handler.distribute_dofs(fe);
+    IndexSet relevant;
+    DoFTools::extract_locally_relevant_dofs (dof_handler, relevant);
+
+    LinearAlgebra::distributed::Vector<double> v (dof_handler.locally_owned_dofs(),
+                                                  relevant, MPI_COMM_WORLD);
+    for (unsigned int i=0; i<v.local_size(); ++i)
+      v.local_element(i) = v.get_partitioner()->local_to_global(i);
+
+    CheckpointWriter writer ("checkpoint", MPI_COMM_WORLD);
+    tr.save (writer);
+    v.save (writer, "solution");
+    writer.close ();
+  }
+
+  CheckpointReader reader ("checkpoint", MPI_COMM_WORLD);
+
+  parallel::distributed::Triangulation<dim> tr(MPI_COMM_WORLD);
+  GridGenerator::hyper_cube(tr);
+  tr.load (reader);
+  deallog << "#cells: " << tr.n_global_active_cells() << std::endl;
+  deallog << "Checksum agrees: "
+          << (tr.get_checksum() == checksum ? "yes" : "no") << std::endl;
+
+  FE_Q<dim> fe(1);
+  DoFHandler<dim> dof_handler(tr);
+  dof_handler.distribute_dofs(fe);
+  IndexSet relevant;
+  DoFTools::extract_locally_relevant_dofs (dof_handler, relevant);
+
+  LinearAlgebra::distributed::Vector<double> v (dof_handler.locally_owned_dofs(),
+                                                relevant, MPI_COMM_WORLD);
+  v.load (reader, "solution");
+  bool agrees = true;
+  for (unsigned int i=0; i<v.local_size(); ++i)
+    if (v.local_element(i) != v.get_partitioner()->local_to_global(i))
+      agrees = false;
+  deallog << "Vector agrees: "
+          << (Utilities::MPI::min (agrees ? 1 : 0, MPI_COMM_WORLD) == 1 ? "yes" : "no")
+          << std::endl;
+
+  // reading into a vector whose locally owned ranges are distributed
+  // evenly, independent of the mesh, must fail on all processors
+  const types::global_dof_index n_dofs = dof_handler.n_dofs();
+  IndexSet owned (n_dofs);
+  owned.add_range (n_dofs * myid / numproc, n_dofs * (myid+1) / numproc);
+  LinearAlgebra::distributed::Vector<double> w (owned, MPI_COMM_WORLD);
+  bool exception_thrown = false;
+  try
+    {
+      w.load (reader, "solution");
+    }
+  catch (const ExceptionBase &)
+    {
+      exception_thrown = true;
+    }
+  deallog << "Vector with different layout rejected: "
+          << (Utilities::MPI::min (exception_thrown ? 1 : 0, MPI_COMM_WORLD) == 1 ? "yes" : "no")
+          << std::endl;
+}
+
+
+int main(int argc, char *argv[])
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+
+      deallog.push("2d");
+      test<2>();
+      deallog.pop();
+    }
+  else
+    test<2>();
+}
@@ -0,0 +1,199 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check LinearAlgebra::distributed::Vector::multi_dot and multi_dot_start
+// against operator*, and check that SolverCG with fused reductions and
+// SolverGMRES with classical Gram-Schmidt, which use these functions,
+// converge like the variants with separate inner products
+
+#include "../tests.h"
+#include <deal.II/base/utilities.h>
+#include <deal.II/base/index_set.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_gmres.h>
+#include <deal.II/lac/precondition.h>
+#include <iostream>
+#include <vector>
+
+
+// a diagonal matrix with ten distinct entries
+class TestMatrix
+{
+public:
+  void vmult (LinearAlgebra::distributed::Vector<double>       &dst,
+              const LinearAlgebra::distributed::Vector<double> &src) const
+  {
+    for (unsigned int i=0; i<src.local_size(); ++i)
+      dst.local_element(i)
+        = (1. + (src.get_partitioner()->local_to_global(i) % 10)) *
+          src.local_element(i);
+  }
+};
+
+
+
+// a diagonal preconditioner that captures a part of the spectrum
+class TestPreconditioner
+{
+public:
+  void vmult (LinearAlgebra::distributed::Vector<double>       &dst,
+              const LinearAlgebra::distributed::Vector<double> &src) const
+  {
+    for (unsigned int i=0; i<src.local_size(); ++i)
+      dst.local_element(i)
+        = src.local_element(i) /
+          (1. + (src.get_partitioner()->local_to_global(i) % 2));
+  }
+};
+
+
+
+void test ()
+{
+  const unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  const unsigned int numproc = Utilities::MPI::n_mpi_processes (MPI_COMM_WORLD);
+
+  // choose a size that is not divisible by the vectorization width and the
+  // chunk sizes of the vector operations
+  const types::global_dof_index local_size = 1117 + 13 * myid;
+  types::global_dof_index start = 0;
+  for (unsigned int p=0; p<myid; ++p)
+    start += 1117 + 13 * p;
+  types::global_dof_index global_size = 0;
+  for (unsigned int p=0; p<numproc; ++p)
+    global_size += 1117 + 13 * p;
+
+  IndexSet local_owned (global_size);
+  local_owned.add_range (start, start+local_size);
+
+  // check multi_dot with 1 to 7 vectors, i.e., including the case of more
+  // vectors than are processed in one sweep
+  LinearAlgebra::distributed::Vector<double> x (local_owned, MPI_COMM_WORLD);
+  std::vector<LinearAlgebra::distributed::Vector<double> > vectors (7, x);
+  for (unsigned int i=0; i<local_size; ++i)
+    {
+      const double global_i = start + i;
+      x.local_element(i) = 0.1 + 0.005 * global_i;
+      for (unsigned int v=0; v<vectors.size(); ++v)
+        vectors[v].local_element(i) = std::sin(global_i * (v+1)) + 1./(1.+v+global_i);
+    }
+
+  for (unsigned int n=1; n<=vectors.size(); ++n)
+    {
+      std::vector<const LinearAlgebra::distributed::Vector<double> *> V;
+      for (unsigned int v=0; v<n; ++v)
+        V.push_back (&vectors[v]);
+
+      const std::vector<double> products = x.multi_dot (V);
+      Utilities::MPI::Future<std::vector<double> > future = x.multi_dot_start (V);
+      const std::vector<double> products_started = future.get();
+
+      AssertThrow (products.size() == n, ExcInternalError());
+      AssertThrow (products_started.size() == n, ExcInternalError());
+      bool same = true;
+      for (unsigned int v=0; v<n; ++v)
+        {
+          const double reference = x * vectors[v];
+          if (std::abs (products[v] - reference) > 1e-14 * std::abs(reference) ||
+              std::abs (products_started[v] - reference) > 1e-14 * std::abs(reference))
+            same = false;
+        }
+      deallog << "Number of vectors " << n << ", agrees with operator*: "
+              << (same ? "yes" : "no") << std::endl;
+    }
+
+  // solve a linear system with the solvers. the output of the solvers
+  // depends on the number of processors, so suppress it
+  deallog.depth_file (2);
+  TestMatrix matrix;
+  LinearAlgebra::distributed::Vector<double> solution (x), rhs (x);
+  rhs = 1.;
+
+  {
+    SolverControl control (100, 1e-10);
+    SolverCG<LinearAlgebra::distributed::Vector<double> > solver (control);
+    solution = 0;
+    solver.solve (matrix, solution, rhs, PreconditionIdentity());
+    deallog << "CG converged in " << control.last_step() << " iterations"
+            << std::endl;
+
+    solution = 0;
+    solver.solve (matrix, solution, rhs, TestPreconditioner());
+    deallog << "Preconditioned CG converged in " << control.last_step()
+            << " iterations" << std::endl;
+    for (unsigned int i=0; i<local_size; ++i)
+      AssertThrow (std::abs (solution.local_element(i) *
+                             (1. + ((start+i) % 10)) - 1.) < 1e-8,
+                   ExcInternalError());
+
+    SolverCG<LinearAlgebra::distributed::Vector<double> >
+    fused_solver (control, SolverCG<LinearAlgebra::distributed::Vector<double> >::AdditionalData (true));
+    solution = 0;
+    fused_solver.solve (matrix, solution, rhs, TestPreconditioner());
+    deallog << "Preconditioned CG with fused reductions converged in "
+            << control.last_step() << " iterations" << std::endl;
+    for (unsigned int i=0; i<local_size; ++i)
+      AssertThrow (std::abs (solution.local_element(i) *
+                             (1. + ((start+i) % 10)) - 1.) < 1e-8,
+                   ExcInternalError());
+  }
+
+  unsigned int gmres_steps[2];
+  for (unsigned int classical=0; classical<2; ++classical)
+    {
+      SolverControl control (100, 1e-10);
+      SolverGMRES<LinearAlgebra::distributed::Vector<double> >::AdditionalData
+      data (30, false, true, false, classical == 1);
+      SolverGMRES<LinearAlgebra::distributed::Vector<double> > solver (control, data);
+      solution = 0;
+      solver.solve (matrix, solution, rhs, PreconditionIdentity());
+      gmres_steps[classical] = control.last_step();
+
+      // the exact solution is the inverse of the diagonal
+      for (unsigned int i=0; i<local_size; ++i)
+        AssertThrow (std::abs (solution.local_element(i) *
+                               (1. + ((start+i) % 10)) - 1.) < 1e-8,
+                     ExcInternalError());
+    }
+  deallog << "GMRES with modified Gram-Schmidt converged in "
+          << gmres_steps[0] << " iterations" << std::endl;
+  deallog << "GMRES with classical Gram-Schmidt converged in "
+          << gmres_steps[1] << " iterations" << std::endl;
+  deallog.depth_file (10);
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, testing_max_num_threads());
+
+  unsigned int myid = Utilities::MPI::this_mpi_process (MPI_COMM_WORLD);
+  deallog.push(Utilities::int_to_string(myid));
+
+  if (myid == 0)
+    {
+      initlog();
+      deallog << std::setprecision(12);
+
+      test();
+    }
+  else
+    test();
+
+}
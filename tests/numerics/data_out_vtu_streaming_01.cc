@@ -0,0 +1,248 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check DataOut::write_vtu_in_parallel_streaming: write a scalar and a vector
+// field in batches of a few cells, with and without compression, decode the
+// appended data of the resulting files and compare it to the patches
+// generated by DataOut::build_patches
+
+#include "../tests.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/grid_generator.h>
+#include <deal.II/dofs/dof_handler.h>
+#include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_system.h>
+#include <deal.II/lac/vector.h>
+#include <deal.II/numerics/data_out.h>
+
+#include <zlib.h>
+
+#include <map>
+
+
+// make get_patches() accessible
+template <int dim>
+class DataOutWithPatches : public DataOut<dim>
+{
+public:
+  using DataOut<dim>::get_patches;
+};
+
+
+
+// return the value of the attribute with the given name in the given XML
+// element, or an empty string if there is no such attribute
+std::string get_attribute (const std::string &element,
+                           const std::string &name)
+{
+  const std::size_t pos = element.find (" " + name + "=\"");
+  if (pos == std::string::npos)
+    return "";
+  const std::size_t begin = pos + name.size() + 3;
+  return element.substr (begin, element.find ('"', begin) - begin);
+}
+
+
+
+// decode the data array that starts at 'data' into raw bytes
+std::vector<char> decode_array (const char *data,
+                                const bool  compressed)
+{
+  std::vector<char> result;
+  const unsigned long long int *header
+    = reinterpret_cast<const unsigned long long int *>(data);
+  if (!compressed)
+    result.assign (data + sizeof(header[0]), data + sizeof(header[0]) + header[0]);
+  else
+    {
+      const unsigned long long int n_blocks = header[0];
+      const char *block = data + (3+n_blocks)*sizeof(header[0]);
+      for (unsigned long long int b=0; b<n_blocks; ++b)
+        {
+          uLongf size = (b == n_blocks-1 && header[2] != 0) ? header[2] : header[1];
+          std::vector<char> buffer (size);
+          const int err = uncompress ((Bytef *)&buffer[0], &size,
+                                      (const Bytef *)block, header[3+b]);
+          AssertThrow (err == Z_OK, ExcInternalError());
+          result.insert (result.end(), buffer.begin(), buffer.begin()+size);
+          block += header[3+b];
+        }
+    }
+  return result;
+}
+
+
+
+// read the given file and return the number of pieces as well as the
+// number of entries and the sum of the entries of all data arrays,
+// accumulated over the pieces
+unsigned int
+read_file (const std::string                                     &filename,
+           std::map<std::string, std::pair<std::size_t, double> > &arrays)
+{
+  std::ifstream file (filename.c_str(), std::ios::binary);
+  const std::string content ((std::istreambuf_iterator<char>(file)),
+                             std::istreambuf_iterator<char>());
+
+  const std::size_t vtk_file = content.find ("<VTKFile");
+  const std::string root = content.substr (vtk_file, content.find ('>', vtk_file) - vtk_file);
+  AssertThrow (get_attribute (root, "header_type") == "UInt64", ExcInternalError());
+  const bool compressed = (get_attribute (root, "compressor") != "");
+
+  const std::size_t appended = content.find ("<AppendedData encoding=\"raw\">");
+  AssertThrow (appended != std::string::npos, ExcInternalError());
+  const char *appended_data = content.c_str() + content.find ('_', appended) + 1;
+  const std::string footer = "\n</AppendedData>\n</VTKFile>\n";
+  AssertThrow (content.substr (content.size()-footer.size()) == footer,
+               ExcInternalError());
+
+  arrays.clear ();
+  unsigned int n_pieces = 0;
+  std::size_t pos = 0;
+  while ((pos = content.find ('<', pos)) < appended)
+    {
+      const std::string element = content.substr (pos, content.find ('>', pos) - pos);
+      ++pos;
+      if (element.find ("<Piece ") == 0)
+        ++n_pieces;
+      if (element.find ("<DataArray ") != 0)
+        continue;
+
+      const std::string type = get_attribute (element, "type");
+      const std::string name = (get_attribute (element, "Name") != "" ?
+                                get_attribute (element, "Name") : "points");
+      const std::vector<char> bytes
+        = decode_array (appended_data + std::stoull (get_attribute (element, "offset")),
+                        compressed);
+
+      std::pair<std::size_t, double> &entry = arrays[name + " (" + type + ")"];
+      if (type == "Float64")
+        for (unsigned int i=0; i<bytes.size()/sizeof(double); ++i)
+          {
+            ++entry.first;
+            entry.second += reinterpret_cast<const double *>(&bytes[0])[i];
+          }
+      else if (type == "Int32")
+        for (unsigned int i=0; i<bytes.size()/sizeof(int32_t); ++i)
+          {
+            ++entry.first;
+            entry.second += reinterpret_cast<const int32_t *>(&bytes[0])[i];
+          }
+      else if (type == "UInt8")
+        for (unsigned int i=0; i<bytes.size(); ++i)
+          {
+            ++entry.first;
+            entry.second += static_cast<unsigned char>(bytes[i]);
+          }
+    }
+  return n_pieces;
+}
+
+
+
+template <int dim>
+void test ()
+{
+  Triangulation<dim> tria;
+  GridGenerator::hyper_cube (tria);
+  tria.refine_global (3);
+
+  FESystem<dim> fe (FE_Q<dim>(2), dim+1);
+  DoFHandler<dim> dof_handler (tria);
+  dof_handler.distribute_dofs (fe);
+
+  Vector<double> solution (dof_handler.n_dofs());
+  for (unsigned int i=0; i<solution.size(); ++i)
+    solution(i) = (i % 17) * 0.25;
+
+  std::vector<std::string> names (dim, "velocity");
+  names.push_back ("pressure");
+  std::vector<DataComponentInterpretation::DataComponentInterpretation>
+  interpretation (dim, DataComponentInterpretation::component_is_part_of_vector);
+  interpretation.push_back (DataComponentInterpretation::component_is_scalar);
+
+  DataOutWithPatches<dim> data_out;
+  data_out.attach_dof_handler (dof_handler);
+  data_out.add_data_vector (solution, names, DataOut<dim>::type_dof_data,
+                            interpretation);
+
+  DataOutBase::VtkFlags flags;
+  flags.print_date_and_time = false;
+  flags.compression_level = DataOutBase::VtkFlags::no_compression;
+  data_out.set_flags (flags);
+  data_out.write_vtu_in_parallel_streaming ("output_uncompressed.vtu",
+                                            MPI_COMM_SELF, 2, 7);
+
+  std::map<std::string, std::pair<std::size_t, double> > arrays;
+  deallog << "Number of pieces: "
+          << read_file ("output_uncompressed.vtu", arrays)
+          << std::endl;
+  for (const auto &array : arrays)
+    deallog << array.first << ": " << array.second.first << " entries"
+            << std::endl;
+
+  // compare against the patches of build_patches
+  data_out.build_patches (2);
+  std::size_t n_points = 0;
+  double velocity_sum = 0, pressure_sum = 0;
+  for (const auto &patch : data_out.get_patches())
+    {
+      n_points += patch.data.n_cols();
+      for (unsigned int q=0; q<patch.data.n_cols(); ++q)
+        {
+          for (unsigned int d=0; d<dim; ++d)
+            velocity_sum += patch.data(d,q);
+          pressure_sum += patch.data(dim,q);
+        }
+    }
+  deallog << "Agrees with build_patches: "
+          << (arrays["pressure (Float64)"].first == n_points &&
+              arrays["velocity (Float64)"].first == 3*n_points &&
+              std::abs(arrays["pressure (Float64)"].second - pressure_sum) < 1e-10 * pressure_sum &&
+              std::abs(arrays["velocity (Float64)"].second - velocity_sum) < 1e-10 * velocity_sum
+              ? "yes" : "no")
+          << std::endl;
+
+  // the compressed file must contain exactly the same data
+  flags.compression_level = DataOutBase::VtkFlags::best_speed;
+  data_out.set_flags (flags);
+  data_out.write_vtu_in_parallel_streaming ("output_compressed.vtu",
+                                            MPI_COMM_SELF, 2, 7);
+
+  std::map<std::string, std::pair<std::size_t, double> > compressed_arrays;
+  const unsigned int n_compressed_pieces
+    = read_file ("output_compressed.vtu", compressed_arrays);
+  deallog << "Compressed file agrees: "
+          << (n_compressed_pieces == read_file ("output_uncompressed.vtu", arrays) &&
+              compressed_arrays == arrays ? "yes" : "no")
+          << std::endl;
+}
+
+
+
+int main (int argc, char **argv)
+{
+  Utilities::MPI::MPI_InitFinalize mpi_initialization (argc, argv, 1);
+  initlog();
+
+  deallog.push("2d");
+  test<2>();
+  deallog.pop();
+  deallog.push("3d");
+  test<3>();
+  deallog.pop();
+}
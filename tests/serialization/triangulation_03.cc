@@ -0,0 +1,222 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that archives written in older formats can still be read: the
+// archives in the triangulation_03/ directory were written before the used,
+// user and coarsen flags of the triangulation were stored as bytes (class
+// version 0, where they were stored as std::vector<bool>), and the ones in
+// triangulation_03/version_1/ before the objects, children, neighbors and
+// flags were stored in one record per object and cell (class version 1).
+// all of them were written for the same meshes as created here
+
+#include "serialization.h"
+#include <deal.II/grid/tria.h>
+#include <deal.II/grid/tria_accessor.h>
+#include <deal.II/grid/tria_iterator.h>
+#include <deal.II/grid/grid_generator.h>
+
+namespace dealii
+{
+  template <int dim, int spacedim>
+  bool operator == (const Triangulation<dim,spacedim> &t1,
+                    const Triangulation<dim,spacedim> &t2)
+  {
+    // test a few attributes, though we can't
+    // test everything unfortunately...
+    if (t1.n_active_cells() != t2.n_active_cells())
+      return false;
+
+    if (t1.n_cells() != t2.n_cells())
+      return false;
+
+    if (t1.n_faces() != t2.n_faces())
+      return false;
+
+    typename Triangulation<dim,spacedim>::cell_iterator
+    c1 = t1.begin(),
+    c2 = t2.begin();
+    for (; (c1 != t1.end()) && (c2 != t2.end()); ++c1, ++c2)
+      {
+        for (unsigned int v=0; v<GeometryInfo<dim>::vertices_per_cell; ++v)
+          {
+            if (c1->vertex(v) != c2->vertex(v))
+              return false;
+            if (c1->vertex_index(v) != c2->vertex_index(v))
+              return false;
+          }
+
+        for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+          {
+            if (c1->face(f)->at_boundary() != c2->face(f)->at_boundary())
+              return false;
+
+            if (c1->face(f)->manifold_id() != c2->face(f)->manifold_id())
+              return false;
+
+            if (c1->face_orientation(f) != c2->face_orientation(f))
+              return false;
+
+            if (c1->face(f)->at_boundary())
+              {
+                if (c1->face(f)->boundary_id() !=
+                    c2->face(f)->boundary_id())
+                  return false;
+              }
+            else
+              {
+                if (c1->neighbor(f)->level() != c2->neighbor(f)->level())
+                  return false;
+                if (c1->neighbor(f)->index() != c2->neighbor(f)->index())
+                  return false;
+              }
+          }
+
+        if (c1->refinement_case() != c2->refinement_case())
+          return false;
+
+        if (c1->active() && c2->active()
+            && (c1->subdomain_id() != c2->subdomain_id()))
+          return false;
+
+        if (c1->level_subdomain_id() != c2->level_subdomain_id())
+          return false;
+
+        if (c1->material_id() != c2->material_id())
+          return false;
+
+        if (c1->user_index() != c2->user_index())
+          return false;
+
+        if (c1->user_flag_set() != c2->user_flag_set())
+          return false;
+
+        if (c1->manifold_id() != c2->manifold_id())
+          return false;
+
+        if (c1->active() && c2->active())
+          if (c1->active_cell_index() != c2->active_cell_index())
+            return false;
+
+        if (c1->level()>0)
+          if (c1->parent_index() != c2->parent_index())
+            return false;
+      }
+
+    // also check the order of raw iterators as they contain
+    // something about the history of the triangulation
+    typename Triangulation<dim,spacedim>::cell_iterator
+    r1 = t1.begin(),
+    r2 = t2.begin();
+    for (; (r1 != t1.end()) && (r2 != t2.end()); ++r1, ++r2)
+      {
+        if (r1->level() != r2->level())
+          return false;
+        if (r1->index() != r2->index())
+          return false;
+      }
+
+    return true;
+  }
+}
+
+
+template <int dim, int spacedim>
+void do_boundary (Triangulation<dim,spacedim> &t1)
+{
+  typename Triangulation<dim,spacedim>::cell_iterator
+  c1 = t1.begin();
+  for (; c1 != t1.end(); ++c1)
+    for (unsigned int f=0; f<GeometryInfo<dim>::faces_per_cell; ++f)
+      if (c1->at_boundary(f))
+        {
+          c1->face(f)->set_boundary_id (42);
+          //        c1->face(f)->set_manifold_id (43);
+        }
+}
+
+
+template <int spacedim>
+void do_boundary (Triangulation<1,spacedim> &)
+{}
+
+
+template <int dim, int spacedim>
+void test (const std::string &filename)
+{
+  Triangulation<dim,spacedim> tria_1, tria_2;
+
+  GridGenerator::hyper_cube (tria_1);
+  tria_1.refine_global (2);
+  tria_1.begin_active()->set_subdomain_id (1);
+  tria_1.begin_active()->set_level_subdomain_id (4);
+  tria_1.begin_active()->set_material_id (2);
+  tria_1.begin_active()->set_user_index (3);
+  tria_1.begin_active()->set_user_flag ();
+  tria_1.begin_active()->set_refine_flag (RefinementCase<dim>::cut_x);
+
+  do_boundary (tria_1);
+
+  std::ifstream in (filename.c_str());
+  AssertThrow (in, ExcIO());
+  {
+    boost::archive::text_iarchive ia(in, boost::archive::no_header);
+    ia >> tria_2;
+  }
+
+  deallog << "dim=" << dim << ", spacedim=" << spacedim
+          << ": " << tria_2.n_active_cells() << " active cells, "
+          << "triangulations agree: " << (tria_1 == tria_2 ? "yes" : "no")
+          << std::endl;
+  deallog << "refine flag of first cell: "
+          << (tria_2.begin_active()->refine_flag_set() ==
+              RefinementCase<dim>::cut_x ? "cut_x" : "wrong")
+          << std::endl;
+
+  // a triangulation loaded from an old archive can be written in the
+  // current format and read back again
+  std::ostringstream oss;
+  {
+    boost::archive::text_oarchive oa(oss, boost::archive::no_header);
+    oa << tria_2;
+  }
+  Triangulation<dim,spacedim> tria_3;
+  {
+    std::istringstream iss(oss.str());
+    boost::archive::text_iarchive ia(iss, boost::archive::no_header);
+    ia >> tria_3;
+  }
+  deallog << "saved and reloaded: " << (tria_2 == tria_3 ? "yes" : "no")
+          << std::endl;
+}
+
+
+int main ()
+{
+  initlog();
+
+  deallog.push ("version 0");
+  test<1,1> (SOURCE_DIR "/triangulation_03/1d_1d.txt");
+  test<2,2> (SOURCE_DIR "/triangulation_03/2d_2d.txt");
+  test<3,3> (SOURCE_DIR "/triangulation_03/3d_3d.txt");
+  deallog.pop ();
+
+  deallog.push ("version 1");
+  test<1,1> (SOURCE_DIR "/triangulation_03/version_1/1d_1d.txt");
+  test<2,2> (SOURCE_DIR "/triangulation_03/version_1/2d_2d.txt");
+  test<3,3> (SOURCE_DIR "/triangulation_03/version_1/3d_3d.txt");
+  deallog.pop ();
+}
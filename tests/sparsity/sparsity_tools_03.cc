@@ -0,0 +1,117 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (C) 2017 by the deal.II authors
+//
+// This file is part of the deal.II library.
+//
+// The deal.II library is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the deal.II distribution.
+//
+// ---------------------------------------------------------------------
+
+
+
+// check that SparsityTools::reorder_nested_dissection returns a
+// permutation for a grid graph, a path, a graph with several components
+// and isolated vertices, and a pattern that is not symmetric
+
+#include "../tests.h"
+#include <deal.II/lac/sparsity_tools.h>
+#include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
+
+
+void check (const DynamicSparsityPattern &dsp,
+            const std::string            &name)
+{
+  SparsityPattern sparsity;
+  sparsity.copy_from (dsp);
+
+  std::vector<types::global_dof_index> permutation (sparsity.n_rows());
+  SparsityTools::reorder_nested_dissection (sparsity, permutation);
+
+  std::vector<bool> found (permutation.size(), false);
+  bool valid = true;
+  for (unsigned int i=0; i<permutation.size(); ++i)
+    if (permutation[i] >= permutation.size() || found[permutation[i]])
+      valid = false;
+    else
+      found[permutation[i]] = true;
+
+  deallog << name << ": " << sparsity.n_rows() << " indices, "
+          << (valid ? "valid permutation" : "not a permutation") << std::endl;
+}
+
+
+
+int main ()
+{
+  initlog();
+
+  {
+    const unsigned int n = 70;
+    DynamicSparsityPattern dsp (n*n, n*n);
+    for (unsigned int i=0; i<n; ++i)
+      for (unsigned int j=0; j<n; ++j)
+        {
+          const unsigned int row = i*n+j;
+          dsp.add (row, row);
+          if (i>0)
+            dsp.add (row, row-n);
+          if (i<n-1)
+            dsp.add (row, row+n);
+          if (j>0)
+            dsp.add (row, row-1);
+          if (j<n-1)
+            dsp.add (row, row+1);
+        }
+    check (dsp, "Grid");
+  }
+
+  {
+    DynamicSparsityPattern dsp (1000, 1000);
+    for (unsigned int i=0; i<1000; ++i)
+      {
+        dsp.add (i, i);
+        if (i>0)
+          dsp.add (i, i-1);
+        if (i<999)
+          dsp.add (i, i+1);
+      }
+    check (dsp, "Path");
+  }
+
+  {
+    // vertices are only coupled to vertices with the same remainder modulo
+    // four, which gives three interleaved components, and the vertices with
+    // remainder three are isolated
+    DynamicSparsityPattern dsp (600, 600);
+    for (unsigned int i=0; i<600; ++i)
+      {
+        dsp.add (i, i);
+        if (i%4 != 3)
+          for (unsigned int j=i%4; j<600; j+=4*(1+i%4))
+            dsp.add (i, j);
+      }
+    check (dsp, "Components");
+  }
+
+  {
+    // only the part above the diagonal of a grid
+    const unsigned int n = 50;
+    DynamicSparsityPattern dsp (n*n, n*n);
+    for (unsigned int row=0; row<n*n; ++row)
+      {
+        dsp.add (row, row);
+        if (row+1 < n*n && (row+1)%n != 0)
+          dsp.add (row, row+1);
+        if (row+n < n*n)
+          dsp.add (row, row+n);
+      }
+    check (dsp, "Upper triangle");
+  }
+}